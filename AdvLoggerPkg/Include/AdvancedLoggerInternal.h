@@ -43,12 +43,13 @@ typedef volatile struct {
   BOOLEAN                 GoneVirtual;            // After VirtualAddressChange
   BOOLEAN                 HdwPortInitialized;     // HdwPort initialized
   BOOLEAN                 HdwPortDisabled;        // HdwPort is Disabled
-  BOOLEAN                 Reserved2[3];           //
+  BOOLEAN                 HdwPortDeferred;        // HdwPort is fed by the drain agent
+  BOOLEAN                 Reserved2[2];           //
   UINT64                  TimerFrequency;         // Ticks per second for log timing
   UINT64                  TicksAtTime;            // Ticks when Time Acquired
   EFI_TIME                Time;                   // Uefi Time Field
   UINT32                  HwPrintLevel;           // Logging level to be printed at hw port
-  UINT32                  Reserved3;              //
+  UINT32                  HdwPortDrained;         // Offset of the first message not yet at the hw port
 } ADVANCED_LOGGER_INFO;
 
 typedef struct {
@@ -96,6 +97,37 @@ typedef struct {
   UINT64                  Signature;                // Signature 'Alog_Ptr'
 } ADVANCED_LOGGER_PTR;
 
+//
+// AdvLoggerMmAccessLib returns the log through GetVariable of gAdvLoggerAccessGuid.  Besides
+// the fixed size blocks V0, V1, ..., the variable C<offset> returns the complete message entries
+// after <offset> (decimal, from LogBuffer, starting at 0), as many as fit in the caller's buffer,
+// behind this header.  NextOffset is the offset for the next call; if it is below LogEndOffset
+// there is more to read right away.  The log does not wrap: once it is full, messages are
+// dropped and DiscardedSize counts their bytes.
+//
+#define ADVANCED_LOGGER_CURSOR_SIGNATURE  SIGNATURE_32('A','L','C','R')
+#define ADVANCED_LOGGER_CURSOR_PREFIX     L'C'
+
+typedef struct {
+  UINT32    Signature;                            // Signature 'ALCR'
+  UINT32    HeaderSize;                           // Size of this header; the entries follow it
+  UINT64    LogOffset;                            // Offset of the first entry returned
+  UINT64    NextOffset;                           // Offset to pass in the next call
+  UINT64    LogEndOffset;                         // End of the log when it was read
+  UINT32    LogBufferSize;                        // Size of the log buffer
+  UINT32    DiscardedSize;                        // Number of bytes of messages missed
+} ADVANCED_LOGGER_CURSOR_HEADER;
+
+STATIC_ASSERT (sizeof (ADVANCED_LOGGER_CURSOR_HEADER) % 8 == 0, "Cursor Header Misaligned");
+
+//
+// While HdwPortDeferred is set, AdvancedLoggerWrite only adds messages to the memory log, and
+// the drain agent writes the messages from HdwPortDrained up to LogCurrent to the hw port.
+// Message entries are 8 byte aligned, so bit 0 of HdwPortDrained is free to mark that a drain
+// is in progress.
+//
+#define ADVANCED_LOGGER_DRAIN_LOCK  BIT0
+
 //
 // Bit flags for PcdAdvancedLoggerHdwDisable
 //
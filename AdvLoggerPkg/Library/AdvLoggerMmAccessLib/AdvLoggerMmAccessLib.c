@@ -141,6 +141,116 @@ AdvLoggerAccessInit (
   DEBUG ((DEBUG_INFO, "%a: LoggerInfo=%p, code=%r\n", __FUNCTION__, mLoggerInfo, Status));
 }
 
+/**
+  Returns the complete message entries written after a cursor, as many as fit in Data, behind an
+  ADVANCED_LOGGER_CURSOR_HEADER.  A collector that polls the log this way only transfers what is
+  new, in as few calls as the size of its buffer allows, instead of reading every block again.
+
+  An entry is complete when its signature is present, as the signature is written last.  An
+  entry that is still being written ends the transfer, and is returned by a later call.
+
+  @param Cursor                     Decimal offset from LogBuffer of the first entry to return.
+  @param DataSize                   Size of Data.  If too small for the header, or for the first
+                                    entry, this value contains the required size.
+  @param Data                       Receives the header and the entries.
+
+  @return EFI_INVALID_PARAMETER     Invalid parameter, or Cursor is not an entry offset in the log.
+  @return EFI_SUCCESS               Data holds the header and the entries.
+  @return EFI_BUFFER_TO_SMALL       DataSize is too small for the result.
+
+**/
+STATIC
+EFI_STATUS
+AdvLoggerAccessGetCursor (
+  IN      CONST CHAR16  *Cursor,
+  IN OUT  UINTN         *DataSize,
+  OUT     VOID          *Data OPTIONAL
+  )
+{
+  ADVANCED_LOGGER_CURSOR_HEADER  *Header;
+  ADVANCED_LOGGER_MESSAGE_ENTRY  *Entry;
+  CHAR16                         *EndPointer;
+  EFI_STATUS                     Status;
+  UINT8                          *LogBuffer;
+  EFI_PHYSICAL_ADDRESS           LogCurrent;
+  UINT64                         Offset;
+  UINTN                          LogEnd;
+  UINTN                          Next;
+  UINTN                          Room;
+  UINTN                          EntrySize;
+
+  Status = StrDecimalToUint64S (Cursor, &EndPointer, &Offset);
+  if (EFI_ERROR (Status) || (*EndPointer != L'\0')) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // The logger info can be written by untrusted code while this runs.  The log buffer
+  // follows the header, and LogCurrent is read once and only that copy is used.
+  //
+  LogBuffer  = (UINT8 *)(mLoggerInfo + 1);
+  LogCurrent = *(volatile EFI_PHYSICAL_ADDRESS *)&mLoggerInfo->LogCurrent;
+  if ((LogCurrent < PA_FROM_PTR (LogBuffer)) || (LogCurrent > mMaxAddress)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  LogEnd = MIN ((UINTN)(LogCurrent - PA_FROM_PTR (LogBuffer)), mBufferSize);
+
+  if ((Offset > LogEnd) || ((Offset & (sizeof (UINT64) - 1)) != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (*DataSize < sizeof (ADVANCED_LOGGER_CURSOR_HEADER)) {
+    *DataSize = sizeof (ADVANCED_LOGGER_CURSOR_HEADER) + (LogEnd - (UINTN)Offset);
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  if (Data == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Room = *DataSize - sizeof (ADVANCED_LOGGER_CURSOR_HEADER);
+  Next = (UINTN)Offset;
+  while (LogEnd - Next >= sizeof (ADVANCED_LOGGER_MESSAGE_ENTRY)) {
+    Entry = (ADVANCED_LOGGER_MESSAGE_ENTRY *)(LogBuffer + Next);
+    if (Entry->Signature != MESSAGE_ENTRY_SIGNATURE) {
+      break;
+    }
+
+    EntrySize = MESSAGE_ENTRY_SIZE (Entry->MessageLen);
+    if (EntrySize > LogEnd - Next) {
+      break;
+    }
+
+    if (EntrySize > Room - (Next - (UINTN)Offset)) {
+      //
+      // The caller has to offer room for at least one entry to make progress.
+      //
+      if (Next == Offset) {
+        *DataSize = sizeof (ADVANCED_LOGGER_CURSOR_HEADER) + EntrySize;
+        return EFI_BUFFER_TOO_SMALL;
+      }
+
+      break;
+    }
+
+    Next += EntrySize;
+  }
+
+  Header                = (ADVANCED_LOGGER_CURSOR_HEADER *)Data;
+  Header->Signature     = ADVANCED_LOGGER_CURSOR_SIGNATURE;
+  Header->HeaderSize    = sizeof (ADVANCED_LOGGER_CURSOR_HEADER);
+  Header->LogOffset     = Offset;
+  Header->NextOffset    = Next;
+  Header->LogEndOffset  = LogEnd;
+  Header->LogBufferSize = mBufferSize;
+  Header->DiscardedSize = mLoggerInfo->DiscardedSize;
+  CopyMem (Header + 1, LogBuffer + Offset, Next - (UINTN)Offset);
+
+  *DataSize = sizeof (ADVANCED_LOGGER_CURSOR_HEADER) + (Next - (UINTN)Offset);
+  return EFI_SUCCESS;
+}
+
 /**
 
   This code accesses the AdvLogger private storage.
@@ -157,6 +267,9 @@ AdvLoggerAccessInit (
   Vxx - returns the last few bytes of the log
   Vxx+1 = returns EFI_NOT_FOUND.
 
+  C[decimal digits] - returns the complete entries after an offset into the log.  See
+  ADVANCED_LOGGER_CURSOR_HEADER.
+
 
 
   Caution: This function may receive untrusted input.
@@ -202,6 +315,15 @@ AdvLoggerAccessGetVariable (
     return EFI_INVALID_PARAMETER;
   }
 
+  if (VariableName[0] == ADVANCED_LOGGER_CURSOR_PREFIX) {
+    Status = AdvLoggerAccessGetCursor (&VariableName[1], DataSize, Data);
+    if ((Attributes != NULL) && !EFI_ERROR (Status)) {
+      *Attributes = EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS;
+    }
+
+    return Status;
+  }
+
   if (VariableName[0] != L'V') {
     return EFI_NOT_FOUND;
   }
@@ -0,0 +1,661 @@
+/** @file
+  Host based unit tests for the log cursor of AdvLoggerMmAccessLib.
+
+  The log lives in a host buffer that the stand-in HobLib points the library at.  Writers
+  reserve an entry by moving LogCurrent and fill it in afterwards, as AdvancedLoggerLib does,
+  and the tests interleave reservations, completions and reads the way concurrent writers
+  and a polling OS collector would.  The collector's reads through the cursor are compared
+  with reading every V<n> block again on each poll.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <PiDxe.h>
+#include <AdvancedLoggerInternal.h>
+#include <Library/AdvLoggerAccessLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/HobLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_NAME     "AdvLogger MM Access Cursor Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define LOG_BUFFER_SIZE     SIZE_1MB
+#define TRANSFER_SIZE       SIZE_32KB
+#define MAX_MESSAGE_LENGTH  200
+#define WRITERS             4
+#define POLL_OPERATIONS     20000
+#define NAME_LENGTH         24
+
+typedef struct {
+  EFI_HOB_GUID_TYPE      Hob;
+  ADVANCED_LOGGER_PTR    LogPtr;
+} TEST_LOGGER_HOB;
+
+typedef struct {
+  UINT8     *Stream;              // Message text of the entries read, in order.
+  UINTN     StreamLength;
+  UINT64    Cursor;
+  UINTN     Calls;
+  UINTN     Bytes;
+} TEST_COLLECTOR;
+
+STATIC ADVANCED_LOGGER_INFO  *mInfo;
+STATIC TEST_LOGGER_HOB       mLoggerHob;
+STATIC UINT8                 *mExpected;        // Message text of the entries written, in log order.
+STATIC UINTN                 mExpectedLength;
+STATIC UINT32                mDiscarded;
+STATIC UINT32                mRandomState;
+STATIC UINT8                 *mTransfer;
+
+//
+// Stands in for the variable driver that owns the communicate buffer.
+//
+UINTN  mVariableBufferPayloadSize = TRANSFER_SIZE;
+
+/**
+  Stands in for HobLib.  Returns the Advanced Logger HOB pointing at the test log.
+**/
+VOID *
+EFIAPI
+GetFirstGuidHob (
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  if (!CompareGuid (Guid, &gAdvancedLoggerHobGuid)) {
+    return NULL;
+  }
+
+  mLoggerHob.Hob.Header.HobType   = EFI_HOB_TYPE_GUID_EXTENSION;
+  mLoggerHob.Hob.Header.HobLength = sizeof (mLoggerHob);
+  CopyGuid (&mLoggerHob.Hob.Name, &gAdvancedLoggerHobGuid);
+  mLoggerHob.LogPtr.Signature = ADVANCED_LOGGER_PTR_SIGNATURE;
+  mLoggerHob.LogPtr.LogBuffer = PA_FROM_PTR (mInfo);
+  return &mLoggerHob;
+}
+
+/**
+  Returns a pseudo random number.
+**/
+STATIC
+UINT32
+Random (
+  VOID
+  )
+{
+  mRandomState = mRandomState * 1103515245 + 12345;
+  return mRandomState >> 8;
+}
+
+/**
+  Reserves an entry for a message the way AdvancedLoggerLib does, and fills in everything but
+  the signature.  A message that does not fit is counted as discarded.
+
+  @param[in] Length  Length of the message.
+
+  @return  The entry, or NULL if the message was discarded.
+**/
+STATIC
+ADVANCED_LOGGER_MESSAGE_ENTRY *
+ReserveEntry (
+  IN UINTN  Length
+  )
+{
+  ADVANCED_LOGGER_MESSAGE_ENTRY  *Entry;
+  UINTN                          Used;
+  UINTN                          Index;
+
+  Used = (UINTN)(mInfo->LogCurrent - mInfo->LogBuffer);
+  if (mInfo->LogBufferSize - Used < MESSAGE_ENTRY_SIZE (Length)) {
+    mInfo->DiscardedSize += (UINT32)Length;
+    mDiscarded           += (UINT32)Length;
+    return NULL;
+  }
+
+  Entry             = (ADVANCED_LOGGER_MESSAGE_ENTRY *)PTR_FROM_PA (mInfo->LogCurrent);
+  mInfo->LogCurrent = PA_FROM_PTR ((UINT8 *)Entry + MESSAGE_ENTRY_SIZE (Length));
+
+  Entry->TimeStamp  = Used;
+  Entry->DebugLevel = DEBUG_INFO;
+  Entry->MessageLen = (UINT16)Length;
+  for (Index = 0; Index < Length; Index++) {
+    Entry->MessageText[Index] = (CHAR8)('a' + Random () % 26);
+  }
+
+  CopyMem (&mExpected[mExpectedLength], Entry->MessageText, Length);
+  mExpectedLength += Length;
+  return Entry;
+}
+
+/**
+  Completes an entry, as AdvancedLoggerLib does by writing the signature last.
+**/
+STATIC
+VOID
+CompleteEntry (
+  IN ADVANCED_LOGGER_MESSAGE_ENTRY  *Entry
+  )
+{
+  Entry->Signature = MESSAGE_ENTRY_SIGNATURE;
+}
+
+/**
+  Writes a complete message.
+**/
+STATIC
+VOID
+AppendMessage (
+  IN UINTN  Length
+  )
+{
+  ADVANCED_LOGGER_MESSAGE_ENTRY  *Entry;
+
+  Entry = ReserveEntry (Length);
+  if (Entry != NULL) {
+    CompleteEntry (Entry);
+  }
+}
+
+/**
+  Builds a variable name from a prefix and a decimal number.
+**/
+STATIC
+VOID
+VariableName (
+  IN  CHAR16  Prefix,
+  IN  UINT64  Number,
+  OUT CHAR16  *Name
+  )
+{
+  CHAR16  Digits[NAME_LENGTH];
+  UINTN   Count;
+  UINTN   Index;
+
+  Count = 0;
+  do {
+    Digits[Count++] = (CHAR16)(L'0' + Number % 10);
+    Number         /= 10;
+  } while (Number != 0);
+
+  Name[0] = Prefix;
+  for (Index = 0; Index < Count; Index++) {
+    Name[Index + 1] = Digits[Count - 1 - Index];
+  }
+
+  Name[Count + 1] = L'\0';
+}
+
+/**
+  Reads through the cursor once, and checks and keeps what it returns.
+
+  @param[in, out] Collector  Collector state.
+  @param[out]     Header     Receives the header returned.
+
+  @retval UNIT_TEST_PASSED  The entries returned are complete and in order.
+**/
+STATIC
+UNIT_TEST_STATUS
+PollCursor (
+  IN OUT TEST_COLLECTOR                 *Collector,
+  OUT    ADVANCED_LOGGER_CURSOR_HEADER  *Header
+  )
+{
+  CHAR16                         Name[NAME_LENGTH];
+  UINTN                          DataSize;
+  UINT8                          *Data;
+  UINT8                          *End;
+  ADVANCED_LOGGER_MESSAGE_ENTRY  *Entry;
+
+  VariableName (ADVANCED_LOGGER_CURSOR_PREFIX, Collector->Cursor, Name);
+  DataSize = TRANSFER_SIZE;
+  UT_ASSERT_NOT_EFI_ERROR (AdvLoggerAccessGetVariable (Name, &gAdvLoggerAccessGuid, NULL, &DataSize, mTransfer));
+  Collector->Calls++;
+  Collector->Bytes += DataSize;
+
+  CopyMem (Header, mTransfer, sizeof (*Header));
+  UT_ASSERT_EQUAL (Header->Signature, ADVANCED_LOGGER_CURSOR_SIGNATURE);
+  UT_ASSERT_EQUAL (Header->HeaderSize, sizeof (*Header));
+  UT_ASSERT_EQUAL (Header->LogOffset, Collector->Cursor);
+  UT_ASSERT_EQUAL (DataSize, Header->HeaderSize + Header->NextOffset - Header->LogOffset);
+  UT_ASSERT_TRUE (Header->NextOffset <= Header->LogEndOffset);
+
+  Data = mTransfer + Header->HeaderSize;
+  End  = mTransfer + DataSize;
+  while (Data < End) {
+    Entry = (ADVANCED_LOGGER_MESSAGE_ENTRY *)Data;
+    UT_ASSERT_EQUAL (Entry->Signature, MESSAGE_ENTRY_SIGNATURE);
+    UT_ASSERT_TRUE (Data + MESSAGE_ENTRY_SIZE (Entry->MessageLen) <= End);
+    UT_ASSERT_MEM_EQUAL (Entry->MessageText, &mExpected[Collector->StreamLength], Entry->MessageLen);
+    CopyMem (&Collector->Stream[Collector->StreamLength], Entry->MessageText, Entry->MessageLen);
+    Collector->StreamLength += Entry->MessageLen;
+    Data                    += MESSAGE_ENTRY_SIZE (Entry->MessageLen);
+  }
+
+  Collector->Cursor = Header->NextOffset;
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Reads the whole log again through the V<n> blocks, as a collector has to without the cursor,
+  and counts the calls and the bytes.
+**/
+STATIC
+UNIT_TEST_STATUS
+PollBlocks (
+  IN OUT TEST_COLLECTOR  *Collector
+  )
+{
+  CHAR16      Name[NAME_LENGTH];
+  UINTN       DataSize;
+  UINTN       Block;
+  EFI_STATUS  Status;
+
+  for (Block = 0; ; Block++) {
+    VariableName (L'V', Block, Name);
+    DataSize = TRANSFER_SIZE;
+    Status   = AdvLoggerAccessGetVariable (Name, &gAdvLoggerAccessGuid, NULL, &DataSize, mTransfer);
+    Collector->Calls++;
+    if (Status == EFI_NOT_FOUND) {
+      break;
+    }
+
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    Collector->Bytes += DataSize;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Starts each test with an empty log.
+**/
+STATIC
+VOID
+EFIAPI
+SetUpLog (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  ZeroMem (mInfo, sizeof (ADVANCED_LOGGER_INFO) + LOG_BUFFER_SIZE);
+  mInfo->Signature     = ADVANCED_LOGGER_SIGNATURE;
+  mInfo->Version       = ADVANCED_LOGGER_VERSION;
+  mInfo->LogBuffer     = PA_FROM_PTR (mInfo + 1);
+  mInfo->LogCurrent    = mInfo->LogBuffer;
+  mInfo->LogBufferSize = LOG_BUFFER_SIZE;
+
+  mExpectedLength = 0;
+  mDiscarded      = 0;
+  mRandomState    = 0x13579BDF;
+
+  AdvLoggerAccessInit ();
+}
+
+/**
+  Allocates a collector.
+**/
+STATIC
+TEST_COLLECTOR *
+NewCollector (
+  VOID
+  )
+{
+  TEST_COLLECTOR  *Collector;
+
+  Collector = AllocateZeroPool (sizeof (TEST_COLLECTOR));
+  if (Collector != NULL) {
+    Collector->Stream = AllocatePool (LOG_BUFFER_SIZE);
+    if (Collector->Stream == NULL) {
+      FreePool (Collector);
+      Collector = NULL;
+    }
+  }
+
+  return Collector;
+}
+
+/**
+  Frees a collector.
+**/
+STATIC
+VOID
+FreeCollector (
+  IN TEST_COLLECTOR  *Collector
+  )
+{
+  FreePool (Collector->Stream);
+  FreePool (Collector);
+}
+
+/**
+  Each poll returns the entries added since the last one, and nothing twice.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+CursorReturnsNewEntries (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_COLLECTOR                 *Collector;
+  ADVANCED_LOGGER_CURSOR_HEADER  Header;
+  UINTN                          Index;
+
+  Collector = NewCollector ();
+  UT_ASSERT_NOT_NULL (Collector);
+
+  UT_ASSERT_EQUAL (PollCursor (Collector, &Header), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (Header.NextOffset, 0);
+  UT_ASSERT_EQUAL (Header.LogEndOffset, 0);
+
+  for (Index = 0; Index < 50; Index++) {
+    AppendMessage (1 + Random () % MAX_MESSAGE_LENGTH);
+  }
+
+  UT_ASSERT_EQUAL (PollCursor (Collector, &Header), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (Header.NextOffset, Header.LogEndOffset);
+  UT_ASSERT_EQUAL (Collector->StreamLength, mExpectedLength);
+
+  UT_ASSERT_EQUAL (PollCursor (Collector, &Header), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (Header.NextOffset, Header.LogOffset);
+
+  AppendMessage (7);
+  UT_ASSERT_EQUAL (PollCursor (Collector, &Header), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (Collector->StreamLength, mExpectedLength);
+  UT_ASSERT_EQUAL (Header.NextOffset - Header.LogOffset, MESSAGE_ENTRY_SIZE (7));
+
+  FreeCollector (Collector);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Writers reserve entries and complete them later, in any order, while the collector polls.
+  The collector never sees an entry before it is complete, and ends up with every message
+  once, in log order.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ConcurrentAppends (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_COLLECTOR                 *Collector;
+  ADVANCED_LOGGER_CURSOR_HEADER  Header;
+  ADVANCED_LOGGER_MESSAGE_ENTRY  *Pending[WRITERS];
+  ADVANCED_LOGGER_MESSAGE_ENTRY  *Entry;
+  UINTN                          Operation;
+  UINTN                          Writer;
+
+  Collector = NewCollector ();
+  UT_ASSERT_NOT_NULL (Collector);
+  ZeroMem (Pending, sizeof (Pending));
+
+  for (Operation = 0; Operation < POLL_OPERATIONS; Operation++) {
+    Writer = Random () % WRITERS;
+    switch (Random () % 4) {
+      case 0:
+      case 1:
+        if (Pending[Writer] == NULL) {
+          Pending[Writer] = ReserveEntry (1 + Random () % MAX_MESSAGE_LENGTH);
+        } else {
+          CompleteEntry (Pending[Writer]);
+          Pending[Writer] = NULL;
+        }
+
+        break;
+      case 2:
+        UT_ASSERT_EQUAL (PollCursor (Collector, &Header), UNIT_TEST_PASSED);
+
+        //
+        // The cursor stops early only at an entry still being written, or when the next
+        // entry does not fit.
+        //
+        if (Header.NextOffset < Header.LogEndOffset) {
+          Entry = (ADVANCED_LOGGER_MESSAGE_ENTRY *)PTR_FROM_PA (mInfo->LogBuffer + Header.NextOffset);
+          if (Entry->Signature == MESSAGE_ENTRY_SIGNATURE) {
+            UT_ASSERT_TRUE (sizeof (Header) + Header.NextOffset - Header.LogOffset + MESSAGE_ENTRY_SIZE (Entry->MessageLen) > TRANSFER_SIZE);
+          }
+        }
+
+        break;
+      default:
+        AppendMessage (1 + Random () % MAX_MESSAGE_LENGTH);
+        break;
+    }
+  }
+
+  for (Writer = 0; Writer < WRITERS; Writer++) {
+    if (Pending[Writer] != NULL) {
+      CompleteEntry (Pending[Writer]);
+    }
+  }
+
+  do {
+    UT_ASSERT_EQUAL (PollCursor (Collector, &Header), UNIT_TEST_PASSED);
+  } while (Header.NextOffset < Header.LogEndOffset);
+
+  UT_ASSERT_EQUAL (Collector->StreamLength, mExpectedLength);
+  UT_ASSERT_MEM_EQUAL (Collector->Stream, mExpected, mExpectedLength);
+  UT_ASSERT_EQUAL (Header.DiscardedSize, mDiscarded);
+  UT_LOG_INFO ("%d polls read %d bytes of messages, %d bytes discarded\n", (UINT32)Collector->Calls, (UINT32)mExpectedLength, mDiscarded);
+
+  FreeCollector (Collector);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Messages that no longer fit are counted, and the count reaches the collector.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DiscardsAreReported (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_COLLECTOR                 *Collector;
+  ADVANCED_LOGGER_CURSOR_HEADER  Header;
+
+  Collector = NewCollector ();
+  UT_ASSERT_NOT_NULL (Collector);
+
+  while (mDiscarded < SIZE_4KB) {
+    AppendMessage (1 + Random () % MAX_MESSAGE_LENGTH);
+  }
+
+  do {
+    UT_ASSERT_EQUAL (PollCursor (Collector, &Header), UNIT_TEST_PASSED);
+  } while (Header.NextOffset < Header.LogEndOffset);
+
+  UT_ASSERT_EQUAL (Header.DiscardedSize, mDiscarded);
+  UT_ASSERT_EQUAL (Header.LogBufferSize, LOG_BUFFER_SIZE);
+  UT_ASSERT_EQUAL (Collector->StreamLength, mExpectedLength);
+  UT_ASSERT_MEM_EQUAL (Collector->Stream, mExpected, mExpectedLength);
+
+  FreeCollector (Collector);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Cursors that are not entry offsets in the log, and buffers too small, are refused.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BadRequestsAreRefused (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CHAR16  Name[NAME_LENGTH];
+  UINTN   DataSize;
+  UINTN   Index;
+
+  for (Index = 0; Index < 10; Index++) {
+    AppendMessage (MAX_MESSAGE_LENGTH);
+  }
+
+  VariableName (ADVANCED_LOGGER_CURSOR_PREFIX, 4, Name);
+  DataSize = TRANSFER_SIZE;
+  UT_ASSERT_STATUS_EQUAL (AdvLoggerAccessGetVariable (Name, &gAdvLoggerAccessGuid, NULL, &DataSize, mTransfer), EFI_INVALID_PARAMETER);
+
+  VariableName (ADVANCED_LOGGER_CURSOR_PREFIX, 11 * MESSAGE_ENTRY_SIZE (MAX_MESSAGE_LENGTH), Name);
+  UT_ASSERT_STATUS_EQUAL (AdvLoggerAccessGetVariable (Name, &gAdvLoggerAccessGuid, NULL, &DataSize, mTransfer), EFI_INVALID_PARAMETER);
+
+  UT_ASSERT_STATUS_EQUAL (AdvLoggerAccessGetVariable (L"C12x", &gAdvLoggerAccessGuid, NULL, &DataSize, mTransfer), EFI_INVALID_PARAMETER);
+
+  DataSize = 0;
+  UT_ASSERT_STATUS_EQUAL (AdvLoggerAccessGetVariable (L"C0", &gAdvLoggerAccessGuid, NULL, &DataSize, NULL), EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (DataSize, sizeof (ADVANCED_LOGGER_CURSOR_HEADER) + 10 * MESSAGE_ENTRY_SIZE (MAX_MESSAGE_LENGTH));
+
+  DataSize = sizeof (ADVANCED_LOGGER_CURSOR_HEADER) + 8;
+  UT_ASSERT_STATUS_EQUAL (AdvLoggerAccessGetVariable (L"C0", &gAdvLoggerAccessGuid, NULL, &DataSize, mTransfer), EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (DataSize, sizeof (ADVANCED_LOGGER_CURSOR_HEADER) + MESSAGE_ENTRY_SIZE (MAX_MESSAGE_LENGTH));
+
+  UT_ASSERT_NOT_EFI_ERROR (AdvLoggerAccessGetVariable (L"C0", &gAdvLoggerAccessGuid, NULL, &DataSize, mTransfer));
+  UT_ASSERT_EQUAL (((ADVANCED_LOGGER_CURSOR_HEADER *)mTransfer)->NextOffset, MESSAGE_ENTRY_SIZE (MAX_MESSAGE_LENGTH));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A collector polling a growing log, through the cursor and through the V<n> blocks.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+PollingComparison (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_COLLECTOR                 *Cursor;
+  TEST_COLLECTOR                 *Blocks;
+  ADVANCED_LOGGER_CURSOR_HEADER  Header;
+  UINTN                          Index;
+
+  Cursor = NewCollector ();
+  Blocks = NewCollector ();
+  UT_ASSERT_NOT_NULL (Cursor);
+  UT_ASSERT_NOT_NULL (Blocks);
+
+  while (mDiscarded == 0) {
+    for (Index = 0; Index < 100; Index++) {
+      AppendMessage (1 + Random () % MAX_MESSAGE_LENGTH);
+    }
+
+    do {
+      UT_ASSERT_EQUAL (PollCursor (Cursor, &Header), UNIT_TEST_PASSED);
+    } while (Header.NextOffset < Header.LogEndOffset);
+
+    UT_ASSERT_EQUAL (PollBlocks (Blocks), UNIT_TEST_PASSED);
+  }
+
+  UT_LOG_INFO (
+    "Cursor: %d calls, %d KB. Blocks: %d calls, %d KB.\n",
+    (UINT32)Cursor->Calls,
+    (UINT32)(Cursor->Bytes / SIZE_1KB),
+    (UINT32)Blocks->Calls,
+    (UINT32)(Blocks->Bytes / SIZE_1KB)
+    );
+
+  UT_ASSERT_EQUAL (Cursor->StreamLength, mExpectedLength);
+  UT_ASSERT_TRUE (Cursor->Calls < Blocks->Calls);
+  UT_ASSERT_TRUE (Cursor->Bytes < Blocks->Bytes);
+
+  FreeCollector (Cursor);
+  FreeCollector (Blocks);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  log cursor of AdvLoggerMmAccessLib and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      CursorSuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  mInfo     = AllocatePool (sizeof (ADVANCED_LOGGER_INFO) + LOG_BUFFER_SIZE);
+  mExpected = AllocatePool (LOG_BUFFER_SIZE);
+  mTransfer = AllocatePool (TRANSFER_SIZE);
+  if ((mInfo == NULL) || (mExpected == NULL) || (mTransfer == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&CursorSuiteHandle, Framework, "Advanced Logger cursor tests", "AdvLoggerMmAccessLib.Cursor", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for CursorSuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (CursorSuiteHandle, "The cursor returns new entries", "NewEntries", CursorReturnsNewEntries, SetUpLog, NULL, NULL);
+  AddTestCase (CursorSuiteHandle, "Concurrent appends while polling", "ConcurrentAppends", ConcurrentAppends, SetUpLog, NULL, NULL);
+  AddTestCase (CursorSuiteHandle, "Discarded messages are reported", "Discards", DiscardsAreReported, SetUpLog, NULL, NULL);
+  AddTestCase (CursorSuiteHandle, "Bad requests are refused", "BadRequests", BadRequestsAreRefused, SetUpLog, NULL, NULL);
+  AddTestCase (CursorSuiteHandle, "Polling through the cursor and the blocks", "PollingComparison", PollingComparison, SetUpLog, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  if (mInfo != NULL) {
+    FreePool ((VOID *)mInfo);
+  }
+
+  if (mExpected != NULL) {
+    FreePool (mExpected);
+  }
+
+  if (mTransfer != NULL) {
+    FreePool (mTransfer);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
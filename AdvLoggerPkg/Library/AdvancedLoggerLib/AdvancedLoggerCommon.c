@@ -13,12 +13,22 @@
 
 #include <Library/AdvancedLoggerHdwPortLib.h>
 #include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
 #include <Library/PcdLib.h>
 #include <Library/SynchronizationLib.h>
 #include <Library/TimerLib.h>
 
 #include "../AdvancedLoggerCommon.h"
 
+#ifdef ADVANCED_LOGGER_PEI_CORE
+  #include "AdvancedLoggerPreMem.h"
+#endif
+
+//
+// Messages are gathered into bursts of up to this size for the hardware port
+//
+#define HDW_PORT_BURST_SIZE  512
+
 /**
   Write data from buffer into the in memory logging buffer.
 
@@ -27,6 +37,8 @@
   @param  DebugLevel       Debug level of the message
   @param  Buffer           Pointer to the data buffer to be written.
   @param  NumberOfBytes    Number of bytes to be written to the Advanced Logger log.
+  @param  Stored           Set to TRUE if the message was added to the log, FALSE if it
+                           was discarded.
 
   @retval LoggerInfo       Returns the logger info block. Returns NULL if it cannot
                            be located. This occurs prior to SEC completion.
@@ -35,9 +47,10 @@ STATIC
 ADVANCED_LOGGER_INFO *
 EFIAPI
 AdvancedLoggerMemoryLoggerWrite (
-  IN       UINTN  DebugLevel,
-  IN CONST CHAR8  *Buffer,
-  IN       UINTN  NumberOfBytes
+  IN       UINTN    DebugLevel,
+  IN CONST CHAR8    *Buffer,
+  IN       UINTN    NumberOfBytes,
+  OUT      BOOLEAN  *Stored
   )
 {
   ADVANCED_LOGGER_INFO           *LoggerInfo;
@@ -51,6 +64,7 @@ AdvancedLoggerMemoryLoggerWrite (
   UINTN                          UsedSize;
   ADVANCED_LOGGER_MESSAGE_ENTRY  *Entry;
 
+  *Stored = FALSE;
   if ((NumberOfBytes == 0) || (Buffer == NULL)) {
     return NULL;
   }
@@ -61,6 +75,14 @@ AdvancedLoggerMemoryLoggerWrite (
 
   LoggerInfo = AdvancedLoggerGetLoggerInfo ();
 
+ #ifdef ADVANCED_LOGGER_PEI_CORE
+  if ((LoggerInfo != NULL) && AdvancedLoggerPreMemIsCompact (LoggerInfo)) {
+    *Stored = TRUE;
+    return AdvancedLoggerPreMemWrite (LoggerInfo, DebugLevel, Buffer, NumberOfBytes);
+  }
+
+ #endif
+
   if (LoggerInfo != NULL) {
     EntrySize = MESSAGE_ENTRY_SIZE (NumberOfBytes);
     do {
@@ -102,11 +124,140 @@ AdvancedLoggerMemoryLoggerWrite (
     Entry->MessageLen = (UINT16)NumberOfBytes;
     CopyMem (Entry->MessageText, Buffer, NumberOfBytes);
     Entry->Signature = MESSAGE_ENTRY_SIGNATURE;
+    *Stored          = TRUE;
   }
 
   return LoggerInfo;
 }
 
+/**
+  Write the messages of the memory log that have not been written to the hardware port,
+  unless another caller is already draining.
+
+  @param  LoggerInfo       Logger Info block.
+  @param  MaxBytes         Stop once this many bytes of messages have been drained.
+                           MAX_UINTN drains the whole log.
+  @param  Drained          Number of bytes of messages drained.
+
+  @retval TRUE             This caller drained the log.
+  @retval FALSE            A drain was already in progress.
+**/
+STATIC
+BOOLEAN
+HdwPortTryDrain (
+  IN  ADVANCED_LOGGER_INFO  *LoggerInfo,
+  IN  UINTN                 MaxBytes,
+  OUT UINTN                 *Drained
+  )
+{
+  ADVANCED_LOGGER_MESSAGE_ENTRY  *Entry;
+  CHAR8                          Burst[HDW_PORT_BURST_SIZE];
+  UINTN                          BurstLevel;
+  UINTN                          BurstSize;
+  UINTN                          DebugLevel;
+  UINT32                         EndOffset;
+  UINT32                         Offset;
+  UINT32                         StartOffset;
+
+  *Drained    = 0;
+  StartOffset = LoggerInfo->HdwPortDrained;
+  if ((StartOffset & ADVANCED_LOGGER_DRAIN_LOCK) != 0) {
+    return FALSE;
+  }
+
+  if (InterlockedCompareExchange32 (
+        (UINT32 *)&LoggerInfo->HdwPortDrained,
+        StartOffset,
+        StartOffset | ADVANCED_LOGGER_DRAIN_LOCK
+        ) != StartOffset)
+  {
+    return FALSE;
+  }
+
+  Offset     = StartOffset;
+  BurstSize  = 0;
+  BurstLevel = 0;
+
+  //
+  // LogCurrent is read again for every entry, so that messages added while draining are
+  // picked up by this drain rather than left for the next one.
+  //
+  while (*Drained < MaxBytes) {
+    EndOffset = (UINT32)(LoggerInfo->LogCurrent - LoggerInfo->LogBuffer);
+    if ((Offset >= EndOffset) || ((EndOffset - Offset) < sizeof (ADVANCED_LOGGER_MESSAGE_ENTRY))) {
+      break;
+    }
+
+    Entry = (ADVANCED_LOGGER_MESSAGE_ENTRY *)PTR_FROM_PA (LoggerInfo->LogBuffer + Offset);
+    if (((volatile ADVANCED_LOGGER_MESSAGE_ENTRY *)Entry)->Signature != MESSAGE_ENTRY_SIGNATURE) {
+      // The entry is reserved but its writer has not finished it.
+      break;
+    }
+
+    if ((EndOffset - Offset) < MESSAGE_ENTRY_SIZE (Entry->MessageLen)) {
+      break;
+    }
+
+    DebugLevel = Entry->DebugLevel;
+    if (LoggerInfo->Version >= ADVANCED_LOGGER_HW_LVL_VER) {
+      DebugLevel = (DebugLevel & LoggerInfo->HwPrintLevel);
+    }
+
+    if (DebugLevel != 0) {
+      //
+      // A burst only holds messages of one level, so the port filters it exactly as it
+      // would filter each of its messages.
+      //
+      if ((BurstSize != 0) && ((DebugLevel != BurstLevel) || ((BurstSize + Entry->MessageLen) > sizeof (Burst)))) {
+        AdvancedLoggerHdwPortWrite (BurstLevel, (UINT8 *)Burst, BurstSize);
+        BurstSize = 0;
+      }
+
+      if (Entry->MessageLen > sizeof (Burst)) {
+        AdvancedLoggerHdwPortWrite (DebugLevel, (UINT8 *)Entry->MessageText, Entry->MessageLen);
+      } else {
+        CopyMem (&Burst[BurstSize], Entry->MessageText, Entry->MessageLen);
+        BurstSize += Entry->MessageLen;
+        BurstLevel = DebugLevel;
+      }
+    }
+
+    *Drained += Entry->MessageLen;
+    Offset   += (UINT32)MESSAGE_ENTRY_SIZE (Entry->MessageLen);
+  }
+
+  if (BurstSize != 0) {
+    AdvancedLoggerHdwPortWrite (BurstLevel, (UINT8 *)Burst, BurstSize);
+  }
+
+  // Storing the new offset also ends the drain.
+  LoggerInfo->HdwPortDrained = Offset;
+
+  return TRUE;
+}
+
+/**
+  Write the messages of the memory log that have not been written to the hardware port.
+
+  @param  LoggerInfo       Logger Info block.
+  @param  MaxBytes         Stop once this many bytes of messages have been drained.
+                           MAX_UINTN drains the whole log.
+
+  @retval                  Number of bytes of messages drained.
+**/
+UINTN
+EFIAPI
+AdvancedLoggerHdwPortDrain (
+  IN  ADVANCED_LOGGER_INFO  *LoggerInfo,
+  IN  UINTN                 MaxBytes
+  )
+{
+  UINTN  Drained;
+
+  HdwPortTryDrain (LoggerInfo, MaxBytes, &Drained);
+  return Drained;
+}
+
 /**
   Write data from buffer to possible debugging devices.
 
@@ -132,9 +283,11 @@ AdvancedLoggerWrite (
   )
 {
   ADVANCED_LOGGER_INFO  *LoggerInfo;
+  BOOLEAN               Stored;
+  UINTN                 Drained;
 
   // All messages go to the in memory log.
-  LoggerInfo = AdvancedLoggerMemoryLoggerWrite (DebugLevel, Buffer, NumberOfBytes);
+  LoggerInfo = AdvancedLoggerMemoryLoggerWrite (DebugLevel, Buffer, NumberOfBytes, &Stored);
 
   // Only selected messages go to the hdw port.
 
@@ -148,6 +301,23 @@ AdvancedLoggerWrite (
       DebugLevel = (DebugLevel & LoggerInfo->HwPrintLevel);
     }
 
+    //
+    // While the drain agent runs, the message waits in the memory log.  An error is written
+    // at once, after everything before it, as the caller may be about to assert or reset.
+    // A message that did not fit in the log is written directly after the drain.  If this
+    // caller interrupted a drain in progress, an error cannot wait for it, and is written
+    // directly too.
+    //
+    if (LoggerInfo->HdwPortDeferred) {
+      if (((DebugLevel & DEBUG_ERROR) == 0) && Stored) {
+        return;
+      }
+
+      if (HdwPortTryDrain (LoggerInfo, MAX_UINTN, &Drained) && Stored) {
+        return;
+      }
+    }
+
  #endif
     AdvancedLoggerHdwPortWrite (DebugLevel, (UINT8 *)Buffer, NumberOfBytes);
   }
@@ -29,6 +29,27 @@ AdvancedLoggerWrite (
   IN       UINTN  NumberOfBytes
   );
 
+/**
+    Write the messages of the memory log that have not been written to the hardware port.
+
+    Only one caller drains at a time.  A caller that finds a drain in progress returns
+    at once, as the drain in progress continues up to the end of the log.  Messages are
+    filtered by HwPrintLevel here, and consecutive messages are written in bursts.  The
+    drain stops at a message that is still being written, so the order is kept.
+
+    @param  LoggerInfo       Logger Info block.
+    @param  MaxBytes         Stop once this many bytes of messages have been drained.
+                             MAX_UINTN drains the whole log.
+
+    @retval                  Number of bytes of messages drained.
+**/
+UINTN
+EFIAPI
+AdvancedLoggerHdwPortDrain (
+  IN  ADVANCED_LOGGER_INFO  *LoggerInfo,
+  IN  UINTN                 MaxBytes
+  );
+
 /**
     Get the Logger Information block
 
@@ -0,0 +1,388 @@
+/** @file
+  Advanced Logger PEI Core pre-memory log
+
+  Compact entries, folding of repeated messages and the spill region chain for the temporary
+  RAM log, and their expansion into the permanent log at memory discovered.
+
+  Pre-memory PEI runs on one processor, so only the reservation of an entry is atomic.  None of
+  these functions may use DEBUG, as that would come back through AdvancedLoggerPreMemWrite.
+
+  Copyright (C) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <PiPei.h>
+
+#include <AdvancedLoggerInternal.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/HobLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PeiServicesLib.h>
+#include <Library/PrintLib.h>
+#include <Library/SynchronizationLib.h>
+#include <Library/TimerLib.h>
+
+#include "AdvancedLoggerPreMem.h"
+
+#define PRE_MEM_HEADER_FROM_ALI(LoggerInfo)  ((ADVANCED_LOGGER_PRE_MEM_HEADER *) (UINTN) ((LoggerInfo) + 1))
+
+#define PRE_MEM_REPEAT_MESSAGE_SIZE  64
+
+/**
+  Reports whether the log described by LoggerInfo is a compact pre-memory log.
+
+  @param  LoggerInfo  Logger Info block.
+
+  @retval TRUE        Messages go through AdvancedLoggerPreMemWrite.
+  @retval FALSE       Messages are standard entries.
+**/
+BOOLEAN
+AdvancedLoggerPreMemIsCompact (
+  IN  ADVANCED_LOGGER_INFO  *LoggerInfo
+  )
+{
+  //
+  // A SEC log has its first message entry where the header would be.
+  //
+  return FeaturePcdGet (PcdAdvancedLoggerPreMemCompact) &&
+         !LoggerInfo->InPermanentRAM &&
+         (PRE_MEM_HEADER_FROM_ALI (LoggerInfo)->Signature == ADVANCED_LOGGER_PRE_MEM_SIGNATURE);
+}
+
+/**
+  Lays out a compact region in a Logger Info block whose other fields are set.
+
+  @param  LoggerInfo  Logger Info block at the start of the region.
+  @param  Pages       Size of the region.
+  @param  Region      Position of the region in the chain, 1 for the first.
+**/
+VOID
+AdvancedLoggerPreMemInitRegion (
+  IN  ADVANCED_LOGGER_INFO  *LoggerInfo,
+  IN  UINTN                 Pages,
+  IN  UINT32                Region
+  )
+{
+  ADVANCED_LOGGER_PRE_MEM_HEADER  *Header;
+
+  Header            = PRE_MEM_HEADER_FROM_ALI (LoggerInfo);
+  Header->Signature = ADVANCED_LOGGER_PRE_MEM_SIGNATURE;
+  Header->LastEntry = PRE_MEM_NO_ENTRY;
+  Header->Region    = Region;
+  Header->Flags     = 0;
+
+  LoggerInfo->LogBuffer     = PA_FROM_PTR (Header + 1);
+  LoggerInfo->LogBufferSize = (UINT32)(EFI_PAGES_TO_SIZE (Pages) - sizeof (ADVANCED_LOGGER_INFO) - sizeof (ADVANCED_LOGGER_PRE_MEM_HEADER));
+  LoggerInfo->LogCurrent    = LoggerInfo->LogBuffer;
+}
+
+/**
+  Adds the bytes of a message that could not be logged to DiscardedSize.
+
+  @param  LoggerInfo       Logger Info block.
+  @param  NumberOfBytes    Number of bytes in the message.
+**/
+STATIC
+VOID
+PreMemDiscard (
+  IN  ADVANCED_LOGGER_INFO  *LoggerInfo,
+  IN  UINTN                 NumberOfBytes
+  )
+{
+  UINT32  OldSize;
+  UINT32  NewSize;
+  UINT32  CurrentSize;
+
+  do {
+    CurrentSize = LoggerInfo->DiscardedSize;
+    NewSize     = CurrentSize + (UINT32)NumberOfBytes;
+    OldSize     = InterlockedCompareExchange32 (
+                    (UINT32 *)&LoggerInfo->DiscardedSize,
+                    (UINT32)CurrentSize,
+                    (UINT32)NewSize
+                    );
+  } while (OldSize != CurrentSize);
+}
+
+/**
+  Starts a new region when the current one is full.  The full region is recorded in a
+  gAdvancedLoggerPreMemSpillHobGuid HOB.
+
+  @param  LoggerInfo  Logger Info block of the full region.
+
+  @return  The Logger Info block of the new region, or NULL if there is none.
+**/
+STATIC
+ADVANCED_LOGGER_INFO *
+PreMemSpill (
+  IN  ADVANCED_LOGGER_INFO  *LoggerInfo
+  )
+{
+  ADVANCED_LOGGER_PRE_MEM_HEADER  *Header;
+  EFI_PHYSICAL_ADDRESS            NewBuffer;
+  ADVANCED_LOGGER_INFO            *NewLoggerInfo;
+  UINT32                          Pages;
+  ADVANCED_LOGGER_PRE_MEM_SPILL   Spill;
+  EFI_STATUS                      Status;
+
+  //
+  // Messages logged while the region is allocated, or after that failed, are discarded.
+  //
+  Header = PRE_MEM_HEADER_FROM_ALI (LoggerInfo);
+  if (((Header->Flags & (PRE_MEM_FLAG_SPILLING | PRE_MEM_FLAG_SPILL_FAILED)) != 0) ||
+      (Header->Region > FixedPcdGet32 (PcdAdvancedLoggerPreMemSpillRegions)))
+  {
+    return NULL;
+  }
+
+  Header->Flags |= PRE_MEM_FLAG_SPILLING;
+  Pages          = FixedPcdGet32 (PcdAdvancedLoggerPreMemPages);
+  Status         = PeiServicesAllocatePages (
+                     EfiReservedMemoryType,
+                     Pages,
+                     &NewBuffer
+                     );
+  if (EFI_ERROR (Status)) {
+    Header->Flags = PRE_MEM_FLAG_SPILL_FAILED;
+    return NULL;
+  }
+
+  Spill.Region   = PA_FROM_PTR (LoggerInfo);
+  Spill.Pages    = Pages;
+  Spill.Reserved = 0;
+  if (BuildGuidDataHob (&gAdvancedLoggerPreMemSpillHobGuid, &Spill, sizeof (Spill)) == NULL) {
+    PeiServicesFreePages (NewBuffer, Pages);
+    Header->Flags = PRE_MEM_FLAG_SPILL_FAILED;
+    return NULL;
+  }
+
+  NewLoggerInfo = ALI_FROM_PA (NewBuffer);
+  ZeroMem ((VOID *)NewLoggerInfo, EFI_PAGES_TO_SIZE (Pages));
+  CopyMem ((VOID *)NewLoggerInfo, (VOID *)LoggerInfo, sizeof (ADVANCED_LOGGER_INFO));
+  AdvancedLoggerPreMemInitRegion (NewLoggerInfo, Pages, Header->Region + 1);
+  AdvancedLoggerPreMemSetLoggerInfo (NewLoggerInfo);
+
+  Header->Flags &= ~PRE_MEM_FLAG_SPILLING;
+  return NewLoggerInfo;
+}
+
+/**
+  Writes a message to the compact pre-memory log, folding it into the last entry when it
+  repeats it, and moving to a new region when the current one is full.
+
+  @param  LoggerInfo       Logger Info block of the current region.
+  @param  DebugLevel       Debug level of the message.
+  @param  Buffer           Message.
+  @param  NumberOfBytes    Number of bytes in the message, 1 to MAX_UINT16.
+
+  @return  The Logger Info block of the region now current.
+**/
+ADVANCED_LOGGER_INFO *
+AdvancedLoggerPreMemWrite (
+  IN       ADVANCED_LOGGER_INFO  *LoggerInfo,
+  IN       UINTN                 DebugLevel,
+  IN CONST CHAR8                 *Buffer,
+  IN       UINTN                 NumberOfBytes
+  )
+{
+  ADVANCED_LOGGER_PRE_MEM_HEADER  *Header;
+  ADVANCED_LOGGER_PRE_MEM_ENTRY   *Entry;
+  ADVANCED_LOGGER_INFO            *NewLoggerInfo;
+  EFI_PHYSICAL_ADDRESS            CurrentBuffer;
+  EFI_PHYSICAL_ADDRESS            NewBuffer;
+  EFI_PHYSICAL_ADDRESS            OldValue;
+  UINT64                          TimeStamp;
+  UINTN                           EntrySize;
+  UINTN                           UsedSize;
+
+  Header = PRE_MEM_HEADER_FROM_ALI (LoggerInfo);
+  if (Header->LastEntry != PRE_MEM_NO_ENTRY) {
+    Entry = (ADVANCED_LOGGER_PRE_MEM_ENTRY *)PTR_FROM_PA (LoggerInfo->LogBuffer + Header->LastEntry);
+    if ((Entry->MessageLen == NumberOfBytes) &&
+        (Entry->DebugLevel == (UINT32)DebugLevel) &&
+        (Entry->RepeatCount < MAX_UINT16) &&
+        (CompareMem (Entry->MessageText, Buffer, NumberOfBytes) == 0))
+    {
+      Entry->RepeatCount++;
+      return LoggerInfo;
+    }
+  }
+
+  //
+  // A message too long for an empty region would spill without end.
+  //
+  EntrySize = PRE_MEM_ENTRY_SIZE (NumberOfBytes);
+  if (EntrySize > EFI_PAGES_TO_SIZE (FixedPcdGet32 (PcdAdvancedLoggerPreMemPages)) - sizeof (ADVANCED_LOGGER_INFO) - sizeof (ADVANCED_LOGGER_PRE_MEM_HEADER)) {
+    PreMemDiscard (LoggerInfo, NumberOfBytes);
+    return LoggerInfo;
+  }
+
+  for ( ; ;) {
+    CurrentBuffer = LoggerInfo->LogCurrent;
+    UsedSize      = (UINTN)(CurrentBuffer - LoggerInfo->LogBuffer);
+    if ((UsedSize >= LoggerInfo->LogBufferSize) ||
+        ((LoggerInfo->LogBufferSize - UsedSize) < EntrySize))
+    {
+      NewLoggerInfo = PreMemSpill (LoggerInfo);
+      if (NewLoggerInfo == NULL) {
+        PreMemDiscard (LoggerInfo, NumberOfBytes);
+        return LoggerInfo;
+      }
+
+      LoggerInfo = NewLoggerInfo;
+      Header     = PRE_MEM_HEADER_FROM_ALI (LoggerInfo);
+      continue;
+    }
+
+    NewBuffer = PA_FROM_PTR ((CHAR8_FROM_PA (CurrentBuffer) + EntrySize));
+    OldValue  = InterlockedCompareExchange64 (
+                  (UINT64 *)&LoggerInfo->LogCurrent,
+                  (UINT64)CurrentBuffer,
+                  (UINT64)NewBuffer
+                  );
+    if (OldValue == CurrentBuffer) {
+      break;
+    }
+  }
+
+  TimeStamp            = GetPerformanceCounter ();
+  Entry                = (ADVANCED_LOGGER_PRE_MEM_ENTRY *)PTR_FROM_PA (CurrentBuffer);
+  Entry->TimeStampLow  = (UINT32)TimeStamp;
+  Entry->TimeStampHigh = (UINT32)RShiftU64 (TimeStamp, 32);
+  Entry->DebugLevel    = (UINT32)DebugLevel;
+  Entry->RepeatCount   = 0;
+  CopyMem (Entry->MessageText, Buffer, NumberOfBytes);
+  Entry->MessageLen = (UINT16)NumberOfBytes;
+  Header->LastEntry = (UINT32)(CurrentBuffer - LoggerInfo->LogBuffer);
+
+  return LoggerInfo;
+}
+
+/**
+  Appends a standard message entry to the permanent log.
+
+  @param  NewLoggerInfo    Permanent Logger Info block.
+  @param  DebugLevel       Debug level of the message.
+  @param  TimeStamp        Time stamp of the message.
+  @param  Buffer           Message.
+  @param  NumberOfBytes    Number of bytes in the message.
+**/
+STATIC
+VOID
+PreMemAppend (
+  IN       ADVANCED_LOGGER_INFO  *NewLoggerInfo,
+  IN       UINT32                DebugLevel,
+  IN       UINT64                TimeStamp,
+  IN CONST CHAR8                 *Buffer,
+  IN       UINTN                 NumberOfBytes
+  )
+{
+  ADVANCED_LOGGER_MESSAGE_ENTRY  *Entry;
+  UINTN                          EntrySize;
+  UINTN                          UsedSize;
+
+  EntrySize = MESSAGE_ENTRY_SIZE (NumberOfBytes);
+  UsedSize  = (UINTN)(NewLoggerInfo->LogCurrent - NewLoggerInfo->LogBuffer);
+  if ((UsedSize >= NewLoggerInfo->LogBufferSize) ||
+      ((NewLoggerInfo->LogBufferSize - UsedSize) < EntrySize))
+  {
+    NewLoggerInfo->DiscardedSize += (UINT32)NumberOfBytes;
+    return;
+  }
+
+  Entry             = (ADVANCED_LOGGER_MESSAGE_ENTRY *)PTR_FROM_PA (NewLoggerInfo->LogCurrent);
+  Entry->TimeStamp  = TimeStamp;
+  Entry->DebugLevel = DebugLevel;
+  Entry->MessageLen = (UINT16)NumberOfBytes;
+  CopyMem (Entry->MessageText, Buffer, NumberOfBytes);
+  Entry->Signature = MESSAGE_ENTRY_SIGNATURE;
+
+  NewLoggerInfo->LogCurrent += EntrySize;
+}
+
+/**
+  Expands the entries of one compact region into the permanent log.  A folded repeat becomes
+  the message followed by a note of how many more times it was logged.
+
+  @param  LoggerInfo     Logger Info block of the region.
+  @param  NewLoggerInfo  Permanent Logger Info block.
+**/
+STATIC
+VOID
+PreMemExpandRegion (
+  IN  ADVANCED_LOGGER_INFO  *LoggerInfo,
+  IN  ADVANCED_LOGGER_INFO  *NewLoggerInfo
+  )
+{
+  ADVANCED_LOGGER_PRE_MEM_ENTRY  *Entry;
+  CHAR8                          Repeat[PRE_MEM_REPEAT_MESSAGE_SIZE];
+  UINTN                          RepeatLen;
+  UINT64                         TimeStamp;
+  UINTN                          Offset;
+  UINTN                          EndOffset;
+
+  if (PRE_MEM_HEADER_FROM_ALI (LoggerInfo)->Signature != ADVANCED_LOGGER_PRE_MEM_SIGNATURE) {
+    return;
+  }
+
+  Offset    = 0;
+  EndOffset = (UINTN)(LoggerInfo->LogCurrent - LoggerInfo->LogBuffer);
+  while (EndOffset - Offset >= sizeof (ADVANCED_LOGGER_PRE_MEM_ENTRY)) {
+    Entry = (ADVANCED_LOGGER_PRE_MEM_ENTRY *)PTR_FROM_PA (LoggerInfo->LogBuffer + Offset);
+
+    //
+    // The size of an entry that was never completed is unknown, so the region ends there.
+    //
+    if ((Entry->MessageLen == 0) || (PRE_MEM_ENTRY_SIZE (Entry->MessageLen) > EndOffset - Offset)) {
+      break;
+    }
+
+    TimeStamp = LShiftU64 (Entry->TimeStampHigh, 32) | Entry->TimeStampLow;
+    PreMemAppend (NewLoggerInfo, Entry->DebugLevel, TimeStamp, Entry->MessageText, Entry->MessageLen);
+    if (Entry->RepeatCount != 0) {
+      RepeatLen = AsciiSPrint (Repeat, sizeof (Repeat), "(last message repeated %d more times)\n", Entry->RepeatCount);
+      PreMemAppend (NewLoggerInfo, Entry->DebugLevel, TimeStamp, Repeat, RepeatLen);
+    }
+
+    Offset += PRE_MEM_ENTRY_SIZE (Entry->MessageLen);
+  }
+}
+
+/**
+  Expands the regions of the compact pre-memory log into the permanent log, and frees the
+  regions that filled.  The current region is left for the caller to free.
+
+  @param  LoggerInfo     Logger Info block of the current region.
+  @param  NewLoggerInfo  Permanent Logger Info block, with LogBuffer, LogCurrent and
+                         LogBufferSize set.  Messages that do not fit are added to its
+                         DiscardedSize.
+**/
+VOID
+AdvancedLoggerPreMemMigrate (
+  IN  ADVANCED_LOGGER_INFO  *LoggerInfo,
+  IN  ADVANCED_LOGGER_INFO  *NewLoggerInfo
+  )
+{
+  EFI_HOB_GUID_TYPE              *GuidHob;
+  ADVANCED_LOGGER_PRE_MEM_SPILL  *Spill;
+
+  //
+  // The spill HOBs are in the order the regions filled.
+  //
+  GuidHob = GetFirstGuidHob (&gAdvancedLoggerPreMemSpillHobGuid);
+  while (GuidHob != NULL) {
+    Spill = (ADVANCED_LOGGER_PRE_MEM_SPILL *)GET_GUID_HOB_DATA (GuidHob);
+    if (Spill->Region != 0) {
+      PreMemExpandRegion (ALI_FROM_PA (Spill->Region), NewLoggerInfo);
+      PeiServicesFreePages (Spill->Region, Spill->Pages);
+      Spill->Region = 0;
+    }
+
+    GuidHob = GetNextGuidHob (&gAdvancedLoggerPreMemSpillHobGuid, GET_NEXT_HOB (GuidHob));
+  }
+
+  PreMemExpandRegion (LoggerInfo, NewLoggerInfo);
+}
@@ -0,0 +1,146 @@
+/** @file
+    Advanced Logger PEI Core pre-memory log declarations
+
+    With PcdAdvancedLoggerPreMemCompact, the temporary RAM log that PEI Core allocates when
+    there is no SEC logger holds compact entries, and a message repeating the one before it
+    only increments a count.  When the region fills, up to PcdAdvancedLoggerPreMemSpillRegions
+    further regions are allocated and described by gAdvancedLoggerPreMemSpillHobGuid HOBs.
+    At memory discovered, every region is expanded into the permanent log as standard
+    ADVANCED_LOGGER_MESSAGE_ENTRY entries, so nothing after PEI sees the compact format.
+
+    Copyright (C) Microsoft Corporation. All rights reserved.
+    SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __ADVANCED_LOGGER_PRE_MEM_H__
+#define __ADVANCED_LOGGER_PRE_MEM_H__
+
+#define ADVANCED_LOGGER_PRE_MEM_SIGNATURE  SIGNATURE_32('A','L','P','M')
+
+#define PRE_MEM_NO_ENTRY  MAX_UINT32
+
+//
+// Region flags
+//
+#define PRE_MEM_FLAG_SPILLING      0x01               // A spill region is being allocated
+#define PRE_MEM_FLAG_SPILL_FAILED  0x02               // No further region could be allocated
+
+#pragma pack (push, 1)
+
+//
+// A compact region is ADVANCED_LOGGER_INFO, this header, then the entries.  LogBuffer
+// points at the first entry.
+//
+typedef struct {
+  UINT32    Signature;                            // Signature 'ALPM'
+  UINT32    LastEntry;                            // Offset of the last entry from LogBuffer
+  UINT32    Region;                               // Position in the chain, 1 for the first region
+  UINT32    Flags;                                // PRE_MEM_FLAG_*
+} ADVANCED_LOGGER_PRE_MEM_HEADER;
+
+//
+// The signature of ADVANCED_LOGGER_MESSAGE_ENTRY is dropped and the time stamp is split,
+// so an entry needs only 4 byte alignment.  MessageLen is written last, and a zero length
+// marks an entry that was never completed.
+//
+typedef struct {
+  UINT32    TimeStampLow;                         // Time stamp of the first occurrence
+  UINT32    TimeStampHigh;                        //
+  UINT32    DebugLevel;                           // Debug Level
+  UINT16    MessageLen;                           // Number of bytes in Message
+  UINT16    RepeatCount;                          // Further occurrences folded into this entry
+  CHAR8     MessageText[];                        // Message Text
+} ADVANCED_LOGGER_PRE_MEM_ENTRY;
+
+#pragma pack (pop)
+
+STATIC_ASSERT (sizeof (ADVANCED_LOGGER_PRE_MEM_HEADER) % 8 == 0, "Pre Mem Header Misaligned");
+
+#define PRE_MEM_ENTRY_SIZE(LenOfMessage)  (ALIGN_VALUE(sizeof(ADVANCED_LOGGER_PRE_MEM_ENTRY) + LenOfMessage, 4))
+
+//
+// Data of a gAdvancedLoggerPreMemSpillHobGuid HOB.  One is built for each region that
+// filled, in order.  Region is cleared once the region has been migrated and freed.
+//
+typedef struct {
+  EFI_PHYSICAL_ADDRESS    Region;                 // ADVANCED_LOGGER_INFO of the full region
+  UINT32                  Pages;                  // Size of the region
+  UINT32                  Reserved;               //
+} ADVANCED_LOGGER_PRE_MEM_SPILL;
+
+extern EFI_GUID  gAdvancedLoggerPreMemSpillHobGuid;
+
+/**
+  Reports whether the log described by LoggerInfo is a compact pre-memory log.
+
+  @param  LoggerInfo  Logger Info block.
+
+  @retval TRUE        Messages go through AdvancedLoggerPreMemWrite.
+  @retval FALSE       Messages are standard entries.
+**/
+BOOLEAN
+AdvancedLoggerPreMemIsCompact (
+  IN  ADVANCED_LOGGER_INFO  *LoggerInfo
+  );
+
+/**
+  Lays out a compact region in a Logger Info block whose other fields are set.
+
+  @param  LoggerInfo  Logger Info block at the start of the region.
+  @param  Pages       Size of the region.
+  @param  Region      Position of the region in the chain, 1 for the first.
+**/
+VOID
+AdvancedLoggerPreMemInitRegion (
+  IN  ADVANCED_LOGGER_INFO  *LoggerInfo,
+  IN  UINTN                 Pages,
+  IN  UINT32                Region
+  );
+
+/**
+  Writes a message to the compact pre-memory log, folding it into the last entry when it
+  repeats it, and moving to a new region when the current one is full.
+
+  @param  LoggerInfo       Logger Info block of the current region.
+  @param  DebugLevel       Debug level of the message.
+  @param  Buffer           Message.
+  @param  NumberOfBytes    Number of bytes in the message, 1 to MAX_UINT16.
+
+  @return  The Logger Info block of the region now current.
+**/
+ADVANCED_LOGGER_INFO *
+AdvancedLoggerPreMemWrite (
+  IN       ADVANCED_LOGGER_INFO  *LoggerInfo,
+  IN       UINTN                 DebugLevel,
+  IN CONST CHAR8                 *Buffer,
+  IN       UINTN                 NumberOfBytes
+  );
+
+/**
+  Expands the regions of the compact pre-memory log into the permanent log, and frees the
+  regions that filled.  The current region is left for the caller to free.
+
+  @param  LoggerInfo     Logger Info block of the current region.
+  @param  NewLoggerInfo  Permanent Logger Info block, with LogBuffer, LogCurrent and
+                         LogBufferSize set.  Messages that do not fit are added to its
+                         DiscardedSize.
+**/
+VOID
+AdvancedLoggerPreMemMigrate (
+  IN  ADVANCED_LOGGER_INFO  *LoggerInfo,
+  IN  ADVANCED_LOGGER_INFO  *NewLoggerInfo
+  );
+
+/**
+  Makes LoggerInfo the current Logger Info block, for the Advanced Logger HOB and for PEI Core.
+  Provided by the PEI Core library instance.
+
+  @param  LoggerInfo  Logger Info block of the new region.
+**/
+VOID
+AdvancedLoggerPreMemSetLoggerInfo (
+  IN  ADVANCED_LOGGER_INFO  *LoggerInfo
+  );
+
+#endif // __ADVANCED_LOGGER_PRE_MEM_H__
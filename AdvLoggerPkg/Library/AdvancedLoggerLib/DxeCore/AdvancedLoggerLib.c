@@ -10,7 +10,10 @@
 
 #include <AdvancedLoggerInternal.h>
 
+#include <Guid/EventGroup.h>
+
 #include <Protocol/AdvancedLogger.h>
+#include <Protocol/ResetNotification.h>
 #include <Protocol/VariablePolicy.h>
 #include <AdvancedLoggerInternalProtocol.h>
 
@@ -35,6 +38,16 @@ STATIC UINT32                mBufferSize  = 0;
 STATIC EFI_PHYSICAL_ADDRESS  mMaxAddress  = 0;
 STATIC BOOLEAN               mInitialized = FALSE;
 
+//
+// With PcdAdvancedLoggerHdwPortDeferred, a timer on the BSP drains the memory log to the
+// hardware port, writing at most ADV_LOG_HDW_PORT_BYTES_PER_EVENT bytes of messages per tick.
+//
+#define ADV_LOG_HDW_PORT_DRAIN_PERIOD     (50 * 10000)        // 50 ms, in 100 ns units
+#define ADV_LOG_HDW_PORT_BYTES_PER_EVENT  4096
+
+STATIC EFI_EVENT                        mHdwPortDrainEvent         = NULL;
+STATIC EFI_RESET_NOTIFICATION_PROTOCOL  *mResetNotificationProtocol = NULL;
+
 VOID
 EFIAPI
 AdvancedLoggerWriteProtocol (
@@ -336,6 +349,217 @@ Cleanup:
   return Status;
 }
 
+/**
+    OnHdwPortDrainTimer
+
+    Writes the next part of the memory log to the hardware port.
+
+  **/
+STATIC
+VOID
+EFIAPI
+OnHdwPortDrainTimer (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  ADVANCED_LOGGER_INFO  *LoggerInfo;
+
+  LoggerInfo = AdvancedLoggerGetLoggerInfo ();
+  if ((LoggerInfo != NULL) && LoggerInfo->HdwPortDeferred) {
+    AdvancedLoggerHdwPortDrain (LoggerInfo, ADV_LOG_HDW_PORT_BYTES_PER_EVENT);
+  }
+}
+
+/**
+    StopHdwPortDrain
+
+    Returns the hardware port to synchronous writes, and writes everything pending.
+
+  **/
+STATIC
+VOID
+StopHdwPortDrain (
+  VOID
+  )
+{
+  ADVANCED_LOGGER_INFO  *LoggerInfo;
+
+  LoggerInfo = AdvancedLoggerGetLoggerInfo ();
+  if ((LoggerInfo != NULL) && LoggerInfo->HdwPortDeferred) {
+    // Messages written from here on go directly to the hardware port, so end the
+    // deferral before the final drain.
+    LoggerInfo->HdwPortDeferred = FALSE;
+    AdvancedLoggerHdwPortDrain (LoggerInfo, MAX_UINTN);
+  }
+}
+
+/**
+    OnHdwPortExitBootServices
+
+    There is no timer after ExitBootServices, so the drain agent stops here.
+
+  **/
+STATIC
+VOID
+EFIAPI
+OnHdwPortExitBootServices (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  EFI_SYSTEM_TABLE  *SystemTable;
+
+  SystemTable = (EFI_SYSTEM_TABLE *)Context;
+
+  StopHdwPortDrain ();
+  SystemTable->BootServices->CloseEvent (Event);
+  if (mHdwPortDrainEvent != NULL) {
+    SystemTable->BootServices->CloseEvent (mHdwPortDrainEvent);
+    mHdwPortDrainEvent = NULL;
+  }
+}
+
+/**
+    OnHdwPortResetNotification
+
+    Writes everything pending before the system resets.
+
+  **/
+STATIC
+VOID
+EFIAPI
+OnHdwPortResetNotification (
+  IN EFI_RESET_TYPE  ResetType,
+  IN EFI_STATUS      ResetStatus,
+  IN UINTN           DataSize,
+  IN VOID            *ResetData OPTIONAL
+  )
+{
+  StopHdwPortDrain ();
+}
+
+/**
+    OnResetNotificationProtocolNotification
+
+    Registers the reset handler of the drain agent.
+
+  **/
+STATIC
+VOID
+EFIAPI
+OnResetNotificationProtocolNotification (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  EFI_SYSTEM_TABLE  *SystemTable;
+  EFI_STATUS        Status;
+
+  SystemTable = (EFI_SYSTEM_TABLE *)Context;
+
+  Status = SystemTable->BootServices->LocateProtocol (&gEfiResetNotificationProtocolGuid, NULL, (VOID **)&mResetNotificationProtocol);
+  if (EFI_ERROR (Status)) {
+    return;
+  }
+
+  SystemTable->BootServices->CloseEvent (Event);
+
+  Status = mResetNotificationProtocol->RegisterResetNotify (mResetNotificationProtocol, OnHdwPortResetNotification);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: failed to register Reset Notification handler (%r)\n", __FUNCTION__, Status));
+  }
+
+  return;
+}
+
+/**
+    OnTimerArchNotification
+
+    Starts the drain agent once timer events can be signaled.  The messages written to
+    the hardware port so far were written synchronously, so the drain starts at the
+    current end of the log.
+
+  **/
+STATIC
+VOID
+EFIAPI
+OnTimerArchNotification (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  ADVANCED_LOGGER_INFO  *LoggerInfo;
+  EFI_SYSTEM_TABLE      *SystemTable;
+  EFI_EVENT             ExitBootServicesEvent;
+  EFI_STATUS            Status;
+
+  SystemTable = (EFI_SYSTEM_TABLE *)Context;
+
+  SystemTable->BootServices->CloseEvent (Event);
+
+  LoggerInfo = AdvancedLoggerGetLoggerInfo ();
+  if ((LoggerInfo == NULL) || LoggerInfo->HdwPortDisabled) {
+    return;
+  }
+
+  Status = SystemTable->BootServices->CreateEvent (
+                                        EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                                        TPL_CALLBACK,
+                                        OnHdwPortDrainTimer,
+                                        NULL,
+                                        &mHdwPortDrainEvent
+                                        );
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: failed to create drain timer event (%r)\n", __FUNCTION__, Status));
+    mHdwPortDrainEvent = NULL;
+    return;
+  }
+
+  Status = SystemTable->BootServices->CreateEventEx (
+                                        EVT_NOTIFY_SIGNAL,
+                                        TPL_NOTIFY,
+                                        OnHdwPortExitBootServices,
+                                        SystemTable,
+                                        &gEfiEventExitBootServicesGuid,
+                                        &ExitBootServicesEvent
+                                        );
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: failed to create ExitBootServices event (%r)\n", __FUNCTION__, Status));
+    goto Cleanup;
+  }
+
+  //
+  // Start draining at the end of the log, then defer.  A message from another CPU that
+  // slips in between is written twice rather than lost.
+  //
+  LoggerInfo->HdwPortDrained  = (UINT32)(LoggerInfo->LogCurrent - LoggerInfo->LogBuffer);
+  LoggerInfo->HdwPortDeferred = TRUE;
+
+  Status = SystemTable->BootServices->SetTimer (mHdwPortDrainEvent, TimerPeriodic, ADV_LOG_HDW_PORT_DRAIN_PERIOD);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: failed to start drain timer (%r)\n", __FUNCTION__, Status));
+    LoggerInfo->HdwPortDeferred = FALSE;
+    SystemTable->BootServices->CloseEvent (ExitBootServicesEvent);
+    goto Cleanup;
+  }
+
+  ProcessProtocolRegistration (
+    SystemTable,
+    &gEfiResetNotificationProtocolGuid,
+    OnResetNotificationProtocolNotification
+    );
+
+  return;
+
+Cleanup:
+  SystemTable->BootServices->CloseEvent (mHdwPortDrainEvent);
+  mHdwPortDrainEvent = NULL;
+  return;
+}
+
 /**
   DxeCore Advanced Logger initialization.
  **/
@@ -397,6 +621,14 @@ DxeCoreAdvancedLoggerLibConstructor (
     OnRealTimeClockArchNotification
     );
 
+  if (FeaturePcdGet (PcdAdvancedLoggerHdwPortDeferred)) {
+    ProcessProtocolRegistration (
+      SystemTable,
+      &gEfiTimerArchProtocolGuid,
+      OnTimerArchNotification
+      );
+  }
+
   if (FeaturePcdGet (PcdAdvancedLoggerLocator)) {
     ProcessProtocolRegistration (
       SystemTable,
@@ -37,6 +37,7 @@
 #include <Library/SynchronizationLib.h>
 
 #include "../AdvancedLoggerCommon.h"
+#include "../AdvancedLoggerPreMem.h"
 
 //
 // Prototype function used in Memory Discovered Ppi
@@ -212,19 +213,28 @@ InstallPermanentMemoryBuffer (
       if (!EFI_ERROR (Status)) {
         NewLoggerInfo = ALI_FROM_PA (NewLogBuffer);
         CopyMem ((VOID *)NewLoggerInfo, (VOID *)LoggerInfo, sizeof (ADVANCED_LOGGER_INFO));
-        CurrentLogOffset         = (UINTN)(LoggerInfo->LogCurrent - LoggerInfo->LogBuffer);
-        NewLoggerInfo->LogBuffer = PA_FROM_PTR ((CHAR8 *)(NewLoggerInfo + 1));
-
-        if (CurrentLogOffset > 0) {
-          CopyMem (
-            PTR_FROM_PA (NewLoggerInfo->LogBuffer),
-            PTR_FROM_PA (LoggerInfo->LogBuffer),
-            (CurrentLogOffset)
-            );
+        CurrentLogOffset             = (UINTN)(LoggerInfo->LogCurrent - LoggerInfo->LogBuffer);
+        NewLoggerInfo->LogBuffer     = PA_FROM_PTR ((CHAR8 *)(NewLoggerInfo + 1));
+        NewLoggerInfo->LogBufferSize = EFI_PAGES_TO_SIZE (FixedPcdGet32 (PcdAdvancedLoggerPages)) - sizeof (ADVANCED_LOGGER_INFO);
+
+        if (AdvancedLoggerPreMemIsCompact (LoggerInfo)) {
+          //
+          // Expand the compact entries of every pre-memory region, the spill regions first.
+          //
+          NewLoggerInfo->LogCurrent = NewLoggerInfo->LogBuffer;
+          AdvancedLoggerPreMemMigrate (LoggerInfo, NewLoggerInfo);
+        } else {
+          if (CurrentLogOffset > 0) {
+            CopyMem (
+              PTR_FROM_PA (NewLoggerInfo->LogBuffer),
+              PTR_FROM_PA (LoggerInfo->LogBuffer),
+              (CurrentLogOffset)
+              );
+          }
+
+          NewLoggerInfo->LogCurrent = PA_FROM_PTR (CHAR8_FROM_PA (NewLoggerInfo->LogBuffer) + CurrentLogOffset);
         }
 
-        NewLoggerInfo->LogBufferSize  = EFI_PAGES_TO_SIZE (FixedPcdGet32 (PcdAdvancedLoggerPages)) - sizeof (ADVANCED_LOGGER_INFO);
-        NewLoggerInfo->LogCurrent     = PA_FROM_PTR (CHAR8_FROM_PA (NewLoggerInfo->LogBuffer) + CurrentLogOffset);
         NewLoggerInfo->InPermanentRAM = TRUE;
 
         PeiCoreInstance               = PEI_CORE_INSTANCE_FROM_PS_THIS (PeiServices);
@@ -273,6 +283,32 @@ InstallPermanentMemoryBuffer (
   return EFI_SUCCESS;
 }
 
+/**
+  Makes LoggerInfo the current Logger Info block, for the Advanced Logger HOB and for PEI Core.
+
+  Called when the compact pre-memory log moves to a spill region.
+
+  @param  LoggerInfo  Logger Info block of the new region.
+**/
+VOID
+AdvancedLoggerPreMemSetLoggerInfo (
+  IN  ADVANCED_LOGGER_INFO  *LoggerInfo
+  )
+{
+  EFI_HOB_GUID_TYPE       *GuidHob;
+  ADVANCED_LOGGER_PTR     *LogPtr;
+  CONST EFI_PEI_SERVICES  **PeiServices;
+
+  GuidHob = GetFirstGuidHob (&gAdvancedLoggerHobGuid);
+  if (GuidHob != NULL) {
+    LogPtr            = (ADVANCED_LOGGER_PTR *)GET_GUID_HOB_DATA (GuidHob);
+    LogPtr->LogBuffer = PA_FROM_PTR (LoggerInfo);
+  }
+
+  PeiServices                                                  = GetPeiServicesTablePointer ();
+  (PEI_CORE_INSTANCE_FROM_PS_THIS (PeiServices))->PlatformBlob = PA_FROM_PTR (LoggerInfo);
+}
+
 /**
   Validate Info Blocks
 
@@ -485,6 +521,10 @@ AdvancedLoggerGetLoggerInfo (
         LoggerInfo->LogBufferSize = BufferSize - sizeof (ADVANCED_LOGGER_INFO);
         LoggerInfo->LogCurrent    = LoggerInfo->LogBuffer;
         LoggerInfo->HwPrintLevel  = FixedPcdGet32 (PcdAdvancedLoggerHdwPortDebugPrintErrorLevel);
+        if (FeaturePcdGet (PcdAdvancedLoggerPreMemCompact) && !FeaturePcdGet (PcdAdvancedLoggerPeiInRAM)) {
+          AdvancedLoggerPreMemInitRegion (LoggerInfo, Pages, 1);
+        }
+
         AdvancedLoggerHdwPortInitialize ();
         LoggerInfo->HdwPortInitialized = TRUE;
       }
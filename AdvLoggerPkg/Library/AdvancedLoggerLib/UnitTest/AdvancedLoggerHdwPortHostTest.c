@@ -0,0 +1,667 @@
+/** @file
+  Host based unit tests for the deferred hardware port of AdvancedLoggerLib.
+
+  Messages go through AdvancedLoggerWrite and AdvancedLoggerHdwPortLib, as they do in
+  DXE Core.  The stand-in SerialPortLib keeps what reaches the port, and charges a fixed
+  number of ticks of the stand-in TimerLib for each write and each byte, so the time a
+  logging caller spends waiting on the port is the tick count across its call.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+#include <AdvancedLoggerInternal.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../AdvancedLoggerCommon.h"
+
+#define UNIT_TEST_NAME     "Advanced Logger Hardware Port Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define LOG_SIZE              SIZE_256KB
+#define SMALL_LOG_SIZE        SIZE_4KB
+#define PORT_OUTPUT_SIZE      SIZE_256KB
+#define MAX_MESSAGE_TEXT      SIZE_256KB
+#define MESSAGE_LENGTH        80
+#define DRAIN_BYTES_PER_TICK  4096
+#define PORT_FILTERED_LEVEL   DEBUG_LOAD                              // Left out of PcdAdvancedLoggerHdwPortDebugPrintErrorLevel by the DSC.
+
+//
+// Cost of the stand-in serial port, in ticks.  About 115200 baud for a 1 MHz counter.
+//
+#define PORT_TICKS_PER_WRITE  20
+#define PORT_TICKS_PER_BYTE   87
+
+STATIC ADVANCED_LOGGER_INFO  *mLoggerInfo;
+STATIC UINT64                mTicks;
+
+//
+// Text of the messages written, in order.
+//
+STATIC CHAR8  *mWrittenText;
+STATIC UINTN  mWrittenTextLength;
+
+//
+// What reached the stand-in serial port.
+//
+STATIC CHAR8  *mPortOutput;
+STATIC UINTN  mPortOutputLength;
+STATIC UINTN  mPortWrites;
+
+/**
+  Stands in for TimerLib.
+**/
+UINT64
+EFIAPI
+GetPerformanceCounter (
+  VOID
+  )
+{
+  return mTicks;
+}
+
+/**
+  Stands in for SerialPortLib.
+**/
+RETURN_STATUS
+EFIAPI
+SerialPortInitialize (
+  VOID
+  )
+{
+  return RETURN_SUCCESS;
+}
+
+/**
+  Stands in for SerialPortLib.  Keeps the bytes, and takes the time a UART would.
+**/
+UINTN
+EFIAPI
+SerialPortWrite (
+  IN UINT8  *Buffer,
+  IN UINTN  NumberOfBytes
+  )
+{
+  if (mPortOutputLength + NumberOfBytes <= PORT_OUTPUT_SIZE) {
+    CopyMem (&mPortOutput[mPortOutputLength], Buffer, NumberOfBytes);
+    mPortOutputLength += NumberOfBytes;
+  }
+
+  mPortWrites++;
+  mTicks += PORT_TICKS_PER_WRITE + (PORT_TICKS_PER_BYTE * NumberOfBytes);
+  return NumberOfBytes;
+}
+
+/**
+  Stands in for the DXE Core library instance.
+**/
+ADVANCED_LOGGER_INFO *
+EFIAPI
+AdvancedLoggerGetLoggerInfo (
+  VOID
+  )
+{
+  return mLoggerInfo;
+}
+
+/**
+  Logs a message through AdvancedLoggerWrite.
+
+  @param[in] Record  Record the text as expected at the port.
+
+  @return  The ticks the caller spent in AdvancedLoggerWrite.
+**/
+STATIC
+UINT64
+LogMessage (
+  IN UINT32       DebugLevel,
+  IN CONST CHAR8  *Message,
+  IN UINTN        Length,
+  IN BOOLEAN      Record
+  )
+{
+  UINT64  Start;
+
+  if (Record && (mWrittenTextLength + Length <= MAX_MESSAGE_TEXT)) {
+    CopyMem (&mWrittenText[mWrittenTextLength], Message, Length);
+    mWrittenTextLength += Length;
+  }
+
+  Start = mTicks;
+  AdvancedLoggerWrite (DebugLevel, Message, Length);
+  return mTicks - Start;
+}
+
+/**
+  Formats a message as one of several CPUs would, and logs it.
+
+  @return  The ticks the caller spent in AdvancedLoggerWrite.
+**/
+STATIC
+UINT64
+LogCpuMessage (
+  IN UINT32  DebugLevel,
+  IN UINTN   Cpu,
+  IN UINTN   Index
+  )
+{
+  CHAR8  Message[MESSAGE_LENGTH];
+  UINTN  Length;
+
+  Length = AsciiSPrint (Message, sizeof (Message), "CPU[%03d]: step %d of the AP procedure done\n", Cpu, Index);
+  return LogMessage (DebugLevel, Message, Length, TRUE);
+}
+
+/**
+  Drains the log as the timer of the drain agent does, until nothing is left.
+
+  @return  Number of timer ticks it took.
+**/
+STATIC
+UINTN
+DrainAll (
+  VOID
+  )
+{
+  UINTN  Ticks;
+
+  Ticks = 0;
+  while (AdvancedLoggerHdwPortDrain (mLoggerInfo, DRAIN_BYTES_PER_TICK) != 0) {
+    Ticks++;
+  }
+
+  return Ticks;
+}
+
+/**
+  Returns the offset from LogBuffer of the end of the log.
+**/
+STATIC
+UINT32
+LogEndOffset (
+  VOID
+  )
+{
+  return (UINT32)(mLoggerInfo->LogCurrent - mLoggerInfo->LogBuffer);
+}
+
+/**
+  Creates a log the way the DXE Core library instance does, and starts the drain agent
+  the way it does once timers are available.
+**/
+STATIC
+UNIT_TEST_STATUS
+SetUpLogOfSize (
+  IN UINTN    Size,
+  IN BOOLEAN  Deferred
+  )
+{
+  mLoggerInfo = AllocateZeroPool (Size);
+  UT_ASSERT_NOT_NULL (mLoggerInfo);
+
+  mLoggerInfo->Signature          = ADVANCED_LOGGER_SIGNATURE;
+  mLoggerInfo->Version            = ADVANCED_LOGGER_VERSION;
+  mLoggerInfo->LogBuffer          = PA_FROM_PTR (mLoggerInfo + 1);
+  mLoggerInfo->LogBufferSize      = (UINT32)(Size - sizeof (ADVANCED_LOGGER_INFO));
+  mLoggerInfo->LogCurrent         = mLoggerInfo->LogBuffer;
+  mLoggerInfo->HwPrintLevel       = MAX_UINT32;
+  mLoggerInfo->InPermanentRAM     = TRUE;
+  mLoggerInfo->HdwPortInitialized = TRUE;
+
+  mTicks             = 0;
+  mWrittenTextLength = 0;
+  mPortOutputLength  = 0;
+  mPortWrites        = 0;
+
+  if (Deferred) {
+    mLoggerInfo->HdwPortDrained  = LogEndOffset ();
+    mLoggerInfo->HdwPortDeferred = TRUE;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Sets up a log with the drain agent running.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetUpDeferred (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return SetUpLogOfSize (LOG_SIZE, TRUE);
+}
+
+/**
+  Sets up a log that writes to the port synchronously.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetUpSynchronous (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return SetUpLogOfSize (LOG_SIZE, FALSE);
+}
+
+/**
+  Sets up a small log with the drain agent running.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetUpSmallDeferred (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return SetUpLogOfSize (SMALL_LOG_SIZE, TRUE);
+}
+
+/**
+  Frees the log.
+**/
+STATIC
+VOID
+EFIAPI
+CleanUpLog (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mLoggerInfo != NULL) {
+    FreePool ((VOID *)mLoggerInfo);
+    mLoggerInfo = NULL;
+  }
+}
+
+/**
+  Checks that the port received exactly the recorded messages, in order.
+**/
+STATIC
+UNIT_TEST_STATUS
+CheckPortOutput (
+  VOID
+  )
+{
+  UT_ASSERT_EQUAL (mPortOutputLength, mWrittenTextLength);
+  UT_ASSERT_MEM_EQUAL (mPortOutput, mWrittenText, mWrittenTextLength);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Without the drain agent every caller waits for its message to go out of the port.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SynchronousCallerLatency (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT64  Latency;
+  UINTN   Index;
+
+  Latency = 0;
+  for (Index = 0; Index < 1000; Index++) {
+    Latency += LogCpuMessage (DEBUG_INFO, Index % 8, Index);
+  }
+
+  UT_ASSERT_EQUAL (mPortWrites, 1000);
+  UT_ASSERT_EQUAL (Latency, (1000 * PORT_TICKS_PER_WRITE) + (mWrittenTextLength * PORT_TICKS_PER_BYTE));
+  UT_ASSERT_EQUAL (CheckPortOutput (), UNIT_TEST_PASSED);
+
+  DEBUG ((DEBUG_INFO, "Synchronous: %ld ticks in callers for %d bytes\n", Latency, mWrittenTextLength));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  With the drain agent no caller waits on the port, and the agent writes everything in
+  order, in bursts.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DeferredCallerLatency (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT64  Latency;
+  UINT64  Start;
+  UINTN   Index;
+  UINTN   Ticks;
+
+  Latency = 0;
+  for (Index = 0; Index < 1000; Index++) {
+    Latency += LogCpuMessage (DEBUG_INFO, Index % 8, Index);
+  }
+
+  UT_ASSERT_EQUAL (Latency, 0);
+  UT_ASSERT_EQUAL (mPortWrites, 0);
+
+  Start = mTicks;
+  Ticks = DrainAll ();
+  UT_ASSERT_EQUAL (CheckPortOutput (), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mLoggerInfo->HdwPortDrained, LogEndOffset ());
+
+  //
+  // Each timer tick drains about DRAIN_BYTES_PER_TICK bytes, and the bytes go out in
+  // bursts of several messages.
+  //
+  UT_ASSERT_TRUE (Ticks <= (mWrittenTextLength / DRAIN_BYTES_PER_TICK) + 1);
+  UT_ASSERT_TRUE (mPortWrites <= 1000 / 4);
+
+  DEBUG ((
+    DEBUG_INFO,
+    "Deferred: %ld ticks in callers, %ld in the drain agent over %d timer ticks and %d port writes\n",
+    Latency,
+    mTicks - Start,
+    Ticks,
+    mPortWrites
+    ));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Messages are filtered by HwPrintLevel when they are drained, not when they are logged.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DrainFiltersByLevel (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mLoggerInfo->HwPrintLevel = DEBUG_INFO;
+
+  LogMessage (DEBUG_INFO, "info 1\n", 7, TRUE);
+  LogMessage (DEBUG_VERBOSE, "verbose 1\n", 10, TRUE);
+  LogMessage (DEBUG_WARN, "warn 1\n", 7, FALSE);
+  LogMessage (DEBUG_INFO, "info 2\n", 7, TRUE);
+
+  mLoggerInfo->HwPrintLevel = DEBUG_INFO | DEBUG_VERBOSE;
+  DrainAll ();
+  UT_ASSERT_EQUAL (CheckPortOutput (), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mLoggerInfo->HdwPortDrained, LogEndOffset ());
+
+  //
+  // A message no level lets through still moves the drain on.
+  //
+  LogMessage (DEBUG_WARN, "warn 2\n", 7, FALSE);
+  UT_ASSERT_EQUAL (DrainAll (), 1);
+  UT_ASSERT_EQUAL (CheckPortOutput (), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mLoggerInfo->HdwPortDrained, LogEndOffset ());
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The port filter applies to each message.  A message the port leaves out does not go out
+  in a burst with messages of levels it lets through.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DrainKeepsPortFilter (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  UT_ASSERT_EQUAL (PcdGet32 (PcdAdvancedLoggerHdwPortDebugPrintErrorLevel) & PORT_FILTERED_LEVEL, 0);
+
+  for (Index = 0; Index < 4; Index++) {
+    LogMessage (DEBUG_INFO, "info\n", 5, TRUE);
+    LogMessage (PORT_FILTERED_LEVEL, "load\n", 5, FALSE);
+    LogMessage (PORT_FILTERED_LEVEL, "load\n", 5, FALSE);
+    LogMessage (DEBUG_WARN, "warn\n", 5, TRUE);
+  }
+
+  DrainAll ();
+  UT_ASSERT_EQUAL (CheckPortOutput (), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mLoggerInfo->HdwPortDrained, LogEndOffset ());
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  An error, such as an ASSERT, is at the port when AdvancedLoggerWrite returns, after
+  everything logged before it.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ErrorFlushesPending (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < 100; Index++) {
+    LogCpuMessage (DEBUG_INFO, Index % 4, Index);
+  }
+
+  UT_ASSERT_EQUAL (mPortOutputLength, 0);
+
+  LogMessage (DEBUG_ERROR, "ASSERT [Test] Test.c(1): FALSE\n", 31, TRUE);
+  UT_ASSERT_EQUAL (CheckPortOutput (), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mLoggerInfo->HdwPortDrained, LogEndOffset ());
+
+  LogCpuMessage (DEBUG_INFO, 0, 100);
+  UT_ASSERT_EQUAL (DrainAll (), 1);
+  UT_ASSERT_EQUAL (CheckPortOutput (), UNIT_TEST_PASSED);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The drain keeps to its budget, and stops at an entry whose writer has not finished it,
+  so that nothing after it goes out first.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DrainKeepsOrder (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  ADVANCED_LOGGER_MESSAGE_ENTRY  *Entry;
+
+  LogMessage (DEBUG_INFO, "first\n", 6, TRUE);
+  LogMessage (DEBUG_INFO, "second\n", 7, TRUE);
+  LogMessage (DEBUG_INFO, "third\n", 6, TRUE);
+
+  UT_ASSERT_EQUAL (AdvancedLoggerHdwPortDrain (mLoggerInfo, 1), 6);
+  UT_ASSERT_EQUAL (mPortOutputLength, 6);
+
+  Entry            = (ADVANCED_LOGGER_MESSAGE_ENTRY *)PTR_FROM_PA (mLoggerInfo->LogBuffer + mLoggerInfo->HdwPortDrained);
+  Entry->Signature = 0;
+  UT_ASSERT_EQUAL (AdvancedLoggerHdwPortDrain (mLoggerInfo, MAX_UINTN), 0);
+  UT_ASSERT_EQUAL (mPortOutputLength, 6);
+
+  Entry->Signature = MESSAGE_ENTRY_SIGNATURE;
+  UT_ASSERT_EQUAL (AdvancedLoggerHdwPortDrain (mLoggerInfo, MAX_UINTN), 13);
+  UT_ASSERT_EQUAL (CheckPortOutput (), UNIT_TEST_PASSED);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A second drain does not write to the port.  An error logged while a drain is in progress
+  is written directly, and the drain in progress writes it again in order.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+OneDrainAtATime (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32  Drained;
+
+  LogMessage (DEBUG_INFO, "pending\n", 8, TRUE);
+
+  Drained                     = mLoggerInfo->HdwPortDrained;
+  mLoggerInfo->HdwPortDrained = Drained | ADVANCED_LOGGER_DRAIN_LOCK;
+
+  UT_ASSERT_EQUAL (AdvancedLoggerHdwPortDrain (mLoggerInfo, MAX_UINTN), 0);
+  UT_ASSERT_EQUAL (mPortOutputLength, 0);
+  LogMessage (DEBUG_ERROR, "error\n", 6, TRUE);
+  UT_ASSERT_EQUAL (mPortOutputLength, 6);
+  UT_ASSERT_MEM_EQUAL (mPortOutput, "error\n", 6);
+
+  mPortOutputLength           = 0;
+  mLoggerInfo->HdwPortDrained = Drained;
+  DrainAll ();
+  UT_ASSERT_EQUAL (CheckPortOutput (), UNIT_TEST_PASSED);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Once the log is full, messages go straight to the port, after everything in the log.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+FullLogWritesDirectly (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+  UINTN  InLog;
+
+  //
+  // The messages are all of the same size, so none fits once one has not.
+  //
+  InLog = 0;
+  for (Index = 0; mLoggerInfo->DiscardedSize == 0; Index++) {
+    LogCpuMessage (DEBUG_INFO, 0, 100 + Index);
+    if (mLoggerInfo->DiscardedSize == 0) {
+      InLog++;
+    }
+  }
+
+  UT_ASSERT_TRUE (InLog > 0);
+  UT_ASSERT_EQUAL (CheckPortOutput (), UNIT_TEST_PASSED);
+
+  LogCpuMessage (DEBUG_INFO, 1, 100 + Index);
+  UT_ASSERT_EQUAL (CheckPortOutput (), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (DrainAll (), 0);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  After a message has been discarded, a message that still fits waits in the log, and
+  reaches the port once.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DiscardDoesNotDuplicate (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CHAR8  Large[SMALL_LOG_SIZE];
+
+  SetMem (Large, sizeof (Large) - 1, 'x');
+  Large[sizeof (Large) - 1] = '\n';
+
+  LogMessage (DEBUG_INFO, Large, sizeof (Large), TRUE);
+  UT_ASSERT_TRUE (mLoggerInfo->DiscardedSize != 0);
+  UT_ASSERT_EQUAL (CheckPortOutput (), UNIT_TEST_PASSED);
+
+  LogMessage (DEBUG_INFO, "fits\n", 5, TRUE);
+  UT_ASSERT_EQUAL (mPortOutputLength, sizeof (Large));
+  DrainAll ();
+  UT_ASSERT_EQUAL (CheckPortOutput (), UNIT_TEST_PASSED);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  deferred hardware port and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      HdwPortSuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  mWrittenText = AllocatePool (MAX_MESSAGE_TEXT);
+  mPortOutput  = AllocatePool (PORT_OUTPUT_SIZE);
+  if ((mWrittenText == NULL) || (mPortOutput == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&HdwPortSuiteHandle, Framework, "Advanced Logger hardware port tests", "AdvancedLoggerLib.HdwPort", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for HdwPortSuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (HdwPortSuiteHandle, "Synchronous writes wait on the port", "SynchronousCallerLatency", SynchronousCallerLatency, SetUpSynchronous, CleanUpLog, NULL);
+  AddTestCase (HdwPortSuiteHandle, "Deferred writes do not wait on the port", "DeferredCallerLatency", DeferredCallerLatency, SetUpDeferred, CleanUpLog, NULL);
+  AddTestCase (HdwPortSuiteHandle, "The drain filters by level", "DrainFiltersByLevel", DrainFiltersByLevel, SetUpDeferred, CleanUpLog, NULL);
+  AddTestCase (HdwPortSuiteHandle, "The port filter applies to each message", "DrainKeepsPortFilter", DrainKeepsPortFilter, SetUpDeferred, CleanUpLog, NULL);
+  AddTestCase (HdwPortSuiteHandle, "An error flushes what is pending", "ErrorFlushesPending", ErrorFlushesPending, SetUpDeferred, CleanUpLog, NULL);
+  AddTestCase (HdwPortSuiteHandle, "The drain keeps the order", "DrainKeepsOrder", DrainKeepsOrder, SetUpDeferred, CleanUpLog, NULL);
+  AddTestCase (HdwPortSuiteHandle, "One drain at a time", "OneDrainAtATime", OneDrainAtATime, SetUpDeferred, CleanUpLog, NULL);
+  AddTestCase (HdwPortSuiteHandle, "A full log writes directly", "FullLogWritesDirectly", FullLogWritesDirectly, SetUpSmallDeferred, CleanUpLog, NULL);
+  AddTestCase (HdwPortSuiteHandle, "A discard does not duplicate", "DiscardDoesNotDuplicate", DiscardDoesNotDuplicate, SetUpSmallDeferred, CleanUpLog, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  if (mWrittenText != NULL) {
+    FreePool (mWrittenText);
+  }
+
+  if (mPortOutput != NULL) {
+    FreePool (mPortOutput);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
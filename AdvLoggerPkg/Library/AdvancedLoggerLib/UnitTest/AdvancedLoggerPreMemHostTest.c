@@ -0,0 +1,916 @@
+/** @file
+  Host based unit tests for the compact PEI Core pre-memory log of AdvancedLoggerLib.
+
+  Messages go through AdvancedLoggerWrite, as they do in PEI Core.  The stand-in PEI services
+  hand out temporary RAM from a fixed budget, the size of the first region and the spill
+  regions the PCDs allow, and the stand-in HobLib keeps a small HOB list.  At the end of each
+  test the log is migrated to a permanent buffer the way InstallPermanentMemoryBuffer does,
+  and the messages read back, with folded repeats expanded again, must be the ones written.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <PiPei.h>
+#include <AdvancedLoggerInternal.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../AdvancedLoggerCommon.h"
+#include "../AdvancedLoggerPreMem.h"
+
+#define UNIT_TEST_NAME     "Advanced Logger Pre-Memory Log Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define PERMANENT_LOG_SIZE  SIZE_4MB
+#define MAX_MESSAGES        SIZE_256KB
+#define MAX_MESSAGE_TEXT    SIZE_4MB
+#define HOB_LIST_SIZE       SIZE_4KB
+#define MAX_REGIONS         16
+#define MESSAGE_LENGTH      120
+
+#define REPEAT_PREFIX  "(last message repeated "
+#define POLL_MESSAGE   "Waiting for SMBus host controller to become idle...\n"
+
+//
+// Logged by the stand-in HobLib.  Its entry is no smaller than that of the messages the tests
+// write, so it never fits where they did not.
+//
+#define HOB_MESSAGE  "HOB list grown by DEBUG\n"
+
+typedef struct {
+  UINT32    DebugLevel;
+  UINT32    Offset;                               // Offset of the text in mWrittenText
+  UINT16    Length;
+} TEST_MESSAGE;
+
+STATIC ADVANCED_LOGGER_INFO  *mCurrent;
+STATIC ADVANCED_LOGGER_INFO  *mPermanent;
+STATIC UINT64                mTicks;
+STATIC UINT32                mRandomState;
+
+//
+// Messages written, in order.
+//
+STATIC TEST_MESSAGE  *mWritten;
+STATIC UINTN         mWrittenCount;
+STATIC CHAR8         *mWrittenText;
+STATIC UINTN         mWrittenTextLength;
+
+//
+// Temporary RAM handed out by the stand-in PEI services.
+//
+STATIC VOID   *mRegions[MAX_REGIONS];
+STATIC UINTN  mRegionPages[MAX_REGIONS];
+STATIC UINTN  mTempRamPages;
+STATIC UINTN  mTempRamBudget;
+STATIC UINTN  mAllocateFailures;
+
+//
+// HOB list of the stand-in HobLib.
+//
+STATIC UINT64   mHobList[HOB_LIST_SIZE / sizeof (UINT64)];
+STATIC UINTN    mHobListLength;
+STATIC BOOLEAN  mLogDuringHob;
+
+/**
+  Stands in for TimerLib.
+**/
+UINT64
+EFIAPI
+GetPerformanceCounter (
+  VOID
+  )
+{
+  return ++mTicks;
+}
+
+/**
+  Stands in for AdvancedLoggerHdwPortLib.
+**/
+UINTN
+EFIAPI
+AdvancedLoggerHdwPortWrite (
+  IN UINTN  DebugLevel,
+  IN UINT8  *Buffer,
+  IN UINTN  NumberOfBytes
+  )
+{
+  return NumberOfBytes;
+}
+
+/**
+  Stands in for the PEI Core library instance.
+**/
+ADVANCED_LOGGER_INFO *
+EFIAPI
+AdvancedLoggerGetLoggerInfo (
+  VOID
+  )
+{
+  return mCurrent;
+}
+
+/**
+  Stands in for the PEI Core library instance.
+**/
+VOID
+AdvancedLoggerPreMemSetLoggerInfo (
+  IN  ADVANCED_LOGGER_INFO  *LoggerInfo
+  )
+{
+  mCurrent = LoggerInfo;
+}
+
+/**
+  Stands in for PeiServicesLib.  Allocates temporary RAM within mTempRamBudget.
+**/
+EFI_STATUS
+EFIAPI
+PeiServicesAllocatePages (
+  IN EFI_MEMORY_TYPE        MemoryType,
+  IN UINTN                  Pages,
+  OUT EFI_PHYSICAL_ADDRESS  *Memory
+  )
+{
+  UINTN  Index;
+
+  if (mTempRamPages + Pages > mTempRamBudget) {
+    mAllocateFailures++;
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Index = 0; Index < MAX_REGIONS; Index++) {
+    if (mRegions[Index] == NULL) {
+      mRegions[Index] = AllocatePool (EFI_PAGES_TO_SIZE (Pages));
+      if (mRegions[Index] == NULL) {
+        break;
+      }
+
+      SetMem (mRegions[Index], EFI_PAGES_TO_SIZE (Pages), 0xAF);
+      mRegionPages[Index] = Pages;
+      mTempRamPages      += Pages;
+      *Memory             = PA_FROM_PTR (mRegions[Index]);
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_OUT_OF_RESOURCES;
+}
+
+/**
+  Stands in for PeiServicesLib.
+**/
+EFI_STATUS
+EFIAPI
+PeiServicesFreePages (
+  IN EFI_PHYSICAL_ADDRESS  Memory,
+  IN UINTN                 Pages
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < MAX_REGIONS; Index++) {
+    if ((mRegions[Index] != NULL) && (PA_FROM_PTR (mRegions[Index]) == Memory)) {
+      if (mRegionPages[Index] != Pages) {
+        return EFI_INVALID_PARAMETER;
+      }
+
+      FreePool (mRegions[Index]);
+      mRegions[Index] = NULL;
+      mTempRamPages  -= Pages;
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Stands in for HobLib.  Returns the next GUID HOB from HobStart on.
+**/
+VOID *
+EFIAPI
+GetNextGuidHob (
+  IN CONST EFI_GUID  *Guid,
+  IN CONST VOID      *HobStart
+  )
+{
+  EFI_HOB_GENERIC_HEADER  *Hob;
+
+  for (Hob = (EFI_HOB_GENERIC_HEADER *)HobStart; Hob->HobType != EFI_HOB_TYPE_END_OF_HOB_LIST; Hob = GET_NEXT_HOB (Hob)) {
+    if ((Hob->HobType == EFI_HOB_TYPE_GUID_EXTENSION) && CompareGuid (Guid, &((EFI_HOB_GUID_TYPE *)Hob)->Name)) {
+      return Hob;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Stands in for HobLib.
+**/
+VOID *
+EFIAPI
+GetFirstGuidHob (
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  return GetNextGuidHob (Guid, mHobList);
+}
+
+/**
+  Stands in for HobLib.  Optionally logs a message first, as a DEBUG in HOB creation would.
+**/
+VOID *
+EFIAPI
+BuildGuidDataHob (
+  IN CONST EFI_GUID  *Guid,
+  IN VOID            *Data,
+  IN UINTN           DataLength
+  )
+{
+  EFI_HOB_GUID_TYPE       *Hob;
+  EFI_HOB_GENERIC_HEADER  *End;
+  UINTN                   Length;
+
+  if (mLogDuringHob) {
+    AdvancedLoggerWrite (DEBUG_INFO, HOB_MESSAGE, sizeof (HOB_MESSAGE) - 1);
+  }
+
+  Length = ALIGN_VALUE (sizeof (EFI_HOB_GUID_TYPE) + DataLength, 8);
+  if (mHobListLength + Length + sizeof (EFI_HOB_GENERIC_HEADER) > sizeof (mHobList)) {
+    return NULL;
+  }
+
+  Hob                   = (EFI_HOB_GUID_TYPE *)((UINT8 *)mHobList + mHobListLength);
+  Hob->Header.HobType   = EFI_HOB_TYPE_GUID_EXTENSION;
+  Hob->Header.HobLength = (UINT16)Length;
+  CopyGuid (&Hob->Name, Guid);
+  CopyMem (Hob + 1, Data, DataLength);
+  mHobListLength += Length;
+
+  End            = (EFI_HOB_GENERIC_HEADER *)((UINT8 *)mHobList + mHobListLength);
+  End->HobType   = EFI_HOB_TYPE_END_OF_HOB_LIST;
+  End->HobLength = sizeof (EFI_HOB_GENERIC_HEADER);
+  return Hob + 1;
+}
+
+/**
+  Returns a pseudo random number.
+**/
+STATIC
+UINT32
+Random (
+  VOID
+  )
+{
+  mRandomState = mRandomState * 1103515245 + 12345;
+  return mRandomState >> 8;
+}
+
+/**
+  Logs a message through AdvancedLoggerWrite and records it.
+**/
+STATIC
+VOID
+LogMessage (
+  IN UINT32       DebugLevel,
+  IN CONST CHAR8  *Message,
+  IN UINTN        Length
+  )
+{
+  if ((mWrittenCount < MAX_MESSAGES) && (mWrittenTextLength + Length <= MAX_MESSAGE_TEXT)) {
+    mWritten[mWrittenCount].DebugLevel = DebugLevel;
+    mWritten[mWrittenCount].Offset     = (UINT32)mWrittenTextLength;
+    mWritten[mWrittenCount].Length     = (UINT16)Length;
+    CopyMem (&mWrittenText[mWrittenTextLength], Message, Length);
+    mWrittenCount++;
+    mWrittenTextLength += Length;
+  }
+
+  AdvancedLoggerWrite (DebugLevel, Message, Length);
+}
+
+/**
+  Formats a message and logs it.
+**/
+STATIC
+VOID
+EFIAPI
+LogPrint (
+  IN UINT32       DebugLevel,
+  IN CONST CHAR8  *Format,
+  ...
+  )
+{
+  CHAR8    Message[MESSAGE_LENGTH];
+  VA_LIST  Marker;
+  UINTN    Length;
+
+  VA_START (Marker, Format);
+  Length = AsciiVSPrint (Message, sizeof (Message), Format, Marker);
+  VA_END (Marker);
+
+  LogMessage (DebugLevel, Message, Length);
+}
+
+/**
+  Returns the temporary RAM budget for the first region and every spill region allowed.
+**/
+STATIC
+UINTN
+FullBudget (
+  VOID
+  )
+{
+  return FixedPcdGet32 (PcdAdvancedLoggerPreMemPages) * (1 + FixedPcdGet32 (PcdAdvancedLoggerPreMemSpillRegions));
+}
+
+/**
+  Creates the first pre-memory region the way AdvancedLoggerGetLoggerInfo does.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetUpLog (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_PHYSICAL_ADDRESS  Buffer;
+  UINTN                 Pages;
+
+  ZeroMem (mRegions, sizeof (mRegions));
+  mTempRamPages      = 0;
+  mTempRamBudget     = FullBudget ();
+  mAllocateFailures  = 0;
+  mHobListLength     = 0;
+  mLogDuringHob      = FALSE;
+  mWrittenCount      = 0;
+  mWrittenTextLength = 0;
+  mTicks             = 0;
+  mRandomState       = 0x2468;
+  mPermanent         = NULL;
+
+  ((EFI_HOB_GENERIC_HEADER *)mHobList)->HobType   = EFI_HOB_TYPE_END_OF_HOB_LIST;
+  ((EFI_HOB_GENERIC_HEADER *)mHobList)->HobLength = sizeof (EFI_HOB_GENERIC_HEADER);
+
+  Pages = FixedPcdGet32 (PcdAdvancedLoggerPreMemPages);
+  UT_ASSERT_NOT_EFI_ERROR (PeiServicesAllocatePages (EfiReservedMemoryType, Pages, &Buffer));
+
+  mCurrent = ALI_FROM_PA (Buffer);
+  ZeroMem ((VOID *)mCurrent, EFI_PAGES_TO_SIZE (Pages));
+  mCurrent->Signature     = ADVANCED_LOGGER_SIGNATURE;
+  mCurrent->Version       = ADVANCED_LOGGER_VERSION;
+  mCurrent->LogBuffer     = PA_FROM_PTR (mCurrent + 1);
+  mCurrent->LogBufferSize = EFI_PAGES_TO_SIZE (Pages) - sizeof (ADVANCED_LOGGER_INFO);
+  mCurrent->LogCurrent    = mCurrent->LogBuffer;
+  mCurrent->HwPrintLevel  = MAX_UINT32;
+  AdvancedLoggerPreMemInitRegion (mCurrent, Pages, 1);
+
+  UT_ASSERT_TRUE (AdvancedLoggerPreMemIsCompact (mCurrent));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Frees what a test left behind.
+**/
+STATIC
+VOID
+EFIAPI
+CleanUpLog (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < MAX_REGIONS; Index++) {
+    if (mRegions[Index] != NULL) {
+      FreePool (mRegions[Index]);
+      mRegions[Index] = NULL;
+    }
+  }
+
+  if (mPermanent != NULL) {
+    FreePool ((VOID *)mPermanent);
+    mPermanent = NULL;
+  }
+
+  mCurrent = NULL;
+}
+
+/**
+  Returns the number of spill HOBs.
+
+  @param[in] Live  Count only the HOBs that still refer to a region.
+**/
+STATIC
+UINTN
+SpillCount (
+  IN BOOLEAN  Live
+  )
+{
+  VOID                           *GuidHob;
+  ADVANCED_LOGGER_PRE_MEM_SPILL  *Spill;
+  UINTN                          Count;
+
+  Count = 0;
+  for (GuidHob = GetFirstGuidHob (&gAdvancedLoggerPreMemSpillHobGuid); GuidHob != NULL;
+       GuidHob = GetNextGuidHob (&gAdvancedLoggerPreMemSpillHobGuid, GET_NEXT_HOB (GuidHob)))
+  {
+    Spill = (ADVANCED_LOGGER_PRE_MEM_SPILL *)GET_GUID_HOB_DATA (GuidHob);
+    if (!Live || (Spill->Region != 0)) {
+      Count++;
+    }
+  }
+
+  return Count;
+}
+
+/**
+  Migrates the log to a permanent buffer the way InstallPermanentMemoryBuffer does.
+
+  @param[in] LogBufferSize  Size of the permanent log buffer.
+**/
+STATIC
+UNIT_TEST_STATUS
+MigrateLog (
+  IN UINTN  LogBufferSize
+  )
+{
+  ADVANCED_LOGGER_INFO  *LoggerInfo;
+
+  LoggerInfo = mCurrent;
+  UT_ASSERT_TRUE (AdvancedLoggerPreMemIsCompact (LoggerInfo));
+
+  mPermanent = AllocateZeroPool (sizeof (ADVANCED_LOGGER_INFO) + LogBufferSize);
+  UT_ASSERT_NOT_NULL (mPermanent);
+
+  CopyMem ((VOID *)mPermanent, (VOID *)LoggerInfo, sizeof (ADVANCED_LOGGER_INFO));
+  mPermanent->LogBuffer     = PA_FROM_PTR ((CHAR8 *)(mPermanent + 1));
+  mPermanent->LogBufferSize = (UINT32)LogBufferSize;
+  mPermanent->LogCurrent    = mPermanent->LogBuffer;
+  AdvancedLoggerPreMemMigrate (LoggerInfo, mPermanent);
+  mPermanent->InPermanentRAM = TRUE;
+
+  mCurrent = mPermanent;
+  UT_ASSERT_NOT_EFI_ERROR (PeiServicesFreePages (PA_FROM_PTR (LoggerInfo), FixedPcdGet32 (PcdAdvancedLoggerPreMemPages)));
+  UT_ASSERT_FALSE (AdvancedLoggerPreMemIsCompact (mCurrent));
+
+  //
+  // Every region has been freed, and no spill HOB refers to one.
+  //
+  UT_ASSERT_EQUAL (mTempRamPages, 0);
+  UT_ASSERT_EQUAL (SpillCount (TRUE), 0);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Checks whether a permanent log entry is the note of a folded repeat.
+
+  @param[in]  Entry  Log entry.
+  @param[out] Count  Receives the number of further occurrences.
+**/
+STATIC
+BOOLEAN
+IsRepeatNote (
+  IN  ADVANCED_LOGGER_MESSAGE_ENTRY  *Entry,
+  OUT UINTN                          *Count
+  )
+{
+  CHAR8  Text[MESSAGE_LENGTH];
+
+  if ((Entry->MessageLen >= sizeof (Text)) ||
+      (Entry->MessageLen < sizeof (REPEAT_PREFIX) - 1) ||
+      (CompareMem (Entry->MessageText, REPEAT_PREFIX, sizeof (REPEAT_PREFIX) - 1) != 0))
+  {
+    return FALSE;
+  }
+
+  CopyMem (Text, Entry->MessageText, Entry->MessageLen);
+  Text[Entry->MessageLen] = '\0';
+  *Count                  = AsciiStrDecimalToUintn (&Text[sizeof (REPEAT_PREFIX) - 1]);
+  return TRUE;
+}
+
+/**
+  Checks that the permanent log holds the first ExpectedCount messages written, in order,
+  once folded repeats are expanded.
+
+  @param[in] ExpectedCount  Number of messages the log must hold.
+**/
+STATIC
+UNIT_TEST_STATUS
+CheckPermanentLog (
+  IN UINTN  ExpectedCount
+  )
+{
+  ADVANCED_LOGGER_MESSAGE_ENTRY  *Entry;
+  ADVANCED_LOGGER_MESSAGE_ENTRY  *Previous;
+  UINT8                          *Data;
+  UINT8                          *End;
+  UINT64                         TimeStamp;
+  UINTN                          Count;
+  UINTN                          Index;
+
+  Data      = (UINT8 *)PTR_FROM_PA (mPermanent->LogBuffer);
+  End       = (UINT8 *)PTR_FROM_PA (mPermanent->LogCurrent);
+  Previous  = NULL;
+  TimeStamp = 0;
+  Index     = 0;
+  while (Data < End) {
+    Entry = (ADVANCED_LOGGER_MESSAGE_ENTRY *)Data;
+    UT_ASSERT_EQUAL (Entry->Signature, MESSAGE_ENTRY_SIGNATURE);
+    UT_ASSERT_TRUE (Data + MESSAGE_ENTRY_SIZE (Entry->MessageLen) <= End);
+    UT_ASSERT_TRUE (Entry->TimeStamp >= TimeStamp);
+    TimeStamp = Entry->TimeStamp;
+
+    if (!IsRepeatNote (Entry, &Count)) {
+      Previous = Entry;
+      Count    = 1;
+    }
+
+    UT_ASSERT_NOT_NULL (Previous);
+    UT_ASSERT_TRUE (Count != 0);
+    UT_ASSERT_TRUE (Index + Count <= ExpectedCount);
+    while (Count-- != 0) {
+      UT_ASSERT_EQUAL (Previous->DebugLevel, mWritten[Index].DebugLevel);
+      UT_ASSERT_EQUAL (Previous->MessageLen, mWritten[Index].Length);
+      UT_ASSERT_MEM_EQUAL (Previous->MessageText, &mWrittenText[mWritten[Index].Offset], Previous->MessageLen);
+      Index++;
+    }
+
+    Data += MESSAGE_ENTRY_SIZE (Entry->MessageLen);
+  }
+
+  UT_ASSERT_EQUAL (Index, ExpectedCount);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Replays the messages of a pre-memory boot: PEIM loads, PPI installs, progress codes, memory
+  training results, and status polling loops that log the same line many times.
+
+  @param[in] Peims  Number of PEIMs to log.
+**/
+STATIC
+VOID
+ReplayPreMemBoot (
+  IN UINTN  Peims
+  )
+{
+  UINTN  Peim;
+  UINTN  Index;
+  UINTN  Polls;
+  UINTN  Channel;
+  UINTN  Rank;
+
+  LogPrint (DEBUG_INFO, "SecCoreStartupWithStack(0x%x, 0x%x)\n", 0xFFFCC094, 0x820000);
+  for (Peim = 0; Peim < Peims; Peim++) {
+    LogPrint (DEBUG_INFO, "Loading PEIM %08X-A8C3-4B6E-9F0D-%08X\n", Random (), (UINT32)Peim);
+    LogPrint (DEBUG_LOAD, "Loading PEIM at 0x%08x EntryPoint=0x%08x Peim%d.efi\n", (UINT32)(0xFFE00000 + (Peim << 12)), (UINT32)(0xFFE00240 + (Peim << 12)), (UINT32)Peim);
+    LogPrint (DEBUG_INFO, "PROGRESS CODE: V03020003 I0\n");
+    for (Index = Random () % 4; Index != 0; Index--) {
+      LogPrint (DEBUG_INFO, "Install PPI: %08X-%04X-%04X\n", Random (), Random () & 0xFFFF, Random () & 0xFFFF);
+    }
+
+    if (Random () % 3 == 0) {
+      for (Polls = 20 + Random () % 200; Polls != 0; Polls--) {
+        LogMessage (DEBUG_VERBOSE, POLL_MESSAGE, sizeof (POLL_MESSAGE) - 1);
+      }
+
+      LogPrint (DEBUG_INFO, "SMBus host controller ready after %d us\n", Random () % 10000);
+    }
+
+    if (Peim % 16 == 5) {
+      for (Channel = 0; Channel < 2; Channel++) {
+        for (Rank = 0; Rank < 4; Rank++) {
+          for (Polls = 3 + Random () % 40; Polls != 0; Polls--) {
+            LogPrint (DEBUG_VERBOSE, "MRC: Ch%d Rank%d training in progress\n", (UINT32)Channel, (UINT32)Rank);
+          }
+
+          LogPrint (DEBUG_INFO, "MRC: Ch%d Rank%d RxDqs margin %d TxDq margin %d\n", (UINT32)Channel, (UINT32)Rank, Random () % 64, Random () % 64);
+        }
+      }
+    }
+  }
+}
+
+/**
+  Returns the bytes the messages written take as standard entries.
+**/
+STATIC
+UINTN
+StandardLogSize (
+  VOID
+  )
+{
+  UINTN  Index;
+  UINTN  Size;
+
+  Size = 0;
+  for (Index = 0; Index < mWrittenCount; Index++) {
+    Size += MESSAGE_ENTRY_SIZE (mWritten[Index].Length);
+  }
+
+  return Size;
+}
+
+/**
+  A pre-memory log that would overflow the temporary RAM budget as standard entries fits when
+  compact, and migrates to the permanent log without losing a message.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ReplayWithinBudget (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  StandardSize;
+  UINTN  BudgetSize;
+  UINTN  Spills;
+
+  ReplayPreMemBoot (300);
+
+  StandardSize = StandardLogSize ();
+  BudgetSize   = EFI_PAGES_TO_SIZE (mTempRamBudget);
+  Spills       = SpillCount (FALSE);
+  DEBUG ((
+    DEBUG_INFO,
+    "%d messages: %d bytes as standard entries, budget %d bytes, %d spill regions used\n",
+    (UINT32)mWrittenCount,
+    (UINT32)StandardSize,
+    (UINT32)BudgetSize,
+    (UINT32)Spills
+    ));
+
+  UT_ASSERT_TRUE (StandardSize > BudgetSize);
+  UT_ASSERT_TRUE (Spills >= 1);
+  UT_ASSERT_TRUE (Spills <= FixedPcdGet32 (PcdAdvancedLoggerPreMemSpillRegions));
+  UT_ASSERT_EQUAL (mCurrent->DiscardedSize, 0);
+  UT_ASSERT_EQUAL (mAllocateFailures, 0);
+
+  UT_ASSERT_EQUAL (MigrateLog (PERMANENT_LOG_SIZE), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mPermanent->DiscardedSize, 0);
+  UT_ASSERT_EQUAL (CheckPermanentLog (mWrittenCount), UNIT_TEST_PASSED);
+
+  //
+  // The permanent log continues where the pre-memory log ended.
+  //
+  LogMessage (DEBUG_INFO, "Memory discovered\n", 18);
+  UT_ASSERT_EQUAL (CheckPermanentLog (mWrittenCount), UNIT_TEST_PASSED);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A repeat is folded only into the entry just before it, with the same level, up to MAX_UINT16
+  repeats an entry.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RepeatsAreFolded (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  ADVANCED_LOGGER_MESSAGE_ENTRY  *Entry;
+  UINTN                          Index;
+  UINTN                          Count;
+
+  for (Index = 0; Index < 5; Index++) {
+    LogMessage (DEBUG_INFO, "A\n", 2);
+  }
+
+  LogMessage (DEBUG_ERROR, "A\n", 2);
+  LogMessage (DEBUG_ERROR, "AA", 2);
+  for (Index = 0; Index < MAX_UINT16 + 3; Index++) {
+    LogMessage (DEBUG_INFO, "B\n", 2);
+  }
+
+  //
+  // A x5, A at another level, AA, then B with MAX_UINT16 repeats and B with 2.
+  //
+  UT_ASSERT_EQUAL (mCurrent->LogCurrent - mCurrent->LogBuffer, 5 * PRE_MEM_ENTRY_SIZE (2));
+  UT_ASSERT_EQUAL (SpillCount (FALSE), 0);
+
+  UT_ASSERT_EQUAL (MigrateLog (PERMANENT_LOG_SIZE), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (CheckPermanentLog (mWrittenCount), UNIT_TEST_PASSED);
+
+  Entry = (ADVANCED_LOGGER_MESSAGE_ENTRY *)PTR_FROM_PA (mPermanent->LogBuffer);
+  Entry = NEXT_LOG_ENTRY (Entry);
+  UT_ASSERT_TRUE (IsRepeatNote (Entry, &Count));
+  UT_ASSERT_EQUAL (Count, 4);
+  UT_ASSERT_EQUAL (Entry->DebugLevel, DEBUG_INFO);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  With no temporary RAM left for a spill region, messages that do not fit are counted as
+  discarded, and the spill is not attempted again for each of them.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+FullRegionDiscards (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CHAR8   *Long;
+  UINTN   Index;
+  UINTN   Kept;
+  UINT32  Discarded;
+
+  mTempRamBudget = FixedPcdGet32 (PcdAdvancedLoggerPreMemPages);
+
+  //
+  // A message longer than a region is discarded without a spill.
+  //
+  Long = AllocatePool (SIZE_64KB);
+  UT_ASSERT_NOT_NULL (Long);
+  SetMem (Long, SIZE_64KB, 'x');
+  AdvancedLoggerWrite (DEBUG_INFO, Long, MAX_UINT16);
+  FreePool (Long);
+  UT_ASSERT_EQUAL (mCurrent->DiscardedSize, MAX_UINT16);
+  UT_ASSERT_EQUAL (mAllocateFailures, 0);
+
+  Kept      = 0;
+  Discarded = MAX_UINT16;
+  for (Index = 0; Index < 4000; Index++) {
+    LogPrint (DEBUG_INFO, "Distinct message %05d\n", (UINT32)Index);
+    if (mCurrent->DiscardedSize == Discarded) {
+      Kept++;
+    } else {
+      Discarded = mCurrent->DiscardedSize;
+    }
+  }
+
+  UT_ASSERT_TRUE (Kept < 4000);
+  UT_ASSERT_EQUAL (mCurrent->DiscardedSize, MAX_UINT16 + (4000 - Kept) * 23);
+  UT_ASSERT_EQUAL (mAllocateFailures, 1);
+  UT_ASSERT_EQUAL (SpillCount (FALSE), 0);
+
+  UT_ASSERT_EQUAL (MigrateLog (PERMANENT_LOG_SIZE), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mPermanent->DiscardedSize, MAX_UINT16 + (4000 - Kept) * 23);
+  UT_ASSERT_EQUAL (CheckPermanentLog (Kept), UNIT_TEST_PASSED);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A message logged while a spill region is set up, as a DEBUG from HOB creation would be, is
+  discarded rather than starting another spill.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LogDuringSpill (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+  UINTN  Spills;
+
+  mLogDuringHob = TRUE;
+  for (Index = 0; Index < 2000; Index++) {
+    LogPrint (DEBUG_INFO, "Distinct message %05d\n", (UINT32)Index);
+  }
+
+  Spills = SpillCount (FALSE);
+  UT_ASSERT_TRUE (Spills >= 1);
+  UT_ASSERT_EQUAL (mCurrent->DiscardedSize, Spills * (sizeof (HOB_MESSAGE) - 1));
+
+  UT_ASSERT_EQUAL (MigrateLog (PERMANENT_LOG_SIZE), UNIT_TEST_PASSED);
+  UT_ASSERT_EQUAL (mPermanent->DiscardedSize, Spills * (sizeof (HOB_MESSAGE) - 1));
+  UT_ASSERT_EQUAL (CheckPermanentLog (mWrittenCount), UNIT_TEST_PASSED);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Messages that do not fit the permanent log at migration are counted as discarded.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+PermanentLogOverflow (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  ADVANCED_LOGGER_MESSAGE_ENTRY  *Entry;
+  UINT8                          *Data;
+  UINTN                          Kept;
+  UINTN                          Count;
+
+  ReplayPreMemBoot (40);
+  UT_ASSERT_EQUAL (MigrateLog (SIZE_4KB), UNIT_TEST_PASSED);
+  UT_ASSERT_TRUE (mPermanent->DiscardedSize != 0);
+  UT_ASSERT_TRUE (mPermanent->LogCurrent - mPermanent->LogBuffer <= SIZE_4KB);
+
+  //
+  // Count the messages kept, a repeat note standing for the occurrences it folds.
+  //
+  Kept = 0;
+  for (Data = (UINT8 *)PTR_FROM_PA (mPermanent->LogBuffer);
+       Data < (UINT8 *)PTR_FROM_PA (mPermanent->LogCurrent);
+       Data += MESSAGE_ENTRY_SIZE (Entry->MessageLen))
+  {
+    Entry = (ADVANCED_LOGGER_MESSAGE_ENTRY *)Data;
+    if (!IsRepeatNote (Entry, &Count)) {
+      Count = 1;
+    }
+
+    Kept += Count;
+  }
+
+  UT_ASSERT_EQUAL (CheckPermanentLog (Kept), UNIT_TEST_PASSED);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  pre-memory log and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      PreMemSuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  mWritten     = AllocatePool (MAX_MESSAGES * sizeof (TEST_MESSAGE));
+  mWrittenText = AllocatePool (MAX_MESSAGE_TEXT);
+  if ((mWritten == NULL) || (mWrittenText == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&PreMemSuiteHandle, Framework, "Advanced Logger pre-memory log tests", "AdvancedLoggerLib.PreMem", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for PreMemSuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (PreMemSuiteHandle, "A large pre-memory log fits the budget", "ReplayWithinBudget", ReplayWithinBudget, SetUpLog, CleanUpLog, NULL);
+  AddTestCase (PreMemSuiteHandle, "Repeated messages are folded", "RepeatsAreFolded", RepeatsAreFolded, SetUpLog, CleanUpLog, NULL);
+  AddTestCase (PreMemSuiteHandle, "A full region without a spill discards", "FullRegionDiscards", FullRegionDiscards, SetUpLog, CleanUpLog, NULL);
+  AddTestCase (PreMemSuiteHandle, "Messages logged during a spill", "LogDuringSpill", LogDuringSpill, SetUpLog, CleanUpLog, NULL);
+  AddTestCase (PreMemSuiteHandle, "The permanent log overflows at migration", "PermanentLogOverflow", PermanentLogOverflow, SetUpLog, CleanUpLog, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  if (mWritten != NULL) {
+    FreePool (mWritten);
+  }
+
+  if (mWrittenText != NULL) {
+    FreePool (mWrittenText);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
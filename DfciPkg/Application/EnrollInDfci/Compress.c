@@ -7,6 +7,10 @@
   This sequence is further divided into Blocks and Huffman codings
   are applied to each Block.
 
+  Repeated strings are found through hash chains over the source buffer.  Every position
+  is linked into the chain of the hash of its first THRESHOLD bytes, and a match is looked
+  for by walking that chain, newest first, for as long as the effort level allows.
+
   Copyright (c) 2007 - 2018, Intel Corporation. All rights reserved.<BR>
   SPDX-License-Identifier: BSD-2-Clause-Patent
 
@@ -16,25 +20,22 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 
+#include "Compress.h"
+
 //
 // Macro Definitions
 //
-typedef INT16 NODE;
-#define UINT8_MAX     0xff
-#define UINT8_BIT     8
-#define THRESHOLD     3
-#define INIT_CRC      0
-#define WNDBIT        13
-#define WNDSIZ        (1U << WNDBIT)
-#define MAXMATCH      256
-#define BLKSIZ        (1U << 14)      // 16 * 1024U
-#define PERC_FLAG     0x8000U
-#define CODE_BIT      16
-#define NIL           0
-#define MAX_HASH_VAL  (3 * WNDSIZ + (WNDSIZ / 512 + 1) * UINT8_MAX)
-#define HASH(LoopVar7, LoopVar5)  ((LoopVar7) + ((LoopVar5) << (WNDBIT - 9)) + WNDSIZ * 2)
-#define CRCPOLY  0xA001
-#define UPDATE_CRC(LoopVar5)  mCrc = mCrcTable[(mCrc ^ (LoopVar5)) & 0xFF] ^ (mCrc >> UINT8_BIT)
+#define UINT8_MAX  0xff
+#define UINT8_BIT  8
+#define THRESHOLD  3
+#define WNDBIT     13
+#define WNDSIZ     (1U << WNDBIT)
+#define MAXMATCH   256
+#define BLKSIZ     (1U << 14)         // 16 * 1024U
+#define CODE_BIT   16
+#define HASH_BIT   15
+#define HASH_SIZE  (1U << HASH_BIT)
+#define HASH(Ptr)  ((((UINT32)(Ptr)[0] << 10) ^ ((UINT32)(Ptr)[1] << 5) ^ (UINT32)(Ptr)[2]) & (HASH_SIZE - 1))
 
 //
 // C: the Char&Len Set; P: the Position Set; T: the exTra Set
@@ -50,6 +51,23 @@ typedef INT16 NODE;
 #else
 #define                 NPT  NP
 #endif
+
+//
+// How hard the match finder looks.  A match of NiceLength ends the search, and the next
+// position is not searched for a longer match when the current one is LazyLength or more.
+//
+typedef struct {
+  UINT32    MaxChain;
+  UINT32    NiceLength;
+  UINT32    LazyLength;
+} COMPRESS_EFFORT_LEVEL;
+
+STATIC CONST COMPRESS_EFFORT_LEVEL  mEffortLevels[CompressEffortMax] = {
+  { 8,      32,       16       },   // CompressEffortFast
+  { 128,    128,      64       },   // CompressEffortDefault
+  { WNDSIZ, MAXMATCH, MAXMATCH },   // CompressEffortBest
+};
+
 //
 // Function Prototypes
 //
@@ -72,16 +90,13 @@ STATIC UINT8  *mDst;
 STATIC UINT8  *mSrcUpperLimit;
 STATIC UINT8  *mDstUpperLimit;
 
-STATIC UINT8   *mLevel;
-STATIC UINT8   *mText;
-STATIC UINT8   *mChildCount;
 STATIC UINT8   *mBuf;
 STATIC UINT8   mCLen[NC];
 STATIC UINT8   mPTLen[NPT];
 STATIC UINT8   *mLen;
 STATIC INT16   mHeap[NC + 1];
-STATIC INT32   mRemainder;
-STATIC INT32   mMatchLen;
+STATIC UINT32  mMatchLen;
+STATIC UINT32  mMatchPos;
 STATIC INT32   mBitCount;
 STATIC INT32   mHeapSize;
 STATIC INT32   mTempInt32;
@@ -89,7 +104,6 @@ STATIC UINT32  mBufSiz = 0;
 STATIC UINT32  mOutputPos;
 STATIC UINT32  mOutputMask;
 STATIC UINT32  mSubBitBuf;
-STATIC UINT32  mCrc;
 STATIC UINT32  mCompSize;
 STATIC UINT32  mOrigSize;
 
@@ -98,50 +112,16 @@ STATIC UINT16  *mSortPtr;
 STATIC UINT16  mLenCnt[17];
 STATIC UINT16  mLeft[2 * NC - 1];
 STATIC UINT16  mRight[2 * NC - 1];
-STATIC UINT16  mCrcTable[UINT8_MAX + 1];
 STATIC UINT16  mCFreq[2 * NC - 1];
 STATIC UINT16  mCCode[NC];
 STATIC UINT16  mPFreq[2 * NP - 1];
 STATIC UINT16  mPTCode[NPT];
 STATIC UINT16  mTFreq[2 * NT - 1];
 
-STATIC NODE  mPos;
-STATIC NODE  mMatchPos;
-STATIC NODE  mAvail;
-STATIC NODE  *mPosition;
-STATIC NODE  *mParent;
-STATIC NODE  *mPrev;
-STATIC NODE  *mNext        = NULL;
-INT32        mHuffmanDepth = 0;
-
-/**
-  Make a CRC table.
-
-**/
-VOID
-MakeCrcTable (
-  VOID
-  )
-{
-  UINT32  LoopVar1;
-
-  UINT32  LoopVar2;
-
-  UINT32  LoopVar4;
-
-  for (LoopVar1 = 0; LoopVar1 <= UINT8_MAX; LoopVar1++) {
-    LoopVar4 = LoopVar1;
-    for (LoopVar2 = 0; LoopVar2 < UINT8_BIT; LoopVar2++) {
-      if ((LoopVar4 & 1) != 0) {
-        LoopVar4 = (LoopVar4 >> 1) ^ CRCPOLY;
-      } else {
-        LoopVar4 >>= 1;
-      }
-    }
-
-    mCrcTable[LoopVar1] = (UINT16)LoopVar4;
-  }
-}
+STATIC UINT32                       *mHashHead = NULL; // Newest position + 1 for each hash, 0 if none.
+STATIC UINT32                       *mHashPrev = NULL; // Next older position + 1 in the chain, by position % WNDSIZ.
+STATIC CONST COMPRESS_EFFORT_LEVEL  *mEffort;
+INT32                               mHuffmanDepth = 0;
 
 /**
   Put a dword to output stream
@@ -181,13 +161,11 @@ AllocateMemory (
   VOID
   )
 {
-  mText       = AllocateZeroPool (WNDSIZ * 2 + MAXMATCH);
-  mLevel      = AllocateZeroPool ((WNDSIZ + UINT8_MAX + 1) * sizeof (*mLevel));
-  mChildCount = AllocateZeroPool ((WNDSIZ + UINT8_MAX + 1) * sizeof (*mChildCount));
-  mPosition   = AllocateZeroPool ((WNDSIZ + UINT8_MAX + 1) * sizeof (*mPosition));
-  mParent     = AllocateZeroPool (WNDSIZ * 2 * sizeof (*mParent));
-  mPrev       = AllocateZeroPool (WNDSIZ * 2 * sizeof (*mPrev));
-  mNext       = AllocateZeroPool ((MAX_HASH_VAL + 1) * sizeof (*mNext));
+  mHashHead = AllocateZeroPool (HASH_SIZE * sizeof (*mHashHead));
+  mHashPrev = AllocateZeroPool (WNDSIZ * sizeof (*mHashPrev));
+  if ((mHashHead == NULL) || (mHashPrev == NULL)) {
+    return EFI_OUT_OF_RESOURCES;
+  }
 
   mBufSiz = BLKSIZ;
   mBuf    = AllocateZeroPool (mBufSiz);
@@ -214,32 +192,12 @@ FreeMemory (
   VOID
   )
 {
-  if (NULL != mText) {
-    FreePool (mText);
-  }
-
-  if (NULL != mLevel) {
-    FreePool (mLevel);
-  }
-
-  if (NULL != mChildCount) {
-    FreePool (mChildCount);
-  }
-
-  if (NULL != mPosition) {
-    FreePool (mPosition);
-  }
-
-  if (NULL != mParent) {
-    FreePool (mParent);
+  if (NULL != mHashHead) {
+    FreePool (mHashHead);
   }
 
-  if (NULL != mPrev) {
-    FreePool (mPrev);
-  }
-
-  if (NULL != mNext) {
-    FreePool (mNext);
+  if (NULL != mHashPrev) {
+    FreePool (mHashPrev);
   }
 
   if (NULL != mBuf) {
@@ -248,400 +206,92 @@ FreeMemory (
 }
 
 /**
-  Initialize String Info Log data structures.
+  Link a position into the hash chain of its first THRESHOLD bytes.
+
+  @param[in] Pos    Offset of the position in the source.
 **/
 VOID
-InitSlide (
-  VOID
+InsertPosition (
+  IN UINT32  Pos
   )
 {
-  NODE  LoopVar1;
+  UINT32  Hash;
 
-  SetMem (mLevel + WNDSIZ, (UINT8_MAX + 1) * sizeof (UINT8), 1);
-  SetMem (mPosition + WNDSIZ, (UINT8_MAX + 1) * sizeof (NODE), 0);
-
-  SetMem (mParent + WNDSIZ, WNDSIZ * sizeof (NODE), 0);
-
-  mAvail = 1;
-  for (LoopVar1 = 1; LoopVar1 < WNDSIZ - 1; LoopVar1++) {
-    mNext[LoopVar1] = (NODE)(LoopVar1 + 1);
+  if ((UINTN)(mSrcUpperLimit - mSrc) - Pos < THRESHOLD) {
+    return;
   }
 
-  mNext[WNDSIZ - 1] = NIL;
-  SetMem (mNext + WNDSIZ * 2, (MAX_HASH_VAL - WNDSIZ * 2 + 1) * sizeof (NODE), 0);
+  Hash                          = HASH (&mSrc[Pos]);
+  mHashPrev[Pos & (WNDSIZ - 1)] = mHashHead[Hash];
+  mHashHead[Hash]               = Pos + 1;
 }
 
 /**
-  Find child node given the parent node and the edge character
+  Find the longest earlier string, at most WNDSIZ bytes back, that the source at a position
+  starts with, and link the position into its hash chain.
 
-  @param[in] LoopVar6       The parent node.
-  @param[in] LoopVar5       The edge character.
-
-  @return             The child node.
-  @retval NIL(Zero)   No child could be found.
+  @param[in]  Pos       Offset of the position in the source.
+  @param[out] MatchPos  Offset of the match, valid if a match is returned.
 
+  @return The length of the match, or 0 if there is none of at least THRESHOLD bytes.
 **/
-NODE
-Child (
-  IN NODE   LoopVar6,
-  IN UINT8  LoopVar5
+UINT32
+FindMatch (
+  IN  UINT32  Pos,
+  OUT UINT32  *MatchPos
   )
 {
-  NODE  LoopVar4;
-
-  LoopVar4     = mNext[HASH (LoopVar6, LoopVar5)];
-  mParent[NIL] = LoopVar6;   /* sentinel */
-  while (mParent[LoopVar4] != LoopVar6) {
-    LoopVar4 = mNext[LoopVar4];
+  UINT8   *Scan;
+  UINT8   *Match;
+  UINT32  Available;
+  UINT32  MaxLength;
+  UINT32  BestLength;
+  UINT32  Length;
+  UINT32  Limit;
+  UINT32  Candidate;
+  UINT32  Chain;
+
+  Available = (UINT32)(mSrcUpperLimit - mSrc) - Pos;
+  if (Available < THRESHOLD) {
+    return 0;
   }
 
-  return LoopVar4;
-}
-
-/**
-  Create a new child for a given parent node.
-
-  @param[in] LoopVar6       The parent node.
-  @param[in] LoopVar5       The edge character.
-  @param[in] LoopVar4       The child node.
-**/
-VOID
-MakeChild (
-  IN NODE   LoopVar6,
-  IN UINT8  LoopVar5,
-  IN NODE   LoopVar4
-  )
-{
-  NODE  LoopVar12;
-
-  NODE  LoopVar10;
-
-  LoopVar12         = (NODE)HASH (LoopVar6, LoopVar5);
-  LoopVar10         = mNext[LoopVar12];
-  mNext[LoopVar12]  = LoopVar4;
-  mNext[LoopVar4]   = LoopVar10;
-  mPrev[LoopVar10]  = LoopVar4;
-  mPrev[LoopVar4]   = LoopVar12;
-  mParent[LoopVar4] = LoopVar6;
-  mChildCount[LoopVar6]++;
-}
-
-/**
-  Split a node.
-
-  @param[in] Old     The node to split.
-**/
-VOID
-Split (
-  IN NODE  Old
-  )
-{
-  NODE  New;
-
-  NODE  LoopVar10;
-
-  New              = mAvail;
-  mAvail           = mNext[New];
-  mChildCount[New] = 0;
-  LoopVar10        = mPrev[Old];
-  mPrev[New]       = LoopVar10;
-  mNext[LoopVar10] = New;
-  LoopVar10        = mNext[Old];
-  mNext[New]       = LoopVar10;
-  mPrev[LoopVar10] = New;
-  mParent[New]     = mParent[Old];
-  mLevel[New]      = (UINT8)mMatchLen;
-  mPosition[New]   = mPos;
-  MakeChild (New, mText[mMatchPos + mMatchLen], Old);
-  MakeChild (New, mText[mPos + mMatchLen], mPos);
-}
-
-/**
-  Insert string info for current position into the String Info Log.
-
-**/
-VOID
-InsertNode (
-  VOID
-  )
-{
-  NODE  LoopVar6;
-
-  NODE  LoopVar4;
-
-  NODE  LoopVar2;
-
-  NODE   LoopVar10;
-  UINT8  LoopVar5;
-  UINT8  *TempString3;
-  UINT8  *TempString2;
-
-  if (mMatchLen >= 4) {
-    //
-    // We have just got a long match, the target tree
-    // can be located by MatchPos + 1. Traverse the tree
-    // from bottom up to get to a proper starting point.
-    // The usage of PERC_FLAG ensures proper node deletion
-    // in DeleteNode() later.
-    //
-    mMatchLen--;
-    LoopVar4 = (NODE)((mMatchPos + 1) | WNDSIZ);
-    LoopVar6 = mParent[LoopVar4];
-    while (LoopVar6 == NIL) {
-      LoopVar4 = mNext[LoopVar4];
-      LoopVar6 = mParent[LoopVar4];
-    }
-
-    while (mLevel[LoopVar6] >= mMatchLen) {
-      LoopVar4 = LoopVar6;
-      LoopVar6 = mParent[LoopVar6];
-    }
-
-    LoopVar10 = LoopVar6;
-    while (mPosition[LoopVar10] < 0) {
-      mPosition[LoopVar10] = mPos;
-      LoopVar10            = mParent[LoopVar10];
-    }
-
-    if (LoopVar10 < WNDSIZ) {
-      mPosition[LoopVar10] = (NODE)(mPos | PERC_FLAG);
-    }
-  } else {
-    //
-    // Locate the target tree
-    //
-    LoopVar6 = (NODE)(mText[mPos] + WNDSIZ);
-    LoopVar5 = mText[mPos + 1];
-    LoopVar4 = Child (LoopVar6, LoopVar5);
-    if (LoopVar4 == NIL) {
-      MakeChild (LoopVar6, LoopVar5, mPos);
-      mMatchLen = 1;
-      return;
-    }
-
-    mMatchLen = 2;
-  }
+  MaxLength  = (Available < MAXMATCH) ? Available : MAXMATCH;
+  Limit      = (Pos > WNDSIZ) ? Pos - WNDSIZ : 0;
+  Scan       = &mSrc[Pos];
+  BestLength = THRESHOLD - 1;
+  Chain      = mEffort->MaxChain;
 
   //
-  // Traverse down the tree to find a match.
-  // Update Position value along the route.
-  // Node split or creation is involved.
+  // The chain is ordered newest first, so it ends at the first position out of the window.
   //
-  for ( ; ;) {
-    if (LoopVar4 >= WNDSIZ) {
-      LoopVar2  = MAXMATCH;
-      mMatchPos = LoopVar4;
-    } else {
-      LoopVar2  = mLevel[LoopVar4];
-      mMatchPos = (NODE)(mPosition[LoopVar4] & ~PERC_FLAG);
-    }
-
-    if (mMatchPos >= mPos) {
-      mMatchPos -= WNDSIZ;
-    }
+  for (Candidate = mHashHead[HASH (Scan)]; (Candidate != 0) && (Candidate - 1 >= Limit) && (Chain != 0); Chain--) {
+    Match = &mSrc[Candidate - 1];
 
-    TempString3 = &mText[mPos + mMatchLen];
-    TempString2 = &mText[mMatchPos + mMatchLen];
-    while (mMatchLen < LoopVar2) {
-      if (*TempString3 != *TempString2) {
-        Split (LoopVar4);
-        return;
+    //
+    // Only a string that also matches the byte after the best match so far can beat it.
+    //
+    if ((Match[BestLength] == Scan[BestLength]) && (Match[0] == Scan[0])) {
+      Length = 0;
+      while ((Length < MaxLength) && (Match[Length] == Scan[Length])) {
+        Length++;
       }
 
-      mMatchLen++;
-      TempString3++;
-      TempString2++;
-    }
-
-    if (mMatchLen >= MAXMATCH) {
-      break;
-    }
-
-    mPosition[LoopVar4] = mPos;
-    LoopVar6            = LoopVar4;
-    LoopVar4            = Child (LoopVar6, *TempString3);
-    if (LoopVar4 == NIL) {
-      MakeChild (LoopVar6, *TempString3, mPos);
-      return;
-    }
-
-    mMatchLen++;
-  }
-
-  LoopVar10         = mPrev[LoopVar4];
-  mPrev[mPos]       = LoopVar10;
-  mNext[LoopVar10]  = mPos;
-  LoopVar10         = mNext[LoopVar4];
-  mNext[mPos]       = LoopVar10;
-  mPrev[LoopVar10]  = mPos;
-  mParent[mPos]     = LoopVar6;
-  mParent[LoopVar4] = NIL;
-
-  //
-  // Special usage of 'next'
-  //
-  mNext[LoopVar4] = mPos;
-}
-
-/**
-  Delete outdated string info. (The Usage of PERC_FLAG
-  ensures a clean deletion).
-
-**/
-VOID
-DeleteNode (
-  VOID
-  )
-{
-  NODE  LoopVar6;
-
-  NODE  LoopVar4;
-
-  NODE  LoopVar11;
-
-  NODE  LoopVar10;
-
-  NODE  LoopVar9;
-
-  if (mParent[mPos] == NIL) {
-    return;
-  }
-
-  LoopVar4         = mPrev[mPos];
-  LoopVar11        = mNext[mPos];
-  mNext[LoopVar4]  = LoopVar11;
-  mPrev[LoopVar11] = LoopVar4;
-  LoopVar4         = mParent[mPos];
-  mParent[mPos]    = NIL;
-  if (LoopVar4 >= WNDSIZ) {
-    return;
-  }
-
-  mChildCount[LoopVar4]--;
-  if (mChildCount[LoopVar4] > 1) {
-    return;
-  }
-
-  LoopVar10 = (NODE)(mPosition[LoopVar4] & ~PERC_FLAG);
-  if (LoopVar10 >= mPos) {
-    LoopVar10 -= WNDSIZ;
-  }
-
-  LoopVar11 = LoopVar10;
-  LoopVar6  = mParent[LoopVar4];
-  LoopVar9  = mPosition[LoopVar6];
-  while ((LoopVar9 & PERC_FLAG) != 0) {
-    LoopVar9 &= ~PERC_FLAG;
-    if (LoopVar9 >= mPos) {
-      LoopVar9 -= WNDSIZ;
-    }
-
-    if (LoopVar9 > LoopVar11) {
-      LoopVar11 = LoopVar9;
-    }
-
-    mPosition[LoopVar6] = (NODE)(LoopVar11 | WNDSIZ);
-    LoopVar6            = mParent[LoopVar6];
-    LoopVar9            = mPosition[LoopVar6];
-  }
-
-  if (LoopVar6 < WNDSIZ) {
-    if (LoopVar9 >= mPos) {
-      LoopVar9 -= WNDSIZ;
-    }
-
-    if (LoopVar9 > LoopVar11) {
-      LoopVar11 = LoopVar9;
-    }
-
-    mPosition[LoopVar6] = (NODE)(LoopVar11 | WNDSIZ | PERC_FLAG);
-  }
-
-  LoopVar11          = Child (LoopVar4, mText[LoopVar10 + mLevel[LoopVar4]]);
-  LoopVar10          = mPrev[LoopVar11];
-  LoopVar9           = mNext[LoopVar11];
-  mNext[LoopVar10]   = LoopVar9;
-  mPrev[LoopVar9]    = LoopVar10;
-  LoopVar10          = mPrev[LoopVar4];
-  mNext[LoopVar10]   = LoopVar11;
-  mPrev[LoopVar11]   = LoopVar10;
-  LoopVar10          = mNext[LoopVar4];
-  mPrev[LoopVar10]   = LoopVar11;
-  mNext[LoopVar11]   = LoopVar10;
-  mParent[LoopVar11] = mParent[LoopVar4];
-  mParent[LoopVar4]  = NIL;
-  mNext[LoopVar4]    = mAvail;
-  mAvail             = LoopVar4;
-}
-
-/**
-  Read in source data
-
-  @param[out] LoopVar7   The buffer to hold the data.
-  @param[in] LoopVar8    The number of bytes to read.
-
-  @return The number of bytes actually read.
-**/
-INT32
-FreadCrc (
-  OUT UINT8  *LoopVar7,
-  IN  INT32  LoopVar8
-  )
-{
-  INT32  LoopVar1;
-
-  for (LoopVar1 = 0; mSrc < mSrcUpperLimit && LoopVar1 < LoopVar8; LoopVar1++) {
-    *LoopVar7++ = *mSrc++;
-  }
-
-  LoopVar8 = LoopVar1;
-
-  LoopVar7  -= LoopVar8;
-  mOrigSize += LoopVar8;
-  LoopVar1--;
-  while (LoopVar1 >= 0) {
-    UPDATE_CRC (*LoopVar7++);
-    LoopVar1--;
-  }
-
-  return LoopVar8;
-}
-
-/**
-  Advance the current position (read in new data if needed).
-  Delete outdated string info. Find a match string for current position.
-
-  @retval TRUE      The operation was successful.
-  @retval FALSE     The operation failed due to insufficient memory.
-**/
-BOOLEAN
-GetNextMatch (
-  VOID
-  )
-{
-  INT32  LoopVar8;
-  VOID   *Temp;
-
-  mRemainder--;
-  mPos++;
-  if (mPos == WNDSIZ * 2) {
-    Temp = AllocateZeroPool (WNDSIZ + MAXMATCH);
-    if (Temp == NULL) {
-      return (FALSE);
+      if (Length > BestLength) {
+        BestLength = Length;
+        *MatchPos  = Candidate - 1;
+        if ((Length >= mEffort->NiceLength) || (Length == MaxLength)) {
+          break;
+        }
+      }
     }
 
-    CopyMem (Temp, &mText[WNDSIZ], WNDSIZ + MAXMATCH);
-    CopyMem (&mText[0], Temp, WNDSIZ + MAXMATCH);
-    FreePool (Temp);
-    LoopVar8    = FreadCrc (&mText[WNDSIZ + MAXMATCH], WNDSIZ);
-    mRemainder += LoopVar8;
-    mPos        = WNDSIZ;
+    Candidate = mHashPrev[(Candidate - 1) & (WNDSIZ - 1)];
   }
 
-  DeleteNode ();
-  InsertNode ();
+  InsertPosition (Pos);
 
-  return (TRUE);
+  return (BestLength >= THRESHOLD) ? BestLength : 0;
 }
 
 /**
@@ -1260,8 +910,10 @@ Encode (
   )
 {
   EFI_STATUS  Status;
-  INT32       LastMatchLen;
-  NODE        LastMatchPos;
+  UINT32      Pos;
+  UINT32      Remainder;
+  UINT32      LastMatchLen;
+  UINT32      LastMatchPos;
 
   Status = AllocateMemory ();
   if (EFI_ERROR (Status)) {
@@ -1269,28 +921,26 @@ Encode (
     return Status;
   }
 
-  InitSlide ();
-
   HufEncodeStart ();
 
-  mRemainder = FreadCrc (&mText[WNDSIZ], WNDSIZ + MAXMATCH);
+  Remainder = mOrigSize;
+  Pos       = 0;
+  mMatchLen = FindMatch (Pos, &mMatchPos);
 
-  mMatchLen = 0;
-  mPos      = WNDSIZ;
-  InsertNode ();
-  if (mMatchLen > mRemainder) {
-    mMatchLen = mRemainder;
-  }
-
-  while (mRemainder > 0) {
+  while (Remainder > 0) {
     LastMatchLen = mMatchLen;
     LastMatchPos = mMatchPos;
-    if (!GetNextMatch ()) {
-      Status = EFI_OUT_OF_RESOURCES;
-    }
+    Pos++;
+    Remainder--;
 
-    if (mMatchLen > mRemainder) {
-      mMatchLen = mRemainder;
+    //
+    // A long enough match is taken without looking for a longer one at the next position.
+    //
+    if (LastMatchLen >= mEffort->LazyLength) {
+      InsertPosition (Pos);
+      mMatchLen = 0;
+    } else {
+      mMatchLen = FindMatch (Pos, &mMatchPos);
     }
 
     if ((mMatchLen > LastMatchLen) || (LastMatchLen < THRESHOLD)) {
@@ -1298,7 +948,7 @@ Encode (
       // Not enough benefits are gained by outputting a pointer,
       // so just output the original character
       //
-      CompressOutput (mText[mPos - 1], 0);
+      CompressOutput (mSrc[Pos - 1], 0);
     } else {
       //
       // Outputting a pointer is beneficial enough, do it.
@@ -1306,19 +956,22 @@ Encode (
 
       CompressOutput (
         LastMatchLen + (UINT8_MAX + 1 - THRESHOLD),
-        (mPos - LastMatchPos - 2) & (WNDSIZ - 1)
+        (Pos - LastMatchPos - 2) & (WNDSIZ - 1)
         );
       LastMatchLen--;
       while (LastMatchLen > 0) {
-        if (!GetNextMatch ()) {
-          Status = EFI_OUT_OF_RESOURCES;
-        }
-
+        Pos++;
+        Remainder--;
         LastMatchLen--;
-      }
 
-      if (mMatchLen > mRemainder) {
-        mMatchLen = mRemainder;
+        //
+        // Only the position after the string is searched; the ones inside it are just linked.
+        //
+        if (LastMatchLen == 0) {
+          mMatchLen = FindMatch (Pos, &mMatchPos);
+        } else {
+          InsertPosition (Pos);
+        }
       }
     }
   }
@@ -1336,32 +989,40 @@ Encode (
   @param[in]       DstBuffer     The buffer to put the compressed image in.
   @param[in, out]  DstSize       On input the size (in bytes) of DstBuffer, on
                                 return the number of bytes placed in DstBuffer.
+  @param[in]       Effort        How hard to look for repeated strings.
 
-  @retval EFI_SUCCESS           The compression was successful.
-  @retval EFI_BUFFER_TOO_SMALL  The buffer was too small.  DstSize is required.
+  @retval EFI_SUCCESS            The compression was successful.
+  @retval EFI_BUFFER_TOO_SMALL   The buffer was too small.  DstSize is required.
+  @retval EFI_INVALID_PARAMETER  Effort is not a COMPRESS_EFFORT, or SrcSize is 4GB or more.
+  @retval EFI_OUT_OF_RESOURCES   Not enough memory for compression process.
 **/
 EFI_STATUS
-Compress (
-  IN       VOID    *SrcBuffer,
-  IN       UINT64  SrcSize,
-  IN       VOID    *DstBuffer,
-  IN OUT   UINT64  *DstSize
+EFIAPI
+CompressWithEffort (
+  IN       VOID             *SrcBuffer,
+  IN       UINT64           SrcSize,
+  IN       VOID             *DstBuffer,
+  IN OUT   UINT64           *DstSize,
+  IN       COMPRESS_EFFORT  Effort
   )
 {
   EFI_STATUS  Status;
 
+  //
+  // The original size is stored in 32 bits.
+  //
+  if ((Effort >= CompressEffortMax) || (SrcSize > MAX_UINT32)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
   //
   // Initializations
   //
-  mBufSiz     = 0;
-  mBuf        = NULL;
-  mText       = NULL;
-  mLevel      = NULL;
-  mChildCount = NULL;
-  mPosition   = NULL;
-  mParent     = NULL;
-  mPrev       = NULL;
-  mNext       = NULL;
+  mBufSiz   = 0;
+  mBuf      = NULL;
+  mHashHead = NULL;
+  mHashPrev = NULL;
+  mEffort   = &mEffortLevels[Effort];
 
   mSrc           = SrcBuffer;
   mSrcUpperLimit = mSrc + SrcSize;
@@ -1371,10 +1032,8 @@ Compress (
   PutDword (0L);
   PutDword (0L);
 
-  MakeCrcTable ();
-
-  mOrigSize = mCompSize = 0;
-  mCrc      = INIT_CRC;
+  mOrigSize = (UINT32)SrcSize;
+  mCompSize = 0;
 
   //
   // Compress it
@@ -1409,3 +1068,27 @@ Compress (
     return EFI_SUCCESS;
   }
 }
+
+/**
+  The compression routine, at CompressEffortDefault.
+
+  @param[in]       SrcBuffer     The buffer containing the source data.
+  @param[in]       SrcSize       The number of bytes in SrcBuffer.
+  @param[in]       DstBuffer     The buffer to put the compressed image in.
+  @param[in, out]  DstSize       On input the size (in bytes) of DstBuffer, on
+                                return the number of bytes placed in DstBuffer.
+
+  @retval EFI_SUCCESS           The compression was successful.
+  @retval EFI_BUFFER_TOO_SMALL  The buffer was too small.  DstSize is required.
+**/
+EFI_STATUS
+EFIAPI
+Compress (
+  IN       VOID    *SrcBuffer,
+  IN       UINT64  SrcSize,
+  IN       VOID    *DstBuffer,
+  IN OUT   UINT64  *DstSize
+  )
+{
+  return CompressWithEffort (SrcBuffer, SrcSize, DstBuffer, DstSize, CompressEffortDefault);
+}
@@ -9,6 +9,17 @@
 #ifndef _EFI_SHELL_COMPRESS_H_
 #define _EFI_SHELL_COMPRESS_H_
 
+///
+/// How hard the compressor looks for repeated strings.  The output of every level
+/// decompresses with UefiDecompressLib; higher levels are slower and usually smaller.
+///
+typedef enum {
+  CompressEffortFast,
+  CompressEffortDefault,
+  CompressEffortBest,
+  CompressEffortMax
+} COMPRESS_EFFORT;
+
 /**
   The compression routine.
 
@@ -30,4 +41,29 @@ Compress (
   IN OUT  UINT64  *DstSize
   );
 
+/**
+  The compression routine, at a chosen effort level.  Compress uses CompressEffortDefault.
+
+  @param[in]       SrcBuffer     The buffer containing the source data.
+  @param[in]       SrcSize       Number of bytes in SrcBuffer.
+  @param[in]       DstBuffer     The buffer to put the compressed image in.
+  @param[in, out]  DstSize       On input the size (in bytes) of DstBuffer, on
+                                 return the number of bytes placed in DstBuffer.
+  @param[in]       Effort        How hard to look for repeated strings.
+
+  @retval EFI_SUCCESS            The compression was successful.
+  @retval EFI_BUFFER_TOO_SMALL   The buffer was too small.  DstSize is required.
+  @retval EFI_INVALID_PARAMETER  Effort is not a COMPRESS_EFFORT, or SrcSize is 4GB or more.
+  @retval EFI_OUT_OF_RESOURCES   Not enough memory for compression process.
+**/
+EFI_STATUS
+EFIAPI
+CompressWithEffort (
+  IN      VOID             *SrcBuffer,
+  IN      UINT64           SrcSize,
+  IN      VOID             *DstBuffer,
+  IN OUT  UINT64           *DstSize,
+  IN      COMPRESS_EFFORT  Effort
+  );
+
 #endif
@@ -0,0 +1,531 @@
+/** @file
+  Host based unit tests for the EnrollInDfci compressor.
+
+  Everything compressed is decompressed again with UefiDecompressLib, the decompressor
+  the compressed certificate is read back with, at every effort level.  A benchmark logs
+  the compression ratio and the throughput of each level over an enrollment package built
+  from the DFCI test certificates and packets.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <time.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiDecompressLib.h>
+#include <Library/UnitTestLib.h>
+#include "../Compress.h"
+#include "CompressTestData.h"
+
+#define UNIT_TEST_NAME     "EnrollInDfci Compress Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define WINDOW_SIZE       8192
+#define PACKAGE_COPIES    64
+#define BENCHMARK_ROUNDS  4
+
+//
+// A test input.  Data is filled in by the generator when it is NULL.
+//
+typedef struct {
+  CHAR8          *Name;
+  CONST UINT8    *Data;
+  UINTN          Size;
+  VOID           (*Generate)(
+    UINT8  *Buffer,
+    UINTN  Size
+    );
+} COMPRESS_TEST_INPUT;
+
+STATIC CONST CHAR8  *mEffortNames[CompressEffortMax] = { "Fast", "Default", "Best" };
+
+/**
+  Pseudo random bytes, which do not compress.
+**/
+STATIC
+VOID
+GenerateRandom (
+  IN UINT8  *Buffer,
+  IN UINTN  Size
+  )
+{
+  UINT32  State;
+  UINTN   Index;
+
+  State = 0x2545F491;
+  for (Index = 0; Index < Size; Index++) {
+    State        ^= State << 13;
+    State        ^= State >> 17;
+    State        ^= State << 5;
+    Buffer[Index] = (UINT8)State;
+  }
+}
+
+/**
+  A single repeated byte, which gives the longest and most overlapping matches.
+**/
+STATIC
+VOID
+GenerateRun (
+  IN UINT8  *Buffer,
+  IN UINTN  Size
+  )
+{
+  SetMem (Buffer, Size, 'A');
+}
+
+/**
+  A random block repeated at exactly the window size.  Every match is as far back as the
+  format allows.
+**/
+STATIC
+VOID
+GenerateWindowPeriod (
+  IN UINT8  *Buffer,
+  IN UINTN  Size
+  )
+{
+  UINTN  Index;
+
+  GenerateRandom (Buffer, MIN (Size, WINDOW_SIZE));
+  for (Index = WINDOW_SIZE; Index < Size; Index++) {
+    Buffer[Index] = Buffer[Index - WINDOW_SIZE];
+  }
+}
+
+/**
+  A random block repeated one byte beyond the window size.  Nothing in it can match.
+**/
+STATIC
+VOID
+GenerateBeyondWindowPeriod (
+  IN UINT8  *Buffer,
+  IN UINTN  Size
+  )
+{
+  UINTN  Index;
+
+  GenerateRandom (Buffer, MIN (Size, WINDOW_SIZE + 1));
+  for (Index = WINDOW_SIZE + 1; Index < Size; Index++) {
+    Buffer[Index] = Buffer[Index - WINDOW_SIZE - 1];
+  }
+}
+
+/**
+  Short random words from a small alphabet, with matches of every length and distance.
+**/
+STATIC
+VOID
+GenerateWords (
+  IN UINT8  *Buffer,
+  IN UINTN  Size
+  )
+{
+  UINTN  Index;
+
+  GenerateRandom (Buffer, Size);
+  for (Index = 0; Index < Size; Index++) {
+    Buffer[Index] = (UINT8)("abcd efgh\n"[Buffer[Index] % 10]);
+  }
+}
+
+#define PACKAGE_SIZE  (PACKAGE_COPIES * (sizeof (mDfciSettingsXml) + sizeof (mDfciPermissionXml) + sizeof (mDfciHttpsPem) + sizeof (mDfciHttpsCer) + 64))
+
+/**
+  An enrollment package: the DFCI test packets and certificates, copied PACKAGE_COPIES
+  times, each copy with its own creation time.  Size is PACKAGE_SIZE.
+**/
+STATIC
+VOID
+GeneratePackage (
+  IN UINT8  *Buffer,
+  IN UINTN  Size
+  )
+{
+  UINTN  Copy;
+  UINTN  Offset;
+
+  Offset = 0;
+  for (Copy = 0; Copy < PACKAGE_COPIES; Copy++) {
+    CopyMem (&Buffer[Offset], mDfciSettingsXml, sizeof (mDfciSettingsXml));
+    Offset += sizeof (mDfciSettingsXml);
+    CopyMem (&Buffer[Offset], mDfciPermissionXml, sizeof (mDfciPermissionXml));
+    Offset += sizeof (mDfciPermissionXml);
+    CopyMem (&Buffer[Offset], mDfciHttpsPem, sizeof (mDfciHttpsPem));
+    Offset += sizeof (mDfciHttpsPem);
+    CopyMem (&Buffer[Offset], mDfciHttpsCer, sizeof (mDfciHttpsCer));
+    Offset += sizeof (mDfciHttpsCer);
+
+    Buffer[Offset - 1] ^= (UINT8)Copy;
+    AsciiSPrint ((CHAR8 *)&Buffer[Offset], Size - Offset, "<CreatedOn>2020-03-27 10:%02d:%02d</CreatedOn>", (UINT32)(Copy / 60), (UINT32)(Copy % 60));
+    Offset += AsciiStrLen ((CHAR8 *)&Buffer[Offset]);
+  }
+
+  ZeroMem (&Buffer[Offset], Size - Offset);
+}
+
+STATIC COMPRESS_TEST_INPUT  mInputs[] = {
+  { "Empty",                  NULL,               0,                           GenerateRandom             },
+  { "One byte",               NULL,               1,                           GenerateRandom             },
+  { "Two bytes",              NULL,               2,                           GenerateRandom             },
+  { "Three bytes",            NULL,               3,                           GenerateRun                },
+  { "Run of 100000",          NULL,               100000,                      GenerateRun                },
+  { "Random 70000",           NULL,               70000,                       GenerateRandom             },
+  { "Window period",          NULL,               5 * WINDOW_SIZE,             GenerateWindowPeriod       },
+  { "Beyond window period",   NULL,               5 * WINDOW_SIZE,             GenerateBeyondWindowPeriod },
+  { "Words",                  NULL,               200000,                      GenerateWords              },
+  { "DFCI_HTTPS.cer",         mDfciHttpsCer,      sizeof (mDfciHttpsCer),      NULL                       },
+  { "DFCI_HTTPS.pem",         mDfciHttpsPem,      sizeof (mDfciHttpsPem),      NULL                       },
+  { "DfciSettings.xml",       mDfciSettingsXml,   sizeof (mDfciSettingsXml),   NULL                       },
+  { "DfciPermission.xml",     mDfciPermissionXml, sizeof (mDfciPermissionXml), NULL                       },
+  { "Enrollment package",     NULL,               PACKAGE_SIZE,                GeneratePackage            },
+};
+
+/**
+  Compresses a buffer, sizing the output the way EnrollInDfci does.
+
+  @param[in]  Data            Data to compress.
+  @param[in]  Size            Size of Data.
+  @param[in]  Effort          Effort level.
+  @param[out] Compressed      Receives the compressed data.  Free with FreePool.
+  @param[out] CompressedSize  Receives the size of Compressed.
+
+  @retval EFI_SUCCESS  Compressed holds the data.
+  @retval Others       The compressor failed, or the size it asked for was wrong.
+**/
+STATIC
+EFI_STATUS
+CompressBuffer (
+  IN  CONST UINT8      *Data,
+  IN  UINTN            Size,
+  IN  COMPRESS_EFFORT  Effort,
+  OUT UINT8            **Compressed,
+  OUT UINT64           *CompressedSize
+  )
+{
+  EFI_STATUS  Status;
+  UINT64      Needed;
+
+  *CompressedSize = 0;
+  Status          = CompressWithEffort ((VOID *)Data, Size, NULL, CompressedSize, Effort);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  Needed      = *CompressedSize;
+  *Compressed = AllocatePool ((UINTN)Needed);
+  if (*Compressed == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = CompressWithEffort ((VOID *)Data, Size, *Compressed, CompressedSize, Effort);
+  if (!EFI_ERROR (Status) && (*CompressedSize != Needed)) {
+    Status = EFI_BAD_BUFFER_SIZE;
+  }
+
+  if (EFI_ERROR (Status)) {
+    FreePool (*Compressed);
+    *Compressed = NULL;
+  }
+
+  return Status;
+}
+
+/**
+  Decompresses with UefiDecompressLib and compares the result with the original.
+
+  @retval TRUE   The data decompressed to the original.
+  @retval FALSE  It did not.
+**/
+STATIC
+BOOLEAN
+RoundTrips (
+  IN CONST UINT8  *Data,
+  IN UINTN        Size,
+  IN CONST UINT8  *Compressed,
+  IN UINT64       CompressedSize
+  )
+{
+  UINT32   DestinationSize;
+  UINT32   ScratchSize;
+  UINT8    *Destination;
+  VOID     *Scratch;
+  BOOLEAN  Result;
+
+  if (RETURN_ERROR (UefiDecompressGetInfo (Compressed, (UINT32)CompressedSize, &DestinationSize, &ScratchSize))) {
+    return FALSE;
+  }
+
+  if (DestinationSize != Size) {
+    return FALSE;
+  }
+
+  Destination = AllocatePool (MAX (DestinationSize, 1));
+  Scratch     = AllocatePool (ScratchSize);
+  Result      = FALSE;
+  if ((Destination != NULL) && (Scratch != NULL)) {
+    Result = (BOOLEAN)(!RETURN_ERROR (UefiDecompress (Compressed, Destination, Scratch)) &&
+                       (CompareMem (Destination, Data, Size) == 0));
+  }
+
+  if (Destination != NULL) {
+    FreePool (Destination);
+  }
+
+  if (Scratch != NULL) {
+    FreePool (Scratch);
+  }
+
+  return Result;
+}
+
+/**
+  Fills in the generated inputs.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+GenerateInputs (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+  UINT8  *Data;
+
+  for (Index = 0; Index < ARRAY_SIZE (mInputs); Index++) {
+    if (mInputs[Index].Generate == NULL) {
+      continue;
+    }
+
+    Data = AllocatePool (MAX (mInputs[Index].Size, 1));
+    if (Data == NULL) {
+      return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+    }
+
+    mInputs[Index].Generate (Data, mInputs[Index].Size);
+    mInputs[Index].Data = Data;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Frees the generated inputs.
+**/
+STATIC
+VOID
+EFIAPI
+FreeInputs (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mInputs); Index++) {
+    if ((mInputs[Index].Generate != NULL) && (mInputs[Index].Data != NULL)) {
+      FreePool ((VOID *)mInputs[Index].Data);
+      mInputs[Index].Data = NULL;
+    }
+  }
+}
+
+/**
+  Every input decompresses to itself at every effort level.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+EveryInputRoundTrips (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN            Index;
+  COMPRESS_EFFORT  Effort;
+  UINT8            *Compressed;
+  UINT64           CompressedSize;
+
+  for (Index = 0; Index < ARRAY_SIZE (mInputs); Index++) {
+    for (Effort = CompressEffortFast; Effort < CompressEffortMax; Effort++) {
+      UT_LOG_INFO ("%a at %a\n", mInputs[Index].Name, mEffortNames[Effort]);
+      UT_ASSERT_NOT_EFI_ERROR (CompressBuffer (mInputs[Index].Data, mInputs[Index].Size, Effort, &Compressed, &CompressedSize));
+      UT_ASSERT_TRUE (RoundTrips (mInputs[Index].Data, mInputs[Index].Size, Compressed, CompressedSize));
+      FreePool (Compressed);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Random data stays random, and a run collapses to a few bytes per maximum length match.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SizesAreSensible (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8   *Data;
+  UINT8   *Compressed;
+  UINT64  CompressedSize;
+
+  Data = AllocatePool (100000);
+  UT_ASSERT_NOT_NULL (Data);
+
+  GenerateRandom (Data, 100000);
+  UT_ASSERT_NOT_EFI_ERROR (CompressBuffer (Data, 100000, CompressEffortBest, &Compressed, &CompressedSize));
+  UT_ASSERT_TRUE (CompressedSize > 100000);
+  UT_ASSERT_TRUE (CompressedSize < 100000 + 100000 / 8);
+  FreePool (Compressed);
+
+  GenerateRun (Data, 100000);
+  UT_ASSERT_NOT_EFI_ERROR (CompressBuffer (Data, 100000, CompressEffortFast, &Compressed, &CompressedSize));
+  UT_ASSERT_TRUE (CompressedSize < 100000 / 256 + 100);
+  FreePool (Compressed);
+
+  FreePool (Data);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Effort levels that do not exist are refused.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BadEffortIsRefused (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8   Data[16];
+  UINT64  CompressedSize;
+
+  ZeroMem (Data, sizeof (Data));
+  CompressedSize = 0;
+  UT_ASSERT_STATUS_EQUAL (CompressWithEffort (Data, sizeof (Data), NULL, &CompressedSize, CompressEffortMax), EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Logs the compression ratio and throughput of each effort level over the enrollment
+  package.  Higher levels must not compress it worse.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+PackageBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONST COMPRESS_TEST_INPUT  *Package;
+  COMPRESS_EFFORT            Effort;
+  UINT8                      *Compressed;
+  UINT64                     CompressedSize;
+  UINT64                     PreviousSize;
+  UINTN                      Round;
+  clock_t                    Start;
+  clock_t                    Elapsed;
+
+  Package      = &mInputs[ARRAY_SIZE (mInputs) - 1];
+  PreviousSize = MAX_UINT64;
+  for (Effort = CompressEffortFast; Effort < CompressEffortMax; Effort++) {
+    Start = clock ();
+    for (Round = 0; Round < BENCHMARK_ROUNDS; Round++) {
+      UT_ASSERT_NOT_EFI_ERROR (CompressBuffer (Package->Data, Package->Size, Effort, &Compressed, &CompressedSize));
+      FreePool (Compressed);
+    }
+
+    Elapsed = MAX (clock () - Start, 1);
+    UT_LOG_INFO (
+      "%a: %d bytes to %d bytes (%d.%d%%), %d KB/s\n",
+      mEffortNames[Effort],
+      (UINT32)Package->Size,
+      (UINT32)CompressedSize,
+      (UINT32)(CompressedSize * 100 / Package->Size),
+      (UINT32)(CompressedSize * 1000 / Package->Size % 10),
+      (UINT32)((UINT64)Package->Size * BENCHMARK_ROUNDS * CLOCKS_PER_SEC / Elapsed / 1024)
+      );
+
+    UT_ASSERT_TRUE (CompressedSize <= PreviousSize);
+    PreviousSize = CompressedSize;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  EnrollInDfci compressor and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      CompressSuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&CompressSuiteHandle, Framework, "Compress tests", "EnrollInDfci.Compress", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for CompressSuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (CompressSuiteHandle, "Every input round trips", "RoundTrip", EveryInputRoundTrips, GenerateInputs, FreeInputs, NULL);
+  AddTestCase (CompressSuiteHandle, "Compressed sizes are sensible", "Sizes", SizesAreSensible, NULL, NULL, NULL);
+  AddTestCase (CompressSuiteHandle, "Bad effort is refused", "BadEffort", BadEffortIsRefused, NULL, NULL, NULL);
+  AddTestCase (CompressSuiteHandle, "Enrollment package benchmark", "PackageBenchmark", PackageBenchmark, GenerateInputs, FreeInputs, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
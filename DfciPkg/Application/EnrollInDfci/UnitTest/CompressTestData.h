@@ -0,0 +1,552 @@
+/**
+  Unit test data supporting the EnrollInDfci compression host test
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+// Generated from DfciPkg/UnitTests/DfciTests/Certs/DFCI_HTTPS.cer
+CONST UINT8  mDfciHttpsCer[] = {
+  0x30, 0x82, 0x04, 0x59, 0x30, 0x82, 0x03, 0x41, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x14, 0x0c,
+  0xc3, 0x08, 0xae, 0xfc, 0x7e, 0x9f, 0xfe, 0xa5, 0x04, 0x23, 0x95, 0x99, 0x72, 0x14, 0x47, 0xf9,
+  0x5e, 0x4e, 0x43, 0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x0b,
+  0x05, 0x00, 0x30, 0x7e, 0x31, 0x0b, 0x30, 0x09, 0x06, 0x03, 0x55, 0x04, 0x06, 0x13, 0x02, 0x55,
+  0x53, 0x31, 0x0b, 0x30, 0x09, 0x06, 0x03, 0x55, 0x04, 0x08, 0x13, 0x02, 0x57, 0x41, 0x31, 0x10,
+  0x30, 0x0e, 0x06, 0x03, 0x55, 0x04, 0x07, 0x13, 0x07, 0x52, 0x65, 0x64, 0x6d, 0x6f, 0x6e, 0x64,
+  0x31, 0x15, 0x30, 0x13, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x13, 0x0c, 0x44, 0x66, 0x63, 0x69, 0x20,
+  0x54, 0x65, 0x73, 0x74, 0x69, 0x6e, 0x67, 0x31, 0x19, 0x30, 0x17, 0x06, 0x03, 0x55, 0x04, 0x0b,
+  0x13, 0x10, 0x44, 0x66, 0x63, 0x69, 0x52, 0x65, 0x63, 0x6f, 0x76, 0x65, 0x72, 0x79, 0x54, 0x65,
+  0x73, 0x74, 0x31, 0x1e, 0x30, 0x1c, 0x06, 0x03, 0x55, 0x04, 0x03, 0x13, 0x15, 0x4d, 0x69, 0x6b,
+  0x65, 0x79, 0x73, 0x20, 0x44, 0x66, 0x63, 0x69, 0x20, 0x54, 0x65, 0x73, 0x74, 0x20, 0x53, 0x68,
+  0x6f, 0x70, 0x30, 0x1e, 0x17, 0x0d, 0x31, 0x39, 0x30, 0x36, 0x30, 0x33, 0x30, 0x33, 0x35, 0x33,
+  0x33, 0x31, 0x5a, 0x17, 0x0d, 0x32, 0x31, 0x30, 0x36, 0x30, 0x32, 0x30, 0x33, 0x35, 0x33, 0x33,
+  0x31, 0x5a, 0x30, 0x7e, 0x31, 0x0b, 0x30, 0x09, 0x06, 0x03, 0x55, 0x04, 0x06, 0x13, 0x02, 0x55,
+  0x53, 0x31, 0x0b, 0x30, 0x09, 0x06, 0x03, 0x55, 0x04, 0x08, 0x13, 0x02, 0x57, 0x41, 0x31, 0x10,
+  0x30, 0x0e, 0x06, 0x03, 0x55, 0x04, 0x07, 0x13, 0x07, 0x52, 0x65, 0x64, 0x6d, 0x6f, 0x6e, 0x64,
+  0x31, 0x15, 0x30, 0x13, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x13, 0x0c, 0x44, 0x66, 0x63, 0x69, 0x20,
+  0x54, 0x65, 0x73, 0x74, 0x69, 0x6e, 0x67, 0x31, 0x19, 0x30, 0x17, 0x06, 0x03, 0x55, 0x04, 0x0b,
+  0x13, 0x10, 0x44, 0x66, 0x63, 0x69, 0x52, 0x65, 0x63, 0x6f, 0x76, 0x65, 0x72, 0x79, 0x54, 0x65,
+  0x73, 0x74, 0x31, 0x1e, 0x30, 0x1c, 0x06, 0x03, 0x55, 0x04, 0x03, 0x13, 0x15, 0x4d, 0x69, 0x6b,
+  0x65, 0x79, 0x73, 0x20, 0x44, 0x66, 0x63, 0x69, 0x20, 0x54, 0x65, 0x73, 0x74, 0x20, 0x53, 0x68,
+  0x6f, 0x70, 0x30, 0x82, 0x01, 0x22, 0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d,
+  0x01, 0x01, 0x01, 0x05, 0x00, 0x03, 0x82, 0x01, 0x0f, 0x00, 0x30, 0x82, 0x01, 0x0a, 0x02, 0x82,
+  0x01, 0x01, 0x00, 0xe1, 0x77, 0x44, 0xd7, 0xa9, 0xec, 0x52, 0x72, 0x4a, 0xa6, 0xec, 0x25, 0xfe,
+  0xc7, 0xdb, 0xc7, 0x11, 0x43, 0x01, 0xa8, 0x3f, 0x9f, 0x52, 0xd0, 0x63, 0x02, 0xc9, 0x6b, 0x07,
+  0x6b, 0xec, 0x17, 0x0a, 0xc2, 0xc7, 0xfd, 0xc9, 0x6f, 0x7d, 0x8e, 0x3c, 0x97, 0x5f, 0x64, 0x01,
+  0xc3, 0x59, 0xc6, 0x4c, 0xc5, 0xfd, 0x7d, 0x3e, 0x12, 0x00, 0xb9, 0x06, 0xdb, 0x7d, 0x10, 0x8b,
+  0x23, 0x16, 0xab, 0x6a, 0x6e, 0xc8, 0xb5, 0x57, 0x64, 0xdc, 0xf8, 0xe4, 0xfd, 0xd6, 0x73, 0xbd,
+  0xfb, 0xe8, 0x16, 0x64, 0x73, 0x75, 0x51, 0x40, 0x35, 0x03, 0x09, 0x66, 0xe8, 0x85, 0x47, 0xc9,
+  0xd4, 0xc0, 0x99, 0x21, 0xa0, 0x07, 0x5d, 0xef, 0x18, 0x60, 0xfa, 0x40, 0x78, 0x82, 0xd9, 0x41,
+  0x18, 0xe0, 0xb7, 0xe3, 0xaf, 0x8a, 0xed, 0x03, 0xd7, 0x95, 0x5c, 0x32, 0xf3, 0xe3, 0x25, 0x25,
+  0xe5, 0x33, 0xa5, 0xed, 0x08, 0x2d, 0x03, 0x3a, 0x93, 0xc7, 0x1d, 0x10, 0x0c, 0x85, 0x83, 0x9d,
+  0xe2, 0xfc, 0xe7, 0xa4, 0xc6, 0x55, 0xef, 0x91, 0x06, 0x85, 0x6e, 0xa8, 0xa3, 0x68, 0x13, 0x03,
+  0x93, 0x9a, 0x51, 0xe9, 0x20, 0x1e, 0x6b, 0x5c, 0xa0, 0x96, 0x98, 0x4e, 0x62, 0x4d, 0x74, 0x76,
+  0xd2, 0x77, 0x9a, 0x9b, 0x5e, 0x86, 0x7a, 0xef, 0x39, 0xc7, 0x8b, 0x92, 0x71, 0x94, 0x11, 0x0e,
+  0xe2, 0xd4, 0x29, 0xea, 0x63, 0xca, 0xfb, 0x00, 0xac, 0x8d, 0x3a, 0xda, 0xbd, 0x0b, 0x71, 0x62,
+  0x9f, 0xc5, 0xf4, 0x30, 0x09, 0x2b, 0x21, 0x29, 0x9d, 0x42, 0x32, 0x79, 0x61, 0x97, 0x2c, 0xcb,
+  0xb7, 0x5e, 0x7d, 0x9a, 0xa9, 0x54, 0x44, 0xfa, 0x69, 0x1b, 0x57, 0x01, 0xfa, 0x0c, 0x1c, 0x0f,
+  0xd8, 0x55, 0x92, 0xc2, 0x31, 0x41, 0x42, 0x98, 0x20, 0xa0, 0x60, 0x7b, 0xed, 0x08, 0x5e, 0xa2,
+  0x51, 0xb3, 0x2b, 0x02, 0x03, 0x01, 0x00, 0x01, 0xa3, 0x81, 0xce, 0x30, 0x81, 0xcb, 0x30, 0x0b,
+  0x06, 0x03, 0x55, 0x1d, 0x0f, 0x04, 0x04, 0x03, 0x02, 0x05, 0xa0, 0x30, 0x1d, 0x06, 0x03, 0x55,
+  0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0xbf, 0x2b, 0x37, 0xd7, 0xe4, 0xd1, 0xbf, 0x38, 0x46, 0xdb,
+  0xdf, 0xd9, 0x15, 0x60, 0xcf, 0x8c, 0xa5, 0xac, 0x04, 0x97, 0x30, 0x56, 0x06, 0x03, 0x55, 0x1d,
+  0x11, 0x04, 0x4f, 0x30, 0x4d, 0x82, 0x15, 0x64, 0x64, 0x73, 0x2e, 0x6d, 0x69, 0x63, 0x72, 0x6f,
+  0x73, 0x6f, 0x66, 0x74, 0x2d, 0x69, 0x6e, 0x74, 0x2e, 0x63, 0x6f, 0x6d, 0x82, 0x17, 0x2a, 0x2e,
+  0x64, 0x64, 0x73, 0x2e, 0x6d, 0x69, 0x63, 0x72, 0x6f, 0x73, 0x6f, 0x66, 0x74, 0x2d, 0x69, 0x6e,
+  0x74, 0x2e, 0x63, 0x6f, 0x6d, 0x82, 0x1b, 0x2a, 0x2e, 0x65, 0x61, 0x73, 0x74, 0x75, 0x73, 0x2e,
+  0x63, 0x6c, 0x6f, 0x75, 0x64, 0x61, 0x70, 0x70, 0x2e, 0x61, 0x7a, 0x75, 0x72, 0x65, 0x2e, 0x63,
+  0x6f, 0x6d, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x05, 0x30, 0x03,
+  0x02, 0x01, 0x00, 0x30, 0x13, 0x06, 0x03, 0x55, 0x1d, 0x25, 0x04, 0x0c, 0x30, 0x0a, 0x06, 0x08,
+  0x2b, 0x06, 0x01, 0x05, 0x05, 0x07, 0x03, 0x01, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04,
+  0x18, 0x30, 0x16, 0x80, 0x14, 0xbf, 0x2b, 0x37, 0xd7, 0xe4, 0xd1, 0xbf, 0x38, 0x46, 0xdb, 0xdf,
+  0xd9, 0x15, 0x60, 0xcf, 0x8c, 0xa5, 0xac, 0x04, 0x97, 0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48,
+  0x86, 0xf7, 0x0d, 0x01, 0x01, 0x0b, 0x05, 0x00, 0x03, 0x82, 0x01, 0x01, 0x00, 0xc1, 0x49, 0xfc,
+  0xb2, 0x4d, 0xbf, 0x07, 0xf5, 0x45, 0x42, 0xd9, 0x79, 0x6f, 0x78, 0xa0, 0x45, 0x4b, 0x14, 0x57,
+  0xd8, 0x9c, 0x9d, 0xcd, 0x1f, 0x94, 0xcc, 0x7b, 0xa1, 0xc7, 0x64, 0x45, 0x29, 0x73, 0x52, 0xc3,
+  0x0f, 0x44, 0xc2, 0x97, 0x92, 0x66, 0x30, 0xd4, 0x67, 0x79, 0x99, 0x66, 0xb4, 0xfa, 0x86, 0x91,
+  0x10, 0x40, 0xce, 0x9a, 0xf0, 0x0e, 0x89, 0xd6, 0x5b, 0x8c, 0xd6, 0x95, 0xec, 0x27, 0xc0, 0x31,
+  0x1b, 0xc8, 0x98, 0x15, 0x51, 0x7e, 0xd1, 0xa4, 0x68, 0xcd, 0x77, 0x64, 0x33, 0x92, 0x35, 0xfd,
+  0x29, 0x6f, 0x09, 0x35, 0x80, 0x23, 0x3d, 0xc2, 0x43, 0x55, 0xcf, 0x4f, 0xe3, 0x2b, 0xbc, 0x6b,
+  0xa7, 0xd4, 0x40, 0x67, 0x9c, 0xc1, 0x97, 0x91, 0x1a, 0x57, 0x72, 0x87, 0x9f, 0x7d, 0x65, 0x73,
+  0xca, 0x70, 0xdc, 0x71, 0x73, 0xba, 0x1d, 0x19, 0x38, 0x6d, 0xeb, 0xab, 0x81, 0x43, 0x73, 0xe6,
+  0xd2, 0xce, 0xe9, 0xad, 0xbb, 0x0a, 0x33, 0x81, 0x38, 0xa6, 0x18, 0xd0, 0x4f, 0xa8, 0x85, 0xdd,
+  0xda, 0x7b, 0x4e, 0xe7, 0x44, 0x61, 0x0b, 0x01, 0xa8, 0xba, 0x7b, 0xd5, 0x9a, 0x69, 0x38, 0x44,
+  0xb9, 0xc2, 0x2d, 0x04, 0x8b, 0xc9, 0x9a, 0x79, 0xc4, 0xa5, 0x82, 0x38, 0x2f, 0xd6, 0x7d, 0x7b,
+  0xee, 0xa4, 0xda, 0x14, 0xfe, 0x99, 0x66, 0x5d, 0xed, 0x7f, 0xe5, 0xfc, 0xbb, 0x3d, 0x9b, 0xdf,
+  0x92, 0x60, 0x05, 0x46, 0x21, 0xd9, 0x7e, 0x1e, 0x55, 0x8d, 0x02, 0x35, 0x91, 0x91, 0xeb, 0x45,
+  0x69, 0xf4, 0xb1, 0x71, 0x6e, 0xca, 0xc3, 0x22, 0x16, 0xbe, 0x82, 0xf4, 0x8f, 0x6b, 0x2b, 0xec,
+  0xf6, 0x82, 0xce, 0x06, 0xd4, 0x92, 0x35, 0x66, 0x8c, 0xc7, 0x69, 0x8e, 0x8c, 0xe4, 0xed, 0x05,
+  0xab, 0x8d, 0x99, 0xdd, 0x57, 0xa3, 0x35, 0x3d, 0x45, 0x79, 0xe8, 0x47, 0xc0,
+};
+
+// Generated from DfciPkg/UnitTests/DfciTests/Certs/DFCI_HTTPS.pem
+CONST UINT8  mDfciHttpsPem[] = {
+  0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x42, 0x45, 0x47, 0x49, 0x4e, 0x20, 0x43, 0x45, 0x52, 0x54, 0x49,
+  0x46, 0x49, 0x43, 0x41, 0x54, 0x45, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x0d, 0x0a, 0x4d, 0x49, 0x49,
+  0x45, 0x57, 0x54, 0x43, 0x43, 0x41, 0x30, 0x47, 0x67, 0x41, 0x77, 0x49, 0x42, 0x41, 0x67, 0x49,
+  0x55, 0x44, 0x4d, 0x4d, 0x49, 0x72, 0x76, 0x78, 0x2b, 0x6e, 0x2f, 0x36, 0x6c, 0x42, 0x43, 0x4f,
+  0x56, 0x6d, 0x58, 0x49, 0x55, 0x52, 0x2f, 0x6c, 0x65, 0x54, 0x6b, 0x4d, 0x77, 0x44, 0x51, 0x59,
+  0x4a, 0x4b, 0x6f, 0x5a, 0x49, 0x68, 0x76, 0x63, 0x4e, 0x41, 0x51, 0x45, 0x4c, 0x0d, 0x0a, 0x42,
+  0x51, 0x41, 0x77, 0x66, 0x6a, 0x45, 0x4c, 0x4d, 0x41, 0x6b, 0x47, 0x41, 0x31, 0x55, 0x45, 0x42,
+  0x68, 0x4d, 0x43, 0x56, 0x56, 0x4d, 0x78, 0x43, 0x7a, 0x41, 0x4a, 0x42, 0x67, 0x4e, 0x56, 0x42,
+  0x41, 0x67, 0x54, 0x41, 0x6c, 0x64, 0x42, 0x4d, 0x52, 0x41, 0x77, 0x44, 0x67, 0x59, 0x44, 0x56,
+  0x51, 0x51, 0x48, 0x45, 0x77, 0x64, 0x53, 0x5a, 0x57, 0x52, 0x74, 0x62, 0x32, 0x35, 0x6b, 0x0d,
+  0x0a, 0x4d, 0x52, 0x55, 0x77, 0x45, 0x77, 0x59, 0x44, 0x56, 0x51, 0x51, 0x4b, 0x45, 0x77, 0x78,
+  0x45, 0x5a, 0x6d, 0x4e, 0x70, 0x49, 0x46, 0x52, 0x6c, 0x63, 0x33, 0x52, 0x70, 0x62, 0x6d, 0x63,
+  0x78, 0x47, 0x54, 0x41, 0x58, 0x42, 0x67, 0x4e, 0x56, 0x42, 0x41, 0x73, 0x54, 0x45, 0x45, 0x52,
+  0x6d, 0x59, 0x32, 0x6c, 0x53, 0x5a, 0x57, 0x4e, 0x76, 0x64, 0x6d, 0x56, 0x79, 0x65, 0x56, 0x52,
+  0x6c, 0x0d, 0x0a, 0x63, 0x33, 0x51, 0x78, 0x48, 0x6a, 0x41, 0x63, 0x42, 0x67, 0x4e, 0x56, 0x42,
+  0x41, 0x4d, 0x54, 0x46, 0x55, 0x31, 0x70, 0x61, 0x32, 0x56, 0x35, 0x63, 0x79, 0x42, 0x45, 0x5a,
+  0x6d, 0x4e, 0x70, 0x49, 0x46, 0x52, 0x6c, 0x63, 0x33, 0x51, 0x67, 0x55, 0x32, 0x68, 0x76, 0x63,
+  0x44, 0x41, 0x65, 0x46, 0x77, 0x30, 0x78, 0x4f, 0x54, 0x41, 0x32, 0x4d, 0x44, 0x4d, 0x77, 0x4d,
+  0x7a, 0x55, 0x7a, 0x0d, 0x0a, 0x4d, 0x7a, 0x46, 0x61, 0x46, 0x77, 0x30, 0x79, 0x4d, 0x54, 0x41,
+  0x32, 0x4d, 0x44, 0x49, 0x77, 0x4d, 0x7a, 0x55, 0x7a, 0x4d, 0x7a, 0x46, 0x61, 0x4d, 0x48, 0x34,
+  0x78, 0x43, 0x7a, 0x41, 0x4a, 0x42, 0x67, 0x4e, 0x56, 0x42, 0x41, 0x59, 0x54, 0x41, 0x6c, 0x56,
+  0x54, 0x4d, 0x51, 0x73, 0x77, 0x43, 0x51, 0x59, 0x44, 0x56, 0x51, 0x51, 0x49, 0x45, 0x77, 0x4a,
+  0x58, 0x51, 0x54, 0x45, 0x51, 0x0d, 0x0a, 0x4d, 0x41, 0x34, 0x47, 0x41, 0x31, 0x55, 0x45, 0x42,
+  0x78, 0x4d, 0x48, 0x55, 0x6d, 0x56, 0x6b, 0x62, 0x57, 0x39, 0x75, 0x5a, 0x44, 0x45, 0x56, 0x4d,
+  0x42, 0x4d, 0x47, 0x41, 0x31, 0x55, 0x45, 0x43, 0x68, 0x4d, 0x4d, 0x52, 0x47, 0x5a, 0x6a, 0x61,
+  0x53, 0x42, 0x55, 0x5a, 0x58, 0x4e, 0x30, 0x61, 0x57, 0x35, 0x6e, 0x4d, 0x52, 0x6b, 0x77, 0x46,
+  0x77, 0x59, 0x44, 0x56, 0x51, 0x51, 0x4c, 0x0d, 0x0a, 0x45, 0x78, 0x42, 0x45, 0x5a, 0x6d, 0x4e,
+  0x70, 0x55, 0x6d, 0x56, 0x6a, 0x62, 0x33, 0x5a, 0x6c, 0x63, 0x6e, 0x6c, 0x55, 0x5a, 0x58, 0x4e,
+  0x30, 0x4d, 0x52, 0x34, 0x77, 0x48, 0x41, 0x59, 0x44, 0x56, 0x51, 0x51, 0x44, 0x45, 0x78, 0x56,
+  0x4e, 0x61, 0x57, 0x74, 0x6c, 0x65, 0x58, 0x4d, 0x67, 0x52, 0x47, 0x5a, 0x6a, 0x61, 0x53, 0x42,
+  0x55, 0x5a, 0x58, 0x4e, 0x30, 0x49, 0x46, 0x4e, 0x6f, 0x0d, 0x0a, 0x62, 0x33, 0x41, 0x77, 0x67,
+  0x67, 0x45, 0x69, 0x4d, 0x41, 0x30, 0x47, 0x43, 0x53, 0x71, 0x47, 0x53, 0x49, 0x62, 0x33, 0x44,
+  0x51, 0x45, 0x42, 0x41, 0x51, 0x55, 0x41, 0x41, 0x34, 0x49, 0x42, 0x44, 0x77, 0x41, 0x77, 0x67,
+  0x67, 0x45, 0x4b, 0x41, 0x6f, 0x49, 0x42, 0x41, 0x51, 0x44, 0x68, 0x64, 0x30, 0x54, 0x58, 0x71,
+  0x65, 0x78, 0x53, 0x63, 0x6b, 0x71, 0x6d, 0x37, 0x43, 0x58, 0x2b, 0x0d, 0x0a, 0x78, 0x39, 0x76,
+  0x48, 0x45, 0x55, 0x4d, 0x42, 0x71, 0x44, 0x2b, 0x66, 0x55, 0x74, 0x42, 0x6a, 0x41, 0x73, 0x6c,
+  0x72, 0x42, 0x32, 0x76, 0x73, 0x46, 0x77, 0x72, 0x43, 0x78, 0x2f, 0x33, 0x4a, 0x62, 0x33, 0x32,
+  0x4f, 0x50, 0x4a, 0x64, 0x66, 0x5a, 0x41, 0x48, 0x44, 0x57, 0x63, 0x5a, 0x4d, 0x78, 0x66, 0x31,
+  0x39, 0x50, 0x68, 0x49, 0x41, 0x75, 0x51, 0x62, 0x62, 0x66, 0x52, 0x43, 0x4c, 0x0d, 0x0a, 0x49,
+  0x78, 0x61, 0x72, 0x61, 0x6d, 0x37, 0x49, 0x74, 0x56, 0x64, 0x6b, 0x33, 0x50, 0x6a, 0x6b, 0x2f,
+  0x64, 0x5a, 0x7a, 0x76, 0x66, 0x76, 0x6f, 0x46, 0x6d, 0x52, 0x7a, 0x64, 0x56, 0x46, 0x41, 0x4e,
+  0x51, 0x4d, 0x4a, 0x5a, 0x75, 0x69, 0x46, 0x52, 0x38, 0x6e, 0x55, 0x77, 0x4a, 0x6b, 0x68, 0x6f,
+  0x41, 0x64, 0x64, 0x37, 0x78, 0x68, 0x67, 0x2b, 0x6b, 0x42, 0x34, 0x67, 0x74, 0x6c, 0x42, 0x0d,
+  0x0a, 0x47, 0x4f, 0x43, 0x33, 0x34, 0x36, 0x2b, 0x4b, 0x37, 0x51, 0x50, 0x58, 0x6c, 0x56, 0x77,
+  0x79, 0x38, 0x2b, 0x4d, 0x6c, 0x4a, 0x65, 0x55, 0x7a, 0x70, 0x65, 0x30, 0x49, 0x4c, 0x51, 0x4d,
+  0x36, 0x6b, 0x38, 0x63, 0x64, 0x45, 0x41, 0x79, 0x46, 0x67, 0x35, 0x33, 0x69, 0x2f, 0x4f, 0x65,
+  0x6b, 0x78, 0x6c, 0x58, 0x76, 0x6b, 0x51, 0x61, 0x46, 0x62, 0x71, 0x69, 0x6a, 0x61, 0x42, 0x4d,
+  0x44, 0x0d, 0x0a, 0x6b, 0x35, 0x70, 0x52, 0x36, 0x53, 0x41, 0x65, 0x61, 0x31, 0x79, 0x67, 0x6c,
+  0x70, 0x68, 0x4f, 0x59, 0x6b, 0x31, 0x30, 0x64, 0x74, 0x4a, 0x33, 0x6d, 0x70, 0x74, 0x65, 0x68,
+  0x6e, 0x72, 0x76, 0x4f, 0x63, 0x65, 0x4c, 0x6b, 0x6e, 0x47, 0x55, 0x45, 0x51, 0x37, 0x69, 0x31,
+  0x43, 0x6e, 0x71, 0x59, 0x38, 0x72, 0x37, 0x41, 0x4b, 0x79, 0x4e, 0x4f, 0x74, 0x71, 0x39, 0x43,
+  0x33, 0x46, 0x69, 0x0d, 0x0a, 0x6e, 0x38, 0x58, 0x30, 0x4d, 0x41, 0x6b, 0x72, 0x49, 0x53, 0x6d,
+  0x64, 0x51, 0x6a, 0x4a, 0x35, 0x59, 0x5a, 0x63, 0x73, 0x79, 0x37, 0x64, 0x65, 0x66, 0x5a, 0x71,
+  0x70, 0x56, 0x45, 0x54, 0x36, 0x61, 0x52, 0x74, 0x58, 0x41, 0x66, 0x6f, 0x4d, 0x48, 0x41, 0x2f,
+  0x59, 0x56, 0x5a, 0x4c, 0x43, 0x4d, 0x55, 0x46, 0x43, 0x6d, 0x43, 0x43, 0x67, 0x59, 0x48, 0x76,
+  0x74, 0x43, 0x46, 0x36, 0x69, 0x0d, 0x0a, 0x55, 0x62, 0x4d, 0x72, 0x41, 0x67, 0x4d, 0x42, 0x41,
+  0x41, 0x47, 0x6a, 0x67, 0x63, 0x34, 0x77, 0x67, 0x63, 0x73, 0x77, 0x43, 0x77, 0x59, 0x44, 0x56,
+  0x52, 0x30, 0x50, 0x42, 0x41, 0x51, 0x44, 0x41, 0x67, 0x57, 0x67, 0x4d, 0x42, 0x30, 0x47, 0x41,
+  0x31, 0x55, 0x64, 0x44, 0x67, 0x51, 0x57, 0x42, 0x42, 0x53, 0x2f, 0x4b, 0x7a, 0x66, 0x58, 0x35,
+  0x4e, 0x47, 0x2f, 0x4f, 0x45, 0x62, 0x62, 0x0d, 0x0a, 0x33, 0x39, 0x6b, 0x56, 0x59, 0x4d, 0x2b,
+  0x4d, 0x70, 0x61, 0x77, 0x45, 0x6c, 0x7a, 0x42, 0x57, 0x42, 0x67, 0x4e, 0x56, 0x48, 0x52, 0x45,
+  0x45, 0x54, 0x7a, 0x42, 0x4e, 0x67, 0x68, 0x56, 0x6b, 0x5a, 0x48, 0x4d, 0x75, 0x62, 0x57, 0x6c,
+  0x6a, 0x63, 0x6d, 0x39, 0x7a, 0x62, 0x32, 0x5a, 0x30, 0x4c, 0x57, 0x6c, 0x75, 0x64, 0x43, 0x35,
+  0x6a, 0x62, 0x32, 0x32, 0x43, 0x46, 0x79, 0x6f, 0x75, 0x0d, 0x0a, 0x5a, 0x47, 0x52, 0x7a, 0x4c,
+  0x6d, 0x31, 0x70, 0x59, 0x33, 0x4a, 0x76, 0x63, 0x32, 0x39, 0x6d, 0x64, 0x43, 0x31, 0x70, 0x62,
+  0x6e, 0x51, 0x75, 0x59, 0x32, 0x39, 0x74, 0x67, 0x68, 0x73, 0x71, 0x4c, 0x6d, 0x56, 0x68, 0x63,
+  0x33, 0x52, 0x31, 0x63, 0x79, 0x35, 0x6a, 0x62, 0x47, 0x39, 0x31, 0x5a, 0x47, 0x46, 0x77, 0x63,
+  0x43, 0x35, 0x68, 0x65, 0x6e, 0x56, 0x79, 0x5a, 0x53, 0x35, 0x6a, 0x0d, 0x0a, 0x62, 0x32, 0x30,
+  0x77, 0x44, 0x77, 0x59, 0x44, 0x56, 0x52, 0x30, 0x54, 0x41, 0x51, 0x48, 0x2f, 0x42, 0x41, 0x55,
+  0x77, 0x41, 0x77, 0x49, 0x42, 0x41, 0x44, 0x41, 0x54, 0x42, 0x67, 0x4e, 0x56, 0x48, 0x53, 0x55,
+  0x45, 0x44, 0x44, 0x41, 0x4b, 0x42, 0x67, 0x67, 0x72, 0x42, 0x67, 0x45, 0x46, 0x42, 0x51, 0x63,
+  0x44, 0x41, 0x54, 0x41, 0x66, 0x42, 0x67, 0x4e, 0x56, 0x48, 0x53, 0x4d, 0x45, 0x0d, 0x0a, 0x47,
+  0x44, 0x41, 0x57, 0x67, 0x42, 0x53, 0x2f, 0x4b, 0x7a, 0x66, 0x58, 0x35, 0x4e, 0x47, 0x2f, 0x4f,
+  0x45, 0x62, 0x62, 0x33, 0x39, 0x6b, 0x56, 0x59, 0x4d, 0x2b, 0x4d, 0x70, 0x61, 0x77, 0x45, 0x6c,
+  0x7a, 0x41, 0x4e, 0x42, 0x67, 0x6b, 0x71, 0x68, 0x6b, 0x69, 0x47, 0x39, 0x77, 0x30, 0x42, 0x41,
+  0x51, 0x73, 0x46, 0x41, 0x41, 0x4f, 0x43, 0x41, 0x51, 0x45, 0x41, 0x77, 0x55, 0x6e, 0x38, 0x0d,
+  0x0a, 0x73, 0x6b, 0x32, 0x2f, 0x42, 0x2f, 0x56, 0x46, 0x51, 0x74, 0x6c, 0x35, 0x62, 0x33, 0x69,
+  0x67, 0x52, 0x55, 0x73, 0x55, 0x56, 0x39, 0x69, 0x63, 0x6e, 0x63, 0x30, 0x66, 0x6c, 0x4d, 0x78,
+  0x37, 0x6f, 0x63, 0x64, 0x6b, 0x52, 0x53, 0x6c, 0x7a, 0x55, 0x73, 0x4d, 0x50, 0x52, 0x4d, 0x4b,
+  0x58, 0x6b, 0x6d, 0x59, 0x77, 0x31, 0x47, 0x64, 0x35, 0x6d, 0x57, 0x61, 0x30, 0x2b, 0x6f, 0x61,
+  0x52, 0x0d, 0x0a, 0x45, 0x45, 0x44, 0x4f, 0x6d, 0x76, 0x41, 0x4f, 0x69, 0x64, 0x5a, 0x62, 0x6a,
+  0x4e, 0x61, 0x56, 0x37, 0x43, 0x66, 0x41, 0x4d, 0x52, 0x76, 0x49, 0x6d, 0x42, 0x56, 0x52, 0x66,
+  0x74, 0x47, 0x6b, 0x61, 0x4d, 0x31, 0x33, 0x5a, 0x44, 0x4f, 0x53, 0x4e, 0x66, 0x30, 0x70, 0x62,
+  0x77, 0x6b, 0x31, 0x67, 0x43, 0x4d, 0x39, 0x77, 0x6b, 0x4e, 0x56, 0x7a, 0x30, 0x2f, 0x6a, 0x4b,
+  0x37, 0x78, 0x72, 0x0d, 0x0a, 0x70, 0x39, 0x52, 0x41, 0x5a, 0x35, 0x7a, 0x42, 0x6c, 0x35, 0x45,
+  0x61, 0x56, 0x33, 0x4b, 0x48, 0x6e, 0x33, 0x31, 0x6c, 0x63, 0x38, 0x70, 0x77, 0x33, 0x48, 0x46,
+  0x7a, 0x75, 0x68, 0x30, 0x5a, 0x4f, 0x47, 0x33, 0x72, 0x71, 0x34, 0x46, 0x44, 0x63, 0x2b, 0x62,
+  0x53, 0x7a, 0x75, 0x6d, 0x74, 0x75, 0x77, 0x6f, 0x7a, 0x67, 0x54, 0x69, 0x6d, 0x47, 0x4e, 0x42,
+  0x50, 0x71, 0x49, 0x58, 0x64, 0x0d, 0x0a, 0x32, 0x6e, 0x74, 0x4f, 0x35, 0x30, 0x52, 0x68, 0x43,
+  0x77, 0x47, 0x6f, 0x75, 0x6e, 0x76, 0x56, 0x6d, 0x6d, 0x6b, 0x34, 0x52, 0x4c, 0x6e, 0x43, 0x4c,
+  0x51, 0x53, 0x4c, 0x79, 0x5a, 0x70, 0x35, 0x78, 0x4b, 0x57, 0x43, 0x4f, 0x43, 0x2f, 0x57, 0x66,
+  0x58, 0x76, 0x75, 0x70, 0x4e, 0x6f, 0x55, 0x2f, 0x70, 0x6c, 0x6d, 0x58, 0x65, 0x31, 0x2f, 0x35,
+  0x66, 0x79, 0x37, 0x50, 0x5a, 0x76, 0x66, 0x0d, 0x0a, 0x6b, 0x6d, 0x41, 0x46, 0x52, 0x69, 0x48,
+  0x5a, 0x66, 0x68, 0x35, 0x56, 0x6a, 0x51, 0x49, 0x31, 0x6b, 0x5a, 0x48, 0x72, 0x52, 0x57, 0x6e,
+  0x30, 0x73, 0x58, 0x46, 0x75, 0x79, 0x73, 0x4d, 0x69, 0x46, 0x72, 0x36, 0x43, 0x39, 0x49, 0x39,
+  0x72, 0x4b, 0x2b, 0x7a, 0x32, 0x67, 0x73, 0x34, 0x47, 0x31, 0x4a, 0x49, 0x31, 0x5a, 0x6f, 0x7a,
+  0x48, 0x61, 0x59, 0x36, 0x4d, 0x35, 0x4f, 0x30, 0x46, 0x0d, 0x0a, 0x71, 0x34, 0x32, 0x5a, 0x33,
+  0x56, 0x65, 0x6a, 0x4e, 0x54, 0x31, 0x46, 0x65, 0x65, 0x68, 0x48, 0x77, 0x41, 0x3d, 0x3d, 0x0d,
+  0x0a, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x45, 0x4e, 0x44, 0x20, 0x43, 0x45, 0x52, 0x54, 0x49, 0x46,
+  0x49, 0x43, 0x41, 0x54, 0x45, 0x2d, 0x2d, 0x2d, 0x2d, 0x2d, 0x0d, 0x0a,
+};
+
+// Generated from DfciPkg/UnitTests/DfciTests/TestCases/DFCI_InTuneEnroll/DfciSettings.xml
+CONST UINT8  mDfciSettingsXml[] = {
+  0x3c, 0x3f, 0x78, 0x6d, 0x6c, 0x20, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x3d, 0x22, 0x31,
+  0x2e, 0x30, 0x22, 0x20, 0x65, 0x6e, 0x63, 0x6f, 0x64, 0x69, 0x6e, 0x67, 0x3d, 0x22, 0x75, 0x74,
+  0x66, 0x2d, 0x38, 0x22, 0x3f, 0x3e, 0x0d, 0x0a, 0x3c, 0x21, 0x2d, 0x2d, 0x0d, 0x0a, 0x0d, 0x0a,
+  0x20, 0x20, 0x20, 0x20, 0x40, 0x66, 0x69, 0x6c, 0x65, 0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x20, 0x20,
+  0x20, 0x53, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x20, 0x44, 0x46, 0x43, 0x49, 0x20, 0x4f, 0x77, 0x6e,
+  0x65, 0x72, 0x20, 0x69, 0x6e, 0x69, 0x74, 0x69, 0x61, 0x6c, 0x20, 0x65, 0x6e, 0x72, 0x6f, 0x6c,
+  0x6c, 0x20, 0x73, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x73, 0x0d, 0x0a, 0x0d, 0x0a, 0x0d, 0x0a,
+  0x20, 0x20, 0x20, 0x20, 0x4d, 0x61, 0x6b, 0x65, 0x20, 0x73, 0x75, 0x72, 0x65, 0x20, 0x79, 0x6f,
+  0x75, 0x20, 0x65, 0x64, 0x69, 0x74, 0x20, 0x44, 0x66, 0x63, 0x69, 0x53, 0x65, 0x74, 0x74, 0x69,
+  0x6e, 0x67, 0x73, 0x50, 0x61, 0x74, 0x74, 0x65, 0x72, 0x6e, 0x2e, 0x78, 0x6d, 0x6c, 0x20, 0x61,
+  0x6e, 0x64, 0x20, 0x74, 0x68, 0x65, 0x6e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x72, 0x75, 0x6e,
+  0x20, 0x42, 0x75, 0x69, 0x6c, 0x64, 0x53, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x73, 0x2e, 0x62,
+  0x61, 0x74, 0x20, 0x74, 0x6f, 0x20, 0x67, 0x65, 0x6e, 0x65, 0x72, 0x61, 0x74, 0x65, 0x20, 0x74,
+  0x68, 0x69, 0x73, 0x20, 0x44, 0x66, 0x63, 0x69, 0x53, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x73,
+  0x2e, 0x78, 0x6d, 0x6c, 0x0d, 0x0a, 0x0d, 0x0a, 0x0d, 0x0a, 0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x20,
+  0x20, 0x20, 0x43, 0x6f, 0x70, 0x79, 0x72, 0x69, 0x67, 0x68, 0x74, 0x20, 0x28, 0x63, 0x29, 0x2c,
+  0x20, 0x4d, 0x69, 0x63, 0x72, 0x6f, 0x73, 0x6f, 0x66, 0x74, 0x20, 0x43, 0x6f, 0x72, 0x70, 0x6f,
+  0x72, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x53, 0x50, 0x44, 0x58,
+  0x2d, 0x4c, 0x69, 0x63, 0x65, 0x6e, 0x73, 0x65, 0x2d, 0x49, 0x64, 0x65, 0x6e, 0x74, 0x69, 0x66,
+  0x69, 0x65, 0x72, 0x3a, 0x20, 0x42, 0x53, 0x44, 0x2d, 0x32, 0x2d, 0x43, 0x6c, 0x61, 0x75, 0x73,
+  0x65, 0x2d, 0x50, 0x61, 0x74, 0x65, 0x6e, 0x74, 0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x2d, 0x2d, 0x3e,
+  0x0d, 0x0a, 0x3c, 0x53, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x73, 0x50, 0x61, 0x63, 0x6b, 0x65,
+  0x74, 0x20, 0x78, 0x6d, 0x6c, 0x6e, 0x73, 0x3d, 0x22, 0x75, 0x72, 0x6e, 0x3a, 0x55, 0x65, 0x66,
+  0x69, 0x53, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x73, 0x2d, 0x53, 0x63, 0x68, 0x65, 0x6d, 0x61,
+  0x22, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x43, 0x72, 0x65, 0x61, 0x74, 0x65, 0x64,
+  0x42, 0x79, 0x3e, 0x44, 0x46, 0x43, 0x49, 0x20, 0x54, 0x65, 0x73, 0x74, 0x65, 0x72, 0x3c, 0x2f,
+  0x43, 0x72, 0x65, 0x61, 0x74, 0x65, 0x64, 0x42, 0x79, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20,
+  0x3c, 0x43, 0x72, 0x65, 0x61, 0x74, 0x65, 0x64, 0x4f, 0x6e, 0x3e, 0x32, 0x30, 0x32, 0x30, 0x2d,
+  0x30, 0x33, 0x2d, 0x32, 0x37, 0x20, 0x31, 0x30, 0x3a, 0x32, 0x32, 0x3a, 0x30, 0x30, 0x3c, 0x2f,
+  0x43, 0x72, 0x65, 0x61, 0x74, 0x65, 0x64, 0x4f, 0x6e, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20,
+  0x3c, 0x56, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x3e, 0x32, 0x3c, 0x2f, 0x56, 0x65, 0x72, 0x73,
+  0x69, 0x6f, 0x6e, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x21, 0x2d, 0x2d, 0x0d, 0x0a,
+  0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x4d, 0x61, 0x6b, 0x65, 0x20, 0x73, 0x75, 0x72,
+  0x65, 0x20, 0x79, 0x6f, 0x75, 0x20, 0x65, 0x64, 0x69, 0x74, 0x20, 0x44, 0x66, 0x63, 0x69, 0x53,
+  0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x73, 0x50, 0x61, 0x74, 0x74, 0x65, 0x72, 0x6e, 0x2e, 0x78,
+  0x6d, 0x6c, 0x20, 0x61, 0x6e, 0x64, 0x20, 0x74, 0x68, 0x65, 0x6e, 0x0d, 0x0a, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x72, 0x75, 0x6e, 0x20, 0x42, 0x75, 0x69, 0x6c, 0x64, 0x53, 0x65, 0x74, 0x74,
+  0x69, 0x6e, 0x67, 0x73, 0x2e, 0x62, 0x61, 0x74, 0x20, 0x74, 0x6f, 0x20, 0x67, 0x65, 0x6e, 0x65,
+  0x72, 0x61, 0x74, 0x65, 0x20, 0x74, 0x68, 0x69, 0x73, 0x20, 0x44, 0x66, 0x63, 0x69, 0x53, 0x65,
+  0x74, 0x74, 0x69, 0x6e, 0x67, 0x73, 0x2e, 0x78, 0x6d, 0x6c, 0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x2d, 0x2d, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x4c, 0x6f,
+  0x77, 0x65, 0x73, 0x74, 0x53, 0x75, 0x70, 0x70, 0x6f, 0x72, 0x74, 0x65, 0x64, 0x56, 0x65, 0x72,
+  0x73, 0x69, 0x6f, 0x6e, 0x3e, 0x32, 0x3c, 0x2f, 0x4c, 0x6f, 0x77, 0x65, 0x73, 0x74, 0x53, 0x75,
+  0x70, 0x70, 0x6f, 0x72, 0x74, 0x65, 0x64, 0x56, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x3e, 0x0d,
+  0x0a, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x53, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x73, 0x3e, 0x0d,
+  0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x53, 0x65, 0x74, 0x74, 0x69, 0x6e,
+  0x67, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x3c, 0x49, 0x64, 0x3e, 0x44, 0x66, 0x63, 0x69, 0x2e, 0x52, 0x65, 0x63, 0x6f, 0x76, 0x65, 0x72,
+  0x79, 0x42, 0x6f, 0x6f, 0x74, 0x73, 0x74, 0x72, 0x61, 0x70, 0x55, 0x72, 0x6c, 0x2e, 0x53, 0x74,
+  0x72, 0x69, 0x6e, 0x67, 0x3c, 0x2f, 0x49, 0x64, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x56, 0x61, 0x6c, 0x75, 0x65, 0x3e, 0x68, 0x74,
+  0x74, 0x70, 0x3a, 0x2f, 0x2f, 0x6d, 0x69, 0x6b, 0x65, 0x79, 0x74, 0x62, 0x64, 0x73, 0x33, 0x2e,
+  0x65, 0x61, 0x73, 0x74, 0x75, 0x73, 0x2e, 0x63, 0x6c, 0x6f, 0x75, 0x64, 0x61, 0x70, 0x70, 0x2e,
+  0x61, 0x7a, 0x75, 0x72, 0x65, 0x2e, 0x63, 0x6f, 0x6d, 0x2f, 0x7a, 0x74, 0x64, 0x2f, 0x6e, 0x6f,
+  0x61, 0x75, 0x74, 0x68, 0x2f, 0x64, 0x66, 0x63, 0x69, 0x2f, 0x72, 0x65, 0x63, 0x6f, 0x76, 0x65,
+  0x72, 0x79, 0x2d, 0x62, 0x6f, 0x6f, 0x74, 0x73, 0x74, 0x72, 0x61, 0x70, 0x2f, 0x3c, 0x2f, 0x56,
+  0x61, 0x6c, 0x75, 0x65, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c,
+  0x2f, 0x53, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x3c, 0x53, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x3e, 0x0d, 0x0a, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x49, 0x64, 0x3e, 0x44, 0x66,
+  0x63, 0x69, 0x2e, 0x52, 0x65, 0x63, 0x6f, 0x76, 0x65, 0x72, 0x79, 0x55, 0x72, 0x6c, 0x2e, 0x53,
+  0x74, 0x72, 0x69, 0x6e, 0x67, 0x3c, 0x2f, 0x49, 0x64, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x56, 0x61, 0x6c, 0x75, 0x65, 0x3e, 0x68,
+  0x74, 0x74, 0x70, 0x73, 0x3a, 0x2f, 0x2f, 0x6d, 0x69, 0x6b, 0x65, 0x79, 0x74, 0x62, 0x64, 0x73,
+  0x33, 0x2e, 0x65, 0x61, 0x73, 0x74, 0x75, 0x73, 0x2e, 0x63, 0x6c, 0x6f, 0x75, 0x64, 0x61, 0x70,
+  0x70, 0x2e, 0x61, 0x7a, 0x75, 0x72, 0x65, 0x2e, 0x63, 0x6f, 0x6d, 0x2f, 0x7a, 0x74, 0x64, 0x2f,
+  0x75, 0x6e, 0x61, 0x75, 0x74, 0x68, 0x2f, 0x64, 0x66, 0x63, 0x69, 0x2f, 0x72, 0x65, 0x63, 0x6f,
+  0x76, 0x65, 0x72, 0x79, 0x2d, 0x70, 0x61, 0x63, 0x6b, 0x65, 0x74, 0x73, 0x2f, 0x3c, 0x2f, 0x56,
+  0x61, 0x6c, 0x75, 0x65, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c,
+  0x2f, 0x53, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x3c, 0x53, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x3e, 0x0d, 0x0a, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x49, 0x64, 0x3e, 0x44, 0x66,
+  0x63, 0x69, 0x2e, 0x48, 0x74, 0x74, 0x70, 0x73, 0x43, 0x65, 0x72, 0x74, 0x2e, 0x42, 0x69, 0x6e,
+  0x61, 0x72, 0x79, 0x3c, 0x2f, 0x49, 0x64, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x21, 0x2d, 0x2d, 0x0d, 0x0a,
+  0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x56, 0x61, 0x6c, 0x75, 0x65, 0x20, 0x69, 0x73, 0x20, 0x58, 0x59, 0x5a, 0x5a, 0x59,
+  0x20, 0x69, 0x6e, 0x20, 0x44, 0x66, 0x63, 0x69, 0x53, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x73,
+  0x50, 0x61, 0x74, 0x74, 0x65, 0x72, 0x6e, 0x2e, 0x78, 0x6d, 0x6c, 0x2e, 0x20, 0x20, 0x74, 0x68,
+  0x65, 0x20, 0x58, 0x59, 0x5a, 0x5a, 0x59, 0x20, 0x69, 0x73, 0x20, 0x72, 0x65, 0x70, 0x6c, 0x61,
+  0x63, 0x65, 0x64, 0x20, 0x62, 0x79, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x61, 0x20, 0x62, 0x61, 0x73, 0x65, 0x36, 0x34,
+  0x20, 0x73, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x20, 0x6f, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20, 0x48,
+  0x54, 0x54, 0x50, 0x53, 0x20, 0x63, 0x65, 0x72, 0x74, 0x69, 0x66, 0x69, 0x63, 0x61, 0x74, 0x65,
+  0x20, 0x77, 0x68, 0x65, 0x6e, 0x20, 0x79, 0x6f, 0x75, 0x20, 0x72, 0x75, 0x6e, 0x20, 0x42, 0x75,
+  0x69, 0x6c, 0x64, 0x53, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x73, 0x2e, 0x62, 0x61, 0x74, 0x2e,
+  0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x2d, 0x2d, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x56, 0x61, 0x6c, 0x75, 0x65, 0x3e, 0x0d, 0x0a, 0x4d, 0x49,
+  0x49, 0x45, 0x57, 0x54, 0x43, 0x43, 0x41, 0x30, 0x47, 0x67, 0x41, 0x77, 0x49, 0x42, 0x41, 0x67,
+  0x49, 0x55, 0x44, 0x4d, 0x4d, 0x49, 0x72, 0x76, 0x78, 0x2b, 0x6e, 0x2f, 0x36, 0x6c, 0x42, 0x43,
+  0x4f, 0x56, 0x6d, 0x58, 0x49, 0x55, 0x52, 0x2f, 0x6c, 0x65, 0x54, 0x6b, 0x4d, 0x77, 0x44, 0x51,
+  0x59, 0x4a, 0x4b, 0x6f, 0x5a, 0x49, 0x68, 0x76, 0x63, 0x4e, 0x41, 0x51, 0x45, 0x4c, 0x42, 0x51,
+  0x41, 0x77, 0x66, 0x6a, 0x45, 0x4c, 0x4d, 0x41, 0x6b, 0x47, 0x41, 0x31, 0x55, 0x45, 0x42, 0x68,
+  0x4d, 0x43, 0x56, 0x56, 0x4d, 0x78, 0x43, 0x7a, 0x41, 0x4a, 0x42, 0x67, 0x4e, 0x56, 0x42, 0x41,
+  0x67, 0x54, 0x41, 0x6c, 0x64, 0x42, 0x4d, 0x52, 0x41, 0x77, 0x44, 0x67, 0x59, 0x44, 0x56, 0x51,
+  0x51, 0x48, 0x45, 0x77, 0x64, 0x53, 0x5a, 0x57, 0x52, 0x74, 0x62, 0x32, 0x35, 0x6b, 0x4d, 0x52,
+  0x55, 0x77, 0x45, 0x77, 0x59, 0x44, 0x56, 0x51, 0x51, 0x4b, 0x45, 0x77, 0x78, 0x45, 0x5a, 0x6d,
+  0x4e, 0x70, 0x49, 0x46, 0x52, 0x6c, 0x63, 0x33, 0x52, 0x70, 0x62, 0x6d, 0x63, 0x78, 0x47, 0x54,
+  0x41, 0x58, 0x42, 0x67, 0x4e, 0x56, 0x42, 0x41, 0x73, 0x54, 0x45, 0x45, 0x52, 0x6d, 0x59, 0x32,
+  0x6c, 0x53, 0x5a, 0x57, 0x4e, 0x76, 0x64, 0x6d, 0x56, 0x79, 0x65, 0x56, 0x52, 0x6c, 0x63, 0x33,
+  0x51, 0x78, 0x48, 0x6a, 0x41, 0x63, 0x42, 0x67, 0x4e, 0x56, 0x42, 0x41, 0x4d, 0x54, 0x46, 0x55,
+  0x31, 0x70, 0x61, 0x32, 0x56, 0x35, 0x63, 0x79, 0x42, 0x45, 0x5a, 0x6d, 0x4e, 0x70, 0x49, 0x46,
+  0x52, 0x6c, 0x63, 0x33, 0x51, 0x67, 0x55, 0x32, 0x68, 0x76, 0x63, 0x44, 0x41, 0x65, 0x46, 0x77,
+  0x30, 0x78, 0x4f, 0x54, 0x41, 0x32, 0x4d, 0x44, 0x4d, 0x77, 0x4d, 0x7a, 0x55, 0x7a, 0x4d, 0x7a,
+  0x46, 0x61, 0x46, 0x77, 0x30, 0x79, 0x4d, 0x54, 0x41, 0x32, 0x4d, 0x44, 0x49, 0x77, 0x4d, 0x7a,
+  0x55, 0x7a, 0x4d, 0x7a, 0x46, 0x61, 0x4d, 0x48, 0x34, 0x78, 0x43, 0x7a, 0x41, 0x4a, 0x42, 0x67,
+  0x4e, 0x56, 0x42, 0x41, 0x59, 0x54, 0x41, 0x6c, 0x56, 0x54, 0x4d, 0x51, 0x73, 0x77, 0x43, 0x51,
+  0x59, 0x44, 0x56, 0x51, 0x51, 0x49, 0x45, 0x77, 0x4a, 0x58, 0x51, 0x54, 0x45, 0x51, 0x4d, 0x41,
+  0x34, 0x47, 0x41, 0x31, 0x55, 0x45, 0x42, 0x78, 0x4d, 0x48, 0x55, 0x6d, 0x56, 0x6b, 0x62, 0x57,
+  0x39, 0x75, 0x5a, 0x44, 0x45, 0x56, 0x4d, 0x42, 0x4d, 0x47, 0x41, 0x31, 0x55, 0x45, 0x43, 0x68,
+  0x4d, 0x4d, 0x52, 0x47, 0x5a, 0x6a, 0x61, 0x53, 0x42, 0x55, 0x5a, 0x58, 0x4e, 0x30, 0x61, 0x57,
+  0x35, 0x6e, 0x4d, 0x52, 0x6b, 0x77, 0x46, 0x77, 0x59, 0x44, 0x56, 0x51, 0x51, 0x4c, 0x45, 0x78,
+  0x42, 0x45, 0x5a, 0x6d, 0x4e, 0x70, 0x55, 0x6d, 0x56, 0x6a, 0x62, 0x33, 0x5a, 0x6c, 0x63, 0x6e,
+  0x6c, 0x55, 0x5a, 0x58, 0x4e, 0x30, 0x4d, 0x52, 0x34, 0x77, 0x48, 0x41, 0x59, 0x44, 0x56, 0x51,
+  0x51, 0x44, 0x45, 0x78, 0x56, 0x4e, 0x61, 0x57, 0x74, 0x6c, 0x65, 0x58, 0x4d, 0x67, 0x52, 0x47,
+  0x5a, 0x6a, 0x61, 0x53, 0x42, 0x55, 0x5a, 0x58, 0x4e, 0x30, 0x49, 0x46, 0x4e, 0x6f, 0x62, 0x33,
+  0x41, 0x77, 0x67, 0x67, 0x45, 0x69, 0x4d, 0x41, 0x30, 0x47, 0x43, 0x53, 0x71, 0x47, 0x53, 0x49,
+  0x62, 0x33, 0x44, 0x51, 0x45, 0x42, 0x41, 0x51, 0x55, 0x41, 0x41, 0x34, 0x49, 0x42, 0x44, 0x77,
+  0x41, 0x77, 0x67, 0x67, 0x45, 0x4b, 0x41, 0x6f, 0x49, 0x42, 0x41, 0x51, 0x44, 0x68, 0x64, 0x30,
+  0x54, 0x58, 0x71, 0x65, 0x78, 0x53, 0x63, 0x6b, 0x71, 0x6d, 0x37, 0x43, 0x58, 0x2b, 0x78, 0x39,
+  0x76, 0x48, 0x45, 0x55, 0x4d, 0x42, 0x71, 0x44, 0x2b, 0x66, 0x55, 0x74, 0x42, 0x6a, 0x41, 0x73,
+  0x6c, 0x72, 0x42, 0x32, 0x76, 0x73, 0x46, 0x77, 0x72, 0x43, 0x78, 0x2f, 0x33, 0x4a, 0x62, 0x33,
+  0x32, 0x4f, 0x50, 0x4a, 0x64, 0x66, 0x5a, 0x41, 0x48, 0x44, 0x57, 0x63, 0x5a, 0x4d, 0x78, 0x66,
+  0x31, 0x39, 0x50, 0x68, 0x49, 0x41, 0x75, 0x51, 0x62, 0x62, 0x66, 0x52, 0x43, 0x4c, 0x49, 0x78,
+  0x61, 0x72, 0x61, 0x6d, 0x37, 0x49, 0x74, 0x56, 0x64, 0x6b, 0x33, 0x50, 0x6a, 0x6b, 0x2f, 0x64,
+  0x5a, 0x7a, 0x76, 0x66, 0x76, 0x6f, 0x46, 0x6d, 0x52, 0x7a, 0x64, 0x56, 0x46, 0x41, 0x4e, 0x51,
+  0x4d, 0x4a, 0x5a, 0x75, 0x69, 0x46, 0x52, 0x38, 0x6e, 0x55, 0x77, 0x4a, 0x6b, 0x68, 0x6f, 0x41,
+  0x64, 0x64, 0x37, 0x78, 0x68, 0x67, 0x2b, 0x6b, 0x42, 0x34, 0x67, 0x74, 0x6c, 0x42, 0x47, 0x4f,
+  0x43, 0x33, 0x34, 0x36, 0x2b, 0x4b, 0x37, 0x51, 0x50, 0x58, 0x6c, 0x56, 0x77, 0x79, 0x38, 0x2b,
+  0x4d, 0x6c, 0x4a, 0x65, 0x55, 0x7a, 0x70, 0x65, 0x30, 0x49, 0x4c, 0x51, 0x4d, 0x36, 0x6b, 0x38,
+  0x63, 0x64, 0x45, 0x41, 0x79, 0x46, 0x67, 0x35, 0x33, 0x69, 0x2f, 0x4f, 0x65, 0x6b, 0x78, 0x6c,
+  0x58, 0x76, 0x6b, 0x51, 0x61, 0x46, 0x62, 0x71, 0x69, 0x6a, 0x61, 0x42, 0x4d, 0x44, 0x6b, 0x35,
+  0x70, 0x52, 0x36, 0x53, 0x41, 0x65, 0x61, 0x31, 0x79, 0x67, 0x6c, 0x70, 0x68, 0x4f, 0x59, 0x6b,
+  0x31, 0x30, 0x64, 0x74, 0x4a, 0x33, 0x6d, 0x70, 0x74, 0x65, 0x68, 0x6e, 0x72, 0x76, 0x4f, 0x63,
+  0x65, 0x4c, 0x6b, 0x6e, 0x47, 0x55, 0x45, 0x51, 0x37, 0x69, 0x31, 0x43, 0x6e, 0x71, 0x59, 0x38,
+  0x72, 0x37, 0x41, 0x4b, 0x79, 0x4e, 0x4f, 0x74, 0x71, 0x39, 0x43, 0x33, 0x46, 0x69, 0x6e, 0x38,
+  0x58, 0x30, 0x4d, 0x41, 0x6b, 0x72, 0x49, 0x53, 0x6d, 0x64, 0x51, 0x6a, 0x4a, 0x35, 0x59, 0x5a,
+  0x63, 0x73, 0x79, 0x37, 0x64, 0x65, 0x66, 0x5a, 0x71, 0x70, 0x56, 0x45, 0x54, 0x36, 0x61, 0x52,
+  0x74, 0x58, 0x41, 0x66, 0x6f, 0x4d, 0x48, 0x41, 0x2f, 0x59, 0x56, 0x5a, 0x4c, 0x43, 0x4d, 0x55,
+  0x46, 0x43, 0x6d, 0x43, 0x43, 0x67, 0x59, 0x48, 0x76, 0x74, 0x43, 0x46, 0x36, 0x69, 0x55, 0x62,
+  0x4d, 0x72, 0x41, 0x67, 0x4d, 0x42, 0x41, 0x41, 0x47, 0x6a, 0x67, 0x63, 0x34, 0x77, 0x67, 0x63,
+  0x73, 0x77, 0x43, 0x77, 0x59, 0x44, 0x56, 0x52, 0x30, 0x50, 0x42, 0x41, 0x51, 0x44, 0x41, 0x67,
+  0x57, 0x67, 0x4d, 0x42, 0x30, 0x47, 0x41, 0x31, 0x55, 0x64, 0x44, 0x67, 0x51, 0x57, 0x42, 0x42,
+  0x53, 0x2f, 0x4b, 0x7a, 0x66, 0x58, 0x35, 0x4e, 0x47, 0x2f, 0x4f, 0x45, 0x62, 0x62, 0x33, 0x39,
+  0x6b, 0x56, 0x59, 0x4d, 0x2b, 0x4d, 0x70, 0x61, 0x77, 0x45, 0x6c, 0x7a, 0x42, 0x57, 0x42, 0x67,
+  0x4e, 0x56, 0x48, 0x52, 0x45, 0x45, 0x54, 0x7a, 0x42, 0x4e, 0x67, 0x68, 0x56, 0x6b, 0x5a, 0x48,
+  0x4d, 0x75, 0x62, 0x57, 0x6c, 0x6a, 0x63, 0x6d, 0x39, 0x7a, 0x62, 0x32, 0x5a, 0x30, 0x4c, 0x57,
+  0x6c, 0x75, 0x64, 0x43, 0x35, 0x6a, 0x62, 0x32, 0x32, 0x43, 0x46, 0x79, 0x6f, 0x75, 0x5a, 0x47,
+  0x52, 0x7a, 0x4c, 0x6d, 0x31, 0x70, 0x59, 0x33, 0x4a, 0x76, 0x63, 0x32, 0x39, 0x6d, 0x64, 0x43,
+  0x31, 0x70, 0x62, 0x6e, 0x51, 0x75, 0x59, 0x32, 0x39, 0x74, 0x67, 0x68, 0x73, 0x71, 0x4c, 0x6d,
+  0x56, 0x68, 0x63, 0x33, 0x52, 0x31, 0x63, 0x79, 0x35, 0x6a, 0x62, 0x47, 0x39, 0x31, 0x5a, 0x47,
+  0x46, 0x77, 0x63, 0x43, 0x35, 0x68, 0x65, 0x6e, 0x56, 0x79, 0x5a, 0x53, 0x35, 0x6a, 0x62, 0x32,
+  0x30, 0x77, 0x44, 0x77, 0x59, 0x44, 0x56, 0x52, 0x30, 0x54, 0x41, 0x51, 0x48, 0x2f, 0x42, 0x41,
+  0x55, 0x77, 0x41, 0x77, 0x49, 0x42, 0x41, 0x44, 0x41, 0x54, 0x42, 0x67, 0x4e, 0x56, 0x48, 0x53,
+  0x55, 0x45, 0x44, 0x44, 0x41, 0x4b, 0x42, 0x67, 0x67, 0x72, 0x42, 0x67, 0x45, 0x46, 0x42, 0x51,
+  0x63, 0x44, 0x41, 0x54, 0x41, 0x66, 0x42, 0x67, 0x4e, 0x56, 0x48, 0x53, 0x4d, 0x45, 0x47, 0x44,
+  0x41, 0x57, 0x67, 0x42, 0x53, 0x2f, 0x4b, 0x7a, 0x66, 0x58, 0x35, 0x4e, 0x47, 0x2f, 0x4f, 0x45,
+  0x62, 0x62, 0x33, 0x39, 0x6b, 0x56, 0x59, 0x4d, 0x2b, 0x4d, 0x70, 0x61, 0x77, 0x45, 0x6c, 0x7a,
+  0x41, 0x4e, 0x42, 0x67, 0x6b, 0x71, 0x68, 0x6b, 0x69, 0x47, 0x39, 0x77, 0x30, 0x42, 0x41, 0x51,
+  0x73, 0x46, 0x41, 0x41, 0x4f, 0x43, 0x41, 0x51, 0x45, 0x41, 0x77, 0x55, 0x6e, 0x38, 0x73, 0x6b,
+  0x32, 0x2f, 0x42, 0x2f, 0x56, 0x46, 0x51, 0x74, 0x6c, 0x35, 0x62, 0x33, 0x69, 0x67, 0x52, 0x55,
+  0x73, 0x55, 0x56, 0x39, 0x69, 0x63, 0x6e, 0x63, 0x30, 0x66, 0x6c, 0x4d, 0x78, 0x37, 0x6f, 0x63,
+  0x64, 0x6b, 0x52, 0x53, 0x6c, 0x7a, 0x55, 0x73, 0x4d, 0x50, 0x52, 0x4d, 0x4b, 0x58, 0x6b, 0x6d,
+  0x59, 0x77, 0x31, 0x47, 0x64, 0x35, 0x6d, 0x57, 0x61, 0x30, 0x2b, 0x6f, 0x61, 0x52, 0x45, 0x45,
+  0x44, 0x4f, 0x6d, 0x76, 0x41, 0x4f, 0x69, 0x64, 0x5a, 0x62, 0x6a, 0x4e, 0x61, 0x56, 0x37, 0x43,
+  0x66, 0x41, 0x4d, 0x52, 0x76, 0x49, 0x6d, 0x42, 0x56, 0x52, 0x66, 0x74, 0x47, 0x6b, 0x61, 0x4d,
+  0x31, 0x33, 0x5a, 0x44, 0x4f, 0x53, 0x4e, 0x66, 0x30, 0x70, 0x62, 0x77, 0x6b, 0x31, 0x67, 0x43,
+  0x4d, 0x39, 0x77, 0x6b, 0x4e, 0x56, 0x7a, 0x30, 0x2f, 0x6a, 0x4b, 0x37, 0x78, 0x72, 0x70, 0x39,
+  0x52, 0x41, 0x5a, 0x35, 0x7a, 0x42, 0x6c, 0x35, 0x45, 0x61, 0x56, 0x33, 0x4b, 0x48, 0x6e, 0x33,
+  0x31, 0x6c, 0x63, 0x38, 0x70, 0x77, 0x33, 0x48, 0x46, 0x7a, 0x75, 0x68, 0x30, 0x5a, 0x4f, 0x47,
+  0x33, 0x72, 0x71, 0x34, 0x46, 0x44, 0x63, 0x2b, 0x62, 0x53, 0x7a, 0x75, 0x6d, 0x74, 0x75, 0x77,
+  0x6f, 0x7a, 0x67, 0x54, 0x69, 0x6d, 0x47, 0x4e, 0x42, 0x50, 0x71, 0x49, 0x58, 0x64, 0x32, 0x6e,
+  0x74, 0x4f, 0x35, 0x30, 0x52, 0x68, 0x43, 0x77, 0x47, 0x6f, 0x75, 0x6e, 0x76, 0x56, 0x6d, 0x6d,
+  0x6b, 0x34, 0x52, 0x4c, 0x6e, 0x43, 0x4c, 0x51, 0x53, 0x4c, 0x79, 0x5a, 0x70, 0x35, 0x78, 0x4b,
+  0x57, 0x43, 0x4f, 0x43, 0x2f, 0x57, 0x66, 0x58, 0x76, 0x75, 0x70, 0x4e, 0x6f, 0x55, 0x2f, 0x70,
+  0x6c, 0x6d, 0x58, 0x65, 0x31, 0x2f, 0x35, 0x66, 0x79, 0x37, 0x50, 0x5a, 0x76, 0x66, 0x6b, 0x6d,
+  0x41, 0x46, 0x52, 0x69, 0x48, 0x5a, 0x66, 0x68, 0x35, 0x56, 0x6a, 0x51, 0x49, 0x31, 0x6b, 0x5a,
+  0x48, 0x72, 0x52, 0x57, 0x6e, 0x30, 0x73, 0x58, 0x46, 0x75, 0x79, 0x73, 0x4d, 0x69, 0x46, 0x72,
+  0x36, 0x43, 0x39, 0x49, 0x39, 0x72, 0x4b, 0x2b, 0x7a, 0x32, 0x67, 0x73, 0x34, 0x47, 0x31, 0x4a,
+  0x49, 0x31, 0x5a, 0x6f, 0x7a, 0x48, 0x61, 0x59, 0x36, 0x4d, 0x35, 0x4f, 0x30, 0x46, 0x71, 0x34,
+  0x32, 0x5a, 0x33, 0x56, 0x65, 0x6a, 0x4e, 0x54, 0x31, 0x46, 0x65, 0x65, 0x68, 0x48, 0x77, 0x41,
+  0x3d, 0x3d, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x3c, 0x2f, 0x56, 0x61, 0x6c, 0x75, 0x65, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x3c, 0x2f, 0x53, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x3e, 0x0d, 0x0a, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x53, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x3e, 0x0d,
+  0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x49, 0x64,
+  0x3e, 0x44, 0x66, 0x63, 0x69, 0x2e, 0x52, 0x65, 0x67, 0x69, 0x73, 0x74, 0x72, 0x61, 0x74, 0x69,
+  0x6f, 0x6e, 0x49, 0x64, 0x2e, 0x53, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x3c, 0x2f, 0x49, 0x64, 0x3e,
+  0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x56,
+  0x61, 0x6c, 0x75, 0x65, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x2d,
+  0x31, 0x32, 0x33, 0x34, 0x2d, 0x35, 0x36, 0x37, 0x38, 0x2d, 0x31, 0x32, 0x33, 0x34, 0x2d, 0x30,
+  0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x34, 0x33, 0x32, 0x31, 0x0d, 0x0a, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x2f, 0x56, 0x61, 0x6c, 0x75, 0x65,
+  0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x2f, 0x53, 0x65, 0x74,
+  0x74, 0x69, 0x6e, 0x67, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c,
+  0x53, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x49, 0x64, 0x3e, 0x44, 0x66, 0x63, 0x69, 0x2e, 0x54,
+  0x65, 0x6e, 0x61, 0x6e, 0x74, 0x49, 0x64, 0x2e, 0x53, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x3c, 0x2f,
+  0x49, 0x64, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x3c, 0x56, 0x61, 0x6c, 0x75, 0x65, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x39, 0x38, 0x37, 0x36, 0x35, 0x34,
+  0x33, 0x32, 0x2d, 0x31, 0x32, 0x33, 0x34, 0x2d, 0x35, 0x36, 0x37, 0x38, 0x2d, 0x31, 0x32, 0x33,
+  0x34, 0x2d, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x34, 0x33, 0x32, 0x31, 0x0d, 0x0a,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x2f, 0x56, 0x61,
+  0x6c, 0x75, 0x65, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x2f,
+  0x53, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c,
+  0x2f, 0x53, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x73, 0x3e, 0x0d, 0x0a, 0x3c, 0x2f, 0x53, 0x65,
+  0x74, 0x74, 0x69, 0x6e, 0x67, 0x73, 0x50, 0x61, 0x63, 0x6b, 0x65, 0x74, 0x3e,
+};
+
+// Generated from DfciPkg/UnitTests/DfciTests/TestCases/DFCI_InTuneEnroll/DfciPermission.xml
+CONST UINT8  mDfciPermissionXml[] = {
+  0x3c, 0x3f, 0x78, 0x6d, 0x6c, 0x20, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x3d, 0x22, 0x31,
+  0x2e, 0x30, 0x22, 0x20, 0x65, 0x6e, 0x63, 0x6f, 0x64, 0x69, 0x6e, 0x67, 0x3d, 0x22, 0x75, 0x74,
+  0x66, 0x2d, 0x38, 0x22, 0x3f, 0x3e, 0x0d, 0x0a, 0x3c, 0x21, 0x2d, 0x2d, 0x0d, 0x0a, 0x0d, 0x0a,
+  0x20, 0x20, 0x20, 0x20, 0x40, 0x66, 0x69, 0x6c, 0x65, 0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x20, 0x20,
+  0x20, 0x53, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x20, 0x44, 0x46, 0x43, 0x49, 0x20, 0x4f, 0x77, 0x6e,
+  0x65, 0x72, 0x20, 0x69, 0x6e, 0x69, 0x74, 0x69, 0x61, 0x6c, 0x20, 0x65, 0x6e, 0x72, 0x6f, 0x6c,
+  0x6c, 0x20, 0x70, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x73, 0x0d, 0x0a, 0x0d,
+  0x0a, 0x20, 0x20, 0x20, 0x20, 0x43, 0x6f, 0x70, 0x79, 0x72, 0x69, 0x67, 0x68, 0x74, 0x20, 0x28,
+  0x63, 0x29, 0x2c, 0x20, 0x4d, 0x69, 0x63, 0x72, 0x6f, 0x73, 0x6f, 0x66, 0x74, 0x20, 0x43, 0x6f,
+  0x72, 0x70, 0x6f, 0x72, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x53,
+  0x50, 0x44, 0x58, 0x2d, 0x4c, 0x69, 0x63, 0x65, 0x6e, 0x73, 0x65, 0x2d, 0x49, 0x64, 0x65, 0x6e,
+  0x74, 0x69, 0x66, 0x69, 0x65, 0x72, 0x3a, 0x20, 0x42, 0x53, 0x44, 0x2d, 0x32, 0x2d, 0x43, 0x6c,
+  0x61, 0x75, 0x73, 0x65, 0x2d, 0x50, 0x61, 0x74, 0x65, 0x6e, 0x74, 0x0d, 0x0a, 0x0d, 0x0a, 0x20,
+  0x2d, 0x2d, 0x3e, 0x0d, 0x0a, 0x3c, 0x50, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f, 0x6e,
+  0x73, 0x50, 0x61, 0x63, 0x6b, 0x65, 0x74, 0x20, 0x78, 0x6d, 0x6c, 0x6e, 0x73, 0x3d, 0x22, 0x75,
+  0x72, 0x6e, 0x3a, 0x55, 0x65, 0x66, 0x69, 0x53, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x73, 0x2d,
+  0x53, 0x63, 0x68, 0x65, 0x6d, 0x61, 0x22, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x43,
+  0x72, 0x65, 0x61, 0x74, 0x65, 0x64, 0x42, 0x79, 0x3e, 0x44, 0x46, 0x43, 0x49, 0x20, 0x54, 0x65,
+  0x73, 0x74, 0x65, 0x72, 0x3c, 0x2f, 0x43, 0x72, 0x65, 0x61, 0x74, 0x65, 0x64, 0x42, 0x79, 0x3e,
+  0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x43, 0x72, 0x65, 0x61, 0x74, 0x65, 0x64, 0x4f, 0x6e,
+  0x3e, 0x32, 0x30, 0x32, 0x30, 0x2d, 0x30, 0x33, 0x2d, 0x32, 0x37, 0x20, 0x31, 0x30, 0x3a, 0x32,
+  0x32, 0x3a, 0x30, 0x30, 0x3c, 0x2f, 0x43, 0x72, 0x65, 0x61, 0x74, 0x65, 0x64, 0x4f, 0x6e, 0x3e,
+  0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x56, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x3e, 0x31,
+  0x3c, 0x2f, 0x56, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20,
+  0x3c, 0x4c, 0x6f, 0x77, 0x65, 0x73, 0x74, 0x53, 0x75, 0x70, 0x70, 0x6f, 0x72, 0x74, 0x65, 0x64,
+  0x56, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x3e, 0x31, 0x3c, 0x2f, 0x4c, 0x6f, 0x77, 0x65, 0x73,
+  0x74, 0x53, 0x75, 0x70, 0x70, 0x6f, 0x72, 0x74, 0x65, 0x64, 0x56, 0x65, 0x72, 0x73, 0x69, 0x6f,
+  0x6e, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x50, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73,
+  0x69, 0x6f, 0x6e, 0x73, 0x20, 0x44, 0x65, 0x66, 0x61, 0x75, 0x6c, 0x74, 0x3d, 0x22, 0x31, 0x32,
+  0x39, 0x22, 0x20, 0x44, 0x65, 0x6c, 0x65, 0x67, 0x61, 0x74, 0x65, 0x64, 0x3d, 0x22, 0x31, 0x39,
+  0x32, 0x22, 0x20, 0x41, 0x70, 0x70, 0x65, 0x6e, 0x64, 0x3d, 0x22, 0x46, 0x61, 0x6c, 0x73, 0x65,
+  0x22, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x21, 0x2d, 0x2d,
+  0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x53,
+  0x61, 0x6d, 0x70, 0x6c, 0x65, 0x20, 0x44, 0x44, 0x53, 0x20, 0x69, 0x6e, 0x69, 0x74, 0x69, 0x61,
+  0x6c, 0x20, 0x65, 0x6e, 0x72, 0x6f, 0x6c, 0x6c, 0x20, 0x70, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73,
+  0x69, 0x6f, 0x6e, 0x73, 0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x50, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x4d, 0x61,
+  0x73, 0x6b, 0x20, 0x2d, 0x20, 0x31, 0x32, 0x38, 0x20, 0x3d, 0x20, 0x4f, 0x77, 0x6e, 0x65, 0x72,
+  0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x36, 0x34, 0x20, 0x3d, 0x20, 0x55, 0x73, 0x65, 0x72, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x33, 0x32, 0x20, 0x3d, 0x20, 0x55, 0x73,
+  0x65, 0x72, 0x31, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x31, 0x36, 0x20, 0x3d, 0x20, 0x55, 0x73, 0x65, 0x72, 0x32, 0x0d, 0x0a, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x38, 0x20,
+  0x3d, 0x20, 0x5a, 0x54, 0x44, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x32, 0x20, 0x3d, 0x20, 0x52, 0x65, 0x67, 0x75, 0x6c, 0x61,
+  0x72, 0x20, 0x45, 0x78, 0x70, 0x72, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x0d, 0x0a, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x31, 0x20, 0x3d,
+  0x20, 0x4c, 0x6f, 0x63, 0x61, 0x6c, 0x20, 0x55, 0x73, 0x65, 0x72, 0x0d, 0x0a, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x4f, 0x77, 0x6e, 0x65, 0x72, 0x20, 0x6b, 0x65,
+  0x65, 0x70, 0x73, 0x20, 0x74, 0x68, 0x65, 0x20, 0x66, 0x6f, 0x6c, 0x6c, 0x6f, 0x77, 0x69, 0x6e,
+  0x67, 0x20, 0x73, 0x65, 0x74, 0x74, 0x69, 0x6e, 0x67, 0x73, 0x20, 0x66, 0x6f, 0x72, 0x20, 0x69,
+  0x74, 0x73, 0x65, 0x6c, 0x66, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x2d, 0x2d, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x50, 0x65,
+  0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x49, 0x64, 0x3e, 0x44, 0x66, 0x63, 0x69, 0x2e,
+  0x4f, 0x77, 0x6e, 0x65, 0x72, 0x4b, 0x65, 0x79, 0x2e, 0x45, 0x6e, 0x75, 0x6d, 0x3c, 0x2f, 0x49,
+  0x64, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x3c, 0x50, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x31, 0x32, 0x38, 0x3c, 0x2f, 0x50, 0x4d, 0x61, 0x73,
+  0x6b, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x3c, 0x44, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x31, 0x32, 0x38, 0x3c, 0x2f, 0x44, 0x4d, 0x61, 0x73,
+  0x6b, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x2f, 0x50, 0x65,
+  0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x3c, 0x50, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x3e, 0x0d,
+  0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x21, 0x2d,
+  0x2d, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x4e, 0x65, 0x65, 0x64, 0x73, 0x20, 0x31, 0x32, 0x38, 0x20,
+  0x28, 0x4f, 0x77, 0x6e, 0x65, 0x72, 0x20, 0x50, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f,
+  0x6e, 0x29, 0x20, 0x74, 0x6f, 0x20, 0x73, 0x65, 0x74, 0x20, 0x74, 0x68, 0x65, 0x20, 0x6b, 0x65,
+  0x79, 0x2c, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x4e, 0x65, 0x65, 0x64, 0x73, 0x20, 0x20, 0x36, 0x34,
+  0x20, 0x28, 0x55, 0x73, 0x65, 0x72, 0x20, 0x50, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f,
+  0x6e, 0x29, 0x20, 0x66, 0x6f, 0x72, 0x20, 0x55, 0x73, 0x65, 0x72, 0x20, 0x74, 0x6f, 0x20, 0x72,
+  0x6f, 0x6c, 0x6c, 0x20, 0x74, 0x68, 0x65, 0x20, 0x6b, 0x65, 0x79, 0x0d, 0x0a, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x2d, 0x2d, 0x3e, 0x0d, 0x0a, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x49, 0x64, 0x3e, 0x44,
+  0x66, 0x63, 0x69, 0x2e, 0x55, 0x73, 0x65, 0x72, 0x4b, 0x65, 0x79, 0x2e, 0x45, 0x6e, 0x75, 0x6d,
+  0x3c, 0x2f, 0x49, 0x64, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x3c, 0x50, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x31, 0x39, 0x32, 0x3c, 0x2f, 0x50,
+  0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x3c, 0x44, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x31, 0x32, 0x38, 0x3c, 0x2f, 0x44,
+  0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c,
+  0x2f, 0x50, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x3e, 0x0d, 0x0a, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x50, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f,
+  0x6e, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x3c, 0x49, 0x64, 0x3e, 0x44, 0x66, 0x63, 0x69, 0x2e, 0x52, 0x65, 0x63, 0x6f, 0x76, 0x65, 0x72,
+  0x79, 0x42, 0x6f, 0x6f, 0x74, 0x73, 0x74, 0x72, 0x61, 0x70, 0x55, 0x72, 0x6c, 0x2e, 0x53, 0x74,
+  0x72, 0x69, 0x6e, 0x67, 0x3c, 0x2f, 0x49, 0x64, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x50, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x31, 0x32,
+  0x38, 0x3c, 0x2f, 0x50, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x44, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x31, 0x32,
+  0x38, 0x3c, 0x2f, 0x44, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x3c, 0x2f, 0x50, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x3e,
+  0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x50, 0x65, 0x72, 0x6d, 0x69,
+  0x73, 0x73, 0x69, 0x6f, 0x6e, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x3c, 0x49, 0x64, 0x3e, 0x44, 0x66, 0x63, 0x69, 0x2e, 0x52, 0x65, 0x63,
+  0x6f, 0x76, 0x65, 0x72, 0x79, 0x55, 0x72, 0x6c, 0x2e, 0x53, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x3c,
+  0x2f, 0x49, 0x64, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x3c, 0x50, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x31, 0x32, 0x38, 0x3c, 0x2f, 0x50, 0x4d,
+  0x61, 0x73, 0x6b, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x3c, 0x44, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x31, 0x32, 0x38, 0x3c, 0x2f, 0x44, 0x4d,
+  0x61, 0x73, 0x6b, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x2f,
+  0x50, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x3c, 0x50, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x3e,
+  0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x49,
+  0x64, 0x3e, 0x44, 0x66, 0x63, 0x69, 0x2e, 0x48, 0x74, 0x74, 0x70, 0x73, 0x43, 0x65, 0x72, 0x74,
+  0x2e, 0x42, 0x69, 0x6e, 0x61, 0x72, 0x79, 0x3c, 0x2f, 0x49, 0x64, 0x3e, 0x0d, 0x0a, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x50, 0x4d, 0x61, 0x73, 0x6b,
+  0x3e, 0x31, 0x32, 0x38, 0x3c, 0x2f, 0x50, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x0d, 0x0a, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x44, 0x4d, 0x61, 0x73, 0x6b,
+  0x3e, 0x31, 0x32, 0x38, 0x3c, 0x2f, 0x44, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x0d, 0x0a, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x2f, 0x50, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73, 0x69,
+  0x6f, 0x6e, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x50, 0x65,
+  0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x49, 0x64, 0x3e, 0x44, 0x66, 0x63, 0x69, 0x2e,
+  0x52, 0x65, 0x67, 0x69, 0x73, 0x74, 0x72, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x49, 0x64, 0x2e, 0x53,
+  0x74, 0x72, 0x69, 0x6e, 0x67, 0x3c, 0x2f, 0x49, 0x64, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x50, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x31,
+  0x32, 0x38, 0x3c, 0x2f, 0x50, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x44, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x31,
+  0x32, 0x38, 0x3c, 0x2f, 0x44, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x3c, 0x2f, 0x50, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f, 0x6e,
+  0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x50, 0x65, 0x72, 0x6d,
+  0x69, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x49, 0x64, 0x3e, 0x44, 0x66, 0x63, 0x69, 0x2e, 0x54, 0x65,
+  0x6e, 0x61, 0x6e, 0x74, 0x49, 0x64, 0x2e, 0x53, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x3c, 0x2f, 0x49,
+  0x64, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x3c, 0x50, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x31, 0x32, 0x38, 0x3c, 0x2f, 0x50, 0x4d, 0x61, 0x73,
+  0x6b, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x3c, 0x44, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x31, 0x32, 0x38, 0x3c, 0x2f, 0x44, 0x4d, 0x61, 0x73,
+  0x6b, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x2f, 0x50, 0x65,
+  0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x3c, 0x50, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x3e, 0x0d,
+  0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x49, 0x64,
+  0x3e, 0x44, 0x66, 0x63, 0x69, 0x33, 0x2e, 0x41, 0x73, 0x73, 0x65, 0x74, 0x54, 0x61, 0x67, 0x2e,
+  0x53, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x3c, 0x2f, 0x49, 0x64, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x50, 0x4d, 0x61, 0x73, 0x6b, 0x3e,
+  0x31, 0x39, 0x32, 0x3c, 0x2f, 0x50, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x44, 0x4d, 0x61, 0x73, 0x6b, 0x3e,
+  0x36, 0x34, 0x3c, 0x2f, 0x44, 0x4d, 0x61, 0x73, 0x6b, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x3c, 0x2f, 0x50, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73, 0x69, 0x6f, 0x6e,
+  0x3e, 0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x20, 0x3c, 0x2f, 0x50, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73,
+  0x69, 0x6f, 0x6e, 0x73, 0x3e, 0x0d, 0x0a, 0x3c, 0x2f, 0x50, 0x65, 0x72, 0x6d, 0x69, 0x73, 0x73,
+  0x69, 0x6f, 0x6e, 0x73, 0x50, 0x61, 0x63, 0x6b, 0x65, 0x74, 0x3e,
+};
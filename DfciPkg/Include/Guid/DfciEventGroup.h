@@ -18,4 +18,14 @@ extern EFI_GUID  gDfciConfigStartEventGroupGuid;
 // gDfciConfigCompleteEventGroupGuid is used to signal that the DFCI configuration update finished
 extern EFI_GUID  gDfciConfigCompleteEventGroupGuid;
 
+// gDfciSettingsApplyStartEventGroupGuid is signaled before the Settings Manager sets a batch of settings
+extern EFI_GUID  gDfciSettingsApplyStartEventGroupGuid;
+
+// gDfciSettingsApplyCompleteEventGroupGuid is signaled after the last setting of the batch has been set
+extern EFI_GUID  gDfciSettingsApplyCompleteEventGroupGuid;
+
+// gDfciSettingsApplyFailedEventGroupGuid is signaled by a provider, from its apply complete notify, when it
+// fails to store the settings it held back during the batch.  The Settings Manager then fails the batch.
+extern EFI_GUID  gDfciSettingsApplyFailedEventGroupGuid;
+
 #endif
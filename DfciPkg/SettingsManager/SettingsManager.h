@@ -18,6 +18,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <Guid/DfciInternalVariableGuid.h>
 #include <Guid/DfciDeviceIdVariables.h>
+#include <Guid/DfciEventGroup.h>
 #include <Guid/DfciPacketHeader.h>
 #include <Guid/DfciSettingsManagerVariables.h>
 #include <Guid/WinCertificate.h>
@@ -111,6 +112,36 @@ ResetAllProvidersToDefaultsWithMatchingFlags (
   DFCI_SETTING_FLAGS  FilterFlag
   );
 
+/**
+Notify function for the apply failed event group.  Records that a provider
+failed to store the settings it held back during the current batch.
+**/
+VOID
+EFIAPI
+SettingsApplyFailedNotify (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  );
+
+/**
+Signals the start of a batch of settings.
+**/
+VOID
+SettingsApplyStart (
+  VOID
+  );
+
+/**
+Signals the end of a batch of settings, so providers store what they held back.
+
+@retval EFI_SUCCESS       All providers stored their settings.
+@retval EFI_DEVICE_ERROR  A provider failed to store the settings of the batch.
+**/
+EFI_STATUS
+SettingsApplyComplete (
+  VOID
+  );
+
 VOID
 DebugPrintProviderList (
   );
@@ -417,6 +417,22 @@ Init (
     DEBUG ((DEBUG_ERROR, "%a - Create Event Ex for Ready to Boot failed\n", __FUNCTION__));
   }
 
+  //
+  // Register notify function to learn when a provider fails to store a batch of settings.
+  //
+  Status = gBS->CreateEventEx (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  SettingsApplyFailedNotify,
+                  NULL,
+                  &gDfciSettingsApplyFailedEventGroupGuid,
+                  &InitEvent
+                  );
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a - Create Event Ex for Settings Apply Failed. %r\n", __FUNCTION__, Status));
+  }
+
 EXIT:
   return Status;
 }
@@ -13,6 +13,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 LIST_ENTRY  mProviderList = INITIALIZE_LIST_HEAD_VARIABLE (mProviderList); // linked list for the providers
 
 static DFCI_AUTHENTICATION_PROTOCOL  *mAuthenticationProtocol = NULL;
+static BOOLEAN                       mSettingsApplyFailed    = FALSE;
 
 #define CERT_STRING_SIZE    (200)
 #define CERT_NOT_AVAILABLE  "No Cert information available"
@@ -849,6 +850,58 @@ RegisterProvider (
   return EFI_SUCCESS;
 }
 
+/**
+Notify function for the apply failed event group.  Records that a provider
+failed to store the settings it held back during the current batch.
+
+@param Event   - Event whose notification function is being invoked
+@param Context - NULL
+**/
+VOID
+EFIAPI
+SettingsApplyFailedNotify (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  mSettingsApplyFailed = TRUE;
+}
+
+/**
+Signals the start of a batch of settings.
+**/
+VOID
+SettingsApplyStart (
+  VOID
+  )
+{
+  mSettingsApplyFailed = FALSE;
+  EfiEventGroupSignal (&gDfciSettingsApplyStartEventGroupGuid);
+}
+
+/**
+Signals the end of a batch of settings, so providers store what they held back.
+
+The notify functions run at TPL_CALLBACK before EfiEventGroupSignal returns, and
+so does SettingsApplyFailedNotify if one of them signals the apply failed group.
+
+@retval EFI_SUCCESS       All providers stored their settings.
+@retval EFI_DEVICE_ERROR  A provider failed to store the settings of the batch.
+**/
+EFI_STATUS
+SettingsApplyComplete (
+  VOID
+  )
+{
+  EfiEventGroupSignal (&gDfciSettingsApplyCompleteEventGroupGuid);
+  if (mSettingsApplyFailed) {
+    DEBUG ((DEBUG_ERROR, "%a - A provider failed to store the settings of the batch.\n", __FUNCTION__));
+    return EFI_DEVICE_ERROR;
+  }
+
+  return EFI_SUCCESS;
+}
+
 /**
 Function sets the providers to default for
 any provider that contains the FilterFlag in its flags
@@ -863,6 +916,7 @@ ResetAllProvidersToDefaultsWithMatchingFlags (
   LIST_ENTRY                        *Link  = NULL;
   DFCI_SETTING_PROVIDER_LIST_ENTRY  *Prov  = NULL;
 
+  SettingsApplyStart ();
   EFI_LIST_FOR_EACH (Link, &mProviderList) {
     // Convert Link Node into object stored
     Prov = PROV_LIST_ENTRY_FROM_LINK (Link);
@@ -874,5 +928,5 @@ ResetAllProvidersToDefaultsWithMatchingFlags (
       }
     }
   }
-  return EFI_SUCCESS;
+  return SettingsApplyComplete ();
 }
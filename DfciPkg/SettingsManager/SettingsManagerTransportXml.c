@@ -69,8 +69,9 @@ ApplySettings (
   UINTN               StrLen = 0;
   DFCI_SETTING_FLAGS  Flags  = 0;
   EFI_TIME            ApplyTime;
-  UINTN               Version = 0;
-  UINTN               Lsv     = 0;
+  UINTN               Version      = 0;
+  UINTN               Lsv          = 0;
+  BOOLEAN             ApplyStarted = FALSE;
 
   if (Data == NULL) {
     DEBUG ((DEBUG_ERROR, "%a - NULL pointer received.\n", __FUNCTION__));
@@ -231,6 +232,10 @@ ApplySettings (
   }
 
   // All verified.   Now lets walk thru the Settings and try to apply each one.
+  // Providers may hold back their writes until the apply complete event.
+  SettingsApplyStart ();
+  ApplyStarted = TRUE;
+
   for (Link = InputSettingsNode->ChildrenListHead.ForwardLink; Link != &(InputSettingsNode->ChildrenListHead); Link = Link->ForwardLink) {
     XmlNode                 *NodeThis = NULL;
     DFCI_SETTING_ID_STRING  Id        = NULL;
@@ -277,6 +282,14 @@ ApplySettings (
     // all done.
   } // end for loop
 
+  ApplyStarted = FALSE;
+  Status       = SettingsApplyComplete ();
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to store the applied settings.  %r\n", Status));
+    Data->State = DFCI_PACKET_STATE_DATA_SYSTEM_ERROR;
+    goto EXIT;
+  }
+
   Data->State = DFCI_PACKET_STATE_DATA_APPLIED;
 
   // PRINT OUT XML HERE
@@ -308,6 +321,10 @@ ApplySettings (
   Status = EFI_SUCCESS;
 
 EXIT:
+  if (ApplyStarted) {
+    SettingsApplyComplete ();
+  }
+
   if (InputRootNode) {
     FreeXmlTree (&InputRootNode);
   }
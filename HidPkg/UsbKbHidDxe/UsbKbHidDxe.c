@@ -123,9 +123,9 @@ UsbKbHidDriverBindingSupported (
 /**
   Starts the keyboard device with this driver.
 
-  This function produces Simple Text Input Protocol and Simple Text Input Ex Protocol,
-  initializes the keyboard device, and submit Asynchronous Interrupt Transfer to manage
-  this keyboard device.
+  This function initializes the keyboard device and produces HID Keyboard Protocol.
+  The Asynchronous Interrupt Transfer that manages this keyboard device is submitted
+  once a report callback is registered, see SetKeyboardPolling().
 
   @param  This                   The USB keyboard driver binding instance.
   @param  Controller             Handle of device to bind driver to.
@@ -151,13 +151,11 @@ UsbKbHidDriverBindingStart (
   UINT8                        EndpointNumber;
   EFI_USB_ENDPOINT_DESCRIPTOR  EndpointDescriptor;
   UINT8                        Index;
-  UINT8                        EndpointAddr;
-  UINT8                        PollingInterval;
-  UINT8                        PacketSize;
   BOOLEAN                      Found;
   EFI_TPL                      OldTpl;
 
-  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  OldTpl            = gBS->RaiseTPL (TPL_CALLBACK);
+  UsbKeyboardDevice = NULL;
   //
   // Open USB I/O Protocol
   //
@@ -292,34 +290,6 @@ UsbKbHidDriverBindingStart (
     goto ErrorExit;
   }
 
-  //
-  // Submit Asynchronous Interrupt Transfer to manage this device.
-  //
-  EndpointAddr    = UsbKeyboardDevice->IntEndpointDescriptor.EndpointAddress;
-  PollingInterval = UsbKeyboardDevice->IntEndpointDescriptor.Interval;
-  PacketSize      = (UINT8)(UsbKeyboardDevice->IntEndpointDescriptor.MaxPacketSize);
-
-  Status = UsbIo->UsbAsyncInterruptTransfer (
-                    UsbIo,
-                    EndpointAddr,
-                    TRUE,
-                    PollingInterval,
-                    PacketSize,
-                    KeyboardHandler,
-                    UsbKeyboardDevice
-                    );
-  if (EFI_ERROR (Status)) {
-    //
-    // Report Status Code to indicate keyboard init failure
-    //
-    REPORT_STATUS_CODE (
-      EFI_ERROR_CODE | EFI_ERROR_MINOR,
-      (EFI_PERIPHERAL_KEYBOARD | EFI_P_EC_CONTROLLER_ERROR)
-      );
-    DEBUG ((DEBUG_ERROR, "[%a] - failed to initialize keyboard interrupt handler: %r.\n", __FUNCTION__, Status));
-    goto ErrorExit;
-  }
-
   //
   // Install HID USB keyboard device.
   //
@@ -357,6 +327,14 @@ UsbKbHidDriverBindingStart (
   //
 ErrorExit:
   if (UsbKeyboardDevice != NULL) {
+    if (UsbKeyboardDevice->DelayedRecoveryEvent != NULL) {
+      gBS->CloseEvent (UsbKeyboardDevice->DelayedRecoveryEvent);
+    }
+
+    if (UsbKeyboardDevice->PollingTimerEvent != NULL) {
+      gBS->CloseEvent (UsbKeyboardDevice->PollingTimerEvent);
+    }
+
     FreePool (UsbKeyboardDevice);
     UsbKeyboardDevice = NULL;
   }
@@ -426,8 +404,14 @@ UsbKbHidDriverBindingStop (
     );
 
   //
-  // Delete the Asynchronous Interrupt Transfer from this device
+  // Stop switching the polling rate, then delete the Asynchronous Interrupt Transfer from this device
   //
+  if (UsbKeyboardDevice->PollingTimerEvent != NULL) {
+    gBS->CloseEvent (UsbKeyboardDevice->PollingTimerEvent);
+    UsbKeyboardDevice->PollingTimerEvent = NULL;
+  }
+
+  UsbKeyboardDevice->PollingState = UsbKbPollingStopped;
   UsbKeyboardDevice->UsbIo->UsbAsyncInterruptTransfer (
                               UsbKeyboardDevice->UsbIo,
                               UsbKeyboardDevice->IntEndpointDescriptor.EndpointAddress,
@@ -496,6 +480,8 @@ RegisterKeyboardHidReportCallback (
   )
 {
   USB_KB_HID_DEV  *HidKeyboard;
+  EFI_STATUS      Status;
+  EFI_TPL         OldTpl;
 
   if ((This == NULL) || (KeyboardReportCallback == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -507,10 +493,29 @@ RegisterKeyboardHidReportCallback (
     return EFI_ALREADY_STARTED;
   }
 
+  //
+  // Reports are only polled for while there is someone to deliver them to, so start
+  // polling at full rate now.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
   HidKeyboard->KeyReportCallback        = KeyboardReportCallback;
   HidKeyboard->KeyReportCallbackContext = Context;
 
-  return EFI_SUCCESS;
+  Status = SetKeyboardPolling (HidKeyboard, UsbKbPollingActive);
+  if (EFI_ERROR (Status)) {
+    REPORT_STATUS_CODE (
+      EFI_ERROR_CODE | EFI_ERROR_MINOR,
+      (EFI_PERIPHERAL_KEYBOARD | EFI_P_EC_CONTROLLER_ERROR)
+      );
+    DEBUG ((DEBUG_ERROR, "[%a] - failed to initialize keyboard interrupt handler: %r.\n", __FUNCTION__, Status));
+    HidKeyboard->KeyReportCallback        = NULL;
+    HidKeyboard->KeyReportCallbackContext = NULL;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  return Status;
 }
 
 /**
@@ -530,6 +535,7 @@ UnRegisterKeyboardHidReportCallback (
   )
 {
   USB_KB_HID_DEV  *HidKeyboard;
+  EFI_TPL         OldTpl;
 
   if (This == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -541,9 +547,17 @@ UnRegisterKeyboardHidReportCallback (
     return EFI_NOT_FOUND;
   }
 
+  //
+  // With no one to deliver reports to, stop polling the keyboard.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  SetKeyboardPolling (HidKeyboard, UsbKbPollingStopped);
   HidKeyboard->KeyReportCallback        = NULL;
   HidKeyboard->KeyReportCallbackContext = NULL;
 
+  gBS->RestoreTPL (OldTpl);
+
   return EFI_SUCCESS;
 }
 
@@ -720,6 +734,18 @@ InitUsbKeyboard (
       );
   }
 
+  //
+  // Set an indefinite idle rate for all input reports, so the keyboard only reports when
+  // a key changes. Key repeat is timed by the HID layer. Keyboards that do not support
+  // SET_IDLE keep reporting at every poll, which is harmless.
+  //
+  UsbSetIdleRequest (
+    UsbKeyboardDevice->UsbIo,
+    UsbKeyboardDevice->InterfaceDescriptor.InterfaceNumber,
+    0,
+    0
+    );
+
   //
   // Create event for delayed recovery, which deals with device error.
   //
@@ -736,6 +762,23 @@ InitUsbKeyboard (
          &UsbKeyboardDevice->DelayedRecoveryEvent
          );
 
+  //
+  // Create event for slowing down polling while input is idle. Without it the keyboard
+  // is simply polled at full rate.
+  //
+  if (UsbKeyboardDevice->PollingTimerEvent != NULL) {
+    gBS->CloseEvent (UsbKeyboardDevice->PollingTimerEvent);
+    UsbKeyboardDevice->PollingTimerEvent = NULL;
+  }
+
+  gBS->CreateEvent (
+         EVT_TIMER | EVT_NOTIFY_SIGNAL,
+         TPL_NOTIFY,
+         UsbKbHidPollingHandler,
+         UsbKeyboardDevice,
+         &UsbKeyboardDevice->PollingTimerEvent
+         );
+
   return EFI_SUCCESS;
 }
 
@@ -841,6 +884,16 @@ KeyboardHandler (
     return EFI_SUCCESS;
   }
 
+  //
+  // Note the input so polling stays at full rate. If polling had slowed down, return to
+  // full rate on the next timer tick rather than resubmitting the transfer from its own
+  // completion.
+  //
+  UsbKeyboardDevice->ReportSeen = TRUE;
+  if ((UsbKeyboardDevice->PollingState == UsbKbPollingIdle) && (UsbKeyboardDevice->PollingTimerEvent != NULL)) {
+    gBS->SetTimer (UsbKeyboardDevice->PollingTimerEvent, TimerRelative, 0);
+  }
+
   //
   // Send the data up to the HID layer via means of the KeyReportCallback.
   //
@@ -856,6 +909,29 @@ KeyboardHandler (
   return EFI_SUCCESS;
 }
 
+/**
+  Gets the interval to poll the keyboard at in a polling state.
+
+  @param  UsbKeyboardDevice  The USB_KB_HID_DEV instance.
+  @param  PollingState       The polling state.
+
+  @return The polling interval in milliseconds.
+
+**/
+STATIC
+UINT8
+GetKeyboardPollingInterval (
+  IN USB_KB_HID_DEV        *UsbKeyboardDevice,
+  IN USB_KB_POLLING_STATE  PollingState
+  )
+{
+  if (PollingState == UsbKbPollingIdle) {
+    return MAX (UsbKeyboardDevice->IntEndpointDescriptor.Interval, PcdGet8 (PcdUsbHidIdlePollingInterval));
+  }
+
+  return UsbKeyboardDevice->IntEndpointDescriptor.Interval;
+}
+
 /**
   Handler for Delayed Recovery event.
 
@@ -884,6 +960,13 @@ UsbKbHidRecoveryHandler (
 
   ASSERT (Context != NULL);
 
+  //
+  // Polling was stopped while waiting to recover, so there is nothing to re-submit.
+  //
+  if (UsbKeyboardDevice->PollingState == UsbKbPollingStopped) {
+    return;
+  }
+
   UsbIo = UsbKeyboardDevice->UsbIo;
 
   PacketSize = (UINT8)(UsbKeyboardDevice->IntEndpointDescriptor.MaxPacketSize);
@@ -895,9 +978,144 @@ UsbKbHidRecoveryHandler (
            UsbIo,
            UsbKeyboardDevice->IntEndpointDescriptor.EndpointAddress,
            TRUE,
-           UsbKeyboardDevice->IntEndpointDescriptor.Interval,
+           GetKeyboardPollingInterval (UsbKeyboardDevice, UsbKeyboardDevice->PollingState),
            PacketSize,
            KeyboardHandler,
            UsbKeyboardDevice
            );
 }
+
+/**
+  Moves the keyboard to a new polling state.
+
+  The Asynchronous Interrupt Transfer is removed and, unless polling is being stopped,
+  submitted again at the interval of the new state.
+
+  @param  UsbKeyboardDevice  The USB_KB_HID_DEV instance.
+  @param  PollingState       The polling state to move to.
+
+  @retval EFI_SUCCESS        The keyboard is polled as requested.
+  @retval Other              The transfer could not be submitted, polling is stopped.
+
+**/
+EFI_STATUS
+SetKeyboardPolling (
+  IN OUT USB_KB_HID_DEV        *UsbKeyboardDevice,
+  IN     USB_KB_POLLING_STATE  PollingState
+  )
+{
+  EFI_USB_IO_PROTOCOL  *UsbIo;
+  EFI_STATUS           Status;
+
+  UsbIo = UsbKeyboardDevice->UsbIo;
+
+  //
+  // Remove the transfer at the old rate. A pending recovery would submit it again, so
+  // cancel that as well.
+  //
+  if (UsbKeyboardDevice->PollingState != UsbKbPollingStopped) {
+    UsbIo->UsbAsyncInterruptTransfer (
+             UsbIo,
+             UsbKeyboardDevice->IntEndpointDescriptor.EndpointAddress,
+             FALSE,
+             0,
+             0,
+             NULL,
+             NULL
+             );
+  }
+
+  if (UsbKeyboardDevice->DelayedRecoveryEvent != NULL) {
+    gBS->SetTimer (UsbKeyboardDevice->DelayedRecoveryEvent, TimerCancel, 0);
+  }
+
+  if (UsbKeyboardDevice->PollingTimerEvent != NULL) {
+    gBS->SetTimer (UsbKeyboardDevice->PollingTimerEvent, TimerCancel, 0);
+  }
+
+  UsbKeyboardDevice->PollingState = UsbKbPollingStopped;
+  UsbKeyboardDevice->ReportSeen   = FALSE;
+
+  if (PollingState == UsbKbPollingStopped) {
+    return EFI_SUCCESS;
+  }
+
+  Status = UsbIo->UsbAsyncInterruptTransfer (
+                    UsbIo,
+                    UsbKeyboardDevice->IntEndpointDescriptor.EndpointAddress,
+                    TRUE,
+                    GetKeyboardPollingInterval (UsbKeyboardDevice, PollingState),
+                    (UINT8)(UsbKeyboardDevice->IntEndpointDescriptor.MaxPacketSize),
+                    KeyboardHandler,
+                    UsbKeyboardDevice
+                    );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  UsbKeyboardDevice->PollingState = PollingState;
+
+  //
+  // Watch for input going idle, unless idle polling would be no slower than full rate.
+  //
+  if ((PollingState == UsbKbPollingActive) &&
+      (UsbKeyboardDevice->PollingTimerEvent != NULL) &&
+      (GetKeyboardPollingInterval (UsbKeyboardDevice, UsbKbPollingIdle) > UsbKeyboardDevice->IntEndpointDescriptor.Interval))
+  {
+    gBS->SetTimer (
+           UsbKeyboardDevice->PollingTimerEvent,
+           TimerRelative,
+           EFI_TIMER_PERIOD_MILLISECONDS (PcdGet32 (PcdUsbHidIdleTimeout))
+           );
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Handler for the polling timer event.
+
+  While polling at full rate the timer fires every PcdUsbHidIdleTimeout, and polling
+  slows down if no report arrived since it last fired. While idle it fires only when a
+  report arrives, and polling returns to full rate.
+
+  @param  Event              The polling timer event.
+  @param  Context            Points to the USB_KB_HID_DEV instance.
+
+**/
+VOID
+EFIAPI
+UsbKbHidPollingHandler (
+  IN    EFI_EVENT  Event,
+  IN    VOID       *Context
+  )
+{
+  USB_KB_HID_DEV  *UsbKeyboardDevice;
+
+  ASSERT (Context != NULL);
+
+  UsbKeyboardDevice = (USB_KB_HID_DEV *)Context;
+
+  switch (UsbKeyboardDevice->PollingState) {
+    case UsbKbPollingIdle:
+      SetKeyboardPolling (UsbKeyboardDevice, UsbKbPollingActive);
+      break;
+
+    case UsbKbPollingActive:
+      if (UsbKeyboardDevice->ReportSeen) {
+        UsbKeyboardDevice->ReportSeen = FALSE;
+        gBS->SetTimer (
+               UsbKeyboardDevice->PollingTimerEvent,
+               TimerRelative,
+               EFI_TIMER_PERIOD_MILLISECONDS (PcdGet32 (PcdUsbHidIdleTimeout))
+               );
+      } else {
+        SetKeyboardPolling (UsbKeyboardDevice, UsbKbPollingIdle);
+      }
+
+      break;
+
+    default:
+      break;
+  }
+}
@@ -41,6 +41,15 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #define USB_HID_KB_DEV_SIGNATURE  SIGNATURE_32 ('u', 'k', 'h', 'd')
 
+///
+/// How the interrupt endpoint of the keyboard is being polled
+///
+typedef enum {
+  UsbKbPollingStopped,          ///< No report callback is registered, so no transfer is submitted
+  UsbKbPollingActive,           ///< Polling at the endpoint's own interval
+  UsbKbPollingIdle              ///< No input for PcdUsbHidIdleTimeout, polling at PcdUsbHidIdlePollingInterval
+} USB_KB_POLLING_STATE;
+
 ///
 /// Structure to describe USB keyboard device
 ///
@@ -50,6 +59,9 @@ typedef struct {
   EFI_DEVICE_PATH_PROTOCOL        *DevicePath;
   EFI_UNICODE_STRING_TABLE        *ControllerNameTable;
   EFI_EVENT                       DelayedRecoveryEvent;
+  EFI_EVENT                       PollingTimerEvent;
+  USB_KB_POLLING_STATE            PollingState;
+  BOOLEAN                         ReportSeen;
   EFI_USB_IO_PROTOCOL             *UsbIo;
   EFI_USB_INTERFACE_DESCRIPTOR    InterfaceDescriptor;
   EFI_USB_ENDPOINT_DESCRIPTOR     IntEndpointDescriptor;
@@ -94,9 +106,9 @@ UsbKbHidDriverBindingSupported (
 /**
   Starts the HID keyboard device with this driver.
 
-  This function produces Simple Text Input Protocol and Simple Text Input Ex Protocol,
-  initializes the keyboard device, and submit Asynchronous Interrupt Transfer to manage
-  this keyboard device.
+  This function initializes the keyboard device and produces HID Keyboard Protocol.
+  The Asynchronous Interrupt Transfer that manages this keyboard device is submitted
+  once a report callback is registered.
 
   @param  This                   The USB keyboard driver binding instance.
   @param  Controller             Handle of device to bind driver to.
@@ -393,4 +405,41 @@ UsbKbHidRecoveryHandler (
   IN    VOID       *Context
   );
 
+/**
+  Moves the keyboard to a new polling state.
+
+  The Asynchronous Interrupt Transfer is removed and, unless polling is being stopped,
+  submitted again at the interval of the new state.
+
+  @param  UsbKeyboardDevice  The USB_KB_HID_DEV instance.
+  @param  PollingState       The polling state to move to.
+
+  @retval EFI_SUCCESS        The keyboard is polled as requested.
+  @retval Other              The transfer could not be submitted, polling is stopped.
+
+**/
+EFI_STATUS
+SetKeyboardPolling (
+  IN OUT USB_KB_HID_DEV        *UsbKeyboardDevice,
+  IN     USB_KB_POLLING_STATE  PollingState
+  );
+
+/**
+  Handler for the polling timer event.
+
+  While polling at full rate the timer fires every PcdUsbHidIdleTimeout, and polling
+  slows down if no report arrived since it last fired. While idle it fires only when a
+  report arrives, and polling returns to full rate.
+
+  @param  Event              The polling timer event.
+  @param  Context            Points to the USB_KB_HID_DEV instance.
+
+**/
+VOID
+EFIAPI
+UsbKbHidPollingHandler (
+  IN    EFI_EVENT  Event,
+  IN    VOID       *Context
+  );
+
 #endif
@@ -0,0 +1,841 @@
+/** @file
+  This module tests how UsbMouseHidDxe polls the mouse's interrupt endpoint: SET_IDLE on
+  init, no polling without a report callback, full rate polling while input arrives and
+  idle rate polling once it stops.
+
+  The USB I/O protocol, boot services timers and the UefiUsbLib requests are mocked, and
+  time is simulated one millisecond at a time.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+#include <Library/UnitTestLib.h>
+#include "../UsbMouseHid.h"
+
+#define UNIT_TEST_NAME     "USB HID Mouse Polling Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define MOCK_ENDPOINT_ADDRESS           0x81
+#define MOCK_ENDPOINT_INTERVAL          8
+#define MOCK_MAX_EVENTS                 4
+#define MOCK_100NS_PER_MS               10000
+#define MOCK_BOOT_MOUSE_REPORT_SIZE     4
+
+///
+/// A timer event created by the driver
+///
+typedef struct {
+  BOOLEAN             Used;
+  EFI_EVENT_NOTIFY    NotifyFunction;
+  VOID                *NotifyContext;
+  BOOLEAN             Armed;
+  UINT64              DueMs;
+} MOCK_TIMER_EVENT;
+
+///
+/// The mocked mouse behind the USB I/O protocol
+///
+typedef struct {
+  EFI_USB_IO_PROTOCOL                UsbIo;
+  BOOLEAN                            TransferActive;
+  UINTN                              PollingInterval;
+  EFI_ASYNC_USB_TRANSFER_CALLBACK    Callback;
+  VOID                               *CallbackContext;
+  UINT64                             LastPollMs;
+  EFI_STATUS                         SubmitStatus;
+  UINTN                              Submits;
+  UINTN                              DoubleSubmits;
+  UINTN                              Polls;
+  UINTN                              SetIdleRequests;
+  UINT8                              SetIdleDuration;
+  BOOLEAN                            ReportPending;
+  UINT64                             ReportQueuedMs;
+  UINT32                             PendingError;
+} MOCK_USB_MOUSE;
+
+///
+/// What the registered report callback has seen
+///
+typedef struct {
+  UINTN     Reports;
+  UINTN     LastReportSize;
+  UINT64    LastLatencyMs;
+  UINT64    MaxLatencyMs;
+} MOCK_REPORT_LOG;
+
+STATIC UINT64             mNowMs;
+STATIC MOCK_TIMER_EVENT   mEvents[MOCK_MAX_EVENTS];
+STATIC MOCK_USB_MOUSE     mMouse;
+STATIC MOCK_REPORT_LOG    mReportLog;
+STATIC EFI_BOOT_SERVICES  mMockBootServices;
+STATIC USB_MOUSE_HID_DEV  *mDevice;
+
+//
+// Boot services mocks.
+//
+
+/**
+  Stands in for gBS->RaiseTPL. Event notifications are only dispatched by RunFor(),
+  so there is nothing to mask.
+**/
+STATIC
+EFI_TPL
+EFIAPI
+MockRaiseTpl (
+  IN EFI_TPL  NewTpl
+  )
+{
+  return TPL_APPLICATION;
+}
+
+/**
+  Stands in for gBS->RestoreTPL.
+**/
+STATIC
+VOID
+EFIAPI
+MockRestoreTpl (
+  IN EFI_TPL  OldTpl
+  )
+{
+}
+
+/**
+  Stands in for gBS->CreateEvent, supporting notify-signal timer events only.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockCreateEvent (
+  IN  UINT32            Type,
+  IN  EFI_TPL           NotifyTpl,
+  IN  EFI_EVENT_NOTIFY  NotifyFunction OPTIONAL,
+  IN  VOID              *NotifyContext OPTIONAL,
+  OUT EFI_EVENT         *Event
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < MOCK_MAX_EVENTS; Index++) {
+    if (!mEvents[Index].Used) {
+      ZeroMem (&mEvents[Index], sizeof (mEvents[Index]));
+      mEvents[Index].Used           = TRUE;
+      mEvents[Index].NotifyFunction = NotifyFunction;
+      mEvents[Index].NotifyContext  = NotifyContext;
+      *Event                        = (EFI_EVENT)&mEvents[Index];
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_OUT_OF_RESOURCES;
+}
+
+/**
+  Stands in for gBS->CloseEvent.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockCloseEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  ZeroMem (Event, sizeof (MOCK_TIMER_EVENT));
+  return EFI_SUCCESS;
+}
+
+/**
+  Stands in for gBS->SetTimer, supporting cancel and relative timers in simulated time.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockSetTimer (
+  IN EFI_EVENT        Event,
+  IN EFI_TIMER_DELAY  Type,
+  IN UINT64           TriggerTime
+  )
+{
+  MOCK_TIMER_EVENT  *Timer;
+
+  Timer = (MOCK_TIMER_EVENT *)Event;
+  if ((Timer == NULL) || !Timer->Used) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Timer->Armed = (BOOLEAN)(Type == TimerRelative);
+  Timer->DueMs = mNowMs + (TriggerTime + MOCK_100NS_PER_MS - 1) / MOCK_100NS_PER_MS;
+
+  return EFI_SUCCESS;
+}
+
+//
+// USB I/O protocol and UefiUsbLib mocks.
+//
+
+/**
+  Stands in for UsbIo->UsbAsyncInterruptTransfer. Records the transfer and the rate it
+  is polled at; RunFor() does the polling.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockUsbAsyncInterruptTransfer (
+  IN EFI_USB_IO_PROTOCOL              *This,
+  IN UINT8                            DeviceEndpoint,
+  IN BOOLEAN                          IsNewTransfer,
+  IN UINTN                            PollingInterval OPTIONAL,
+  IN UINTN                            DataLength OPTIONAL,
+  IN EFI_ASYNC_USB_TRANSFER_CALLBACK  InterruptCallBack OPTIONAL,
+  IN VOID                             *Context OPTIONAL
+  )
+{
+  if (DeviceEndpoint != MOCK_ENDPOINT_ADDRESS) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (!IsNewTransfer) {
+    mMouse.TransferActive = FALSE;
+    return EFI_SUCCESS;
+  }
+
+  if (EFI_ERROR (mMouse.SubmitStatus)) {
+    return mMouse.SubmitStatus;
+  }
+
+  if (mMouse.TransferActive) {
+    mMouse.DoubleSubmits++;
+  }
+
+  mMouse.TransferActive  = TRUE;
+  mMouse.PollingInterval = PollingInterval;
+  mMouse.Callback        = InterruptCallBack;
+  mMouse.CallbackContext = Context;
+  mMouse.LastPollMs      = mNowMs;
+  mMouse.Submits++;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Stands in for UefiUsbLib UsbGetProtocolRequest. The mouse is in boot protocol.
+**/
+EFI_STATUS
+EFIAPI
+UsbGetProtocolRequest (
+  IN EFI_USB_IO_PROTOCOL  *UsbIo,
+  IN UINT8                Interface,
+  OUT UINT8               *Protocol
+  )
+{
+  *Protocol = BOOT_PROTOCOL;
+  return EFI_SUCCESS;
+}
+
+/**
+  Stands in for UefiUsbLib UsbSetProtocolRequest.
+**/
+EFI_STATUS
+EFIAPI
+UsbSetProtocolRequest (
+  IN EFI_USB_IO_PROTOCOL  *UsbIo,
+  IN UINT8                Interface,
+  IN UINT8                Protocol
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Stands in for UefiUsbLib UsbSetIdleRequest, recording the requested idle rate.
+**/
+EFI_STATUS
+EFIAPI
+UsbSetIdleRequest (
+  IN EFI_USB_IO_PROTOCOL  *UsbIo,
+  IN UINT8                Interface,
+  IN UINT8                ReportId,
+  IN UINT8                Duration
+  )
+{
+  mMouse.SetIdleRequests++;
+  mMouse.SetIdleDuration = Duration;
+  return EFI_SUCCESS;
+}
+
+/**
+  Stands in for UefiUsbLib UsbClearEndpointHalt.
+**/
+EFI_STATUS
+EFIAPI
+UsbClearEndpointHalt (
+  IN  EFI_USB_IO_PROTOCOL  *UsbIo,
+  IN  UINT8                Endpoint,
+  OUT UINT32               *Status
+  )
+{
+  *Status = EFI_USB_NOERROR;
+  return EFI_SUCCESS;
+}
+
+//
+// Simulation helpers.
+//
+
+/**
+  Report callback registered with the HID pointer protocol. Logs delivery latency.
+**/
+STATIC
+VOID
+EFIAPI
+MockPointerReportCallback (
+  IN HID_POINTER_INTERFACE  Interface,
+  IN UINT8                   *HidInputReportBuffer,
+  IN UINTN                   HidInputReportBufferSize,
+  IN VOID                    *Context
+  )
+{
+  mReportLog.Reports++;
+  mReportLog.LastReportSize = HidInputReportBufferSize;
+  mReportLog.LastLatencyMs  = mNowMs - mMouse.ReportQueuedMs;
+  mReportLog.MaxLatencyMs   = MAX (mReportLog.MaxLatencyMs, mReportLog.LastLatencyMs);
+}
+
+/**
+  Queues a report on the mouse, delivered at the next poll.
+**/
+STATIC
+VOID
+QueueMouseReport (
+  VOID
+  )
+{
+  mMouse.ReportPending  = TRUE;
+  mMouse.ReportQueuedMs = mNowMs;
+}
+
+/**
+  Advances simulated time, polling the interrupt endpoint at its interval and firing
+  timers as they fall due.
+
+  @param  Milliseconds  How long to run for.
+**/
+STATIC
+VOID
+RunFor (
+  IN UINTN  Milliseconds
+  )
+{
+  UINT8   Report[MOCK_BOOT_MOUSE_REPORT_SIZE];
+  UINT32  Error;
+  UINTN   Index;
+
+  while (Milliseconds-- > 0) {
+    mNowMs++;
+
+    if (mMouse.TransferActive && (mNowMs - mMouse.LastPollMs >= mMouse.PollingInterval)) {
+      mMouse.LastPollMs = mNowMs;
+      mMouse.Polls++;
+      if (mMouse.PendingError != EFI_USB_NOERROR) {
+        Error                  = mMouse.PendingError;
+        mMouse.PendingError = EFI_USB_NOERROR;
+        mMouse.Callback (NULL, 0, mMouse.CallbackContext, Error);
+      } else if (mMouse.ReportPending) {
+        //
+        // With SET_IDLE(0) the mouse NAKs every poll until it moves or a button changes.
+        //
+        mMouse.ReportPending = FALSE;
+        ZeroMem (Report, sizeof (Report));
+        Report[1] = 0x10;
+        mMouse.Callback (Report, sizeof (Report), mMouse.CallbackContext, EFI_USB_NOERROR);
+      }
+    }
+
+    for (Index = 0; Index < MOCK_MAX_EVENTS; Index++) {
+      if (mEvents[Index].Used && mEvents[Index].Armed && (mEvents[Index].DueMs <= mNowMs)) {
+        mEvents[Index].Armed = FALSE;
+        mEvents[Index].NotifyFunction ((EFI_EVENT)&mEvents[Index], mEvents[Index].NotifyContext);
+      }
+    }
+  }
+}
+
+/**
+  Counts the timer events that are armed.
+**/
+STATIC
+UINTN
+ArmedTimers (
+  VOID
+  )
+{
+  UINTN  Index;
+  UINTN  Count;
+
+  Count = 0;
+  for (Index = 0; Index < MOCK_MAX_EVENTS; Index++) {
+    if (mEvents[Index].Used && mEvents[Index].Armed) {
+      Count++;
+    }
+  }
+
+  return Count;
+}
+
+/**
+  Creates and initializes a mouse device on the mocked USB I/O protocol.
+
+  @param Context  Unused.
+
+  @retval UNIT_TEST_PASSED                      The device is ready.
+  @retval UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  The device could not be initialized.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+MouseSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mNowMs = 0;
+  ZeroMem (mEvents, sizeof (mEvents));
+  ZeroMem (&mMouse, sizeof (mMouse));
+  ZeroMem (&mReportLog, sizeof (mReportLog));
+  mMouse.UsbIo.UsbAsyncInterruptTransfer = MockUsbAsyncInterruptTransfer;
+
+  ZeroMem (&mMockBootServices, sizeof (mMockBootServices));
+  mMockBootServices.RaiseTPL    = MockRaiseTpl;
+  mMockBootServices.RestoreTPL  = MockRestoreTpl;
+  mMockBootServices.CreateEvent = MockCreateEvent;
+  mMockBootServices.CloseEvent  = MockCloseEvent;
+  mMockBootServices.SetTimer    = MockSetTimer;
+  gBS                           = &mMockBootServices;
+
+  mDevice = AllocateZeroPool (sizeof (USB_MOUSE_HID_DEV));
+  if (mDevice == NULL) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  mDevice->Signature                                          = USB_MOUSE_HID_DEV_SIGNATURE;
+  mDevice->UsbIo                                              = &mMouse.UsbIo;
+  mDevice->IntEndpointDescriptor.EndpointAddress              = MOCK_ENDPOINT_ADDRESS;
+  mDevice->IntEndpointDescriptor.Attributes                   = USB_ENDPOINT_INTERRUPT;
+  mDevice->IntEndpointDescriptor.MaxPacketSize                = MOCK_BOOT_MOUSE_REPORT_SIZE;
+  mDevice->IntEndpointDescriptor.Interval                     = MOCK_ENDPOINT_INTERVAL;
+  mDevice->HidPointerProtocol.RegisterPointerReportCallback   = RegisterPointerReportCallback;
+  mDevice->HidPointerProtocol.UnRegisterPointerReportCallback = UnRegisterPointerReportCallback;
+
+  if (EFI_ERROR (InitializeUsbMouseDevice (mDevice))) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Releases the mouse device.
+
+  @param Context  Unused.
+**/
+STATIC
+VOID
+EFIAPI
+MouseCleanup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mDevice != NULL) {
+    if (mDevice->MouseReportCallback != NULL) {
+      UnRegisterPointerReportCallback (&mDevice->HidPointerProtocol);
+    }
+
+    FreePool (mDevice);
+    mDevice = NULL;
+  }
+}
+
+/**
+  Registers the report callback and checks polling started at full rate.
+**/
+STATIC
+UNIT_TEST_STATUS
+RegisterAndCheckActive (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = RegisterPointerReportCallback (&mDevice->HidPointerProtocol, MockPointerReportCallback, NULL);
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (mDevice->PollingState, UsbMousePollingActive);
+  UT_ASSERT_TRUE (mMouse.TransferActive);
+  UT_ASSERT_EQUAL (mMouse.PollingInterval, MOCK_ENDPOINT_INTERVAL);
+
+  return UNIT_TEST_PASSED;
+}
+
+//
+// Tests.
+//
+
+/**
+  Init sends SET_IDLE with an indefinite duration, and nothing is polled until a report
+  callback is registered.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestInitSetsIdleAndDoesNotPoll (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UT_ASSERT_EQUAL (mMouse.SetIdleRequests, 1);
+  UT_ASSERT_EQUAL (mMouse.SetIdleDuration, 0);
+  UT_ASSERT_EQUAL (mDevice->PollingState, UsbMousePollingStopped);
+
+  RunFor (5000);
+
+  UT_ASSERT_FALSE (mMouse.TransferActive);
+  UT_ASSERT_EQUAL (mMouse.Submits, 0);
+  UT_ASSERT_EQUAL (mMouse.Polls, 0);
+  UT_ASSERT_EQUAL (ArmedTimers (), 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Registering starts polling at the endpoint's interval straight away, and a report is
+  delivered within one interval.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestRegisterStartsFullRatePolling (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS  TestStatus;
+
+  TestStatus = RegisterAndCheckActive ();
+  if (TestStatus != UNIT_TEST_PASSED) {
+    return TestStatus;
+  }
+
+  RunFor (MOCK_ENDPOINT_INTERVAL * 10);
+  UT_ASSERT_EQUAL (mMouse.Polls, 10);
+
+  QueueMouseReport ();
+  RunFor (MOCK_ENDPOINT_INTERVAL);
+  UT_ASSERT_EQUAL (mReportLog.Reports, 1);
+  UT_ASSERT_EQUAL (mReportLog.LastReportSize, MOCK_BOOT_MOUSE_REPORT_SIZE);
+  UT_ASSERT_TRUE (mReportLog.LastLatencyMs <= MOCK_ENDPOINT_INTERVAL);
+
+  UT_ASSERT_EQUAL (
+    RegisterPointerReportCallback (&mDevice->HidPointerProtocol, MockPointerReportCallback, NULL),
+    EFI_ALREADY_STARTED
+    );
+  UT_ASSERT_EQUAL (mMouse.DoubleSubmits, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Polling slows to the idle interval once no report arrives for the idle timeout, and
+  stays at full rate while reports keep arriving.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestIdleTimeoutSlowsPolling (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS  TestStatus;
+  UINTN             Index;
+
+  TestStatus = RegisterAndCheckActive ();
+  if (TestStatus != UNIT_TEST_PASSED) {
+    return TestStatus;
+  }
+
+  //
+  // Moving keeps the mouse at full rate well past the timeout.
+  //
+  for (Index = 0; Index < 6; Index++) {
+    QueueMouseReport ();
+    RunFor (PcdGet32 (PcdUsbHidIdleTimeout) / 2);
+    UT_ASSERT_EQUAL (mDevice->PollingState, UsbMousePollingActive);
+  }
+
+  UT_ASSERT_EQUAL (mReportLog.Reports, 6);
+
+  //
+  // A quiet timeout period after the last movement goes idle.
+  //
+  RunFor (PcdGet32 (PcdUsbHidIdleTimeout) * 2);
+  UT_ASSERT_EQUAL (mDevice->PollingState, UsbMousePollingIdle);
+  UT_ASSERT_TRUE (mMouse.TransferActive);
+  UT_ASSERT_EQUAL (mMouse.PollingInterval, PcdGet8 (PcdUsbHidIdlePollingInterval));
+  UT_ASSERT_EQUAL (mMouse.DoubleSubmits, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A report that arrives while idle is delivered within the idle interval and returns
+  polling to full rate.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestActivityResumesFullRatePolling (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS  TestStatus;
+
+  TestStatus = RegisterAndCheckActive ();
+  if (TestStatus != UNIT_TEST_PASSED) {
+    return TestStatus;
+  }
+
+  RunFor (PcdGet32 (PcdUsbHidIdleTimeout) + 1);
+  UT_ASSERT_EQUAL (mDevice->PollingState, UsbMousePollingIdle);
+
+  RunFor (3);
+  QueueMouseReport ();
+  RunFor (PcdGet8 (PcdUsbHidIdlePollingInterval));
+  UT_ASSERT_EQUAL (mReportLog.Reports, 1);
+  UT_ASSERT_TRUE (mReportLog.LastLatencyMs <= PcdGet8 (PcdUsbHidIdlePollingInterval));
+
+  //
+  // The switch back to full rate is made from the polling timer, not from inside the
+  // transfer's completion.
+  //
+  RunFor (1);
+  UT_ASSERT_EQUAL (mDevice->PollingState, UsbMousePollingActive);
+  UT_ASSERT_EQUAL (mMouse.PollingInterval, MOCK_ENDPOINT_INTERVAL);
+
+  QueueMouseReport ();
+  RunFor (MOCK_ENDPOINT_INTERVAL);
+  UT_ASSERT_EQUAL (mReportLog.Reports, 2);
+  UT_ASSERT_TRUE (mReportLog.LastLatencyMs <= MOCK_ENDPOINT_INTERVAL);
+  UT_ASSERT_EQUAL (mMouse.DoubleSubmits, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unregistering removes the transfer and all timers, so nothing is polled.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestUnregisterStopsPolling (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS  TestStatus;
+  UINTN             Polls;
+
+  TestStatus = RegisterAndCheckActive ();
+  if (TestStatus != UNIT_TEST_PASSED) {
+    return TestStatus;
+  }
+
+  RunFor (100);
+  UT_ASSERT_NOT_EFI_ERROR (UnRegisterPointerReportCallback (&mDevice->HidPointerProtocol));
+  UT_ASSERT_EQUAL (mDevice->PollingState, UsbMousePollingStopped);
+  UT_ASSERT_FALSE (mMouse.TransferActive);
+  UT_ASSERT_EQUAL (ArmedTimers (), 0);
+
+  Polls = mMouse.Polls;
+  QueueMouseReport ();
+  RunFor (5000);
+  UT_ASSERT_EQUAL (mMouse.Polls, Polls);
+  UT_ASSERT_EQUAL (mReportLog.Reports, 0);
+
+  UT_ASSERT_EQUAL (UnRegisterPointerReportCallback (&mDevice->HidPointerProtocol), EFI_NOT_FOUND);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A failure to submit the transfer fails registration and leaves polling stopped.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestRegisterFailsWhenSubmitFails (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mMouse.SubmitStatus = EFI_DEVICE_ERROR;
+
+  UT_ASSERT_EQUAL (
+    RegisterPointerReportCallback (&mDevice->HidPointerProtocol, MockPointerReportCallback, NULL),
+    EFI_DEVICE_ERROR
+    );
+  UT_ASSERT_EQUAL (mDevice->PollingState, UsbMousePollingStopped);
+  UT_ASSERT_TRUE (mDevice->MouseReportCallback == NULL);
+  UT_ASSERT_EQUAL (ArmedTimers (), 0);
+
+  mMouse.SubmitStatus = EFI_SUCCESS;
+  return RegisterAndCheckActive ();
+}
+
+/**
+  Error recovery resubmits at the rate of the current polling state, and does nothing
+  once polling was stopped.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestRecoveryFollowsPollingState (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS  TestStatus;
+  UINTN             Submits;
+
+  TestStatus = RegisterAndCheckActive ();
+  if (TestStatus != UNIT_TEST_PASSED) {
+    return TestStatus;
+  }
+
+  RunFor (PcdGet32 (PcdUsbHidIdleTimeout) + 1);
+  UT_ASSERT_EQUAL (mDevice->PollingState, UsbMousePollingIdle);
+
+  //
+  // An error while idle recovers at the idle rate.
+  //
+  mMouse.PendingError = EFI_USB_ERR_STALL;
+  RunFor (PcdGet8 (PcdUsbHidIdlePollingInterval));
+  UT_ASSERT_FALSE (mMouse.TransferActive);
+  RunFor (EFI_USB_INTERRUPT_DELAY / MOCK_100NS_PER_MS);
+  UT_ASSERT_TRUE (mMouse.TransferActive);
+  UT_ASSERT_EQUAL (mMouse.PollingInterval, PcdGet8 (PcdUsbHidIdlePollingInterval));
+
+  //
+  // An error followed by unregistering is not recovered.
+  //
+  mMouse.PendingError = EFI_USB_ERR_STALL;
+  RunFor (PcdGet8 (PcdUsbHidIdlePollingInterval));
+  UT_ASSERT_FALSE (mMouse.TransferActive);
+  UT_ASSERT_NOT_EFI_ERROR (UnRegisterPointerReportCallback (&mDevice->HidPointerProtocol));
+
+  Submits = mMouse.Submits;
+  RunFor (EFI_USB_INTERRUPT_DELAY / MOCK_100NS_PER_MS * 2);
+  UT_ASSERT_FALSE (mMouse.TransferActive);
+  UT_ASSERT_EQUAL (mMouse.Submits, Submits);
+  UT_ASSERT_EQUAL (mMouse.DoubleSubmits, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Compares how often the endpoint is polled per second at full rate and once idle.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestPollsPerSecond (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UNIT_TEST_STATUS  TestStatus;
+  UINTN             ActivePolls;
+  UINTN             IdlePolls;
+
+  TestStatus = RegisterAndCheckActive ();
+  if (TestStatus != UNIT_TEST_PASSED) {
+    return TestStatus;
+  }
+
+  ActivePolls = mMouse.Polls;
+  RunFor (PcdGet32 (PcdUsbHidIdleTimeout));
+  ActivePolls = (mMouse.Polls - ActivePolls) * 1000 / PcdGet32 (PcdUsbHidIdleTimeout);
+  UT_ASSERT_EQUAL (mDevice->PollingState, UsbMousePollingIdle);
+
+  IdlePolls = mMouse.Polls;
+  RunFor (10000);
+  IdlePolls = (mMouse.Polls - IdlePolls) / 10;
+
+  UT_LOG_INFO ("Polls per second: %u at full rate, %u idle\n", (UINT32)ActivePolls, (UINT32)IdlePolls);
+  UT_ASSERT_EQUAL (ActivePolls, 1000 / MOCK_ENDPOINT_INTERVAL);
+  UT_ASSERT_EQUAL (IdlePolls, 1000 / PcdGet8 (PcdUsbHidIdlePollingInterval));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  mouse polling tests and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      PollingSuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&PollingSuiteHandle, Framework, "UsbMouseHidDxe interrupt polling tests", "UsbMouseHidDxe.Polling", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for PollingSuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (PollingSuiteHandle, "Init sends SET_IDLE and does not poll", "Init.SetIdle", TestInitSetsIdleAndDoesNotPoll, MouseSetup, MouseCleanup, NULL);
+  AddTestCase (PollingSuiteHandle, "Registering a callback starts full rate polling", "Register.FullRate", TestRegisterStartsFullRatePolling, MouseSetup, MouseCleanup, NULL);
+  AddTestCase (PollingSuiteHandle, "Registering fails if the transfer cannot be submitted", "Register.SubmitFails", TestRegisterFailsWhenSubmitFails, MouseSetup, MouseCleanup, NULL);
+  AddTestCase (PollingSuiteHandle, "Idle input slows polling down", "Idle.Timeout", TestIdleTimeoutSlowsPolling, MouseSetup, MouseCleanup, NULL);
+  AddTestCase (PollingSuiteHandle, "Input while idle resumes full rate polling", "Idle.Resume", TestActivityResumesFullRatePolling, MouseSetup, MouseCleanup, NULL);
+  AddTestCase (PollingSuiteHandle, "Unregistering the callback stops polling", "Unregister.Stop", TestUnregisterStopsPolling, MouseSetup, MouseCleanup, NULL);
+  AddTestCase (PollingSuiteHandle, "Error recovery follows the polling state", "Recovery", TestRecoveryFollowsPollingState, MouseSetup, MouseCleanup, NULL);
+  AddTestCase (PollingSuiteHandle, "Polls per second at full rate and idle", "PollsPerSecond", TestPollsPerSecond, MouseSetup, MouseCleanup, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
@@ -117,9 +117,10 @@ UsbMouseHidDriverBindingSupported (
 /**
   Starts the mouse device with this driver.
 
-  This function consumes USB I/O Protocol, initializes USB mouse device,
-  installs Absolute Pointer Protocol, and submits Asynchronous Interrupt
-  Transfer to manage the USB mouse device.
+  This function consumes USB I/O Protocol, initializes USB mouse device and
+  installs HID Pointer Protocol. The Asynchronous Interrupt Transfer that manages
+  the USB mouse device is submitted once a report callback is registered, see
+  SetMousePolling().
 
   @param  This                  The driver binding instance.
   @param  Controller            Handle of device to bind driver to.
@@ -147,13 +148,11 @@ UsbMouseHidDriverBindingStart (
   UINT8                        EndpointNumber;
   EFI_USB_ENDPOINT_DESCRIPTOR  EndpointDescriptor;
   UINT8                        Index;
-  UINT8                        EndpointAddr;
-  UINT8                        PollingInterval;
-  UINT8                        PacketSize;
   BOOLEAN                      Found;
   EFI_TPL                      OldTpl;
 
-  OldTpl = gBS->RaiseTPL (TPL_CALLBACK);
+  OldTpl            = gBS->RaiseTPL (TPL_CALLBACK);
+  UsbMouseHidDevice = NULL;
   //
   // Open USB I/O Protocol
   //
@@ -276,9 +275,9 @@ UsbMouseHidDriverBindingStart (
   }
 
   //
-  // The next step would be submitting Asynchronous Interrupt Transfer on this mouse device.
-  // After that we will be able to get key data from it. Thus this is deemed as
-  // the enable action of the mouse, so report status code accordingly.
+  // Once a report callback is registered Asynchronous Interrupt Transfer is submitted on
+  // this mouse device. After that we will be able to get key data from it. Thus this is
+  // deemed as the enable action of the mouse, so report status code accordingly.
   //
   REPORT_STATUS_CODE_WITH_DEVICE_PATH (
     EFI_PROGRESS_CODE,
@@ -286,27 +285,6 @@ UsbMouseHidDriverBindingStart (
     UsbMouseHidDevice->DevicePath
     );
 
-  //
-  // Submit Asynchronous Interrupt Transfer to manage this device.
-  //
-  EndpointAddr    = UsbMouseHidDevice->IntEndpointDescriptor.EndpointAddress;
-  PollingInterval = UsbMouseHidDevice->IntEndpointDescriptor.Interval;
-  PacketSize      = (UINT8)(UsbMouseHidDevice->IntEndpointDescriptor.MaxPacketSize);
-
-  Status = UsbIo->UsbAsyncInterruptTransfer (
-                    UsbIo,
-                    EndpointAddr,
-                    TRUE,
-                    PollingInterval,
-                    PacketSize,
-                    OnMouseInterruptComplete,
-                    UsbMouseHidDevice
-                    );
-
-  if (EFI_ERROR (Status)) {
-    goto ErrorExit;
-  }
-
   //
   // Initialize and install HID Pointer Protocol.
   //
@@ -354,6 +332,14 @@ ErrorExit:
            );
 
     if (UsbMouseHidDevice != NULL) {
+      if (UsbMouseHidDevice->DelayedRecoveryEvent != NULL) {
+        gBS->CloseEvent (UsbMouseHidDevice->DelayedRecoveryEvent);
+      }
+
+      if (UsbMouseHidDevice->PollingTimerEvent != NULL) {
+        gBS->CloseEvent (UsbMouseHidDevice->PollingTimerEvent);
+      }
+
       FreePool (UsbMouseHidDevice);
       UsbMouseHidDevice = NULL;
     }
@@ -419,8 +405,14 @@ UsbMouseHidDriverBindingStop (
     );
 
   //
-  // Delete the Asynchronous Interrupt Transfer from this device
+  // Stop switching the polling rate, then delete the Asynchronous Interrupt Transfer from this device
   //
+  if (UsbMouseHidDevice->PollingTimerEvent != NULL) {
+    gBS->CloseEvent (UsbMouseHidDevice->PollingTimerEvent);
+    UsbMouseHidDevice->PollingTimerEvent = NULL;
+  }
+
+  UsbMouseHidDevice->PollingState = UsbMousePollingStopped;
   UsbIo->UsbAsyncInterruptTransfer (
            UsbIo,
            UsbMouseHidDevice->IntEndpointDescriptor.EndpointAddress,
@@ -488,6 +480,8 @@ RegisterPointerReportCallback (
   )
 {
   USB_MOUSE_HID_DEV  *UsbMouseHidDevice;
+  EFI_STATUS         Status;
+  EFI_TPL            OldTpl;
 
   if ((This == NULL) || (PointerReportCallback == NULL)) {
     return EFI_INVALID_PARAMETER;
@@ -499,10 +493,25 @@ RegisterPointerReportCallback (
     return EFI_ALREADY_STARTED;
   }
 
+  //
+  // Reports are only polled for while there is someone to deliver them to, so start
+  // polling at full rate now.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
   UsbMouseHidDevice->MouseReportCallback        = PointerReportCallback;
   UsbMouseHidDevice->MouseReportCallbackContext = Context;
 
-  return EFI_SUCCESS;
+  Status = SetMousePolling (UsbMouseHidDevice, UsbMousePollingActive);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "[%a] - failed to submit mouse interrupt transfer: %r.\n", __FUNCTION__, Status));
+    UsbMouseHidDevice->MouseReportCallback        = NULL;
+    UsbMouseHidDevice->MouseReportCallbackContext = NULL;
+  }
+
+  gBS->RestoreTPL (OldTpl);
+
+  return Status;
 }
 
 /**
@@ -521,6 +530,7 @@ UnRegisterPointerReportCallback (
   )
 {
   USB_MOUSE_HID_DEV  *UsbMouseHidDevice;
+  EFI_TPL            OldTpl;
 
   if (This == NULL) {
     return EFI_INVALID_PARAMETER;
@@ -532,9 +542,17 @@ UnRegisterPointerReportCallback (
     return EFI_NOT_FOUND;
   }
 
+  //
+  // With no one to deliver reports to, stop polling the mouse.
+  //
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+
+  SetMousePolling (UsbMouseHidDevice, UsbMousePollingStopped);
   UsbMouseHidDevice->MouseReportCallback        = NULL;
   UsbMouseHidDevice->MouseReportCallbackContext = NULL;
 
+  gBS->RestoreTPL (OldTpl);
+
   return EFI_SUCCESS;
 }
 
@@ -624,6 +642,18 @@ InitializeUsbMouseDevice (
     }
   }
 
+  //
+  // Set an indefinite idle rate for all input reports, so the mouse only reports when
+  // it moves or a button changes. Mice that do not support SET_IDLE keep reporting at
+  // every poll, which is harmless.
+  //
+  UsbSetIdleRequest (
+    UsbIo,
+    UsbMouseHidDev->InterfaceDescriptor.InterfaceNumber,
+    0,
+    0
+    );
+
   //
   // Create event for delayed recovery, which deals with device error.
   //
@@ -640,6 +670,23 @@ InitializeUsbMouseDevice (
          &UsbMouseHidDev->DelayedRecoveryEvent
          );
 
+  //
+  // Create event for slowing down polling while input is idle. Without it the mouse
+  // is simply polled at full rate.
+  //
+  if (UsbMouseHidDev->PollingTimerEvent != NULL) {
+    gBS->CloseEvent (UsbMouseHidDev->PollingTimerEvent);
+    UsbMouseHidDev->PollingTimerEvent = NULL;
+  }
+
+  gBS->CreateEvent (
+         EVT_TIMER | EVT_NOTIFY_SIGNAL,
+         TPL_NOTIFY,
+         UsbMouseHidPollingHandler,
+         UsbMouseHidDev,
+         &UsbMouseHidDev->PollingTimerEvent
+         );
+
   return EFI_SUCCESS;
 }
 
@@ -728,6 +775,16 @@ OnMouseInterruptComplete (
     return EFI_SUCCESS;
   }
 
+  //
+  // Note the input so polling stays at full rate. If polling had slowed down, return to
+  // full rate on the next timer tick rather than resubmitting the transfer from its own
+  // completion.
+  //
+  UsbMouseHidDevice->ReportSeen = TRUE;
+  if ((UsbMouseHidDevice->PollingState == UsbMousePollingIdle) && (UsbMouseHidDevice->PollingTimerEvent != NULL)) {
+    gBS->SetTimer (UsbMouseHidDevice->PollingTimerEvent, TimerRelative, 0);
+  }
+
   //
   // Send report to the HID layer.
   //
@@ -743,6 +800,29 @@ OnMouseInterruptComplete (
   return EFI_SUCCESS;
 }
 
+/**
+  Gets the interval to poll the mouse at in a polling state.
+
+  @param  UsbMouseHidDev   Device instance.
+  @param  PollingState     The polling state.
+
+  @return The polling interval in milliseconds.
+
+**/
+STATIC
+UINT8
+GetMousePollingInterval (
+  IN USB_MOUSE_HID_DEV        *UsbMouseHidDev,
+  IN USB_MOUSE_POLLING_STATE  PollingState
+  )
+{
+  if (PollingState == UsbMousePollingIdle) {
+    return MAX (UsbMouseHidDev->IntEndpointDescriptor.Interval, PcdGet8 (PcdUsbHidIdlePollingInterval));
+  }
+
+  return UsbMouseHidDev->IntEndpointDescriptor.Interval;
+}
+
 /**
   Handler for Delayed Recovery event.
 
@@ -768,6 +848,13 @@ UsbMouseHidRecoveryHandler (
 
   UsbMouseHidDev = (USB_MOUSE_HID_DEV *)Context;
 
+  //
+  // Polling was stopped while waiting to recover, so there is nothing to re-submit.
+  //
+  if (UsbMouseHidDev->PollingState == UsbMousePollingStopped) {
+    return;
+  }
+
   UsbIo = UsbMouseHidDev->UsbIo;
 
   //
@@ -777,9 +864,142 @@ UsbMouseHidRecoveryHandler (
            UsbIo,
            UsbMouseHidDev->IntEndpointDescriptor.EndpointAddress,
            TRUE,
-           UsbMouseHidDev->IntEndpointDescriptor.Interval,
+           GetMousePollingInterval (UsbMouseHidDev, UsbMouseHidDev->PollingState),
            UsbMouseHidDev->IntEndpointDescriptor.MaxPacketSize,
            OnMouseInterruptComplete,
            UsbMouseHidDev
            );
 }
+
+/**
+  Moves the mouse to a new polling state.
+
+  The Asynchronous Interrupt Transfer is removed and, unless polling is being stopped,
+  submitted again at the interval of the new state.
+
+  @param  UsbMouseHidDev   Device instance.
+  @param  PollingState     The polling state to move to.
+
+  @retval EFI_SUCCESS      The mouse is polled as requested.
+  @retval Other            The transfer could not be submitted, polling is stopped.
+
+**/
+EFI_STATUS
+SetMousePolling (
+  IN OUT USB_MOUSE_HID_DEV        *UsbMouseHidDev,
+  IN     USB_MOUSE_POLLING_STATE  PollingState
+  )
+{
+  EFI_USB_IO_PROTOCOL  *UsbIo;
+  EFI_STATUS           Status;
+
+  UsbIo = UsbMouseHidDev->UsbIo;
+
+  //
+  // Remove the transfer at the old rate. A pending recovery would submit it again, so
+  // cancel that as well.
+  //
+  if (UsbMouseHidDev->PollingState != UsbMousePollingStopped) {
+    UsbIo->UsbAsyncInterruptTransfer (
+             UsbIo,
+             UsbMouseHidDev->IntEndpointDescriptor.EndpointAddress,
+             FALSE,
+             0,
+             0,
+             NULL,
+             NULL
+             );
+  }
+
+  if (UsbMouseHidDev->DelayedRecoveryEvent != NULL) {
+    gBS->SetTimer (UsbMouseHidDev->DelayedRecoveryEvent, TimerCancel, 0);
+  }
+
+  if (UsbMouseHidDev->PollingTimerEvent != NULL) {
+    gBS->SetTimer (UsbMouseHidDev->PollingTimerEvent, TimerCancel, 0);
+  }
+
+  UsbMouseHidDev->PollingState = UsbMousePollingStopped;
+  UsbMouseHidDev->ReportSeen   = FALSE;
+
+  if (PollingState == UsbMousePollingStopped) {
+    return EFI_SUCCESS;
+  }
+
+  Status = UsbIo->UsbAsyncInterruptTransfer (
+                    UsbIo,
+                    UsbMouseHidDev->IntEndpointDescriptor.EndpointAddress,
+                    TRUE,
+                    GetMousePollingInterval (UsbMouseHidDev, PollingState),
+                    UsbMouseHidDev->IntEndpointDescriptor.MaxPacketSize,
+                    OnMouseInterruptComplete,
+                    UsbMouseHidDev
+                    );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  UsbMouseHidDev->PollingState = PollingState;
+
+  //
+  // Watch for input going idle, unless idle polling would be no slower than full rate.
+  //
+  if ((PollingState == UsbMousePollingActive) &&
+      (UsbMouseHidDev->PollingTimerEvent != NULL) &&
+      (GetMousePollingInterval (UsbMouseHidDev, UsbMousePollingIdle) > UsbMouseHidDev->IntEndpointDescriptor.Interval))
+  {
+    gBS->SetTimer (
+           UsbMouseHidDev->PollingTimerEvent,
+           TimerRelative,
+           EFI_TIMER_PERIOD_MILLISECONDS (PcdGet32 (PcdUsbHidIdleTimeout))
+           );
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Handler for the polling timer event.
+
+  While polling at full rate the timer fires every PcdUsbHidIdleTimeout, and polling
+  slows down if no report arrived since it last fired. While idle it fires only when a
+  report arrives, and polling returns to full rate.
+
+  @param  Event                 The polling timer event.
+  @param  Context               Points to the USB_MOUSE_HID_DEV instance.
+
+**/
+VOID
+EFIAPI
+UsbMouseHidPollingHandler (
+  IN    EFI_EVENT  Event,
+  IN    VOID       *Context
+  )
+{
+  USB_MOUSE_HID_DEV  *UsbMouseHidDev;
+
+  UsbMouseHidDev = (USB_MOUSE_HID_DEV *)Context;
+
+  switch (UsbMouseHidDev->PollingState) {
+    case UsbMousePollingIdle:
+      SetMousePolling (UsbMouseHidDev, UsbMousePollingActive);
+      break;
+
+    case UsbMousePollingActive:
+      if (UsbMouseHidDev->ReportSeen) {
+        UsbMouseHidDev->ReportSeen = FALSE;
+        gBS->SetTimer (
+               UsbMouseHidDev->PollingTimerEvent,
+               TimerRelative,
+               EFI_TIMER_PERIOD_MILLISECONDS (PcdGet32 (PcdUsbHidIdleTimeout))
+               );
+      } else {
+        SetMousePolling (UsbMouseHidDev, UsbMousePollingIdle);
+      }
+
+      break;
+
+    default:
+      break;
+  }
+}
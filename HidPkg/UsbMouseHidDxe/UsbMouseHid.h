@@ -32,6 +32,7 @@
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
 #include <Library/UefiUsbLib.h>
 #include <Library/DebugLib.h>
 
@@ -56,6 +57,15 @@ typedef struct {
 } USB_DESC_HEAD;
 #pragma pack()
 
+///
+/// How the interrupt endpoint of the mouse is being polled
+///
+typedef enum {
+  UsbMousePollingStopped,       ///< No report callback is registered, so no transfer is submitted
+  UsbMousePollingActive,        ///< Polling at the endpoint's own interval
+  UsbMousePollingIdle           ///< No input for PcdUsbHidIdleTimeout, polling at PcdUsbHidIdlePollingInterval
+} USB_MOUSE_POLLING_STATE;
+
 ///
 /// Device instance of USB mouse.
 ///
@@ -63,6 +73,9 @@ typedef struct {
   UINTN                           Signature;
   EFI_DEVICE_PATH_PROTOCOL        *DevicePath;
   EFI_EVENT                       DelayedRecoveryEvent;
+  EFI_EVENT                       PollingTimerEvent;
+  USB_MOUSE_POLLING_STATE         PollingState;
+  BOOLEAN                         ReportSeen;
   EFI_USB_IO_PROTOCOL             *UsbIo;
   EFI_USB_INTERFACE_DESCRIPTOR    InterfaceDescriptor;
   EFI_USB_ENDPOINT_DESCRIPTOR     IntEndpointDescriptor;
@@ -108,9 +121,9 @@ UsbMouseHidDriverBindingSupported (
 /**
   Starts the mouse device with this driver.
 
-  This function consumes USB I/O Protocol, initializes USB mouse device,
-  installs Absolute Pointer Protocol, and submits Asynchronous Interrupt
-  Transfer to manage the USB mouse device.
+  This function consumes USB I/O Protocol, initializes USB mouse device and
+  installs HID Pointer Protocol. The Asynchronous Interrupt Transfer that manages
+  the USB mouse device is submitted once a report callback is registered.
 
   @param  This                  The driver binding instance.
   @param  Controller            Handle of device to bind driver to.
@@ -387,4 +400,41 @@ UsbMouseHidRecoveryHandler (
   IN    VOID       *Context
   );
 
+/**
+  Moves the mouse to a new polling state.
+
+  The Asynchronous Interrupt Transfer is removed and, unless polling is being stopped,
+  submitted again at the interval of the new state.
+
+  @param  UsbMouseHidDev   Device instance.
+  @param  PollingState     The polling state to move to.
+
+  @retval EFI_SUCCESS      The mouse is polled as requested.
+  @retval Other            The transfer could not be submitted, polling is stopped.
+
+**/
+EFI_STATUS
+SetMousePolling (
+  IN OUT USB_MOUSE_HID_DEV        *UsbMouseHidDev,
+  IN     USB_MOUSE_POLLING_STATE  PollingState
+  );
+
+/**
+  Handler for the polling timer event.
+
+  While polling at full rate the timer fires every PcdUsbHidIdleTimeout, and polling
+  slows down if no report arrived since it last fired. While idle it fires only when a
+  report arrives, and polling returns to full rate.
+
+  @param  Event                 The polling timer event.
+  @param  Context               Points to the USB_MOUSE_HID_DEV instance.
+
+**/
+VOID
+EFIAPI
+UsbMouseHidPollingHandler (
+  IN    EFI_EVENT  Event,
+  IN    VOID       *Context
+  );
+
 #endif
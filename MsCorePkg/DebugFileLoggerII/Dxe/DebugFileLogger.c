@@ -13,12 +13,14 @@
 // Global variables.
 //
 
+EFI_EVENT                 mDrainEvent                 = NULL;
+UINT32                    mDrainPending               = 0;
 VOID                      *mFileSystemRegistration    = NULL;
 CHAR8                     *mLoggingBuffer             = NULL;
 UINT64                    mLoggingBuffer_BytesWritten = 0;
 UINT64                    mLoggingBuffer_Size         = 0;
 LIST_ENTRY                mLoggingDeviceHead          = INITIALIZE_LIST_HEAD_VARIABLE (mLoggingDeviceHead);
-UINT32                    mLoggingSemaphore           = 0;
+LOG_RECORD_RING           mRecordRing;
 EFI_RSC_HANDLER_PROTOCOL  *mRscHandlerProtocol        = NULL;
 UINT32                    mWritingSemaphore           = 0;
 
@@ -134,6 +136,159 @@ CleanUp:
   return Status;
 }
 
+/**
+
+    Allocate the ring that status codes are captured in until they are formatted.
+
+    @param    None
+
+    @retval   EFI_SUCCESS           The ring was successfully initialized.
+    @retval   EFI_OUT_OF_RESOURCES  The ring could not be allocated.
+
+**/
+STATIC
+EFI_STATUS
+RecordRingInit (
+  VOID
+  )
+{
+  VOID        *Buffer;
+  EFI_STATUS  Status;
+
+  Buffer = AllocatePages (EFI_SIZE_TO_PAGES (DEBUG_LOG_RECORD_RING_SIZE));
+  if (Buffer == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+  } else {
+    Status = LogRecordRingInit (&mRecordRing, Buffer, DEBUG_LOG_RECORD_RING_SIZE);
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a: failed to initialize the status code record ring (%r)\n", __FUNCTION__, Status));
+  }
+
+  return Status;
+}
+
+/**
+    Write the logging buffer to every log device so the buffer can be reused.  The rest of
+    the log is appended to the same log file; once that file is full the remainder is dropped
+    and counted at the end of the file.
+
+    @retval   TRUE      The logging buffer was written and is now empty.
+    @retval   FALSE     There is no log device to write to.  The buffer was left as is.
+
+  **/
+STATIC
+BOOLEAN
+SpillLoggingBuffer (
+  VOID
+  )
+{
+  LIST_ENTRY  *Link;
+  LOG_DEVICE  *LogDevice;
+
+  if (IsListEmpty (&mLoggingDeviceHead)) {
+    return FALSE;
+  }
+
+  EFI_LIST_FOR_EACH (Link, &(mLoggingDeviceHead)) {
+    LogDevice = LOG_DEVICE_FROM_LINK (Link);
+    WriteALogFile (LogDevice, mLoggingBuffer, mLoggingBuffer_BytesWritten);
+    LogDevice->BufferConsumed = 0;
+  }
+
+  mLoggingBuffer_BytesWritten = 0;
+  return TRUE;
+}
+
+/**
+    Format the captured status code records into the logging buffer.
+
+    When the logging buffer fills up, it is spilled to the log devices.  If there are no log
+    devices yet, the remaining records stay in the ring until there is room.  Must be called
+    with mWritingSemaphore held.
+
+  **/
+STATIC
+VOID
+FormatPendingRecords (
+  VOID
+  )
+{
+  UINT32      Lost;
+  LOG_RECORD  *Record;
+
+  if ((mLoggingBuffer == NULL) || (mRecordRing.Buffer == NULL)) {
+    return;
+  }
+
+  for ( ; ;) {
+    Record = LogRecordRingPeek (&mRecordRing);
+    if (Record == NULL) {
+      break;
+    }
+
+    if ((mLoggingBuffer_BytesWritten + LOG_RECORD_MAX_TEXT) > mLoggingBuffer_Size) {
+      if (!SpillLoggingBuffer ()) {
+        return;
+      }
+    }
+
+    mLoggingBuffer_BytesWritten += LogRecordFormat (
+                                     Record,
+                                     mLoggingBuffer + mLoggingBuffer_BytesWritten,
+                                     LOG_RECORD_MAX_TEXT
+                                     );
+    LogRecordRingRelease (&mRecordRing, Record);
+  }
+
+  //
+  // Records lost after the newest record have no record to carry the count.
+  //
+  if ((mLoggingBuffer_BytesWritten + LOG_RECORD_MAX_TEXT) > mLoggingBuffer_Size) {
+    return;
+  }
+
+  Lost = LogRecordRingTakeLost (&mRecordRing);
+  if (Lost != 0) {
+    mLoggingBuffer_BytesWritten += LogRecordFormatLost (
+                                     Lost,
+                                     mLoggingBuffer + mLoggingBuffer_BytesWritten,
+                                     LOG_RECORD_MAX_TEXT
+                                     );
+  }
+}
+
+/**
+    Format the captured status code records once the ring is half full.
+
+    @param    Event           Not Used.
+    @param    Context         Not Used.
+
+   @retval   none
+ **/
+STATIC
+VOID
+EFIAPI
+OnDrainRecords (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  //
+  // Allow the handler to signal again before formatting, so records captured while this
+  // runs are not left behind.
+  //
+  InterlockedCompareExchange32 (&mDrainPending, 1, 0);
+
+  if (InterlockedCompareExchange32 (&mWritingSemaphore, 0, 1) != 0) {
+    return;
+  }
+
+  FormatPendingRecords ();
+  InterlockedCompareExchange32 (&mWritingSemaphore, 1, 0);
+}
+
 /**
     WriteLogFiles
 
@@ -162,6 +317,8 @@ WriteLogFiles (
 
   TimeStart = GetPerformanceCounter ();
 
+  FormatPendingRecords ();
+
   EFI_LIST_FOR_EACH (Link, &(mLoggingDeviceHead)) {
     LogDevice = LOG_DEVICE_FROM_LINK (Link);
 
@@ -234,7 +391,11 @@ OnPostReadyToBootNotification (
 }
 
 /**
-    Capture the data from a logging event and store the information in ASCII form in the logging buffer.
+    Capture the data from a logging event as a binary record.  The record is formatted as
+    ASCII text into the logging buffer later, at TPL_CALLBACK.
+
+    This may be called at any TPL, and may interrupt itself.  Every call gets its own record,
+    so nested reports are kept.
 
     @param    CodeType    Indicates the type of status code being reported.
     @param    Value       Describes the current status of a hardware or software entity.
@@ -248,9 +409,8 @@ OnPostReadyToBootNotification (
     @param    Data        This optional parameter may be used to pass additional data.
 
     @retval   EFI_STATUS              Event data was successfully captured.
-    @retval   EFI_DEVICE_ERROR        Function has been called a second+ time (reentrancy error)
-    @retval   EFI_OUT_OF_RESOURCES    Insufficient resources to complete the operation.
-    @retval   Others                  The operation failed.
+    @retval   EFI_OUT_OF_RESOURCES    The record ring is full.  The event was counted as lost, and
+                                      the count is written to the log.
 
 **/
 EFI_STATUS
@@ -263,52 +423,51 @@ DxeLoggingBufferCaptureEvent (
   IN EFI_STATUS_CODE_DATA   *Data OPTIONAL
   )
 {
-  UINTN       BytesWritten = 0;
-  CHAR8       *LoggingBufferWriteLoc;
-  EFI_STATUS  Status = EFI_SUCCESS;
+  EFI_STATUS  Status;
+
+  Status = LogRecordCapture (
+             &mRecordRing,
+             CodeType,
+             Value,
+             Instance,
+             (CONST EFI_GUID *)CallerId,
+             Data
+             );
 
   //
-  // Use an atomic lock to catch a re-entrant call. Non-zero means we've entered
-  // a second time.
+  // Have the records formatted before the ring fills up.  Signal only once until the
+  // drain has started.
   //
-  if (InterlockedCompareExchange32 (&mLoggingSemaphore, 0, 1) != 0) {
-    DEBUG ((DEBUG_ERROR, "CaptureEvent blocked.\n"));
-    return EFI_DEVICE_ERROR;
+  if ((mDrainEvent != NULL) &&
+      (LogRecordRingUsed (&mRecordRing) >= DEBUG_LOG_RECORD_DRAIN_AT) &&
+      (InterlockedCompareExchange32 (&mDrainPending, 0, 1) == 0))
+  {
+    gBS->SignalEvent (mDrainEvent);
   }
 
-  // If we don't have enough space to log the current event, at least store what
-  // we have thus far to the log file.
-  if ((mLoggingBuffer_BytesWritten + EFI_STATUS_CODE_DATA_MAX_SIZE) > mLoggingBuffer_Size) {
-    DEBUG ((DEBUG_ERROR, "%a: buffer full, truncating at %d bytes.\n", __FUNCTION__, mLoggingBuffer_BytesWritten));
-    //  -- this will be running at high level.  need to instead trigger event at callback level DflDxeLoggingBufferWriteToFile(0, NULL);
-    Status = EFI_OUT_OF_RESOURCES;
-    mRscHandlerProtocol->Unregister (DxeLoggingBufferCaptureEvent);
-    goto CleanUp;
-  }
-
-  //
-  // Capture the event information as ASCII text.
-  //
-  LoggingBufferWriteLoc = mLoggingBuffer + mLoggingBuffer_BytesWritten;
-  BytesWritten          = WriteStatusCodeToBuffer (
-                            CodeType,
-                            Value,
-                            Instance,
-                            (CONST EFI_GUID *)CallerId,
-                            Data,
-                            LoggingBufferWriteLoc,
-                            EFI_STATUS_CODE_DATA_MAX_SIZE
-                            );
+  return Status;
+}
 
-  mLoggingBuffer_BytesWritten += BytesWritten;
+/**
+    Stop capturing at ExitBootServices.  Boot services, and this driver, are going away.
 
-CleanUp:
+    @param    Event           Not Used.
+    @param    Context         Not Used.
 
-  //
-  // Release the lock.
-  //
-  InterlockedCompareExchange32 (&mLoggingSemaphore, 1, 0);
-  return Status;
+   @retval   none
+ **/
+STATIC
+VOID
+EFIAPI
+OnExitBootServicesNotification (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  mDrainEvent = NULL;
+  if (mRscHandlerProtocol != NULL) {
+    mRscHandlerProtocol->Unregister (DxeLoggingBufferCaptureEvent);
+  }
 }
 
 /**
@@ -451,11 +610,13 @@ RegisterLogDevice (
     return;
   }
 
-  LogDevice->Signature     = LOG_DEVICE_SIGNATURE;
-  LogDevice->Handle        = Handle;
-  LogDevice->FileIndex     = 0;
-  LogDevice->CurrentOffset = 0;
-  LogDevice->Valid         = TRUE;
+  LogDevice->Signature      = LOG_DEVICE_SIGNATURE;
+  LogDevice->Handle         = Handle;
+  LogDevice->FileIndex      = 0;
+  LogDevice->CurrentOffset  = 0;
+  LogDevice->BufferConsumed = 0;
+  LogDevice->BytesDropped   = 0;
+  LogDevice->Valid          = TRUE;
 
   Status = EnableLoggingOnThisDevice (LogDevice);
 
@@ -783,6 +944,60 @@ ProcessPostReadyToBootRegistration (
   return Status;
 }
 
+/**
+    ProcessRecordDrainRegistration
+
+    This function creates the event that formats captured records when the ring is half
+    full, and the ExitBootServices event that stops the capture.
+
+
+    @param    VOID
+
+    @returns  EFI_SUCCESS   - Successfully created the events
+    @returns  other         - failure code from CreateEvent or CreateEventEx
+
+  **/
+EFI_STATUS
+ProcessRecordDrainRegistration (
+  VOID
+  )
+{
+  EFI_EVENT   ExitBootServicesEvent;
+  EFI_STATUS  Status;
+
+  Status = gBS->CreateEvent (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  OnDrainRecords,
+                  NULL,
+                  &mDrainEvent
+                  );
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a - Create Event for draining records. Code = %r\n", __FUNCTION__, Status));
+    mDrainEvent = NULL;
+    goto Cleanup;
+  }
+
+  Status = gBS->CreateEventEx (
+                  EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  OnExitBootServicesNotification,
+                  NULL,
+                  &gEfiEventExitBootServicesGuid,
+                  &ExitBootServicesEvent
+                  );
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a - Create Event Ex for ExitBootServices. Code = %r\n", __FUNCTION__, Status));
+    gBS->CloseEvent (mDrainEvent);
+    mDrainEvent = NULL;
+  }
+
+Cleanup:
+  return Status;
+}
+
 /**
     Main entry point for this driver.
 
@@ -805,13 +1020,18 @@ DebugFileLoggerDxeEntry (
   DEBUG ((DEBUG_INFO, "%a: VII enter...\n", __FUNCTION__));
 
   //
-  // Step 1. Initialize the debug logging buffer.
+  // Step 1. Initialize the debug logging buffer and the status code record ring.
   //
   Status = LoggingBufferInit ();
   if (EFI_ERROR (Status)) {
     goto Exit;
   }
 
+  Status = RecordRingInit ();
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
   //
   // Step 2. Register for file system notifications
   //
@@ -821,8 +1041,13 @@ DebugFileLoggerDxeEntry (
   }
 
   //
-  // Step 3. Register for logging output
+  // Step 3. Register for logging output, and for formatting the captured records
   //
+  Status = ProcessRecordDrainRegistration ();
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
   Status = ProcessRscHandlerRegistration ();
   if (EFI_ERROR (Status)) {
     goto Exit;
@@ -35,6 +35,7 @@
 #include <Library/UefiRuntimeServicesTableLib.h>
 
 #include "../DebugFileLoggerCommon.h"
+#include "LogRecordRing.h"
 
 typedef
 EFI_STATUS
@@ -55,7 +56,9 @@ typedef struct {
   LIST_ENTRY    Link;
   EFI_HANDLE    Handle;
   UINTN         FileIndex;
-  UINT64        CurrentOffset;
+  UINT64        CurrentOffset;      // Bytes of the log file written this boot.
+  UINT64        BufferConsumed;     // Bytes of the logging buffer written or dropped.
+  UINT64        BytesDropped;       // Bytes that did not fit in the log file.
   BOOLEAN       Valid;
 } LOG_DEVICE;
 
@@ -77,9 +80,20 @@ typedef struct {
 #define DEBUG_LOG_CHUNK_SIZE  (EFI_PAGE_SIZE * 16)                                                            // # of pages per write to log (64KB)
 #define DEBUG_LOG_FILE_SIZE   (DEBUG_LOG_CHUNK_SIZE * (FixedPcdGet32(PcdDebugFileLoggerAllocatedPages) / 16)) // # chunks per log file (4MB total)
 
+// Status codes are captured as binary records and formatted into the log buffer at
+// TPL_CALLBACK.  The records are drained once the ring is half full.
+
+#define DEBUG_LOG_RECORD_RING_SIZE  SIZE_256KB
+#define DEBUG_LOG_RECORD_DRAIN_AT   (DEBUG_LOG_RECORD_RING_SIZE / 2)
+
 #define END_OF_FILE_MARKER       "\n\n === END_OF_LOG ===\n\n"
 #define END_OF_FILE_MARKER_SIZE  (sizeof(END_OF_FILE_MARKER) - 1)
 
+// The end of each log file is kept free for a note of how much of the log did not fit.
+
+#define LOG_FULL_MARKER       "\n\n === LOG_FULL, %ld bytes dropped ===\n\n"
+#define LOG_FULL_MARKER_SIZE  64
+
 #define LOG_DIRECTORY_NAME  L"\\Logs"
 
 //
@@ -104,7 +118,7 @@ typedef struct {
 
   @param   LogDevice        Which log device to write the log to
   @param   LogBuffer        The log data to be written
-  @param   LogBufferLength  The number of bytes to write to the log
+  @param   LogBufferLength  The number of bytes in LogBuffer
 
   @retval  EFI_SUCCESS      The log was updated
   @retval  other            An error occurred.  The log device was disabled
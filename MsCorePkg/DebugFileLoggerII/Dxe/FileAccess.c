@@ -459,11 +459,12 @@ DetermineLogFile (
 /**
   WriteALogFIle
 
-  Writes the currently unwritten part of the log file.
+  Writes the currently unwritten part of the log file.  Data that does not fit in
+  the log file is dropped and the number of dropped bytes is noted at the end of it.
 
   @param   LogDevice        Which log device to write the log to
   @param   LogBuffer        The log data to be written
-  @param   LogBufferLength  The number of bytes to write to the log
+  @param   LogBufferLength  The number of bytes in LogBuffer
 
   @retval  EFI_SUCCESS      The log was updated
   @retval  other            An error occurred.  The log device was disabled
@@ -482,6 +483,7 @@ WriteALogFile (
   UINT64      RoomLeft;
   EFI_STATUS  Status;
   EFI_FILE    *Volume;
+  CHAR8       LogFullMarker[LOG_FULL_MARKER_SIZE];
 
   if (!LogDevice->Valid) {
     return EFI_DEVICE_ERROR;
@@ -532,22 +534,22 @@ WriteALogFile (
   // than the existing file size.  We do not want to alter the
   // metadata on the disk (new FAT entries etc).
   //
-  if (LogBufferLength > DEBUG_LOG_FILE_SIZE) {
-    LogBufferLength = DEBUG_LOG_FILE_SIZE;
-  }
-
-  RoomLeft   = DEBUG_LOG_FILE_SIZE - LogDevice->CurrentOffset;
-  BufferSize = LogBufferLength - LogDevice->CurrentOffset;
+  RoomLeft   = DEBUG_LOG_FILE_SIZE - LOG_FULL_MARKER_SIZE - LogDevice->CurrentOffset;
+  BufferSize = LogBufferLength - LogDevice->BufferConsumed;
 
   if (BufferSize > RoomLeft) {
-    BufferSize = RoomLeft;
-    DEBUG ((DEBUG_ERROR, "Log file truncated\n"));
+    if (LogDevice->BytesDropped == 0) {
+      DEBUG ((DEBUG_ERROR, "Log file truncated\n"));
+    }
+
+    LogDevice->BytesDropped += BufferSize - RoomLeft;
+    BufferSize               = RoomLeft;
   }
 
-  RoomLeft -= BufferSize;
+  RoomLeft += LOG_FULL_MARKER_SIZE - BufferSize;
 
   if (BufferSize > 0) {
-    Buffer = &LogBuffer[LogDevice->CurrentOffset];
+    Buffer = &LogBuffer[LogDevice->BufferConsumed];
     Status = File->Write (File, &BufferSize, (VOID *)Buffer);
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "%a: Failed to write to log file: %r !\n", __FUNCTION__, Status));
@@ -557,6 +559,24 @@ WriteALogFile (
     }
 
     LogDevice->CurrentOffset += BufferSize;
+  }
+
+  LogDevice->BufferConsumed = LogBufferLength;
+
+  if (LogDevice->BytesDropped != 0) {
+    //
+    // The log file is full.  Note how much of the log was dropped in the space kept
+    // free at the end of the file.
+    //
+    BufferSize = AsciiSPrint (LogFullMarker, sizeof (LogFullMarker), LOG_FULL_MARKER, LogDevice->BytesDropped);
+    Status     = File->Write (File, &BufferSize, (VOID *)LogFullMarker);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a: Failed to write log full marker: %r !\n", __FUNCTION__, Status));
+      File->Close (File);
+      LogDevice->Valid = FALSE;
+      return Status;
+    }
+  } else if (BufferSize > 0) {
     //
     // Write End Of Buffer file mark.
     //
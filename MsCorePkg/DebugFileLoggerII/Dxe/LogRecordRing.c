@@ -0,0 +1,586 @@
+/** @file LogRecordRing.c
+
+  Copyright (C) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+  Lock-free ring of binary status code records.  See LogRecordRing.h.
+
+**/
+
+#include <PiDxe.h>
+
+#include <Guid/StatusCodeDataTypeDebug.h>
+#include <Guid/StatusCodeDataTypeId.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/PrintLib.h>
+#include <Library/ReportStatusCodeLib.h>
+#include <Library/SynchronizationLib.h>
+
+#include "../DebugFileLoggerCommon.h"
+#include "LogRecordRing.h"
+
+#define RECORD_ALIGN(Size)  ALIGN_VALUE ((Size), 8)
+
+/**
+  Copies a string into the tail of a record, or measures the room it needs.
+
+  @param[in]  String     String to copy.
+  @param[in]  CharSize   Size of a character, 1 or 2.
+  @param[out] Tail       Where to copy the string.  NULL to only measure it.
+  @param[in]  TailSize   Room left at Tail.
+
+  @return  Bytes used at Tail, or needed if Tail is NULL.
+**/
+STATIC
+UINT32
+CopyStringToTail (
+  IN  CONST VOID  *String,
+  IN  UINTN       CharSize,
+  OUT UINT8       *Tail OPTIONAL,
+  IN  UINT32      TailSize
+  )
+{
+  UINTN  Length;
+  UINTN  MaxLength;
+
+  MaxLength = LOG_RECORD_MAX_STRING;
+  if (Tail != NULL) {
+    if (TailSize < CharSize) {
+      return 0;
+    }
+
+    MaxLength = MIN (MaxLength, (TailSize / CharSize) - 1);
+  }
+
+  for (Length = 0; Length < MaxLength; Length++) {
+    if (CharSize == sizeof (CHAR16)) {
+      if (((CONST CHAR16 *)String)[Length] == L'\0') {
+        break;
+      }
+    } else if (((CONST CHAR8 *)String)[Length] == '\0') {
+      break;
+    }
+  }
+
+  if (Tail != NULL) {
+    CopyMem (Tail, String, Length * CharSize);
+    ZeroMem (Tail + Length * CharSize, CharSize);
+  }
+
+  return (UINT32)RECORD_ALIGN ((Length + 1) * CharSize);
+}
+
+/**
+  Walks the packed arguments of a DEBUG() record and copies everything they point to into
+  the tail of the record, or measures the room that needs.
+
+  The walk follows the format string exactly the way the arguments were packed by the
+  ReportStatusCode DebugLib, so every pointer slot is found.  When copying, each pointer slot
+  is rewritten to point at its copy, so the record no longer refers to the reporter's memory.
+
+  @param[in,out] Marker      Packed arguments.  Pointer slots are rewritten when copying.
+  @param[in]     Format      Format string that follows the packed arguments.
+  @param[in]     FormatEnd   End of the status code data holding the format string.
+  @param[out]    Tail        Where to copy the data.  NULL to only measure it.
+  @param[in]     TailSize    Room at Tail.
+
+  @return  Bytes used at Tail, or needed if Tail is NULL.
+**/
+STATIC
+UINT32
+CaptureDebugArguments (
+  IN OUT BASE_LIST    Marker,
+  IN     CONST CHAR8  *Format,
+  IN     CONST CHAR8  *FormatEnd,
+  OUT    UINT8        *Tail OPTIONAL,
+  IN     UINT32       TailSize
+  )
+{
+  UINTN        CopySize;
+  CONST CHAR8  *FormatStart;
+  BOOLEAN      Long;
+  VOID         **Slot;
+  UINT32       Used;
+  UINT32       ItemSize;
+
+  FormatStart = Format;
+  Used        = 0;
+
+  for ( ; (Format < FormatEnd) && (*Format != '\0'); Format++) {
+    if (*Format != '%') {
+      continue;
+    }
+
+    Long = FALSE;
+    for (Format++; Format < FormatEnd; Format++) {
+      if ((*Format == '.') || (*Format == '-') || (*Format == '+') || (*Format == ' ')) {
+        continue;
+      }
+
+      if ((*Format >= '0') && (*Format <= '9')) {
+        continue;
+      }
+
+      if ((*Format == 'L') || (*Format == 'l')) {
+        Long = TRUE;
+        continue;
+      }
+
+      if (*Format == '*') {
+        Marker += _BASE_INT_SIZE_OF (UINTN);
+        continue;
+      }
+
+      break;
+    }
+
+    if ((Format >= FormatEnd) || (*Format == '\0')) {
+      break;
+    }
+
+    if ((*Format == 'p') && (sizeof (VOID *) > 4)) {
+      Long = TRUE;
+    }
+
+    Slot = NULL;
+    if ((*Format == 'p') || (*Format == 'X') || (*Format == 'x') || (*Format == 'd') || (*Format == 'u')) {
+      Marker += Long ? _BASE_INT_SIZE_OF (INT64) : _BASE_INT_SIZE_OF (int);
+    } else if ((*Format == 's') || (*Format == 'S') || (*Format == 'a') || (*Format == 'g') || (*Format == 't')) {
+      Slot = &BASE_ARG (Marker, VOID *);
+    } else if (*Format == 'c') {
+      Marker += _BASE_INT_SIZE_OF (UINTN);
+    } else if (*Format == 'r') {
+      Marker += _BASE_INT_SIZE_OF (RETURN_STATUS);
+    }
+
+    //
+    // The packer drops the record if the arguments run into the format string, so
+    // there is nothing valid past this point.
+    //
+    if ((CONST CHAR8 *)Marker > FormatStart) {
+      break;
+    }
+
+    if ((Slot == NULL) || (*Slot == NULL)) {
+      continue;
+    }
+
+    if (*Format == 'a') {
+      ItemSize = CopyStringToTail (*Slot, sizeof (CHAR8), (Tail == NULL) ? NULL : Tail + Used, TailSize - Used);
+    } else if ((*Format == 's') || (*Format == 'S')) {
+      ItemSize = CopyStringToTail (*Slot, sizeof (CHAR16), (Tail == NULL) ? NULL : Tail + Used, TailSize - Used);
+    } else {
+      CopySize = (*Format == 'g') ? sizeof (EFI_GUID) : sizeof (EFI_TIME);
+      ItemSize = (UINT32)RECORD_ALIGN (CopySize);
+      if (Tail != NULL) {
+        if (ItemSize > TailSize - Used) {
+          //
+          // Only possible if the data changed since it was measured.  Drop the argument
+          // rather than point outside the record.
+          //
+          *Slot = NULL;
+          continue;
+        }
+
+        CopyMem (Tail + Used, *Slot, CopySize);
+      }
+    }
+
+    if (Tail != NULL) {
+      if (ItemSize == 0) {
+        *Slot = NULL;
+        continue;
+      }
+
+      *Slot = Tail + Used;
+    }
+
+    Used += ItemSize;
+  }
+
+  return Used;
+}
+
+/**
+  Initializes a record ring.
+
+  @param[out] Ring    Ring to initialize.
+  @param[in]  Buffer  Backing storage.
+  @param[in]  Size    Size of Buffer.  Must be a power of two.
+
+  @retval EFI_SUCCESS            The ring is empty and ready.
+  @retval EFI_INVALID_PARAMETER  A parameter is NULL, or Size is not a power of two or too small.
+**/
+EFI_STATUS
+LogRecordRingInit (
+  OUT LOG_RECORD_RING  *Ring,
+  IN  VOID             *Buffer,
+  IN  UINT32           Size
+  )
+{
+  if ((Ring == NULL) || (Buffer == NULL) || (((UINTN)Buffer & 7) != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((Size < 2 * sizeof (LOG_RECORD)) || ((Size & (Size - 1)) != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Released space is always zero, so a record that is reserved but not yet committed
+  // can never look committed to the consumer.
+  //
+  ZeroMem (Buffer, Size);
+  ZeroMem (Ring, sizeof (LOG_RECORD_RING));
+  Ring->Buffer = Buffer;
+  Ring->Size   = Size;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Returns the number of bytes reserved and not yet released.
+
+  @param[in] Ring  Ring to check.
+**/
+UINT32
+LogRecordRingUsed (
+  IN LOG_RECORD_RING  *Ring
+  )
+{
+  return Ring->Reserved - Ring->Consumed;
+}
+
+/**
+  Reserves space for a record.  Safe to call while another reservation is being filled.
+
+  @param[in] Ring  Ring to reserve in.
+  @param[in] Size  Bytes needed, header included.
+
+  @return  The record, with Size set and all other fields zero, or NULL if the ring is full.
+           The record must be committed with LogRecordCommit.
+**/
+LOG_RECORD *
+LogRecordReserve (
+  IN LOG_RECORD_RING  *Ring,
+  IN UINT32           Size
+  )
+{
+  UINT32      Head;
+  UINT32      Tail;
+  UINT32      Offset;
+  UINT32      Padding;
+  LOG_RECORD  *Record;
+
+  Size = (UINT32)RECORD_ALIGN (MAX (Size, sizeof (LOG_RECORD)));
+  if (Size > Ring->Size / 2) {
+    return NULL;
+  }
+
+  do {
+    Head   = Ring->Reserved;
+    Tail   = Ring->Consumed;
+    Offset = Head & (Ring->Size - 1);
+
+    //
+    // Records never wrap.  If this one does not fit before the end of the buffer, the
+    // rest of the buffer is filled with a padding record and this one starts over at 0.
+    //
+    Padding = 0;
+    if (Size > Ring->Size - Offset) {
+      Padding = Ring->Size - Offset;
+    }
+
+    if ((Head - Tail) + Padding + Size > Ring->Size) {
+      return NULL;
+    }
+  } while (InterlockedCompareExchange32 ((UINT32 *)&Ring->Reserved, Head, Head + Padding + Size) != Head);
+
+  if (Padding != 0) {
+    Record       = (LOG_RECORD *)(Ring->Buffer + Offset);
+    Record->Size = Padding;
+    MemoryFence ();
+    Record->Flags = LOG_RECORD_PADDING | LOG_RECORD_COMMITTED;
+    Offset        = 0;
+  }
+
+  Record       = (LOG_RECORD *)(Ring->Buffer + Offset);
+  Record->Size = Size;
+  return Record;
+}
+
+/**
+  Publishes a reserved record to the consumer.
+
+  @param[in] Ring    Ring the record was reserved in.
+  @param[in] Record  Record to publish.
+**/
+VOID
+LogRecordCommit (
+  IN LOG_RECORD_RING  *Ring,
+  IN LOG_RECORD       *Record
+  )
+{
+  MemoryFence ();
+  Record->Flags |= LOG_RECORD_COMMITTED;
+  MemoryFence ();
+}
+
+/**
+  Stores a status code report in the ring.
+
+  @param[in] Ring      Ring to store the report in.
+  @param[in] CodeType  Indicates the type of status code being reported.
+  @param[in] Value     Describes the current status of a hardware or software entity.
+  @param[in] Instance  The enumeration of a hardware or software entity within the system.
+  @param[in] CallerId  This optional parameter may be used to identify the caller.
+  @param[in] Data      This optional parameter may be used to pass additional data.
+
+  @retval EFI_SUCCESS           The report was stored.
+  @retval EFI_OUT_OF_RESOURCES  The ring is full or nesting is too deep.  The report was counted as lost.
+**/
+EFI_STATUS
+LogRecordCapture (
+  IN LOG_RECORD_RING             *Ring,
+  IN EFI_STATUS_CODE_TYPE        CodeType,
+  IN EFI_STATUS_CODE_VALUE       Value,
+  IN UINT32                      Instance,
+  IN CONST EFI_GUID              *CallerId OPTIONAL,
+  IN CONST EFI_STATUS_CODE_DATA  *Data OPTIONAL
+  )
+{
+  UINT32                       DataSize;
+  UINT32                       Depth;
+  EFI_STATUS_CODE_DATA         *DataCopy;
+  UINT32                       ErrorLevel;
+  UINT32                       Extra;
+  CHAR8                        *Format;
+  BASE_LIST                    Marker;
+  LOG_RECORD                   *Record;
+  EFI_STATUS                   Status;
+  EFI_STATUS_CODE_STRING_DATA  *StringData;
+  UINT8                        *Tail;
+  BOOLEAN                      Truncated;
+
+  Status = EFI_SUCCESS;
+  Depth  = InterlockedIncrement ((UINT32 *)&Ring->Depth);
+  if (Depth > LOG_RECORD_MAX_NESTING) {
+    InterlockedIncrement ((UINT32 *)&Ring->Lost);
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  if (Depth > Ring->MaxDepth) {
+    Ring->MaxDepth = Depth;
+  }
+
+  //
+  // Measure the record.
+  //
+  DataSize  = 0;
+  Extra     = 0;
+  Truncated = FALSE;
+  if (Data != NULL) {
+    DataSize = MAX (Data->HeaderSize, sizeof (EFI_STATUS_CODE_DATA)) + Data->Size;
+    if (DataSize > LOG_RECORD_MAX_DATA) {
+      DataSize  = sizeof (EFI_STATUS_CODE_DATA);
+      Truncated = TRUE;
+    } else if (ReportStatusCodeExtractDebugInfo (Data, &ErrorLevel, &Marker, &Format)) {
+      Extra = CaptureDebugArguments (Marker, Format, (CONST CHAR8 *)Data + DataSize, NULL, 0);
+    } else if ((DataSize >= sizeof (EFI_STATUS_CODE_STRING_DATA)) &&
+               CompareGuid (&Data->Type, &gEfiStatusCodeDataTypeStringGuid) &&
+               (((EFI_STATUS_CODE_STRING_DATA *)Data)->StringType == EfiStringAscii) &&
+               (((EFI_STATUS_CODE_STRING_DATA *)Data)->String.Ascii != NULL))
+    {
+      Extra = CopyStringToTail (((EFI_STATUS_CODE_STRING_DATA *)Data)->String.Ascii, sizeof (CHAR8), NULL, 0);
+    }
+  }
+
+  Record = LogRecordReserve (Ring, (UINT32)(sizeof (LOG_RECORD) + RECORD_ALIGN (DataSize) + Extra));
+  if (Record == NULL) {
+    InterlockedIncrement ((UINT32 *)&Ring->Lost);
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  Record->LostBefore = LogRecordRingTakeLost (Ring);
+  Record->Instance   = Instance;
+  Record->CodeType   = CodeType;
+  Record->Value      = Value;
+  Record->DataSize   = DataSize;
+  if (CallerId != NULL) {
+    CopyGuid (&Record->CallerId, CallerId);
+    Record->Flags |= LOG_RECORD_HAS_CALLER_ID;
+  }
+
+  //
+  // Copy the data, then everything it points to, and point it at the copies.
+  //
+  if (Data != NULL) {
+    DataCopy = (EFI_STATUS_CODE_DATA *)(Record + 1);
+    Tail     = (UINT8 *)DataCopy + RECORD_ALIGN (DataSize);
+    CopyMem (DataCopy, Data, DataSize);
+    if (Truncated) {
+      DataCopy->HeaderSize = sizeof (EFI_STATUS_CODE_DATA);
+      DataCopy->Size       = 0;
+      ZeroMem (&DataCopy->Type, sizeof (EFI_GUID));
+    } else if (ReportStatusCodeExtractDebugInfo (DataCopy, &ErrorLevel, &Marker, &Format)) {
+      CaptureDebugArguments (Marker, Format, (CONST CHAR8 *)DataCopy + DataSize, Tail, Extra);
+    } else if (Extra != 0) {
+      StringData = (EFI_STATUS_CODE_STRING_DATA *)DataCopy;
+      if (CopyStringToTail (StringData->String.Ascii, sizeof (CHAR8), Tail, Extra) != 0) {
+        StringData->String.Ascii = (CHAR8 *)Tail;
+      } else {
+        StringData->String.Ascii = "";
+      }
+    }
+  }
+
+  LogRecordCommit (Ring, Record);
+
+Exit:
+  InterlockedDecrement ((UINT32 *)&Ring->Depth);
+  return Status;
+}
+
+/**
+  Returns the oldest committed record without removing it.  Called only by the consumer.
+
+  @param[in] Ring  Ring to read.
+
+  @return  The record, or NULL if the ring is empty or the oldest record is not committed yet.
+**/
+LOG_RECORD *
+LogRecordRingPeek (
+  IN LOG_RECORD_RING  *Ring
+  )
+{
+  UINT32      Tail;
+  LOG_RECORD  *Record;
+
+  for ( ; ;) {
+    Tail = Ring->Consumed;
+    if (Tail == Ring->Reserved) {
+      return NULL;
+    }
+
+    Record = (LOG_RECORD *)(Ring->Buffer + (Tail & (Ring->Size - 1)));
+    if ((*(volatile UINT32 *)&Record->Flags & LOG_RECORD_COMMITTED) == 0) {
+      //
+      // Still being filled in, possibly by a report this one interrupted.  Records
+      // after it wait so the log stays in order.
+      //
+      return NULL;
+    }
+
+    MemoryFence ();
+    if ((Record->Flags & LOG_RECORD_PADDING) == 0) {
+      return Record;
+    }
+
+    LogRecordRingRelease (Ring, Record);
+  }
+}
+
+/**
+  Releases the record returned by LogRecordRingPeek.
+
+  @param[in] Ring    Ring the record belongs to.
+  @param[in] Record  Record to release.
+**/
+VOID
+LogRecordRingRelease (
+  IN LOG_RECORD_RING  *Ring,
+  IN LOG_RECORD       *Record
+  )
+{
+  UINT32  Size;
+
+  Size = Record->Size;
+  ZeroMem (Record, Size);
+  MemoryFence ();
+  Ring->Consumed += Size;
+}
+
+/**
+  Takes the count of dropped records that no record has carried yet.
+
+  @param[in] Ring  Ring to check.
+
+  @return  Records dropped since the newest record.
+**/
+UINT32
+LogRecordRingTakeLost (
+  IN LOG_RECORD_RING  *Ring
+  )
+{
+  UINT32  Lost;
+
+  do {
+    Lost = Ring->Lost;
+  } while ((Lost != 0) && (InterlockedCompareExchange32 ((UINT32 *)&Ring->Lost, Lost, 0) != Lost));
+
+  return Lost;
+}
+
+/**
+  Formats the notice for records that were lost.
+
+  @param[in]  Lost        Number of records lost.
+  @param[out] Buffer      Receives the text.
+  @param[in]  BufferSize  Size of Buffer.
+
+  @return  Number of characters written, excluding the NULL terminator.
+**/
+UINTN
+LogRecordFormatLost (
+  IN  UINT32  Lost,
+  OUT CHAR8   *Buffer,
+  IN  UINTN   BufferSize
+  )
+{
+  return AsciiSPrint (Buffer, BufferSize, "*** %u status codes lost ***\r\n", Lost);
+}
+
+/**
+  Formats a record as ASCII text, the same way the report would have been written when it
+  was made.  A notice is written first if records were lost before this one.
+
+  @param[in]  Record      Record to format.
+  @param[out] Buffer      Receives the text.
+  @param[in]  BufferSize  Size of Buffer.  At least LOG_RECORD_MAX_TEXT.
+
+  @return  Number of characters written, excluding the NULL terminator.
+**/
+UINTN
+LogRecordFormat (
+  IN  LOG_RECORD  *Record,
+  OUT CHAR8       *Buffer,
+  IN  UINTN       BufferSize
+  )
+{
+  UINTN  CharCount;
+
+  CharCount = 0;
+  if (Record->LostBefore != 0) {
+    CharCount = LogRecordFormatLost (Record->LostBefore, Buffer, BufferSize);
+  }
+
+  if (BufferSize <= CharCount + 1) {
+    return CharCount;
+  }
+
+  CharCount += WriteStatusCodeToBuffer (
+                 Record->CodeType,
+                 Record->Value,
+                 Record->Instance,
+                 ((Record->Flags & LOG_RECORD_HAS_CALLER_ID) != 0) ? &Record->CallerId : NULL,
+                 (Record->DataSize != 0) ? (EFI_STATUS_CODE_DATA *)(Record + 1) : NULL,
+                 &Buffer[CharCount],
+                 MIN (BufferSize - CharCount, EFI_STATUS_CODE_DATA_MAX_SIZE)
+                 );
+
+  return CharCount;
+}
@@ -0,0 +1,224 @@
+/** @file LogRecordRing.h
+
+  Copyright (C) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+  Lock-free ring of binary status code records.
+
+  The status code handler runs at whatever TPL the report was made at, and a report can
+  arrive while another one is still being captured.  Instead of formatting text in the
+  handler, each report is stored as a compact binary record: the code, value, instance and
+  caller, plus a copy of the status code data.  For DEBUG() records the copy holds the
+  format string and the packed argument list, and any string, GUID or time the arguments
+  point to is copied into the record as well, so the record can be formatted later at
+  TPL_CALLBACK.
+
+  Space is reserved with a compare-exchange on the producer counter, so every nesting
+  level gets its own record and a report that interrupts another one is never dropped.
+  A record only becomes visible to the consumer once it has been committed.  Records that
+  do not fit are counted, and the count is carried by the next record that does.
+
+**/
+
+#ifndef _LOG_RECORD_RING_H
+#define _LOG_RECORD_RING_H
+
+#include <Pi/PiStatusCode.h>
+
+//
+// Largest copy of status code data kept in a record.  Larger data keeps only its header.
+//
+#define LOG_RECORD_MAX_DATA  512
+
+//
+// Longest string argument copied into a record, in characters.  A formatted record never
+// shows more than this, so the copy is always enough to reproduce the text.
+//
+#define LOG_RECORD_MAX_STRING  EFI_STATUS_CODE_DATA_MAX_SIZE
+
+//
+// Deepest nesting of reports that is captured.
+//
+#define LOG_RECORD_MAX_NESTING  8
+
+//
+// Text LogRecordFormat can produce for one record, lost record notice included.
+//
+#define LOG_RECORD_MAX_TEXT  (EFI_STATUS_CODE_DATA_MAX_SIZE + 64)
+
+#define LOG_RECORD_COMMITTED       BIT0     // The record is complete.
+#define LOG_RECORD_PADDING         BIT1     // Filler up to the end of the ring.  Carries no data.
+#define LOG_RECORD_HAS_CALLER_ID   BIT2     // CallerId is valid.
+
+//
+// Only Size and Flags are valid in a padding record, which may be as small as 8 bytes.
+//
+typedef struct {
+  UINT32                   Size;            // Bytes in the record, header included.  Multiple of 8.
+  UINT32                   Flags;
+  UINT32                   LostBefore;      // Records dropped since the previous record.
+  UINT32                   Instance;
+  EFI_STATUS_CODE_TYPE     CodeType;
+  EFI_STATUS_CODE_VALUE    Value;
+  EFI_GUID                 CallerId;
+  UINT32                   DataSize;        // Bytes of EFI_STATUS_CODE_DATA following the header.  0 if none.
+  UINT32                   Reserved;
+} LOG_RECORD;
+
+typedef struct {
+  UINT8              *Buffer;
+  UINT32             Size;                  // Power of two.
+  volatile UINT32    Reserved;              // Bytes ever reserved by producers.
+  volatile UINT32    Consumed;              // Bytes ever released by the consumer.
+  volatile UINT32    Lost;                  // Records dropped and not yet carried by a record.
+  volatile UINT32    Depth;                 // Captures in progress.
+  UINT32             MaxDepth;              // Deepest nesting seen.
+} LOG_RECORD_RING;
+
+/**
+  Initializes a record ring.
+
+  @param[out] Ring    Ring to initialize.
+  @param[in]  Buffer  Backing storage.
+  @param[in]  Size    Size of Buffer.  Must be a power of two.
+
+  @retval EFI_SUCCESS            The ring is empty and ready.
+  @retval EFI_INVALID_PARAMETER  A parameter is NULL, or Size is not a power of two or too small.
+**/
+EFI_STATUS
+LogRecordRingInit (
+  OUT LOG_RECORD_RING  *Ring,
+  IN  VOID             *Buffer,
+  IN  UINT32           Size
+  );
+
+/**
+  Returns the number of bytes reserved and not yet released.
+
+  @param[in] Ring  Ring to check.
+**/
+UINT32
+LogRecordRingUsed (
+  IN LOG_RECORD_RING  *Ring
+  );
+
+/**
+  Reserves space for a record.  Safe to call while another reservation is being filled.
+
+  @param[in] Ring  Ring to reserve in.
+  @param[in] Size  Bytes needed, header included.
+
+  @return  The record, with Size set and all other fields zero, or NULL if the ring is full.
+           The record must be committed with LogRecordCommit.
+**/
+LOG_RECORD *
+LogRecordReserve (
+  IN LOG_RECORD_RING  *Ring,
+  IN UINT32           Size
+  );
+
+/**
+  Publishes a reserved record to the consumer.
+
+  @param[in] Ring    Ring the record was reserved in.
+  @param[in] Record  Record to publish.
+**/
+VOID
+LogRecordCommit (
+  IN LOG_RECORD_RING  *Ring,
+  IN LOG_RECORD       *Record
+  );
+
+/**
+  Stores a status code report in the ring.
+
+  @param[in] Ring      Ring to store the report in.
+  @param[in] CodeType  Indicates the type of status code being reported.
+  @param[in] Value     Describes the current status of a hardware or software entity.
+  @param[in] Instance  The enumeration of a hardware or software entity within the system.
+  @param[in] CallerId  This optional parameter may be used to identify the caller.
+  @param[in] Data      This optional parameter may be used to pass additional data.
+
+  @retval EFI_SUCCESS           The report was stored.
+  @retval EFI_OUT_OF_RESOURCES  The ring is full or nesting is too deep.  The report was counted as lost.
+**/
+EFI_STATUS
+LogRecordCapture (
+  IN LOG_RECORD_RING             *Ring,
+  IN EFI_STATUS_CODE_TYPE        CodeType,
+  IN EFI_STATUS_CODE_VALUE       Value,
+  IN UINT32                      Instance,
+  IN CONST EFI_GUID              *CallerId OPTIONAL,
+  IN CONST EFI_STATUS_CODE_DATA  *Data OPTIONAL
+  );
+
+/**
+  Returns the oldest committed record without removing it.  Called only by the consumer.
+
+  @param[in] Ring  Ring to read.
+
+  @return  The record, or NULL if the ring is empty or the oldest record is not committed yet.
+**/
+LOG_RECORD *
+LogRecordRingPeek (
+  IN LOG_RECORD_RING  *Ring
+  );
+
+/**
+  Releases the record returned by LogRecordRingPeek.
+
+  @param[in] Ring    Ring the record belongs to.
+  @param[in] Record  Record to release.
+**/
+VOID
+LogRecordRingRelease (
+  IN LOG_RECORD_RING  *Ring,
+  IN LOG_RECORD       *Record
+  );
+
+/**
+  Takes the count of dropped records that no record has carried yet.
+
+  @param[in] Ring  Ring to check.
+
+  @return  Records dropped since the newest record.
+**/
+UINT32
+LogRecordRingTakeLost (
+  IN LOG_RECORD_RING  *Ring
+  );
+
+/**
+  Formats a record as ASCII text, the same way the report would have been written when it
+  was made.  A notice is written first if records were lost before this one.
+
+  @param[in]  Record      Record to format.
+  @param[out] Buffer      Receives the text.
+  @param[in]  BufferSize  Size of Buffer.  At least LOG_RECORD_MAX_TEXT.
+
+  @return  Number of characters written, excluding the NULL terminator.
+**/
+UINTN
+LogRecordFormat (
+  IN  LOG_RECORD  *Record,
+  OUT CHAR8       *Buffer,
+  IN  UINTN       BufferSize
+  );
+
+/**
+  Formats the notice for records that were lost.
+
+  @param[in]  Lost        Number of records lost.
+  @param[out] Buffer      Receives the text.
+  @param[in]  BufferSize  Size of Buffer.
+
+  @return  Number of characters written, excluding the NULL terminator.
+**/
+UINTN
+LogRecordFormatLost (
+  IN  UINT32  Lost,
+  OUT CHAR8   *Buffer,
+  IN  UINTN   BufferSize
+  );
+
+#endif // _LOG_RECORD_RING_H
@@ -0,0 +1,887 @@
+/** @file
+  Host based unit tests for the DebugFileLoggerII status code record ring.
+
+  Status codes are packed the way the ReportStatusCode DebugLib packs DEBUG() output, captured
+  into the ring, and formatted later.  The text is compared with what WriteStatusCodeToBuffer
+  produces when the report is formatted right away, after everything the report pointed to
+  has been overwritten.  Interrupted captures are simulated with the reserve and commit steps
+  of the capture, and small rings are used to run the ring out of space.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <PiDxe.h>
+#include <Guid/StatusCodeDataTypeDebug.h>
+#include <Guid/StatusCodeDataTypeId.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include <Library/ReportStatusCodeLib.h>
+#include <Library/UnitTestLib.h>
+#include "../../DebugFileLoggerCommon.h"
+#include "../LogRecordRing.h"
+
+#define UNIT_TEST_NAME     "DebugFileLoggerII Record Ring Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define TEST_RING_SIZE        SIZE_256KB
+#define SMALL_RING_SIZE       SIZE_4KB
+#define TINY_RING_SIZE        SIZE_1KB
+#define EXHAUSTION_REPORTS    1000
+#define DRAINED_REPORTS       20000
+#define TEXT_BUFFER_SIZE      SIZE_4MB
+#define DEBUG_ARGUMENT_SLOTS  12
+
+//
+// Status code data as ReportStatusCodeEx hands it to the handler.  UINT64 keeps the packed
+// arguments aligned.
+//
+typedef struct {
+  UINT64    Storage[LOG_RECORD_MAX_DATA / sizeof (UINT64)];
+} TEST_DATA;
+
+typedef struct {
+  VOID               *RingBuffer;
+  LOG_RECORD_RING    Ring;
+  CHAR8              *Text;
+  UINTN              TextLength;
+  CHAR8              *Expected;
+  UINTN              ExpectedLength;
+} TEST_CONTEXT;
+
+STATIC TEST_CONTEXT  mTest;
+STATIC UINT32        mRandomState;
+
+STATIC CONST EFI_GUID  mTestCallerId = {
+  0x6b0f1ae2, 0x3c0d, 0x4b5e, { 0x9a, 0x51, 0x2e, 0x7c, 0x11, 0x84, 0x0f, 0x3d }
+};
+
+STATIC CONST EFI_GUID  mTestDataType = {
+  0x0d8d4b61, 0x52a9, 0x4e0c, { 0x84, 0x1e, 0x6f, 0x9b, 0x22, 0x35, 0xc7, 0x10 }
+};
+
+/**
+  Stands in for ReportStatusCodeLib.  Same as the DXE instance.
+**/
+BOOLEAN
+EFIAPI
+ReportStatusCodeExtractAssertInfo (
+  IN EFI_STATUS_CODE_TYPE        CodeType,
+  IN EFI_STATUS_CODE_VALUE       Value,
+  IN CONST EFI_STATUS_CODE_DATA  *Data,
+  OUT CHAR8                      **Filename,
+  OUT CHAR8                      **Description,
+  OUT UINT32                     *LineNumber
+  )
+{
+  EFI_DEBUG_ASSERT_DATA  *AssertData;
+
+  if (((CodeType & EFI_STATUS_CODE_TYPE_MASK) == EFI_ERROR_CODE) &&
+      ((CodeType & EFI_STATUS_CODE_SEVERITY_MASK) == EFI_ERROR_UNRECOVERED) &&
+      ((Value & EFI_STATUS_CODE_OPERATION_MASK) == EFI_SW_EC_ILLEGAL_SOFTWARE_STATE))
+  {
+    AssertData   = (EFI_DEBUG_ASSERT_DATA *)(Data + 1);
+    *Filename    = (CHAR8 *)(AssertData + 1);
+    *Description = *Filename + AsciiStrLen (*Filename) + 1;
+    *LineNumber  = AssertData->LineNumber;
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/**
+  Stands in for ReportStatusCodeLib.  Same as the DXE instance.
+**/
+BOOLEAN
+EFIAPI
+ReportStatusCodeExtractDebugInfo (
+  IN CONST EFI_STATUS_CODE_DATA  *Data,
+  OUT UINT32                     *ErrorLevel,
+  OUT BASE_LIST                  *Marker,
+  OUT CHAR8                      **Format
+  )
+{
+  EFI_DEBUG_INFO  *DebugInfo;
+
+  if (!CompareGuid (&Data->Type, &gEfiStatusCodeDataTypeDebugGuid)) {
+    return FALSE;
+  }
+
+  DebugInfo   = (EFI_DEBUG_INFO *)(Data + 1);
+  *ErrorLevel = DebugInfo->ErrorLevel;
+  *Marker     = (BASE_LIST)(DebugInfo + 1);
+  *Format     = (CHAR8 *)(((UINT64 *)*Marker) + DEBUG_ARGUMENT_SLOTS);
+  return TRUE;
+}
+
+/**
+  Deterministic pseudo random numbers so that failures reproduce.
+**/
+STATIC
+UINT32
+NextRandom (
+  VOID
+  )
+{
+  mRandomState = mRandomState * 1103515245 + 12345;
+  return (mRandomState >> 8) & 0xFFFFFF;
+}
+
+/**
+  Packs a DEBUG() report the way the ReportStatusCode DebugLib does.
+
+  @return  The status code data, or NULL if the arguments do not fit.
+**/
+STATIC
+EFI_STATUS_CODE_DATA *
+PackDebugData (
+  OUT TEST_DATA    *Data,
+  IN  CONST CHAR8  *Format,
+  ...
+  )
+{
+  EFI_STATUS_CODE_DATA  *Header;
+  EFI_DEBUG_INFO        *DebugInfo;
+  BASE_LIST             BaseListMarker;
+  CHAR8                 *FormatString;
+  VA_LIST               VaListMarker;
+  BOOLEAN               Long;
+
+  ZeroMem (Data, sizeof (TEST_DATA));
+  Header                = (EFI_STATUS_CODE_DATA *)Data->Storage;
+  DebugInfo             = (EFI_DEBUG_INFO *)(Header + 1);
+  BaseListMarker        = (BASE_LIST)(DebugInfo + 1);
+  FormatString          = (CHAR8 *)((UINT64 *)(DebugInfo + 1) + DEBUG_ARGUMENT_SLOTS);
+  DebugInfo->ErrorLevel = DEBUG_INFO;
+
+  if ((FormatString + AsciiStrSize (Format)) - (CHAR8 *)DebugInfo > EFI_STATUS_CODE_DATA_MAX_SIZE) {
+    return NULL;
+  }
+
+  Header->HeaderSize = sizeof (EFI_STATUS_CODE_DATA);
+  Header->Size       = (UINT16)((FormatString + AsciiStrSize (Format)) - (CHAR8 *)DebugInfo);
+  CopyGuid (&Header->Type, &gEfiStatusCodeDataTypeDebugGuid);
+  CopyMem (FormatString, Format, AsciiStrSize (Format));
+
+  VA_START (VaListMarker, Format);
+  for ( ; *Format != '\0'; Format++) {
+    if (*Format != '%') {
+      continue;
+    }
+
+    Long = FALSE;
+    for (Format++; TRUE; Format++) {
+      if ((*Format == '.') || (*Format == '-') || (*Format == '+') || (*Format == ' ')) {
+        continue;
+      }
+
+      if ((*Format >= '0') && (*Format <= '9')) {
+        continue;
+      }
+
+      if ((*Format == 'L') || (*Format == 'l')) {
+        Long = TRUE;
+        continue;
+      }
+
+      if (*Format == '*') {
+        BASE_ARG (BaseListMarker, UINTN) = VA_ARG (VaListMarker, UINTN);
+        continue;
+      }
+
+      if (*Format == '\0') {
+        Format--;
+      }
+
+      break;
+    }
+
+    if ((*Format == 'p') && (sizeof (VOID *) > 4)) {
+      Long = TRUE;
+    }
+
+    if ((*Format == 'p') || (*Format == 'X') || (*Format == 'x') || (*Format == 'd') || (*Format == 'u')) {
+      if (Long) {
+        BASE_ARG (BaseListMarker, INT64) = VA_ARG (VaListMarker, INT64);
+      } else {
+        BASE_ARG (BaseListMarker, int) = VA_ARG (VaListMarker, int);
+      }
+    } else if ((*Format == 's') || (*Format == 'S') || (*Format == 'a') || (*Format == 'g') || (*Format == 't')) {
+      BASE_ARG (BaseListMarker, VOID *) = VA_ARG (VaListMarker, VOID *);
+    } else if (*Format == 'c') {
+      BASE_ARG (BaseListMarker, UINTN) = VA_ARG (VaListMarker, UINTN);
+    } else if (*Format == 'r') {
+      BASE_ARG (BaseListMarker, RETURN_STATUS) = VA_ARG (VaListMarker, RETURN_STATUS);
+    }
+
+    if ((CHAR8 *)BaseListMarker > FormatString) {
+      VA_END (VaListMarker);
+      return NULL;
+    }
+  }
+
+  VA_END (VaListMarker);
+  return Header;
+}
+
+/**
+  Appends text to a growing buffer.
+**/
+STATIC
+VOID
+AppendText (
+  IN OUT CHAR8        *Text,
+  IN OUT UINTN        *Length,
+  IN     CONST CHAR8  *Source,
+  IN     UINTN        SourceLength
+  )
+{
+  ASSERT (*Length + SourceLength < TEXT_BUFFER_SIZE);
+  CopyMem (Text + *Length, Source, SourceLength);
+  *Length      += SourceLength;
+  Text[*Length] = '\0';
+}
+
+/**
+  Formats the pending records into mTest.Text, the way the driver does.
+
+  @param[in] TakeLost  Also write the count of lost records no record has carried.
+
+  @return  Number of records formatted.
+**/
+STATIC
+UINTN
+DrainRing (
+  IN BOOLEAN  TakeLost
+  )
+{
+  LOG_RECORD  *Record;
+  CHAR8       Line[LOG_RECORD_MAX_TEXT];
+  UINTN       Count;
+  UINT32      Lost;
+
+  Count = 0;
+  for ( ; ;) {
+    Record = LogRecordRingPeek (&mTest.Ring);
+    if (Record == NULL) {
+      break;
+    }
+
+    AppendText (mTest.Text, &mTest.TextLength, Line, LogRecordFormat (Record, Line, sizeof (Line)));
+    LogRecordRingRelease (&mTest.Ring, Record);
+    Count++;
+  }
+
+  if (TakeLost) {
+    Lost = LogRecordRingTakeLost (&mTest.Ring);
+    if (Lost != 0) {
+      AppendText (mTest.Text, &mTest.TextLength, Line, LogRecordFormatLost (Lost, Line, sizeof (Line)));
+    }
+  }
+
+  return Count;
+}
+
+/**
+  Formats a report right away and appends it to mTest.Expected.
+**/
+STATIC
+VOID
+ExpectReport (
+  IN EFI_STATUS_CODE_TYPE        CodeType,
+  IN EFI_STATUS_CODE_VALUE       Value,
+  IN CONST EFI_GUID              *CallerId OPTIONAL,
+  IN CONST EFI_STATUS_CODE_DATA  *Data OPTIONAL
+  )
+{
+  CHAR8  Line[EFI_STATUS_CODE_DATA_MAX_SIZE];
+  UINTN  Length;
+
+  Length = WriteStatusCodeToBuffer (CodeType, Value, 0, CallerId, Data, Line, sizeof (Line));
+  AppendText (mTest.Expected, &mTest.ExpectedLength, Line, Length);
+}
+
+/**
+  Returns TRUE if every byte of the ring buffer is zero.
+**/
+STATIC
+BOOLEAN
+RingIsClean (
+  VOID
+  )
+{
+  UINT32  Index;
+
+  for (Index = 0; Index < mTest.Ring.Size; Index++) {
+    if (((UINT8 *)mTest.RingBuffer)[Index] != 0) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Allocates a ring of the given size and empty text buffers.
+**/
+STATIC
+UNIT_TEST_STATUS
+SetUpRing (
+  IN UINT32  Size
+  )
+{
+  mRandomState     = 0x1D2C3B4A;
+  mTest.RingBuffer = AllocatePages (EFI_SIZE_TO_PAGES (Size));
+  mTest.Text       = AllocatePool (TEXT_BUFFER_SIZE);
+  mTest.Expected   = AllocatePool (TEXT_BUFFER_SIZE);
+  if ((mTest.RingBuffer == NULL) || (mTest.Text == NULL) || (mTest.Expected == NULL)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  mTest.Text[0]        = '\0';
+  mTest.Expected[0]    = '\0';
+  mTest.TextLength     = 0;
+  mTest.ExpectedLength = 0;
+
+  if (EFI_ERROR (LogRecordRingInit (&mTest.Ring, mTest.RingBuffer, Size))) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetUpLargeRing (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return SetUpRing (TEST_RING_SIZE);
+}
+
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetUpSmallRing (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return SetUpRing (SMALL_RING_SIZE);
+}
+
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetUpTinyRing (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return SetUpRing (TINY_RING_SIZE);
+}
+
+STATIC
+VOID
+EFIAPI
+TearDownRing (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mTest.RingBuffer != NULL) {
+    FreePages (mTest.RingBuffer, EFI_SIZE_TO_PAGES (mTest.Ring.Size));
+  }
+
+  if (mTest.Text != NULL) {
+    FreePool (mTest.Text);
+  }
+
+  if (mTest.Expected != NULL) {
+    FreePool (mTest.Expected);
+  }
+
+  ZeroMem (&mTest, sizeof (mTest));
+}
+
+/**
+  Every kind of report formats the same later as it would have right away, even though
+  everything it pointed to was overwritten after the capture.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DeferredFormatMatchesImmediate (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_DATA                    Data[8];
+  EFI_STATUS_CODE_DATA         *Reports[8];
+  CHAR8                        Name[32];
+  CHAR8                        Long[300];
+  CHAR16                       Wide[16];
+  EFI_GUID                     Guid;
+  EFI_TIME                     Time;
+  EFI_STATUS_CODE_STRING_DATA  *StringData;
+  CHAR8                        StringText[40];
+  EFI_STATUS_CODE_DATA         *AssertHeader;
+  EFI_DEBUG_ASSERT_DATA        *AssertData;
+  EFI_STATUS_CODE_DATA         *BigData;
+  UINTN                        Index;
+  EFI_STATUS                   Status;
+
+  AsciiStrCpyS (Name, sizeof (Name), "PciBusDxe");
+  SetMem (Long, sizeof (Long) - 1, 'L');
+  Long[sizeof (Long) - 1] = '\0';
+  CopyMem (Wide, L"Wide String", sizeof (L"Wide String"));
+  CopyGuid (&Guid, &mTestCallerId);
+  ZeroMem (&Time, sizeof (Time));
+  Time.Year   = 2024;
+  Time.Month  = 7;
+  Time.Day    = 15;
+  Time.Hour   = 13;
+  Time.Minute = 45;
+
+  Reports[0] = PackDebugData (&Data[0], "Loading driver %a at 0x%p (%d bytes) %r\n", Name, (VOID *)Name, 4096, EFI_NOT_FOUND);
+  Reports[1] = PackDebugData (&Data[1], "%s: %g %t %c%c\n", Wide, &Guid, &Time, (UINTN)'o', (UINTN)'k');
+  Reports[2] = PackDebugData (&Data[2], "%-10a|%5d|%*d|%lx|%X|%u\n", Name, -7, (UINTN)6, 42, (UINT64)0x123456789AULL, 0xBEEF, 17);
+  Reports[3] = PackDebugData (&Data[3], "%a\n", Long);
+  Reports[4] = PackDebugData (&Data[4], "%a and %a\n", Name, NULL);
+
+  for (Index = 0; Index < 5; Index++) {
+    UT_ASSERT_NOT_NULL (Reports[Index]);
+    ExpectReport (EFI_DEBUG_CODE, EFI_SOFTWARE_DXE_BS_DRIVER, NULL, Reports[Index]);
+    Status = LogRecordCapture (&mTest.Ring, EFI_DEBUG_CODE, EFI_SOFTWARE_DXE_BS_DRIVER, 0, NULL, Reports[Index]);
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+  }
+
+  //
+  // Progress, error and undefined codes without data.
+  //
+  ExpectReport (EFI_PROGRESS_CODE, 0x03051001, NULL, NULL);
+  UT_ASSERT_NOT_EFI_ERROR (LogRecordCapture (&mTest.Ring, EFI_PROGRESS_CODE, 0x03051001, 0, NULL, NULL));
+  ExpectReport (EFI_ERROR_CODE | EFI_ERROR_MAJOR, 0x03058002, &mTestCallerId, NULL);
+  UT_ASSERT_NOT_EFI_ERROR (LogRecordCapture (&mTest.Ring, EFI_ERROR_CODE | EFI_ERROR_MAJOR, 0x03058002, 0, &mTestCallerId, NULL));
+  ExpectReport (EFI_DEBUG_CODE, 0x03050000, NULL, NULL);
+  UT_ASSERT_NOT_EFI_ERROR (LogRecordCapture (&mTest.Ring, EFI_DEBUG_CODE, 0x03050000, 0, NULL, NULL));
+
+  //
+  // An ASCII string reported by pointer.
+  //
+  AsciiStrCpyS (StringText, sizeof (StringText), "String status code data");
+  ZeroMem (&Data[5], sizeof (TEST_DATA));
+  StringData                        = (EFI_STATUS_CODE_STRING_DATA *)Data[5].Storage;
+  StringData->DataHeader.HeaderSize = sizeof (EFI_STATUS_CODE_DATA);
+  StringData->DataHeader.Size       = sizeof (EFI_STATUS_CODE_STRING_DATA) - sizeof (EFI_STATUS_CODE_DATA);
+  CopyGuid (&StringData->DataHeader.Type, &gEfiStatusCodeDataTypeStringGuid);
+  StringData->StringType   = EfiStringAscii;
+  StringData->String.Ascii = StringText;
+  ExpectReport (EFI_DEBUG_CODE, 0, NULL, &StringData->DataHeader);
+  UT_ASSERT_NOT_EFI_ERROR (LogRecordCapture (&mTest.Ring, EFI_DEBUG_CODE, 0, 0, NULL, &StringData->DataHeader));
+
+  //
+  // An ASSERT(), with the file name and description stored inline.
+  //
+  ZeroMem (&Data[6], sizeof (TEST_DATA));
+  AssertHeader             = (EFI_STATUS_CODE_DATA *)Data[6].Storage;
+  AssertData               = (EFI_DEBUG_ASSERT_DATA *)(AssertHeader + 1);
+  AssertData->LineNumber   = 321;
+  AssertData->FileNameSize = sizeof ("Driver.c");
+  CopyMem (AssertData + 1, "Driver.c\0Buffer != NULL", sizeof ("Driver.c\0Buffer != NULL"));
+  AssertHeader->HeaderSize = sizeof (EFI_STATUS_CODE_DATA);
+  AssertHeader->Size       = (UINT16)(sizeof (EFI_DEBUG_ASSERT_DATA) + sizeof ("Driver.c\0Buffer != NULL"));
+  CopyGuid (&AssertHeader->Type, &gEfiStatusCodeSpecificDataGuid);
+  ExpectReport (EFI_ERROR_CODE | EFI_ERROR_UNRECOVERED, EFI_SOFTWARE_DXE_BS_DRIVER | EFI_SW_EC_ILLEGAL_SOFTWARE_STATE, NULL, AssertHeader);
+  UT_ASSERT_NOT_EFI_ERROR (
+    LogRecordCapture (
+      &mTest.Ring,
+      EFI_ERROR_CODE | EFI_ERROR_UNRECOVERED,
+      EFI_SOFTWARE_DXE_BS_DRIVER | EFI_SW_EC_ILLEGAL_SOFTWARE_STATE,
+      0,
+      NULL,
+      AssertHeader
+      )
+    );
+
+  //
+  // Data too large to keep.  Only the header is kept, which formats the same for a
+  // type the formatter does not know.
+  //
+  BigData = AllocateZeroPool (LOG_RECORD_MAX_DATA * 2);
+  UT_ASSERT_NOT_NULL (BigData);
+  BigData->HeaderSize = sizeof (EFI_STATUS_CODE_DATA);
+  BigData->Size       = LOG_RECORD_MAX_DATA;
+  CopyGuid (&BigData->Type, &mTestDataType);
+  ExpectReport (EFI_PROGRESS_CODE, 0x03051002, NULL, BigData);
+  UT_ASSERT_NOT_EFI_ERROR (LogRecordCapture (&mTest.Ring, EFI_PROGRESS_CODE, 0x03051002, 0, NULL, BigData));
+
+  //
+  // Overwrite everything the reports pointed to.
+  //
+  SetMem (Name, sizeof (Name), 'X');
+  SetMem (Long, sizeof (Long), 'X');
+  SetMem (Wide, sizeof (Wide), 'X');
+  SetMem (&Guid, sizeof (Guid), 0xA5);
+  SetMem (&Time, sizeof (Time), 0xA5);
+  SetMem (StringText, sizeof (StringText), 'X');
+  SetMem (Data, sizeof (Data), 0xA5);
+  SetMem (BigData, LOG_RECORD_MAX_DATA * 2, 0xA5);
+  FreePool (BigData);
+
+  UT_ASSERT_EQUAL (DrainRing (TRUE), 11);
+  UT_ASSERT_EQUAL (mTest.TextLength, mTest.ExpectedLength);
+  UT_ASSERT_MEM_EQUAL (mTest.Text, mTest.Expected, mTest.ExpectedLength);
+  UT_ASSERT_EQUAL (LogRecordRingUsed (&mTest.Ring), 0);
+  UT_ASSERT_TRUE (RingIsClean ());
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Reports made while another capture is in progress each get their own record, and the
+  consumer waits for the interrupted record so the log stays in order.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+NestedReportsAreKept (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  LOG_RECORD  *Outer;
+  TEST_DATA   Data;
+  UINT32      Level;
+
+  //
+  // The outer report is interrupted after it reserved its record.
+  //
+  Outer = LogRecordReserve (&mTest.Ring, sizeof (LOG_RECORD));
+  UT_ASSERT_NOT_NULL (Outer);
+  mTest.Ring.Depth++;
+
+  //
+  // Nested reports down to the deepest level that is captured.
+  //
+  for (Level = 1; Level < LOG_RECORD_MAX_NESTING; Level++) {
+    UT_ASSERT_NOT_EFI_ERROR (
+      LogRecordCapture (&mTest.Ring, EFI_DEBUG_CODE, 0, 0, NULL, PackDebugData (&Data, "Nested report %d\n", Level))
+      );
+    mTest.Ring.Depth++;
+  }
+
+  UT_ASSERT_EQUAL (mTest.Ring.MaxDepth, LOG_RECORD_MAX_NESTING);
+  UT_ASSERT_TRUE (LogRecordRingPeek (&mTest.Ring) == NULL);
+
+  //
+  // One level deeper is dropped, and counted.
+  //
+  UT_ASSERT_STATUS_EQUAL (
+    LogRecordCapture (&mTest.Ring, EFI_DEBUG_CODE, 0, 0, NULL, PackDebugData (&Data, "Too deep\n")),
+    EFI_OUT_OF_RESOURCES
+    );
+
+  //
+  // Unwind.  The outer report finishes last.
+  //
+  mTest.Ring.Depth -= LOG_RECORD_MAX_NESTING;
+  Outer->CodeType = EFI_PROGRESS_CODE;
+  Outer->Value    = 0x1234;
+  LogRecordCommit (&mTest.Ring, Outer);
+
+  UT_ASSERT_NOT_EFI_ERROR (
+    LogRecordCapture (&mTest.Ring, EFI_DEBUG_CODE, 0, 0, NULL, PackDebugData (&Data, "After\n"))
+    );
+
+  ExpectReport (EFI_PROGRESS_CODE, 0x1234, NULL, NULL);
+  for (Level = 1; Level < LOG_RECORD_MAX_NESTING; Level++) {
+    ExpectReport (EFI_DEBUG_CODE, 0, NULL, PackDebugData (&Data, "Nested report %d\n", Level));
+  }
+
+  AppendText (mTest.Expected, &mTest.ExpectedLength, "*** 1 status codes lost ***\r\n", AsciiStrLen ("*** 1 status codes lost ***\r\n"));
+  ExpectReport (EFI_DEBUG_CODE, 0, NULL, PackDebugData (&Data, "After\n"));
+
+  UT_ASSERT_EQUAL (DrainRing (TRUE), LOG_RECORD_MAX_NESTING + 1);
+  UT_ASSERT_EQUAL (mTest.TextLength, mTest.ExpectedLength);
+  UT_ASSERT_MEM_EQUAL (mTest.Text, mTest.Expected, mTest.ExpectedLength);
+  UT_ASSERT_EQUAL (mTest.Ring.Depth, 0);
+  UT_ASSERT_TRUE (RingIsClean ());
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  When nothing drains the ring, reports that do not fit are counted, and the count is
+  written once the ring is drained.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ExhaustionCountsLostReports (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_DATA             Data;
+  EFI_STATUS_CODE_DATA  *Report;
+  UINTN                 Index;
+  UINTN                 Stored;
+  UINTN                 Lost;
+  CHAR8                 Notice[64];
+
+  Stored = 0;
+  Lost   = 0;
+  for (Index = 0; Index < EXHAUSTION_REPORTS; Index++) {
+    Report = PackDebugData (&Data, "Report %d\n", Index);
+    if (EFI_ERROR (LogRecordCapture (&mTest.Ring, EFI_DEBUG_CODE, 0, 0, NULL, Report))) {
+      Lost++;
+    } else {
+      //
+      // Once full, the ring stays full.
+      //
+      UT_ASSERT_EQUAL (Lost, 0);
+      ExpectReport (EFI_DEBUG_CODE, 0, NULL, Report);
+      Stored++;
+    }
+  }
+
+  UT_ASSERT_TRUE (Stored > 0);
+  UT_ASSERT_TRUE (Lost > 0);
+  UT_ASSERT_EQUAL (mTest.Ring.Lost, Lost);
+
+  //
+  // The records drain first.  The lost count has no record to ride on yet.
+  //
+  UT_ASSERT_EQUAL (DrainRing (FALSE), Stored);
+  UT_ASSERT_EQUAL (mTest.TextLength, mTest.ExpectedLength);
+  UT_ASSERT_MEM_EQUAL (mTest.Text, mTest.Expected, mTest.ExpectedLength);
+
+  //
+  // The next record carries it.
+  //
+  Report = PackDebugData (&Data, "Recovered\n");
+  UT_ASSERT_NOT_EFI_ERROR (LogRecordCapture (&mTest.Ring, EFI_DEBUG_CODE, 0, 0, NULL, Report));
+  UT_ASSERT_EQUAL (mTest.Ring.Lost, 0);
+  AsciiSPrint (Notice, sizeof (Notice), "*** %d status codes lost ***\r\n", Lost);
+  AppendText (mTest.Expected, &mTest.ExpectedLength, Notice, AsciiStrLen (Notice));
+  ExpectReport (EFI_DEBUG_CODE, 0, NULL, Report);
+
+  //
+  // Fill the ring again.  Reports lost with no record after them are written when the
+  // ring is drained.
+  //
+  for (Index = 0; ; Index++) {
+    Report = PackDebugData (&Data, "Refill %d\n", Index);
+    if (EFI_ERROR (LogRecordCapture (&mTest.Ring, EFI_DEBUG_CODE, 0, 0, NULL, Report))) {
+      break;
+    }
+
+    ExpectReport (EFI_DEBUG_CODE, 0, NULL, Report);
+  }
+
+  UT_ASSERT_STATUS_EQUAL (LogRecordCapture (&mTest.Ring, EFI_DEBUG_CODE, 0, 0, NULL, Report), EFI_OUT_OF_RESOURCES);
+  AppendText (mTest.Expected, &mTest.ExpectedLength, "*** 2 status codes lost ***\r\n", AsciiStrLen ("*** 2 status codes lost ***\r\n"));
+
+  UT_ASSERT_EQUAL (DrainRing (TRUE), Index + 1);
+  UT_ASSERT_EQUAL (mTest.TextLength, mTest.ExpectedLength);
+  UT_ASSERT_MEM_EQUAL (mTest.Text, mTest.Expected, mTest.ExpectedLength);
+  UT_ASSERT_EQUAL (LogRecordRingTakeLost (&mTest.Ring), 0);
+  UT_ASSERT_TRUE (RingIsClean ());
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A small ring that is drained whenever it is half full, the way the driver drains it,
+  loses nothing over many wraparounds.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DrainedRingLosesNothing (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  TEST_DATA             Data;
+  EFI_STATUS_CODE_DATA  *Report;
+  CHAR8                 Name[80];
+  UINTN                 Index;
+  UINTN                 Length;
+  UINTN                 Formatted;
+  UINTN                 Drains;
+
+  Formatted = 0;
+  Drains    = 0;
+  for (Index = 0; Index < DRAINED_REPORTS; Index++) {
+    //
+    // Vary the record size so the records land at every offset of the ring.
+    //
+    Length = NextRandom () % (sizeof (Name) - 1);
+    SetMem (Name, Length, (CHAR8)('a' + Index % 26));
+    Name[Length] = '\0';
+
+    if ((Index % 7) == 0) {
+      ExpectReport (EFI_PROGRESS_CODE, (EFI_STATUS_CODE_VALUE)Index, NULL, NULL);
+      UT_ASSERT_NOT_EFI_ERROR (LogRecordCapture (&mTest.Ring, EFI_PROGRESS_CODE, (EFI_STATUS_CODE_VALUE)Index, 0, NULL, NULL));
+    } else {
+      Report = PackDebugData (&Data, "Report %d: %a\n", Index, Name);
+      ExpectReport (EFI_DEBUG_CODE, 0, NULL, Report);
+      UT_ASSERT_NOT_EFI_ERROR (LogRecordCapture (&mTest.Ring, EFI_DEBUG_CODE, 0, 0, NULL, Report));
+    }
+
+    SetMem (Name, sizeof (Name), 'X');
+
+    if (LogRecordRingUsed (&mTest.Ring) >= mTest.Ring.Size / 2) {
+      Formatted += DrainRing (TRUE);
+      Drains++;
+    }
+  }
+
+  Formatted += DrainRing (TRUE);
+
+  UT_ASSERT_EQUAL (Formatted, DRAINED_REPORTS);
+  UT_ASSERT_TRUE (Drains > 0);
+  UT_ASSERT_TRUE (mTest.Ring.Reserved > 100 * mTest.Ring.Size);
+  UT_ASSERT_EQUAL (mTest.TextLength, mTest.ExpectedLength);
+  UT_ASSERT_MEM_EQUAL (mTest.Text, mTest.Expected, mTest.ExpectedLength);
+  UT_ASSERT_EQUAL (LogRecordRingUsed (&mTest.Ring), 0);
+  UT_ASSERT_TRUE (RingIsClean ());
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A record that does not fit before the end of the buffer starts over at the beginning,
+  behind a padding record the consumer skips.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+WraparoundSkipsPadding (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  LOG_RECORD  *First;
+  LOG_RECORD  *Second;
+  LOG_RECORD  *Third;
+
+  First = LogRecordReserve (&mTest.Ring, 480);
+  UT_ASSERT_NOT_NULL (First);
+  First->Value = 1;
+  LogRecordCommit (&mTest.Ring, First);
+
+  Second = LogRecordReserve (&mTest.Ring, 480);
+  UT_ASSERT_NOT_NULL (Second);
+  Second->Value = 2;
+  LogRecordCommit (&mTest.Ring, Second);
+
+  //
+  // 64 bytes are left before the end and 64 are free in total.  A record needing the
+  // 64 at the end plus 200 at the start does not fit, and reserves nothing.
+  //
+  UT_ASSERT_TRUE (LogRecordReserve (&mTest.Ring, 200) == NULL);
+  UT_ASSERT_EQUAL (LogRecordRingUsed (&mTest.Ring), 960);
+
+  UT_ASSERT_TRUE (LogRecordRingPeek (&mTest.Ring) == First);
+  LogRecordRingRelease (&mTest.Ring, First);
+
+  Third = LogRecordReserve (&mTest.Ring, 200);
+  UT_ASSERT_TRUE ((UINT8 *)Third == mTest.Ring.Buffer);
+  UT_ASSERT_EQUAL (Third->Size, 200);
+  UT_ASSERT_EQUAL (LogRecordRingUsed (&mTest.Ring), 480 + 64 + 200);
+  Third->Value = 3;
+
+  UT_ASSERT_TRUE (LogRecordRingPeek (&mTest.Ring) == Second);
+  LogRecordRingRelease (&mTest.Ring, Second);
+
+  //
+  // The padding is committed, but the record behind it is not yet.
+  //
+  UT_ASSERT_TRUE (LogRecordRingPeek (&mTest.Ring) == NULL);
+  LogRecordCommit (&mTest.Ring, Third);
+  UT_ASSERT_TRUE (LogRecordRingPeek (&mTest.Ring) == Third);
+  UT_ASSERT_EQUAL (Third->Value, 3);
+  LogRecordRingRelease (&mTest.Ring, Third);
+
+  UT_ASSERT_TRUE (LogRecordRingPeek (&mTest.Ring) == NULL);
+  UT_ASSERT_EQUAL (LogRecordRingUsed (&mTest.Ring), 0);
+  UT_ASSERT_TRUE (RingIsClean ());
+
+  //
+  // Rings must be a power of two, and records at most half the ring.
+  //
+  UT_ASSERT_TRUE (LogRecordReserve (&mTest.Ring, TINY_RING_SIZE / 2 + 8) == NULL);
+  UT_ASSERT_STATUS_EQUAL (LogRecordRingInit (&mTest.Ring, mTest.RingBuffer, TINY_RING_SIZE - 8), EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  record ring and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      RingSuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&RingSuiteHandle, Framework, "Status code record ring tests", "DebugFileLogger.RecordRing", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for RingSuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (RingSuiteHandle, "Deferred formatting matches immediate formatting", "DeferredFormat", DeferredFormatMatchesImmediate, SetUpLargeRing, TearDownRing, NULL);
+  AddTestCase (RingSuiteHandle, "Nested reports are all kept", "NestedReports", NestedReportsAreKept, SetUpLargeRing, TearDownRing, NULL);
+  AddTestCase (RingSuiteHandle, "Exhaustion counts lost reports", "Exhaustion", ExhaustionCountsLostReports, SetUpSmallRing, TearDownRing, NULL);
+  AddTestCase (RingSuiteHandle, "A drained ring loses nothing", "Drained", DrainedRingLosesNothing, SetUpSmallRing, TearDownRing, NULL);
+  AddTestCase (RingSuiteHandle, "Wraparound skips padding", "Wraparound", WraparoundSkipsPadding, SetUpTinyRing, TearDownRing, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
@@ -0,0 +1,38 @@
+/** @file
+
+  This header defines an interface to the short history of exceptions some
+  ExceptionPersistenceLib instances keep in platform-specific early store, in
+  addition to the exception reported by ExPersistGetException().
+
+  Copyright (c) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef EXCEPTION_PERSISTENCE_HISTORY_LIB_H_
+#define EXCEPTION_PERSISTENCE_HISTORY_LIB_H_
+
+#include <Library/ExceptionPersistenceLib.h>
+
+/**
+  Retrieves the exceptions recorded in the platform-specific persistent storage, newest first.
+
+  @param[out]     History  Receives the recorded exceptions.  May be NULL if *Count is 0.
+  @param[in, out] Count    On input, the number of entries History can hold.  On output, the
+                           number of recorded exceptions.
+
+  @retval EFI_SUCCESS             History holds *Count exceptions
+  @retval EFI_BUFFER_TOO_SMALL    History is too small.  *Count has the number of recorded exceptions.
+  @retval EFI_INVALID_PARAMETER   Count is NULL, History is NULL and *Count is not 0, or
+                                  persistent storage contents are invalid
+  @retval EFI_UNSUPPORTED         The platform does not keep a history
+  @retval EFI_DEVICE_ERROR        Can't write/read platform-specific persistent storage
+**/
+EFI_STATUS
+EFIAPI
+ExPersistGetExceptionHistory (
+  OUT    EXCEPTION_TYPE  *History OPTIONAL,
+  IN OUT UINTN           *Count
+  );
+
+#endif
@@ -0,0 +1,136 @@
+/** @file
+This protocol lets callers that verify many PKCS7 payloads against the same trusted
+certificate register the certificate once and verify against the returned handle.
+
+It is installed alongside MU_PKCS7_PROTOCOL by MuCryptoDxe, under its own GUID so that
+consumers of MU_PKCS7_PROTOCOL built against the original layout are not affected.
+
+Copyright (C) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __MU_PKCS7_TRUSTED_CERT_H__
+#define __MU_PKCS7_TRUSTED_CERT_H__
+
+typedef struct _MU_PKCS7_TRUSTED_CERT_PROTOCOL MU_PKCS7_TRUSTED_CERT_PROTOCOL;
+
+///
+/// Opaque handle to a trusted certificate registered with RegisterTrustedCert.
+///
+typedef VOID *MU_PKCS7_TRUSTED_CERT_HANDLE;
+
+/**
+Registers a trusted/root certificate for repeated PKCS#7 verification.
+
+The certificate is checked once here.  The handle remembers the payloads that verified
+against it, so the same signed data and content presented again are not verified again.
+Every other payload is verified against this certificate.
+
+@param[in]  TrustedCert         Pointer to a trusted/root certificate encoded in DER.
+@param[in]  TrustedCertLength   Length of the trusted certificate in bytes.
+@param[out] Handle              Receives the handle.  Release it with UnregisterTrustedCert.
+
+@retval  EFI_SUCCESS            The certificate was registered.
+@retval  EFI_INVALID_PARAMETER  A pointer is NULL or the certificate is not a valid X.509 certificate.
+@retval  EFI_OUT_OF_RESOURCES   There is not enough memory to register the certificate.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *MU_PKCS7_REGISTER_TRUSTED_CERT)(
+  IN  CONST MU_PKCS7_TRUSTED_CERT_PROTOCOL  *This,
+  IN  CONST UINT8                           *TrustedCert,
+  IN  UINTN                                 TrustedCertLength,
+  OUT MU_PKCS7_TRUSTED_CERT_HANDLE          *Handle
+  );
+
+/**
+Releases a handle returned by RegisterTrustedCert.
+
+@param[in]  Handle              Handle to release.
+
+@retval  EFI_SUCCESS            The handle was released.
+@retval  EFI_INVALID_PARAMETER  Handle is not a registered trusted certificate.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *MU_PKCS7_UNREGISTER_TRUSTED_CERT)(
+  IN  CONST MU_PKCS7_TRUSTED_CERT_PROTOCOL  *This,
+  IN  MU_PKCS7_TRUSTED_CERT_HANDLE          Handle
+  );
+
+/**
+Same as MU_PKCS7_PROTOCOL.Verify, with the trusted certificate given by a handle from
+RegisterTrustedCert.
+
+@param[in]  Handle              Trusted certificate to verify against.
+@param[in]  P7Data              Pointer to the PKCS#7 message to verify.
+@param[in]  P7DataLength        Length of the PKCS#7 message in bytes.
+@param[in]  Data                Pointer to the content to be verified.
+@param[in]  DataLength          Length of Data in bytes.
+
+@retval  EFI_SUCCESS            The specified PKCS#7 signed data is valid.
+@retval  EFI_SECURITY_VIOLATION Invalid PKCS#7 signed data.
+@retval  EFI_INVALID_PARAMETER  A pointer is NULL or Handle is not a registered trusted certificate.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *MU_PKCS7_VERIFY_WITH_TRUSTED_CERT)(
+  IN  CONST MU_PKCS7_TRUSTED_CERT_PROTOCOL  *This,
+  IN  MU_PKCS7_TRUSTED_CERT_HANDLE          Handle,
+  IN  CONST UINT8                           *P7Data,
+  IN  UINTN                                 P7DataLength,
+  IN  CONST UINT8                           *Data,
+  IN  UINTN                                 DataLength
+  );
+
+///
+/// One payload of a VerifyBatch call.
+///
+typedef struct {
+  CONST UINT8    *P7Data;                   ///< PKCS#7 message to verify.
+  UINTN          P7DataLength;
+  CONST UINT8    *Data;                     ///< Content to be verified.
+  UINTN          DataLength;
+  EFI_STATUS     Status;                    ///< Result for this payload, as VerifyWithTrustedCert returns it.
+} MU_PKCS7_VERIFY_REQUEST;
+
+/**
+Verifies several PKCS#7 payloads against one trusted certificate.
+
+Every request is verified, and its result is stored in its Status field.
+
+@param[in]      Handle          Trusted certificate to verify against.
+@param[in, out] Requests        Payloads to verify.
+@param[in]      RequestCount    Number of entries in Requests.
+
+@retval  EFI_SUCCESS            Every payload is valid.
+@retval  EFI_INVALID_PARAMETER  Requests is NULL or Handle is not a registered trusted certificate.
+@retval  Others                 The Status of the first request that failed.
+
+**/
+typedef
+EFI_STATUS
+(EFIAPI *MU_PKCS7_VERIFY_BATCH)(
+  IN     CONST MU_PKCS7_TRUSTED_CERT_PROTOCOL  *This,
+  IN     MU_PKCS7_TRUSTED_CERT_HANDLE          Handle,
+  IN OUT MU_PKCS7_VERIFY_REQUEST               *Requests,
+  IN     UINTN                                 RequestCount
+  );
+
+///
+/// PKCS7 trusted certificate protocol
+///
+struct _MU_PKCS7_TRUSTED_CERT_PROTOCOL {
+  MU_PKCS7_REGISTER_TRUSTED_CERT       RegisterTrustedCert;
+  MU_PKCS7_UNREGISTER_TRUSTED_CERT     UnregisterTrustedCert;
+  MU_PKCS7_VERIFY_WITH_TRUSTED_CERT    VerifyWithTrustedCert;
+  MU_PKCS7_VERIFY_BATCH                VerifyBatch;
+};
+
+extern EFI_GUID  gMuPkcs7TrustedCertProtocolGuid;
+
+#endif // __MU_PKCS7_TRUSTED_CERT_H__
@@ -11,8 +11,11 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Uefi/UefiSpec.h>
 
 #include <Library/ExceptionPersistenceLib.h>
+#include <Library/ExceptionPersistenceHistoryLib.h>
 #include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
 #include <Library/IoLib.h>
+#include <Library/PcdLib.h>
 
 typedef UINT16  EXCEPTION_PERSISTENCE_VAL;
 typedef UINT16  EXCEPTION_PERSISTENCE_VAL_CHECKSUM;
@@ -34,11 +37,52 @@ typedef UINT16  EXCEPTION_PERSISTENCE_VAL_CHECKSUM;
 #define CMOS_EX_PERSIST_TEST_SIZE       sizeof (UINT8)
 #define CMOS_EX_PERSIST_TEST_VAL        0x99
 
+//
+// With PcdExceptionPersistenceCmosHistoryDepth set, the last exceptions are kept in a ring after
+// the test byte: a head byte holding the number of records and the next slot, then one byte per
+// slot.  A new record writes its own slot and the head, so the slots are written in turn rather
+// than one byte being rewritten for every exception.  The ring is not covered by the checksum,
+// which keeps the checksum compatible with the single record layout.
+//
+#define CMOS_EX_PERSIST_HISTORY_MAX_DEPTH   8
+#define CMOS_EX_PERSIST_HISTORY_DEPTH       MIN (FixedPcdGet8 (PcdExceptionPersistenceCmosHistoryDepth), CMOS_EX_PERSIST_HISTORY_MAX_DEPTH)
+#define CMOS_EX_PERSIST_HISTORY_HEAD_START  (CMOS_EX_PERSIST_TEST_START + CMOS_EX_PERSIST_TEST_SIZE)
+#define CMOS_EX_PERSIST_HISTORY_START       (CMOS_EX_PERSIST_HISTORY_HEAD_START + 1)
+
+#define HISTORY_HEAD(Count, Next)  ((UINT8)(((Count) << 4) | (Next)))
+#define HISTORY_HEAD_COUNT(Head)   ((UINT8)((Head) >> 4))
+#define HISTORY_HEAD_NEXT(Head)    ((UINT8)((Head) & 0x0F))
+
+//
+// The shadow covers the checksum, the data and the test byte, and the history head if there is a
+// history.  Offsets into it are from CMOS_EX_PERSIST_CHECKSUM_START.
+//
+#define SHADOW_OFFSET(Address)  ((UINT8)((Address) - CMOS_EX_PERSIST_CHECKSUM_START))
+#define SHADOW_MAX_SIZE         SHADOW_OFFSET (CMOS_EX_PERSIST_HISTORY_START)
+#define SHADOW_SIZE             ((CMOS_EX_PERSIST_HISTORY_DEPTH == 0) ? SHADOW_OFFSET (CMOS_EX_PERSIST_HISTORY_HEAD_START) : SHADOW_MAX_SIZE)
+
 #define PCAT_RTC_LO_ADDRESS_PORT  0x70
 #define PCAT_RTC_LO_DATA_PORT     0x71
 
 #define ONLY_ONE_BIT_SET(a)  (!(a & (a - 1)))
 
+//
+// Copy of the CMOS region for the duration of one API call.  Stored holds what CMOS holds and
+// Current what the call wants it to hold.  Every CMOS byte is a pair of port accesses, so the
+// region is read once, and only the bytes that differ are written back.
+//
+// The shadow is not kept between calls: every module has its own copy of this library, PEI
+// globals may not be writable, and CMOS survives the module.  A shadow kept longer would go stale.
+//
+typedef struct {
+  UINT8      Stored[SHADOW_MAX_SIZE];
+  UINT8      Current[SHADOW_MAX_SIZE];
+  BOOLEAN    ChecksumValid;
+  BOOLEAN    Record;            // RecordValue goes to history slot RecordSlot
+  UINT8      RecordSlot;
+  UINT8      RecordValue;
+} EX_PERSIST_SHADOW;
+
 // ---------------------
 //
 // PRIVATE API
@@ -127,73 +171,207 @@ ExPersistTestCmos (
 }
 
 /**
-  Sums across bytes in memory protection CMOS region.
+  Sums across the memory protection data bytes of a shadow region.
+
+  @param[in]  Region  Shadow region
 
   @retval the checksum value
 **/
 STATIC
 EXCEPTION_PERSISTENCE_VAL_CHECKSUM
 ExPersistSum (
-  VOID
+  IN CONST UINT8  *Region
   )
 {
-  UINT8                               i, Address;
+  UINT8                               i;
   EXCEPTION_PERSISTENCE_VAL_CHECKSUM  Sum = 0;
 
-  Address = CMOS_EX_PERSIST_DATA_START;
-
   for (i = 0; i < CMOS_EX_PERSIST_DATA_SIZE; i++) {
-    IoWrite8 (PCAT_RTC_LO_ADDRESS_PORT, Address + i);
-    Sum += IoRead8 (PCAT_RTC_LO_DATA_PORT);
+    Sum += Region[SHADOW_OFFSET (CMOS_EX_PERSIST_DATA_START) + i];
   }
 
   return Sum;
 }
 
 /**
-  Returns if the checksum region value matches the sum of memory protection CMOS data
+  Reads the memory protection CMOS region into a shadow.  The test value is written first and is
+  read back with the rest of the region.
+
+  @param[out] Shadow  Receives the region
 
-  @retval TRUE   The CMOS checksum is valid
-  @retval FALSE  The CMOS checksum is not valid
+  @retval EFI_SUCCESS       Shadow holds the region
+  @retval EFI_DEVICE_ERROR  Can't write/read CMOS
 **/
 STATIC
-BOOLEAN
-ExPersistIsChecksumValid (
-  VOID
+EFI_STATUS
+ExPersistLoad (
+  OUT EX_PERSIST_SHADOW  *Shadow
+  )
+{
+  UINT8  TestVal;
+
+  TestVal = CMOS_EX_PERSIST_TEST_VAL;
+  ExPersistCmosWrite (&TestVal, CMOS_EX_PERSIST_TEST_SIZE, CMOS_EX_PERSIST_TEST_START);
+  ExPersistCmosRead (Shadow->Stored, SHADOW_SIZE, CMOS_EX_PERSIST_CHECKSUM_START);
+
+  if (Shadow->Stored[SHADOW_OFFSET (CMOS_EX_PERSIST_TEST_START)] != CMOS_EX_PERSIST_TEST_VAL) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  CopyMem (Shadow->Current, Shadow->Stored, SHADOW_SIZE);
+  Shadow->ChecksumValid = ReadUnaligned16 ((UINT16 *)&Shadow->Stored[SHADOW_OFFSET (CMOS_EX_PERSIST_CHECKSUM_START)]) ==
+                          ExPersistSum (Shadow->Stored);
+  Shadow->Record = FALSE;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Writes the bytes of a shadow region that differ from CMOS. FOR INTERNAL USE ONLY.
+
+  @param[in]  Shadow  Shadow region
+  @param[in]  Offset  Offset of the first byte to write back
+  @param[in]  Size    Number of bytes to write back
+**/
+STATIC
+VOID
+ExPersistWriteChanged (
+  IN CONST EX_PERSIST_SHADOW  *Shadow,
+  IN UINT8                    Offset,
+  IN UINT8                    Size
+  )
+{
+  UINT8  i;
+
+  for (i = Offset; i < Offset + Size; i++) {
+    if (Shadow->Current[i] != Shadow->Stored[i]) {
+      IoWrite8 (PCAT_RTC_LO_ADDRESS_PORT, CMOS_EX_PERSIST_CHECKSUM_START + i);
+      IoWrite8 (PCAT_RTC_LO_DATA_PORT, Shadow->Current[i]);
+    }
+  }
+}
+
+/**
+  Writes a shadow region back to CMOS in one sequence: the data, the history, and the checksum
+  last, as before.  The checksum is adjusted by the data bytes that changed rather than summed
+  again, unless it was not valid to begin with.
+
+  @param[in, out] Shadow  Shadow region
+**/
+STATIC
+VOID
+ExPersistCommit (
+  IN OUT EX_PERSIST_SHADOW  *Shadow
   )
 {
-  EXCEPTION_PERSISTENCE_VAL_CHECKSUM  Sum;
   EXCEPTION_PERSISTENCE_VAL_CHECKSUM  Checksum;
+  UINT8                               i;
+  UINT8                               Offset;
+
+  if (Shadow->ChecksumValid) {
+    Checksum = ReadUnaligned16 ((UINT16 *)&Shadow->Stored[SHADOW_OFFSET (CMOS_EX_PERSIST_CHECKSUM_START)]);
+    for (i = 0; i < CMOS_EX_PERSIST_DATA_SIZE; i++) {
+      Offset    = SHADOW_OFFSET (CMOS_EX_PERSIST_DATA_START) + i;
+      Checksum += (EXCEPTION_PERSISTENCE_VAL_CHECKSUM)(Shadow->Current[Offset] - Shadow->Stored[Offset]);
+    }
+  } else {
+    Checksum = ExPersistSum (Shadow->Current);
+  }
 
-  ExPersistCmosRead (
-    &Checksum,
-    CMOS_EX_PERSIST_CHECKSUM_SIZE,
-    CMOS_EX_PERSIST_CHECKSUM_START
-    );
+  WriteUnaligned16 ((UINT16 *)&Shadow->Current[SHADOW_OFFSET (CMOS_EX_PERSIST_CHECKSUM_START)], Checksum);
+
+  ExPersistWriteChanged (Shadow, SHADOW_OFFSET (CMOS_EX_PERSIST_DATA_START), CMOS_EX_PERSIST_DATA_SIZE);
+
+  if (Shadow->Record) {
+    IoWrite8 (PCAT_RTC_LO_ADDRESS_PORT, CMOS_EX_PERSIST_HISTORY_START + Shadow->RecordSlot);
+    IoWrite8 (PCAT_RTC_LO_DATA_PORT, Shadow->RecordValue);
+  }
+
+  if (CMOS_EX_PERSIST_HISTORY_DEPTH != 0) {
+    ExPersistWriteChanged (Shadow, SHADOW_OFFSET (CMOS_EX_PERSIST_HISTORY_HEAD_START), 1);
+  }
+
+  ExPersistWriteChanged (Shadow, SHADOW_OFFSET (CMOS_EX_PERSIST_CHECKSUM_START), CMOS_EX_PERSIST_CHECKSUM_SIZE);
+
+  CopyMem (Shadow->Stored, Shadow->Current, SHADOW_SIZE);
+  Shadow->ChecksumValid = TRUE;
+  Shadow->Record        = FALSE;
+}
+
+/**
+  Decodes the history head of a shadow region.
+
+  @param[in]  Shadow  Shadow region
+  @param[out] Count   Number of records in the history
+  @param[out] Next    Slot the next record goes to
+
+  @retval TRUE   The head is valid for the configured depth
+  @retval FALSE  The head is not valid, or there is no history
+**/
+STATIC
+BOOLEAN
+ExPersistHistoryHead (
+  IN  CONST EX_PERSIST_SHADOW  *Shadow,
+  OUT UINT8                    *Count,
+  OUT UINT8                    *Next
+  )
+{
+  UINT8  Head;
 
-  Sum = ExPersistSum ();
+  if (CMOS_EX_PERSIST_HISTORY_DEPTH == 0) {
+    return FALSE;
+  }
 
-  return Checksum == Sum;
+  Head   = Shadow->Current[SHADOW_OFFSET (CMOS_EX_PERSIST_HISTORY_HEAD_START)];
+  *Count = HISTORY_HEAD_COUNT (Head);
+  *Next  = HISTORY_HEAD_NEXT (Head);
+
+  return (*Count <= CMOS_EX_PERSIST_HISTORY_DEPTH) && (*Next < CMOS_EX_PERSIST_HISTORY_DEPTH);
 }
 
 /**
-  Routine to update the checksum based on the memory protection CMOS bytes.
+  Adds an exception to the history of a shadow region, if there is a history.  It is written to
+  CMOS by ExPersistCommit().
+
+  @param[in, out] Shadow     Shadow region
+  @param[in]      Exception  Exception to record
 **/
 STATIC
 VOID
-ExPersistUpdateChecksum (
-  VOID
+ExPersistRecordException (
+  IN OUT EX_PERSIST_SHADOW  *Shadow,
+  IN     EXCEPTION_TYPE     Exception
   )
 {
-  EXCEPTION_PERSISTENCE_VAL_CHECKSUM  Checksum = 0;
+  UINT8  Count;
+  UINT8  Next;
 
-  Checksum = ExPersistSum ();
+  if (CMOS_EX_PERSIST_HISTORY_DEPTH == 0) {
+    return;
+  }
 
-  ExPersistCmosWrite (
-    &Checksum,
-    CMOS_EX_PERSIST_CHECKSUM_SIZE,
-    CMOS_EX_PERSIST_CHECKSUM_START
-    );
+  //
+  // A head that does not fit the configured depth was written by a build with another depth.
+  //
+  if (!ExPersistHistoryHead (Shadow, &Count, &Next)) {
+    Count = 0;
+    Next  = 0;
+  }
+
+  Shadow->Record      = TRUE;
+  Shadow->RecordSlot  = Next;
+  Shadow->RecordValue = (UINT8)Exception;
+
+  Next++;
+  if (Next >= CMOS_EX_PERSIST_HISTORY_DEPTH) {
+    Next = 0;
+  }
+
+  if (Count < CMOS_EX_PERSIST_HISTORY_DEPTH) {
+    Count++;
+  }
+
+  Shadow->Current[SHADOW_OFFSET (CMOS_EX_PERSIST_HISTORY_HEAD_START)] = HISTORY_HEAD (Count, Next);
 }
 
 /**
@@ -211,48 +389,64 @@ ExPersistRead (
   OUT EXCEPTION_PERSISTENCE_VAL  *Val
   )
 {
-  if (!ExPersistTestCmos ()) {
-    return EFI_DEVICE_ERROR;
+  EFI_STATUS         Status;
+  EX_PERSIST_SHADOW  Shadow;
+
+  Status = ExPersistLoad (&Shadow);
+  if (EFI_ERROR (Status)) {
+    return Status;
   }
 
-  if (!ExPersistIsChecksumValid () || (Val == NULL)) {
+  if (!Shadow.ChecksumValid || (Val == NULL)) {
     return EFI_INVALID_PARAMETER;
   }
 
-  ExPersistCmosRead (
-    Val,
-    CMOS_EX_PERSIST_DATA_SIZE,
-    CMOS_EX_PERSIST_DATA_START
-    );
+  *Val = ReadUnaligned16 ((UINT16 *)&Shadow.Current[SHADOW_OFFSET (CMOS_EX_PERSIST_DATA_START)]);
 
   return EFI_SUCCESS;
 }
 
 /**
-  Writes Input Value to early store
+  Sets and clears bits of the value in early store, with one read of the region and one write
+  of the bytes that change.
 
-  @param[in] Val EXCEPTION_PERSISTENCE_VAL value to write
+  @param[in] SetBits    Bits to set
+  @param[in] ClearBits  Bits to clear
+  @param[in] Exception  Exception to add to the history, or ExceptionPersistNone
 
   @retval EFI_SUCCESS            Value written
+  @retval EFI_INVALID_PARAMETER  Checksum was invalid
   @retval EFI_DEVICE_ERROR       Can't write/read CMOS
 **/
 STATIC
 EFI_STATUS
-ExPersistWrite (
-  IN EXCEPTION_PERSISTENCE_VAL  Val
+ExPersistUpdate (
+  IN EXCEPTION_PERSISTENCE_VAL  SetBits,
+  IN EXCEPTION_PERSISTENCE_VAL  ClearBits,
+  IN EXCEPTION_TYPE             Exception
   )
 {
-  if (!ExPersistTestCmos ()) {
-    return EFI_DEVICE_ERROR;
+  EFI_STATUS                 Status;
+  EX_PERSIST_SHADOW          Shadow;
+  EXCEPTION_PERSISTENCE_VAL  Val;
+
+  Status = ExPersistLoad (&Shadow);
+  if (EFI_ERROR (Status)) {
+    return Status;
   }
 
-  ExPersistCmosWrite (
-    &Val,
-    CMOS_EX_PERSIST_DATA_SIZE,
-    CMOS_EX_PERSIST_DATA_START
-    );
+  if (!Shadow.ChecksumValid) {
+    return EFI_INVALID_PARAMETER;
+  }
 
-  ExPersistUpdateChecksum ();
+  Val = ReadUnaligned16 ((UINT16 *)&Shadow.Current[SHADOW_OFFSET (CMOS_EX_PERSIST_DATA_START)]);
+  WriteUnaligned16 ((UINT16 *)&Shadow.Current[SHADOW_OFFSET (CMOS_EX_PERSIST_DATA_START)], (EXCEPTION_PERSISTENCE_VAL)((Val | SetBits) & ~ClearBits));
+
+  if (Exception != ExceptionPersistNone) {
+    ExPersistRecordException (&Shadow, Exception);
+  }
+
+  ExPersistCommit (&Shadow);
 
   return EFI_SUCCESS;
 }
@@ -343,9 +537,7 @@ ExPersistSetException (
   IN  EXCEPTION_TYPE  Exception
   )
 {
-  EXCEPTION_PERSISTENCE_VAL  CmosVal = 0;
-  EFI_STATUS                 Status;
-  UINT16                     ExceptionBit = 0;
+  UINT16  ExceptionBit = 0;
 
   switch (Exception) {
     case ExceptionPersistPageFault:
@@ -363,9 +555,7 @@ ExPersistSetException (
       return EFI_INVALID_PARAMETER;
   }
 
-  Status = ExPersistRead (&CmosVal);
-
-  return (EFI_ERROR (Status)) ? Status : ExPersistWrite (CmosVal | (EX_PERSIST_VALID_BIT | ExceptionBit));
+  return ExPersistUpdate (EX_PERSIST_VALID_BIT | ExceptionBit, 0, Exception);
 }
 
 /**
@@ -381,12 +571,7 @@ ExPersistClearExceptions (
   VOID
   )
 {
-  EXCEPTION_PERSISTENCE_VAL  CmosVal = 0;
-  EFI_STATUS                 Status;
-
-  Status = ExPersistRead (&CmosVal);
-
-  return (EFI_ERROR (Status)) ? Status : ExPersistWrite (CmosVal & ~EX_PERSIST_EXCEPTION_BITS);
+  return ExPersistUpdate (0, EX_PERSIST_EXCEPTION_BITS, ExceptionPersistNone);
 }
 
 /**
@@ -441,12 +626,7 @@ ExPersistSetIgnoreNextPageFault (
   VOID
   )
 {
-  EXCEPTION_PERSISTENCE_VAL  CmosVal = 0;
-  EFI_STATUS                 Status;
-
-  Status = ExPersistRead (&CmosVal);
-
-  return (EFI_ERROR (Status)) ? Status : ExPersistWrite (CmosVal | (EX_PERSIST_VALID_BIT | EX_PERSIST_IGNORE_NEXT_PF));
+  return ExPersistUpdate (EX_PERSIST_VALID_BIT | EX_PERSIST_IGNORE_NEXT_PF, 0, ExceptionPersistNone);
 }
 
 /**
@@ -463,12 +643,7 @@ ExPersistClearIgnoreNextPageFault (
   VOID
   )
 {
-  EXCEPTION_PERSISTENCE_VAL  CmosVal = 0;
-  EFI_STATUS                 Status;
-
-  Status = ExPersistRead (&CmosVal);
-
-  return (EFI_ERROR (Status)) ? Status : ExPersistWrite (CmosVal & ~EX_PERSIST_IGNORE_NEXT_PF);
+  return ExPersistUpdate (0, EX_PERSIST_IGNORE_NEXT_PF, ExceptionPersistNone);
 }
 
 /**
@@ -484,5 +659,99 @@ ExPersistClearAll (
   VOID
   )
 {
-  return ExPersistWrite ((EXCEPTION_PERSISTENCE_VAL)0);
+  UINT8  Zero[CMOS_EX_PERSIST_CHECKSUM_SIZE + CMOS_EX_PERSIST_DATA_SIZE];
+  UINT8  HistoryHead;
+
+  if (!ExPersistTestCmos ()) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  //
+  // Nothing here depends on what CMOS holds, so the data and the checksum of zero data are
+  // written without reading them first.  Emptying the history only takes its head.
+  //
+  ZeroMem (Zero, sizeof (Zero));
+  ExPersistCmosWrite (
+    &Zero[CMOS_EX_PERSIST_CHECKSUM_SIZE],
+    CMOS_EX_PERSIST_DATA_SIZE,
+    CMOS_EX_PERSIST_DATA_START
+    );
+
+  if (CMOS_EX_PERSIST_HISTORY_DEPTH != 0) {
+    HistoryHead = HISTORY_HEAD (0, 0);
+    ExPersistCmosWrite (&HistoryHead, 1, CMOS_EX_PERSIST_HISTORY_HEAD_START);
+  }
+
+  ExPersistCmosWrite (
+    Zero,
+    CMOS_EX_PERSIST_CHECKSUM_SIZE,
+    CMOS_EX_PERSIST_CHECKSUM_START
+    );
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Retrieves the exceptions recorded in the platform-specific persistent storage, newest first.
+
+  @param[out]     History  Receives the recorded exceptions.  May be NULL if *Count is 0.
+  @param[in, out] Count    On input, the number of entries History can hold.  On output, the
+                           number of recorded exceptions.
+
+  @retval EFI_SUCCESS             History holds *Count exceptions
+  @retval EFI_BUFFER_TOO_SMALL    History is too small.  *Count has the number of recorded exceptions.
+  @retval EFI_INVALID_PARAMETER   Count is NULL, History is NULL and *Count is not 0, or
+                                  persistent storage contents are invalid
+  @retval EFI_UNSUPPORTED         The platform does not keep a history
+  @retval EFI_DEVICE_ERROR        Can't write/read platform-specific persistent storage
+**/
+EFI_STATUS
+EFIAPI
+ExPersistGetExceptionHistory (
+  OUT    EXCEPTION_TYPE  *History OPTIONAL,
+  IN OUT UINTN           *Count
+  )
+{
+  EFI_STATUS         Status;
+  EX_PERSIST_SHADOW  Shadow;
+  UINT8              Recorded;
+  UINT8              Next;
+  UINT8              Slots[CMOS_EX_PERSIST_HISTORY_MAX_DEPTH];
+  UINT8              i;
+
+  if ((Count == NULL) || ((History == NULL) && (*Count != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (CMOS_EX_PERSIST_HISTORY_DEPTH == 0) {
+    return EFI_UNSUPPORTED;
+  }
+
+  Status = ExPersistLoad (&Shadow);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  if (!Shadow.ChecksumValid || !ExPersistHistoryHead (&Shadow, &Recorded, &Next)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (*Count < Recorded) {
+    *Count = Recorded;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  ExPersistCmosRead (Slots, CMOS_EX_PERSIST_HISTORY_DEPTH, CMOS_EX_PERSIST_HISTORY_START);
+
+  for (i = 0; i < Recorded; i++) {
+    Next = (Next == 0) ? CMOS_EX_PERSIST_HISTORY_DEPTH - 1 : Next - 1;
+    if (Slots[Next] >= ExceptionPersistMax) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    History[i] = (EXCEPTION_TYPE)Slots[Next];
+  }
+
+  *Count = Recorded;
+  return EFI_SUCCESS;
 }
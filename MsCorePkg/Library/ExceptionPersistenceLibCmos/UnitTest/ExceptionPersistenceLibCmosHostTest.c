@@ -0,0 +1,605 @@
+/** @file
+  Host based unit tests for the CMOS instance of ExceptionPersistenceLib.
+
+  IoWrite8 and IoRead8 are replaced with a mock RTC whose index and data ports address a
+  128 byte CMOS array, and every port access is counted.  The tests check the library
+  against the layout the single record version wrote, and the number of port accesses
+  each call takes against what that version took.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/ExceptionPersistenceLib.h>
+#include <Library/ExceptionPersistenceHistoryLib.h>
+#include <Library/IoLib.h>
+#include <Library/PcdLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_NAME     "Exception Persistence Lib CMOS Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define RTC_ADDRESS_PORT  0x70
+#define RTC_DATA_PORT     0x71
+#define CMOS_SIZE         128
+
+//
+// Layout written by the single record version of the library.
+//
+#define CMOS_CHECKSUM        0x10
+#define CMOS_DATA            0x12
+#define CMOS_TEST            0x14
+#define CMOS_HISTORY_HEAD    0x15
+#define CMOS_HISTORY         0x16
+#define CMOS_TEST_VAL        0x99
+#define DATA_VALID           BIT0
+#define DATA_IGNORE_NEXT_PF  BIT6
+#define DATA_PAGE_FAULT      BIT10
+#define DATA_STACK_COOKIE    BIT11
+#define DATA_OTHER           BIT15
+
+//
+// Port accesses the single record version took for each call: 16 to check CMOS and read the
+// value, and 16 more to check CMOS, write the value and sum it again for the checksum.
+//
+#define LEGACY_GET_ACCESSES        16
+#define LEGACY_UPDATE_ACCESSES     32
+#define LEGACY_CLEAR_ALL_ACCESSES  16
+
+#define RANDOM_OPERATIONS  2000
+
+#define HISTORY_DEPTH  FixedPcdGet8 (PcdExceptionPersistenceCmosHistoryDepth)
+
+typedef struct {
+  UINT8      Cmos[CMOS_SIZE];
+  UINT8      Index;
+  UINTN      Accesses;
+  UINTN      Writes[CMOS_SIZE];
+  BOOLEAN    Dead;                  // Reads return 0xFF, as with no RTC behind the ports.
+} MOCK_RTC;
+
+STATIC MOCK_RTC  mRtc;
+STATIC UINT32    mRandomState;
+
+/**
+  Stands in for IoLib.  Writes the index or the data port of the mock RTC.
+**/
+UINT8
+EFIAPI
+IoWrite8 (
+  IN UINTN  Port,
+  IN UINT8  Value
+  )
+{
+  mRtc.Accesses++;
+  if (Port == RTC_ADDRESS_PORT) {
+    mRtc.Index = Value & (CMOS_SIZE - 1);
+  } else if (Port == RTC_DATA_PORT) {
+    mRtc.Cmos[mRtc.Index] = Value;
+    mRtc.Writes[mRtc.Index]++;
+  } else {
+    ASSERT (FALSE);
+  }
+
+  return Value;
+}
+
+/**
+  Stands in for IoLib.  Reads the data port of the mock RTC.
+**/
+UINT8
+EFIAPI
+IoRead8 (
+  IN UINTN  Port
+  )
+{
+  mRtc.Accesses++;
+  ASSERT (Port == RTC_DATA_PORT);
+  return mRtc.Dead ? 0xFF : mRtc.Cmos[mRtc.Index];
+}
+
+/**
+  Returns a pseudo random number.
+**/
+STATIC
+UINT32
+Random (
+  VOID
+  )
+{
+  mRandomState = mRandomState * 1103515245 + 12345;
+  return mRandomState >> 8;
+}
+
+/**
+  Reads a 16 bit value from the mock CMOS.
+**/
+STATIC
+UINT16
+CmosRead16 (
+  IN UINT8  Address
+  )
+{
+  return (UINT16)(mRtc.Cmos[Address] | (mRtc.Cmos[Address + 1] << 8));
+}
+
+/**
+  Writes a value and its checksum to the mock CMOS the way the single record version did.
+**/
+STATIC
+VOID
+CmosWriteLegacy (
+  IN UINT16  Value
+  )
+{
+  UINT16  Sum;
+
+  mRtc.Cmos[CMOS_DATA]     = (UINT8)Value;
+  mRtc.Cmos[CMOS_DATA + 1] = (UINT8)(Value >> 8);
+  Sum                      = (UINT16)(mRtc.Cmos[CMOS_DATA] + mRtc.Cmos[CMOS_DATA + 1]);
+  mRtc.Cmos[CMOS_CHECKSUM]     = (UINT8)Sum;
+  mRtc.Cmos[CMOS_CHECKSUM + 1] = (UINT8)(Sum >> 8);
+}
+
+/**
+  Tells if the checksum in the mock CMOS is the one the single record version computes.
+**/
+STATIC
+BOOLEAN
+CmosChecksumValid (
+  VOID
+  )
+{
+  return CmosRead16 (CMOS_CHECKSUM) == (UINT16)(mRtc.Cmos[CMOS_DATA] + mRtc.Cmos[CMOS_DATA + 1]);
+}
+
+/**
+  Fills the mock CMOS with noise and starts each test from ExPersistClearAll().
+**/
+STATIC
+VOID
+EFIAPI
+SetUpCmos (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  ZeroMem (&mRtc, sizeof (mRtc));
+  mRandomState = 0x2468ACE1;
+  for (Index = 0; Index < CMOS_SIZE; Index++) {
+    mRtc.Cmos[Index] = (UINT8)Random ();
+  }
+
+  ExPersistClearAll ();
+  mRtc.Accesses = 0;
+  ZeroMem (mRtc.Writes, sizeof (mRtc.Writes));
+}
+
+/**
+  Each exception reads back as the one set, and the page fault override is independent of it.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ExceptionsRoundTrip (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EXCEPTION_TYPE  Set;
+  EXCEPTION_TYPE  Exception;
+  BOOLEAN         Ignore;
+
+  Exception = ExceptionPersistMax;
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistGetException (&Exception));
+  UT_ASSERT_EQUAL (Exception, ExceptionPersistMax);
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistGetIgnoreNextPageFault (&Ignore));
+  UT_ASSERT_FALSE (Ignore);
+
+  for (Set = ExceptionPersistPageFault; Set < ExceptionPersistMax; Set++) {
+    UT_ASSERT_NOT_EFI_ERROR (ExPersistClearExceptions ());
+    UT_ASSERT_NOT_EFI_ERROR (ExPersistSetException (Set));
+    UT_ASSERT_NOT_EFI_ERROR (ExPersistGetException (&Exception));
+    UT_ASSERT_EQUAL (Exception, Set);
+    UT_ASSERT_TRUE (CmosChecksumValid ());
+  }
+
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistSetIgnoreNextPageFault ());
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistGetIgnoreNextPageFault (&Ignore));
+  UT_ASSERT_TRUE (Ignore);
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistGetException (&Exception));
+  UT_ASSERT_EQUAL (Exception, ExceptionPersistMax - 1);
+
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistSetException (ExceptionPersistNone));
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistGetException (&Exception));
+  UT_ASSERT_EQUAL (Exception, ExceptionPersistNone);
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistGetIgnoreNextPageFault (&Ignore));
+  UT_ASSERT_TRUE (Ignore);
+
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistClearIgnoreNextPageFault ());
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistGetIgnoreNextPageFault (&Ignore));
+  UT_ASSERT_FALSE (Ignore);
+
+  UT_ASSERT_STATUS_EQUAL (ExPersistSetException (ExceptionPersistMax), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (ExPersistGetException (NULL), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (ExPersistGetIgnoreNextPageFault (NULL), EFI_INVALID_PARAMETER);
+  UT_ASSERT_TRUE (CmosChecksumValid ());
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Random calls leave the same value as a model of the bits does, and the incrementally updated
+  checksum stays equal to the full sum.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ChecksumMatchesFullSum (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT16          Model;
+  UINT16          Exceptions;
+  UINTN           Operation;
+  EXCEPTION_TYPE  Exception;
+
+  Model = 0;
+  for (Operation = 0; Operation < RANDOM_OPERATIONS; Operation++) {
+    switch (Random () % 6) {
+      case 0:
+        Exception = (EXCEPTION_TYPE)(ExceptionPersistPageFault + Random () % (ExceptionPersistMax - ExceptionPersistPageFault));
+        UT_ASSERT_NOT_EFI_ERROR (ExPersistSetException (Exception));
+        Model |= DATA_VALID | ((Exception == ExceptionPersistPageFault) ? DATA_PAGE_FAULT :
+                               (Exception == ExceptionPersistStackCookie) ? DATA_STACK_COOKIE : DATA_OTHER);
+        break;
+      case 1:
+        UT_ASSERT_NOT_EFI_ERROR (ExPersistClearExceptions ());
+        Model &= ~(DATA_PAGE_FAULT | DATA_STACK_COOKIE | DATA_OTHER);
+        break;
+      case 2:
+        UT_ASSERT_NOT_EFI_ERROR (ExPersistSetIgnoreNextPageFault ());
+        Model |= DATA_VALID | DATA_IGNORE_NEXT_PF;
+        break;
+      case 3:
+        UT_ASSERT_NOT_EFI_ERROR (ExPersistClearIgnoreNextPageFault ());
+        Model &= ~DATA_IGNORE_NEXT_PF;
+        break;
+      case 4:
+        //
+        // More than one exception recorded is reported as invalid.
+        //
+        Exceptions = Model & (DATA_PAGE_FAULT | DATA_STACK_COOKIE | DATA_OTHER);
+        UT_ASSERT_STATUS_EQUAL (
+          ExPersistGetException (&Exception),
+          (((Model & DATA_VALID) != 0) && ((Exceptions & (Exceptions - 1)) != 0)) ? EFI_INVALID_PARAMETER : EFI_SUCCESS
+          );
+        break;
+      default:
+        if (Random () % 8 == 0) {
+          UT_ASSERT_NOT_EFI_ERROR (ExPersistClearAll ());
+          Model = 0;
+        }
+
+        break;
+    }
+
+    UT_ASSERT_EQUAL (CmosRead16 (CMOS_DATA), Model);
+    UT_ASSERT_TRUE (CmosChecksumValid ());
+    UT_ASSERT_EQUAL (mRtc.Cmos[CMOS_TEST], CMOS_TEST_VAL);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A value written by the single record version is read, and updated, as it was.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LegacyLayoutIsRead (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EXCEPTION_TYPE  Exception;
+  BOOLEAN         Ignore;
+
+  CmosWriteLegacy (DATA_VALID | DATA_PAGE_FAULT | DATA_IGNORE_NEXT_PF);
+
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistGetException (&Exception));
+  UT_ASSERT_EQUAL (Exception, ExceptionPersistPageFault);
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistGetIgnoreNextPageFault (&Ignore));
+  UT_ASSERT_TRUE (Ignore);
+
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistClearExceptions ());
+  UT_ASSERT_EQUAL (CmosRead16 (CMOS_DATA), DATA_VALID | DATA_IGNORE_NEXT_PF);
+  UT_ASSERT_TRUE (CmosChecksumValid ());
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A bad checksum fails every call but ExPersistClearAll(), and nothing is written on failure.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BadChecksumIsRefused (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8           Before[CMOS_SIZE];
+  EXCEPTION_TYPE  Exception;
+  BOOLEAN         Ignore;
+  UINTN           Count;
+
+  CmosWriteLegacy (DATA_VALID | DATA_PAGE_FAULT);
+  mRtc.Cmos[CMOS_CHECKSUM] ^= 0x5A;
+  CopyMem (Before, mRtc.Cmos, sizeof (Before));
+
+  UT_ASSERT_STATUS_EQUAL (ExPersistGetException (&Exception), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (ExPersistGetIgnoreNextPageFault (&Ignore), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (ExPersistSetException (ExceptionPersistOther), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (ExPersistClearExceptions (), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (ExPersistSetIgnoreNextPageFault (), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (ExPersistClearIgnoreNextPageFault (), EFI_INVALID_PARAMETER);
+  if (HISTORY_DEPTH != 0) {
+    Count = 0;
+    UT_ASSERT_STATUS_EQUAL (ExPersistGetExceptionHistory (NULL, &Count), EFI_INVALID_PARAMETER);
+  }
+
+  UT_ASSERT_MEM_EQUAL (mRtc.Cmos, Before, sizeof (Before));
+
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistClearAll ());
+  UT_ASSERT_EQUAL (CmosRead16 (CMOS_DATA), 0);
+  UT_ASSERT_TRUE (CmosChecksumValid ());
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistSetException (ExceptionPersistOther));
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistGetException (&Exception));
+  UT_ASSERT_EQUAL (Exception, ExceptionPersistOther);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Without CMOS behind the ports every call fails with EFI_DEVICE_ERROR.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DeadCmosIsReported (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EXCEPTION_TYPE  Exception;
+  BOOLEAN         Ignore;
+  UINTN           Count;
+
+  mRtc.Dead = TRUE;
+
+  UT_ASSERT_STATUS_EQUAL (ExPersistGetException (&Exception), EFI_DEVICE_ERROR);
+  UT_ASSERT_STATUS_EQUAL (ExPersistGetIgnoreNextPageFault (&Ignore), EFI_DEVICE_ERROR);
+  UT_ASSERT_STATUS_EQUAL (ExPersistSetException (ExceptionPersistPageFault), EFI_DEVICE_ERROR);
+  UT_ASSERT_STATUS_EQUAL (ExPersistClearExceptions (), EFI_DEVICE_ERROR);
+  UT_ASSERT_STATUS_EQUAL (ExPersistSetIgnoreNextPageFault (), EFI_DEVICE_ERROR);
+  UT_ASSERT_STATUS_EQUAL (ExPersistClearIgnoreNextPageFault (), EFI_DEVICE_ERROR);
+  UT_ASSERT_STATUS_EQUAL (ExPersistClearAll (), EFI_DEVICE_ERROR);
+  if (HISTORY_DEPTH != 0) {
+    Count = 0;
+    UT_ASSERT_STATUS_EQUAL (ExPersistGetExceptionHistory (NULL, &Count), EFI_DEVICE_ERROR);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The history keeps the newest exceptions, newest first, and writes its slots in turn.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+HistoryKeepsNewest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EXCEPTION_TYPE  Recorded[3 * 8];
+  EXCEPTION_TYPE  History[8];
+  UINTN           Count;
+  UINTN           Index;
+  UINTN           Slot;
+
+  if (HISTORY_DEPTH == 0) {
+    Count = 0;
+    UT_ASSERT_STATUS_EQUAL (ExPersistGetExceptionHistory (NULL, &Count), EFI_UNSUPPORTED);
+    return UNIT_TEST_SKIPPED;
+  }
+
+  Count = 0;
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistGetExceptionHistory (NULL, &Count));
+  UT_ASSERT_EQUAL (Count, 0);
+
+  for (Index = 0; Index < 3 * HISTORY_DEPTH; Index++) {
+    Recorded[Index] = (EXCEPTION_TYPE)(ExceptionPersistPageFault + Random () % (ExceptionPersistMax - ExceptionPersistPageFault));
+    UT_ASSERT_NOT_EFI_ERROR (ExPersistSetException (Recorded[Index]));
+
+    Count = 0;
+    UT_ASSERT_STATUS_EQUAL (ExPersistGetExceptionHistory (NULL, &Count), EFI_BUFFER_TOO_SMALL);
+    UT_ASSERT_EQUAL (Count, MIN (Index + 1, HISTORY_DEPTH));
+
+    UT_ASSERT_NOT_EFI_ERROR (ExPersistGetExceptionHistory (History, &Count));
+    for (Slot = 0; Slot < Count; Slot++) {
+      UT_ASSERT_EQUAL (History[Slot], Recorded[Index - Slot]);
+    }
+  }
+
+  //
+  // Each slot took one of every HISTORY_DEPTH records.
+  //
+  for (Slot = 0; Slot < HISTORY_DEPTH; Slot++) {
+    UT_ASSERT_EQUAL (mRtc.Writes[CMOS_HISTORY + Slot], 3);
+  }
+
+  UT_ASSERT_TRUE (CmosChecksumValid ());
+
+  Count = ARRAY_SIZE (History);
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistClearExceptions ());
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistGetExceptionHistory (History, &Count));
+  UT_ASSERT_EQUAL (Count, HISTORY_DEPTH);
+
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistClearAll ());
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistGetExceptionHistory (History, &Count));
+  UT_ASSERT_EQUAL (Count, 0);
+
+  //
+  // A head left by a build with a deeper history starts the ring over.
+  //
+  mRtc.Cmos[CMOS_HISTORY_HEAD] = 0xFF;
+  UT_ASSERT_STATUS_EQUAL (ExPersistGetExceptionHistory (History, &Count), EFI_INVALID_PARAMETER);
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistSetException (ExceptionPersistStackCookie));
+  Count = ARRAY_SIZE (History);
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistGetExceptionHistory (History, &Count));
+  UT_ASSERT_EQUAL (Count, 1);
+  UT_ASSERT_EQUAL (History[0], ExceptionPersistStackCookie);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Counts the port accesses of each call and compares them with the single record version.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+PortAccessCounts (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EXCEPTION_TYPE  Exception;
+  UINTN           Get;
+  UINTN           Set;
+  UINTN           Clear;
+  UINTN           ClearAll;
+  UINTN           Unchanged;
+
+  mRtc.Accesses = 0;
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistGetException (&Exception));
+  Get = mRtc.Accesses;
+
+  mRtc.Accesses = 0;
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistSetException (ExceptionPersistPageFault));
+  Set = mRtc.Accesses;
+
+  mRtc.Accesses = 0;
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistSetIgnoreNextPageFault ());
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistSetIgnoreNextPageFault ());
+  mRtc.Accesses = 0;
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistSetIgnoreNextPageFault ());
+  Unchanged = mRtc.Accesses;
+
+  mRtc.Accesses = 0;
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistClearExceptions ());
+  Clear = mRtc.Accesses;
+
+  mRtc.Accesses = 0;
+  UT_ASSERT_NOT_EFI_ERROR (ExPersistClearAll ());
+  ClearAll = mRtc.Accesses;
+
+  UT_LOG_INFO (
+    "Port accesses: get %d (was %d), set %d (was %d), set unchanged %d, clear %d (was %d), clear all %d (was %d)\n",
+    (UINT32)Get,
+    LEGACY_GET_ACCESSES,
+    (UINT32)Set,
+    LEGACY_UPDATE_ACCESSES,
+    (UINT32)Unchanged,
+    (UINT32)Clear,
+    LEGACY_UPDATE_ACCESSES,
+    (UINT32)ClearAll,
+    LEGACY_CLEAR_ALL_ACCESSES
+    );
+
+  UT_ASSERT_TRUE (Get < LEGACY_GET_ACCESSES);
+  UT_ASSERT_TRUE (Set < LEGACY_UPDATE_ACCESSES);
+  UT_ASSERT_TRUE (Clear < LEGACY_UPDATE_ACCESSES);
+  UT_ASSERT_TRUE (ClearAll < LEGACY_CLEAR_ALL_ACCESSES);
+
+  //
+  // A call that changes nothing only checks CMOS and reads the region.
+  //
+  UT_ASSERT_EQUAL (Unchanged, Get);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  CMOS instance of ExceptionPersistenceLib and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      CmosSuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&CmosSuiteHandle, Framework, "Exception persistence in CMOS tests", "ExceptionPersistenceLibCmos", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for CmosSuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (CmosSuiteHandle, "Exceptions read back as set", "RoundTrip", ExceptionsRoundTrip, SetUpCmos, NULL, NULL);
+  AddTestCase (CmosSuiteHandle, "The checksum matches the full sum", "Checksum", ChecksumMatchesFullSum, SetUpCmos, NULL, NULL);
+  AddTestCase (CmosSuiteHandle, "The single record layout is read", "LegacyLayout", LegacyLayoutIsRead, SetUpCmos, NULL, NULL);
+  AddTestCase (CmosSuiteHandle, "A bad checksum is refused", "BadChecksum", BadChecksumIsRefused, SetUpCmos, NULL, NULL);
+  AddTestCase (CmosSuiteHandle, "Dead CMOS is reported", "DeadCmos", DeadCmosIsReported, SetUpCmos, NULL, NULL);
+  AddTestCase (CmosSuiteHandle, "The history keeps the newest exceptions", "History", HistoryKeepsNewest, SetUpCmos, NULL, NULL);
+  AddTestCase (CmosSuiteHandle, "Port accesses per call", "PortAccesses", PortAccessCounts, SetUpCmos, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
@@ -0,0 +1,299 @@
+/** @file
+  PBKDF2 with HMAC-SHA256 and HMAC-SHA384
+
+Copyright (C) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseCryptLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+#include "Pbkdf2HmacSha.h"
+
+#define PBKDF2_MAX_BLOCK_SIZE   128
+#define PBKDF2_MAX_DIGEST_SIZE  SHA384_DIGEST_SIZE
+
+//
+// Pkcs5HashPassword refuses sizes and counts that do not fit an INT32.
+//
+#define PBKDF2_MAX_LENGTH  MAX_INT32
+
+typedef
+UINTN
+(EFIAPI *PBKDF2_HASH_GET_CONTEXT_SIZE)(
+  VOID
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *PBKDF2_HASH_INIT)(
+  OUT VOID  *HashContext
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *PBKDF2_HASH_DUPLICATE)(
+  IN  CONST VOID  *HashContext,
+  OUT VOID        *NewHashContext
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *PBKDF2_HASH_UPDATE)(
+  IN OUT VOID        *HashContext,
+  IN     CONST VOID  *Data,
+  IN     UINTN       DataSize
+  );
+
+typedef
+BOOLEAN
+(EFIAPI *PBKDF2_HASH_FINAL)(
+  IN OUT VOID   *HashContext,
+  OUT    UINT8  *HashValue
+  );
+
+typedef struct {
+  UINTN                           DigestSize;
+  UINTN                           BlockSize;
+  PBKDF2_HASH_GET_CONTEXT_SIZE    GetContextSize;
+  PBKDF2_HASH_INIT                Init;
+  PBKDF2_HASH_DUPLICATE           Duplicate;
+  PBKDF2_HASH_UPDATE              Update;
+  PBKDF2_HASH_FINAL               Final;
+} PBKDF2_HASH;
+
+STATIC CONST PBKDF2_HASH  mPbkdf2Hashes[] = {
+  { SHA256_DIGEST_SIZE, 64,  Sha256GetContextSize, Sha256Init, Sha256Duplicate, Sha256Update, Sha256Final },
+  { SHA384_DIGEST_SIZE, 128, Sha384GetContextSize, Sha384Init, Sha384Duplicate, Sha384Update, Sha384Final },
+};
+
+//
+// Hash states after the pads, and the context each HMAC call works in.
+//
+typedef struct {
+  CONST PBKDF2_HASH    *Hash;
+  VOID                 *Inner;
+  VOID                 *Outer;
+  VOID                 *Work;
+} PBKDF2_HMAC;
+
+/**
+  Hashes the password, padded with Pad, into Context.
+
+  @param[in]  Hash     Hash to use.
+  @param[in]  Key      HMAC key, no longer than the block size.
+  @param[in]  KeySize  Size of Key in bytes.
+  @param[in]  Pad      0x36 for the inner pad, 0x5C for the outer one.
+  @param[out] Context  Receives the hash state.
+
+  @retval TRUE   Context holds the hash state after the pad.
+  @retval FALSE  A hash function failed.
+**/
+STATIC
+BOOLEAN
+HashPad (
+  IN  CONST PBKDF2_HASH  *Hash,
+  IN  CONST UINT8        *Key,
+  IN  UINTN              KeySize,
+  IN  UINT8              Pad,
+  OUT VOID               *Context
+  )
+{
+  UINT8  Block[PBKDF2_MAX_BLOCK_SIZE];
+  UINTN  Index;
+
+  SetMem (Block, Hash->BlockSize, Pad);
+  for (Index = 0; Index < KeySize; Index++) {
+    Block[Index] ^= Key[Index];
+  }
+
+  return Hash->Init (Context) && Hash->Update (Context, Block, Hash->BlockSize);
+}
+
+/**
+  Computes HMAC (Password, Data) from the precomputed pad states.
+
+  @param[in]  Hmac      Keyed HMAC.
+  @param[in]  Data      Message.
+  @param[in]  DataSize  Size of Data in bytes.
+  @param[in]  Data2     Optional message continuation.
+  @param[in]  Data2Size Size of Data2 in bytes.
+  @param[out] Mac       Receives Hmac->Hash->DigestSize bytes.  May be the same as Data.
+
+  @retval TRUE   Mac is valid.
+  @retval FALSE  A hash function failed.
+**/
+STATIC
+BOOLEAN
+HmacCompute (
+  IN  PBKDF2_HMAC  *Hmac,
+  IN  CONST UINT8  *Data,
+  IN  UINTN        DataSize,
+  IN  CONST UINT8  *Data2      OPTIONAL,
+  IN  UINTN        Data2Size,
+  OUT UINT8        *Mac
+  )
+{
+  CONST PBKDF2_HASH  *Hash;
+
+  Hash = Hmac->Hash;
+  if (!Hash->Duplicate (Hmac->Inner, Hmac->Work) ||
+      !Hash->Update (Hmac->Work, Data, DataSize) ||
+      ((Data2Size != 0) && !Hash->Update (Hmac->Work, Data2, Data2Size)) ||
+      !Hash->Final (Hmac->Work, Mac))
+  {
+    return FALSE;
+  }
+
+  return Hash->Duplicate (Hmac->Outer, Hmac->Work) &&
+         Hash->Update (Hmac->Work, Mac, Hash->DigestSize) &&
+         Hash->Final (Hmac->Work, Mac);
+}
+
+/**
+  Derives a key from a password with PBKDF2, as defined in RFC 8018.  The output is the same
+  as Pkcs5HashPassword gives for the same parameters.
+
+  @param[in]  PasswordSize    Size of Password in bytes.
+  @param[in]  Password        Password.
+  @param[in]  SaltSize        Size of Salt in bytes.
+  @param[in]  Salt            Salt.
+  @param[in]  IterationCount  Number of iterations.
+  @param[in]  DigestSize      SHA256_DIGEST_SIZE or SHA384_DIGEST_SIZE, selecting the hash.
+  @param[in]  OutputSize      Size of Output in bytes.
+  @param[out] Output          Receives the derived key.
+
+  @retval EFI_SUCCESS            The key is in Output.
+  @retval EFI_INVALID_PARAMETER  A pointer is NULL, or a size or IterationCount is out of range.
+  @retval EFI_UNSUPPORTED        DigestSize does not select a hash supported here.
+  @retval EFI_OUT_OF_RESOURCES   There is not enough memory.
+  @retval EFI_ABORTED            A hash function failed.
+**/
+EFI_STATUS
+Pbkdf2HmacSha (
+  IN  UINTN        PasswordSize,
+  IN  CONST CHAR8  *Password,
+  IN  UINTN        SaltSize,
+  IN  CONST UINT8  *Salt,
+  IN  UINTN        IterationCount,
+  IN  UINTN        DigestSize,
+  IN  UINTN        OutputSize,
+  OUT UINT8        *Output
+  )
+{
+  EFI_STATUS   Status;
+  PBKDF2_HMAC  Hmac;
+  UINTN        Index;
+  UINTN        ContextSize;
+  UINT8        Key[PBKDF2_MAX_DIGEST_SIZE];
+  CONST UINT8  *KeyData;
+  UINTN        KeySize;
+  UINT8        BlockIndex[4];
+  UINT32       Block;
+  UINT8        U[PBKDF2_MAX_DIGEST_SIZE];
+  UINT8        T[PBKDF2_MAX_DIGEST_SIZE];
+  UINTN        Iteration;
+  UINTN        Length;
+
+  if ((Password == NULL) || (Salt == NULL) || (Output == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((PasswordSize == 0) || (PasswordSize > PBKDF2_MAX_LENGTH) ||
+      (SaltSize > PBKDF2_MAX_LENGTH) ||
+      (OutputSize == 0) || (OutputSize > PBKDF2_MAX_LENGTH) ||
+      (IterationCount == 0) || (IterationCount > PBKDF2_MAX_LENGTH))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ZeroMem (&Hmac, sizeof (Hmac));
+  for (Index = 0; Index < ARRAY_SIZE (mPbkdf2Hashes); Index++) {
+    if (mPbkdf2Hashes[Index].DigestSize == DigestSize) {
+      Hmac.Hash = &mPbkdf2Hashes[Index];
+      break;
+    }
+  }
+
+  if (Hmac.Hash == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  ContextSize = Hmac.Hash->GetContextSize ();
+  Hmac.Inner  = AllocatePool (3 * ContextSize);
+  if (Hmac.Inner == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Hmac.Outer = (UINT8 *)Hmac.Inner + ContextSize;
+  Hmac.Work  = (UINT8 *)Hmac.Outer + ContextSize;
+  Status     = EFI_ABORTED;
+
+  //
+  // A password longer than a block is replaced by its hash, as HMAC requires.
+  //
+  KeyData = (CONST UINT8 *)Password;
+  KeySize = PasswordSize;
+  if (PasswordSize > Hmac.Hash->BlockSize) {
+    if (!Hmac.Hash->Init (Hmac.Work) ||
+        !Hmac.Hash->Update (Hmac.Work, Password, PasswordSize) ||
+        !Hmac.Hash->Final (Hmac.Work, Key))
+    {
+      goto Exit;
+    }
+
+    KeyData = Key;
+    KeySize = DigestSize;
+  }
+
+  if (!HashPad (Hmac.Hash, KeyData, KeySize, 0x36, Hmac.Inner) ||
+      !HashPad (Hmac.Hash, KeyData, KeySize, 0x5C, Hmac.Outer))
+  {
+    goto Exit;
+  }
+
+  //
+  // T_Block = U_1 ^ U_2 ^ ... ^ U_IterationCount, with U_1 = HMAC (Password, Salt || Block)
+  // and U_n = HMAC (Password, U_n-1).  The key is T_1 || T_2 || ..., cut to OutputSize.
+  //
+  for (Block = 1; OutputSize != 0; Block++) {
+    BlockIndex[0] = (UINT8)(Block >> 24);
+    BlockIndex[1] = (UINT8)(Block >> 16);
+    BlockIndex[2] = (UINT8)(Block >> 8);
+    BlockIndex[3] = (UINT8)Block;
+    if (!HmacCompute (&Hmac, Salt, SaltSize, BlockIndex, sizeof (BlockIndex), U)) {
+      goto Exit;
+    }
+
+    CopyMem (T, U, DigestSize);
+    for (Iteration = 1; Iteration < IterationCount; Iteration++) {
+      if (!HmacCompute (&Hmac, U, DigestSize, NULL, 0, U)) {
+        goto Exit;
+      }
+
+      for (Index = 0; Index < DigestSize; Index++) {
+        T[Index] ^= U[Index];
+      }
+    }
+
+    Length = MIN (OutputSize, DigestSize);
+    CopyMem (Output, T, Length);
+    Output     += Length;
+    OutputSize -= Length;
+  }
+
+  Status = EFI_SUCCESS;
+
+Exit:
+  ZeroMem (Key, sizeof (Key));
+  ZeroMem (U, sizeof (U));
+  ZeroMem (T, sizeof (T));
+  ZeroMem (Hmac.Inner, 3 * ContextSize);
+  FreePool (Hmac.Inner);
+  return Status;
+}
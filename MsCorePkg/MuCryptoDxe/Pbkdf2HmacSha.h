@@ -0,0 +1,48 @@
+/** @file
+  PBKDF2 with HMAC-SHA256 and HMAC-SHA384
+
+  Pkcs5HashPassword sets up a new HMAC, padding the password again, for each of the
+  IterationCount HMAC calls.  Here the hash states after the inner and the outer pad are
+  computed once per password, and each HMAC call copies them and only hashes the previous
+  result, into contexts allocated once per call.
+
+Copyright (C) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef PBKDF2_HMAC_SHA_H_
+#define PBKDF2_HMAC_SHA_H_
+
+/**
+  Derives a key from a password with PBKDF2, as defined in RFC 8018.  The output is the same
+  as Pkcs5HashPassword gives for the same parameters.
+
+  @param[in]  PasswordSize    Size of Password in bytes.
+  @param[in]  Password        Password.
+  @param[in]  SaltSize        Size of Salt in bytes.
+  @param[in]  Salt            Salt.
+  @param[in]  IterationCount  Number of iterations.
+  @param[in]  DigestSize      SHA256_DIGEST_SIZE or SHA384_DIGEST_SIZE, selecting the hash.
+  @param[in]  OutputSize      Size of Output in bytes.
+  @param[out] Output          Receives the derived key.
+
+  @retval EFI_SUCCESS            The key is in Output.
+  @retval EFI_INVALID_PARAMETER  A pointer is NULL, or a size or IterationCount is out of range.
+  @retval EFI_UNSUPPORTED        DigestSize does not select a hash supported here.
+  @retval EFI_OUT_OF_RESOURCES   There is not enough memory.
+  @retval EFI_ABORTED            A hash function failed.
+**/
+EFI_STATUS
+Pbkdf2HmacSha (
+  IN  UINTN        PasswordSize,
+  IN  CONST CHAR8  *Password,
+  IN  UINTN        SaltSize,
+  IN  CONST UINT8  *Salt,
+  IN  UINTN        IterationCount,
+  IN  UINTN        DigestSize,
+  IN  UINTN        OutputSize,
+  OUT UINT8        *Output
+  );
+
+#endif // PBKDF2_HMAC_SHA_H_
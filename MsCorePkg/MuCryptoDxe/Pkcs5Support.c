@@ -11,10 +11,13 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiBootServicesTableLib.h>
 #include <Protocol/MuPkcs5PasswordHash.h>
 
+#include "Pbkdf2HmacSha.h"
+
 MU_PKCS5_PASSWORD_HASH_PROTOCOL  mPkcs5PwHashProtocol;
 
 /**
-Pkcs5 wrapper function - This is basically a pass thru to the BaseCryptLib .
+Pkcs5 wrapper function - SHA256 and SHA384 use the PBKDF2 in Pbkdf2HmacSha.c, which gives the
+same output in far less time.  Other digests pass thru to the BaseCryptLib .
 
 
 **/
@@ -37,16 +40,28 @@ HashUsingPkcs5 (
     return EFI_INVALID_PARAMETER;
   }
 
-  return Pkcs5HashPassword (
-           PasswordSize,                            // Size
-           Password,                                // Password
-           SaltSize,                                // SaltSize
-           Salt,                                    // Salt
-           IterationCount,                          // IterationCount
-           DigestSize,                              // DigestSize
-           OutputSize,                              // OutputSize
-           Output
-           );
+  if ((DigestSize == SHA256_DIGEST_SIZE) || (DigestSize == SHA384_DIGEST_SIZE)) {
+    return Pbkdf2HmacSha (PasswordSize, Password, SaltSize, Salt, IterationCount, DigestSize, OutputSize, Output);
+  }
+
+  //
+  // Pkcs5HashPassword returns a BOOLEAN, not an EFI_STATUS.
+  //
+  if (!Pkcs5HashPassword (
+         PasswordSize,                              // Size
+         Password,                                  // Password
+         SaltSize,                                  // SaltSize
+         Salt,                                      // Salt
+         IterationCount,                            // IterationCount
+         DigestSize,                                // DigestSize
+         OutputSize,                                // OutputSize
+         Output
+         ))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return EFI_SUCCESS;
 }
 
 /**
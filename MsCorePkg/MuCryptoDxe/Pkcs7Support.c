@@ -11,8 +11,12 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiBootServicesTableLib.h>
 
 #include <Protocol/MuPkcs7.h>
+#include <Protocol/MuPkcs7TrustedCert.h>
 
-MU_PKCS7_PROTOCOL  mPkcsProt;
+#include "Pkcs7TrustedCert.h"
+
+MU_PKCS7_PROTOCOL               mPkcsProt;
+MU_PKCS7_TRUSTED_CERT_PROTOCOL  mPkcsTrustedCertProt;
 
 /**
 Pkcs7 Verify function - This is basically a pass thru to the BaseCryptLib .
@@ -64,6 +68,8 @@ UninstallPkcs7Support (
                 ImageHandle,
                 &gMuPKCS7ProtocolGuid,
                 &mPkcsProt,
+                &gMuPkcs7TrustedCertProtocolGuid,
+                &mPkcsTrustedCertProt,
                 NULL
                 );
 }
@@ -117,6 +123,159 @@ Exit:
   return Status;
 }// VerifyEKUFunc()
 
+/**
+Pkcs7 Register Trusted Cert function - Checks the certificate once and returns a handle
+that VerifyWithTrustedCert and VerifyBatch accept.
+
+**/
+EFI_STATUS
+EFIAPI
+RegisterTrustedCertFunc (
+  IN  CONST MU_PKCS7_TRUSTED_CERT_PROTOCOL  *This,
+  IN  CONST UINT8                           *TrustedCert,
+  IN  UINTN                                 TrustedCertLength,
+  OUT MU_PKCS7_TRUSTED_CERT_HANDLE          *Handle
+  )
+{
+  EFI_STATUS    Status;
+  TRUSTED_CERT  *Entry;
+
+  if (This != &mPkcsTrustedCertProt) {
+    DEBUG ((DEBUG_ERROR, "%a - Invalid This pointer\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((TrustedCert == NULL) || (Handle == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a - Invalid input parameter.  Pointer can not be NULL\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = TrustedCertRegister (TrustedCert, TrustedCertLength, &Entry);
+  if (!EFI_ERROR (Status)) {
+    *Handle = (MU_PKCS7_TRUSTED_CERT_HANDLE)Entry;
+  }
+
+  return Status;
+}
+
+/**
+Pkcs7 Unregister Trusted Cert function - Releases a handle from RegisterTrustedCert.
+
+**/
+EFI_STATUS
+EFIAPI
+UnregisterTrustedCertFunc (
+  IN CONST MU_PKCS7_TRUSTED_CERT_PROTOCOL  *This,
+  IN MU_PKCS7_TRUSTED_CERT_HANDLE          Handle
+  )
+{
+  TRUSTED_CERT  *Entry;
+
+  if (This != &mPkcsTrustedCertProt) {
+    DEBUG ((DEBUG_ERROR, "%a - Invalid This pointer\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Entry = TrustedCertFromHandle (Handle);
+  if (Entry == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a - Invalid trusted certificate handle\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  DEBUG ((
+    DEBUG_INFO,
+    "%a - %u chain verifications, %u repeated messages.\n",
+    __FUNCTION__,
+    (UINT32)Entry->ChainVerifications,
+    (UINT32)Entry->VerifiedHits
+    ));
+  TrustedCertUnregister (Entry);
+  return EFI_SUCCESS;
+}
+
+/**
+Pkcs7 Verify With Trusted Cert function - Same as Verify, against a registered certificate.
+
+**/
+EFI_STATUS
+EFIAPI
+VerifyWithTrustedCertFunc (
+  IN CONST MU_PKCS7_TRUSTED_CERT_PROTOCOL  *This,
+  IN MU_PKCS7_TRUSTED_CERT_HANDLE          Handle,
+  IN CONST UINT8                           *P7Data,
+  IN UINTN                                 P7DataLength,
+  IN CONST UINT8                           *Data,
+  IN UINTN                                 DataLength
+  )
+{
+  TRUSTED_CERT  *Entry;
+  EFI_STATUS    Status;
+
+  if (This != &mPkcsTrustedCertProt) {
+    DEBUG ((DEBUG_ERROR, "%a - Invalid This pointer\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Entry = TrustedCertFromHandle (Handle);
+  if ((Entry == NULL) || (P7Data == NULL) || (Data == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a - Invalid input parameter.  Pointer can not be NULL\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = TrustedCertVerify (Entry, P7Data, P7DataLength, Data, DataLength);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_INFO, "%a - Data did not validate.\n", __FUNCTION__));
+  }
+
+  return Status;
+}
+
+/**
+Pkcs7 Verify Batch function - Verifies several payloads against one registered certificate.
+
+**/
+EFI_STATUS
+EFIAPI
+VerifyBatchFunc (
+  IN     CONST MU_PKCS7_TRUSTED_CERT_PROTOCOL  *This,
+  IN     MU_PKCS7_TRUSTED_CERT_HANDLE          Handle,
+  IN OUT MU_PKCS7_VERIFY_REQUEST               *Requests,
+  IN     UINTN                                 RequestCount
+  )
+{
+  TRUSTED_CERT  *Entry;
+  EFI_STATUS    Status;
+  UINTN         Index;
+
+  if (This != &mPkcsTrustedCertProt) {
+    DEBUG ((DEBUG_ERROR, "%a - Invalid This pointer\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Entry = TrustedCertFromHandle (Handle);
+  if ((Entry == NULL) || (Requests == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a - Invalid input parameter.  Pointer can not be NULL\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = EFI_SUCCESS;
+  for (Index = 0; Index < RequestCount; Index++) {
+    Requests[Index].Status = TrustedCertVerify (
+                               Entry,
+                               Requests[Index].P7Data,
+                               Requests[Index].P7DataLength,
+                               Requests[Index].Data,
+                               Requests[Index].DataLength
+                               );
+    if (EFI_ERROR (Requests[Index].Status) && !EFI_ERROR (Status)) {
+      Status = Requests[Index].Status;
+    }
+  }
+
+  DEBUG ((DEBUG_INFO, "%a - %u payloads verified.  %r\n", __FUNCTION__, (UINT32)RequestCount, Status));
+  return Status;
+}
+
 /**
 Function to install Pkcs7 Protocol for other drivers to use
 
@@ -130,10 +289,17 @@ InstallPkcs7Support (
   mPkcsProt.Verify    = VerifyFunc;
   mPkcsProt.VerifyEKU = VerifyEKUFunc;
 
+  mPkcsTrustedCertProt.RegisterTrustedCert   = RegisterTrustedCertFunc;
+  mPkcsTrustedCertProt.UnregisterTrustedCert = UnregisterTrustedCertFunc;
+  mPkcsTrustedCertProt.VerifyWithTrustedCert = VerifyWithTrustedCertFunc;
+  mPkcsTrustedCertProt.VerifyBatch           = VerifyBatchFunc;
+
   return gBS->InstallMultipleProtocolInterfaces (
                 &ImageHandle,
                 &gMuPKCS7ProtocolGuid,
                 &mPkcsProt,
+                &gMuPkcs7TrustedCertProtocolGuid,
+                &mPkcsTrustedCertProt,
                 NULL
                 );
 }
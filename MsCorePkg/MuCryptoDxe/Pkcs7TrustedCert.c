@@ -0,0 +1,227 @@
+/** @file
+  Trusted certificates registered for repeated PKCS7 verification
+
+Copyright (C) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseCryptLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+#include "Pkcs7TrustedCert.h"
+
+STATIC LIST_ENTRY  mTrustedCerts = INITIALIZE_LIST_HEAD_VARIABLE (mTrustedCerts);
+
+/**
+  Computes the digest a verified message is remembered by.
+
+  The lengths are hashed with the message and the content, so that moving bytes from the
+  end of one to the start of the other changes the digest.
+
+  @param[in]  P7Data        PKCS7 message.
+  @param[in]  P7DataLength  Length of P7Data in bytes.
+  @param[in]  Data          Content of the message.
+  @param[in]  DataLength    Length of Data in bytes.
+  @param[out] Digest        Receives the SHA256 digest.
+
+  @retval TRUE   Digest is valid.
+  @retval FALSE  There is not enough memory, or the hash failed.
+**/
+STATIC
+BOOLEAN
+GetMessageDigest (
+  IN  CONST UINT8  *P7Data,
+  IN  UINTN        P7DataLength,
+  IN  CONST UINT8  *Data,
+  IN  UINTN        DataLength,
+  OUT UINT8        *Digest
+  )
+{
+  VOID     *HashContext;
+  UINT64   Lengths[2];
+  BOOLEAN  Result;
+
+  HashContext = AllocatePool (Sha256GetContextSize ());
+  if (HashContext == NULL) {
+    return FALSE;
+  }
+
+  Lengths[0] = P7DataLength;
+  Lengths[1] = DataLength;
+  Result     = Sha256Init (HashContext) &&
+               Sha256Update (HashContext, Lengths, sizeof (Lengths)) &&
+               Sha256Update (HashContext, P7Data, P7DataLength) &&
+               Sha256Update (HashContext, Data, DataLength) &&
+               Sha256Final (HashContext, Digest);
+
+  FreePool (HashContext);
+  return Result;
+}
+
+/**
+  Registers a trusted certificate.
+
+  @param[in]  Cert        DER encoded certificate.
+  @param[in]  CertLength  Length of Cert in bytes.
+  @param[out] TrustedCert Receives the registered certificate.
+
+  @retval EFI_SUCCESS            The certificate was registered.
+  @retval EFI_INVALID_PARAMETER  A pointer is NULL or the certificate does not parse.
+  @retval EFI_OUT_OF_RESOURCES   There is not enough memory.
+**/
+EFI_STATUS
+TrustedCertRegister (
+  IN  CONST UINT8   *Cert,
+  IN  UINTN         CertLength,
+  OUT TRUSTED_CERT  **TrustedCert
+  )
+{
+  TRUSTED_CERT  *Entry;
+  UINT8         *X509Cert;
+
+  if ((Cert == NULL) || (CertLength == 0) || (TrustedCert == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Catch a bad certificate here, rather than as a failure of every verification.
+  //
+  X509Cert = NULL;
+  if (!X509ConstructCertificate (Cert, CertLength, &X509Cert)) {
+    DEBUG ((DEBUG_ERROR, "%a - Trusted certificate does not parse\n", __FUNCTION__));
+    return EFI_INVALID_PARAMETER;
+  }
+
+  X509Free (X509Cert);
+
+  Entry = AllocateZeroPool (sizeof (TRUSTED_CERT));
+  if (Entry == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Entry->Cert = AllocateCopyPool (CertLength, Cert);
+  if (Entry->Cert == NULL) {
+    FreePool (Entry);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Entry->Signature  = TRUSTED_CERT_SIGNATURE;
+  Entry->CertLength = CertLength;
+  InsertTailList (&mTrustedCerts, &Entry->Link);
+
+  *TrustedCert = Entry;
+  return EFI_SUCCESS;
+}
+
+/**
+  Looks up a handle returned by TrustedCertRegister.
+
+  @param[in] Handle  Handle to look up.
+
+  @return  The registered certificate, or NULL if Handle is not registered.
+**/
+TRUSTED_CERT *
+TrustedCertFromHandle (
+  IN VOID  *Handle
+  )
+{
+  LIST_ENTRY  *Link;
+
+  if (Handle == NULL) {
+    return NULL;
+  }
+
+  //
+  // Walk the list rather than trusting the pointer, so a stale handle is refused.
+  //
+  for (Link = GetFirstNode (&mTrustedCerts); !IsNull (&mTrustedCerts, Link); Link = GetNextNode (&mTrustedCerts, Link)) {
+    if (Link == &((TRUSTED_CERT *)Handle)->Link) {
+      ASSERT (((TRUSTED_CERT *)Handle)->Signature == TRUSTED_CERT_SIGNATURE);
+      return (TRUSTED_CERT *)Handle;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Unregisters a trusted certificate and frees it.
+
+  @param[in] TrustedCert  Certificate returned by TrustedCertFromHandle.
+**/
+VOID
+TrustedCertUnregister (
+  IN TRUSTED_CERT  *TrustedCert
+  )
+{
+  RemoveEntryList (&TrustedCert->Link);
+  FreePool (TrustedCert->Cert);
+  ZeroMem (TrustedCert, sizeof (TRUSTED_CERT));
+  FreePool (TrustedCert);
+}
+
+/**
+  Verifies a PKCS7 message against a registered trusted certificate.
+
+  @param[in] TrustedCert   Certificate returned by TrustedCertFromHandle.
+  @param[in] P7Data        PKCS7 message to verify.
+  @param[in] P7DataLength  Length of P7Data in bytes.
+  @param[in] Data          Content to be verified.
+  @param[in] DataLength    Length of Data in bytes.
+
+  @retval EFI_SUCCESS             The message is valid.
+  @retval EFI_SECURITY_VIOLATION  The message is not valid.
+  @retval EFI_INVALID_PARAMETER   A pointer is NULL.
+**/
+EFI_STATUS
+TrustedCertVerify (
+  IN TRUSTED_CERT  *TrustedCert,
+  IN CONST UINT8   *P7Data,
+  IN UINTN         P7DataLength,
+  IN CONST UINT8   *Data,
+  IN UINTN         DataLength
+  )
+{
+  UINT8    Digest[SHA256_DIGEST_SIZE];
+  BOOLEAN  HaveDigest;
+  BOOLEAN  Valid;
+  UINTN    Index;
+
+  if ((P7Data == NULL) || (Data == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Only a message and content that are identical to ones which already verified against
+  // the registered certificate skip the verification.  Anything else, including another
+  // message from the same signer, is verified against the registered certificate.
+  //
+  HaveDigest = GetMessageDigest (P7Data, P7DataLength, Data, DataLength, Digest);
+  if (HaveDigest) {
+    for (Index = 0; Index < TrustedCert->VerifiedCount; Index++) {
+      if (CompareMem (TrustedCert->Verified[Index].Digest, Digest, SHA256_DIGEST_SIZE) == 0) {
+        TrustedCert->VerifiedHits++;
+        return EFI_SUCCESS;
+      }
+    }
+  }
+
+  TrustedCert->ChainVerifications++;
+  Valid = Pkcs7Verify (P7Data, P7DataLength, TrustedCert->Cert, TrustedCert->CertLength, Data, DataLength);
+  if (Valid && HaveDigest) {
+    if (TrustedCert->VerifiedCount < TRUSTED_CERT_VERIFIED_CACHE_SIZE) {
+      TrustedCert->VerifiedCount++;
+    }
+
+    CopyMem (TrustedCert->Verified[TrustedCert->VerifiedNext].Digest, Digest, SHA256_DIGEST_SIZE);
+    TrustedCert->VerifiedNext = (TrustedCert->VerifiedNext + 1) % TRUSTED_CERT_VERIFIED_CACHE_SIZE;
+  }
+
+  return Valid ? EFI_SUCCESS : EFI_SECURITY_VIOLATION;
+}
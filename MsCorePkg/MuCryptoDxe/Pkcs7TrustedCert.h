@@ -0,0 +1,106 @@
+/** @file
+  Trusted certificates registered for repeated PKCS7 verification
+
+  BaseCryptLib only verifies against a DER encoded trusted certificate, and builds the
+  certificate and trust store from it on every Pkcs7Verify call; it cannot keep a parsed
+  store.  A registered certificate is checked once when it is registered, and keeps the
+  digests of the messages that verified against it.  Every other message is verified
+  against the registered certificate; a signer is never used as a trust anchor.  Pkcs7Verify
+  does not check validity times, so a message and content that verified once always do.
+
+Copyright (C) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef PKCS7_TRUSTED_CERT_H_
+#define PKCS7_TRUSTED_CERT_H_
+
+#include <Library/BaseCryptLib.h>
+
+#define TRUSTED_CERT_SIGNATURE  SIGNATURE_32 ('P', '7', 'T', 'C')
+
+//
+// Verified messages remembered per trusted certificate.  The oldest is forgotten first.
+//
+#define TRUSTED_CERT_VERIFIED_CACHE_SIZE  8
+
+typedef struct {
+  UINT8    Digest[SHA256_DIGEST_SIZE];        // SHA256 of the PKCS7 message and the content.
+} TRUSTED_VERIFIED;
+
+typedef struct {
+  UINT32              Signature;
+  LIST_ENTRY          Link;
+  UINT8               *Cert;
+  UINTN               CertLength;
+  TRUSTED_VERIFIED    Verified[TRUSTED_CERT_VERIFIED_CACHE_SIZE];
+  UINTN               VerifiedCount;
+  UINTN               VerifiedNext;
+  UINTN               ChainVerifications;     // Verifications against the registered certificate.
+  UINTN               VerifiedHits;           // Messages found among the verified ones.
+} TRUSTED_CERT;
+
+/**
+  Registers a trusted certificate.
+
+  @param[in]  Cert        DER encoded certificate.
+  @param[in]  CertLength  Length of Cert in bytes.
+  @param[out] TrustedCert Receives the registered certificate.
+
+  @retval EFI_SUCCESS            The certificate was registered.
+  @retval EFI_INVALID_PARAMETER  A pointer is NULL or the certificate does not parse.
+  @retval EFI_OUT_OF_RESOURCES   There is not enough memory.
+**/
+EFI_STATUS
+TrustedCertRegister (
+  IN  CONST UINT8   *Cert,
+  IN  UINTN         CertLength,
+  OUT TRUSTED_CERT  **TrustedCert
+  );
+
+/**
+  Looks up a handle returned by TrustedCertRegister.
+
+  @param[in] Handle  Handle to look up.
+
+  @return  The registered certificate, or NULL if Handle is not registered.
+**/
+TRUSTED_CERT *
+TrustedCertFromHandle (
+  IN VOID  *Handle
+  );
+
+/**
+  Unregisters a trusted certificate and frees it.
+
+  @param[in] TrustedCert  Certificate returned by TrustedCertFromHandle.
+**/
+VOID
+TrustedCertUnregister (
+  IN TRUSTED_CERT  *TrustedCert
+  );
+
+/**
+  Verifies a PKCS7 message against a registered trusted certificate.
+
+  @param[in] TrustedCert   Certificate returned by TrustedCertFromHandle.
+  @param[in] P7Data        PKCS7 message to verify.
+  @param[in] P7DataLength  Length of P7Data in bytes.
+  @param[in] Data          Content to be verified.
+  @param[in] DataLength    Length of Data in bytes.
+
+  @retval EFI_SUCCESS             The message is valid.
+  @retval EFI_SECURITY_VIOLATION  The message is not valid.
+  @retval EFI_INVALID_PARAMETER   A pointer is NULL.
+**/
+EFI_STATUS
+TrustedCertVerify (
+  IN TRUSTED_CERT  *TrustedCert,
+  IN CONST UINT8   *P7Data,
+  IN UINTN         P7DataLength,
+  IN CONST UINT8   *Data,
+  IN UINTN         DataLength
+  );
+
+#endif // PKCS7_TRUSTED_CERT_H_
@@ -0,0 +1,143 @@
+/**
+  Unit test data supporting the MuCryptoDxe PKCS7 trusted certificate tests
+
+  Signed by the FwPolicy test leaf from MfciPkg, with the content attached.  Only the leaf
+  is carried, not the CA that issued it, so it does not chain to Root.cer on its own.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+CONST  UINT8  mSigned_leaf_only[] = {
+  0x30, 0x82, 0x08, 0x3b, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x07, 0x02, 0xa0,
+  0x82, 0x08, 0x2c, 0x30, 0x82, 0x08, 0x28, 0x02, 0x01, 0x01, 0x31, 0x0f, 0x30, 0x0d, 0x06, 0x09,
+  0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x30, 0x50, 0x06, 0x09, 0x2a,
+  0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x07, 0x01, 0xa0, 0x43, 0x04, 0x41, 0x53, 0x69, 0x67, 0x6e,
+  0x65, 0x64, 0x20, 0x62, 0x79, 0x20, 0x74, 0x68, 0x65, 0x20, 0x46, 0x77, 0x50, 0x6f, 0x6c, 0x69,
+  0x63, 0x79, 0x20, 0x74, 0x65, 0x73, 0x74, 0x20, 0x6c, 0x65, 0x61, 0x66, 0x2c, 0x20, 0x77, 0x69,
+  0x74, 0x68, 0x6f, 0x75, 0x74, 0x20, 0x74, 0x68, 0x65, 0x20, 0x43, 0x41, 0x20, 0x74, 0x68, 0x61,
+  0x74, 0x20, 0x69, 0x73, 0x73, 0x75, 0x65, 0x64, 0x20, 0x69, 0x74, 0x2e, 0x0a, 0xa0, 0x82, 0x04,
+  0xe9, 0x30, 0x82, 0x04, 0xe5, 0x30, 0x82, 0x02, 0xcd, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x10,
+  0xd5, 0x6d, 0xa3, 0xbe, 0x9a, 0xfa, 0x80, 0x8c, 0x4d, 0x77, 0xa9, 0x29, 0xcc, 0x2e, 0xe4, 0x42,
+  0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x0b, 0x05, 0x00, 0x30,
+  0x2b, 0x31, 0x10, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x13, 0x07, 0x43, 0x6f, 0x6e, 0x74,
+  0x6f, 0x73, 0x6f, 0x31, 0x17, 0x30, 0x15, 0x06, 0x03, 0x55, 0x04, 0x03, 0x13, 0x0e, 0x41, 0x20,
+  0x55, 0x45, 0x46, 0x49, 0x20, 0x54, 0x65, 0x73, 0x74, 0x20, 0x43, 0x41, 0x30, 0x1e, 0x17, 0x0d,
+  0x32, 0x30, 0x30, 0x32, 0x30, 0x36, 0x30, 0x32, 0x30, 0x30, 0x34, 0x39, 0x5a, 0x17, 0x0d, 0x32,
+  0x32, 0x30, 0x38, 0x30, 0x36, 0x30, 0x32, 0x30, 0x30, 0x34, 0x38, 0x5a, 0x30, 0x2f, 0x31, 0x10,
+  0x30, 0x0e, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x13, 0x07, 0x43, 0x6f, 0x6e, 0x74, 0x6f, 0x73, 0x6f,
+  0x31, 0x1b, 0x30, 0x19, 0x06, 0x03, 0x55, 0x04, 0x03, 0x13, 0x12, 0x46, 0x77, 0x50, 0x6f, 0x6c,
+  0x69, 0x63, 0x79, 0x20, 0x54, 0x65, 0x73, 0x74, 0x20, 0x4c, 0x65, 0x61, 0x66, 0x30, 0x82, 0x01,
+  0xa2, 0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x01, 0x05, 0x00,
+  0x03, 0x82, 0x01, 0x8f, 0x00, 0x30, 0x82, 0x01, 0x8a, 0x02, 0x82, 0x01, 0x81, 0x00, 0xb1, 0x1c,
+  0xc8, 0xc0, 0xe2, 0x62, 0xf0, 0xa3, 0xf0, 0x1d, 0x1f, 0x59, 0x9f, 0xf7, 0x60, 0x2f, 0x86, 0x9d,
+  0x26, 0xc1, 0x98, 0x6d, 0xbe, 0x45, 0x83, 0xbb, 0xde, 0x10, 0x12, 0x14, 0x6a, 0xed, 0x0a, 0xba,
+  0x0e, 0x72, 0x5b, 0x80, 0x37, 0xa5, 0xc8, 0x65, 0x3a, 0xcf, 0xa3, 0x53, 0x20, 0xb2, 0x23, 0xb8,
+  0x9d, 0xea, 0x46, 0x4b, 0xa8, 0xfa, 0x19, 0x2c, 0xfe, 0x60, 0xad, 0x03, 0xc6, 0x52, 0x71, 0x7a,
+  0xd3, 0xb7, 0x75, 0x68, 0x60, 0x23, 0xcb, 0x4b, 0xb3, 0x3e, 0x86, 0x1b, 0x5f, 0xcd, 0x1a, 0xc9,
+  0x91, 0x00, 0x86, 0xfb, 0x6f, 0x13, 0xd3, 0x62, 0x7a, 0xe6, 0xb2, 0xaa, 0xc1, 0x95, 0xb8, 0xb6,
+  0xb5, 0x76, 0x2b, 0xfe, 0xbe, 0x43, 0x4c, 0x97, 0x9c, 0x37, 0xdb, 0xb1, 0x9a, 0xd4, 0xd6, 0x18,
+  0x53, 0x64, 0xce, 0x54, 0x95, 0xe5, 0x9c, 0xfd, 0x3e, 0x01, 0x05, 0xbb, 0x50, 0x10, 0xe6, 0x88,
+  0xdf, 0x5e, 0xd7, 0xa1, 0xb0, 0xca, 0x44, 0xd5, 0xbe, 0x41, 0x23, 0x3e, 0x59, 0x7f, 0x39, 0x08,
+  0x7d, 0x2b, 0x48, 0x62, 0xea, 0x01, 0x73, 0x1c, 0x1c, 0x88, 0x56, 0xb4, 0xa8, 0x48, 0x35, 0x4a,
+  0x01, 0xd2, 0x4b, 0xec, 0xf5, 0x9e, 0xb5, 0xae, 0x07, 0x6e, 0x5a, 0x4b, 0x9f, 0x5c, 0x06, 0x04,
+  0x08, 0x9d, 0x93, 0xd3, 0x66, 0x6e, 0x31, 0xc6, 0xd2, 0xa4, 0x61, 0xa9, 0x41, 0xb8, 0x45, 0x6f,
+  0x4c, 0x36, 0x09, 0x75, 0x7d, 0xe4, 0xdd, 0x79, 0x42, 0xfa, 0xb6, 0xd2, 0x40, 0x8d, 0x07, 0xad,
+  0x7d, 0xb5, 0xa9, 0xc0, 0x73, 0x91, 0xef, 0xe4, 0x70, 0xdd, 0x78, 0xd6, 0x4a, 0x96, 0x42, 0x7a,
+  0x3f, 0xfa, 0xbd, 0x32, 0xee, 0x65, 0x9f, 0x2c, 0x31, 0x05, 0x25, 0x94, 0xb2, 0x62, 0xdc, 0x7d,
+  0xa7, 0x3e, 0x06, 0x05, 0x2c, 0xc5, 0xc3, 0x0d, 0x9c, 0x7e, 0x2e, 0x4c, 0x2a, 0x2e, 0x49, 0x63,
+  0x73, 0xca, 0xbc, 0x1e, 0xba, 0x61, 0x67, 0xcf, 0xd7, 0xbb, 0x67, 0xd9, 0x71, 0xc2, 0x59, 0x00,
+  0xd7, 0x27, 0xe5, 0x29, 0x26, 0xab, 0xdd, 0x1d, 0x56, 0xdd, 0xd3, 0x22, 0xe3, 0x6a, 0x9f, 0x6e,
+  0xf2, 0x93, 0x77, 0xa2, 0x4e, 0x53, 0x7a, 0x14, 0xf4, 0x6a, 0xc3, 0x1a, 0x32, 0x27, 0x9b, 0xf3,
+  0xec, 0x79, 0x82, 0xaf, 0xeb, 0x1e, 0xbb, 0xee, 0xa6, 0x19, 0xc6, 0x1b, 0x5e, 0x60, 0xed, 0xa4,
+  0x30, 0x93, 0x85, 0xde, 0x11, 0x89, 0x58, 0x65, 0xb0, 0xce, 0x34, 0x02, 0xf2, 0xf6, 0x46, 0xaf,
+  0x67, 0x1a, 0x78, 0xd6, 0xfa, 0x7d, 0xfa, 0x56, 0xe6, 0xf1, 0x6b, 0xd9, 0x68, 0x58, 0xa0, 0x94,
+  0xe7, 0x1a, 0x61, 0x20, 0x2d, 0xc9, 0x93, 0x86, 0xec, 0x55, 0x90, 0x56, 0xe0, 0x00, 0x75, 0x95,
+  0x80, 0xe9, 0xc3, 0xc2, 0x05, 0xcf, 0x25, 0x45, 0x21, 0xc9, 0xad, 0xc9, 0x98, 0x39, 0x02, 0x03,
+  0x01, 0x00, 0x01, 0xa3, 0x81, 0x80, 0x30, 0x7e, 0x30, 0x21, 0x06, 0x03, 0x55, 0x1d, 0x25, 0x04,
+  0x1a, 0x30, 0x18, 0x06, 0x0c, 0x2b, 0x06, 0x01, 0x04, 0x01, 0x82, 0x37, 0x2d, 0x81, 0x7f, 0x81,
+  0x7f, 0x06, 0x08, 0x2b, 0x06, 0x01, 0x05, 0x05, 0x07, 0x03, 0x03, 0x30, 0x59, 0x06, 0x03, 0x55,
+  0x1d, 0x01, 0x04, 0x52, 0x30, 0x50, 0x80, 0x10, 0x99, 0x20, 0x5d, 0x71, 0xc5, 0x31, 0x0b, 0xb1,
+  0x3b, 0x5d, 0x4e, 0xc2, 0x65, 0x17, 0x1a, 0x76, 0xa1, 0x2a, 0x30, 0x28, 0x31, 0x10, 0x30, 0x0e,
+  0x06, 0x03, 0x55, 0x04, 0x0a, 0x13, 0x07, 0x43, 0x6f, 0x6e, 0x74, 0x6f, 0x73, 0x6f, 0x31, 0x14,
+  0x30, 0x12, 0x06, 0x03, 0x55, 0x04, 0x03, 0x13, 0x0b, 0x41, 0x20, 0x54, 0x65, 0x73, 0x74, 0x20,
+  0x52, 0x6f, 0x6f, 0x74, 0x82, 0x10, 0x67, 0x20, 0x94, 0x91, 0xe3, 0x74, 0x0c, 0x98, 0x4c, 0x95,
+  0x13, 0x05, 0xd3, 0xc1, 0x07, 0xed, 0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d,
+  0x01, 0x01, 0x0b, 0x05, 0x00, 0x03, 0x82, 0x02, 0x01, 0x00, 0x30, 0xc3, 0xd9, 0xa2, 0x0d, 0x5e,
+  0x7e, 0xb4, 0x38, 0x29, 0x97, 0x85, 0x49, 0x9a, 0x93, 0x64, 0xcd, 0xff, 0xde, 0xdb, 0x53, 0x1c,
+  0x1a, 0x08, 0xa0, 0x92, 0x17, 0x94, 0x98, 0x4a, 0x34, 0xdd, 0x4e, 0xad, 0x64, 0x39, 0xaa, 0xa5,
+  0xdc, 0x72, 0x15, 0x4c, 0xe2, 0xca, 0xe8, 0x6a, 0x77, 0x4d, 0xc5, 0x91, 0x80, 0xea, 0x69, 0xb6,
+  0xae, 0x5d, 0xd2, 0x38, 0x4d, 0xc2, 0xdc, 0x61, 0x9c, 0xfb, 0x09, 0x24, 0xcb, 0x25, 0x8b, 0x19,
+  0x49, 0x89, 0x2f, 0xba, 0x51, 0x26, 0x09, 0x7a, 0x3a, 0xaa, 0x39, 0xe1, 0x1a, 0xbe, 0x9d, 0x33,
+  0x5d, 0x01, 0xd6, 0xb5, 0xc7, 0x48, 0x83, 0x8b, 0x6f, 0x13, 0x59, 0xbe, 0x27, 0x7f, 0xd3, 0x8d,
+  0x32, 0x80, 0x6a, 0x34, 0x60, 0x13, 0x00, 0x25, 0x5b, 0xd4, 0x75, 0x27, 0xec, 0x2c, 0x9c, 0xf3,
+  0x2d, 0x40, 0xa1, 0x08, 0xf9, 0x21, 0x00, 0x7b, 0xce, 0x12, 0xe4, 0x03, 0x2e, 0xb2, 0xe0, 0xda,
+  0x22, 0x8c, 0xe0, 0x8d, 0x36, 0x41, 0x66, 0xbb, 0x65, 0xbe, 0x5f, 0xe2, 0xa3, 0xad, 0xc1, 0xd4,
+  0x1b, 0xd8, 0xf1, 0x78, 0x77, 0xa7, 0xd1, 0x91, 0xfc, 0x50, 0x85, 0x79, 0xb5, 0x20, 0x37, 0xb9,
+  0x70, 0x7c, 0xa4, 0x91, 0xfe, 0x27, 0xb2, 0xb1, 0xae, 0x8a, 0xc9, 0x64, 0x6d, 0xbd, 0xd4, 0x96,
+  0x2d, 0xbc, 0x9b, 0x25, 0x14, 0x18, 0xc4, 0x93, 0xd0, 0xa1, 0xdb, 0x80, 0xda, 0x4d, 0x4a, 0xc1,
+  0x93, 0x02, 0x3a, 0x95, 0x64, 0xb4, 0x62, 0x3c, 0x15, 0x9e, 0x61, 0xca, 0xfb, 0x85, 0xbd, 0xf6,
+  0x70, 0xd6, 0x9c, 0x45, 0xa6, 0xbf, 0xc6, 0x48, 0x7c, 0x8d, 0x87, 0x02, 0xb4, 0x59, 0x3e, 0xd3,
+  0x13, 0x27, 0xf3, 0xac, 0x99, 0x23, 0x5f, 0x6b, 0xf0, 0xe2, 0x63, 0xd8, 0x43, 0x6b, 0x1a, 0x4b,
+  0xcd, 0xfe, 0x98, 0x65, 0x58, 0x2d, 0xab, 0x0e, 0xaa, 0x3b, 0x9e, 0x4f, 0x1b, 0x27, 0x19, 0xa8,
+  0xe1, 0x81, 0xdc, 0x35, 0xbd, 0xf1, 0x35, 0xce, 0xdd, 0x1b, 0x05, 0xab, 0x00, 0xf5, 0x1e, 0x3e,
+  0xd9, 0x95, 0x7d, 0x22, 0xd0, 0x3c, 0x06, 0xfe, 0xa7, 0x62, 0xee, 0xf0, 0x30, 0x8f, 0xf7, 0x0d,
+  0x36, 0x6e, 0x4a, 0x83, 0x94, 0x5c, 0x16, 0x5e, 0xd7, 0xde, 0x2b, 0xaf, 0x78, 0x6e, 0xc3, 0xb9,
+  0x76, 0xb3, 0x6f, 0xf0, 0xcf, 0xb9, 0xf2, 0x45, 0x5c, 0xe4, 0xb1, 0xc2, 0xa0, 0x50, 0x2b, 0x85,
+  0x51, 0xb1, 0x6d, 0xa1, 0x71, 0x32, 0xae, 0x2a, 0xce, 0xb5, 0x4c, 0x58, 0xa3, 0x55, 0x05, 0x46,
+  0x82, 0xaa, 0x2f, 0xad, 0xd0, 0xfc, 0x7c, 0xb5, 0x31, 0xa9, 0x9a, 0xbc, 0x5a, 0xc1, 0xd8, 0xcf,
+  0xfc, 0x77, 0x5d, 0x36, 0x63, 0xe5, 0xaf, 0xc6, 0x51, 0x53, 0x35, 0xd6, 0x8e, 0x48, 0x8f, 0x8c,
+  0x60, 0xd2, 0x5b, 0xfe, 0x1b, 0x31, 0x92, 0xe7, 0x5d, 0x65, 0xbe, 0x33, 0x18, 0x8d, 0x7e, 0x16,
+  0x2f, 0x29, 0xb9, 0x22, 0x76, 0xc4, 0x28, 0x6e, 0x06, 0x78, 0x34, 0xdd, 0xa1, 0xf5, 0x41, 0x15,
+  0x63, 0xe7, 0x1c, 0xe6, 0x72, 0x25, 0x76, 0x4c, 0x34, 0x16, 0x93, 0x75, 0x9c, 0xe3, 0xf4, 0x87,
+  0x93, 0xf8, 0xa1, 0x1d, 0xad, 0x7b, 0x75, 0xfe, 0x4f, 0x21, 0xa0, 0xc3, 0xf6, 0x5f, 0xa0, 0x9b,
+  0xe2, 0xc0, 0x70, 0x6a, 0x24, 0x76, 0x1e, 0x9d, 0xbb, 0xfb, 0x8c, 0xe6, 0x3f, 0xef, 0x63, 0x7c,
+  0x17, 0x85, 0xd8, 0x18, 0xd5, 0x9f, 0x60, 0xa7, 0x3c, 0xf8, 0xee, 0xe5, 0x61, 0x6a, 0xcd, 0x29,
+  0x2a, 0xf7, 0x4b, 0x3d, 0x62, 0x84, 0x71, 0x59, 0x16, 0x79, 0x03, 0x52, 0xfd, 0x60, 0xef, 0x96,
+  0x7e, 0x63, 0xe6, 0xfd, 0xde, 0x95, 0xfd, 0x5d, 0xa4, 0x94, 0x90, 0xd9, 0x80, 0x49, 0xfe, 0xcd,
+  0x7f, 0x39, 0x02, 0x0b, 0x91, 0x67, 0xa8, 0x81, 0x85, 0x63, 0x31, 0x82, 0x02, 0xd1, 0x30, 0x82,
+  0x02, 0xcd, 0x02, 0x01, 0x01, 0x30, 0x3f, 0x30, 0x2b, 0x31, 0x10, 0x30, 0x0e, 0x06, 0x03, 0x55,
+  0x04, 0x0a, 0x13, 0x07, 0x43, 0x6f, 0x6e, 0x74, 0x6f, 0x73, 0x6f, 0x31, 0x17, 0x30, 0x15, 0x06,
+  0x03, 0x55, 0x04, 0x03, 0x13, 0x0e, 0x41, 0x20, 0x55, 0x45, 0x46, 0x49, 0x20, 0x54, 0x65, 0x73,
+  0x74, 0x20, 0x43, 0x41, 0x02, 0x10, 0xd5, 0x6d, 0xa3, 0xbe, 0x9a, 0xfa, 0x80, 0x8c, 0x4d, 0x77,
+  0xa9, 0x29, 0xcc, 0x2e, 0xe4, 0x42, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03,
+  0x04, 0x02, 0x01, 0x05, 0x00, 0xa0, 0x81, 0xe4, 0x30, 0x18, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86,
+  0xf7, 0x0d, 0x01, 0x09, 0x03, 0x31, 0x0b, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01,
+  0x07, 0x01, 0x30, 0x1c, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x09, 0x05, 0x31,
+  0x0f, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x38, 0x30, 0x31, 0x31, 0x34, 0x32, 0x39, 0x5a,
+  0x30, 0x2f, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x09, 0x04, 0x31, 0x22, 0x04,
+  0x20, 0x34, 0xd4, 0x10, 0xa4, 0x1b, 0xba, 0xef, 0xdc, 0xee, 0xa5, 0x33, 0x70, 0xbd, 0x61, 0x42,
+  0xd3, 0xeb, 0x90, 0xad, 0xad, 0xb3, 0xf3, 0x3b, 0x87, 0xee, 0x97, 0x37, 0xbd, 0x19, 0x96, 0xb2,
+  0x29, 0x30, 0x79, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x09, 0x0f, 0x31, 0x6c,
+  0x30, 0x6a, 0x30, 0x0b, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x01, 0x2a, 0x30,
+  0x0b, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x01, 0x16, 0x30, 0x0b, 0x06, 0x09,
+  0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x01, 0x02, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48,
+  0x86, 0xf7, 0x0d, 0x03, 0x07, 0x30, 0x0e, 0x06, 0x08, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x03,
+  0x02, 0x02, 0x02, 0x00, 0x80, 0x30, 0x0d, 0x06, 0x08, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x03,
+  0x02, 0x02, 0x01, 0x40, 0x30, 0x07, 0x06, 0x05, 0x2b, 0x0e, 0x03, 0x02, 0x07, 0x30, 0x0d, 0x06,
+  0x08, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x03, 0x02, 0x02, 0x01, 0x28, 0x30, 0x0d, 0x06, 0x09,
+  0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x01, 0x05, 0x00, 0x04, 0x82, 0x01, 0x80, 0x29,
+  0x0a, 0x68, 0xa2, 0xa1, 0x02, 0x45, 0x94, 0xaf, 0x55, 0xd9, 0x75, 0x55, 0xfc, 0x7a, 0x73, 0xe2,
+  0x5c, 0x7d, 0xb1, 0x71, 0x5a, 0x33, 0x09, 0xd1, 0xed, 0x12, 0xb2, 0xb2, 0x39, 0x36, 0x65, 0xa0,
+  0xd9, 0xcc, 0xaa, 0xdf, 0xf2, 0x6a, 0xe1, 0x9e, 0x0a, 0xaa, 0x86, 0x92, 0x0c, 0x48, 0xbe, 0xb1,
+  0x05, 0x7c, 0x2d, 0x76, 0x5b, 0x26, 0xac, 0x0d, 0x22, 0xec, 0xb5, 0x7c, 0x08, 0x5a, 0xfe, 0xa3,
+  0x8a, 0x39, 0xda, 0x42, 0xd1, 0x11, 0xc2, 0xd4, 0x84, 0x79, 0x16, 0x8e, 0x2e, 0x7e, 0x01, 0x0a,
+  0x2d, 0xfa, 0x61, 0xb5, 0xd3, 0xf2, 0x58, 0x6e, 0x47, 0xee, 0xba, 0x61, 0x73, 0x99, 0xb3, 0xc1,
+  0x61, 0x9e, 0xd4, 0x85, 0x9d, 0x76, 0x27, 0x2d, 0x9f, 0xcf, 0x4f, 0x8b, 0x38, 0x2a, 0x7a, 0xde,
+  0xd9, 0x7f, 0x4f, 0xa1, 0xbb, 0xc7, 0xd2, 0xcf, 0xe5, 0x0c, 0xfb, 0xb0, 0x09, 0xf5, 0x62, 0x09,
+  0x43, 0xc9, 0x1e, 0x8d, 0x24, 0xcf, 0xef, 0xb2, 0x3f, 0x9d, 0xcf, 0xb9, 0x33, 0xa1, 0x0f, 0x1c,
+  0x0a, 0x2a, 0x4d, 0xdc, 0xd8, 0x92, 0xbf, 0xec, 0x4a, 0x13, 0x74, 0xfc, 0x84, 0xb0, 0x26, 0x65,
+  0xc2, 0xe3, 0x0d, 0xcc, 0x41, 0xc0, 0x8c, 0x5b, 0x0f, 0xb9, 0x0c, 0x33, 0xdd, 0x42, 0xe7, 0xe5,
+  0x7b, 0xb4, 0x94, 0x9d, 0x5b, 0x45, 0x6b, 0x38, 0xc6, 0x97, 0xf3, 0x36, 0x03, 0xfe, 0xe8, 0xa1,
+  0x43, 0xde, 0xfa, 0xc4, 0xf3, 0x42, 0xb9, 0xe8, 0x42, 0xda, 0x6e, 0xab, 0xb8, 0x80, 0x03, 0x45,
+  0x2b, 0x25, 0xba, 0x4f, 0xa8, 0xc7, 0xcd, 0xf8, 0xb5, 0x7e, 0x5e, 0xe5, 0x09, 0x9e, 0x26, 0xfe,
+  0x5a, 0xdd, 0xa6, 0x0c, 0xc2, 0x33, 0xf5, 0x6d, 0x2b, 0x23, 0xb8, 0x5f, 0x9d, 0x5e, 0x19, 0xa8,
+  0x68, 0x0a, 0x13, 0xc9, 0x3f, 0x88, 0xff, 0x14, 0x74, 0xaf, 0xec, 0x35, 0xc2, 0xd4, 0x57, 0x9f,
+  0x94, 0x72, 0xf5, 0x84, 0x50, 0x72, 0xcf, 0xa0, 0x67, 0xc6, 0xaf, 0x0a, 0x9b, 0x9c, 0xbe, 0xc4,
+  0x23, 0x2f, 0x1a, 0x30, 0xda, 0x44, 0x4b, 0x41, 0x2c, 0xb5, 0x8b, 0x00, 0x30, 0x36, 0xf5, 0x5b,
+  0xce, 0xcf, 0x3c, 0x2c, 0x65, 0xe6, 0x81, 0x90, 0x5c, 0x9f, 0xfc, 0xc5, 0x69, 0xfa, 0xc9, 0xf4,
+  0xe7, 0xda, 0x65, 0x35, 0x2c, 0xd5, 0x1c, 0x1f, 0x28, 0x85, 0x57, 0xda, 0xef, 0xca, 0x0a, 0x46,
+  0x0b, 0xdd, 0x37, 0xda, 0xae, 0x1a, 0xba, 0x3f, 0x63, 0xa2, 0x08, 0x09, 0xf7, 0xde, 0x2e, 0x84,
+  0x0f, 0x03, 0x3a, 0x1e, 0x84, 0x7d, 0x9e, 0x33, 0x50, 0xa2, 0x04, 0x20, 0xda, 0x4b, 0x97, 0xb6,
+  0xba, 0x79, 0x66, 0x37, 0x5e, 0xa5, 0xc9, 0x97, 0xc3, 0xb2, 0x29, 0x35, 0x8f, 0x8f, 0x12, 0x28,
+  0x03, 0x51, 0xb0, 0xc3, 0xa1, 0xaf, 0x01, 0xb0, 0x25, 0xb4, 0x21, 0xf8, 0x17, 0x4c, 0x8a };
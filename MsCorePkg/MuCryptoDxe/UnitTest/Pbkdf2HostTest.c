@@ -0,0 +1,488 @@
+/** @file
+  Host based unit tests for the PBKDF2 behind the MuCryptoDxe PKCS5 password hash protocol.
+
+  The protocol is installed into a stand-in boot services table and checked against known
+  answers, and against Pkcs5HashPassword from real BaseCryptLib.  A benchmark compares the
+  time both take for 1,000,000 iterations.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <time.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseCryptLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UnitTestLib.h>
+#include <Protocol/MuPkcs5PasswordHash.h>
+#include "../MuCryptoDxe.h"
+
+#define UNIT_TEST_NAME     "MuCryptoDxe PBKDF2 Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define BENCHMARK_ITERATIONS  1000000
+
+#define LONG_PASSWORD  "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef" \
+                       "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef"
+
+typedef struct {
+  CONST CHAR8    *Password;
+  UINTN          PasswordSize;
+  CONST CHAR8    *Salt;
+  UINTN          SaltSize;
+  UINTN          IterationCount;
+  UINTN          DigestSize;
+  UINTN          OutputSize;
+  UINT8          Expected[64];
+} PBKDF2_KNOWN_ANSWER;
+
+STATIC CONST PBKDF2_KNOWN_ANSWER  mKnownAnswers[] = {
+  //
+  // RFC 7914 section 11
+  //
+  {
+    "passwd", 6, "salt", 4, 1, SHA256_DIGEST_SIZE, 64,
+    {
+      0x55, 0xac, 0x04, 0x6e, 0x56, 0xe3, 0x08, 0x9f, 0xec, 0x16, 0x91, 0xc2, 0x25, 0x44, 0xb6, 0x05,
+      0xf9, 0x41, 0x85, 0x21, 0x6d, 0xde, 0x04, 0x65, 0xe6, 0x8b, 0x9d, 0x57, 0xc2, 0x0d, 0xac, 0xbc,
+      0x49, 0xca, 0x9c, 0xcc, 0xf1, 0x79, 0xb6, 0x45, 0x99, 0x16, 0x64, 0xb3, 0x9d, 0x77, 0xef, 0x31,
+      0x7c, 0x71, 0xb8, 0x45, 0xb1, 0xe3, 0x0b, 0xd5, 0x09, 0x11, 0x20, 0x41, 0xd3, 0xa1, 0x97, 0x83,
+    }
+  },
+  {
+    "Password", 8, "NaCl", 4, 80000, SHA256_DIGEST_SIZE, 64,
+    {
+      0x4d, 0xdc, 0xd8, 0xf6, 0x0b, 0x98, 0xbe, 0x21, 0x83, 0x0c, 0xee, 0x5e, 0xf2, 0x27, 0x01, 0xf9,
+      0x64, 0x1a, 0x44, 0x18, 0xd0, 0x4c, 0x04, 0x14, 0xae, 0xff, 0x08, 0x87, 0x6b, 0x34, 0xab, 0x56,
+      0xa1, 0xd4, 0x25, 0xa1, 0x22, 0x58, 0x33, 0x54, 0x9a, 0xdb, 0x84, 0x1b, 0x51, 0xc9, 0xb3, 0x17,
+      0x6a, 0x27, 0x2b, 0xde, 0xbb, 0xa1, 0xd0, 0x78, 0x47, 0x8f, 0x62, 0xb3, 0x97, 0xf3, 0x3c, 0x8d,
+    }
+  },
+  //
+  // SHA256 and SHA384 vectors computed with an independent PBKDF2 implementation.  They
+  // cover embedded NULs, an empty salt, passwords longer than a block, keys longer than a
+  // digest and iteration counts up to 1,000,000.
+  //
+  {
+    "password", 8, "salt", 4, 1, SHA256_DIGEST_SIZE, 32,
+    {
+      0x12, 0x0f, 0xb6, 0xcf, 0xfc, 0xf8, 0xb3, 0x2c, 0x43, 0xe7, 0x22, 0x52, 0x56, 0xc4, 0xf8, 0x37,
+      0xa8, 0x65, 0x48, 0xc9, 0x2c, 0xcc, 0x35, 0x48, 0x08, 0x05, 0x98, 0x7c, 0xb7, 0x0b, 0xe1, 0x7b,
+    }
+  },
+  {
+    "password", 8, "salt", 4, 2, SHA256_DIGEST_SIZE, 32,
+    {
+      0xae, 0x4d, 0x0c, 0x95, 0xaf, 0x6b, 0x46, 0xd3, 0x2d, 0x0a, 0xdf, 0xf9, 0x28, 0xf0, 0x6d, 0xd0,
+      0x2a, 0x30, 0x3f, 0x8e, 0xf3, 0xc2, 0x51, 0xdf, 0xd6, 0xe2, 0xd8, 0x5a, 0x95, 0x47, 0x4c, 0x43,
+    }
+  },
+  {
+    "password", 8, "salt", 4, 4096, SHA256_DIGEST_SIZE, 32,
+    {
+      0xc5, 0xe4, 0x78, 0xd5, 0x92, 0x88, 0xc8, 0x41, 0xaa, 0x53, 0x0d, 0xb6, 0x84, 0x5c, 0x4c, 0x8d,
+      0x96, 0x28, 0x93, 0xa0, 0x01, 0xce, 0x4e, 0x11, 0xa4, 0x96, 0x38, 0x73, 0xaa, 0x98, 0x13, 0x4a,
+    }
+  },
+  {
+    "passwordPASSWORDpassword", 24, "saltSALTsaltSALTsaltSALTsaltSALTsalt", 36, 4096, SHA256_DIGEST_SIZE, 40,
+    {
+      0x34, 0x8c, 0x89, 0xdb, 0xcb, 0xd3, 0x2b, 0x2f, 0x32, 0xd8, 0x14, 0xb8, 0x11, 0x6e, 0x84, 0xcf,
+      0x2b, 0x17, 0x34, 0x7e, 0xbc, 0x18, 0x00, 0x18, 0x1c, 0x4e, 0x2a, 0x1f, 0xb8, 0xdd, 0x53, 0xe1,
+      0xc6, 0x35, 0x51, 0x8c, 0x7d, 0xac, 0x47, 0xe9,
+    }
+  },
+  {
+    "pass\0word", 9, "sa\0lt", 5, 4096, SHA256_DIGEST_SIZE, 16,
+    {
+      0x89, 0xb6, 0x9d, 0x05, 0x16, 0xf8, 0x29, 0x89, 0x3c, 0x69, 0x62, 0x26, 0x65, 0x0a, 0x86, 0x87,
+    }
+  },
+  {
+    "password", 8, "", 0, 1000, SHA256_DIGEST_SIZE, 32,
+    {
+      0x26, 0x93, 0x96, 0x81, 0xd1, 0x99, 0x95, 0xa2, 0xce, 0xfb, 0x7b, 0x90, 0xd1, 0x3e, 0x13, 0x43,
+      0xf0, 0x9b, 0x30, 0xf0, 0xab, 0xbd, 0x07, 0x41, 0x6a, 0x23, 0xb9, 0xbc, 0x3c, 0x5b, 0x35, 0x36,
+    }
+  },
+  {
+    LONG_PASSWORD, sizeof (LONG_PASSWORD) - 1, "salt", 4, 1000, SHA256_DIGEST_SIZE, 64,
+    {
+      0x81, 0xc6, 0x84, 0xba, 0xda, 0x19, 0xd6, 0xba, 0xfc, 0x23, 0x2b, 0x3d, 0xe1, 0xaa, 0x89, 0x49,
+      0xe0, 0xdc, 0x7d, 0x37, 0x48, 0x7e, 0xca, 0x6f, 0x8f, 0xd4, 0x58, 0x31, 0x30, 0x59, 0x70, 0xe9,
+      0x49, 0x5b, 0x1a, 0x77, 0xf2, 0x66, 0xeb, 0x71, 0x79, 0x29, 0x08, 0x0f, 0xd8, 0xfd, 0xeb, 0xe4,
+      0x48, 0xed, 0x53, 0xcc, 0x8a, 0xc4, 0x81, 0xad, 0x34, 0x48, 0x8c, 0xf9, 0x61, 0xcd, 0xf3, 0xce,
+    }
+  },
+  {
+    "password", 8, "salt", 4, 1000000, SHA256_DIGEST_SIZE, 32,
+    {
+      0x50, 0x51, 0x12, 0xa5, 0x90, 0xbe, 0x61, 0xac, 0x9d, 0x3a, 0x23, 0x5b, 0xf0, 0xa8, 0xee, 0xce,
+      0xa4, 0x0e, 0x54, 0x65, 0x2e, 0xc0, 0xe3, 0xc2, 0x57, 0xc2, 0x27, 0xc9, 0xaa, 0x5e, 0x66, 0x4c,
+    }
+  },
+  {
+    "password", 8, "salt", 4, 1, SHA384_DIGEST_SIZE, 48,
+    {
+      0xc0, 0xe1, 0x4f, 0x06, 0xe4, 0x9e, 0x32, 0xd7, 0x3f, 0x9f, 0x52, 0xdd, 0xf1, 0xd0, 0xc5, 0xc7,
+      0x19, 0x16, 0x09, 0x23, 0x36, 0x31, 0xda, 0xdd, 0x76, 0xa5, 0x67, 0xdb, 0x42, 0xb7, 0x86, 0x76,
+      0xb3, 0x8f, 0xc8, 0x00, 0xcc, 0x53, 0xdd, 0xb6, 0x42, 0xf5, 0xc7, 0x44, 0x42, 0xe6, 0x2b, 0xe4,
+    }
+  },
+  {
+    "password", 8, "salt", 4, 2, SHA384_DIGEST_SIZE, 48,
+    {
+      0x54, 0xf7, 0x75, 0xc6, 0xd7, 0x90, 0xf2, 0x19, 0x30, 0x45, 0x91, 0x62, 0xfc, 0x53, 0x5d, 0xbf,
+      0x04, 0xa9, 0x39, 0x18, 0x51, 0x27, 0x01, 0x6a, 0x04, 0x17, 0x6a, 0x07, 0x30, 0xc6, 0xf1, 0xf4,
+      0xfb, 0x48, 0x83, 0x2a, 0xd1, 0x26, 0x1b, 0xaa, 0xdd, 0x2c, 0xed, 0xd5, 0x08, 0x14, 0xb1, 0xc8,
+    }
+  },
+  {
+    "password", 8, "salt", 4, 4096, SHA384_DIGEST_SIZE, 48,
+    {
+      0x55, 0x97, 0x26, 0xbe, 0x38, 0xdb, 0x12, 0x5b, 0xc8, 0x5e, 0xd7, 0x89, 0x5f, 0x6e, 0x3c, 0xf5,
+      0x74, 0xc7, 0xa0, 0x1c, 0x08, 0x0c, 0x34, 0x47, 0xdb, 0x1e, 0x8a, 0x76, 0x76, 0x4d, 0xeb, 0x3c,
+      0x30, 0x7b, 0x94, 0x85, 0x3f, 0xbe, 0x42, 0x4f, 0x64, 0x88, 0xc5, 0xf4, 0xf1, 0x28, 0x96, 0x26,
+    }
+  },
+  {
+    "passwordPASSWORDpassword", 24, "saltSALTsaltSALTsaltSALTsaltSALTsalt", 36, 4096, SHA384_DIGEST_SIZE, 64,
+    {
+      0x81, 0x91, 0x43, 0xad, 0x66, 0xdf, 0x9a, 0x55, 0x25, 0x59, 0xb9, 0xe1, 0x31, 0xc5, 0x2a, 0xe6,
+      0xc5, 0xc1, 0xb0, 0xee, 0xd1, 0x8f, 0x4d, 0x28, 0x3b, 0x8c, 0x5c, 0x9e, 0xae, 0xb9, 0x2b, 0x39,
+      0x2c, 0x14, 0x7c, 0xc2, 0xd2, 0x86, 0x9d, 0x58, 0xff, 0xe2, 0xf7, 0xda, 0x13, 0xd1, 0x5f, 0x8d,
+      0x92, 0x57, 0x21, 0xf0, 0xed, 0x1a, 0xfa, 0xfa, 0x24, 0x48, 0x0d, 0x55, 0xcf, 0x60, 0x60, 0xb1,
+    }
+  },
+  {
+    "pass\0word", 9, "sa\0lt", 5, 4096, SHA384_DIGEST_SIZE, 16,
+    {
+      0xa3, 0xf0, 0x0a, 0xc8, 0x65, 0x7e, 0x09, 0x5f, 0x8e, 0x08, 0x23, 0xd2, 0x32, 0xfc, 0x60, 0xb3,
+    }
+  },
+  {
+    LONG_PASSWORD, sizeof (LONG_PASSWORD) - 1, "salt", 4, 1000, SHA384_DIGEST_SIZE, 64,
+    {
+      0xc4, 0x28, 0xaa, 0x4d, 0x8e, 0x58, 0x6f, 0x97, 0x49, 0x09, 0xb5, 0x72, 0x67, 0xa2, 0x25, 0x7f,
+      0x4d, 0x80, 0x8a, 0xa7, 0xb4, 0xc4, 0x4c, 0xab, 0x7d, 0x87, 0x01, 0x53, 0x6d, 0xc8, 0x78, 0xea,
+      0x73, 0x35, 0x40, 0x9d, 0x0b, 0xc5, 0xba, 0xe8, 0xeb, 0xac, 0x71, 0xc6, 0xc0, 0x63, 0xe7, 0x3a,
+      0xfe, 0xfd, 0x1f, 0x10, 0x3f, 0x9a, 0x58, 0x64, 0x05, 0x6d, 0x0a, 0x22, 0x64, 0x8a, 0x69, 0xb2,
+    }
+  },
+  {
+    "password", 8, "salt", 4, 1000000, SHA384_DIGEST_SIZE, 48,
+    {
+      0x5f, 0xb3, 0xaf, 0xb5, 0x71, 0xc9, 0xd1, 0xb4, 0x42, 0x43, 0x91, 0x73, 0xfc, 0xd2, 0x60, 0x99,
+      0x41, 0x3d, 0x8b, 0x2c, 0x98, 0x90, 0xe3, 0xa5, 0x46, 0x94, 0x0e, 0xbe, 0xc2, 0x49, 0x2c, 0x96,
+      0xa6, 0x4d, 0x8d, 0x00, 0x63, 0xe1, 0x30, 0xca, 0x72, 0xfe, 0x0a, 0xd8, 0x1d, 0xcb, 0xaa, 0x49,
+    }
+  },
+};
+
+//
+// Stands in for UefiBootServicesTableLib.
+//
+EFI_BOOT_SERVICES  *gBS;
+
+STATIC EFI_BOOT_SERVICES                mBootServices;
+STATIC MU_PKCS5_PASSWORD_HASH_PROTOCOL  *mPkcs5;
+
+/**
+  Stands in for InstallMultipleProtocolInterfaces.  Keeps the PKCS5 protocol interface.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+StubInstallMultipleProtocolInterfaces (
+  IN OUT EFI_HANDLE  *Handle,
+  ...
+  )
+{
+  VA_LIST   Args;
+  EFI_GUID  *Guid;
+  VOID      *Interface;
+
+  VA_START (Args, Handle);
+  for ( ; ;) {
+    Guid = VA_ARG (Args, EFI_GUID *);
+    if (Guid == NULL) {
+      break;
+    }
+
+    Interface = VA_ARG (Args, VOID *);
+    if (CompareGuid (Guid, &gMuPKCS5PasswordHashProtocolGuid)) {
+      mPkcs5 = Interface;
+    }
+  }
+
+  VA_END (Args);
+  return EFI_SUCCESS;
+}
+
+/**
+  Installs the protocol.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetUpProtocol (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  ZeroMem (&mBootServices, sizeof (mBootServices));
+  mBootServices.InstallMultipleProtocolInterfaces = StubInstallMultipleProtocolInterfaces;
+  gBS                                             = &mBootServices;
+
+  mPkcs5 = NULL;
+  if (EFI_ERROR (InstallPkcs5Support (NULL)) || (mPkcs5 == NULL)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Every known answer is reproduced.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+KnownAnswers (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONST PBKDF2_KNOWN_ANSWER  *Vector;
+  UINT8                      Output[64];
+  UINTN                      Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mKnownAnswers); Index++) {
+    Vector = &mKnownAnswers[Index];
+    UT_LOG_INFO ("Vector %lu: %lu iterations, digest size %lu\n", (UINT64)Index, (UINT64)Vector->IterationCount, (UINT64)Vector->DigestSize);
+
+    SetMem (Output, sizeof (Output), 0xA5);
+    UT_ASSERT_NOT_EFI_ERROR (
+      mPkcs5->HashPassword (
+                mPkcs5,
+                Vector->PasswordSize,
+                Vector->Password,
+                Vector->SaltSize,
+                (CONST UINT8 *)Vector->Salt,
+                Vector->IterationCount,
+                Vector->DigestSize,
+                Vector->OutputSize,
+                Output
+                )
+      );
+    UT_ASSERT_MEM_EQUAL (Output, Vector->Expected, Vector->OutputSize);
+
+    //
+    // Nothing is written past OutputSize.
+    //
+    if (Vector->OutputSize < sizeof (Output)) {
+      UT_ASSERT_EQUAL (Output[Vector->OutputSize], 0xA5);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  SHA256 output is the same as Pkcs5HashPassword gives, across password, salt and output
+  sizes around the block and digest boundaries.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+MatchesPkcs5HashPassword (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINTN  PasswordSizes[]   = { 1, 31, 32, 33, 63, 64, 65, 100, 144 };
+  STATIC CONST UINTN  SaltSizes[]       = { 0, 1, 16, 59, 60, 64, 119 };
+  STATIC CONST UINTN  IterationCounts[] = { 1, 2, 3, 17, 1000 };
+  STATIC CONST UINTN  OutputSizes[]     = { 1, 31, 32, 33, 64, 100 };
+  UINT8               Salt[128];
+  UINT8               Output[100];
+  UINT8               Expected[100];
+  UINTN               PasswordIndex;
+  UINTN               SaltIndex;
+  UINTN               IterationIndex;
+  UINTN               OutputIndex;
+
+  for (SaltIndex = 0; SaltIndex < sizeof (Salt); SaltIndex++) {
+    Salt[SaltIndex] = (UINT8)(SaltIndex * 37 + 11);
+  }
+
+  for (PasswordIndex = 0; PasswordIndex < ARRAY_SIZE (PasswordSizes); PasswordIndex++) {
+    for (SaltIndex = 0; SaltIndex < ARRAY_SIZE (SaltSizes); SaltIndex++) {
+      for (IterationIndex = 0; IterationIndex < ARRAY_SIZE (IterationCounts); IterationIndex++) {
+        for (OutputIndex = 0; OutputIndex < ARRAY_SIZE (OutputSizes); OutputIndex++) {
+          UT_ASSERT_TRUE (
+            Pkcs5HashPassword (
+              PasswordSizes[PasswordIndex],
+              LONG_PASSWORD,
+              SaltSizes[SaltIndex],
+              Salt,
+              IterationCounts[IterationIndex],
+              SHA256_DIGEST_SIZE,
+              OutputSizes[OutputIndex],
+              Expected
+              )
+            );
+          UT_ASSERT_NOT_EFI_ERROR (
+            mPkcs5->HashPassword (
+                      mPkcs5,
+                      PasswordSizes[PasswordIndex],
+                      LONG_PASSWORD,
+                      SaltSizes[SaltIndex],
+                      Salt,
+                      IterationCounts[IterationIndex],
+                      SHA256_DIGEST_SIZE,
+                      OutputSizes[OutputIndex],
+                      Output
+                      )
+            );
+          UT_ASSERT_MEM_EQUAL (Output, Expected, OutputSizes[OutputIndex]);
+        }
+      }
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Parameters Pkcs5HashPassword refuses are refused.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BadParametersAreRefused (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  Salt[4];
+  UINT8  Output[SHA384_DIGEST_SIZE];
+
+  ZeroMem (Salt, sizeof (Salt));
+  UT_ASSERT_STATUS_EQUAL (mPkcs5->HashPassword (mPkcs5, 8, NULL, sizeof (Salt), Salt, 1, SHA256_DIGEST_SIZE, 32, Output), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (mPkcs5->HashPassword (mPkcs5, 8, "password", sizeof (Salt), NULL, 1, SHA256_DIGEST_SIZE, 32, Output), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (mPkcs5->HashPassword (mPkcs5, 8, "password", sizeof (Salt), Salt, 1, SHA384_DIGEST_SIZE, 48, NULL), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (mPkcs5->HashPassword (mPkcs5, 0, "password", sizeof (Salt), Salt, 1, SHA256_DIGEST_SIZE, 32, Output), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (mPkcs5->HashPassword (mPkcs5, 8, "password", sizeof (Salt), Salt, 0, SHA256_DIGEST_SIZE, 32, Output), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (mPkcs5->HashPassword (mPkcs5, 8, "password", sizeof (Salt), Salt, 1, SHA384_DIGEST_SIZE, 0, Output), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (mPkcs5->HashPassword (mPkcs5, 8, "password", sizeof (Salt), Salt, (UINTN)MAX_INT32 + 1, SHA256_DIGEST_SIZE, 32, Output), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (mPkcs5->HashPassword (mPkcs5, 8, "password", sizeof (Salt), Salt, 1, 17, 32, Output), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (mPkcs5->HashPassword (NULL, 8, "password", sizeof (Salt), Salt, 1, SHA256_DIGEST_SIZE, 32, Output), EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Times 1,000,000 SHA256 iterations through the protocol and through Pkcs5HashPassword.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IterationBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8    Output[SHA256_DIGEST_SIZE];
+  UINT8    Expected[SHA256_DIGEST_SIZE];
+  clock_t  Start;
+  clock_t  Protocol;
+  clock_t  Generic;
+
+  Start = clock ();
+  UT_ASSERT_NOT_EFI_ERROR (mPkcs5->HashPassword (mPkcs5, 8, "password", 4, (CONST UINT8 *)"salt", BENCHMARK_ITERATIONS, SHA256_DIGEST_SIZE, sizeof (Output), Output));
+  Protocol = clock () - Start;
+
+  Start = clock ();
+  UT_ASSERT_TRUE (Pkcs5HashPassword (8, "password", 4, (CONST UINT8 *)"salt", BENCHMARK_ITERATIONS, SHA256_DIGEST_SIZE, sizeof (Expected), Expected));
+  Generic = clock () - Start;
+
+  UT_ASSERT_MEM_EQUAL (Output, Expected, sizeof (Output));
+  UT_LOG_INFO (
+    "%lu iterations: %lu ms through the protocol, %lu ms through Pkcs5HashPassword.\n",
+    (UINT64)BENCHMARK_ITERATIONS,
+    (UINT64)(Protocol * 1000 / CLOCKS_PER_SEC),
+    (UINT64)(Generic * 1000 / CLOCKS_PER_SEC)
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  PBKDF2 behind the PKCS5 password hash protocol and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      Pkcs5SuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&Pkcs5SuiteHandle, Framework, "PBKDF2 tests", "MuCryptoDxe.Pbkdf2", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Pkcs5SuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (Pkcs5SuiteHandle, "Known answers are reproduced", "KnownAnswers", KnownAnswers, SetUpProtocol, NULL, NULL);
+  AddTestCase (Pkcs5SuiteHandle, "SHA256 matches Pkcs5HashPassword", "MatchesGeneric", MatchesPkcs5HashPassword, SetUpProtocol, NULL, NULL);
+  AddTestCase (Pkcs5SuiteHandle, "Bad parameters are refused", "BadParameters", BadParametersAreRefused, SetUpProtocol, NULL, NULL);
+  AddTestCase (Pkcs5SuiteHandle, "1,000,000 iterations benchmark", "IterationBenchmark", IterationBenchmark, SetUpProtocol, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
@@ -0,0 +1,574 @@
+/** @file
+  Host based unit tests for the MuCryptoDxe PKCS7 trusted certificate protocol.
+
+  The protocol is installed into a stand-in boot services table and used the way a
+  consumer would.  The signed MFCI test policies and the certificates they chain to are
+  verified with real BaseCryptLib, and every result is compared with a plain Pkcs7Verify
+  call.  The counters of the registered certificate show which payloads were found among
+  the ones that already verified.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseCryptLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UnitTestLib.h>
+#include <Protocol/MuPkcs7.h>
+#include <Protocol/MuPkcs7TrustedCert.h>
+#include "../MuCryptoDxe.h"
+#include "../Pkcs7TrustedCert.h"
+
+//
+// Test certificates and signed policies from MfciPkg.  The policies are signed by a leaf
+// that chains to CA.cer, and carry the signed content themselves.
+//
+#include "../../../MfciPkg/UnitTests/MfciPolicyParsingUnitTest/data/certs/CA.cer.h"
+#include "../../../MfciPkg/UnitTests/MfciPolicyParsingUnitTest/data/certs/CA_NotTrusted.cer.h"
+#include "../../../MfciPkg/UnitTests/MfciPolicyParsingUnitTest/data/certs/Root.cer.h"
+#include "../../../MfciPkg/UnitTests/MfciPolicyParsingUnitTest/data/packets/policy_good_manufacturing.bin.p7.h"
+#include "../../../MfciPkg/UnitTests/MfciPolicyParsingUnitTest/data/packets/policy_target_manufacturing.bin.p7.h"
+#include "LeafOnlySigned.p7.h"
+
+#define UNIT_TEST_NAME     "MuCryptoDxe PKCS7 Trusted Certificate Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+//
+// Stands in for UefiBootServicesTableLib.
+//
+EFI_BOOT_SERVICES  *gBS;
+
+STATIC EFI_BOOT_SERVICES               mBootServices;
+STATIC MU_PKCS7_TRUSTED_CERT_PROTOCOL  *mPkcs7;
+STATIC UINT8                           *mGoodContent;
+STATIC UINTN                           mGoodContentSize;
+STATIC UINT8                           *mTargetContent;
+STATIC UINTN                           mTargetContentSize;
+STATIC UINT8                           *mLeafOnlyContent;
+STATIC UINTN                           mLeafOnlyContentSize;
+
+/**
+  Stands in for InstallMultipleProtocolInterfaces.  Keeps the trusted certificate protocol interface.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+StubInstallMultipleProtocolInterfaces (
+  IN OUT EFI_HANDLE  *Handle,
+  ...
+  )
+{
+  VA_LIST   Args;
+  EFI_GUID  *Guid;
+  VOID      *Interface;
+
+  VA_START (Args, Handle);
+  for ( ; ;) {
+    Guid = VA_ARG (Args, EFI_GUID *);
+    if (Guid == NULL) {
+      break;
+    }
+
+    Interface = VA_ARG (Args, VOID *);
+    if (CompareGuid (Guid, &gMuPkcs7TrustedCertProtocolGuid)) {
+      mPkcs7 = Interface;
+    }
+  }
+
+  VA_END (Args);
+  return EFI_SUCCESS;
+}
+
+/**
+  Installs the protocol and extracts the content of the signed policies.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetUpProtocol (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  ZeroMem (&mBootServices, sizeof (mBootServices));
+  mBootServices.InstallMultipleProtocolInterfaces = StubInstallMultipleProtocolInterfaces;
+  gBS                                             = &mBootServices;
+
+  mPkcs7 = NULL;
+  if (EFI_ERROR (InstallPkcs7Support (NULL)) || (mPkcs7 == NULL)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  if (!Pkcs7GetAttachedContent (mSigned_policy_good_manufacturing, sizeof (mSigned_policy_good_manufacturing), (VOID **)&mGoodContent, &mGoodContentSize) ||
+      !Pkcs7GetAttachedContent (mSigned_policy_target_manufacturing, sizeof (mSigned_policy_target_manufacturing), (VOID **)&mTargetContent, &mTargetContentSize) ||
+      !Pkcs7GetAttachedContent (mSigned_leaf_only, sizeof (mSigned_leaf_only), (VOID **)&mLeafOnlyContent, &mLeafOnlyContentSize))
+  {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Frees the content extracted by SetUpProtocol.
+**/
+STATIC
+VOID
+EFIAPI
+CleanUpContent (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mGoodContent != NULL) {
+    FreePool (mGoodContent);
+    mGoodContent = NULL;
+  }
+
+  if (mTargetContent != NULL) {
+    FreePool (mTargetContent);
+    mTargetContent = NULL;
+  }
+
+  if (mLeafOnlyContent != NULL) {
+    FreePool (mLeafOnlyContent);
+    mLeafOnlyContent = NULL;
+  }
+}
+
+/**
+  Returns what a plain Pkcs7Verify call says about a payload.
+**/
+STATIC
+EFI_STATUS
+PlainVerify (
+  IN CONST UINT8  *Cert,
+  IN UINTN        CertLength,
+  IN CONST UINT8  *P7Data,
+  IN UINTN        P7DataLength,
+  IN CONST UINT8  *Data,
+  IN UINTN        DataLength
+  )
+{
+  return Pkcs7Verify (P7Data, P7DataLength, Cert, CertLength, Data, DataLength) ? EFI_SUCCESS : EFI_SECURITY_VIOLATION;
+}
+
+/**
+  Certificates that do not parse and bad handles are refused.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BadCertsAndHandlesAreRefused (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MU_PKCS7_TRUSTED_CERT_HANDLE  Handle;
+  MU_PKCS7_TRUSTED_CERT_HANDLE  Stale;
+  UINT8                         Garbage[64];
+
+  SetMem (Garbage, sizeof (Garbage), 0x30);
+  UT_ASSERT_STATUS_EQUAL (mPkcs7->RegisterTrustedCert (mPkcs7, Garbage, sizeof (Garbage), &Handle), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (mPkcs7->RegisterTrustedCert (mPkcs7, NULL, sizeof (mCert_Trusted_CA), &Handle), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (mPkcs7->RegisterTrustedCert (mPkcs7, mCert_Trusted_CA, sizeof (mCert_Trusted_CA), NULL), EFI_INVALID_PARAMETER);
+
+  UT_ASSERT_NOT_EFI_ERROR (mPkcs7->RegisterTrustedCert (mPkcs7, mCert_Trusted_CA, sizeof (mCert_Trusted_CA), &Stale));
+  UT_ASSERT_NOT_EFI_ERROR (mPkcs7->UnregisterTrustedCert (mPkcs7, Stale));
+
+  UT_ASSERT_STATUS_EQUAL (mPkcs7->UnregisterTrustedCert (mPkcs7, Stale), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (mPkcs7->UnregisterTrustedCert (mPkcs7, Garbage), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (
+    mPkcs7->VerifyWithTrustedCert (
+              mPkcs7,
+              Stale,
+              mSigned_policy_good_manufacturing,
+              sizeof (mSigned_policy_good_manufacturing),
+              mGoodContent,
+              mGoodContentSize
+              ),
+    EFI_INVALID_PARAMETER
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Every payload verifies against a handle exactly as it does with the raw certificate,
+  before and after it has been remembered.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+HandleMatchesPlainVerify (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST struct {
+    CONST UINT8    *Cert;
+    UINTN          CertLength;
+  } Certs[] = {
+    { mCert_Trusted_CA,   sizeof (mCert_Trusted_CA)   },
+    { mCertCA_NotTrusted, sizeof (mCertCA_NotTrusted) },
+  };
+  MU_PKCS7_TRUSTED_CERT_HANDLE  Handle;
+  MU_PKCS7_VERIFY_REQUEST       Payloads[5];
+  UINT8                         *Tampered;
+  UINT8                         *Truncated;
+  UINTN                         CertIndex;
+  UINTN                         Index;
+  UINTN                         Pass;
+  EFI_STATUS                    Expected;
+  EFI_STATUS                    Status;
+
+  Tampered  = AllocateCopyPool (mGoodContentSize, mGoodContent);
+  Truncated = AllocateCopyPool (sizeof (mSigned_policy_good_manufacturing), mSigned_policy_good_manufacturing);
+  UT_ASSERT_NOT_NULL (Tampered);
+  UT_ASSERT_NOT_NULL (Truncated);
+  Tampered[mGoodContentSize / 2] ^= 0x01;
+
+  ZeroMem (Payloads, sizeof (Payloads));
+  Payloads[0].P7Data       = mSigned_policy_good_manufacturing;
+  Payloads[0].P7DataLength = sizeof (mSigned_policy_good_manufacturing);
+  Payloads[0].Data         = mGoodContent;
+  Payloads[0].DataLength   = mGoodContentSize;
+  Payloads[1].P7Data       = mSigned_policy_target_manufacturing;
+  Payloads[1].P7DataLength = sizeof (mSigned_policy_target_manufacturing);
+  Payloads[1].Data         = mTargetContent;
+  Payloads[1].DataLength   = mTargetContentSize;
+  Payloads[2].P7Data       = mSigned_policy_good_manufacturing;
+  Payloads[2].P7DataLength = sizeof (mSigned_policy_good_manufacturing);
+  Payloads[2].Data         = Tampered;
+  Payloads[2].DataLength   = mGoodContentSize;
+  Payloads[3].P7Data       = mSigned_policy_good_manufacturing;
+  Payloads[3].P7DataLength = sizeof (mSigned_policy_good_manufacturing);
+  Payloads[3].Data         = mTargetContent;
+  Payloads[3].DataLength   = mTargetContentSize;
+  Payloads[4].P7Data       = Truncated;
+  Payloads[4].P7DataLength = sizeof (mSigned_policy_good_manufacturing) / 2;
+  Payloads[4].Data         = mGoodContent;
+  Payloads[4].DataLength   = mGoodContentSize;
+
+  for (CertIndex = 0; CertIndex < ARRAY_SIZE (Certs); CertIndex++) {
+    UT_ASSERT_NOT_EFI_ERROR (mPkcs7->RegisterTrustedCert (mPkcs7, Certs[CertIndex].Cert, Certs[CertIndex].CertLength, &Handle));
+
+    for (Pass = 0; Pass < 3; Pass++) {
+      for (Index = 0; Index < ARRAY_SIZE (Payloads); Index++) {
+        Expected = PlainVerify (
+                     Certs[CertIndex].Cert,
+                     Certs[CertIndex].CertLength,
+                     Payloads[Index].P7Data,
+                     Payloads[Index].P7DataLength,
+                     Payloads[Index].Data,
+                     Payloads[Index].DataLength
+                     );
+        Status = mPkcs7->VerifyWithTrustedCert (
+                           mPkcs7,
+                           Handle,
+                           Payloads[Index].P7Data,
+                           Payloads[Index].P7DataLength,
+                           Payloads[Index].Data,
+                           Payloads[Index].DataLength
+                           );
+        UT_ASSERT_STATUS_EQUAL (Status, Expected);
+
+        //
+        // Only the untampered policies verify, and only against the CA they chain to.
+        //
+        UT_ASSERT_EQUAL (Status == EFI_SUCCESS, (CertIndex == 0) && (Index < 2));
+      }
+    }
+
+    UT_ASSERT_NOT_EFI_ERROR (mPkcs7->UnregisterTrustedCert (mPkcs7, Handle));
+  }
+
+  FreePool (Tampered);
+  FreePool (Truncated);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A batch reports every payload, and the first failure overall.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BatchReportsEveryPayload (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MU_PKCS7_TRUSTED_CERT_HANDLE  Handle;
+  MU_PKCS7_VERIFY_REQUEST       Requests[4];
+
+  UT_ASSERT_NOT_EFI_ERROR (mPkcs7->RegisterTrustedCert (mPkcs7, mCert_Trusted_CA, sizeof (mCert_Trusted_CA), &Handle));
+
+  SetMem (Requests, sizeof (Requests), 0xA5);
+  Requests[0].P7Data       = mSigned_policy_good_manufacturing;
+  Requests[0].P7DataLength = sizeof (mSigned_policy_good_manufacturing);
+  Requests[0].Data         = mGoodContent;
+  Requests[0].DataLength   = mGoodContentSize;
+  Requests[1].P7Data       = mSigned_policy_target_manufacturing;
+  Requests[1].P7DataLength = sizeof (mSigned_policy_target_manufacturing);
+  Requests[1].Data         = mTargetContent;
+  Requests[1].DataLength   = mTargetContentSize;
+  CopyMem (&Requests[2], &Requests[0], sizeof (Requests[0]));
+  CopyMem (&Requests[3], &Requests[1], sizeof (Requests[1]));
+
+  UT_ASSERT_NOT_EFI_ERROR (mPkcs7->VerifyBatch (mPkcs7, Handle, Requests, ARRAY_SIZE (Requests)));
+  UT_ASSERT_NOT_EFI_ERROR (Requests[0].Status);
+  UT_ASSERT_NOT_EFI_ERROR (Requests[1].Status);
+  UT_ASSERT_NOT_EFI_ERROR (Requests[2].Status);
+  UT_ASSERT_NOT_EFI_ERROR (Requests[3].Status);
+
+  //
+  // Swap the content of the second pair, and leave out the content of the last one.
+  //
+  Requests[2].Data = mTargetContent;
+  Requests[3].Data = NULL;
+  UT_ASSERT_STATUS_EQUAL (mPkcs7->VerifyBatch (mPkcs7, Handle, Requests, ARRAY_SIZE (Requests)), EFI_SECURITY_VIOLATION);
+  UT_ASSERT_NOT_EFI_ERROR (Requests[0].Status);
+  UT_ASSERT_NOT_EFI_ERROR (Requests[1].Status);
+  UT_ASSERT_STATUS_EQUAL (Requests[2].Status, EFI_SECURITY_VIOLATION);
+  UT_ASSERT_STATUS_EQUAL (Requests[3].Status, EFI_INVALID_PARAMETER);
+
+  UT_ASSERT_STATUS_EQUAL (mPkcs7->VerifyBatch (mPkcs7, Handle, NULL, 1), EFI_INVALID_PARAMETER);
+  UT_ASSERT_NOT_EFI_ERROR (mPkcs7->VerifyBatch (mPkcs7, Handle, Requests, 0));
+
+  UT_ASSERT_NOT_EFI_ERROR (mPkcs7->UnregisterTrustedCert (mPkcs7, Handle));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Only a payload that is identical to one which already verified skips the verification.
+  A different policy from the same signer and a bad payload are verified against the
+  registered certificate, and an untrusted root remembers nothing.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+VerifiedPayloadIsRemembered (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MU_PKCS7_TRUSTED_CERT_HANDLE  Handle;
+  TRUSTED_CERT                  *Entry;
+
+  UT_ASSERT_NOT_EFI_ERROR (mPkcs7->RegisterTrustedCert (mPkcs7, mCert_Trusted_CA, sizeof (mCert_Trusted_CA), &Handle));
+  Entry = TrustedCertFromHandle (Handle);
+  UT_ASSERT_NOT_NULL (Entry);
+
+  UT_ASSERT_NOT_EFI_ERROR (
+    mPkcs7->VerifyWithTrustedCert (
+              mPkcs7,
+              Handle,
+              mSigned_policy_good_manufacturing,
+              sizeof (mSigned_policy_good_manufacturing),
+              mGoodContent,
+              mGoodContentSize
+              )
+    );
+  UT_ASSERT_EQUAL (Entry->ChainVerifications, 1);
+  UT_ASSERT_EQUAL (Entry->VerifiedCount, 1);
+
+  UT_ASSERT_NOT_EFI_ERROR (
+    mPkcs7->VerifyWithTrustedCert (
+              mPkcs7,
+              Handle,
+              mSigned_policy_good_manufacturing,
+              sizeof (mSigned_policy_good_manufacturing),
+              mGoodContent,
+              mGoodContentSize
+              )
+    );
+  UT_ASSERT_EQUAL (Entry->ChainVerifications, 1);
+  UT_ASSERT_EQUAL (Entry->VerifiedHits, 1);
+
+  UT_ASSERT_NOT_EFI_ERROR (
+    mPkcs7->VerifyWithTrustedCert (
+              mPkcs7,
+              Handle,
+              mSigned_policy_target_manufacturing,
+              sizeof (mSigned_policy_target_manufacturing),
+              mTargetContent,
+              mTargetContentSize
+              )
+    );
+  UT_ASSERT_EQUAL (Entry->ChainVerifications, 2);
+  UT_ASSERT_EQUAL (Entry->VerifiedHits, 1);
+  UT_ASSERT_EQUAL (Entry->VerifiedCount, 2);
+
+  UT_ASSERT_STATUS_EQUAL (
+    mPkcs7->VerifyWithTrustedCert (
+              mPkcs7,
+              Handle,
+              mSigned_policy_target_manufacturing,
+              sizeof (mSigned_policy_target_manufacturing),
+              mGoodContent,
+              mGoodContentSize
+              ),
+    EFI_SECURITY_VIOLATION
+    );
+  UT_ASSERT_EQUAL (Entry->ChainVerifications, 3);
+  UT_ASSERT_EQUAL (Entry->VerifiedCount, 2);
+
+  UT_ASSERT_NOT_EFI_ERROR (mPkcs7->UnregisterTrustedCert (mPkcs7, Handle));
+
+  UT_ASSERT_NOT_EFI_ERROR (mPkcs7->RegisterTrustedCert (mPkcs7, mCertCA_NotTrusted, sizeof (mCertCA_NotTrusted), &Handle));
+  Entry = TrustedCertFromHandle (Handle);
+  UT_ASSERT_NOT_NULL (Entry);
+  UT_ASSERT_STATUS_EQUAL (
+    mPkcs7->VerifyWithTrustedCert (
+              mPkcs7,
+              Handle,
+              mSigned_policy_good_manufacturing,
+              sizeof (mSigned_policy_good_manufacturing),
+              mGoodContent,
+              mGoodContentSize
+              ),
+    EFI_SECURITY_VIOLATION
+    );
+  UT_ASSERT_EQUAL (Entry->VerifiedCount, 0);
+
+  UT_ASSERT_NOT_EFI_ERROR (mPkcs7->UnregisterTrustedCert (mPkcs7, Handle));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A signer that chained to the registered root once does not become a trust anchor.  A
+  message from the same leaf that does not carry the CA between the leaf and the root
+  fails, just as it does with a plain Verify call.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SignerIsNotAnAnchor (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MU_PKCS7_TRUSTED_CERT_HANDLE  Handle;
+
+  //
+  // The leaf only message is good, it just needs the CA to be trusted.
+  //
+  UT_ASSERT_NOT_EFI_ERROR (mPkcs7->RegisterTrustedCert (mPkcs7, mCert_Trusted_CA, sizeof (mCert_Trusted_CA), &Handle));
+  UT_ASSERT_NOT_EFI_ERROR (
+    mPkcs7->VerifyWithTrustedCert (
+              mPkcs7,
+              Handle,
+              mSigned_leaf_only,
+              sizeof (mSigned_leaf_only),
+              mLeafOnlyContent,
+              mLeafOnlyContentSize
+              )
+    );
+  UT_ASSERT_NOT_EFI_ERROR (mPkcs7->UnregisterTrustedCert (mPkcs7, Handle));
+
+  UT_ASSERT_NOT_EFI_ERROR (mPkcs7->RegisterTrustedCert (mPkcs7, (CONST UINT8 *)mCertRoot_cer, sizeof (mCertRoot_cer), &Handle));
+  UT_ASSERT_NOT_EFI_ERROR (
+    mPkcs7->VerifyWithTrustedCert (
+              mPkcs7,
+              Handle,
+              mSigned_policy_good_manufacturing,
+              sizeof (mSigned_policy_good_manufacturing),
+              mGoodContent,
+              mGoodContentSize
+              )
+    );
+  UT_ASSERT_STATUS_EQUAL (
+    PlainVerify (
+      (CONST UINT8 *)mCertRoot_cer,
+      sizeof (mCertRoot_cer),
+      mSigned_leaf_only,
+      sizeof (mSigned_leaf_only),
+      mLeafOnlyContent,
+      mLeafOnlyContentSize
+      ),
+    EFI_SECURITY_VIOLATION
+    );
+  UT_ASSERT_STATUS_EQUAL (
+    mPkcs7->VerifyWithTrustedCert (
+              mPkcs7,
+              Handle,
+              mSigned_leaf_only,
+              sizeof (mSigned_leaf_only),
+              mLeafOnlyContent,
+              mLeafOnlyContentSize
+              ),
+    EFI_SECURITY_VIOLATION
+    );
+
+  UT_ASSERT_NOT_EFI_ERROR (mPkcs7->UnregisterTrustedCert (mPkcs7, Handle));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  PKCS7 trusted certificate handles and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      Pkcs7SuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&Pkcs7SuiteHandle, Framework, "PKCS7 trusted certificate tests", "MuCryptoDxe.Pkcs7TrustedCert", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for Pkcs7SuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (Pkcs7SuiteHandle, "Bad certificates and handles are refused", "BadCerts", BadCertsAndHandlesAreRefused, SetUpProtocol, CleanUpContent, NULL);
+  AddTestCase (Pkcs7SuiteHandle, "Handles verify like plain Verify", "MatchesPlain", HandleMatchesPlainVerify, SetUpProtocol, CleanUpContent, NULL);
+  AddTestCase (Pkcs7SuiteHandle, "A batch reports every payload", "Batch", BatchReportsEveryPayload, SetUpProtocol, CleanUpContent, NULL);
+  AddTestCase (Pkcs7SuiteHandle, "Verified payloads are remembered", "Verified", VerifiedPayloadIsRemembered, SetUpProtocol, CleanUpContent, NULL);
+  AddTestCase (Pkcs7SuiteHandle, "A signer is not a trust anchor", "NotAnchor", SignerIsNotAnAnchor, SetUpProtocol, CleanUpContent, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
@@ -0,0 +1,340 @@
+/** @file SerialOutputBuffer.c
+
+  Copyright (C) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+  Lock-free ring of formatted status code text waiting for the serial port.  See
+  SerialOutputBuffer.h.
+
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/PrintLib.h>
+#include <Library/SerialPortLib.h>
+#include <Library/SynchronizationLib.h>
+
+#include "SerialOutputBuffer.h"
+
+#define CHUNK_ALIGN(Size)  ALIGN_VALUE ((Size), 8)
+
+/**
+  Releases the chunk returned by PeekChunk.
+
+  Released space is always zero.  The next chunk header may land anywhere in it, and must
+  not look committed to the drain before its producer has filled it in.
+
+  @param[in] Output  Output buffer the chunk belongs to.
+  @param[in] Chunk   Chunk to release.
+**/
+STATIC
+VOID
+ReleaseChunk (
+  IN SERIAL_OUTPUT_BUFFER  *Output,
+  IN SERIAL_OUTPUT_CHUNK   *Chunk
+  )
+{
+  UINT32  Size;
+
+  Size = Chunk->Size;
+  ZeroMem (Chunk, Size);
+  MemoryFence ();
+  Output->Consumed += Size;
+}
+
+/**
+  Returns the oldest committed chunk without removing it.  Padding is released on the way.
+
+  @param[in] Output  Output buffer to read.
+
+  @return  The chunk, or NULL if the ring is empty or the oldest chunk is not committed yet.
+**/
+STATIC
+SERIAL_OUTPUT_CHUNK *
+PeekChunk (
+  IN SERIAL_OUTPUT_BUFFER  *Output
+  )
+{
+  UINT32               Tail;
+  SERIAL_OUTPUT_CHUNK  *Chunk;
+
+  for ( ; ;) {
+    Tail = Output->Consumed;
+    if (Tail == Output->Reserved) {
+      return NULL;
+    }
+
+    Chunk = (SERIAL_OUTPUT_CHUNK *)(Output->Buffer + (Tail & (Output->Size - 1)));
+    if ((*(volatile UINT32 *)&Chunk->Flags & SERIAL_OUTPUT_COMMITTED) == 0) {
+      //
+      // Still being filled in, possibly by a report this drain interrupted.  Chunks after
+      // it wait so the output stays in order.
+      //
+      return NULL;
+    }
+
+    MemoryFence ();
+    if ((Chunk->Flags & SERIAL_OUTPUT_PADDING) == 0) {
+      return Chunk;
+    }
+
+    ReleaseChunk (Output, Chunk);
+  }
+}
+
+/**
+  Adds to the count of dropped bytes.
+
+  @param[in] Output         Output buffer that dropped the text.
+  @param[in] NumberOfBytes  Bytes dropped.
+**/
+STATIC
+VOID
+CountDropped (
+  IN SERIAL_OUTPUT_BUFFER  *Output,
+  IN UINTN                 NumberOfBytes
+  )
+{
+  UINT32  Dropped;
+  UINT32  Updated;
+
+  do {
+    Dropped = Output->Dropped;
+    Updated = (UINT32)MIN ((UINTN)Dropped + NumberOfBytes, MAX_UINT32);
+  } while (InterlockedCompareExchange32 ((UINT32 *)&Output->Dropped, Dropped, Updated) != Dropped);
+}
+
+/**
+  Initializes an output buffer.
+
+  @param[out] Output  Output buffer to initialize.
+  @param[in]  Buffer  Backing storage for the ring.
+  @param[in]  Size    Size of Buffer.  Must be a power of two.
+
+  @retval EFI_SUCCESS            The ring is empty and ready.
+  @retval EFI_INVALID_PARAMETER  A parameter is NULL, or Size is not a power of two or too small.
+**/
+EFI_STATUS
+SerialOutputBufferInit (
+  OUT SERIAL_OUTPUT_BUFFER  *Output,
+  IN  VOID                  *Buffer,
+  IN  UINT32                Size
+  )
+{
+  if ((Output == NULL) || (Buffer == NULL) || (((UINTN)Buffer & 7) != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((Size < 4 * sizeof (SERIAL_OUTPUT_CHUNK)) || ((Size & (Size - 1)) != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Released space is always zero, see ReleaseChunk.
+  //
+  ZeroMem (Buffer, Size);
+  ZeroMem (Output, sizeof (SERIAL_OUTPUT_BUFFER));
+  Output->Buffer = Buffer;
+  Output->Size   = Size;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Reserves a chunk for text.  Safe to call while another chunk is being filled.
+
+  @param[in] Output  Output buffer to reserve in.
+  @param[in] Length  Bytes of text the chunk will hold.
+
+  @return  The chunk, with Size and Length set, or NULL if the ring is full.  The text
+           goes right after the header, and the chunk must be committed with
+           SerialOutputCommit.
+**/
+SERIAL_OUTPUT_CHUNK *
+SerialOutputReserve (
+  IN SERIAL_OUTPUT_BUFFER  *Output,
+  IN UINTN                 Length
+  )
+{
+  UINT32               Size;
+  UINT32               Head;
+  UINT32               Tail;
+  UINT32               Offset;
+  UINT32               Padding;
+  SERIAL_OUTPUT_CHUNK  *Chunk;
+
+  if (Length > Output->Size / 2) {
+    return NULL;
+  }
+
+  Size = (UINT32)CHUNK_ALIGN (sizeof (SERIAL_OUTPUT_CHUNK) + Length);
+  if (Size > Output->Size / 2) {
+    return NULL;
+  }
+
+  do {
+    Head   = Output->Reserved;
+    Tail   = Output->Consumed;
+    Offset = Head & (Output->Size - 1);
+
+    //
+    // Chunks never wrap.  If this one does not fit before the end of the buffer, the rest
+    // of the buffer is filled with a padding chunk and this one starts over at 0.
+    //
+    Padding = 0;
+    if (Size > Output->Size - Offset) {
+      Padding = Output->Size - Offset;
+    }
+
+    if ((Head - Tail) + Padding + Size > Output->Size) {
+      return NULL;
+    }
+  } while (InterlockedCompareExchange32 ((UINT32 *)&Output->Reserved, Head, Head + Padding + Size) != Head);
+
+  if (Padding != 0) {
+    Chunk       = (SERIAL_OUTPUT_CHUNK *)(Output->Buffer + Offset);
+    Chunk->Size = Padding;
+    MemoryFence ();
+    Chunk->Flags = SERIAL_OUTPUT_PADDING | SERIAL_OUTPUT_COMMITTED;
+    Offset       = 0;
+  }
+
+  Chunk         = (SERIAL_OUTPUT_CHUNK *)(Output->Buffer + Offset);
+  Chunk->Size   = Size;
+  Chunk->Length = (UINT32)Length;
+  return Chunk;
+}
+
+/**
+  Publishes a reserved chunk to the drain.
+
+  @param[in] Output  Output buffer the chunk was reserved in.
+  @param[in] Chunk   Chunk to publish.
+**/
+VOID
+SerialOutputCommit (
+  IN SERIAL_OUTPUT_BUFFER  *Output,
+  IN SERIAL_OUTPUT_CHUNK   *Chunk
+  )
+{
+  MemoryFence ();
+  Chunk->Flags |= SERIAL_OUTPUT_COMMITTED;
+  MemoryFence ();
+}
+
+/**
+  Queues text for the serial port.  If the ring is full it is drained first, and text too
+  large for the ring is written straight to the serial port once the ring is empty.
+
+  @param[in] Output         Output buffer to queue the text in.
+  @param[in] Buffer         Text to write.
+  @param[in] NumberOfBytes  Bytes in Buffer.
+**/
+VOID
+SerialOutputBufferWrite (
+  IN SERIAL_OUTPUT_BUFFER  *Output,
+  IN CONST UINT8           *Buffer,
+  IN UINTN                 NumberOfBytes
+  )
+{
+  SERIAL_OUTPUT_CHUNK  *Chunk;
+
+  if (NumberOfBytes == 0) {
+    return;
+  }
+
+  Chunk = SerialOutputReserve (Output, NumberOfBytes);
+  if ((Chunk == NULL) && SerialOutputBufferFlush (Output)) {
+    Chunk = SerialOutputReserve (Output, NumberOfBytes);
+    if (Chunk == NULL) {
+      //
+      // Larger than the ring allows.  Nothing is queued ahead of it any more.
+      //
+      SerialPortWrite ((UINT8 *)Buffer, NumberOfBytes);
+      return;
+    }
+  }
+
+  if (Chunk == NULL) {
+    CountDropped (Output, NumberOfBytes);
+    return;
+  }
+
+  CopyMem (Chunk + 1, Buffer, NumberOfBytes);
+  SerialOutputCommit (Output, Chunk);
+}
+
+/**
+  Writes every committed chunk to the serial port, oldest first.  Does nothing if a drain
+  is already in progress, which only happens when this call interrupted it.
+
+  @param[in] Output  Output buffer to drain.
+
+  @retval TRUE   The ring is empty.
+  @retval FALSE  A drain was already in progress, or a chunk reserved by a producer that
+                 this call interrupted is not committed yet.
+**/
+BOOLEAN
+SerialOutputBufferFlush (
+  IN SERIAL_OUTPUT_BUFFER  *Output
+  )
+{
+  SERIAL_OUTPUT_CHUNK  *Chunk;
+  UINTN                Burst;
+  UINT32               Dropped;
+  BOOLEAN              Empty;
+
+  if (InterlockedCompareExchange32 ((UINT32 *)&Output->Draining, 0, 1) != 0) {
+    return FALSE;
+  }
+
+  do {
+    //
+    // Gather as many chunks as fit into one burst.  The space is released as soon as the
+    // text is copied out, so producers can refill it while the burst is being written.
+    //
+    Burst = 0;
+    for ( ; ;) {
+      Chunk = PeekChunk (Output);
+      if (Chunk == NULL) {
+        break;
+      }
+
+      if (Chunk->Length > sizeof (Output->Burst) - Burst) {
+        if (Burst != 0) {
+          break;
+        }
+
+        SerialPortWrite ((UINT8 *)(Chunk + 1), Chunk->Length);
+        ReleaseChunk (Output, Chunk);
+        continue;
+      }
+
+      CopyMem (Output->Burst + Burst, Chunk + 1, Chunk->Length);
+      Burst += Chunk->Length;
+      ReleaseChunk (Output, Chunk);
+    }
+
+    if (Burst != 0) {
+      SerialPortWrite (Output->Burst, Burst);
+    }
+  } while (Burst != 0);
+
+  Empty = (BOOLEAN)(Output->Reserved == Output->Consumed);
+  if (Empty) {
+    do {
+      Dropped = Output->Dropped;
+    } while (InterlockedCompareExchange32 ((UINT32 *)&Output->Dropped, Dropped, 0) != Dropped);
+
+    if (Dropped != 0) {
+      Burst = AsciiSPrint ((CHAR8 *)Output->Burst, sizeof (Output->Burst), "\n*** %u bytes of serial output dropped ***\n", Dropped);
+      SerialPortWrite (Output->Burst, Burst);
+    }
+  }
+
+  MemoryFence ();
+  Output->Draining = 0;
+  return Empty;
+}
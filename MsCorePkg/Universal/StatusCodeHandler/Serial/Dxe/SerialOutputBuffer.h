@@ -0,0 +1,128 @@
+/** @file SerialOutputBuffer.h
+
+  Copyright (C) Microsoft Corporation. All rights reserved.
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+  Lock-free ring of formatted status code text waiting for the serial port.
+
+  The handler runs at TPL_HIGH_LEVEL, and writing a line to a 115200 baud UART holds every
+  interrupt off for several milliseconds.  With buffered output the handler only copies the
+  formatted text into this ring, and the ring is written to the serial port in large bursts
+  at TPL_CALLBACK.
+
+  Space is reserved with a compare-exchange on the producer counter, so a report that
+  interrupts another one gets its own chunk.  Chunks reach the serial port in the order they
+  were reserved, and a chunk is only written once it has been committed.  If the ring fills
+  up, the producer writes it out itself.  That is not possible while the producer has
+  interrupted a drain, so in that case the text is dropped, and the number of bytes dropped
+  is written once the ring has been drained.
+
+**/
+
+#ifndef _SERIAL_OUTPUT_BUFFER_H
+#define _SERIAL_OUTPUT_BUFFER_H
+
+//
+// Text collected from the ring for each SerialPortWrite call.
+//
+#define SERIAL_OUTPUT_BURST_SIZE  SIZE_4KB
+
+#define SERIAL_OUTPUT_COMMITTED  BIT0       // The chunk is complete.
+#define SERIAL_OUTPUT_PADDING    BIT1       // Filler up to the end of the ring.  Carries no text.
+
+//
+// Only Size and Flags are valid in a padding chunk.
+//
+typedef struct {
+  UINT32    Size;                           // Bytes in the chunk, header included.  Multiple of 8.
+  UINT32    Flags;
+  UINT32    Length;                         // Bytes of text following the header.
+  UINT32    Reserved;
+} SERIAL_OUTPUT_CHUNK;
+
+typedef struct {
+  UINT8              *Buffer;
+  UINT32             Size;                  // Power of two.
+  volatile UINT32    Reserved;              // Bytes ever reserved by producers.
+  volatile UINT32    Consumed;              // Bytes ever released by the drain.
+  volatile UINT32    Dropped;               // Bytes of text dropped and not reported yet.
+  volatile UINT32    Draining;              // Non-zero while a drain is writing to the serial port.
+  UINT8              Burst[SERIAL_OUTPUT_BURST_SIZE];
+} SERIAL_OUTPUT_BUFFER;
+
+/**
+  Initializes an output buffer.
+
+  @param[out] Output  Output buffer to initialize.
+  @param[in]  Buffer  Backing storage for the ring.
+  @param[in]  Size    Size of Buffer.  Must be a power of two.
+
+  @retval EFI_SUCCESS            The ring is empty and ready.
+  @retval EFI_INVALID_PARAMETER  A parameter is NULL, or Size is not a power of two or too small.
+**/
+EFI_STATUS
+SerialOutputBufferInit (
+  OUT SERIAL_OUTPUT_BUFFER  *Output,
+  IN  VOID                  *Buffer,
+  IN  UINT32                Size
+  );
+
+/**
+  Reserves a chunk for text.  Safe to call while another chunk is being filled.
+
+  @param[in] Output  Output buffer to reserve in.
+  @param[in] Length  Bytes of text the chunk will hold.
+
+  @return  The chunk, with Size and Length set, or NULL if the ring is full.  The text
+           goes right after the header, and the chunk must be committed with
+           SerialOutputCommit.
+**/
+SERIAL_OUTPUT_CHUNK *
+SerialOutputReserve (
+  IN SERIAL_OUTPUT_BUFFER  *Output,
+  IN UINTN                 Length
+  );
+
+/**
+  Publishes a reserved chunk to the drain.
+
+  @param[in] Output  Output buffer the chunk was reserved in.
+  @param[in] Chunk   Chunk to publish.
+**/
+VOID
+SerialOutputCommit (
+  IN SERIAL_OUTPUT_BUFFER  *Output,
+  IN SERIAL_OUTPUT_CHUNK   *Chunk
+  );
+
+/**
+  Queues text for the serial port.  If the ring is full it is drained first, and text too
+  large for the ring is written straight to the serial port once the ring is empty.
+
+  @param[in] Output         Output buffer to queue the text in.
+  @param[in] Buffer         Text to write.
+  @param[in] NumberOfBytes  Bytes in Buffer.
+**/
+VOID
+SerialOutputBufferWrite (
+  IN SERIAL_OUTPUT_BUFFER  *Output,
+  IN CONST UINT8           *Buffer,
+  IN UINTN                 NumberOfBytes
+  );
+
+/**
+  Writes every committed chunk to the serial port, oldest first.  Does nothing if a drain
+  is already in progress, which only happens when this call interrupted it.
+
+  @param[in] Output  Output buffer to drain.
+
+  @retval TRUE   The ring is empty.
+  @retval FALSE  A drain was already in progress, or a chunk reserved by a producer that
+                 this call interrupted is not committed yet.
+**/
+BOOLEAN
+SerialOutputBufferFlush (
+  IN SERIAL_OUTPUT_BUFFER  *Output
+  );
+
+#endif // _SERIAL_OUTPUT_BUFFER_H
@@ -10,15 +10,147 @@ Copyright (C) Microsoft Corporation. All rights reserved.
 #include <PiDxe.h>
 #include <Library/SerialPortLib.h>
 #include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Guid/EventGroup.h>
 #include <Guid/StatusCodeDataTypeDebug.h>
 #include <Protocol/ReportStatusCodeHandler.h>
 #include "../Common/SerialStatusCodeHandler.h"
+#include "SerialOutputBuffer.h"
+
+//
+// How often buffered output is written to the serial port, in 100ns units.
+//
+#define SERIAL_OUTPUT_DRAIN_PERIOD  100000
 
 EFI_RSC_HANDLER_PROTOCOL  *mRscHandlerProtocol   = NULL;
 EFI_EVENT                 mExitBootServicesEvent = NULL;
 EFI_EVENT                 mRscRegisterEvent      = NULL;
+EFI_EVENT                 mDrainTimerEvent       = NULL;
+BOOLEAN                   mBufferedOutput        = FALSE;
+UINT32                    mWriteThrough          = 0;
+SERIAL_OUTPUT_BUFFER      mSerialOutput;
+
+/**
+  Status code handler used when output is buffered.
+
+  Reports are formatted into the output buffer like any other.  An unrecovered error,
+  ASSERT() included, may be the last thing the system does, so its text and everything
+  queued ahead of it is written out before returning.  If the error interrupted a drain,
+  the queue cannot be written until the drain resumes, which may never happen, so the
+  error text is written straight to the serial port instead.
+
+  @param  CodeType         Indicates the type of status code being reported.
+  @param  Value            Describes the current status of a hardware or software entity.
+  @param  Instance         The enumeration of a hardware or software entity within the system.
+  @param  CallerId         This optional parameter may be used to identify the caller.
+  @param  Data             This optional parameter may be used to pass additional data.
+
+  @retval EFI_SUCCESS      Status code reported to serial I/O successfully.
+
+**/
+EFI_STATUS
+EFIAPI
+BufferedSerialStatusCode (
+  IN EFI_STATUS_CODE_TYPE        CodeType,
+  IN EFI_STATUS_CODE_VALUE       Value,
+  IN UINT32                      Instance,
+  IN CONST EFI_GUID              *CallerId,
+  IN CONST EFI_STATUS_CODE_DATA  *Data OPTIONAL
+  )
+{
+  BOOLEAN  Unrecovered;
+
+  Unrecovered = (BOOLEAN)(((CodeType & EFI_STATUS_CODE_TYPE_MASK) == EFI_ERROR_CODE) &&
+                          ((CodeType & EFI_STATUS_CODE_SEVERITY_MASK) == EFI_ERROR_UNRECOVERED));
+
+  if (Unrecovered && (mSerialOutput.Draining != 0)) {
+    mWriteThrough++;
+    SerialStatusCode (CodeType, Value, Instance, CallerId, Data);
+    mWriteThrough--;
+    return EFI_SUCCESS;
+  }
+
+  SerialStatusCode (CodeType, Value, Instance, CallerId, Data);
+
+  if (Unrecovered) {
+    SerialOutputBufferFlush (&mSerialOutput);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Writes the buffered status code text to the serial port.
+
+  @param  Event         Event whose notification function is being invoked.
+  @param  Context       Pointer to the notification function's context.
+
+**/
+VOID
+EFIAPI
+DrainSerialOutput (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  SerialOutputBufferFlush (&mSerialOutput);
+}
+
+/**
+  Sets up buffered output: the ring and the timer that drains it.
+
+  @retval EFI_SUCCESS            Output is buffered.
+  @retval EFI_OUT_OF_RESOURCES   The ring could not be allocated.
+  @retval Others                 The timer could not be started.
+
+**/
+STATIC
+EFI_STATUS
+InitializeBufferedOutput (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+  VOID        *Buffer;
+  UINT32      Size;
+
+  Size   = FixedPcdGet32 (PcdSerialStatusCodeBufferSize);
+  Buffer = AllocatePool (Size);
+  if (Buffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = SerialOutputBufferInit (&mSerialOutput, Buffer, Size);
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_CALLBACK,
+                  DrainSerialOutput,
+                  NULL,
+                  &mDrainTimerEvent
+                  );
+  if (EFI_ERROR (Status)) {
+    goto Exit;
+  }
+
+  Status = gBS->SetTimer (mDrainTimerEvent, TimerPeriodic, SERIAL_OUTPUT_DRAIN_PERIOD);
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (mDrainTimerEvent);
+    mDrainTimerEvent = NULL;
+  }
+
+Exit:
+  if (EFI_ERROR (Status)) {
+    FreePool (Buffer);
+  }
+
+  return Status;
+}
 
 /**
 
@@ -37,7 +169,19 @@ UnregisterBootTimeHandlers (
   IN VOID       *Context
   )
 {
-  mRscHandlerProtocol->Unregister ((EFI_RSC_HANDLER_CALLBACK)SerialStatusCode);
+  if (!mBufferedOutput) {
+    mRscHandlerProtocol->Unregister ((EFI_RSC_HANDLER_CALLBACK)SerialStatusCode);
+    return;
+  }
+
+  mRscHandlerProtocol->Unregister ((EFI_RSC_HANDLER_CALLBACK)BufferedSerialStatusCode);
+  gBS->CloseEvent (mDrainTimerEvent);
+
+  //
+  // Nothing can queue more text now, and the drain timer runs at this TPL, so it cannot
+  // be in the middle of a drain.
+  //
+  SerialOutputBufferFlush (&mSerialOutput);
 }
 
 /**
@@ -77,7 +221,20 @@ DxeEntry (
     return Status;
   }
 
-  mRscHandlerProtocol->Register ((EFI_RSC_HANDLER_CALLBACK)SerialStatusCode, TPL_HIGH_LEVEL);
+  if (FeaturePcdGet (PcdSerialStatusCodeBufferedOutput)) {
+    Status = InitializeBufferedOutput ();
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a: buffered output unavailable, writing directly (%r)\n", __FUNCTION__, Status));
+    } else {
+      mBufferedOutput = TRUE;
+    }
+  }
+
+  if (mBufferedOutput) {
+    mRscHandlerProtocol->Register ((EFI_RSC_HANDLER_CALLBACK)BufferedSerialStatusCode, TPL_HIGH_LEVEL);
+  } else {
+    mRscHandlerProtocol->Register ((EFI_RSC_HANDLER_CALLBACK)SerialStatusCode, TPL_HIGH_LEVEL);
+  }
 
   //
   // This callback should be invoked AFTER the ExitBootServices callback
@@ -129,5 +286,9 @@ WriteStatusCode (
   IN UINTN  NumberOfBytes
   )
 {
-  SerialPortWrite (Buffer, NumberOfBytes);
+  if (mBufferedOutput && (mWriteThrough == 0)) {
+    SerialOutputBufferWrite (&mSerialOutput, Buffer, NumberOfBytes);
+  } else {
+    SerialPortWrite (Buffer, NumberOfBytes);
+  }
 }
@@ -0,0 +1,727 @@
+/** @file
+  Host based unit tests for the buffered output of the DXE serial status code handler.
+
+  SerialPortWrite is replaced with a mock UART that keeps everything written to it and
+  charges 115200 baud worth of time for every byte.  The same status codes are reported
+  with output written directly and with output buffered, and the time each call to the
+  handler spent on the UART is compared, as is the text that reached it.  Reports that
+  interrupt another report or a drain are simulated with the reserve and commit steps of
+  the buffer and from inside the mock UART.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <PiDxe.h>
+#include <Guid/StatusCodeDataTypeDebug.h>
+#include <Guid/StatusCodeDataTypeId.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/DebugPrintErrorLevelLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include <Library/ReportStatusCodeLib.h>
+#include <Library/SerialPortLib.h>
+#include <Library/UnitTestLib.h>
+#include "../../Common/SerialStatusCodeHandler.h"
+#include "../SerialOutputBuffer.h"
+
+#define UNIT_TEST_NAME     "Serial Status Code Buffered Output Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define TEST_RING_SIZE        SIZE_64KB
+#define SMALL_RING_SIZE       SIZE_1KB
+#define WORKLOAD_REPORTS      4000
+#define REPORTS_PER_DRAIN     32
+#define TEXT_BUFFER_SIZE      SIZE_4MB
+#define DEBUG_ARGUMENT_SLOTS  12
+
+//
+// 115200 baud with 10 bits on the wire for every byte.
+//
+#define UART_NS_PER_BYTE  86806
+
+typedef struct {
+  UINT64    Storage[EFI_STATUS_CODE_DATA_MAX_SIZE / sizeof (UINT64)];
+} TEST_DATA;
+
+typedef VOID (*UART_INTERRUPT)(
+  VOID
+  );
+
+typedef struct {
+  BOOLEAN                 Buffered;
+  VOID                    *RingBuffer;
+  SERIAL_OUTPUT_BUFFER    *Output;
+  CHAR8                   *Uart;              // Everything written to the mock UART.
+  UINTN                   UartLength;
+  UINT64                  UartTime;           // Nanoseconds spent writing to the mock UART.
+  UINTN                   UartWrites;
+  UART_INTERRUPT          Interrupt;          // Runs once from inside the next UART write.
+  CHAR8                   *Expected;
+  UINTN                   ExpectedLength;
+} TEST_CONTEXT;
+
+STATIC TEST_CONTEXT  mTest;
+STATIC UINT32        mRandomState;
+
+STATIC CONST EFI_GUID  mTestCallerId = {
+  0x2f6d8c14, 0x91ab, 0x4c3e, { 0xb0, 0x57, 0x6a, 0x1d, 0xe3, 0x48, 0x90, 0x2c }
+};
+
+/**
+  Mock UART.  Keeps the text and charges the time the bytes take on the wire.
+**/
+UINTN
+EFIAPI
+SerialPortWrite (
+  IN UINT8  *Buffer,
+  IN UINTN  NumberOfBytes
+  )
+{
+  UART_INTERRUPT  Interrupt;
+
+  ASSERT (mTest.UartLength + NumberOfBytes < TEXT_BUFFER_SIZE);
+  CopyMem (mTest.Uart + mTest.UartLength, Buffer, NumberOfBytes);
+  mTest.UartLength            += NumberOfBytes;
+  mTest.Uart[mTest.UartLength] = '\0';
+  mTest.UartTime              += MultU64x32 (NumberOfBytes, UART_NS_PER_BYTE);
+  mTest.UartWrites++;
+
+  Interrupt = mTest.Interrupt;
+  if (Interrupt != NULL) {
+    mTest.Interrupt = NULL;
+    Interrupt ();
+  }
+
+  return NumberOfBytes;
+}
+
+/**
+  Same as the DXE handler.
+**/
+VOID
+EFIAPI
+WriteStatusCode (
+  IN UINT8  *Buffer,
+  IN UINTN  NumberOfBytes
+  )
+{
+  if (mTest.Buffered) {
+    SerialOutputBufferWrite (mTest.Output, Buffer, NumberOfBytes);
+  } else {
+    SerialPortWrite (Buffer, NumberOfBytes);
+  }
+}
+
+/**
+  Stands in for DebugPrintErrorLevelLib.
+**/
+UINT32
+EFIAPI
+GetDebugPrintErrorLevel (
+  VOID
+  )
+{
+  return DEBUG_INFO | DEBUG_ERROR;
+}
+
+/**
+  Stands in for ReportStatusCodeLib.  Same as the DXE instance.
+**/
+BOOLEAN
+EFIAPI
+ReportStatusCodeExtractAssertInfo (
+  IN EFI_STATUS_CODE_TYPE        CodeType,
+  IN EFI_STATUS_CODE_VALUE       Value,
+  IN CONST EFI_STATUS_CODE_DATA  *Data,
+  OUT CHAR8                      **Filename,
+  OUT CHAR8                      **Description,
+  OUT UINT32                     *LineNumber
+  )
+{
+  EFI_DEBUG_ASSERT_DATA  *AssertData;
+
+  if (((CodeType & EFI_STATUS_CODE_TYPE_MASK) == EFI_ERROR_CODE) &&
+      ((CodeType & EFI_STATUS_CODE_SEVERITY_MASK) == EFI_ERROR_UNRECOVERED) &&
+      ((Value & EFI_STATUS_CODE_OPERATION_MASK) == EFI_SW_EC_ILLEGAL_SOFTWARE_STATE))
+  {
+    AssertData   = (EFI_DEBUG_ASSERT_DATA *)(Data + 1);
+    *Filename    = (CHAR8 *)(AssertData + 1);
+    *Description = *Filename + AsciiStrLen (*Filename) + 1;
+    *LineNumber  = AssertData->LineNumber;
+    return TRUE;
+  }
+
+  return FALSE;
+}
+
+/**
+  Stands in for ReportStatusCodeLib.  Same as the DXE instance.
+**/
+BOOLEAN
+EFIAPI
+ReportStatusCodeExtractDebugInfo (
+  IN CONST EFI_STATUS_CODE_DATA  *Data,
+  OUT UINT32                     *ErrorLevel,
+  OUT BASE_LIST                  *Marker,
+  OUT CHAR8                      **Format
+  )
+{
+  EFI_DEBUG_INFO  *DebugInfo;
+
+  if (!CompareGuid (&Data->Type, &gEfiStatusCodeDataTypeDebugGuid)) {
+    return FALSE;
+  }
+
+  DebugInfo   = (EFI_DEBUG_INFO *)(Data + 1);
+  *ErrorLevel = DebugInfo->ErrorLevel;
+  *Marker     = (BASE_LIST)(DebugInfo + 1);
+  *Format     = (CHAR8 *)(((UINT64 *)*Marker) + DEBUG_ARGUMENT_SLOTS);
+  return TRUE;
+}
+
+/**
+  Deterministic pseudo random numbers so that failures reproduce.
+**/
+STATIC
+UINT32
+NextRandom (
+  VOID
+  )
+{
+  mRandomState = mRandomState * 1103515245 + 12345;
+  return (mRandomState >> 8) & 0xFFFFFF;
+}
+
+/**
+  Appends text to a growing buffer.
+**/
+STATIC
+VOID
+AppendText (
+  IN OUT CHAR8        *Text,
+  IN OUT UINTN        *Length,
+  IN     CONST CHAR8  *Source,
+  IN     UINTN        SourceLength
+  )
+{
+  ASSERT (*Length + SourceLength < TEXT_BUFFER_SIZE);
+  CopyMem (Text + *Length, Source, SourceLength);
+  *Length      += SourceLength;
+  Text[*Length] = '\0';
+}
+
+/**
+  Packs a DEBUG ((DEBUG_INFO, "%a: %d bytes at 0x%lx\n", ...)) report the way the
+  ReportStatusCode DebugLib does.
+**/
+STATIC
+EFI_STATUS_CODE_DATA *
+PackDebugData (
+  OUT TEST_DATA    *Data,
+  IN  CONST CHAR8  *Name,
+  IN  UINT32       Count,
+  IN  UINT64       Address
+  )
+{
+  STATIC CONST CHAR8    Format[] = "%a: %d bytes at 0x%lx\n";
+  EFI_STATUS_CODE_DATA  *Header;
+  EFI_DEBUG_INFO        *DebugInfo;
+  BASE_LIST             Marker;
+  CHAR8                 *FormatString;
+
+  ZeroMem (Data, sizeof (TEST_DATA));
+  Header                = (EFI_STATUS_CODE_DATA *)Data->Storage;
+  DebugInfo             = (EFI_DEBUG_INFO *)(Header + 1);
+  Marker                = (BASE_LIST)(DebugInfo + 1);
+  FormatString          = (CHAR8 *)((UINT64 *)(DebugInfo + 1) + DEBUG_ARGUMENT_SLOTS);
+  DebugInfo->ErrorLevel = DEBUG_INFO;
+
+  Header->HeaderSize = sizeof (EFI_STATUS_CODE_DATA);
+  Header->Size       = (UINT16)((FormatString + sizeof (Format)) - (CHAR8 *)DebugInfo);
+  CopyGuid (&Header->Type, &gEfiStatusCodeDataTypeDebugGuid);
+  CopyMem (FormatString, Format, sizeof (Format));
+
+  BASE_ARG (Marker, CONST CHAR8 *) = Name;
+  BASE_ARG (Marker, int)           = (int)Count;
+  BASE_ARG (Marker, UINT64)        = Address;
+
+  return Header;
+}
+
+/**
+  Reports the Index'th status code of a mixed workload: DEBUG() output, progress codes,
+  error codes, ASCII strings of random length and the occasional ASSERT().
+
+  @return  Nanoseconds the handler spent on the UART.
+**/
+STATIC
+UINT64
+ReportWorkload (
+  IN UINTN  Index
+  )
+{
+  TEST_DATA                    Data;
+  EFI_STATUS_CODE_DATA         *Header;
+  EFI_STATUS_CODE_STRING_DATA  *StringData;
+  EFI_DEBUG_ASSERT_DATA        *AssertData;
+  CHAR8                        String[400];
+  CHAR8                        *Filename;
+  UINTN                        Length;
+  UINTN                        Char;
+  UINT64                       Start;
+
+  Start = mTest.UartTime;
+
+  switch (Index % 5) {
+    case 0:
+      Header = PackDebugData (&Data, "PciBus", NextRandom (), MultU64x32 (NextRandom (), 0x1000));
+      SerialStatusCode (EFI_DEBUG_CODE, EFI_SOFTWARE_DXE_CORE | EFI_DC_UNSPECIFIED, 0, NULL, Header);
+      break;
+
+    case 1:
+      SerialStatusCode (EFI_PROGRESS_CODE, EFI_SOFTWARE_DXE_CORE | (UINT32)Index, 0, NULL, NULL);
+      break;
+
+    case 2:
+      SerialStatusCode (EFI_ERROR_CODE | EFI_ERROR_MINOR, EFI_SOFTWARE_DXE_BS_DRIVER | EFI_SW_EC_ABORTED, (UINT32)Index, &mTestCallerId, NULL);
+      break;
+
+    case 3:
+      Length = 1 + NextRandom () % (sizeof (String) - 1);
+      for (Char = 0; Char < Length; Char++) {
+        String[Char] = (CHAR8)('a' + (Index + Char) % 26);
+      }
+
+      String[Length - 1] = '\n';
+
+      ZeroMem (&Data, sizeof (Data));
+      StringData                        = (EFI_STATUS_CODE_STRING_DATA *)Data.Storage;
+      StringData->DataHeader.HeaderSize = sizeof (EFI_STATUS_CODE_DATA);
+      StringData->DataHeader.Size       = (UINT16)Length;
+      CopyGuid (&StringData->DataHeader.Type, &gEfiStatusCodeDataTypeStringGuid);
+      StringData->StringType   = EfiStringAscii;
+      StringData->String.Ascii = String;
+      SerialStatusCode (EFI_DEBUG_CODE, EFI_SOFTWARE_DXE_CORE | EFI_DC_UNSPECIFIED, 0, NULL, &StringData->DataHeader);
+      break;
+
+    default:
+      if ((Index % 95) != 4) {
+        SerialStatusCode (EFI_PROGRESS_CODE | 0x80, EFI_SOFTWARE_DXE_CORE, 0, NULL, NULL);
+        break;
+      }
+
+      ZeroMem (&Data, sizeof (Data));
+      Header                 = (EFI_STATUS_CODE_DATA *)Data.Storage;
+      Header->HeaderSize     = sizeof (EFI_STATUS_CODE_DATA);
+      AssertData             = (EFI_DEBUG_ASSERT_DATA *)(Header + 1);
+      AssertData->LineNumber = (UINT32)Index;
+      Filename               = (CHAR8 *)(AssertData + 1);
+      AsciiStrCpyS (Filename, 64, "Driver.c");
+      AsciiStrCpyS (Filename + sizeof ("Driver.c"), 64, "Pointer != NULL");
+      SerialStatusCode (
+        EFI_ERROR_CODE | EFI_ERROR_UNRECOVERED,
+        EFI_SOFTWARE_DXE_BS_DRIVER | EFI_SW_EC_ILLEGAL_SOFTWARE_STATE,
+        0,
+        NULL,
+        Header
+        );
+      break;
+  }
+
+  return mTest.UartTime - Start;
+}
+
+/**
+  Allocates a ring of the given size and empty text buffers.
+**/
+STATIC
+UNIT_TEST_STATUS
+SetUpOutput (
+  IN UINT32  Size
+  )
+{
+  mRandomState     = 0x5EB1A1C0;
+  mTest.Output     = AllocateZeroPool (sizeof (SERIAL_OUTPUT_BUFFER));
+  mTest.RingBuffer = AllocatePages (EFI_SIZE_TO_PAGES (Size));
+  mTest.Uart       = AllocatePool (TEXT_BUFFER_SIZE);
+  mTest.Expected   = AllocatePool (TEXT_BUFFER_SIZE);
+  if ((mTest.Output == NULL) || (mTest.RingBuffer == NULL) || (mTest.Uart == NULL) || (mTest.Expected == NULL)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  mTest.Uart[0]     = '\0';
+  mTest.Expected[0] = '\0';
+  mTest.Buffered    = TRUE;
+
+  if (EFI_ERROR (SerialOutputBufferInit (mTest.Output, mTest.RingBuffer, Size))) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetUpLargeOutput (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return SetUpOutput (TEST_RING_SIZE);
+}
+
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetUpSmallOutput (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  return SetUpOutput (SMALL_RING_SIZE);
+}
+
+STATIC
+VOID
+EFIAPI
+TearDownOutput (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mTest.RingBuffer != NULL) {
+    FreePages (mTest.RingBuffer, EFI_SIZE_TO_PAGES (mTest.Output->Size));
+  }
+
+  if (mTest.Output != NULL) {
+    FreePool (mTest.Output);
+  }
+
+  if (mTest.Uart != NULL) {
+    FreePool (mTest.Uart);
+  }
+
+  if (mTest.Expected != NULL) {
+    FreePool (mTest.Expected);
+  }
+
+  ZeroMem (&mTest, sizeof (mTest));
+}
+
+/**
+  Moves what the mock UART received so far to mTest.Expected and clears the UART.
+**/
+STATIC
+VOID
+KeepUartAsExpected (
+  VOID
+  )
+{
+  AppendText (mTest.Expected, &mTest.ExpectedLength, mTest.Uart, mTest.UartLength);
+  mTest.Uart[0]    = '\0';
+  mTest.UartLength = 0;
+  mTest.UartTime   = 0;
+  mTest.UartWrites = 0;
+}
+
+/**
+  Buffered output reaches the UART exactly as direct output does, and the handler no longer
+  spends any time on the UART.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BufferedOutputMatchesDirect (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN   Index;
+  UINT64  Latency;
+  UINT64  DirectTotal;
+  UINT64  DirectMax;
+  UINT64  BufferedMax;
+  UINTN   DirectWrites;
+
+  mTest.Buffered = FALSE;
+  DirectTotal    = 0;
+  DirectMax      = 0;
+  for (Index = 0; Index < WORKLOAD_REPORTS; Index++) {
+    Latency      = ReportWorkload (Index);
+    DirectTotal += Latency;
+    DirectMax    = MAX (DirectMax, Latency);
+  }
+
+  DirectWrites = mTest.UartWrites;
+  KeepUartAsExpected ();
+
+  //
+  // Same reports, drained every so often the way the timer does.
+  //
+  mRandomState   = 0x5EB1A1C0;
+  mTest.Buffered = TRUE;
+  BufferedMax    = 0;
+  for (Index = 0; Index < WORKLOAD_REPORTS; Index++) {
+    Latency     = ReportWorkload (Index);
+    BufferedMax = MAX (BufferedMax, Latency);
+    if ((Index % REPORTS_PER_DRAIN) == REPORTS_PER_DRAIN - 1) {
+      UT_ASSERT_TRUE (SerialOutputBufferFlush (mTest.Output));
+    }
+  }
+
+  UT_ASSERT_TRUE (SerialOutputBufferFlush (mTest.Output));
+
+  UT_LOG_INFO (
+    "Direct: %d UART writes, %d us worst handler call, %d ms total.  Buffered: %d UART writes, %d us worst handler call.\n",
+    DirectWrites,
+    (UINT32)DivU64x32 (DirectMax, 1000),
+    (UINT32)DivU64x32 (DirectTotal, 1000000),
+    mTest.UartWrites,
+    (UINT32)DivU64x32 (BufferedMax, 1000)
+    );
+
+  UT_ASSERT_EQUAL (mTest.UartLength, mTest.ExpectedLength);
+  UT_ASSERT_MEM_EQUAL (mTest.Uart, mTest.Expected, mTest.ExpectedLength);
+  UT_ASSERT_TRUE (DirectMax > 0);
+  UT_ASSERT_EQUAL (BufferedMax, 0);
+  UT_ASSERT_TRUE (mTest.UartWrites * 8 < DirectWrites);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A report that interrupts another one goes out after it, even though it finished first.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+NestedWritesKeepOrder (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST CHAR8   Outer[]  = "outer report\n";
+  STATIC CONST CHAR8   Inner1[] = "first nested report\n";
+  STATIC CONST CHAR8   Inner2[] = "second nested report\n";
+  SERIAL_OUTPUT_CHUNK  *Chunk;
+
+  Chunk = SerialOutputReserve (mTest.Output, sizeof (Outer) - 1);
+  UT_ASSERT_NOT_NULL (Chunk);
+
+  SerialOutputBufferWrite (mTest.Output, (CONST UINT8 *)Inner1, sizeof (Inner1) - 1);
+  SerialOutputBufferWrite (mTest.Output, (CONST UINT8 *)Inner2, sizeof (Inner2) - 1);
+
+  //
+  // The outer report is not committed yet, so nothing may go out.
+  //
+  UT_ASSERT_FALSE (SerialOutputBufferFlush (mTest.Output));
+  UT_ASSERT_EQUAL (mTest.UartLength, 0);
+
+  CopyMem (Chunk + 1, Outer, sizeof (Outer) - 1);
+  SerialOutputCommit (mTest.Output, Chunk);
+
+  UT_ASSERT_TRUE (SerialOutputBufferFlush (mTest.Output));
+  UT_ASSERT_EQUAL (mTest.UartWrites, 1);
+  UT_ASSERT_EQUAL (AsciiStrCmp (mTest.Uart, "outer report\nfirst nested report\nsecond nested report\n"), 0);
+  UT_ASSERT_EQUAL (mTest.Output->Reserved, mTest.Output->Consumed);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A full ring is drained by the handler itself, and text larger than the ring is written
+  straight through after what was queued ahead of it.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+FullRingDrainsInline (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CHAR8   Line[SMALL_RING_SIZE];
+  UINTN   Length;
+  UINTN   Index;
+  UINTN   InlineDrains;
+  UINT64  Start;
+
+  InlineDrains = 0;
+  for (Index = 0; Index < 500; Index++) {
+    if (Index == 250) {
+      //
+      // Larger than half the ring.
+      //
+      SetMem (Line, sizeof (Line) - 1, 'x');
+      Line[sizeof (Line) - 1] = '\n';
+      Length                  = sizeof (Line);
+    } else {
+      Length = AsciiSPrint (Line, sizeof (Line), "line %d: %a\n", Index, "abcdefghijklmnopqrstuvwxyz" + (NextRandom () % 26));
+    }
+
+    AppendText (mTest.Expected, &mTest.ExpectedLength, Line, Length);
+
+    Start = mTest.UartTime;
+    SerialOutputBufferWrite (mTest.Output, (UINT8 *)Line, Length);
+    if (mTest.UartTime != Start) {
+      InlineDrains++;
+    }
+  }
+
+  UT_ASSERT_TRUE (InlineDrains > 0);
+  UT_ASSERT_TRUE (InlineDrains < 100);
+  UT_ASSERT_TRUE (SerialOutputBufferFlush (mTest.Output));
+  UT_ASSERT_EQUAL (mTest.UartLength, mTest.ExpectedLength);
+  UT_ASSERT_MEM_EQUAL (mTest.Uart, mTest.Expected, mTest.ExpectedLength);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Reports made from inside a UART write.  The drain they interrupted owns the UART.
+**/
+STATIC
+VOID
+ReportDuringDrain (
+  VOID
+  )
+{
+  CHAR8  Line[64];
+  UINTN  Length;
+  UINTN  Index;
+
+  for (Index = 0; Index < 100; Index++) {
+    Length = AsciiSPrint (Line, sizeof (Line), "interrupting report %d\n", Index);
+    SerialOutputBufferWrite (mTest.Output, (UINT8 *)Line, Length);
+  }
+}
+
+/**
+  Text that does not fit while a drain is interrupted is dropped, counted and reported once
+  the ring is empty.  Everything that did fit goes out in order.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+InterruptedDrainCountsDropped (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CHAR8   Line[64];
+  CHAR8   Notice[80];
+  UINTN   Length;
+  UINTN   Index;
+  UINTN   Kept;
+  UINT32  Dropped;
+
+  Length = AsciiSPrint (Line, sizeof (Line), "before the drain\n");
+  SerialOutputBufferWrite (mTest.Output, (UINT8 *)Line, Length);
+  AppendText (mTest.Expected, &mTest.ExpectedLength, Line, Length);
+
+  mTest.Interrupt = ReportDuringDrain;
+  UT_ASSERT_TRUE (SerialOutputBufferFlush (mTest.Output));
+  UT_ASSERT_TRUE (mTest.Interrupt == NULL);
+
+  //
+  // Every chunk holds one line of the same size, so the reports that fit are the first
+  // ones made.
+  //
+  Length = AsciiSPrint (Line, sizeof (Line), "interrupting report %d\n", 10);
+  Kept   = SMALL_RING_SIZE / ALIGN_VALUE (sizeof (SERIAL_OUTPUT_CHUNK) + Length, 8);
+  UT_ASSERT_TRUE (Kept < 100);
+
+  Dropped = 0;
+  for (Index = 0; Index < 100; Index++) {
+    Length = AsciiSPrint (Line, sizeof (Line), "interrupting report %d\n", Index);
+    if (Index < Kept) {
+      AppendText (mTest.Expected, &mTest.ExpectedLength, Line, Length);
+    } else {
+      Dropped += (UINT32)Length;
+    }
+  }
+
+  Length = AsciiSPrint (Notice, sizeof (Notice), "\n*** %u bytes of serial output dropped ***\n", Dropped);
+  AppendText (mTest.Expected, &mTest.ExpectedLength, Notice, Length);
+
+  UT_ASSERT_EQUAL (mTest.UartLength, mTest.ExpectedLength);
+  UT_ASSERT_MEM_EQUAL (mTest.Uart, mTest.Expected, mTest.ExpectedLength);
+  UT_ASSERT_EQUAL (mTest.Output->Dropped, 0);
+  UT_ASSERT_EQUAL (mTest.Output->Draining, 0);
+
+  //
+  // The ring works normally afterwards.
+  //
+  SerialOutputBufferWrite (mTest.Output, (CONST UINT8 *)"after\n", 6);
+  UT_ASSERT_TRUE (SerialOutputBufferFlush (mTest.Output));
+  UT_ASSERT_EQUAL (AsciiStrCmp (mTest.Uart + mTest.ExpectedLength, "after\n"), 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  buffered serial output and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      OutputSuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&OutputSuiteHandle, Framework, "Buffered serial output tests", "SerialStatusCode.BufferedOutput", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for OutputSuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (OutputSuiteHandle, "Buffered output matches direct output", "MatchesDirect", BufferedOutputMatchesDirect, SetUpLargeOutput, TearDownOutput, NULL);
+  AddTestCase (OutputSuiteHandle, "Nested writes keep their order", "NestedWrites", NestedWritesKeepOrder, SetUpLargeOutput, TearDownOutput, NULL);
+  AddTestCase (OutputSuiteHandle, "A full ring drains inline", "FullRing", FullRingDrainsInline, SetUpSmallOutput, TearDownOutput, NULL);
+  AddTestCase (OutputSuiteHandle, "An interrupted drain counts dropped text", "InterruptedDrain", InterruptedDrainCountsDropped, SetUpSmallOutput, TearDownOutput, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
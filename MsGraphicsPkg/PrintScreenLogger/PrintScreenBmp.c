@@ -0,0 +1,743 @@
+/** @file
+PrintScreenBmp.c
+
+Streams the Gop frame buffer to a .BMP file in bounded strips of rows.
+
+Copyright (C) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "PrintScreenLogger.h"
+
+#define BMP_BITS_PER_PIXEL      24
+#define BMP_RLE8_BITS_PER_PIXEL 8
+#define BMP_RLE8_COMPRESSION    1
+#define BMP_RLE8_MAX_COLORS     256
+#define BMP_RLE8_MAX_RUN        255
+#define COLOR_HASH_SIZE         1024            // Power of 2, at least 2x BMP_RLE8_MAX_COLORS
+#define COLOR_HASH_EMPTY        MAX_UINT32      // Pixels are masked to 24 bits so this never matches a color
+
+#define SWAP_RED_BLUE(Pixel)  ((((Pixel) >> 16) & 0xFF) | ((Pixel) & 0xFF00) | (((Pixel) & 0xFF) << 16))
+
+//
+// Color table used to build the RLE8 palette.  Open addressing keyed on the 24 bit color.
+//
+typedef struct {
+  UINT32    Key[COLOR_HASH_SIZE];
+  UINT8     Index[COLOR_HASH_SIZE];
+  UINT32    Palette[BMP_RLE8_MAX_COLORS];
+  UINTN     Count;
+} COLOR_TABLE;
+
+/**
+  Write a buffer to the file, failing on a short write.
+
+  @param  FileHandle    File to write.
+  @param  Buffer        Data to write.
+  @param  BufferSize    Number of bytes to write.
+
+  @retval EFI_SUCCESS           The buffer was written.
+  @retval EFI_BAD_BUFFER_SIZE   The file system wrote fewer bytes than requested.
+  @retval Others                The write failed.
+
+**/
+STATIC
+EFI_STATUS
+WriteChunk (
+  IN EFI_FILE_PROTOCOL  *FileHandle,
+  IN VOID               *Buffer,
+  IN UINTN              BufferSize
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       WriteSize;
+
+  WriteSize = BufferSize;
+  Status    = FileHandle->Write (FileHandle, &WriteSize, Buffer);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Error writing Bmp file. Code=%r\n", Status));
+    return Status;
+  }
+
+  if (WriteSize != BufferSize) {
+    DEBUG ((DEBUG_ERROR, "Wrong number of bytes written.  S/B=%ld, Actual=%ld\n", BufferSize, WriteSize));
+    return EFI_BAD_BUFFER_SIZE;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Convert one row of 32 bpp Blt pixels to packed 24 bpp, four pixels per iteration.
+
+  Four pixels are loaded as UINT32s and repacked into three UINT32 stores.
+
+  @param  Src           Row of Blt pixels.
+  @param  Dst           Receives Width * 3 bytes.
+  @param  Width         Number of pixels in the row.
+  @param  SwapRedBlue   TRUE to emit Red, Green, Blue instead of Blue, Green, Red.
+
+**/
+STATIC
+VOID
+SwizzleRowTo24Bpp (
+  IN  CONST UINT32  *Src,
+  OUT UINT8         *Dst,
+  IN  UINTN         Width,
+  IN  BOOLEAN       SwapRedBlue
+  )
+{
+  UINTN   Index;
+  UINT32  P0;
+  UINT32  P1;
+  UINT32  P2;
+  UINT32  P3;
+
+  for (Index = 0; Index + 4 <= Width; Index += 4) {
+    P0 = Src[Index];
+    P1 = Src[Index + 1];
+    P2 = Src[Index + 2];
+    P3 = Src[Index + 3];
+    if (SwapRedBlue) {
+      P0 = SWAP_RED_BLUE (P0);
+      P1 = SWAP_RED_BLUE (P1);
+      P2 = SWAP_RED_BLUE (P2);
+      P3 = SWAP_RED_BLUE (P3);
+    }
+
+    WriteUnaligned32 ((UINT32 *)Dst, (P0 & 0xFFFFFF) | (P1 << 24));
+    WriteUnaligned32 ((UINT32 *)(Dst + 4), ((P1 >> 8) & 0xFFFF) | (P2 << 16));
+    WriteUnaligned32 ((UINT32 *)(Dst + 8), ((P2 >> 16) & 0xFF) | (P3 << 8));
+    Dst += 12;
+  }
+
+  for ( ; Index < Width; Index++) {
+    P0 = Src[Index];
+    if (SwapRedBlue) {
+      P0 = SWAP_RED_BLUE (P0);
+    }
+
+    *Dst++ = (UINT8)P0;
+    *Dst++ = (UINT8)(P0 >> 8);
+    *Dst++ = (UINT8)(P0 >> 16);
+  }
+}
+
+/**
+  Look up a color in the color table, optionally adding it if there is room.
+
+  @param  Table         Color table.
+  @param  Color         24 bit color.
+  @param  Add           TRUE to add the color if it is not in the table.
+  @param  PaletteIndex  Receives the palette index of the color.
+
+  @retval TRUE          The color is in the table.
+  @retval FALSE         The color is not in the table.
+
+**/
+STATIC
+BOOLEAN
+LookupColor (
+  IN  COLOR_TABLE  *Table,
+  IN  UINT32       Color,
+  IN  BOOLEAN      Add,
+  OUT UINT8        *PaletteIndex
+  )
+{
+  UINTN  Slot;
+
+  Slot = ((Color * 0x9E3779B1) >> 22) & (COLOR_HASH_SIZE - 1);
+  while (Table->Key[Slot] != COLOR_HASH_EMPTY) {
+    if (Table->Key[Slot] == Color) {
+      *PaletteIndex = Table->Index[Slot];
+      return TRUE;
+    }
+
+    Slot = (Slot + 1) & (COLOR_HASH_SIZE - 1);
+  }
+
+  if (!Add || (Table->Count == BMP_RLE8_MAX_COLORS)) {
+    return FALSE;
+  }
+
+  Table->Key[Slot]              = Color;
+  Table->Index[Slot]            = (UINT8)Table->Count;
+  Table->Palette[Table->Count]  = Color;
+  *PaletteIndex                 = (UINT8)Table->Count;
+  Table->Count++;
+  return TRUE;
+}
+
+/**
+  Fill the common fields of a BMP header.
+
+  @param  BmpHeader     Header to fill.
+  @param  Width         Image width in pixels.
+  @param  Height        Image height in pixels.
+
+**/
+STATIC
+VOID
+InitBmpHeader (
+  OUT BMP_IMAGE_HEADER  *BmpHeader,
+  IN  UINT32            Width,
+  IN  UINT32            Height
+  )
+{
+  ZeroMem (BmpHeader, sizeof (BMP_IMAGE_HEADER));
+  BmpHeader->CharB           = 'B';   // Header flag
+  BmpHeader->CharM           = 'M';
+  BmpHeader->HeaderSize      = sizeof (BMP_IMAGE_HEADER) - OFFSET_OF (BMP_IMAGE_HEADER, HeaderSize);
+  BmpHeader->PixelWidth      = Width;
+  BmpHeader->PixelHeight     = Height;
+  BmpHeader->Planes          = 1;
+  BmpHeader->XPixelsPerMeter = 11000;    // Approximately 300 dpi
+  BmpHeader->YPixelsPerMeter = 11000;
+}
+
+/**
+  Read a strip of rows from the frame buffer.
+
+  @param  Gop           GRAPHICS_OUTPUT_PROTOCOL
+  @param  Strip         Receives Width * Rows Blt pixels.
+  @param  Top           First screen row of the strip.
+  @param  Width         Width of the screen.
+  @param  Rows          Number of rows in the strip.
+
+  @retval EFI_SUCCESS   The strip was read.
+  @retval Others        Gop->Blt failed.
+
+**/
+STATIC
+EFI_STATUS
+ReadStrip (
+  IN  EFI_GRAPHICS_OUTPUT_PROTOCOL   *Gop,
+  OUT EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Strip,
+  IN  UINT32                         Top,
+  IN  UINT32                         Width,
+  IN  UINT32                         Rows
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = Gop->Blt (
+                  Gop,
+                  Strip,
+                  EfiBltVideoToBltBuffer,
+                  0,
+                  Top,
+                  0,
+                  0,
+                  Width,
+                  Rows,
+                  0
+                  );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Unable to BLt video to buffer, code=%r\n", Status));
+  }
+
+  return Status;
+}
+
+/**
+  Build the RLE8 palette for the screen.
+
+  @param  Gop           GRAPHICS_OUTPUT_PROTOCOL
+  @param  Strip         Strip buffer of RowsPerStrip rows.
+  @param  RowsPerStrip  Rows read per Blt.
+  @param  SwapRedBlue   TRUE if the palette is stored Red, Green, Blue.
+  @param  Table         Receives the palette.
+
+  @retval EFI_SUCCESS       The screen has no more than 256 colors.
+  @retval EFI_UNSUPPORTED   The screen has more than 256 colors.
+
+**/
+STATIC
+EFI_STATUS
+BuildPalette (
+  IN  EFI_GRAPHICS_OUTPUT_PROTOCOL   *Gop,
+  IN  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Strip,
+  IN  UINT32                         RowsPerStrip,
+  IN  BOOLEAN                        SwapRedBlue,
+  OUT COLOR_TABLE                    *Table
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Width;
+  UINT32      Height;
+  UINT32      Top;
+  UINT32      Rows;
+  UINTN       Index;
+  UINT32      Pixel;
+  UINT32      LastPixel;
+  UINT8       PaletteIndex;
+
+  Width  = Gop->Mode->Info->HorizontalResolution;
+  Height = Gop->Mode->Info->VerticalResolution;
+
+  SetMem32 (Table->Key, sizeof (Table->Key), COLOR_HASH_EMPTY);
+  Table->Count = 0;
+  LastPixel    = COLOR_HASH_EMPTY;
+
+  for (Top = 0; Top < Height; Top += Rows) {
+    Rows   = MIN (RowsPerStrip, Height - Top);
+    Status = ReadStrip (Gop, Strip, Top, Width, Rows);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    for (Index = 0; Index < (UINTN)Width * Rows; Index++) {
+      Pixel = ((UINT32 *)Strip)[Index] & 0xFFFFFF;
+      if (Pixel == LastPixel) {
+        continue;
+      }
+
+      LastPixel = Pixel;
+      if (!LookupColor (Table, SwapRedBlue ? SWAP_RED_BLUE (Pixel) : Pixel, TRUE, &PaletteIndex)) {
+        return EFI_UNSUPPORTED;
+      }
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Encode one row as BMP RLE8 runs terminated by an end of line marker.
+
+  A color that appeared after the palette was built (the screen changed during
+  the capture) is added to the palette while there is room for it.
+
+  @param  Table         Palette built by BuildPalette.
+  @param  Src           Row of Blt pixels.
+  @param  Width         Number of pixels in the row.
+  @param  SwapRedBlue   TRUE if the palette is stored Red, Green, Blue.
+  @param  Dst           Receives at most (Width * 2) + 2 bytes.
+
+  @retval Number of bytes written to Dst, or 0 if the row needs more than 256 colors.
+
+**/
+STATIC
+UINTN
+EncodeRowRle8 (
+  IN  COLOR_TABLE   *Table,
+  IN  CONST UINT32  *Src,
+  IN  UINTN         Width,
+  IN  BOOLEAN       SwapRedBlue,
+  OUT UINT8         *Dst
+  )
+{
+  UINTN   Index;
+  UINTN   Run;
+  UINT32  Pixel;
+  UINT8   PaletteIndex;
+  UINT8   *Start;
+
+  Start = Dst;
+  for (Index = 0; Index < Width; Index += Run) {
+    Pixel = Src[Index] & 0xFFFFFF;
+    for (Run = 1; (Index + Run < Width) && (Run < BMP_RLE8_MAX_RUN) && ((Src[Index + Run] & 0xFFFFFF) == Pixel); Run++) {
+    }
+
+    if (!LookupColor (Table, SwapRedBlue ? SWAP_RED_BLUE (Pixel) : Pixel, TRUE, &PaletteIndex)) {
+      return 0;
+    }
+
+    *Dst++ = (UINT8)Run;
+    *Dst++ = PaletteIndex;
+  }
+
+  *Dst++ = 0;   // End of line
+  *Dst++ = 0;
+
+  return (UINTN)(Dst - Start);
+}
+
+/**
+  Write the screen as an RLE8 compressed .BMP.  Room is left for a full 256
+  entry palette so colors that appear while the capture is in progress can
+  still be added; the header and palette are rewritten once the compressed
+  size is known.
+
+  @param  Gop           GRAPHICS_OUTPUT_PROTOCOL
+  @param  FileHandle    File to write.
+  @param  Strip         Strip buffer of RowsPerStrip rows.
+  @param  RowsPerStrip  Rows read per Blt.
+  @param  SwapRedBlue   TRUE if the palette is stored Red, Green, Blue.
+  @param  Table         Palette built by BuildPalette.
+  @param  BytesWritten  Receives the number of bytes written to the file.
+
+  @retval EFI_SUCCESS       The screen was written to the file.
+  @retval EFI_UNSUPPORTED   The screen changed during the capture and now has more
+                            than 256 colors.  The file holds a partial image.
+  @retval Others            Reading the screen or writing the file failed.
+
+**/
+STATIC
+EFI_STATUS
+WriteRle8Bmp (
+  IN  EFI_GRAPHICS_OUTPUT_PROTOCOL   *Gop,
+  IN  EFI_FILE_PROTOCOL              *FileHandle,
+  IN  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Strip,
+  IN  UINT32                         RowsPerStrip,
+  IN  BOOLEAN                        SwapRedBlue,
+  IN  COLOR_TABLE                    *Table,
+  OUT UINTN                          *BytesWritten
+  )
+{
+  EFI_STATUS        Status;
+  BMP_IMAGE_HEADER  BmpHeader;
+  UINT8             *Encoded;
+  UINTN             EncodedSize;
+  UINTN             RowSize;
+  UINTN             ImageSize;
+  UINT32            Width;
+  UINT32            Height;
+  UINT32            Bottom;
+  UINT32            Top;
+  UINT32            Rows;
+  UINT32            Row;
+  UINT8             EndOfBitmap[2];
+
+  Width  = Gop->Mode->Info->HorizontalResolution;
+  Height = Gop->Mode->Info->VerticalResolution;
+
+  Encoded = AllocatePool ((UINTN)RowsPerStrip * ((Width * 2) + 2));
+  if (NULL == Encoded) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  InitBmpHeader (&BmpHeader, Width, Height);
+  BmpHeader.ImageOffset     = (UINT32)(sizeof (BMP_IMAGE_HEADER) + sizeof (Table->Palette));
+  BmpHeader.BitPerPixel     = BMP_RLE8_BITS_PER_PIXEL;
+  BmpHeader.CompressionType = BMP_RLE8_COMPRESSION;
+
+  //
+  // Write a placeholder header and palette.
+  //
+  *BytesWritten = 0;
+  Status        = WriteChunk (FileHandle, &BmpHeader, sizeof (BmpHeader));
+  if (!EFI_ERROR (Status)) {
+    Status = WriteChunk (FileHandle, Table->Palette, sizeof (Table->Palette));
+  }
+
+  ImageSize = 0;
+  for (Bottom = Height; (Bottom > 0) && !EFI_ERROR (Status); Bottom = Top) {
+    Rows   = MIN (RowsPerStrip, Bottom);
+    Top    = Bottom - Rows;
+    Status = ReadStrip (Gop, Strip, Top, Width, Rows);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    EncodedSize = 0;
+    for (Row = 0; Row < Rows; Row++) {
+      RowSize = EncodeRowRle8 (
+                  Table,
+                  (UINT32 *)&Strip[(Rows - Row - 1) * Width],
+                  Width,
+                  SwapRedBlue,
+                  Encoded + EncodedSize
+                  );
+      if (RowSize == 0) {
+        DEBUG ((DEBUG_INFO, "%a: Screen changed to more than %d colors during the capture\n", __FUNCTION__, BMP_RLE8_MAX_COLORS));
+        Status = EFI_UNSUPPORTED;
+        break;
+      }
+
+      EncodedSize += RowSize;
+    }
+
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Status     = WriteChunk (FileHandle, Encoded, EncodedSize);
+    ImageSize += EncodedSize;
+  }
+
+  if (!EFI_ERROR (Status)) {
+    EndOfBitmap[0] = 0;
+    EndOfBitmap[1] = 1;
+    Status         = WriteChunk (FileHandle, EndOfBitmap, sizeof (EndOfBitmap));
+    ImageSize     += sizeof (EndOfBitmap);
+  }
+
+  *BytesWritten = BmpHeader.ImageOffset + ImageSize;
+
+  //
+  // Now that the compressed size and the final palette are known, rewrite the
+  // header and the palette.
+  //
+  if (!EFI_ERROR (Status)) {
+    BmpHeader.ImageSize      = (UINT32)ImageSize;
+    BmpHeader.Size           = (UINT32)(BmpHeader.ImageOffset + ImageSize);
+    BmpHeader.NumberOfColors = (UINT32)Table->Count;
+    Status                   = FileHandle->SetPosition (FileHandle, 0);
+    if (!EFI_ERROR (Status)) {
+      Status = WriteChunk (FileHandle, &BmpHeader, sizeof (BmpHeader));
+    }
+
+    if (!EFI_ERROR (Status)) {
+      Status = WriteChunk (FileHandle, Table->Palette, Table->Count * sizeof (UINT32));
+    }
+  }
+
+  FreePool (Encoded);
+  return Status;
+}
+
+/**
+  Shrink a file that was partly written by an abandoned RLE8 capture and then
+  overwritten with a shorter image.
+
+  @param  FileHandle    File to truncate.
+  @param  Size          New size of the file.
+
+  @retval EFI_SUCCESS   The file is Size bytes long.
+  @retval Others        The file information could not be read or updated.
+
+**/
+STATIC
+EFI_STATUS
+TruncateFile (
+  IN EFI_FILE_PROTOCOL  *FileHandle,
+  IN UINT64             Size
+  )
+{
+  EFI_STATUS     Status;
+  EFI_FILE_INFO  *FileInfo;
+  UINTN          InfoSize;
+
+  InfoSize = 0;
+  Status   = FileHandle->GetInfo (FileHandle, &gEfiFileInfoGuid, &InfoSize, NULL);
+  if (Status != EFI_BUFFER_TOO_SMALL) {
+    return EFI_ERROR (Status) ? Status : EFI_DEVICE_ERROR;
+  }
+
+  FileInfo = AllocatePool (InfoSize);
+  if (NULL == FileInfo) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Status = FileHandle->GetInfo (FileHandle, &gEfiFileInfoGuid, &InfoSize, FileInfo);
+  if (!EFI_ERROR (Status) && (FileInfo->FileSize > Size)) {
+    FileInfo->FileSize = Size;
+    Status             = FileHandle->SetInfo (FileHandle, &gEfiFileInfoGuid, InfoSize, FileInfo);
+  }
+
+  FreePool (FileInfo);
+  return Status;
+}
+
+/**
+  Write the screen as an uncompressed 24 bpp .BMP, one strip of rows at a time.
+
+  The file layout matches the original whole-screen writer exactly, including the
+  header padding and the trailing pad after the last row.
+
+  @param  Gop           GRAPHICS_OUTPUT_PROTOCOL
+  @param  FileHandle    File to write.
+  @param  Strip         Strip buffer of RowsPerStrip rows.
+  @param  RowsPerStrip  Rows read per Blt.
+  @param  SwapRedBlue   TRUE to emit Red, Green, Blue instead of Blue, Green, Red.
+  @param  BmpSize       Receives the size of the .BMP.
+
+**/
+STATIC
+EFI_STATUS
+WriteUncompressedBmp (
+  IN  EFI_GRAPHICS_OUTPUT_PROTOCOL   *Gop,
+  IN  EFI_FILE_PROTOCOL              *FileHandle,
+  IN  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Strip,
+  IN  UINT32                         RowsPerStrip,
+  IN  BOOLEAN                        SwapRedBlue,
+  OUT UINTN                          *BmpSize
+  )
+{
+  EFI_STATUS        Status;
+  BMP_IMAGE_HEADER  *BmpHeader;
+  UINT8             *Image;
+  UINTN             DataSizePerLine;
+  UINTN             BmpBufferSize;
+  UINTN             HeaderSize;
+  UINTN             ImageDataSize;
+  UINT32            Width;
+  UINT32            Height;
+  UINT32            Bottom;
+  UINT32            Top;
+  UINT32            Rows;
+  UINT32            Row;
+
+  Width  = Gop->Mode->Info->HorizontalResolution;
+  Height = Gop->Mode->Info->VerticalResolution;
+
+  HeaderSize      = (sizeof (BMP_IMAGE_HEADER) + 3) & ~0x03;   // Start first row on 4 byte boundary
+  DataSizePerLine = ((Width * BMP_BITS_PER_PIXEL + 31) >> 3) & (~0x3);
+  ImageDataSize   = (UINTN)MultU64x32 (DataSizePerLine, Height);
+  BmpBufferSize   = ImageDataSize + sizeof (BMP_IMAGE_HEADER) + HeaderSize;
+
+  if (BmpBufferSize > (UINT32) ~0) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *BmpSize = BmpBufferSize;
+
+  //
+  // Image holds either the header or one converted strip.  The zeroed tail of the
+  // allocation supplies the row padding and the trailing pad.
+  //
+  Image = AllocateZeroPool (MAX (DataSizePerLine * RowsPerStrip, HeaderSize + sizeof (BMP_IMAGE_HEADER)));
+  if (NULL == Image) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  BmpHeader = (BMP_IMAGE_HEADER *)Image;
+  InitBmpHeader (BmpHeader, Width, Height);
+  BmpHeader->Size        = (UINT32)BmpBufferSize;
+  BmpHeader->ImageOffset = (UINT32)HeaderSize;
+  BmpHeader->BitPerPixel = BMP_BITS_PER_PIXEL;
+
+  Status = WriteChunk (FileHandle, Image, HeaderSize);
+  ZeroMem (Image, HeaderSize);
+
+  //
+  // BMP rows are stored bottom up, so walk the screen from the bottom strip to the top.
+  //
+  for (Bottom = Height; (Bottom > 0) && !EFI_ERROR (Status); Bottom = Top) {
+    Rows   = MIN (RowsPerStrip, Bottom);
+    Top    = Bottom - Rows;
+    Status = ReadStrip (Gop, Strip, Top, Width, Rows);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    for (Row = 0; Row < Rows; Row++) {
+      SwizzleRowTo24Bpp (
+        (UINT32 *)&Strip[(Rows - Row - 1) * Width],
+        Image + (Row * DataSizePerLine),
+        Width,
+        SwapRedBlue
+        );
+    }
+
+    Status = WriteChunk (FileHandle, Image, DataSizePerLine * Rows);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    ZeroMem (Image, BmpBufferSize - HeaderSize - ImageDataSize);
+    Status = WriteChunk (FileHandle, Image, BmpBufferSize - HeaderSize - ImageDataSize);
+  }
+
+  FreePool (Image);
+  return Status;
+}
+
+/**
+  Convert a Gop 32 bits per pixel video frame buffer to a .BMP file.
+
+  The frame buffer is read and converted in strips of at most StripSize bytes so
+  the memory needed does not grow with the screen resolution.
+
+  @param  Gop           GRAPHICS_OUTPUT_PROTOCOL
+  @param  FileHandle    File to write.
+  @param  StripSize     Maximum size of a strip of Blt pixels, in bytes.
+  @param  Compress      TRUE to write an RLE8 .BMP when the screen has no more than
+                        256 colors.  Screens with more colors are written uncompressed.
+
+  @retval EFI_SUCCESS           The screen was written to the file.
+  @retval EFI_UNSUPPORTED       The Gop pixel format is not supported.
+  @retval EFI_OUT_OF_RESOURCES  Not enough memory for the strip buffers.
+  @retval Others                Reading the screen or writing the file failed.
+
+**/
+EFI_STATUS
+WriteGopToBmpFile (
+  IN EFI_GRAPHICS_OUTPUT_PROTOCOL  *Gop,
+  IN EFI_FILE_PROTOCOL             *FileHandle,
+  IN UINTN                         StripSize,
+  IN BOOLEAN                       Compress
+  )
+{
+  EFI_STATUS                     Status;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Strip;
+  COLOR_TABLE                    *Table;
+  UINT32                         Width;
+  UINT32                         Height;
+  UINT32                         RowsPerStrip;
+  UINTN                          Rle8Size;
+  UINTN                          BmpSize;
+  BOOLEAN                        SwapRedBlue;
+
+  if ((Gop->Mode->Info->PixelFormat != PixelRedGreenBlueReserved8BitPerColor) &&
+      (Gop->Mode->Info->PixelFormat != PixelBlueGreenRedReserved8BitPerColor))
+  {
+    DEBUG ((DEBUG_ERROR, "%a: Unsupported video mode\n", __FUNCTION__));
+    return EFI_UNSUPPORTED;
+  }
+
+  Width       = Gop->Mode->Info->HorizontalResolution;
+  Height      = Gop->Mode->Info->VerticalResolution;
+  SwapRedBlue = (BOOLEAN)(Gop->Mode->Info->PixelFormat == PixelRedGreenBlueReserved8BitPerColor);
+
+  if ((Width == 0) || (Height == 0)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  RowsPerStrip = (UINT32)MIN (MAX (StripSize / (Width * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)), 1), Height);
+
+  Strip = AllocatePool ((UINTN)Width * RowsPerStrip * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+  if (NULL == Strip) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  DEBUG ((DEBUG_INFO, "%a: %dx%d in strips of %d rows\n", __FUNCTION__, Width, Height, RowsPerStrip));
+
+  Table = NULL;
+  if (Compress) {
+    Table = AllocateZeroPool (sizeof (COLOR_TABLE));
+    if (NULL == Table) {
+      Status = EFI_OUT_OF_RESOURCES;
+      goto Exit;
+    }
+
+    Rle8Size = 0;
+    Status   = BuildPalette (Gop, Strip, RowsPerStrip, SwapRedBlue, Table);
+    if (!EFI_ERROR (Status)) {
+      Status = WriteRle8Bmp (Gop, FileHandle, Strip, RowsPerStrip, SwapRedBlue, Table, &Rle8Size);
+    }
+
+    if (Status != EFI_UNSUPPORTED) {
+      goto Exit;
+    }
+
+    DEBUG ((DEBUG_INFO, "%a: More than %d colors, writing uncompressed\n", __FUNCTION__, BMP_RLE8_MAX_COLORS));
+
+    //
+    // Start over with the uncompressed format.  On a tiny screen the abandoned
+    // RLE8 image can be longer than the uncompressed one, so cut off what is left.
+    //
+    Status = FileHandle->SetPosition (FileHandle, 0);
+    if (EFI_ERROR (Status)) {
+      goto Exit;
+    }
+
+    Status = WriteUncompressedBmp (Gop, FileHandle, Strip, RowsPerStrip, SwapRedBlue, &BmpSize);
+    if (!EFI_ERROR (Status) && (Rle8Size > BmpSize)) {
+      Status = TruncateFile (FileHandle, BmpSize);
+    }
+
+    goto Exit;
+  }
+
+  Status = WriteUncompressedBmp (Gop, FileHandle, Strip, RowsPerStrip, SwapRedBlue, &BmpSize);
+
+Exit:
+  if (Table != NULL) {
+    FreePool (Table);
+  }
+
+  FreePool (Strip);
+  return Status;
+}
@@ -181,16 +181,16 @@ CleanUp:
 
 /**
   Convert a Gop 32 bits per pixel video frame buffer to a
-  24 bits per pixel *.BMP graphics image
+  *.BMP graphics image
 
-  @param  BmpFileName   Name of file to create
-  @param  Gop           GRAPHICS_OUTPUT_PROTOCOL
-  @param  BltBuffer     Buffer containing GOP version of BmpImage.
+  The screen is read, converted and written in strips of at most PcdPrintScreenStripSize
+  bytes.  When PcdPrintScreenCompression is TRUE, screens with no more than 256 colors
+  are written as RLE8 compressed bitmaps.
 
-  @retval EFI_SUCCESS           GopBlt and GopBltSize are returned.
-  @retval EFI_UNSUPPORTED       BmpImage is not a valid *.BMP image
-  @retval EFI_BUFFER_TOO_SMALL  The passed in GopBlt buffer is not big enough.
-                                GopBltSize will contain the required size.
+  @param  FileHandle    File to write.
+
+  @retval EFI_SUCCESS           The screen was written to the file.
+  @retval EFI_UNSUPPORTED       The Gop pixel format is not supported.
   @retval EFI_OUT_OF_RESOURCES  No enough buffer to allocate.
 
 **/
@@ -199,24 +199,9 @@ WriteBmpToFile (
   IN EFI_FILE_PROTOCOL  *FileHandle
   )
 {
-  EFI_STATUS                     Status;
-  BMP_IMAGE_HEADER               *BmpHeader;
-  UINTN                          DataSizePerLine;
-  UINTN                          BmpBufferSize;
-  UINT8                          *Image;
-  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Blt;
-  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *BltBuffer;
-  UINT32                         Height;
-  UINT32                         Width;
-  UINT64                         WriteSize;
-
+  EFI_STATUS                    Status;
   EFI_GRAPHICS_OUTPUT_PROTOCOL  *Gop;
 
-  #define BMP_BITS_PER_PIXEL  24
-
-  BmpHeader = NULL;
-  BltBuffer = NULL;
-
   Status = gBS->LocateProtocol (
                   &gEfiGraphicsOutputProtocolGuid,
                   NULL,
@@ -227,113 +212,12 @@ WriteBmpToFile (
     return Status;
   }
 
-  if ((Gop->Mode->Info->PixelFormat != PixelRedGreenBlueReserved8BitPerColor) &&
-      (Gop->Mode->Info->PixelFormat != PixelBlueGreenRedReserved8BitPerColor))
-  {
-    DEBUG ((DEBUG_ERROR, "%a: Unsupported video mode\n", __FUNCTION__));
-    return EFI_UNSUPPORTED;
-  }
-
-  BltBuffer = (EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)AllocatePool (Gop->Mode->FrameBufferSize);
-  if (NULL == BltBuffer) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  Height = Gop->Mode->Info->VerticalResolution;
-  Width  = Gop->Mode->Info->HorizontalResolution;
-
-  Status = Gop->Blt (
-                  Gop,
-                  BltBuffer,
-                  EfiBltVideoToBltBuffer,
-                  0,
-                  0,
-                  0,
-                  0,
-                  Width,
-                  Height,
-                  0
-                  );
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "Unable to BLt video to buffer, code=%r\n", Status));
-    goto ErrorExit;
-  }
-
-  DataSizePerLine = ((Gop->Mode->Info->HorizontalResolution * BMP_BITS_PER_PIXEL + 31) >> 3) & (~0x3);
-  BmpBufferSize   = MultU64x32 (DataSizePerLine, Gop->Mode->Info->VerticalResolution) + sizeof (BMP_IMAGE_HEADER) + ((sizeof (BMP_IMAGE_HEADER) + 3) & ~0x03);
-
-  if (BmpBufferSize > (UINT32) ~0) {
-    Status = EFI_INVALID_PARAMETER;
-    goto ErrorExit;
-  }
-
-  BmpHeader = AllocateZeroPool (BmpBufferSize);   // Insure unfilled area is zeroed
-  if (NULL == BmpHeader) {
-    Status = EFI_OUT_OF_RESOURCES;
-    goto ErrorExit;
-  }
-
-  Status = EFI_SUCCESS;
-
-  BmpHeader->CharB           = 'B';   // Header flag
-  BmpHeader->CharM           = 'M';
-  BmpHeader->Size            = (UINT32)BmpBufferSize;
-  BmpHeader->Reserved[0]     = 0;
-  BmpHeader->Reserved[1]     = 0;
-  BmpHeader->ImageOffset     = (sizeof (BMP_IMAGE_HEADER) + 3) & ~0x03; // Start first row on 4 byte boundary
-  BmpHeader->HeaderSize      = sizeof (BMP_IMAGE_HEADER) - OFFSET_OF (BMP_IMAGE_HEADER, HeaderSize);
-  BmpHeader->PixelWidth      = Width;
-  BmpHeader->PixelHeight     = Height;
-  BmpHeader->Planes          = 1;
-  BmpHeader->BitPerPixel     = 24;
-  BmpHeader->CompressionType = 0;     // Not Compressed
-  BmpHeader->ImageSize       = 0;
-  BmpHeader->XPixelsPerMeter = 11000;    // Approximately 300 dpi
-  BmpHeader->YPixelsPerMeter = 11000;
-  BmpHeader->NumberOfColors  = 0;
-  BmpHeader->ImportantColors = 0;
-
-  Image = ((UINT8 *)BmpHeader) + BmpHeader->ImageOffset;
-
-  for (Height = 0; Height < BmpHeader->PixelHeight; Height++) {
-    Blt = &BltBuffer[(BmpHeader->PixelHeight - Height - 1) * BmpHeader->PixelWidth];
-    for (Width = 0; Width < BmpHeader->PixelWidth; Width++, Blt++) {
-      if (Gop->Mode->Info->PixelFormat == PixelRedGreenBlueReserved8BitPerColor) {
-        *Image++ = Blt->Red;
-        *Image++ = Blt->Green;
-        *Image++ = Blt->Blue;
-      } else {
-        // PixelBlueGreenRedReserved8BitPerColor
-        *Image++ = Blt->Blue;
-        *Image++ = Blt->Green;
-        *Image++ = Blt->Red;
-      }
-    }
-
-    Image = (UINT8 *)(((UINT64)Image + 3) & ~0x03);        // Start next row on 4 byte boundary.
-  }
-
-  WriteSize = BmpBufferSize;
-  Status    = FileHandle->Write (FileHandle, &WriteSize, BmpHeader);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR, "Error writing Bmp file. Code=%r\n", Status));
-  }
-
-  if (WriteSize != BmpBufferSize) {
-    DEBUG ((DEBUG_ERROR, "Wrong number of bytes written.  S/B=%ld, Actual=%ld\n", BmpBufferSize, WriteSize));
-    Status = EFI_BAD_BUFFER_SIZE;
-  }
-
-ErrorExit:
-  if (BltBuffer != NULL) {
-    FreePool (BltBuffer);
-  }
-
-  if (BmpHeader != NULL) {
-    FreePool (BmpHeader);
-  }
-
-  return Status;
+  return WriteGopToBmpFile (
+           Gop,
+           FileHandle,
+           PcdGet32 (PcdPrintScreenStripSize),
+           PcdGetBool (PcdPrintScreenCompression)
+           );
 }
 
 /**
@@ -15,6 +15,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <IndustryStandard/Bmp.h>
 
+#include <Guid/FileInfo.h>
+
 #include <Protocol/GraphicsOutput.h>
 #include <Protocol/SimpleFileSystem.h>
 #include <Protocol/SimpleTextInEx.h>
@@ -23,6 +25,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/DebugLib.h>
 #include <Library/DevicePathLib.h>
 #include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
 #include <Library/PrintLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
@@ -40,4 +43,30 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 // 3 seconds in 100ns intervals = 3 * ms in 1 second * us in 1 ms * 100ns in 1us
 #define PRINT_SCREEN_DELAY  (3 * 1000           * 1000       * 10)
 
+/**
+  Convert a Gop 32 bits per pixel video frame buffer to a .BMP file.
+
+  The frame buffer is read and converted in strips of at most StripSize bytes so
+  the memory needed does not grow with the screen resolution.
+
+  @param  Gop           GRAPHICS_OUTPUT_PROTOCOL
+  @param  FileHandle    File to write.
+  @param  StripSize     Maximum size of a strip of Blt pixels, in bytes.
+  @param  Compress      TRUE to write an RLE8 .BMP when the screen has no more than
+                        256 colors.  Screens with more colors are written uncompressed.
+
+  @retval EFI_SUCCESS           The screen was written to the file.
+  @retval EFI_UNSUPPORTED       The Gop pixel format is not supported.
+  @retval EFI_OUT_OF_RESOURCES  Not enough memory for the strip buffers.
+  @retval Others                Reading the screen or writing the file failed.
+
+**/
+EFI_STATUS
+WriteGopToBmpFile (
+  IN EFI_GRAPHICS_OUTPUT_PROTOCOL  *Gop,
+  IN EFI_FILE_PROTOCOL             *FileHandle,
+  IN UINTN                         StripSize,
+  IN BOOLEAN                       Compress
+  );
+
 #endif // __PRINTSCREEN_LOGGER_H__
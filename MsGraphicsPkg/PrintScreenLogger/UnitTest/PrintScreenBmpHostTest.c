@@ -0,0 +1,688 @@
+/** @file
+  Host based unit tests for the PrintScreenLogger strip BMP writer.
+
+  A memory backed mock GOP supplies the frame buffer and a mock file protocol
+  captures the output, which is compared byte for byte with the original
+  whole-screen conversion.  The mocks also record the largest Blt buffer and
+  the largest write, which together are the strip memory the writer needs.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <time.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include "../PrintScreenLogger.h"
+
+#define UNIT_TEST_NAME     "PrintScreenLogger BMP Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define DEFAULT_STRIP_SIZE  0x40000
+
+//
+// Mock GOP state.
+//
+STATIC EFI_GRAPHICS_OUTPUT_MODE_INFORMATION  mModeInfo;
+STATIC EFI_GRAPHICS_OUTPUT_PROTOCOL_MODE     mMode;
+STATIC EFI_GRAPHICS_OUTPUT_PROTOCOL          mGop;
+STATIC EFI_GRAPHICS_OUTPUT_BLT_PIXEL         *mFrameBuffer = NULL;
+STATIC UINTN                                 mBltCalls;
+STATIC UINTN                                 mLargestBlt;
+STATIC UINTN                                 mChangeAfterBltCalls;
+STATIC UINT32                                mChangeColor;
+
+//
+// Mock file state.
+//
+STATIC EFI_FILE_PROTOCOL  mFile;
+STATIC UINT8              *mFileData = NULL;
+STATIC UINTN              mFileSize;
+STATIC UINTN              mFileCapacity;
+STATIC UINTN              mFilePosition;
+STATIC UINTN              mWriteCalls;
+STATIC UINTN              mLargestWrite;
+
+/**
+  Mock EFI_GRAPHICS_OUTPUT_PROTOCOL.Blt.  Only EfiBltVideoToBltBuffer is supported.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockBlt (
+  IN EFI_GRAPHICS_OUTPUT_PROTOCOL       *This,
+  IN EFI_GRAPHICS_OUTPUT_BLT_PIXEL      *BltBuffer,
+  IN EFI_GRAPHICS_OUTPUT_BLT_OPERATION  BltOperation,
+  IN UINTN                              SourceX,
+  IN UINTN                              SourceY,
+  IN UINTN                              DestinationX,
+  IN UINTN                              DestinationY,
+  IN UINTN                              Width,
+  IN UINTN                              Height,
+  IN UINTN                              Delta
+  )
+{
+  UINTN  Row;
+
+  if ((BltOperation != EfiBltVideoToBltBuffer) || (DestinationX != 0) || (DestinationY != 0) || (Delta != 0)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (((SourceX + Width) > mModeInfo.HorizontalResolution) || ((SourceY + Height) > mModeInfo.VerticalResolution)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Row = 0; Row < Height; Row++) {
+    CopyMem (
+      &BltBuffer[Row * Width],
+      &mFrameBuffer[(SourceY + Row) * mModeInfo.HorizontalResolution + SourceX],
+      Width * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)
+      );
+  }
+
+  mBltCalls++;
+  mLargestBlt = MAX (mLargestBlt, Width * Height * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+
+  //
+  // Simulate the screen changing while it is being captured by drawing a new
+  // color in the bottom right corner.
+  //
+  if (mBltCalls == mChangeAfterBltCalls) {
+    mFrameBuffer[mMode.FrameBufferSize / sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL) - 1].Blue  = (UINT8)mChangeColor;
+    mFrameBuffer[mMode.FrameBufferSize / sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL) - 1].Green = (UINT8)(mChangeColor >> 8);
+    mFrameBuffer[mMode.FrameBufferSize / sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL) - 1].Red   = (UINT8)(mChangeColor >> 16);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Mock EFI_FILE_PROTOCOL.Write.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockWrite (
+  IN EFI_FILE_PROTOCOL  *This,
+  IN OUT UINTN          *BufferSize,
+  IN VOID               *Buffer
+  )
+{
+  UINTN  NewCapacity;
+
+  if (mFilePosition + *BufferSize > mFileCapacity) {
+    NewCapacity = MAX (mFileCapacity * 2, mFilePosition + *BufferSize);
+    mFileData   = ReallocatePool (mFileCapacity, NewCapacity, mFileData);
+    if (mFileData == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    mFileCapacity = NewCapacity;
+  }
+
+  CopyMem (mFileData + mFilePosition, Buffer, *BufferSize);
+  mFilePosition += *BufferSize;
+  mFileSize      = MAX (mFileSize, mFilePosition);
+  mWriteCalls++;
+  mLargestWrite = MAX (mLargestWrite, *BufferSize);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Mock EFI_FILE_PROTOCOL.SetPosition.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockSetPosition (
+  IN EFI_FILE_PROTOCOL  *This,
+  IN UINT64             Position
+  )
+{
+  if (Position > mFileSize) {
+    return EFI_UNSUPPORTED;
+  }
+
+  mFilePosition = (UINTN)Position;
+  return EFI_SUCCESS;
+}
+
+/**
+  Mock EFI_FILE_PROTOCOL.GetInfo.  Only EFI_FILE_INFO.FileSize is filled in.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockGetInfo (
+  IN EFI_FILE_PROTOCOL  *This,
+  IN EFI_GUID           *InformationType,
+  IN OUT UINTN          *BufferSize,
+  OUT VOID              *Buffer
+  )
+{
+  if (!CompareGuid (InformationType, &gEfiFileInfoGuid)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (*BufferSize < sizeof (EFI_FILE_INFO)) {
+    *BufferSize = sizeof (EFI_FILE_INFO);
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  ZeroMem (Buffer, sizeof (EFI_FILE_INFO));
+  ((EFI_FILE_INFO *)Buffer)->Size     = sizeof (EFI_FILE_INFO);
+  ((EFI_FILE_INFO *)Buffer)->FileSize = mFileSize;
+  *BufferSize                         = sizeof (EFI_FILE_INFO);
+  return EFI_SUCCESS;
+}
+
+/**
+  Mock EFI_FILE_PROTOCOL.SetInfo.  Only shrinking EFI_FILE_INFO.FileSize is supported.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockSetInfo (
+  IN EFI_FILE_PROTOCOL  *This,
+  IN EFI_GUID           *InformationType,
+  IN UINTN              BufferSize,
+  IN VOID               *Buffer
+  )
+{
+  if (!CompareGuid (InformationType, &gEfiFileInfoGuid) || (((EFI_FILE_INFO *)Buffer)->FileSize > mFileSize)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  mFileSize     = (UINTN)((EFI_FILE_INFO *)Buffer)->FileSize;
+  mFilePosition = MIN (mFilePosition, mFileSize);
+  return EFI_SUCCESS;
+}
+
+/**
+  Reset the mock file and the call counters.
+**/
+STATIC
+VOID
+ResetMockFile (
+  VOID
+  )
+{
+  mFileSize            = 0;
+  mFilePosition        = 0;
+  mWriteCalls          = 0;
+  mLargestWrite        = 0;
+  mBltCalls            = 0;
+  mLargestBlt          = 0;
+  mChangeAfterBltCalls = 0;
+}
+
+/**
+  Set up the mock GOP with a generated screen and reset the mock file.
+
+  @param  Width       Screen width.
+  @param  Height      Screen height.
+  @param  Format      Pixel format.
+  @param  Colors      Number of distinct colors to draw, 0 for a gradient.
+**/
+STATIC
+VOID
+SetupMocks (
+  IN UINT32                     Width,
+  IN UINT32                     Height,
+  IN EFI_GRAPHICS_PIXEL_FORMAT  Format,
+  IN UINT32                     Colors
+  )
+{
+  UINTN   Index;
+  UINT32  Value;
+
+  if (mFrameBuffer != NULL) {
+    FreePool (mFrameBuffer);
+  }
+
+  mFrameBuffer = AllocatePool ((UINTN)Width * Height * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+
+  for (Index = 0; Index < (UINTN)Width * Height; Index++) {
+    if (Colors == 0) {
+      Value = (UINT32)(Index * 2654435761u);
+    } else {
+      // Horizontal bands of solid color, like a typical menu screen.
+      Value = (UINT32)(((Index / Width) / 8) % Colors) * 0x010305;
+    }
+
+    mFrameBuffer[Index].Blue     = (UINT8)Value;
+    mFrameBuffer[Index].Green    = (UINT8)(Value >> 8);
+    mFrameBuffer[Index].Red      = (UINT8)(Value >> 16);
+    mFrameBuffer[Index].Reserved = (UINT8)(Value >> 24);
+  }
+
+  ZeroMem (&mModeInfo, sizeof (mModeInfo));
+  mModeInfo.HorizontalResolution = Width;
+  mModeInfo.VerticalResolution   = Height;
+  mModeInfo.PixelFormat          = Format;
+  mModeInfo.PixelsPerScanLine    = Width;
+
+  ZeroMem (&mMode, sizeof (mMode));
+  mMode.Info            = &mModeInfo;
+  mMode.SizeOfInfo      = sizeof (mModeInfo);
+  mMode.FrameBufferSize = (UINTN)Width * Height * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL);
+
+  ZeroMem (&mGop, sizeof (mGop));
+  mGop.Blt  = MockBlt;
+  mGop.Mode = &mMode;
+
+  ZeroMem (&mFile, sizeof (mFile));
+  mFile.Write       = MockWrite;
+  mFile.SetPosition = MockSetPosition;
+  mFile.GetInfo     = MockGetInfo;
+  mFile.SetInfo     = MockSetInfo;
+
+  ResetMockFile ();
+}
+
+/**
+  The original whole-screen conversion, used as the reference output.
+
+  @param  Size    Receives the size of the returned image.
+
+  @return Pool buffer holding the reference .BMP.
+**/
+STATIC
+UINT8 *
+ReferenceBmp (
+  OUT UINTN  *Size
+  )
+{
+  BMP_IMAGE_HEADER               *BmpHeader;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Blt;
+  UINT8                          *Image;
+  UINT8                          *RowStart;
+  UINTN                          DataSizePerLine;
+  UINTN                          BmpBufferSize;
+  UINT32                         Height;
+  UINT32                         Width;
+
+  DataSizePerLine = ((mModeInfo.HorizontalResolution * 24 + 31) >> 3) & (~0x3);
+  BmpBufferSize   = DataSizePerLine * mModeInfo.VerticalResolution + sizeof (BMP_IMAGE_HEADER) + ((sizeof (BMP_IMAGE_HEADER) + 3) & ~0x03);
+
+  BmpHeader                  = AllocateZeroPool (BmpBufferSize);
+  BmpHeader->CharB           = 'B';
+  BmpHeader->CharM           = 'M';
+  BmpHeader->Size            = (UINT32)BmpBufferSize;
+  BmpHeader->ImageOffset     = (sizeof (BMP_IMAGE_HEADER) + 3) & ~0x03;
+  BmpHeader->HeaderSize      = sizeof (BMP_IMAGE_HEADER) - OFFSET_OF (BMP_IMAGE_HEADER, HeaderSize);
+  BmpHeader->PixelWidth      = mModeInfo.HorizontalResolution;
+  BmpHeader->PixelHeight     = mModeInfo.VerticalResolution;
+  BmpHeader->Planes          = 1;
+  BmpHeader->BitPerPixel     = 24;
+  BmpHeader->XPixelsPerMeter = 11000;
+  BmpHeader->YPixelsPerMeter = 11000;
+
+  RowStart = ((UINT8 *)BmpHeader) + BmpHeader->ImageOffset;
+  for (Height = 0; Height < BmpHeader->PixelHeight; Height++) {
+    Image = RowStart;
+    Blt   = &mFrameBuffer[(BmpHeader->PixelHeight - Height - 1) * BmpHeader->PixelWidth];
+    for (Width = 0; Width < BmpHeader->PixelWidth; Width++, Blt++) {
+      if (mModeInfo.PixelFormat == PixelRedGreenBlueReserved8BitPerColor) {
+        *Image++ = Blt->Red;
+        *Image++ = Blt->Green;
+        *Image++ = Blt->Blue;
+      } else {
+        *Image++ = Blt->Blue;
+        *Image++ = Blt->Green;
+        *Image++ = Blt->Red;
+      }
+    }
+
+    RowStart += DataSizePerLine;
+  }
+
+  *Size = BmpBufferSize;
+  return (UINT8 *)BmpHeader;
+}
+
+/**
+  Decode an RLE8 .BMP produced by the writer and compare it with the frame buffer.
+
+  @retval TRUE    The decoded image matches the frame buffer.
+**/
+STATIC
+BOOLEAN
+Rle8MatchesFrameBuffer (
+  VOID
+  )
+{
+  BMP_IMAGE_HEADER               *BmpHeader;
+  UINT32                         *Palette;
+  UINT8                          *Data;
+  UINT8                          *End;
+  UINT32                         X;
+  UINT32                         Y;
+  UINT32                         Color;
+  UINT32                         Expected;
+  UINT8                          Count;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *Blt;
+
+  BmpHeader = (BMP_IMAGE_HEADER *)mFileData;
+  if ((BmpHeader->CompressionType != 1) || (BmpHeader->BitPerPixel != 8) || (BmpHeader->Size != mFileSize)) {
+    return FALSE;
+  }
+
+  Palette = (UINT32 *)(mFileData + sizeof (BMP_IMAGE_HEADER));
+  Data    = mFileData + BmpHeader->ImageOffset;
+  End     = Data + BmpHeader->ImageSize;
+  X       = 0;
+  Y       = 0;
+
+  while (Data + 2 <= End) {
+    Count = *Data++;
+    if (Count == 0) {
+      if (*Data == 1) {
+        return (BOOLEAN)(Y == BmpHeader->PixelHeight);
+      }
+
+      if ((*Data++ != 0) || (X != BmpHeader->PixelWidth)) {
+        return FALSE;
+      }
+
+      X = 0;
+      Y++;
+      continue;
+    }
+
+    if (*Data >= BmpHeader->NumberOfColors) {
+      return FALSE;
+    }
+
+    Color = Palette[*Data++];
+    while (Count-- > 0) {
+      Blt      = &mFrameBuffer[(BmpHeader->PixelHeight - Y - 1) * BmpHeader->PixelWidth + X];
+      Expected = (mModeInfo.PixelFormat == PixelRedGreenBlueReserved8BitPerColor) ?
+                 (((UINT32)Blt->Blue << 16) | ((UINT32)Blt->Green << 8) | Blt->Red) :
+                 (((UINT32)Blt->Red << 16) | ((UINT32)Blt->Green << 8) | Blt->Blue);
+      if (Color != Expected) {
+        return FALSE;
+      }
+
+      X++;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Uncompressed output is byte identical to the original writer for several
+  resolutions, pixel formats and strip sizes.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+UncompressedMatchesReference (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINT32  Resolutions[][2] = {
+    { 1,    1    },
+    { 5,    3    },
+    { 1023, 17   },
+    { 1366, 768  },
+    { 3840, 2160 }
+  };
+  STATIC CONST UINTN  StripSizes[] = { 1, 4096, DEFAULT_STRIP_SIZE, MAX_UINT32 };
+  UINTN               Res;
+  UINTN               Strip;
+  UINTN               Format;
+  UINT8               *Expected;
+  UINTN               ExpectedSize;
+  UINTN               RowSize;
+  clock_t             Start;
+  clock_t             Ticks;
+
+  for (Res = 0; Res < ARRAY_SIZE (Resolutions); Res++) {
+    for (Format = 0; Format < 2; Format++) {
+      SetupMocks (Resolutions[Res][0], Resolutions[Res][1], (EFI_GRAPHICS_PIXEL_FORMAT)Format, 0);
+      Expected = ReferenceBmp (&ExpectedSize);
+
+      for (Strip = 0; Strip < ARRAY_SIZE (StripSizes); Strip++) {
+        ResetMockFile ();
+
+        Start = clock ();
+        UT_ASSERT_NOT_EFI_ERROR (WriteGopToBmpFile (&mGop, &mFile, StripSizes[Strip], FALSE));
+        Ticks = clock () - Start;
+        UT_ASSERT_EQUAL (mFileSize, ExpectedSize);
+        UT_ASSERT_MEM_EQUAL (mFileData, Expected, ExpectedSize);
+
+        if (StripSizes[Strip] == DEFAULT_STRIP_SIZE) {
+          //
+          // The writer holds one strip of Blt pixels and one strip of converted
+          // rows; a strip is never smaller than one row.
+          //
+          RowSize = ((Resolutions[Res][0] * 24 + 31) >> 3) & ~0x3;
+          UT_ASSERT_TRUE (mLargestBlt <= MAX (DEFAULT_STRIP_SIZE, Resolutions[Res][0] * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)));
+          UT_ASSERT_TRUE (mLargestWrite <= MAX (DEFAULT_STRIP_SIZE, RowSize));
+          UT_LOG_INFO (
+            "%ux%u: %u bytes, %u Blt calls, %u writes, peak strip memory %u bytes (full frame %u bytes), %u MB/s\n",
+            Resolutions[Res][0],
+            Resolutions[Res][1],
+            (UINT32)mFileSize,
+            (UINT32)mBltCalls,
+            (UINT32)mWriteCalls,
+            (UINT32)(mLargestBlt + mLargestWrite),
+            (UINT32)mMode.FrameBufferSize,
+            (UINT32)((Ticks == 0) ? 0 : ((UINT64)mMode.FrameBufferSize * CLOCKS_PER_SEC / Ticks / 1000000))
+            );
+        }
+      }
+
+      FreePool (Expected);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  RLE8 output decodes back to the frame buffer when the screen has few colors.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+CompressedDecodesToFrameBuffer (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Format;
+  UINTN  Colors;
+
+  for (Format = 0; Format < 2; Format++) {
+    for (Colors = 1; Colors <= 256; Colors *= 4) {
+      SetupMocks (1366, 768, (EFI_GRAPHICS_PIXEL_FORMAT)Format, (UINT32)Colors);
+      UT_ASSERT_NOT_EFI_ERROR (WriteGopToBmpFile (&mGop, &mFile, 4096, TRUE));
+      UT_ASSERT_TRUE (Rle8MatchesFrameBuffer ());
+      UT_ASSERT_TRUE (mFileSize < mMode.FrameBufferSize / 4);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Screens with more than 256 colors fall back to the uncompressed format.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+CompressedFallsBackForManyColors (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT8  *Expected;
+  UINTN  ExpectedSize;
+
+  SetupMocks (800, 600, PixelBlueGreenRedReserved8BitPerColor, 0);
+  Expected = ReferenceBmp (&ExpectedSize);
+
+  UT_ASSERT_NOT_EFI_ERROR (WriteGopToBmpFile (&mGop, &mFile, DEFAULT_STRIP_SIZE, TRUE));
+  UT_ASSERT_EQUAL (mFileSize, ExpectedSize);
+  UT_ASSERT_MEM_EQUAL (mFileData, Expected, ExpectedSize);
+
+  FreePool (Expected);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A color drawn after the palette was built is added to the palette, and a
+  screen that gains a color beyond the palette limit during the capture is
+  written uncompressed instead of drawing the new color with the wrong entry.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+CompressedHandlesScreenChange (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINT32  Resolutions[][2] = {
+    { 16,  16  },
+    { 800, 600 }
+  };
+  UINTN                Res;
+  UINTN                Index;
+  UINT8                *Expected;
+  UINTN                ExpectedSize;
+
+  for (Res = 0; Res < ARRAY_SIZE (Resolutions); Res++) {
+    //
+    // One strip per row, so the palette pass takes one Blt per row and the
+    // change lands before the first strip is encoded.
+    //
+    SetupMocks (Resolutions[Res][0], Resolutions[Res][1], PixelBlueGreenRedReserved8BitPerColor, 4);
+    mChangeAfterBltCalls = Resolutions[Res][1];
+    mChangeColor         = 0xABCDEF;
+    UT_ASSERT_NOT_EFI_ERROR (WriteGopToBmpFile (&mGop, &mFile, 1, TRUE));
+    UT_ASSERT_TRUE (Rle8MatchesFrameBuffer ());
+
+    //
+    // A full palette cannot take the new color.  The 16x16 screen also checks
+    // that the longer, abandoned RLE8 image is cut off.
+    //
+    SetupMocks (Resolutions[Res][0], Resolutions[Res][1], PixelBlueGreenRedReserved8BitPerColor, 4);
+    for (Index = 0; Index < 256; Index++) {
+      mFrameBuffer[Index].Blue  = (UINT8)(Index * 0x010305);
+      mFrameBuffer[Index].Green = (UINT8)((Index * 0x010305) >> 8);
+      mFrameBuffer[Index].Red   = (UINT8)((Index * 0x010305) >> 16);
+    }
+
+    mChangeAfterBltCalls = Resolutions[Res][1];
+    mChangeColor         = 0xABCDEF;
+    UT_ASSERT_NOT_EFI_ERROR (WriteGopToBmpFile (&mGop, &mFile, 1, TRUE));
+    Expected = ReferenceBmp (&ExpectedSize);
+    UT_ASSERT_EQUAL (mFileSize, ExpectedSize);
+    UT_ASSERT_MEM_EQUAL (mFileData, Expected, ExpectedSize);
+    FreePool (Expected);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Unsupported pixel formats are rejected.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+UnsupportedFormatRejected (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SetupMocks (16, 16, PixelBitMask, 0);
+  UT_ASSERT_STATUS_EQUAL (WriteGopToBmpFile (&mGop, &mFile, DEFAULT_STRIP_SIZE, FALSE), EFI_UNSUPPORTED);
+  UT_ASSERT_EQUAL (mWriteCalls, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  PrintScreenLogger BMP writer and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      BmpSuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&BmpSuiteHandle, Framework, "PrintScreenLogger BMP writer tests", "PrintScreenLogger.Bmp", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for BmpSuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (BmpSuiteHandle, "Uncompressed output matches the original writer", "Uncompressed", UncompressedMatchesReference, NULL, NULL, NULL);
+  AddTestCase (BmpSuiteHandle, "RLE8 output decodes to the frame buffer", "Rle8", CompressedDecodesToFrameBuffer, NULL, NULL, NULL);
+  AddTestCase (BmpSuiteHandle, "RLE8 falls back to uncompressed for many colors", "Rle8Fallback", CompressedFallsBackForManyColors, NULL, NULL, NULL);
+  AddTestCase (BmpSuiteHandle, "RLE8 handles a screen that changes during the capture", "Rle8ScreenChange", CompressedHandlesScreenChange, NULL, NULL, NULL);
+  AddTestCase (BmpSuiteHandle, "Unsupported pixel format is rejected", "UnsupportedFormat", UnsupportedFormatRejected, NULL, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  if (mFrameBuffer != NULL) {
+    FreePool (mFrameBuffer);
+  }
+
+  if (mFileData != NULL) {
+    FreePool (mFileData);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
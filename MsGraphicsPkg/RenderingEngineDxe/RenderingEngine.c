@@ -12,7 +12,6 @@ Copyright (C) Microsoft Corporation. All rights reserved.
 // ****** Preprocessor constants ******
 //
 #define SURFACE_FRAME_SAMPLE_REFRESH_INTERVAL  (200 * 10 * 1000)            // Sample surface frames: 200ms in 100ns units
-#define SURFACE_FRAME_SAMPLE_PIXEL_SPACING     50                           // Pixel spacing when checking whether the surface frame has been changed.
 
 // ****** Global variables ******
 //
@@ -50,9 +49,9 @@ SREShowMousePointer (
   );
 
 static
-UINT32
-CalculateSurfaceFrameChecksum (
-  IN  SRE_SURFACE_LIST  *Surface
+VOID
+MarkSurfaceFramesDirty (
+  IN  SWM_RECT  *Rect
   );
 
 VOID
@@ -95,6 +94,7 @@ DrawMousePointer (
 {
   EFI_STATUS  Status = EFI_SUCCESS;
   UINTN       Index;
+  SWM_RECT    PointerRect;
 
   // Restore the location where the mouse pointer currently resides with the original screen content.
   //
@@ -111,6 +111,12 @@ DrawMousePointer (
                   mSRE.MousePointerHeight,
                   0
                   );
+
+    PointerRect.Left   = (UINT32)(mSRE.MousePointerOrigX);
+    PointerRect.Top    = (UINT32)(mSRE.MousePointerOrigY);
+    PointerRect.Right  = (UINT32)(mSRE.MousePointerOrigX + mSRE.MousePointerWidth  - 1);
+    PointerRect.Bottom = (UINT32)(mSRE.MousePointerOrigY + mSRE.MousePointerHeight - 1);
+    MarkSurfaceFramesDirty (&PointerRect);
   }
 
   // If we don't need to show the mouse pointer, we're done.
@@ -176,6 +182,12 @@ DrawMousePointer (
                 0
                 );
 
+  PointerRect.Left   = (UINT32)(NewOrigX);
+  PointerRect.Top    = (UINT32)(NewOrigY);
+  PointerRect.Right  = (UINT32)(NewOrigX + mSRE.MousePointerWidth  - 1);
+  PointerRect.Bottom = (UINT32)(NewOrigY + mSRE.MousePointerHeight - 1);
+  MarkSurfaceFramesDirty (&PointerRect);
+
 Exit:
 
   return Status;
@@ -229,6 +241,8 @@ SREBlt (
   SRE_SURFACE_LIST  *Surface;
   SWM_RECT          BltRect;
   SWM_RECT          PointerRect;
+  SWM_RECT          TileRect;
+  UINT32            TileIndex;
   UINT32            FrameWidth, FrameHeight;
   BOOLEAN           MousePointerState = mSRE.ShowingMousePointer;
 
@@ -259,14 +273,15 @@ SREBlt (
       );
   }
 
-  // First see if the blit intersects with one of the active surfaces.  If it does, restore surface back buffer contents first.  We ignore
-  // a surface if the blitting flag is set so that drawing to a surface doesn't trigger a self-refresh.
+  // First see if the blit intersects with one of the active surfaces, or whether the frame sampler found tiles that were changed
+  // behind our back.  If so, restore surface back buffer contents first.  We ignore a surface if the blitting flag is set so that
+  // drawing to a surface doesn't trigger a self-refresh.
   //
   Surface = mSRE.Surfaces;
   while ((NULL != Surface) && (EfiBltVideoToBltBuffer != BltOperation)) {
     if ((TRUE  == Surface->Active) &&
         (FALSE == Surface->BlittingSurface) &&
-        ((TRUE  == RectsOverlap (Surface->FrameRect, BltRect)) || (Surface->FrameChecksum != CalculateSurfaceFrameChecksum (Surface))))
+        ((TRUE  == RectsOverlap (Surface->FrameRect, BltRect)) || (0 != Surface->FrameTiles.ChangedCount)))
     {
       FrameWidth  = (Surface->FrameRect.Right - Surface->FrameRect.Left + 1);
       FrameHeight = (Surface->FrameRect.Bottom - Surface->FrameRect.Top + 1);
@@ -284,24 +299,45 @@ SREBlt (
           );
       }
 
-      // Restore the contents to the framebuffer.
-      //
-      mParentGop->Blt (
-                    mParentGop,
-                    Surface->pCaptureBuffer,
-                    EfiBltBufferToVideo,
-                    0,
-                    0,
-                    Surface->FrameRect.Left,
-                    Surface->FrameRect.Top,
-                    FrameWidth,
-                    FrameHeight,
-                    0
-                    );
-
-      // Re-calculate the surface frame checksum.
-      //
-      Surface->FrameChecksum = CalculateSurfaceFrameChecksum (Surface);
+      if (TRUE == RectsOverlap (Surface->FrameRect, BltRect)) {
+        // Restore the contents to the framebuffer.
+        //
+        mParentGop->Blt (
+                      mParentGop,
+                      Surface->pCaptureBuffer,
+                      EfiBltBufferToVideo,
+                      0,
+                      0,
+                      Surface->FrameRect.Left,
+                      Surface->FrameRect.Top,
+                      FrameWidth,
+                      FrameHeight,
+                      0
+                      );
+
+        MarkSurfaceFramesDirty (&Surface->FrameRect);
+      } else {
+        // Only restore the tiles that were changed.
+        //
+        for (TileIndex = 0; !EFI_ERROR (TileChecksumGetNextChangedTile (&Surface->FrameTiles, &TileIndex, &TileRect)); TileIndex++) {
+          mParentGop->Blt (
+                        mParentGop,
+                        Surface->pCaptureBuffer,
+                        EfiBltBufferToVideo,
+                        TileRect.Left - Surface->FrameRect.Left,
+                        TileRect.Top - Surface->FrameRect.Top,
+                        TileRect.Left,
+                        TileRect.Top,
+                        TileRect.Right - TileRect.Left + 1,
+                        TileRect.Bottom - TileRect.Top + 1,
+                        FrameWidth * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL)
+                        );
+
+          MarkSurfaceFramesDirty (&TileRect);
+        }
+      }
+
+      TileChecksumClearChanged (&Surface->FrameTiles);
     }
 
     Surface = Surface->pNext;
@@ -353,9 +389,9 @@ SREBlt (
                       );
       }
 
-      // Re-calculate the surface frame checksum.
+      // The blit rectangle now holds new content; rehash those tiles on the next sample.
       //
-      Surface->FrameChecksum = CalculateSurfaceFrameChecksum (Surface);
+      TileChecksumMarkDirty (&Surface->FrameTiles, &BltRect);
     }
 
     Surface = Surface->pNext;
@@ -612,46 +648,29 @@ CheckForPendingPaintRequest (
   }
 }
 
+/**
+    Marks the surface frame tiles overlapping a rectangle as dirty for every active surface.
+    Used when the SRE itself writes to the framebuffer so those tiles aren't reported as changed.
+
+    @param[in] Rect                 Rectangle written to the framebuffer (screen coordinates).
+
+**/
 static
-UINT32
-CalculateSurfaceFrameChecksum (
-  IN  SRE_SURFACE_LIST  *Surface
+VOID
+MarkSurfaceFramesDirty (
+  IN  SWM_RECT  *Rect
   )
 {
-  UINT32                         Width  = (Surface->FrameRect.Right - Surface->FrameRect.Left + 1);
-  UINT32                         Height = (Surface->FrameRect.Bottom - Surface->FrameRect.Top + 1);
-  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *SurfaceOrigin;
-  UINT32                         Offset;
-  UINT32                         Checksum = 0;
-
-  // Sample top edge.
-  //
-  SurfaceOrigin = ((EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)mParentGop->Mode->FrameBufferBase + (Surface->FrameRect.Top * mParentGop->Mode->Info->PixelsPerScanLine) + Surface->FrameRect.Left);
-  for (Offset = 0; Offset < Width; Offset += SURFACE_FRAME_SAMPLE_PIXEL_SPACING) {
-    Checksum += *(UINT32 *)(SurfaceOrigin + Offset);
-  }
-
-  // Sample left and right edges and midpoint bisecting line.
-  //
-  for (Offset = 0; Offset < Height; Offset += SURFACE_FRAME_SAMPLE_PIXEL_SPACING) {
-    // Left edge.
-    Checksum += *(UINT32 *)(SurfaceOrigin + (Offset * mParentGop->Mode->Info->PixelsPerScanLine));
-
-    // Midpoint bisecting line.
-    Checksum += *(UINT32 *)(SurfaceOrigin + (Offset * mParentGop->Mode->Info->PixelsPerScanLine) + ((Width - 1) /2));
+  SRE_SURFACE_LIST  *Surface;
 
-    // Right edge.
-    Checksum += *(UINT32 *)(SurfaceOrigin + (Offset * mParentGop->Mode->Info->PixelsPerScanLine) + (Width - 1));
-  }
+  Surface = mSRE.Surfaces;
+  while (NULL != Surface) {
+    if (TRUE == Surface->Active) {
+      TileChecksumMarkDirty (&Surface->FrameTiles, Rect);
+    }
 
-  // Sample bottom edge.
-  //
-  SurfaceOrigin = ((EFI_GRAPHICS_OUTPUT_BLT_PIXEL *)mParentGop->Mode->FrameBufferBase + ((Surface->FrameRect.Bottom - 1) * mParentGop->Mode->Info->PixelsPerScanLine) + Surface->FrameRect.Left);
-  for (Offset = 0; Offset < Width; Offset += SURFACE_FRAME_SAMPLE_PIXEL_SPACING) {
-    Checksum += *(UINT32 *)(SurfaceOrigin + Offset);
+    Surface = Surface->pNext;
   }
-
-  return Checksum;
 }
 
 VOID
@@ -667,11 +686,12 @@ SampleSurfaceFrameTimerCallback (
   //
   EFI_TPL  PreviousTPL = gBS->RaiseTPL (TPL_NOTIFY);
 
-  // Check whether any active surface's frame has been altered.
+  // Check whether any active surface's frame has been altered.  An idle frame costs at
+  // most the fixed tile budget per sample.
   //
   Surface = mSRE.Surfaces;
   while (NULL != Surface) {
-    if ((TRUE == Surface->Active) && (Surface->FrameChecksum != CalculateSurfaceFrameChecksum (Surface))) {
+    if ((TRUE == Surface->Active) && (0 != TileChecksumSample (&Surface->FrameTiles, mParentGop, TileChecksumVerifyBudget (&Surface->FrameTiles)))) {
       Surface->PaintNotify = TRUE;
     }
 
@@ -753,6 +773,17 @@ SRECreateSurface (
     goto Exit;
   }
 
+  // Allocate the surface frame tile checksums.
+  //
+  Status = TileChecksumInit (&pTemp->FrameTiles, &FrameRect);
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "ERROR [SRE]: Failed to allocate surface frame tile checksums (%r).\r\n", Status));
+    FreePool (pTemp->pCaptureBuffer);
+    FreePool (pTemp);
+    goto Exit;
+  }
+
   // Create a custom paint event for this client with EVT_NOTIFY_WAIT so we're called with the client's
   // context whenever the client waits on it.
   //
@@ -766,6 +797,7 @@ SRECreateSurface (
 
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "ERROR [SRE]: Failed to create event for notifying client of a surface paint request (%r).\r\n", Status));
+    TileChecksumFree (&pTemp->FrameTiles);
     FreePool (pTemp->pCaptureBuffer);
     FreePool (pTemp);
     goto Exit;
@@ -804,10 +836,12 @@ SREResizeSurface (
   IN  SWM_RECT                      *FrameRect
   )
 {
-  EFI_STATUS        Status = EFI_SUCCESS;
-  SRE_SURFACE_LIST  *Surface;
-  UINT32            Width, Height;
-  BOOLEAN           MousePointerState = mSRE.ShowingMousePointer;
+  EFI_STATUS                     Status = EFI_SUCCESS;
+  SRE_SURFACE_LIST               *Surface;
+  UINT32                         Width, Height;
+  SRE_TILE_CHECKSUM              FrameTiles;
+  EFI_GRAPHICS_OUTPUT_BLT_PIXEL  *pCaptureBuffer;
+  BOOLEAN                        MousePointerState = mSRE.ShowingMousePointer;
 
   DEBUG ((DEBUG_INFO, "INFO [SRE]: Resizing surface (ImageHandle=0x%x).\r\n", (UINTN)ImageHandle));
 
@@ -829,6 +863,25 @@ SREResizeSurface (
   Surface = mSRE.Surfaces;
   while (NULL != Surface) {
     if (Surface->ImageHandle == ImageHandle) {
+      // Tile the new frame (all tiles start out dirty) and allocate storage for the new backing
+      // buffer before giving up the old ones, so a failure leaves the surface as it was.
+      //
+      Status = TileChecksumInit (&FrameTiles, FrameRect);
+      if (EFI_ERROR (Status)) {
+        break;
+      }
+
+      Width          = (FrameRect->Right - FrameRect->Left + 1);
+      Height         = (FrameRect->Bottom - FrameRect->Top + 1);
+      pCaptureBuffer = AllocatePool (Width * Height * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
+
+      ASSERT (NULL != pCaptureBuffer);
+      if (NULL == pCaptureBuffer) {
+        TileChecksumFree (&FrameTiles);
+        Status = EFI_OUT_OF_RESOURCES;
+        break;
+      }
+
       // Check whether a framebuffer already exists.  If so, free it.
       //
       if (NULL != Surface->pCaptureBuffer) {
@@ -858,21 +911,14 @@ SREResizeSurface (
         Surface->pCaptureBuffer = NULL;
       }
 
-      // Capture the new frame rectangle.
+      // Capture the new frame rectangle, tiles and backing buffer.
       //
       CopyMem (&Surface->FrameRect, FrameRect, sizeof (SWM_RECT));
-
-      // Allocate storage for the backing buffer.
-      //
+      TileChecksumFree (&Surface->FrameTiles);
+      CopyMem (&Surface->FrameTiles, &FrameTiles, sizeof (SRE_TILE_CHECKSUM));
+      Surface->pCaptureBuffer = pCaptureBuffer;
       Width                   = (FrameRect->Right - FrameRect->Left + 1);
       Height                  = (FrameRect->Bottom - FrameRect->Top + 1);
-      Surface->pCaptureBuffer = AllocatePool (Width * Height * sizeof (EFI_GRAPHICS_OUTPUT_BLT_PIXEL));
-
-      ASSERT (NULL != Surface->pCaptureBuffer);
-      if (NULL == Surface->pCaptureBuffer) {
-        Status = EFI_OUT_OF_RESOURCES;
-        break;
-      }
 
       // If the surface is active, capture screen contents to the new buffer.
       //
@@ -891,10 +937,6 @@ SREResizeSurface (
                       Height,
                       0
                       );
-
-        // Compute the surface frame checksum.
-        //
-        Surface->FrameChecksum = CalculateSurfaceFrameChecksum (Surface);
       }
     }
 
@@ -1029,9 +1071,10 @@ SREActivateSurface (
         }
       }
 
-      // Compute the surface frame checksum.
+      // Rehash the whole surface frame on the next sample.
       //
-      Surface->FrameChecksum = CalculateSurfaceFrameChecksum (Surface);
+      TileChecksumMarkDirty (&Surface->FrameTiles, &Surface->FrameRect);
+      TileChecksumClearChanged (&Surface->FrameTiles);
 
       Status = EFI_SUCCESS;
       break;
@@ -1089,6 +1132,8 @@ SREDeleteSurface (
         Surface->pCaptureBuffer = NULL;
       }
 
+      TileChecksumFree (&Surface->FrameTiles);
+
       // Unlink the current client node and free it.
       //
       if (NULL == Surface->pPrev) {
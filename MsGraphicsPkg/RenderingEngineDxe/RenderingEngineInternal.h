@@ -24,6 +24,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Protocol/RenderingEngine.h>
 #include <Protocol/SimpleWindowManager.h>
 
+#include "SurfaceTileChecksum.h"
+
 // ****** Preprocessor constants ******
 //
 
@@ -97,7 +99,7 @@ typedef struct _SRE_SURFACE_LIST_tag {
   BOOLEAN                          PaintNotify;             // TRUE == client needs to be notified to paint their surface.
   BOOLEAN                          BlittingSurface;         // TRUE == currently blitting this surface.
   SWM_RECT                         FrameRect;               // Clients on-screen window frame rectangle (used for hit detection).
-  UINT32                           FrameChecksum;           // Simple checksum from a sampling of surface frame pixels (used to detect surface changes from someone accessing the framebuffer directly).
+  SRE_TILE_CHECKSUM                FrameTiles;              // Per-tile surface frame checksums (used to detect surface changes from someone accessing the framebuffer directly).
   EFI_GRAPHICS_OUTPUT_BLT_PIXEL    *pCaptureBuffer;         // Buffer for capturing screen contents underlying the client's window area.
   EFI_HANDLE                       ImageHandle;             // Image handle associated with the surface context.
   struct _SRE_SURFACE_LIST_tag     *PreviousActive;         // Previous ACTIVE Surface
@@ -0,0 +1,392 @@
+/** @file
+
+  Tiled surface frame checksums used by the Simple Rendering Engine (SRE).
+
+  NOTE: These routines don't synchronize access to the tile state.  Callers are expected
+        to raise the TPL around them.
+
+Copyright (C) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+#include "SurfaceTileChecksum.h"
+
+// Multiplicative constants for the tile hash (64-bit golden ratio based primes).
+//
+#define TILE_HASH_PRIME_1  0x9E3779B185EBCA87ULL
+#define TILE_HASH_PRIME_2  0xC2B2AE3D27D4EB4FULL
+#define TILE_HASH_PRIME_3  0x165667B19E3779F9ULL
+
+/**
+    Mixes one 64-bit word into the running tile hash.
+
+    @param[in] Hash                 Running hash.
+    @param[in] Word                 Word to mix in.
+
+    @retval Updated hash.
+
+**/
+STATIC
+UINT64
+TileHashRound (
+  IN UINT64  Hash,
+  IN UINT64  Word
+  )
+{
+  Hash += Word * TILE_HASH_PRIME_2;
+  Hash  = LRotU64 (Hash, 31);
+  return Hash * TILE_HASH_PRIME_1;
+}
+
+/**
+    Computes the screen rectangle covered by a tile, clipped to the surface frame.
+
+    @param[in]  Tiles               Tiled checksum state.
+    @param[in]  TileIndex           Index of the tile.
+    @param[out] TileRect            Screen rectangle covered by the tile.
+
+**/
+STATIC
+VOID
+GetTileRect (
+  IN  SRE_TILE_CHECKSUM  *Tiles,
+  IN  UINT32             TileIndex,
+  OUT SWM_RECT           *TileRect
+  )
+{
+  TileRect->Left   = Tiles->FrameRect.Left + ((TileIndex % Tiles->TilesX) * SRE_TILE_SIZE);
+  TileRect->Top    = Tiles->FrameRect.Top  + ((TileIndex / Tiles->TilesX) * SRE_TILE_SIZE);
+  TileRect->Right  = MIN (TileRect->Left + SRE_TILE_SIZE - 1, Tiles->FrameRect.Right);
+  TileRect->Bottom = MIN (TileRect->Top  + SRE_TILE_SIZE - 1, Tiles->FrameRect.Bottom);
+}
+
+/**
+    Hashes the framebuffer contents of a tile.
+
+    Pixels are consumed in pairs as 64-bit words so each row of a full tile takes
+    SRE_TILE_SIZE / 2 rounds.
+
+    @param[in] Tiles                Tiled checksum state.
+    @param[in] Gop                  Graphics output protocol that owns the framebuffer.
+    @param[in] TileIndex            Index of the tile to hash.
+
+    @retval 64-bit hash of the tile contents.
+
+**/
+STATIC
+UINT64
+HashTile (
+  IN SRE_TILE_CHECKSUM             *Tiles,
+  IN EFI_GRAPHICS_OUTPUT_PROTOCOL  *Gop,
+  IN UINT32                        TileIndex
+  )
+{
+  SWM_RECT  TileRect;
+  UINT32    *Row;
+  UINT32    Width;
+  UINT32    Height;
+  UINT32    X;
+  UINT32    Y;
+  UINT64    Hash;
+
+  GetTileRect (Tiles, TileIndex, &TileRect);
+
+  Width  = TileRect.Right - TileRect.Left + 1;
+  Height = TileRect.Bottom - TileRect.Top + 1;
+  Row    = (UINT32 *)(UINTN)Gop->Mode->FrameBufferBase + ((UINTN)TileRect.Top * Gop->Mode->Info->PixelsPerScanLine) + TileRect.Left;
+  Hash   = TILE_HASH_PRIME_3 + TileIndex;
+
+  for (Y = 0; Y < Height; Y++) {
+    for (X = 0; (X + 1) < Width; X += 2) {
+      Hash = TileHashRound (Hash, (UINT64)Row[X] | LShiftU64 (Row[X + 1], 32));
+    }
+
+    if (X < Width) {
+      Hash = TileHashRound (Hash, Row[X]);
+    }
+
+    Row += Gop->Mode->Info->PixelsPerScanLine;
+  }
+
+  Tiles->Stats.PixelsRead += (UINTN)Width * Height;
+
+  // Final avalanche so single bit differences spread across the whole hash.
+  //
+  Hash ^= RShiftU64 (Hash, 33);
+  Hash *= TILE_HASH_PRIME_2;
+  Hash ^= RShiftU64 (Hash, 29);
+
+  return Hash;
+}
+
+/**
+    Initializes the tiled checksum state for a surface frame.  All tiles start out dirty
+    so the first sample establishes the baseline.
+
+    @param[out] Tiles               Tiled checksum state to initialize.
+    @param[in]  FrameRect           Surface frame rectangle (screen coordinates).
+
+    @retval EFI_SUCCESS             The state was initialized.
+    @retval EFI_INVALID_PARAMETER   The frame rectangle is empty.
+    @retval EFI_OUT_OF_RESOURCES    Failed to allocate the tile arrays.
+
+**/
+EFI_STATUS
+TileChecksumInit (
+  OUT SRE_TILE_CHECKSUM  *Tiles,
+  IN  SWM_RECT           *FrameRect
+  )
+{
+  ZeroMem (Tiles, sizeof (SRE_TILE_CHECKSUM));
+
+  if ((FrameRect->Right < FrameRect->Left) || (FrameRect->Bottom < FrameRect->Top)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  CopyMem (&Tiles->FrameRect, FrameRect, sizeof (SWM_RECT));
+
+  Tiles->TilesX    = ((FrameRect->Right - FrameRect->Left) / SRE_TILE_SIZE) + 1;
+  Tiles->TilesY    = ((FrameRect->Bottom - FrameRect->Top) / SRE_TILE_SIZE) + 1;
+  Tiles->TileCount = Tiles->TilesX * Tiles->TilesY;
+
+  Tiles->TileHash  = AllocateZeroPool (Tiles->TileCount * sizeof (UINT64));
+  Tiles->TileFlags = AllocatePool (Tiles->TileCount * sizeof (UINT8));
+
+  if ((NULL == Tiles->TileHash) || (NULL == Tiles->TileFlags)) {
+    TileChecksumFree (Tiles);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  SetMem (Tiles->TileFlags, Tiles->TileCount, SRE_TILE_DIRTY);
+  Tiles->DirtyCount = Tiles->TileCount;
+
+  return EFI_SUCCESS;
+}
+
+/**
+    Frees the tile arrays owned by the tiled checksum state.
+
+    @param[in] Tiles                Tiled checksum state to free.
+
+**/
+VOID
+TileChecksumFree (
+  IN SRE_TILE_CHECKSUM  *Tiles
+  )
+{
+  if (NULL != Tiles->TileHash) {
+    FreePool (Tiles->TileHash);
+  }
+
+  if (NULL != Tiles->TileFlags) {
+    FreePool (Tiles->TileFlags);
+  }
+
+  ZeroMem (Tiles, sizeof (SRE_TILE_CHECKSUM));
+}
+
+/**
+    Marks every tile overlapping the specified rectangle as dirty.
+
+    @param[in] Tiles                Tiled checksum state.
+    @param[in] Rect                 Rectangle written through the SRE (screen coordinates).
+
+**/
+VOID
+TileChecksumMarkDirty (
+  IN SRE_TILE_CHECKSUM  *Tiles,
+  IN SWM_RECT           *Rect
+  )
+{
+  UINT32  FirstX;
+  UINT32  LastX;
+  UINT32  FirstY;
+  UINT32  LastY;
+  UINT32  X;
+  UINT32  Y;
+  UINT8   *Flags;
+
+  if ((0 == Tiles->TileCount) ||
+      (Rect->Right < Rect->Left) || (Rect->Bottom < Rect->Top) ||
+      (Rect->Right < Tiles->FrameRect.Left) || (Rect->Left > Tiles->FrameRect.Right) ||
+      (Rect->Bottom < Tiles->FrameRect.Top) || (Rect->Top > Tiles->FrameRect.Bottom))
+  {
+    return;
+  }
+
+  // Clip the rectangle to the surface frame and convert it to tile coordinates.
+  //
+  FirstX = (MAX (Rect->Left, Tiles->FrameRect.Left) - Tiles->FrameRect.Left) / SRE_TILE_SIZE;
+  LastX  = (MIN (Rect->Right, Tiles->FrameRect.Right) - Tiles->FrameRect.Left) / SRE_TILE_SIZE;
+  FirstY = (MAX (Rect->Top, Tiles->FrameRect.Top) - Tiles->FrameRect.Top) / SRE_TILE_SIZE;
+  LastY  = (MIN (Rect->Bottom, Tiles->FrameRect.Bottom) - Tiles->FrameRect.Top) / SRE_TILE_SIZE;
+
+  for (Y = FirstY; Y <= LastY; Y++) {
+    Flags = &Tiles->TileFlags[Y * Tiles->TilesX];
+    for (X = FirstX; X <= LastX; X++) {
+      if (0 == (Flags[X] & SRE_TILE_DIRTY)) {
+        Flags[X] |= SRE_TILE_DIRTY;
+        Tiles->DirtyCount++;
+      }
+    }
+  }
+}
+
+/**
+    Returns the number of clean tiles to verify per sample.  A frame small enough is swept
+    within SRE_TILE_VERIFY_SWEEP_SAMPLES samples; a larger frame is capped at
+    SRE_TILE_VERIFY_BUDGET tiles, so an idle frame never costs more than that per sample.
+
+    @param[in] Tiles                Tiled checksum state.
+
+    @retval Clean tiles to verify per sample (0 if the frame has no tiles).
+
+**/
+UINT32
+TileChecksumVerifyBudget (
+  IN SRE_TILE_CHECKSUM  *Tiles
+  )
+{
+  return MIN (
+           SRE_TILE_VERIFY_BUDGET,
+           (Tiles->TileCount + SRE_TILE_VERIFY_SWEEP_SAMPLES - 1) / SRE_TILE_VERIFY_SWEEP_SAMPLES
+           );
+}
+
+/**
+    Rehashes all dirty tiles and verifies up to MaxVerify clean tiles against their baseline.
+    Clean tiles that no longer match are flagged as changed and take the new contents as their
+    baseline so that the same change is only reported once.
+
+    @param[in] Tiles                Tiled checksum state.
+    @param[in] Gop                  Graphics output protocol that owns the framebuffer.
+    @param[in] MaxVerify            Maximum number of clean tiles to verify (0 == all of them).
+
+    @retval Number of tiles newly flagged as changed.
+
+**/
+UINT32
+TileChecksumSample (
+  IN SRE_TILE_CHECKSUM             *Tiles,
+  IN EFI_GRAPHICS_OUTPUT_PROTOCOL  *Gop,
+  IN UINT32                        MaxVerify
+  )
+{
+  UINT32  Index;
+  UINT32  Visited;
+  UINT32  Verified;
+  UINT32  Changed;
+  UINT64  Hash;
+
+  Tiles->Stats.Samples++;
+  Changed = 0;
+
+  if (0 == Tiles->TileCount) {
+    return 0;
+  }
+
+  // Establish a new baseline for every tile written through the SRE since the last sample.
+  //
+  for (Index = 0; (Index < Tiles->TileCount) && (Tiles->DirtyCount > 0); Index++) {
+    if (0 != (Tiles->TileFlags[Index] & SRE_TILE_DIRTY)) {
+      Tiles->TileHash[Index]   = HashTile (Tiles, Gop, Index);
+      Tiles->TileFlags[Index] &= (UINT8)~SRE_TILE_DIRTY;
+      Tiles->DirtyCount--;
+      Tiles->Stats.TilesRehashed++;
+    }
+  }
+
+  if ((0 == MaxVerify) || (MaxVerify > Tiles->TileCount)) {
+    MaxVerify = Tiles->TileCount;
+  }
+
+  // Verify a window of clean tiles, picking up where the previous sample left off.
+  //
+  Verified = 0;
+  for (Visited = 0; (Visited < Tiles->TileCount) && (Verified < MaxVerify); Visited++) {
+    Index               = Tiles->VerifyCursor;
+    Tiles->VerifyCursor = (Tiles->VerifyCursor + 1) % Tiles->TileCount;
+
+    if (0 != (Tiles->TileFlags[Index] & SRE_TILE_CHANGED)) {
+      continue;
+    }
+
+    Hash = HashTile (Tiles, Gop, Index);
+    Verified++;
+    Tiles->Stats.TilesVerified++;
+
+    if (Hash != Tiles->TileHash[Index]) {
+      Tiles->TileHash[Index]   = Hash;
+      Tiles->TileFlags[Index] |= SRE_TILE_CHANGED;
+      Tiles->ChangedCount++;
+      Tiles->Stats.TilesChanged++;
+      Changed++;
+    }
+  }
+
+  return Changed;
+}
+
+/**
+    Finds the next tile flagged as changed.
+
+    @param[in]     Tiles            Tiled checksum state.
+    @param[in,out] TileIndex        On input, the first tile to consider.  On output, the changed tile.
+    @param[out]    TileRect         Screen rectangle covered by the changed tile.
+
+    @retval EFI_SUCCESS             A changed tile was found.
+    @retval EFI_NOT_FOUND           No changed tile at or after the specified index.
+
+**/
+EFI_STATUS
+TileChecksumGetNextChangedTile (
+  IN     SRE_TILE_CHECKSUM  *Tiles,
+  IN OUT UINT32             *TileIndex,
+  OUT    SWM_RECT           *TileRect
+  )
+{
+  UINT32  Index;
+
+  if (0 == Tiles->ChangedCount) {
+    return EFI_NOT_FOUND;
+  }
+
+  for (Index = *TileIndex; Index < Tiles->TileCount; Index++) {
+    if (0 != (Tiles->TileFlags[Index] & SRE_TILE_CHANGED)) {
+      *TileIndex = Index;
+      GetTileRect (Tiles, Index, TileRect);
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+    Clears the changed flag from every tile.
+
+    @param[in] Tiles                Tiled checksum state.
+
+**/
+VOID
+TileChecksumClearChanged (
+  IN SRE_TILE_CHECKSUM  *Tiles
+  )
+{
+  UINT32  Index;
+
+  for (Index = 0; (Index < Tiles->TileCount) && (Tiles->ChangedCount > 0); Index++) {
+    if (0 != (Tiles->TileFlags[Index] & SRE_TILE_CHANGED)) {
+      Tiles->TileFlags[Index] &= (UINT8)~SRE_TILE_CHANGED;
+      Tiles->ChangedCount--;
+    }
+  }
+}
@@ -0,0 +1,161 @@
+/** @file
+
+  Tiled surface frame checksums used by the Simple Rendering Engine (SRE).
+
+  A surface frame is divided into square tiles, each with its own 64-bit hash.  Tiles
+  written through the SRE are marked dirty and only those are rehashed on the next
+  sample.  A bounded number of clean tiles is re-read on each sample to catch writes
+  made directly to the framebuffer; tiles that no longer match are reported as changed.
+
+Copyright (C) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _SURFACE_TILE_CHECKSUM_H_
+#define _SURFACE_TILE_CHECKSUM_H_
+
+#include <Uefi.h>
+
+#include <Protocol/GraphicsOutput.h>
+#include <Protocol/SimpleWindowManager.h>
+
+#define SRE_TILE_SIZE  32                                                   // Tile width and height in pixels.
+
+#define SRE_TILE_VERIFY_BUDGET         32                                   // Most clean tiles re-read per sample when checking for direct framebuffer writes.
+#define SRE_TILE_VERIFY_SWEEP_SAMPLES  5                                    // Samples to re-read every clean tile of a small frame once (1s at 200ms).
+
+#define SRE_TILE_DIRTY    0x01                                              // Tile was written through the SRE and must be rehashed.
+#define SRE_TILE_CHANGED  0x02                                              // Tile contents changed without going through the SRE.
+
+// Tile checksum statistics (per surface).
+//
+typedef struct {
+  UINTN    Samples;             // Number of calls to TileChecksumSample.
+  UINTN    TilesRehashed;       // Dirty tiles rehashed to establish a new baseline.
+  UINTN    TilesVerified;       // Clean tiles re-read and compared against their baseline.
+  UINTN    TilesChanged;        // Clean tiles found to differ from their baseline.
+  UINTN    PixelsRead;          // Framebuffer pixels read while hashing tiles.
+} SRE_TILE_CHECKSUM_STATS;
+
+// Tiled checksum state for a surface frame.
+//
+typedef struct {
+  SWM_RECT                   FrameRect;     // Surface frame rectangle (screen coordinates).
+  UINT32                     TilesX;        // Number of tile columns.
+  UINT32                     TilesY;        // Number of tile rows.
+  UINT32                     TileCount;     // Total number of tiles.
+  UINT32                     DirtyCount;    // Number of tiles with SRE_TILE_DIRTY set.
+  UINT32                     ChangedCount;  // Number of tiles with SRE_TILE_CHANGED set.
+  UINT32                     VerifyCursor;  // Next tile to verify (round-robin).
+  UINT64                     *TileHash;     // Baseline hash for each tile.
+  UINT8                      *TileFlags;    // SRE_TILE_* flags for each tile.
+  SRE_TILE_CHECKSUM_STATS    Stats;
+} SRE_TILE_CHECKSUM;
+
+/**
+    Initializes the tiled checksum state for a surface frame.  All tiles start out dirty
+    so the first sample establishes the baseline.
+
+    @param[out] Tiles               Tiled checksum state to initialize.
+    @param[in]  FrameRect           Surface frame rectangle (screen coordinates).
+
+    @retval EFI_SUCCESS             The state was initialized.
+    @retval EFI_INVALID_PARAMETER   The frame rectangle is empty.
+    @retval EFI_OUT_OF_RESOURCES    Failed to allocate the tile arrays.
+
+**/
+EFI_STATUS
+TileChecksumInit (
+  OUT SRE_TILE_CHECKSUM  *Tiles,
+  IN  SWM_RECT           *FrameRect
+  );
+
+/**
+    Frees the tile arrays owned by the tiled checksum state.
+
+    @param[in] Tiles                Tiled checksum state to free.
+
+**/
+VOID
+TileChecksumFree (
+  IN SRE_TILE_CHECKSUM  *Tiles
+  );
+
+/**
+    Marks every tile overlapping the specified rectangle as dirty.
+
+    @param[in] Tiles                Tiled checksum state.
+    @param[in] Rect                 Rectangle written through the SRE (screen coordinates).
+
+**/
+VOID
+TileChecksumMarkDirty (
+  IN SRE_TILE_CHECKSUM  *Tiles,
+  IN SWM_RECT           *Rect
+  );
+
+/**
+    Returns the number of clean tiles to verify per sample.  A frame small enough is swept
+    within SRE_TILE_VERIFY_SWEEP_SAMPLES samples; a larger frame is capped at
+    SRE_TILE_VERIFY_BUDGET tiles, so an idle frame never costs more than that per sample.
+
+    @param[in] Tiles                Tiled checksum state.
+
+    @retval Clean tiles to verify per sample (0 if the frame has no tiles).
+
+**/
+UINT32
+TileChecksumVerifyBudget (
+  IN SRE_TILE_CHECKSUM  *Tiles
+  );
+
+/**
+    Rehashes all dirty tiles and verifies up to MaxVerify clean tiles against their baseline.
+    Clean tiles that no longer match are flagged as changed and take the new contents as their
+    baseline so that the same change is only reported once.
+
+    @param[in] Tiles                Tiled checksum state.
+    @param[in] Gop                  Graphics output protocol that owns the framebuffer.
+    @param[in] MaxVerify            Maximum number of clean tiles to verify (0 == all of them).
+
+    @retval Number of tiles newly flagged as changed.
+
+**/
+UINT32
+TileChecksumSample (
+  IN SRE_TILE_CHECKSUM             *Tiles,
+  IN EFI_GRAPHICS_OUTPUT_PROTOCOL  *Gop,
+  IN UINT32                        MaxVerify
+  );
+
+/**
+    Finds the next tile flagged as changed.
+
+    @param[in]     Tiles            Tiled checksum state.
+    @param[in,out] TileIndex        On input, the first tile to consider.  On output, the changed tile.
+    @param[out]    TileRect         Screen rectangle covered by the changed tile.
+
+    @retval EFI_SUCCESS             A changed tile was found.
+    @retval EFI_NOT_FOUND           No changed tile at or after the specified index.
+
+**/
+EFI_STATUS
+TileChecksumGetNextChangedTile (
+  IN     SRE_TILE_CHECKSUM  *Tiles,
+  IN OUT UINT32             *TileIndex,
+  OUT    SWM_RECT           *TileRect
+  );
+
+/**
+    Clears the changed flag from every tile.
+
+    @param[in] Tiles                Tiled checksum state.
+
+**/
+VOID
+TileChecksumClearChanged (
+  IN SRE_TILE_CHECKSUM  *Tiles
+  );
+
+#endif // _SURFACE_TILE_CHECKSUM_H_
@@ -0,0 +1,477 @@
+/** @file
+  Host based unit tests for the RenderingEngineDxe tiled surface frame checksums.
+
+  A memory backed mock GOP supplies the frame buffer.  Writes made "through the SRE"
+  mark tiles dirty, writes made directly to the frame buffer don't.  The sample cost
+  (frame buffer pixels read) is reported for an idle and a fully redrawn screen, using
+  the verify budget the Rendering Engine samples with.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include "../SurfaceTileChecksum.h"
+
+#define UNIT_TEST_NAME     "RenderingEngineDxe Tile Checksum Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define SCREEN_WIDTH   1024
+#define SCREEN_HEIGHT  768
+#define SCREEN_STRIDE  1040                                                 // Pixels per scan line (wider than the visible area).
+
+//
+// Mock GOP state.
+//
+STATIC EFI_GRAPHICS_OUTPUT_MODE_INFORMATION  mModeInfo;
+STATIC EFI_GRAPHICS_OUTPUT_PROTOCOL_MODE     mMode;
+STATIC EFI_GRAPHICS_OUTPUT_PROTOCOL          mGop;
+STATIC UINT32                                *mFrameBuffer = NULL;
+
+/**
+  Allocates the memory backed frame buffer and fills it with a gradient.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetupMockGop (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  X;
+  UINTN  Y;
+
+  if (mFrameBuffer == NULL) {
+    mFrameBuffer = AllocatePool (SCREEN_STRIDE * SCREEN_HEIGHT * sizeof (UINT32));
+    if (mFrameBuffer == NULL) {
+      return UNIT_TEST_ERROR_TEST_FAILED;
+    }
+  }
+
+  for (Y = 0; Y < SCREEN_HEIGHT; Y++) {
+    for (X = 0; X < SCREEN_STRIDE; X++) {
+      mFrameBuffer[Y * SCREEN_STRIDE + X] = (UINT32)((Y << 12) ^ (X * 0x10101));
+    }
+  }
+
+  ZeroMem (&mModeInfo, sizeof (mModeInfo));
+  mModeInfo.HorizontalResolution = SCREEN_WIDTH;
+  mModeInfo.VerticalResolution   = SCREEN_HEIGHT;
+  mModeInfo.PixelFormat          = PixelBlueGreenRedReserved8BitPerColor;
+  mModeInfo.PixelsPerScanLine    = SCREEN_STRIDE;
+
+  ZeroMem (&mMode, sizeof (mMode));
+  mMode.Info            = &mModeInfo;
+  mMode.SizeOfInfo      = sizeof (mModeInfo);
+  mMode.FrameBufferBase = (EFI_PHYSICAL_ADDRESS)(UINTN)mFrameBuffer;
+  mMode.FrameBufferSize = SCREEN_STRIDE * SCREEN_HEIGHT * sizeof (UINT32);
+
+  ZeroMem (&mGop, sizeof (mGop));
+  mGop.Mode = &mMode;
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Fills a screen rectangle with a solid color directly in the frame buffer.
+**/
+STATIC
+VOID
+FillRect (
+  IN SWM_RECT  *Rect,
+  IN UINT32    Color
+  )
+{
+  UINT32  X;
+  UINT32  Y;
+
+  for (Y = Rect->Top; Y <= Rect->Bottom; Y++) {
+    for (X = Rect->Left; X <= Rect->Right; X++) {
+      mFrameBuffer[Y * SCREEN_STRIDE + X] = Color;
+    }
+  }
+}
+
+/**
+  Builds a rectangle from its origin and size.
+**/
+STATIC
+SWM_RECT
+MakeRect (
+  IN UINT32  Left,
+  IN UINT32  Top,
+  IN UINT32  Width,
+  IN UINT32  Height
+  )
+{
+  SWM_RECT  Rect;
+
+  Rect.Left   = Left;
+  Rect.Top    = Top;
+  Rect.Right  = Left + Width - 1;
+  Rect.Bottom = Top + Height - 1;
+
+  return Rect;
+}
+
+/**
+  The first sample hashes every tile, including partial tiles on the right and bottom edges,
+  and doesn't report anything as changed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+InitialSampleEstablishesBaseline (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SRE_TILE_CHECKSUM  Tiles;
+  SWM_RECT           Frame;
+
+  Frame = MakeRect (10, 5, 100, 70);
+  UT_ASSERT_NOT_EFI_ERROR (TileChecksumInit (&Tiles, &Frame));
+
+  UT_ASSERT_EQUAL (Tiles.TilesX, 4);
+  UT_ASSERT_EQUAL (Tiles.TilesY, 3);
+  UT_ASSERT_EQUAL (Tiles.DirtyCount, 12);
+
+  UT_ASSERT_EQUAL (TileChecksumSample (&Tiles, &mGop, 0), 0);
+  UT_ASSERT_EQUAL (Tiles.DirtyCount, 0);
+  UT_ASSERT_EQUAL (Tiles.ChangedCount, 0);
+  UT_ASSERT_EQUAL (Tiles.Stats.TilesRehashed, 12);
+  UT_ASSERT_EQUAL (Tiles.Stats.TilesVerified, 12);
+  UT_ASSERT_EQUAL (Tiles.Stats.PixelsRead, 2 * 100 * 70);
+
+  TileChecksumFree (&Tiles);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A write made directly to the frame buffer is reported once, on the tile that contains it.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DirectWriteIsReported (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SRE_TILE_CHECKSUM  Tiles;
+  SWM_RECT           Frame;
+  SWM_RECT           TileRect;
+  UINT32             TileIndex;
+
+  Frame = MakeRect (10, 5, 100, 70);
+  UT_ASSERT_NOT_EFI_ERROR (TileChecksumInit (&Tiles, &Frame));
+  UT_ASSERT_EQUAL (TileChecksumSample (&Tiles, &mGop, 0), 0);
+
+  // Flip a single bit of one pixel in the bottom right (partial) tile.
+  //
+  mFrameBuffer[(5 + 69) * SCREEN_STRIDE + (10 + 99)] ^= 0x100;
+
+  UT_ASSERT_EQUAL (TileChecksumSample (&Tiles, &mGop, 0), 1);
+  UT_ASSERT_EQUAL (Tiles.ChangedCount, 1);
+
+  TileIndex = 0;
+  UT_ASSERT_NOT_EFI_ERROR (TileChecksumGetNextChangedTile (&Tiles, &TileIndex, &TileRect));
+  UT_ASSERT_EQUAL (TileIndex, 11);
+  UT_ASSERT_EQUAL (TileRect.Left, 10 + 96);
+  UT_ASSERT_EQUAL (TileRect.Top, 5 + 64);
+  UT_ASSERT_EQUAL (TileRect.Right, 10 + 99);
+  UT_ASSERT_EQUAL (TileRect.Bottom, 5 + 69);
+
+  TileIndex++;
+  UT_ASSERT_STATUS_EQUAL (TileChecksumGetNextChangedTile (&Tiles, &TileIndex, &TileRect), EFI_NOT_FOUND);
+
+  // The change is only reported once.
+  //
+  UT_ASSERT_EQUAL (TileChecksumSample (&Tiles, &mGop, 0), 0);
+
+  TileChecksumClearChanged (&Tiles);
+  UT_ASSERT_EQUAL (Tiles.ChangedCount, 0);
+  UT_ASSERT_EQUAL (TileChecksumSample (&Tiles, &mGop, 0), 0);
+
+  TileChecksumFree (&Tiles);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Writes made through the SRE only rehash the tiles they touch and aren't reported.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SreWriteRehashesTouchedTiles (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SRE_TILE_CHECKSUM  Tiles;
+  SWM_RECT           Frame;
+  SWM_RECT           Blt;
+  UINTN              Rehashed;
+
+  Frame = MakeRect (0, 0, 256, 256);
+  UT_ASSERT_NOT_EFI_ERROR (TileChecksumInit (&Tiles, &Frame));
+  UT_ASSERT_EQUAL (TileChecksumSample (&Tiles, &mGop, 0), 0);
+
+  // A blit straddling four tiles.
+  //
+  Blt = MakeRect (60, 60, 10, 10);
+  FillRect (&Blt, 0x00FF00FF);
+  TileChecksumMarkDirty (&Tiles, &Blt);
+  UT_ASSERT_EQUAL (Tiles.DirtyCount, 4);
+
+  Rehashed = Tiles.Stats.TilesRehashed;
+  UT_ASSERT_EQUAL (TileChecksumSample (&Tiles, &mGop, 0), 0);
+  UT_ASSERT_EQUAL (Tiles.Stats.TilesRehashed - Rehashed, 4);
+
+  // Blits outside of the surface frame, or clipped by it.
+  //
+  Blt = MakeRect (300, 300, 10, 10);
+  TileChecksumMarkDirty (&Tiles, &Blt);
+  UT_ASSERT_EQUAL (Tiles.DirtyCount, 0);
+
+  Blt = MakeRect (250, 0, 100, 1);
+  TileChecksumMarkDirty (&Tiles, &Blt);
+  UT_ASSERT_EQUAL (Tiles.DirtyCount, 1);
+
+  TileChecksumFree (&Tiles);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  With a verify budget, every clean tile is eventually re-read (round-robin).
+**/
+UNIT_TEST_STATUS
+EFIAPI
+VerifyBudgetCoversAllTiles (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SRE_TILE_CHECKSUM  Tiles;
+  SWM_RECT           Frame;
+  UINT32             Found;
+  UINT32             Sample;
+
+  Frame = MakeRect (0, 0, 128, 96);     // 4 x 3 tiles.
+  UT_ASSERT_NOT_EFI_ERROR (TileChecksumInit (&Tiles, &Frame));
+  UT_ASSERT_EQUAL (TileChecksumSample (&Tiles, &mGop, 5), 0);
+
+  // Tamper with the last tile.
+  //
+  mFrameBuffer[95 * SCREEN_STRIDE + 127] ^= 0x1;
+
+  Found = 0;
+  for (Sample = 0; (Sample < 3) && (Found == 0); Sample++) {
+    Found = TileChecksumSample (&Tiles, &mGop, 5);
+  }
+
+  UT_ASSERT_EQUAL (Found, 1);
+  UT_ASSERT_TRUE (Tiles.Stats.TilesVerified <= (5 * 4));
+
+  TileChecksumFree (&Tiles);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A small frame is swept within SRE_TILE_VERIFY_SWEEP_SAMPLES samples, and no frame
+  verifies more than SRE_TILE_VERIFY_BUDGET tiles per sample.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+VerifyBudgetIsCapped (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SRE_TILE_CHECKSUM  Tiles;
+  SWM_RECT           Frame;
+  UINT32             Sample;
+  UINTN              Verified;
+
+  Frame = MakeRect (10, 5, 100, 70);    // 4 x 3 tiles.
+  UT_ASSERT_NOT_EFI_ERROR (TileChecksumInit (&Tiles, &Frame));
+  UT_ASSERT_EQUAL (TileChecksumVerifyBudget (&Tiles), 3);
+  UT_ASSERT_EQUAL (TileChecksumSample (&Tiles, &mGop, TileChecksumVerifyBudget (&Tiles)), 0);
+
+  Verified = Tiles.Stats.TilesVerified;
+  for (Sample = 0; Sample < SRE_TILE_VERIFY_SWEEP_SAMPLES; Sample++) {
+    UT_ASSERT_EQUAL (TileChecksumSample (&Tiles, &mGop, TileChecksumVerifyBudget (&Tiles)), 0);
+  }
+
+  UT_ASSERT_TRUE (Tiles.Stats.TilesVerified - Verified >= Tiles.TileCount);
+  TileChecksumFree (&Tiles);
+
+  // Full screen and a 4K frame: the tile arrays are all that is needed here.
+  //
+  Frame = MakeRect (0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+  UT_ASSERT_NOT_EFI_ERROR (TileChecksumInit (&Tiles, &Frame));
+  UT_ASSERT_EQUAL (TileChecksumVerifyBudget (&Tiles), SRE_TILE_VERIFY_BUDGET);
+  TileChecksumFree (&Tiles);
+
+  Frame = MakeRect (0, 0, 3840, 2160);
+  UT_ASSERT_NOT_EFI_ERROR (TileChecksumInit (&Tiles, &Frame));
+  UT_ASSERT_EQUAL (TileChecksumVerifyBudget (&Tiles), SRE_TILE_VERIFY_BUDGET);
+  TileChecksumFree (&Tiles);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Measures the sample cost for an idle and a fully redrawn full-screen surface.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SampleCostIdleVersusRedrawn (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SRE_TILE_CHECKSUM  Tiles;
+  SWM_RECT           Frame;
+  UINTN              PixelsRead;
+  UINTN              IdleCost;
+  UINTN              RedrawCost;
+  UINTN              Sample;
+  UINT32             Budget;
+
+  Frame = MakeRect (0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+  UT_ASSERT_NOT_EFI_ERROR (TileChecksumInit (&Tiles, &Frame));
+  Budget = TileChecksumVerifyBudget (&Tiles);
+  UT_ASSERT_EQUAL (TileChecksumSample (&Tiles, &mGop, Budget), 0);
+
+  // Idle: nothing written between samples.
+  //
+  PixelsRead = Tiles.Stats.PixelsRead;
+  for (Sample = 0; Sample < 10; Sample++) {
+    UT_ASSERT_EQUAL (TileChecksumSample (&Tiles, &mGop, Budget), 0);
+  }
+
+  IdleCost = (Tiles.Stats.PixelsRead - PixelsRead) / 10;
+
+  // Fully redrawn: the whole screen is blitted through the SRE before each sample.
+  //
+  PixelsRead = Tiles.Stats.PixelsRead;
+  for (Sample = 0; Sample < 10; Sample++) {
+    FillRect (&Frame, (UINT32)Sample);
+    TileChecksumMarkDirty (&Tiles, &Frame);
+    UT_ASSERT_EQUAL (TileChecksumSample (&Tiles, &mGop, Budget), 0);
+  }
+
+  RedrawCost = (Tiles.Stats.PixelsRead - PixelsRead) / 10;
+
+  UT_LOG_INFO ("Tiles: %u, idle sample: %u pixels, redrawn sample: %u pixels\n", Tiles.TileCount, (UINT32)IdleCost, (UINT32)RedrawCost);
+
+  UT_ASSERT_EQUAL (IdleCost, Budget * SRE_TILE_SIZE * SRE_TILE_SIZE);
+  UT_ASSERT_TRUE (IdleCost <= SRE_TILE_VERIFY_BUDGET * SRE_TILE_SIZE * SRE_TILE_SIZE);
+  UT_ASSERT_TRUE (RedrawCost >= (UINTN)SCREEN_WIDTH * SCREEN_HEIGHT);
+  UT_ASSERT_TRUE (IdleCost * 16 < RedrawCost);
+
+  TileChecksumFree (&Tiles);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Empty frame rectangles are rejected.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+EmptyFrameRejected (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  SRE_TILE_CHECKSUM  Tiles;
+  SWM_RECT           Frame;
+
+  Frame.Left   = 10;
+  Frame.Right  = 9;
+  Frame.Top    = 0;
+  Frame.Bottom = 10;
+
+  UT_ASSERT_STATUS_EQUAL (TileChecksumInit (&Tiles, &Frame), EFI_INVALID_PARAMETER);
+  UT_ASSERT_EQUAL (TileChecksumSample (&Tiles, &mGop, 0), 0);
+
+  TileChecksumFree (&Tiles);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  tiled surface frame checksums and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      TileSuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&TileSuiteHandle, Framework, "RenderingEngineDxe tile checksum tests", "RenderingEngine.TileChecksum", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for TileSuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (TileSuiteHandle, "First sample establishes the baseline", "Baseline", InitialSampleEstablishesBaseline, SetupMockGop, NULL, NULL);
+  AddTestCase (TileSuiteHandle, "Direct frame buffer writes are reported", "DirectWrite", DirectWriteIsReported, SetupMockGop, NULL, NULL);
+  AddTestCase (TileSuiteHandle, "SRE writes only rehash touched tiles", "SreWrite", SreWriteRehashesTouchedTiles, SetupMockGop, NULL, NULL);
+  AddTestCase (TileSuiteHandle, "Verify budget covers all tiles", "VerifyBudget", VerifyBudgetCoversAllTiles, SetupMockGop, NULL, NULL);
+  AddTestCase (TileSuiteHandle, "Verify budget is capped", "BudgetCap", VerifyBudgetIsCapped, SetupMockGop, NULL, NULL);
+  AddTestCase (TileSuiteHandle, "Sample cost for idle and redrawn screens", "SampleCost", SampleCostIdleVersusRedrawn, SetupMockGop, NULL, NULL);
+  AddTestCase (TileSuiteHandle, "Empty frame is rejected", "EmptyFrame", EmptyFrameRejected, SetupMockGop, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  if (mFrameBuffer != NULL) {
+    FreePool (mFrameBuffer);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
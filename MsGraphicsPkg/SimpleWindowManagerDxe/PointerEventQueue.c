@@ -0,0 +1,282 @@
+/** @file
+
+  Per-client absolute pointer event queue used by the Simple Window Manager (SWM).
+
+  NOTE: These routines don't synchronize access to the queue.  Callers are expected
+        to raise the TPL around them.
+
+Copyright (C) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+
+#include <Library/DebugLib.h>
+
+#include "PointerEventQueue.h"
+
+/**
+    Converts a logical queue index (0 == oldest) into a slot in the circular buffer.
+
+    @param[in] Queue                Queue to index.
+    @param[in] Index                Logical index of the pointer state.
+
+    @retval Slot in PointerStateQueue.
+
+**/
+STATIC
+UINTN
+QueueSlot (
+  IN MS_SWM_ABSOLUTE_POINTER_QUEUE  *Queue,
+  IN UINTN                          Index
+  )
+{
+  return (Queue->QueueOutputPosition + Index) % POINTER_STATE_INPUT_QUEUE_SIZE;
+}
+
+/**
+    Determines whether the queued pointer state at the logical index only moves the pointer
+    (i.e., its button state matches the pointer state that precedes it).
+
+    @param[in] Queue                Queue to check.
+    @param[in] Index                Logical index of the pointer state.
+
+    @retval TRUE                    The pointer state doesn't change the button state.
+
+**/
+STATIC
+BOOLEAN
+IsMoveOnly (
+  IN MS_SWM_ABSOLUTE_POINTER_QUEUE  *Queue,
+  IN UINTN                          Index
+  )
+{
+  UINT32  PreviousButtons;
+
+  if (Index == 0) {
+    PreviousButtons = Queue->LastExtractedButtons;
+  } else {
+    PreviousButtons = Queue->PointerStateQueue[QueueSlot (Queue, Index - 1)].ActiveButtons;
+  }
+
+  return (BOOLEAN)(Queue->PointerStateQueue[QueueSlot (Queue, Index)].ActiveButtons == PreviousButtons);
+}
+
+/**
+    Removes the queued pointer state at the logical index, preserving the order of the others.
+
+    @param[in] Queue                Queue to remove from.
+    @param[in] Index                Logical index of the pointer state.
+
+**/
+STATIC
+VOID
+RemoveAt (
+  IN MS_SWM_ABSOLUTE_POINTER_QUEUE  *Queue,
+  IN UINTN                          Index
+  )
+{
+  for ( ; (Index + 1) < Queue->QueueDepth; Index++) {
+    Queue->PointerStateQueue[QueueSlot (Queue, Index)] = Queue->PointerStateQueue[QueueSlot (Queue, Index + 1)];
+  }
+
+  Queue->QueueDepth--;
+  Queue->QueueInputPosition = QueueSlot (Queue, Queue->QueueDepth);
+  Queue->bQueueEmpty        = (BOOLEAN)(Queue->QueueDepth == 0);
+}
+
+/**
+    Empties the pointer event queue.  Statistics are preserved.
+
+    @param[in] Queue                Queue to be reset.
+
+**/
+VOID
+PointerQueueReset (
+  IN MS_SWM_ABSOLUTE_POINTER_QUEUE  *Queue
+  )
+{
+  Queue->bQueueEmpty          = TRUE;
+  Queue->QueueInputPosition   = 0;
+  Queue->QueueOutputPosition  = 0;
+  Queue->QueueDepth           = 0;
+  Queue->LastExtractedButtons = 0;
+  Queue->Stats.CurrentDepth   = 0;
+}
+
+/**
+    Inserts a pointer state into the queue.
+
+    A move-only state (same buttons as the newest queued state, where that state is itself
+    move-only) replaces the newest queued position.  When the queue is full the oldest move-only
+    state is discarded to make room.  Button transitions are never discarded once queued.
+
+    @param[in] Queue                Queue to insert into.
+    @param[in] PointerState         Pointer state to insert.
+
+    @retval EFI_SUCCESS             The pointer state was queued or coalesced.
+    @retval EFI_OUT_OF_RESOURCES    The queue is full of button transitions.
+
+**/
+EFI_STATUS
+PointerQueueInsert (
+  IN MS_SWM_ABSOLUTE_POINTER_QUEUE  *Queue,
+  IN MS_SWM_ABSOLUTE_POINTER_STATE  *PointerState
+  )
+{
+  MS_SWM_ABSOLUTE_POINTER_STATE  *Tail;
+  UINT32                         Buttons;
+  UINTN                          Index;
+
+  Buttons = (PointerState->ActiveButtons & 0x1);                    // We only recognize the LSB.
+
+  if (Queue->QueueDepth > 0) {
+    Tail = &Queue->PointerStateQueue[QueueSlot (Queue, Queue->QueueDepth - 1)];
+
+    // Coalesce consecutive moves into the newest position.  The tail must itself be a move so
+    // the location of a press or release is never overwritten.
+    //
+    if ((Tail->ActiveButtons == Buttons) && IsMoveOnly (Queue, Queue->QueueDepth - 1)) {
+      Tail->CurrentX = PointerState->CurrentX;
+      Tail->CurrentY = PointerState->CurrentY;
+      Queue->Stats.Coalesced++;
+      return EFI_SUCCESS;
+    }
+  }
+
+  // If the queue is full, make room by discarding the oldest move.  Removing a move never
+  // changes whether the state that follows it is a transition.
+  //
+  if (Queue->QueueDepth == POINTER_STATE_INPUT_QUEUE_SIZE) {
+    for (Index = 0; Index < Queue->QueueDepth; Index++) {
+      if (IsMoveOnly (Queue, Index)) {
+        RemoveAt (Queue, Index);
+        Queue->Stats.DroppedMoves++;
+        break;
+      }
+    }
+
+    if (Queue->QueueDepth == POINTER_STATE_INPUT_QUEUE_SIZE) {
+      // The queue only holds transitions.  A move can simply be discarded since the newest
+      // queued button state already matches it.
+      //
+      if (Queue->PointerStateQueue[QueueSlot (Queue, Queue->QueueDepth - 1)].ActiveButtons == Buttons) {
+        Queue->Stats.DroppedMoves++;
+        return EFI_SUCCESS;
+      }
+
+      DEBUG ((DEBUG_WARN, "WARN [SWM]: Pointer event %p queue overflow!\r\n", Queue));
+      Queue->Stats.Overflows++;
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  // Store pointer state data in the queue
+  //
+  Queue->PointerStateQueue[Queue->QueueInputPosition].CurrentX      = PointerState->CurrentX;
+  Queue->PointerStateQueue[Queue->QueueInputPosition].CurrentY      = PointerState->CurrentY;
+  Queue->PointerStateQueue[Queue->QueueInputPosition].CurrentZ      = 0;                         // Z should always be 0.
+  Queue->PointerStateQueue[Queue->QueueInputPosition].ActiveButtons = Buttons;
+
+  // Increment the input position to the next slot and handle wrap-around
+  //
+  ++Queue->QueueInputPosition;
+  Queue->QueueInputPosition %= POINTER_STATE_INPUT_QUEUE_SIZE;
+
+  Queue->QueueDepth++;
+  Queue->bQueueEmpty = FALSE;
+
+  Queue->Stats.Inserted++;
+  Queue->Stats.CurrentDepth = Queue->QueueDepth;
+  if (Queue->QueueDepth > Queue->Stats.MaxDepth) {
+    Queue->Stats.MaxDepth = Queue->QueueDepth;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+    Returns the oldest pointer state in the queue without removing it.
+
+    @param[in]  Queue               Queue to peek at.
+    @param[out] PointerState        Pointer state to be filled in from the queue.
+
+    @retval EFI_SUCCESS             Successfully retrieved event state.
+    @retval EFI_NOT_FOUND           No data found in the queue.
+
+**/
+EFI_STATUS
+PointerQueuePeek (
+  IN  MS_SWM_ABSOLUTE_POINTER_QUEUE  *Queue,
+  OUT MS_SWM_ABSOLUTE_POINTER_STATE  *PointerState
+  )
+{
+  if (Queue->QueueDepth == 0) {
+    return EFI_NOT_FOUND;
+  }
+
+  *PointerState = Queue->PointerStateQueue[Queue->QueueOutputPosition];
+
+  return EFI_SUCCESS;
+}
+
+/**
+    Removes the oldest pointer state from the queue.
+
+    @param[in]  Queue               Queue to extract from.
+    @param[out] PointerState        Pointer state to be filled in from the queue.
+
+    @retval EFI_SUCCESS             Successfully retrieved event state.
+    @retval EFI_NOT_FOUND           No data found in the queue.
+
+**/
+EFI_STATUS
+PointerQueueExtract (
+  IN  MS_SWM_ABSOLUTE_POINTER_QUEUE  *Queue,
+  OUT MS_SWM_ABSOLUTE_POINTER_STATE  *PointerState
+  )
+{
+  if (Queue->QueueDepth == 0) {
+    return EFI_NOT_FOUND;
+  }
+
+  *PointerState               = Queue->PointerStateQueue[Queue->QueueOutputPosition];
+  Queue->LastExtractedButtons = PointerState->ActiveButtons;
+
+  // Increment the output position to the next slot and handle wrap-around
+  //
+  ++Queue->QueueOutputPosition;
+  Queue->QueueOutputPosition %= POINTER_STATE_INPUT_QUEUE_SIZE;
+
+  Queue->QueueDepth--;
+  Queue->bQueueEmpty        = (BOOLEAN)(Queue->QueueDepth == 0);
+  Queue->Stats.CurrentDepth = Queue->QueueDepth;
+
+  return EFI_SUCCESS;
+}
+
+/**
+    Returns a copy of the queue statistics.
+
+    @param[in]  Queue               Queue whose statistics are requested.
+    @param[out] Stats               Statistics to be filled in.
+
+    @retval EFI_SUCCESS             Successfully retrieved the statistics.
+    @retval EFI_INVALID_PARAMETER   Queue or Stats is NULL.
+
+**/
+EFI_STATUS
+PointerQueueGetStatistics (
+  IN  MS_SWM_ABSOLUTE_POINTER_QUEUE  *Queue,
+  OUT MS_SWM_POINTER_QUEUE_STATS     *Stats
+  )
+{
+  if ((Queue == NULL) || (Stats == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  *Stats = Queue->Stats;
+
+  return EFI_SUCCESS;
+}
@@ -0,0 +1,125 @@
+/** @file
+
+  Per-client absolute pointer event queue used by the Simple Window Manager (SWM).
+
+  Consecutive move-only samples are coalesced into the newest position while every
+  button state transition is preserved in order.
+
+Copyright (C) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _POINTER_EVENT_QUEUE_H_
+#define _POINTER_EVENT_QUEUE_H_
+
+#include <Uefi.h>
+
+#include <Protocol/AbsolutePointer.h>
+#include <Protocol/SimpleWindowManager.h>
+
+#define POINTER_STATE_INPUT_QUEUE_SIZE  50                                  // Depth of aggregate pointer event queue.
+
+// Pointer event queue statistics (per client).
+//
+typedef struct {
+  UINTN    CurrentDepth;        // Number of pointer states currently queued.
+  UINTN    MaxDepth;            // High water mark of the queue depth.
+  UINTN    Inserted;            // Pointer states appended to the queue.
+  UINTN    Coalesced;           // Move-only pointer states merged into the newest queued position.
+  UINTN    DroppedMoves;        // Move-only pointer states discarded to make room for a button transition.
+  UINTN    Overflows;           // Button transitions that could not be queued because the queue was full of transitions.
+} MS_SWM_POINTER_QUEUE_STATS;
+
+// Pointer state event input queue (holds pointer event data until consumer reads them out, FIFO)
+//
+typedef struct {
+  BOOLEAN                          bQueueEmpty;
+  UINTN                            QueueInputPosition;
+  UINTN                            QueueOutputPosition;
+  UINTN                            QueueDepth;
+  UINT32                           LastExtractedButtons; // Button state of the last pointer state handed to the client.
+  MS_SWM_POINTER_QUEUE_STATS       Stats;
+  MS_SWM_ABSOLUTE_POINTER_STATE    PointerStateQueue[POINTER_STATE_INPUT_QUEUE_SIZE];
+} MS_SWM_ABSOLUTE_POINTER_QUEUE;
+
+/**
+    Empties the pointer event queue.  Statistics are preserved.
+
+    @param[in] Queue                Queue to be reset.
+
+**/
+VOID
+PointerQueueReset (
+  IN MS_SWM_ABSOLUTE_POINTER_QUEUE  *Queue
+  );
+
+/**
+    Inserts a pointer state into the queue.
+
+    A move-only state (same buttons as the newest queued state, where that state is itself
+    move-only) replaces the newest queued position.  When the queue is full the oldest move-only
+    state is discarded to make room.  Button transitions are never discarded once queued.
+
+    @param[in] Queue                Queue to insert into.
+    @param[in] PointerState         Pointer state to insert.
+
+    @retval EFI_SUCCESS             The pointer state was queued or coalesced.
+    @retval EFI_OUT_OF_RESOURCES    The queue is full of button transitions.
+
+**/
+EFI_STATUS
+PointerQueueInsert (
+  IN MS_SWM_ABSOLUTE_POINTER_QUEUE  *Queue,
+  IN MS_SWM_ABSOLUTE_POINTER_STATE  *PointerState
+  );
+
+/**
+    Returns the oldest pointer state in the queue without removing it.
+
+    @param[in]  Queue               Queue to peek at.
+    @param[out] PointerState        Pointer state to be filled in from the queue.
+
+    @retval EFI_SUCCESS             Successfully retrieved event state.
+    @retval EFI_NOT_FOUND           No data found in the queue.
+
+**/
+EFI_STATUS
+PointerQueuePeek (
+  IN  MS_SWM_ABSOLUTE_POINTER_QUEUE  *Queue,
+  OUT MS_SWM_ABSOLUTE_POINTER_STATE  *PointerState
+  );
+
+/**
+    Removes the oldest pointer state from the queue.
+
+    @param[in]  Queue               Queue to extract from.
+    @param[out] PointerState        Pointer state to be filled in from the queue.
+
+    @retval EFI_SUCCESS             Successfully retrieved event state.
+    @retval EFI_NOT_FOUND           No data found in the queue.
+
+**/
+EFI_STATUS
+PointerQueueExtract (
+  IN  MS_SWM_ABSOLUTE_POINTER_QUEUE  *Queue,
+  OUT MS_SWM_ABSOLUTE_POINTER_STATE  *PointerState
+  );
+
+/**
+    Returns a copy of the queue statistics.
+
+    @param[in]  Queue               Queue whose statistics are requested.
+    @param[out] Stats               Statistics to be filled in.
+
+    @retval EFI_SUCCESS             Successfully retrieved the statistics.
+    @retval EFI_INVALID_PARAMETER   Queue or Stats is NULL.
+
+**/
+EFI_STATUS
+PointerQueueGetStatistics (
+  IN  MS_SWM_ABSOLUTE_POINTER_QUEUE  *Queue,
+  OUT MS_SWM_POINTER_QUEUE_STATS     *Stats
+  );
+
+#endif // _POINTER_EVENT_QUEUE_H_
@@ -36,9 +36,7 @@ SWMAbsolutePointerReset (
 
   // Purge the event queue (removes old pending events).
   //
-  Client->Queue.bQueueEmpty         = TRUE;
-  Client->Queue.QueueInputPosition  = 0;
-  Client->Queue.QueueOutputPosition = 0;
+  PointerQueueReset (&Client->Queue);
 
   // Restore the TPL
   //
@@ -215,9 +213,7 @@ SWMRegisterClient (
   NewClient->DataNotificationContext   = Context;
   NewClient->ClientAbsPtr.Reset        = SWMAbsolutePointerReset;          // SWM functions
   NewClient->ClientAbsPtr.GetState     = SWMAbsolutePointerGetState;
-  NewClient->Queue.bQueueEmpty         = TRUE;
-  NewClient->Queue.QueueInputPosition  = 0;
-  NewClient->Queue.QueueOutputPosition = 0;
+  PointerQueueReset (&NewClient->Queue);
   // Return Abs Pointer Protocol to client
   *AbsolutePointer = &NewClient->ClientAbsPtr;
 
@@ -345,8 +341,9 @@ SWMUnregisterClient (
   IN  EFI_HANDLE                         ImageHandle
   )
 {
-  EFI_STATUS     Status = EFI_SUCCESS;
-  WINMGR_CLIENT  *pList = mSWM.Clients;
+  EFI_STATUS                  Status = EFI_SUCCESS;
+  WINMGR_CLIENT               *pList = mSWM.Clients;
+  MS_SWM_POINTER_QUEUE_STATS  QueueStats;
 
   DEBUG ((DEBUG_INFO, "INFO [SWM]: Unregistering client (ImageHandle=0x%x).\r\n", (UINTN)ImageHandle));
 
@@ -385,6 +382,18 @@ SWMUnregisterClient (
         }
       }
 
+      if (!EFI_ERROR (GetPointerQueueStatistics (pList, &QueueStats))) {
+        DEBUG ((
+          DEBUG_INFO,
+          "INFO [SWM]: Pointer queue stats - MaxDepth=%u, Inserted=%u, Coalesced=%u, DroppedMoves=%u, Overflows=%u\r\n",
+          (UINT32)QueueStats.MaxDepth,
+          (UINT32)QueueStats.Inserted,
+          (UINT32)QueueStats.Coalesced,
+          (UINT32)QueueStats.DroppedMoves,
+          (UINT32)QueueStats.Overflows
+          ));
+      }
+
       gBS->CloseEvent (pList->ClientAbsPtr.WaitForInput);
       FreePool (pList);
 
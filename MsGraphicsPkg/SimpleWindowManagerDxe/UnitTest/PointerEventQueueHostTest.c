@@ -0,0 +1,432 @@
+/** @file
+  Host based unit tests for the Simple Window Manager pointer event queue.
+
+  Mock absolute pointer providers flood the per-client queues while the client
+  drains them slowly, and the tests verify that every press/release is delivered.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/UnitTestLib.h>
+#include "../PointerEventQueue.h"
+
+#define UNIT_TEST_NAME     "SWM Pointer Event Queue Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define MOCK_PROVIDER_COUNT  2
+
+//
+// Mock absolute pointer provider.  Produces a drag that toggles the button state
+// every ToggleInterval samples.
+//
+typedef struct {
+  UINTN     SamplesProduced;
+  UINTN     SampleCount;
+  UINTN     ToggleInterval;
+  UINT32    Buttons;
+  UINTN     Transitions;
+  UINT64    LastX;
+  UINT64    LastY;
+} MOCK_POINTER_PROVIDER;
+
+//
+// Client side view of what was delivered from a queue.
+//
+typedef struct {
+  UINT32    Buttons;
+  UINTN     Transitions;
+  BOOLEAN   OutOfOrder;
+  UINT64    LastX;
+  UINT64    LastY;
+} MOCK_POINTER_CLIENT;
+
+/**
+  Mock EFI_ABSOLUTE_POINTER_PROTOCOL.GetState.
+
+  @param[in]  Provider    Mock provider.
+  @param[out] State       Next pointer state.
+
+  @retval EFI_SUCCESS     A new state was produced.
+  @retval EFI_NOT_READY   The provider has no more input.
+**/
+STATIC
+EFI_STATUS
+MockGetState (
+  IN  MOCK_POINTER_PROVIDER          *Provider,
+  OUT MS_SWM_ABSOLUTE_POINTER_STATE  *State
+  )
+{
+  if (Provider->SamplesProduced >= Provider->SampleCount) {
+    return EFI_NOT_READY;
+  }
+
+  Provider->SamplesProduced++;
+  if ((Provider->SamplesProduced % Provider->ToggleInterval) == 0) {
+    Provider->Buttons ^= 0x1;
+    Provider->Transitions++;
+  }
+
+  Provider->LastX = (Provider->SamplesProduced * 7) % 1920;
+  Provider->LastY = (Provider->SamplesProduced * 3) % 1080;
+
+  State->CurrentX      = Provider->LastX;
+  State->CurrentY      = Provider->LastY;
+  State->CurrentZ      = 0;
+  State->ActiveButtons = Provider->Buttons;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Drains one pointer state from the queue into the mock client.
+
+  @param[in] Queue      Queue to drain.
+  @param[in] Client     Mock client tracking delivered button state.
+
+  @retval TRUE          A state was delivered.
+**/
+STATIC
+BOOLEAN
+MockClientDrainOne (
+  IN MS_SWM_ABSOLUTE_POINTER_QUEUE  *Queue,
+  IN MOCK_POINTER_CLIENT            *Client
+  )
+{
+  MS_SWM_ABSOLUTE_POINTER_STATE  State;
+
+  if (EFI_ERROR (PointerQueueExtract (Queue, &State))) {
+    return FALSE;
+  }
+
+  if (State.ActiveButtons != Client->Buttons) {
+    Client->Transitions++;
+    Client->Buttons = State.ActiveButtons;
+  }
+
+  Client->LastX = State.CurrentX;
+  Client->LastY = State.CurrentY;
+
+  return TRUE;
+}
+
+/**
+  Floods the queues from multiple providers with a slow consumer and verifies that
+  every button transition is delivered.
+
+  @param[in] Context    Unused.
+
+  @retval UNIT_TEST_PASSED    Test passed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+FloodDeliversEveryTransition (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MS_SWM_ABSOLUTE_POINTER_QUEUE  Queues[MOCK_PROVIDER_COUNT];
+  MOCK_POINTER_PROVIDER          Providers[MOCK_PROVIDER_COUNT];
+  MOCK_POINTER_CLIENT            Clients[MOCK_PROVIDER_COUNT];
+  MS_SWM_ABSOLUTE_POINTER_STATE  State;
+  BOOLEAN                        Producing;
+  UINTN                          Tick;
+  UINTN                          Index;
+
+  ZeroMem (Queues, sizeof (Queues));
+  ZeroMem (Providers, sizeof (Providers));
+  ZeroMem (Clients, sizeof (Clients));
+
+  for (Index = 0; Index < MOCK_PROVIDER_COUNT; Index++) {
+    PointerQueueReset (&Queues[Index]);
+    Providers[Index].SampleCount    = 100000;
+    Providers[Index].ToggleInterval = 13 + (Index * 4);
+  }
+
+  // Poll every provider each tick but only let the clients consume every 8th tick.
+  //
+  Tick = 0;
+  do {
+    Producing = FALSE;
+    for (Index = 0; Index < MOCK_PROVIDER_COUNT; Index++) {
+      if (!EFI_ERROR (MockGetState (&Providers[Index], &State))) {
+        Producing = TRUE;
+        UT_ASSERT_NOT_EFI_ERROR (PointerQueueInsert (&Queues[Index], &State));
+      }
+
+      if ((Tick % 8) == 0) {
+        MockClientDrainOne (&Queues[Index], &Clients[Index]);
+      }
+    }
+
+    Tick++;
+  } while (Producing);
+
+  for (Index = 0; Index < MOCK_PROVIDER_COUNT; Index++) {
+    while (MockClientDrainOne (&Queues[Index], &Clients[Index])) {
+    }
+
+    UT_ASSERT_EQUAL (Clients[Index].Transitions, Providers[Index].Transitions);
+    UT_ASSERT_EQUAL (Clients[Index].Buttons, Providers[Index].Buttons);
+    UT_ASSERT_EQUAL (Clients[Index].LastX, Providers[Index].LastX);
+    UT_ASSERT_EQUAL (Clients[Index].LastY, Providers[Index].LastY);
+    UT_ASSERT_EQUAL (Queues[Index].Stats.Overflows, 0);
+    UT_ASSERT_TRUE (Queues[Index].Stats.Coalesced > 0);
+
+    DEBUG ((
+      DEBUG_INFO,
+      "Provider %u: Inserted=%u Coalesced=%u DroppedMoves=%u MaxDepth=%u\n",
+      (UINT32)Index,
+      (UINT32)Queues[Index].Stats.Inserted,
+      (UINT32)Queues[Index].Stats.Coalesced,
+      (UINT32)Queues[Index].Stats.DroppedMoves,
+      (UINT32)Queues[Index].Stats.MaxDepth
+      ));
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Verifies that a drag is coalesced into the newest position without moving the press location.
+
+  @param[in] Context    Unused.
+
+  @retval UNIT_TEST_PASSED    Test passed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DragKeepsPressLocation (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MS_SWM_ABSOLUTE_POINTER_QUEUE  Queue;
+  MS_SWM_ABSOLUTE_POINTER_STATE  State;
+  UINTN                          Index;
+
+  ZeroMem (&Queue, sizeof (Queue));
+  PointerQueueReset (&Queue);
+
+  // Press at (10,10) then drag to (109,109).
+  //
+  ZeroMem (&State, sizeof (State));
+  for (Index = 0; Index < 100; Index++) {
+    State.CurrentX      = 10 + Index;
+    State.CurrentY      = 10 + Index;
+    State.ActiveButtons = 1;
+    UT_ASSERT_NOT_EFI_ERROR (PointerQueueInsert (&Queue, &State));
+  }
+
+  // Release at the same place.
+  //
+  State.ActiveButtons = 0;
+  UT_ASSERT_NOT_EFI_ERROR (PointerQueueInsert (&Queue, &State));
+
+  UT_ASSERT_EQUAL (Queue.QueueDepth, 3);
+  UT_ASSERT_EQUAL (Queue.Stats.Coalesced, 98);
+
+  UT_ASSERT_NOT_EFI_ERROR (PointerQueueExtract (&Queue, &State));
+  UT_ASSERT_EQUAL (State.ActiveButtons, 1);
+  UT_ASSERT_EQUAL (State.CurrentX, 10);
+
+  UT_ASSERT_NOT_EFI_ERROR (PointerQueueExtract (&Queue, &State));
+  UT_ASSERT_EQUAL (State.ActiveButtons, 1);
+  UT_ASSERT_EQUAL (State.CurrentX, 109);
+
+  UT_ASSERT_NOT_EFI_ERROR (PointerQueueExtract (&Queue, &State));
+  UT_ASSERT_EQUAL (State.ActiveButtons, 0);
+  UT_ASSERT_EQUAL (State.CurrentX, 109);
+
+  UT_ASSERT_STATUS_EQUAL (PointerQueueExtract (&Queue, &State), EFI_NOT_FOUND);
+  UT_ASSERT_TRUE (Queue.bQueueEmpty);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Fills the queue with button transitions and verifies that moves are discarded first and that
+  an unconsumed queue full of transitions still delivers a consistent button sequence.
+
+  @param[in] Context    Unused.
+
+  @retval UNIT_TEST_PASSED    Test passed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+FullQueueNeverDropsQueuedTransitions (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MS_SWM_ABSOLUTE_POINTER_QUEUE  Queue;
+  MS_SWM_ABSOLUTE_POINTER_STATE  State;
+  MOCK_POINTER_CLIENT            Client;
+  UINTN                          Index;
+
+  ZeroMem (&Queue, sizeof (Queue));
+  ZeroMem (&Client, sizeof (Client));
+  ZeroMem (&State, sizeof (State));
+  PointerQueueReset (&Queue);
+
+  // Alternate presses and releases with a move after each so every other entry is a move.
+  //
+  for (Index = 0; Index < POINTER_STATE_INPUT_QUEUE_SIZE; Index++) {
+    State.ActiveButtons = (UINT32)((Index + 1) & 0x1);
+    State.CurrentX      = Index;
+    UT_ASSERT_NOT_EFI_ERROR (PointerQueueInsert (&Queue, &State));
+    State.CurrentX = Index + 1000;
+    UT_ASSERT_NOT_EFI_ERROR (PointerQueueInsert (&Queue, &State));
+  }
+
+  UT_ASSERT_EQUAL (Queue.QueueDepth, POINTER_STATE_INPUT_QUEUE_SIZE);
+  UT_ASSERT_EQUAL (Queue.Stats.Overflows, 0);
+  UT_ASSERT_TRUE (Queue.Stats.DroppedMoves > 0);
+
+  // One more transition than can be held is refused rather than overwriting an older one.
+  //
+  State.ActiveButtons ^= 0x1;
+  UT_ASSERT_STATUS_EQUAL (PointerQueueInsert (&Queue, &State), EFI_OUT_OF_RESOURCES);
+  UT_ASSERT_EQUAL (Queue.Stats.Overflows, 1);
+
+  while (MockClientDrainOne (&Queue, &Client)) {
+  }
+
+  UT_ASSERT_EQUAL (Client.Transitions, POINTER_STATE_INPUT_QUEUE_SIZE);
+  UT_ASSERT_EQUAL (Client.Buttons, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Verifies the statistics query returns a snapshot of the queue statistics and rejects NULL
+  arguments.
+
+  @param[in] Context    Unused.
+
+  @retval UNIT_TEST_PASSED    Test passed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+StatisticsAreQueryable (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MS_SWM_ABSOLUTE_POINTER_QUEUE  Queue;
+  MS_SWM_ABSOLUTE_POINTER_STATE  State;
+  MS_SWM_POINTER_QUEUE_STATS     Stats;
+  MS_SWM_POINTER_QUEUE_STATS     Later;
+
+  ZeroMem (&Queue, sizeof (Queue));
+  ZeroMem (&State, sizeof (State));
+  PointerQueueReset (&Queue);
+
+  // Press, drag twice (the second move coalesces into the first), then release.
+  //
+  State.ActiveButtons = 1;
+  UT_ASSERT_NOT_EFI_ERROR (PointerQueueInsert (&Queue, &State));
+  State.CurrentX = 10;
+  UT_ASSERT_NOT_EFI_ERROR (PointerQueueInsert (&Queue, &State));
+  State.CurrentX = 20;
+  UT_ASSERT_NOT_EFI_ERROR (PointerQueueInsert (&Queue, &State));
+  State.ActiveButtons = 0;
+  UT_ASSERT_NOT_EFI_ERROR (PointerQueueInsert (&Queue, &State));
+
+  UT_ASSERT_NOT_EFI_ERROR (PointerQueueGetStatistics (&Queue, &Stats));
+  UT_ASSERT_EQUAL (Stats.CurrentDepth, 3);
+  UT_ASSERT_EQUAL (Stats.MaxDepth, 3);
+  UT_ASSERT_EQUAL (Stats.Inserted, 3);
+  UT_ASSERT_EQUAL (Stats.Coalesced, 1);
+  UT_ASSERT_EQUAL (Stats.DroppedMoves, 0);
+  UT_ASSERT_EQUAL (Stats.Overflows, 0);
+
+  // The returned statistics are a copy; draining the queue only shows up in a new query.
+  //
+  while (!EFI_ERROR (PointerQueueExtract (&Queue, &State))) {
+  }
+
+  UT_ASSERT_EQUAL (Stats.CurrentDepth, 3);
+  UT_ASSERT_NOT_EFI_ERROR (PointerQueueGetStatistics (&Queue, &Later));
+  UT_ASSERT_EQUAL (Later.CurrentDepth, 0);
+  UT_ASSERT_EQUAL (Later.MaxDepth, 3);
+  UT_ASSERT_EQUAL (Later.Inserted, 3);
+
+  UT_ASSERT_STATUS_EQUAL (PointerQueueGetStatistics (NULL, &Stats), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (PointerQueueGetStatistics (&Queue, NULL), EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  pointer event queue and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      QueueSuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&QueueSuiteHandle, Framework, "SimpleWindowManagerDxe pointer event queue tests", "SimpleWindowManagerDxe.PointerQueue", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for QueueSuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (QueueSuiteHandle, "Flood from mock providers delivers every transition", "Flood", FloodDeliversEveryTransition, NULL, NULL, NULL);
+  AddTestCase (QueueSuiteHandle, "Drag is coalesced without moving the press", "DragCoalesce", DragKeepsPressLocation, NULL, NULL, NULL);
+  AddTestCase (QueueSuiteHandle, "Full queue never drops queued transitions", "Overflow", FullQueueNeverDropsQueuedTransitions, NULL, NULL, NULL);
+  AddTestCase (QueueSuiteHandle, "Statistics can be queried", "Statistics", StatisticsAreQueryable, NULL, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
@@ -109,6 +109,11 @@ InitializeWindowManagerContext (
   mSWM.MousePointer.Width   = MOUSE_POINTER_WIDTH_MEDIUM;
   mSWM.MousePointer.Height  = MOUSE_POINTER_HEIGHT_MEDIUM;
 
+  // Start scanning Absolute Pointer providers at the periodic rate.
+  //
+  mSWM.IdleScanCount = 0;
+  mSWM.bIdleScanRate = FALSE;
+
   return EFI_SUCCESS;
 }
 
@@ -383,6 +388,9 @@ SignalClient (
 /**
     Inserts the specified pointer event state into an aggregate event queue (FIFO).
 
+    Consecutive move-only events are coalesced into the newest queued position.  Button
+    state transitions are never dropped once queued.
+
     @param[in] PointerState         Pointer event to insert.
 
     @retval EFI_SUCCESS             Successfully inserted the event state.
@@ -395,40 +403,20 @@ InsertPointerEventIntoQueue (
   IN EFI_ABSOLUTE_POINTER_STATE  *PointerState
   )
 {
-  EFI_STATUS                     Status      = EFI_SUCCESS;
-  EFI_TPL                        PreviousTPL = 0;
-  MS_SWM_ABSOLUTE_POINTER_QUEUE  *Queue      = &Client->Queue;
+  EFI_STATUS  Status      = EFI_SUCCESS;
+  EFI_TPL     PreviousTPL = 0;
 
   // Raise the TPL to avoid race condition with the peek-extract routines.
   //
   PreviousTPL = gBS->RaiseTPL (TPL_NOTIFY);
 
-  // If queue input and output positions collide, there is a buffer overflow
-  //
-  if ((Queue->QueueInputPosition == Queue->QueueOutputPosition) && (FALSE == Queue->bQueueEmpty)) {
-    DEBUG ((DEBUG_WARN, "WARN [SWM]: Pointer event %p queue overflow!\r\n", Queue));
-    // Just throw the queue away and queue the next point
-  }
-
-  // Store pointer state data in the queue
-  //
-  Queue->PointerStateQueue[Queue->QueueInputPosition].CurrentX      = PointerState->CurrentX;
-  Queue->PointerStateQueue[Queue->QueueInputPosition].CurrentY      = PointerState->CurrentY;
-  Queue->PointerStateQueue[Queue->QueueInputPosition].CurrentZ      = 0;                                        // Z should always be 0.
-  Queue->PointerStateQueue[Queue->QueueInputPosition].ActiveButtons = (PointerState->ActiveButtons & 0x1);      // We only recognize the LSB.
-
-  // Increment the input position to the next slot and handle wrap-around
-  //
-  ++Queue->QueueInputPosition;
-  Queue->QueueInputPosition %= POINTER_STATE_INPUT_QUEUE_SIZE;
-
-  // No longer the first insertion
-  //
-  Queue->bQueueEmpty = FALSE;
+  Status = PointerQueueInsert (&Client->Queue, PointerState);
 
   // Signal Client
   //
-  SignalClient (Client);
+  if (!EFI_ERROR (Status)) {
+    SignalClient (Client);
+  }
 
   // Restore the TPL.
   //
@@ -454,29 +442,14 @@ PeekAtAbsolutePointerEventInQueue (
   OUT EFI_ABSOLUTE_POINTER_STATE  *PointerState
   )
 {
-  EFI_STATUS                     Status      = EFI_SUCCESS;
-  EFI_TPL                        PreviousTPL = 0;
-  MS_SWM_ABSOLUTE_POINTER_QUEUE  *Queue      = &Client->Queue;
+  EFI_STATUS  Status      = EFI_SUCCESS;
+  EFI_TPL     PreviousTPL = 0;
 
   // Raise the TPL to avoid race condition with the insert-extract routines.
   //
   PreviousTPL = gBS->RaiseTPL (TPL_NOTIFY);
 
-  // If the queue is empty, there's nothing to retrieve
-  //
-  if (TRUE == Queue->bQueueEmpty) {
-    Status = EFI_NOT_FOUND;
-    goto Exit;
-  }
-
-  // Retrieve a pointer event from the queue
-  //
-  PointerState->CurrentX      = Queue->PointerStateQueue[Queue->QueueOutputPosition].CurrentX;
-  PointerState->CurrentY      = Queue->PointerStateQueue[Queue->QueueOutputPosition].CurrentY;
-  PointerState->CurrentZ      = Queue->PointerStateQueue[Queue->QueueOutputPosition].CurrentZ;
-  PointerState->ActiveButtons = Queue->PointerStateQueue[Queue->QueueOutputPosition].ActiveButtons;
-
-Exit:
+  Status = PointerQueuePeek (&Client->Queue, PointerState);
 
   // Restore the TPL.
   //
@@ -502,42 +475,54 @@ ExtractAbsolutePointerEventFromQueue (
   OUT EFI_ABSOLUTE_POINTER_STATE  *PointerState
   )
 {
-  EFI_STATUS                     Status      = EFI_SUCCESS;
-  EFI_TPL                        PreviousTPL = 0;
-  MS_SWM_ABSOLUTE_POINTER_QUEUE  *Queue      = &Client->Queue;
+  EFI_STATUS  Status      = EFI_SUCCESS;
+  EFI_TPL     PreviousTPL = 0;
 
   // Raise the TPL to avoid race condition with the peek-insert routines.
   //
   PreviousTPL = gBS->RaiseTPL (TPL_NOTIFY);
 
-  // If the queue is empty, there's nothing to retrieve
+  Status = PointerQueueExtract (&Client->Queue, PointerState);
+
+  // If there is more data in the queue, let the client know.
   //
-  if (TRUE == Queue->bQueueEmpty) {
-    Status = EFI_NOT_FOUND;
-    goto Exit;
+  if (!EFI_ERROR (Status) && (FALSE == Client->Queue.bQueueEmpty)) {
+    SignalClient (Client);
   }
 
-  // Retrieve a pointer event from the queue
+  // Restore the TPL.
   //
-  PointerState->CurrentX      = Queue->PointerStateQueue[Queue->QueueOutputPosition].CurrentX;
-  PointerState->CurrentY      = Queue->PointerStateQueue[Queue->QueueOutputPosition].CurrentY;
-  PointerState->CurrentZ      = Queue->PointerStateQueue[Queue->QueueOutputPosition].CurrentZ;
-  PointerState->ActiveButtons = Queue->PointerStateQueue[Queue->QueueOutputPosition].ActiveButtons;
+  if (PreviousTPL) {
+    gBS->RestoreTPL (PreviousTPL);
+  }
 
-  // Increment the output position to the next slot and handle wrap-around
-  //
-  ++Queue->QueueOutputPosition;
-  Queue->QueueOutputPosition %= POINTER_STATE_INPUT_QUEUE_SIZE;
+  return Status;
+}
+
+/**
+    Retrieves the pointer event queue statistics for a client.
+
+    @param[in]  Client              Client whose queue statistics are requested.
+    @param[out] Stats               Statistics to be filled in.
 
-  // If queue input and output positions are the same, the queue is empty
+    @retval EFI_SUCCESS             Successfully retrieved the statistics.
+    @retval EFI_INVALID_PARAMETER   Stats is NULL.
+
+**/
+EFI_STATUS
+GetPointerQueueStatistics (
+  IN  WINMGR_CLIENT               *Client,
+  OUT MS_SWM_POINTER_QUEUE_STATS  *Stats
+  )
+{
+  EFI_STATUS  Status      = EFI_SUCCESS;
+  EFI_TPL     PreviousTPL = 0;
+
+  // Raise the TPL to avoid race condition with the insert-extract routines.
   //
-  if (Queue->QueueInputPosition == Queue->QueueOutputPosition) {
-    Queue->bQueueEmpty = TRUE;
-  } else {
-    SignalClient (Client);
-  }
+  PreviousTPL = gBS->RaiseTPL (TPL_NOTIFY);
 
-Exit:
+  Status = PointerQueueGetStatistics (&Client->Queue, Stats);
 
   // Restore the TPL.
   //
@@ -890,6 +875,44 @@ Exit:
   return Status;
 }
 
+/**
+    Adjusts the watchlist scan rate.  After a period without pointer input the watchlist is
+    scanned at the idle rate, and the periodic rate is restored as soon as input is seen again.
+
+    @param[in] InputSeen            TRUE = the last scan found pointer input.
+
+    @retval None.
+
+**/
+static VOID
+UpdateWatchListScanRate (
+  IN BOOLEAN  InputSeen
+  )
+{
+  EFI_STATUS  Status;
+
+  if (InputSeen) {
+    mSWM.IdleScanCount = 0;
+    if (FALSE == mSWM.bIdleScanRate) {
+      return;
+    }
+
+    mSWM.bIdleScanRate = FALSE;
+    Status             = gBS->SetTimer (mSWMWatchListTimerEvent, TimerPeriodic, PERIODIC_REFRESH_INTERVAL);
+  } else {
+    if ((TRUE == mSWM.bIdleScanRate) || (++mSWM.IdleScanCount < IDLE_REFRESH_TICK_THRESHOLD)) {
+      return;
+    }
+
+    mSWM.bIdleScanRate = TRUE;
+    Status             = gBS->SetTimer (mSWMWatchListTimerEvent, TimerPeriodic, IDLE_REFRESH_INTERVAL);
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "ERROR [SWM]: Failed to change provider watchlist scanning rate.  Status = %r\r\n", Status));
+  }
+}
+
 /**
     Timer Callback that Polls the Absolute Pointer provider watchlist for incoming pointer events,
     and Queues them to the proper queue.
@@ -911,6 +934,7 @@ CheckWatchListCallback (
   WINMGR_AP_WATCHLIST  *pList = mSWM.AbsolutePointerProviders;
   WINMGR_CLIENT        *Client;
   UINTN                ScreenMaxX, ScreenMaxY;
+  BOOLEAN              InputSeen = FALSE;
 
   // Get screen coordinate space maximums.
   //
@@ -941,6 +965,8 @@ CheckWatchListCallback (
                                          );
 
       if (!EFI_ERROR (Status)) {
+        InputSeen = TRUE;
+
         // Conditionally filter the raw pointer event.  For now, don't filter mouse pointer events (only touch).
         //
         if ((FALSE == pList->bNeedsMousePointer) && (TRUE == FilterPointerEvent (&PointerState, pList->AbsolutePointer->Mode))) {
@@ -1012,6 +1038,8 @@ CheckWatchListCallback (
     //
     pList = pList->pNext;
   }
+
+  UpdateWatchListScanRate (InputSeen);
 }
 
 /**
@@ -40,12 +40,14 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/MsColorTableLib.h>
 
 #include "SimpleWindowManagerProtocol.h"
+#include "PointerEventQueue.h"
 
 // ****** Preprocessor constants ******
 //
 
-#define POINTER_STATE_INPUT_QUEUE_SIZE  50                                  // Depth of aggregate pointer event queue.
 #define PERIODIC_REFRESH_INTERVAL       (5 * 10 * 1000)                     // Interval for scanning AP providers: 5ms in 100ns units.
+#define IDLE_REFRESH_INTERVAL           (50 * 10 * 1000)                    // Interval for scanning AP providers while idle: 50ms in 100ns units.
+#define IDLE_REFRESH_TICK_THRESHOLD     200                                 // Consecutive idle scans (1s at the periodic rate) before switching to the idle rate.
 
 #define SWM_POINTER_EVENT_FILTER_BOX_SIZE_PERCENT  50                       // Filter window in fraction of a percent (0.50%) of the absolute pointer maximum width.
 
@@ -53,15 +55,6 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 extern EFI_HII_HANDLE             mSWMHiiHandle;
 extern EFI_ABSOLUTE_POINTER_MODE  mAbsPointerMode;
 
-// Pointer state event input queue (holds pointer event data until consumer reads them out, FIFO)
-//
-typedef struct {
-  BOOLEAN                          bQueueEmpty;
-  UINTN                            QueueInputPosition;
-  UINTN                            QueueOutputPosition;
-  MS_SWM_ABSOLUTE_POINTER_STATE    PointerStateQueue[POINTER_STATE_INPUT_QUEUE_SIZE];
-} MS_SWM_ABSOLUTE_POINTER_QUEUE;
-
 // ****** Function prototypes ******
 //
 
@@ -346,6 +339,8 @@ typedef struct _WINMGR_CONTEXT_tag {
   // List of Absolute Pointer protocol providers to watch & aggregate
   //
   WINMGR_AP_WATCHLIST                  *AbsolutePointerProviders;
+  UINTN                                IdleScanCount;       // Consecutive watchlist scans that found no pointer input.
+  BOOLEAN                              bIdleScanRate;       // TRUE = watchlist is being scanned at the idle rate.
 
   // List of clients supported by the window manager
   //
@@ -403,4 +398,20 @@ ExtractAbsolutePointerEventFromQueue (
   OUT MS_SWM_ABSOLUTE_POINTER_STATE  *pPointerState
   );
 
+/**
+    Retrieves the pointer event queue statistics for a client.
+
+    @param[in]  Client              Client whose queue statistics are requested.
+    @param[out] Stats               Statistics to be filled in.
+
+    @retval EFI_SUCCESS             Successfully retrieved the statistics.
+    @retval EFI_INVALID_PARAMETER   Stats is NULL.
+
+**/
+EFI_STATUS
+GetPointerQueueStatistics (
+  IN  WINMGR_CLIENT               *Client,
+  OUT MS_SWM_POINTER_QUEUE_STATS  *Stats
+  );
+
 #endif // _WINDOW_MANAGER_H_
@@ -21,7 +21,8 @@ EFI_ACPI_TABLE_PROTOCOL  *mAcpiTableProtocol = NULL;
 
 /**
 
-Identify different sections in CPER and send each to AddCperSectionToBert.
+Identify different sections in CPER and add each one, as a generic
+data entry, to the BERT Boot Error Region.
 
 @return FALSE if BootErrorRegion is out of space
 
@@ -45,8 +46,17 @@ BertAddAllCperSections (
   CperHdr        = (EFI_COMMON_ERROR_RECORD_HEADER *)ErrorData;
   CperErrSecDscp = (EFI_ERROR_SECTION_DESCRIPTOR *)(CperHdr + 1);
 
-  do {
-    if (!BertAddCperSection (Bert, CperHdr, CperErrSecDscp)) {
+  while (Index < CperHdr->SectionCount) {
+    if (!BertErrorBlockAddErrorData (
+           (VOID *)Bert->BootErrorRegion,
+           Bert->BootErrorRegionLength,
+           &CperErrSecDscp->SectionType,
+           (VOID *)(((UINT8 *)CperHdr) + (CperErrSecDscp->SectionOffset)),
+           CperErrSecDscp->SectionLength,
+           CperErrSecDscp->Severity,
+           TRUE // correctable
+           ))
+    {
       // Boot Error Region is out of space!
       return FALSE;
     }
@@ -54,41 +64,16 @@ BertAddAllCperSections (
     CperErrSecDscp++;
     Index++;
     DEBUG ((DEBUG_VERBOSE, "%a %d - Section %d of %d \n", __FUNCTION__, __LINE__, Index, CperHdr->SectionCount));
-  } while (Index < CperHdr->SectionCount);
+  }
 
   return TRUE;
 }
 
 /**
 
-Take CPER header and section descriptor,
-use that to form a generic data entry,
-then stuff that entry in BERT Boot Error Region.
-
-**/
-BOOLEAN
-EFIAPI
-BertAddCperSection (
-  IN EFI_ACPI_6_1_BOOT_ERROR_RECORD_TABLE_HEADER  *Bert,
-  IN EFI_COMMON_ERROR_RECORD_HEADER               *CperHdr,
-  IN EFI_ERROR_SECTION_DESCRIPTOR                 *CperErrSecDscp
-  )
-{
-  return BertErrorBlockAddErrorData (
-           (VOID *)Bert->BootErrorRegion,
-           Bert->BootErrorRegionLength,
-           &CperErrSecDscp->SectionType,
-           (VOID *)(((UINT8 *)CperHdr) + (CperErrSecDscp->SectionOffset)),
-           CperErrSecDscp->SectionLength,
-           CperErrSecDscp->Severity,
-           TRUE // correctable
-           );
-}
-
-/**
-
 Allocate and populate EFI_ACPI_6_1_BOOT_ERROR_RECORD_TABLE_HEADER
-in the BERT_CONTEXT that was provided.
+in the BERT_CONTEXT that was provided. BertHeader is left NULL if
+either allocation fails.
 
 **/
 VOID
@@ -102,8 +87,22 @@ BertHeaderCreator (
     return;
   }
 
-  Context->BertHeader                         = AllocateZeroPool (sizeof (EFI_ACPI_6_1_BOOT_ERROR_RECORD_TABLE_HEADER));
-  Context->Block                              = AllocateReservedZeroPool (ErrorBlockSize);
+  Context->BertHeader = AllocateZeroPool (sizeof (EFI_ACPI_6_1_BOOT_ERROR_RECORD_TABLE_HEADER));
+  Context->Block      = AllocateReservedZeroPool (ErrorBlockSize);
+  if ((Context->BertHeader == NULL) || (Context->Block == NULL)) {
+    if (Context->BertHeader != NULL) {
+      FreePool (Context->BertHeader);
+      Context->BertHeader = NULL;
+    }
+
+    if (Context->Block != NULL) {
+      FreePool (Context->Block);
+      Context->Block = NULL;
+    }
+
+    return;
+  }
+
   Context->BlockSize                          = ErrorBlockSize;
   Context->BertHeader->Header.Signature       = EFI_ACPI_6_1_BOOT_ERROR_RECORD_TABLE_SIGNATURE;
   Context->BertHeader->Header.Length          = sizeof (EFI_ACPI_6_1_BOOT_ERROR_RECORD_TABLE_HEADER);
@@ -246,19 +245,19 @@ BertErrorBlockAddErrorData (
                                                               BlockHeader->DataLength);
 
   // Setup Entry header
-  gBS->SetMem (Entry, sizeof (EFI_ACPI_6_1_GENERIC_ERROR_DATA_ENTRY_STRUCTURE), 0);
-  gBS->CopyMem (&Entry->SectionType, Guid, sizeof (EFI_GUID));
+  ZeroMem (Entry, sizeof (EFI_ACPI_6_1_GENERIC_ERROR_DATA_ENTRY_STRUCTURE));
+  CopyMem (&Entry->SectionType, Guid, sizeof (EFI_GUID));
   Entry->ErrorSeverity   = ErrorSeverity;
   Entry->Revision        = EFI_ACPI_6_1_GENERIC_ERROR_DATA_ENTRY_REVISION;
   Entry->ErrorDataLength = SizeOfGenericErrorData;
 
   // Copy data right after header
   GenericErrorDataFollowEntry = (VOID *)(Entry + 1);
-  gBS->CopyMem (
-         GenericErrorDataFollowEntry,
-         GenericErrorData,
-         SizeOfGenericErrorData
-         );
+  CopyMem (
+    GenericErrorDataFollowEntry,
+    GenericErrorData,
+    SizeOfGenericErrorData
+    );
 
   // Setup the header with the new size
   BlockHeader->DataLength = ExpectedNewDataLength;
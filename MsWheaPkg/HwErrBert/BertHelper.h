@@ -12,7 +12,6 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 //
 // ACPI table information used to initialize tables.
 //
-#define BOOT_ERROR_REGION_SIZE       0x1000
 #define EFI_HW_ERR_REC_VAR_NAME      L"HwErrRec"
 #define EFI_HW_ERR_REC_VAR_NAME_LEN  13       // Buffer length covers at least "HwErrRec####\0"
 
@@ -65,14 +64,6 @@ BertErrorBlockAddErrorData (
   IN BOOLEAN   Correctable
   );
 
-BOOLEAN
-EFIAPI
-BertAddCperSection (
-  IN EFI_ACPI_6_1_BOOT_ERROR_RECORD_TABLE_HEADER  *Bert,
-  IN EFI_COMMON_ERROR_RECORD_HEADER               *CperHdr,
-  IN EFI_ERROR_SECTION_DESCRIPTOR                 *CperErrSecDscp
-  );
-
 BOOLEAN
 EFIAPI
 BertAddAllCperSections (
@@ -24,10 +24,158 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Uefi.h>
 #include "BertHelper.h"
 
+#define BERT_NAME_LIST_INITIAL  (16 * EFI_HW_ERR_REC_VAR_NAME_LEN)
+#define BERT_SIZE_LIST_INITIAL  16
+
+//
+// Each CPER section becomes a generic error data entry in the Boot Error Region. The entry
+// header takes no more room than the section descriptor it replaces, so a record never needs
+// more of the region than it takes past its own header.
+//
+STATIC_ASSERT (
+  sizeof (EFI_ACPI_6_1_GENERIC_ERROR_DATA_ENTRY_STRUCTURE) <= sizeof (EFI_ERROR_SECTION_DESCRIPTOR),
+  "Generic error data entry does not fit in the room of a section descriptor"
+  );
+
 STATIC EFI_EVENT  mExitBootServicesEvent = NULL;
 STATIC EFI_EVENT  mReadyToBootEvent      = NULL;
 UINT16            mVarNameListCount      = 0;
 CHAR16            *mVarNameList          = NULL;
+STATIC UINTN      mVarNameListLength     = 0;   // CHAR16s used in mVarNameList
+STATIC UINTN      mVarNameListCapacity   = 0;   // CHAR16s allocated for mVarNameList
+STATIC UINTN      *mVarSizeList          = NULL;  // Size of each variable in mVarNameList
+STATIC VOID       **mVarDataList         = NULL;  // Copy of the data of each variable in mVarNameList
+STATIC UINTN      mVarSizeListCapacity   = 0;   // Entries allocated for mVarSizeList and mVarDataList
+
+/**
+
+Append a variable name, the size of its data and a copy of the data to mVarNameList,
+mVarSizeList and mVarDataList. The lists grow geometrically, so building them costs
+time linear in the number of variables found.
+
+@param[in] Name                 Name of the variable.
+@param[in] Data                 Data of the variable.
+@param[in] Size                 Size of the variable data.
+
+@retval EFI_SUCCESS             The variable was added.
+@retval EFI_OUT_OF_RESOURCES    The lists could not be grown.
+
+**/
+STATIC
+EFI_STATUS
+AddVariableToList (
+  IN CONST CHAR16  *Name,
+  IN CONST VOID    *Data,
+  IN UINTN         Size
+  )
+{
+  UINTN   NameLength;
+  UINTN   Capacity;
+  CHAR16  *NewNameList;
+  UINTN   *NewSizeList;
+  VOID    **NewDataList;
+  VOID    *DataCopy;
+
+  if (mVarNameListCount == MAX_UINT16) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  NameLength = StrLen (Name) + 1;
+  if (mVarNameListLength + NameLength > mVarNameListCapacity) {
+    Capacity = MAX (mVarNameListCapacity * 2, BERT_NAME_LIST_INITIAL);
+    Capacity = MAX (Capacity, mVarNameListLength + NameLength);
+
+    NewNameList = ReallocatePool (
+                    mVarNameListCapacity * sizeof (CHAR16),
+                    Capacity * sizeof (CHAR16),
+                    mVarNameList
+                    );
+    if (NewNameList == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    mVarNameList         = NewNameList;
+    mVarNameListCapacity = Capacity;
+  }
+
+  if (mVarNameListCount == mVarSizeListCapacity) {
+    Capacity    = MAX (mVarSizeListCapacity * 2, BERT_SIZE_LIST_INITIAL);
+    NewSizeList = ReallocatePool (
+                    mVarSizeListCapacity * sizeof (UINTN),
+                    Capacity * sizeof (UINTN),
+                    mVarSizeList
+                    );
+    if (NewSizeList == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    mVarSizeList = NewSizeList;
+
+    NewDataList = ReallocatePool (
+                    mVarSizeListCapacity * sizeof (VOID *),
+                    Capacity * sizeof (VOID *),
+                    mVarDataList
+                    );
+    if (NewDataList == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    mVarDataList         = NewDataList;
+    mVarSizeListCapacity = Capacity;
+  }
+
+  DataCopy = AllocateCopyPool (Size, Data);
+  if (DataCopy == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  CopyMem (&mVarNameList[mVarNameListLength], Name, NameLength * sizeof (CHAR16));
+  mVarNameListLength             += NameLength;
+  mVarSizeList[mVarNameListCount] = Size;
+  mVarDataList[mVarNameListCount] = DataCopy;
+  mVarNameListCount++;
+
+  return EFI_SUCCESS;
+}
+
+/**
+
+Free mVarNameList, mVarSizeList, mVarDataList and the data copies, and leave
+them empty.
+
+**/
+STATIC
+VOID
+FreeVariableList (
+  VOID
+  )
+{
+  UINTN  Index;
+
+  if (mVarDataList != NULL) {
+    for (Index = 0; Index < mVarNameListCount; Index++) {
+      FreePool (mVarDataList[Index]);
+    }
+
+    FreePool (mVarDataList);
+  }
+
+  if (mVarNameList != NULL) {
+    FreePool (mVarNameList);
+  }
+
+  if (mVarSizeList != NULL) {
+    FreePool (mVarSizeList);
+  }
+
+  mVarNameList         = NULL;
+  mVarNameListCount    = 0;
+  mVarNameListLength   = 0;
+  mVarNameListCapacity = 0;
+  mVarSizeList         = NULL;
+  mVarDataList         = NULL;
+  mVarSizeListCapacity = 0;
+}
 
 /**
 
@@ -35,16 +183,22 @@ Create and publish Boot Error Runtime Table.
 Gather variables in mVarNameList and add them
 to the BootErrorRegion of the BERT table.
 
+GenerateVariableList already read each variable, so the Boot Error
+Region is allocated once at the size it needs, and the records are
+added from the copies kept on the list without reading them again.
+
 **/
 VOID
 EFIAPI
 SetupBert (
   )
 {
-  UINTN         Size     = 0;
-  UINTN         NameSize = 0;
-  CHAR16        *NamePtr = NULL;
-  VOID          *Buffer  = NULL;
+  UINTN         Index;
+  UINTN         Size;
+  UINTN         RegionSize;
+  UINTN         NameSize;
+  CHAR16        *NamePtr;
+  VOID          *Record;
   EFI_STATUS    Status;
   BERT_CONTEXT  Context;
 
@@ -55,76 +209,61 @@ SetupBert (
 
   DEBUG ((DEBUG_VERBOSE, "%a - %x CPER entries to publish to BERT\n", __FUNCTION__, mVarNameListCount));
 
+  RegionSize = sizeof (EFI_ACPI_6_1_GENERIC_ERROR_STATUS_STRUCTURE);
+  for (Index = 0; Index < mVarNameListCount; Index++) {
+    if (mVarSizeList[Index] > sizeof (EFI_COMMON_ERROR_RECORD_HEADER)) {
+      RegionSize += mVarSizeList[Index] - sizeof (EFI_COMMON_ERROR_RECORD_HEADER);
+    }
+  }
+
+  if (RegionSize > MAX_UINT32) {
+    DEBUG ((DEBUG_ERROR, "%a - %x CPER entries do not fit in a boot error region\n", __FUNCTION__, mVarNameListCount));
+    return;
+  }
+
   // Create & publish BERT Header
-  BertHeaderCreator (&Context, BOOT_ERROR_REGION_SIZE);
+  BertHeaderCreator (&Context, (UINT32)RegionSize);
+  if (Context.BertHeader == NULL) {
+    DEBUG ((DEBUG_ERROR, "%a - out of memory", __FUNCTION__));
+    goto Exit;
+  }
+
   BertErrorBlockInitial (Context.Block, EFI_ACPI_6_2_ERROR_SEVERITY_CORRECTED);
   Status = BertSetAcpiTable (&Context);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "Publishing BERT ACPI table failed\n"));
-    return;
+    goto Exit;
   }
 
   // Iterate through the list of variable names
   NamePtr = mVarNameList;
-  for (UINTN Index = 0; Index < mVarNameListCount; Index++) {
-    Size     = 0;
-    Buffer   = NULL;
+  for (Index = 0; Index < mVarNameListCount; Index++) {
+    Size     = mVarSizeList[Index];
+    Record   = mVarDataList[Index];
     NameSize = StrLen (NamePtr) + 1;
     DEBUG ((DEBUG_VERBOSE, "%a - Publishing %s\n", __FUNCTION__, NamePtr));
 
-    //
-    // Call, get variable size; call again, get variable
-    //
-    Status = gRT->GetVariable (
-                    NamePtr,
-                    &gEfiHardwareErrorVariableGuid,
-                    NULL,
-                    &Size,
-                    NULL
-                    );
-
-    if (Status != EFI_BUFFER_TOO_SMALL) {
-      DEBUG ((DEBUG_ERROR, "%a - %s 0 size GetVariable returned %r\n", __FUNCTION__, NamePtr, Status));
-      ASSERT (FALSE);
-      NamePtr += NameSize;
-      continue;
+    if (!ValidateCperHeader ((EFI_COMMON_ERROR_RECORD_HEADER *)Record, Size)) {
+      DEBUG ((DEBUG_ERROR, "%a: CPER was deemed unsafe - %s\n", __FUNCTION__, NamePtr));
+      goto Exit;
     }
 
-    Buffer = AllocateZeroPool (Size);
-    if (Buffer == NULL) {
-      DEBUG ((DEBUG_ERROR, "%a - out of memory", __FUNCTION__));
-      return;
-    }
-
-    Status = gRT->GetVariable (
-                    NamePtr,
-                    &gEfiHardwareErrorVariableGuid,
-                    NULL,
-                    &Size,
-                    Buffer
-                    );
-
-    if (!EFI_ERROR (Status) && ValidateCperHeader ((EFI_COMMON_ERROR_RECORD_HEADER *)Buffer, Size)) {
-      // We got a CPER, time to add it to BERT!
-      if (!BertAddAllCperSections (Context.BertHeader, Buffer)) {
-        DEBUG ((DEBUG_ERROR, "Ran out of space in BERT boot error region\n"));
-        FreePool (Buffer);
-        return;
-      }
-    } else {
-      DEBUG ((DEBUG_ERROR, "%a: Variable failed or CPER was deemed unsafe - %r\n", __FUNCTION__, Status));
-      FreePool (Buffer);
-      return;
-    }
-
-    if (Buffer) {
-      FreePool (Buffer);
+    // We got a CPER, time to add it to BERT!
+    if (!BertAddAllCperSections (Context.BertHeader, Record)) {
+      DEBUG ((DEBUG_ERROR, "Ran out of space in BERT boot error region\n"));
+      goto Exit;
     }
 
     NamePtr += NameSize;
   }
 
   DEBUG ((DEBUG_INFO, "%a - All variables added to BERT successfully.\n", __FUNCTION__));
+
+Exit:
+  // InstallAcpiTable keeps a copy of the header
+  if (Context.BertHeader != NULL) {
+    FreePool (Context.BertHeader);
+  }
 }
 
 /**
@@ -132,6 +271,11 @@ SetupBert (
 Go through variables on flash and find
 variables with GUID gEfiHardwareErrorVariableGuid.
 
+The names are walked once. Only the variables with the right
+GUID are read, each with a single GetVariable call into a buffer
+of PcdMaxHardwareErrorVariableSize, and a copy of each is kept
+for SetupBert.
+
 **/
 VOID
 EFIAPI
@@ -147,14 +291,22 @@ GenerateVariableList (
   UINTN       BertVarsSize;
   UINTN       Offset = 0;
   CHAR16      *CurrentName;
-  UINTN       CurrentSize         = 0;
-  UINTN       VarNameUnicodeCount = 0;
-  UINTN       DummyVarSize;
+  UINTN       CurrentSize = 0;
+  UINTN       VarSize;
+  VOID        *ReadBuffer;
+  UINTN       ReadBufferSize;
 
   DEBUG ((DEBUG_VERBOSE, "%a enter\n", __FUNCTION__));
 
-  NameSize = sizeof (CHAR16);
-  Name     = AllocateZeroPool (NameSize);
+  ReadBufferSize = PcdGet32 (PcdMaxHardwareErrorVariableSize);
+  ReadBuffer     = AllocatePool (ReadBufferSize);
+  NameSize       = sizeof (CHAR16);
+  Name           = AllocateZeroPool (NameSize);
+  if ((ReadBuffer == NULL) || (Name == NULL)) {
+    DEBUG ((DEBUG_ERROR, "%a - out of memory\n", __FUNCTION__));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto cleanup;
+  }
 
   // Go through all the variables on flash, only when the HwErrRec is not supported
   while (!PcdGetBool (PcdVariableHardwareErrorRecordAttributeSupported)) {
@@ -187,21 +339,21 @@ GenerateVariableList (
       continue;
     }
 
+    // Read the record once, SetupBert uses the copy kept on the list
+    VarSize = ReadBufferSize;
+    Status  = gRT->GetVariable (Name, &gEfiHardwareErrorVariableGuid, NULL, &VarSize, ReadBuffer);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a - %s GetVariable returned %r\n", __FUNCTION__, Name, Status));
+      continue;
+    }
+
     // Add this variable to the array
     DEBUG ((DEBUG_ERROR, "%a - found %s\n", __FUNCTION__, Name));
-    mVarNameList = ReallocatePool (
-                     mVarNameListCount * EFI_HW_ERR_REC_VAR_NAME_LEN * sizeof (CHAR16),
-                     (mVarNameListCount + 1) * EFI_HW_ERR_REC_VAR_NAME_LEN * sizeof (CHAR16),
-                     mVarNameList
-                     );
-    if (mVarNameList == NULL) {
+    Status = AddVariableToList (Name, ReadBuffer, VarSize);
+    if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "%a - %d\n", __FUNCTION__, __LINE__));
-      Status = EFI_OUT_OF_RESOURCES;
       goto cleanup;
     }
-
-    StrCpyS (&mVarNameList[mVarNameListCount * EFI_HW_ERR_REC_VAR_NAME_LEN], StrLen (Name) + 1, Name);
-    mVarNameListCount++;
   }
 
   // Only check potential extra variable CPER errors when HwErrRec works properly
@@ -233,31 +385,25 @@ GenerateVariableList (
           break;
         }
 
-        DummyVarSize = 0;
-        Status       = gRT->GetVariable (
-                              CurrentName,
-                              &gEfiHardwareErrorVariableGuid,
-                              NULL,
-                              &DummyVarSize,
-                              NULL
-                              );
-
-        if (Status == EFI_BUFFER_TOO_SMALL) {
-          // Make room for populated variables
-          mVarNameList = ReallocatePool (
-                           VarNameUnicodeCount * sizeof (CHAR16),
-                           VarNameUnicodeCount * sizeof (CHAR16) + CurrentSize,
-                           mVarNameList
-                           );
-          if (mVarNameList == NULL) {
+        VarSize = ReadBufferSize;
+        Status  = gRT->GetVariable (
+                         CurrentName,
+                         &gEfiHardwareErrorVariableGuid,
+                         NULL,
+                         &VarSize,
+                         ReadBuffer
+                         );
+
+        if (!EFI_ERROR (Status)) {
+          // Note populated variables along with their data
+          Status = AddVariableToList (CurrentName, ReadBuffer, VarSize);
+          if (EFI_ERROR (Status)) {
             DEBUG ((DEBUG_ERROR, "%a - %d\n", __FUNCTION__, __LINE__));
-            Status = EFI_OUT_OF_RESOURCES;
             goto cleanup;
           }
-
-          StrCpyS (&mVarNameList[VarNameUnicodeCount], CurrentSize / sizeof (CHAR16), CurrentName);
-          VarNameUnicodeCount += CurrentSize / sizeof (CHAR16);
-          mVarNameListCount++;
+        } else if (Status == EFI_BUFFER_TOO_SMALL) {
+          // Larger than any hardware error record may be
+          DEBUG ((DEBUG_ERROR, "%a - %s is larger than PcdMaxHardwareErrorVariableSize\n", __FUNCTION__, CurrentName));
         } else if (Status != EFI_NOT_FOUND) {
           // The expected variable is not populated
           DEBUG ((DEBUG_ERROR, "%a Unexpected result when querying variable status - %r\n", __FUNCTION__, Status));
@@ -284,11 +430,14 @@ cleanup:
     FreePool (BertVars);
   }
 
+  if (ReadBuffer != NULL) {
+    FreePool (ReadBuffer);
+  }
+
   if (EFI_ERROR (Status)) {
     // Shouldn't be happening... but we can cleanup anyways
     ASSERT (FALSE);
-    mVarNameListCount = 0;
-    mVarNameList      = NULL;
+    FreeVariableList ();
   }
 
   DEBUG ((DEBUG_INFO, "%a found %x variables for the BERT table - %r\n", __FUNCTION__, mVarNameListCount, Status));
@@ -355,10 +504,7 @@ ExitBootServicesHandlerCallback (
 
   // Delete all variables in the array because they have been published
   ClearVariables ();
-
-  if (mVarNameList) {
-    FreePool (mVarNameList);
-  }
+  FreeVariableList ();
 
   return;
 }
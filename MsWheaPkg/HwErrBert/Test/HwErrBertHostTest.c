@@ -0,0 +1,713 @@
+/** @file -- HwErrBertHostTest.c
+Host-based UnitTest for the HwErrBert driver.
+
+The stand-in variable store holds HwErrRecs among many other variables and counts the calls
+made to the variable services, so each test can check how much work building the BERT took,
+as well as the table that was published.
+
+Copyright (c) Microsoft Corporation
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+
+#include <Guid/Cper.h>
+#include <IndustryStandard/Acpi.h>
+#include <Protocol/AcpiTable.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../BertHelper.h"
+
+#define UNIT_TEST_NAME     "HwErrBert Unit Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define MOCK_MAX_VARIABLES   600
+#define MOCK_OTHER_COUNT     400      // Variables under other GUIDs
+#define MOCK_RECORD_EVERY    17       // One HwErrRec among this many variables
+#define MOCK_NAME_LENGTH     32
+
+typedef struct {
+  CHAR16      Name[MOCK_NAME_LENGTH];
+  EFI_GUID    Guid;
+  UINT8       *Data;
+  UINTN       Size;
+} MOCK_VARIABLE;
+
+//
+// Prototypes of the driver functions under test.
+//
+VOID
+EFIAPI
+GenerateVariableList (
+  );
+
+VOID
+EFIAPI
+SetupBert (
+  );
+
+VOID
+EFIAPI
+ExitBootServicesHandlerCallback (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  );
+
+extern UINT16  mVarNameListCount;
+
+STATIC EFI_GUID  mOtherGuid = {
+  0x2d4e7f3a, 0x9b61, 0x4c5e, { 0xa0, 0x8f, 0x31, 0x6d, 0xc2, 0x47, 0x5b, 0xe9 }
+};
+
+STATIC EFI_GUID  mSectionGuid = {
+  0x00000000, 0x5c1f, 0x4a8d, { 0x96, 0x21, 0x7e, 0x0b, 0x3a, 0xd4, 0x18, 0x6c }
+};
+
+STATIC MOCK_VARIABLE  *mVariables;
+STATIC UINTN          mVariableCount;
+STATIC UINT32         mSectionSerial;
+STATIC UINTN          mRecordCount;
+
+STATIC UINTN  mNextNameCalls;
+STATIC UINTN  mGetVariableCalls;
+STATIC UINTN  mSetVariableCalls;
+STATIC UINTN  mInstallCalls;
+
+STATIC EFI_ACPI_6_1_BOOT_ERROR_RECORD_TABLE_HEADER  mInstalledBert;
+
+/**
+  Looks up a variable of the stand-in store.
+**/
+STATIC
+MOCK_VARIABLE *
+FindVariable (
+  IN CONST CHAR16    *Name,
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < mVariableCount; Index++) {
+    if (CompareGuid (&mVariables[Index].Guid, Guid) && (StrCmp (mVariables[Index].Name, Name) == 0)) {
+      return &mVariables[Index];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Stands in for gRT->GetVariable.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockGetVariable (
+  IN     CHAR16    *VariableName,
+  IN     EFI_GUID  *VendorGuid,
+  OUT    UINT32    *Attributes OPTIONAL,
+  IN OUT UINTN     *DataSize,
+  OUT    VOID      *Data OPTIONAL
+  )
+{
+  MOCK_VARIABLE  *Variable;
+
+  mGetVariableCalls++;
+
+  Variable = FindVariable (VariableName, VendorGuid);
+  if (Variable == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  if ((*DataSize < Variable->Size) || (Data == NULL)) {
+    *DataSize = Variable->Size;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  *DataSize = Variable->Size;
+  CopyMem (Data, Variable->Data, Variable->Size);
+  return EFI_SUCCESS;
+}
+
+/**
+  Stands in for gRT->GetNextVariableName.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockGetNextVariableName (
+  IN OUT UINTN     *VariableNameSize,
+  IN OUT CHAR16    *VariableName,
+  IN OUT EFI_GUID  *VendorGuid
+  )
+{
+  MOCK_VARIABLE  *Variable;
+  UINTN          Next;
+  UINTN          Size;
+
+  mNextNameCalls++;
+
+  if (VariableName[0] == L'\0') {
+    Next = 0;
+  } else {
+    Variable = FindVariable (VariableName, VendorGuid);
+    if (Variable == NULL) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Next = (Variable - mVariables) + 1;
+  }
+
+  if (Next >= mVariableCount) {
+    return EFI_NOT_FOUND;
+  }
+
+  Size = StrSize (mVariables[Next].Name);
+  if (*VariableNameSize < Size) {
+    *VariableNameSize = Size;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  *VariableNameSize = Size;
+  CopyMem (VariableName, mVariables[Next].Name, Size);
+  CopyGuid (VendorGuid, &mVariables[Next].Guid);
+  return EFI_SUCCESS;
+}
+
+/**
+  Stands in for gRT->SetVariable. Only deletion is supported.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockSetVariable (
+  IN  CHAR16    *VariableName,
+  IN  EFI_GUID  *VendorGuid,
+  IN  UINT32    Attributes,
+  IN  UINTN     DataSize,
+  IN  VOID      *Data
+  )
+{
+  MOCK_VARIABLE  *Variable;
+
+  mSetVariableCalls++;
+
+  Variable = FindVariable (VariableName, VendorGuid);
+  if ((Variable == NULL) || (DataSize != 0)) {
+    return EFI_NOT_FOUND;
+  }
+
+  FreePool (Variable->Data);
+  CopyMem (Variable, Variable + 1, (mVariables + mVariableCount - (Variable + 1)) * sizeof (MOCK_VARIABLE));
+  mVariableCount--;
+  return EFI_SUCCESS;
+}
+
+/**
+  Stands in for the ACPI table protocol, keeping a copy of the BERT header.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockInstallAcpiTable (
+  IN   EFI_ACPI_TABLE_PROTOCOL  *This,
+  IN   VOID                     *AcpiTableBuffer,
+  IN   UINTN                    AcpiTableBufferSize,
+  OUT  UINTN                    *TableKey
+  )
+{
+  mInstallCalls++;
+  CopyMem (&mInstalledBert, AcpiTableBuffer, MIN (AcpiTableBufferSize, sizeof (mInstalledBert)));
+  *TableKey = mInstallCalls;
+  return EFI_SUCCESS;
+}
+
+STATIC EFI_ACPI_TABLE_PROTOCOL  mMockAcpiTable = {
+  .InstallAcpiTable = MockInstallAcpiTable,
+};
+
+/**
+  Stands in for gBS->LocateProtocol.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockLocateProtocol (
+  IN  EFI_GUID  *Protocol,
+  IN  VOID      *Registration OPTIONAL,
+  OUT VOID      **Interface
+  )
+{
+  *Interface = &mMockAcpiTable;
+  return EFI_SUCCESS;
+}
+
+STATIC EFI_RUNTIME_SERVICES  mMockRuntime = {
+  .GetVariable         = MockGetVariable,
+  .GetNextVariableName = MockGetNextVariableName,
+  .SetVariable         = MockSetVariable,
+};
+
+STATIC EFI_BOOT_SERVICES  mMockBoot = {
+  .LocateProtocol = MockLocateProtocol,
+};
+
+EFI_RUNTIME_SERVICES  *gRT = &mMockRuntime;
+EFI_BOOT_SERVICES     *gBS = &mMockBoot;
+
+/**
+  Adds a variable with no particular contents to the stand-in store.
+**/
+STATIC
+MOCK_VARIABLE *
+AddVariable (
+  IN CONST CHAR16    *Name,
+  IN CONST EFI_GUID  *Guid,
+  IN UINTN           Size
+  )
+{
+  MOCK_VARIABLE  *Variable;
+
+  Variable = &mVariables[mVariableCount++];
+  StrCpyS (Variable->Name, ARRAY_SIZE (Variable->Name), Name);
+  CopyGuid (&Variable->Guid, Guid);
+  Variable->Size = Size;
+  Variable->Data = AllocateZeroPool (Size);
+  return Variable;
+}
+
+/**
+  Builds a CPER into a variable. Each section gets the next serial number in Data1 of its
+  type, and data bytes that count up from the serial number.
+**/
+STATIC
+VOID
+FillRecord (
+  IN OUT MOCK_VARIABLE  *Variable,
+  IN     UINT16         SectionCount,
+  IN     UINT32         SectionLength
+  )
+{
+  EFI_COMMON_ERROR_RECORD_HEADER  *Header;
+  EFI_ERROR_SECTION_DESCRIPTOR    *Section;
+  UINT8                           *Bytes;
+  UINTN                           Index;
+  UINTN                           Byte;
+
+  if (Variable->Data != NULL) {
+    FreePool (Variable->Data);
+  }
+
+  Variable->Size = sizeof (EFI_COMMON_ERROR_RECORD_HEADER) +
+                   SectionCount * (sizeof (EFI_ERROR_SECTION_DESCRIPTOR) + SectionLength);
+  Variable->Data = AllocateZeroPool (Variable->Size);
+
+  Header                 = (EFI_COMMON_ERROR_RECORD_HEADER *)Variable->Data;
+  Header->SignatureStart = EFI_ERROR_RECORD_SIGNATURE_START;
+  Header->SectionCount   = SectionCount;
+  Header->RecordLength   = (UINT32)Variable->Size;
+
+  Section = (EFI_ERROR_SECTION_DESCRIPTOR *)(Header + 1);
+  for (Index = 0; Index < SectionCount; Index++) {
+    Section[Index].SectionOffset = (UINT32)(sizeof (EFI_COMMON_ERROR_RECORD_HEADER) +
+                                            SectionCount * sizeof (EFI_ERROR_SECTION_DESCRIPTOR) +
+                                            Index * SectionLength);
+    Section[Index].SectionLength = SectionLength;
+    Section[Index].Severity      = (UINT32)(Index % 4);
+    CopyGuid (&Section[Index].SectionType, &mSectionGuid);
+    Section[Index].SectionType.Data1 = mSectionSerial;
+
+    Bytes = Variable->Data + Section[Index].SectionOffset;
+    for (Byte = 0; Byte < SectionLength; Byte++) {
+      Bytes[Byte] = (UINT8)(mSectionSerial + Byte);
+    }
+
+    mSectionSerial++;
+  }
+}
+
+/**
+  Checks the published BERT against the CPERs under the HwErrRec GUID, in store order.
+
+  @param[in]  Skip    A variable that is expected to be left out, or NULL.
+**/
+STATIC
+UNIT_TEST_STATUS
+VerifyBert (
+  IN MOCK_VARIABLE  *Skip
+  )
+{
+  EFI_ACPI_6_1_GENERIC_ERROR_STATUS_STRUCTURE      *Block;
+  EFI_ACPI_6_1_GENERIC_ERROR_DATA_ENTRY_STRUCTURE  *Entry;
+  EFI_COMMON_ERROR_RECORD_HEADER                   *Header;
+  EFI_ERROR_SECTION_DESCRIPTOR                     *Section;
+  UINTN                                            Index;
+  UINTN                                            SectionIndex;
+  UINTN                                            Entries;
+
+  UT_ASSERT_EQUAL (mInstallCalls, 1);
+  UT_ASSERT_EQUAL (mInstalledBert.Header.Signature, EFI_ACPI_6_1_BOOT_ERROR_RECORD_TABLE_SIGNATURE);
+  UT_ASSERT_EQUAL (CalculateSum8 ((UINT8 *)&mInstalledBert, sizeof (mInstalledBert)), 0);
+
+  Block   = (EFI_ACPI_6_1_GENERIC_ERROR_STATUS_STRUCTURE *)(UINTN)mInstalledBert.BootErrorRegion;
+  Entry   = (EFI_ACPI_6_1_GENERIC_ERROR_DATA_ENTRY_STRUCTURE *)(Block + 1);
+  Entries = 0;
+  for (Index = 0; Index < mVariableCount; Index++) {
+    if ((&mVariables[Index] == Skip) || !CompareGuid (&mVariables[Index].Guid, &gEfiHardwareErrorVariableGuid)) {
+      continue;
+    }
+
+    Header  = (EFI_COMMON_ERROR_RECORD_HEADER *)mVariables[Index].Data;
+    Section = (EFI_ERROR_SECTION_DESCRIPTOR *)(Header + 1);
+    for (SectionIndex = 0; SectionIndex < Header->SectionCount; SectionIndex++) {
+      UT_ASSERT_TRUE (CompareGuid ((EFI_GUID *)Entry->SectionType, &Section[SectionIndex].SectionType));
+      UT_ASSERT_EQUAL (Entry->ErrorSeverity, Section[SectionIndex].Severity);
+      UT_ASSERT_EQUAL (Entry->ErrorDataLength, Section[SectionIndex].SectionLength);
+      UT_ASSERT_MEM_EQUAL (Entry + 1, (UINT8 *)Header + Section[SectionIndex].SectionOffset, Entry->ErrorDataLength);
+
+      Entry = (EFI_ACPI_6_1_GENERIC_ERROR_DATA_ENTRY_STRUCTURE *)((UINT8 *)(Entry + 1) + Entry->ErrorDataLength);
+      Entries++;
+    }
+  }
+
+  UT_ASSERT_EQUAL (Block->BlockStatus.ErrorDataEntryCount, Entries);
+  UT_ASSERT_EQUAL (sizeof (*Block) + Block->DataLength, (UINTN)((UINT8 *)Entry - (UINT8 *)Block));
+  UT_ASSERT_TRUE (sizeof (*Block) + Block->DataLength <= mInstalledBert.BootErrorRegionLength);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Fills the stand-in store with MOCK_OTHER_COUNT variables under other GUIDs, with a HwErrRec
+  after every MOCK_RECORD_EVERY of them.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetUpStore (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CHAR16  Name[MOCK_NAME_LENGTH];
+  UINTN   Index;
+
+  mVariableCount = 0;
+  mSectionSerial = 0;
+  mRecordCount   = 0;
+  for (Index = 0; Index < MOCK_OTHER_COUNT; Index++) {
+    UnicodeSPrint (Name, sizeof (Name), L"%s%04X", L"Other", Index);
+    AddVariable (Name, (Index % 2) ? &mOtherGuid : &gEfiGlobalVariableGuid, 0x20 + Index % 0x40);
+
+    if (Index % MOCK_RECORD_EVERY == 0) {
+      UnicodeSPrint (Name, sizeof (Name), L"%s%04X", L"HwErrRec", mRecordCount);
+      FillRecord (
+        AddVariable (Name, &gEfiHardwareErrorVariableGuid, 0),
+        (UINT16)(1 + mRecordCount % 3),
+        (UINT32)(0x20 + 0x10 * (mRecordCount % 5))
+        );
+      mRecordCount++;
+    }
+  }
+
+  mNextNameCalls    = 0;
+  mGetVariableCalls = 0;
+  mSetVariableCalls = 0;
+  mInstallCalls     = 0;
+  ZeroMem (&mInstalledBert, sizeof (mInstalledBert));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Drops the driver's lists, the published region and the stand-in store.
+**/
+STATIC
+VOID
+EFIAPI
+CleanUpStore (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  //
+  // Deletes what is left on the list, which the tests have already checked.
+  //
+  ExitBootServicesHandlerCallback (NULL, NULL);
+
+  if (mInstalledBert.BootErrorRegion != 0) {
+    FreePool ((VOID *)(UINTN)mInstalledBert.BootErrorRegion);
+  }
+
+  for (Index = 0; Index < mVariableCount; Index++) {
+    FreePool (mVariables[Index].Data);
+  }
+
+  mVariableCount = 0;
+}
+
+/**
+  Finding the records walks the names once and reads only the HwErrRecs, once each.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ListReadsOnlyRecords (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  GenerateVariableList ();
+
+  UT_ASSERT_EQUAL (mVarNameListCount, mRecordCount);
+  //
+  // One call per name and one to find the end, plus one each time the name buffer grows
+  //
+  UT_ASSERT_TRUE (mNextNameCalls >= mVariableCount + 1);
+  UT_ASSERT_TRUE (mNextNameCalls <= mVariableCount + 1 + 2);
+  UT_ASSERT_EQUAL (mGetVariableCalls, mRecordCount);
+
+  DEBUG ((DEBUG_INFO, "%d name calls and %d reads for %d records\n", mNextNameCalls, mGetVariableCalls, mRecordCount));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Building the BERT reads each record once in all, into a region of exactly the size it
+  needs.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BertReadsEachRecordOnce (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+  UINTN  RegionSize;
+
+  GenerateVariableList ();
+  SetupBert ();
+
+  UT_ASSERT_EQUAL (mGetVariableCalls, mRecordCount);
+
+  RegionSize = sizeof (EFI_ACPI_6_1_GENERIC_ERROR_STATUS_STRUCTURE);
+  for (Index = 0; Index < mVariableCount; Index++) {
+    if (CompareGuid (&mVariables[Index].Guid, &gEfiHardwareErrorVariableGuid)) {
+      RegionSize += mVariables[Index].Size - sizeof (EFI_COMMON_ERROR_RECORD_HEADER);
+    }
+  }
+
+  UT_ASSERT_EQUAL (mInstalledBert.BootErrorRegionLength, RegionSize);
+  return VerifyBert (NULL);
+}
+
+/**
+  A name under the HwErrRec GUID longer than HwErrRecXXXX is published and deleted like the
+  others.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LongNameRecord (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FillRecord (AddVariable (L"HwErrRecPlatformCrashDump", &gEfiHardwareErrorVariableGuid, 0), 2, 0x100);
+  mRecordCount++;
+
+  GenerateVariableList ();
+  UT_ASSERT_EQUAL (mVarNameListCount, mRecordCount);
+
+  SetupBert ();
+  return VerifyBert (NULL);
+}
+
+/**
+  At ExitBootServices the published records are deleted and nothing else is.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RecordsDeletedAtExitBootServices (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+  UINTN  Others;
+
+  Others = mVariableCount - mRecordCount;
+
+  GenerateVariableList ();
+  SetupBert ();
+  ExitBootServicesHandlerCallback (NULL, NULL);
+
+  UT_ASSERT_EQUAL (mSetVariableCalls, mRecordCount);
+  UT_ASSERT_EQUAL (mVariableCount, Others);
+  UT_ASSERT_EQUAL (mVarNameListCount, 0);
+  for (Index = 0; Index < mVariableCount; Index++) {
+    UT_ASSERT_FALSE (CompareGuid (&mVariables[Index].Guid, &gEfiHardwareErrorVariableGuid));
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A record that changed after the list was made is published as it was read.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ChangedRecordPublishedAsRead (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MOCK_VARIABLE  *Grown;
+  UINT8          *Original;
+  UINTN          OriginalSize;
+
+  GenerateVariableList ();
+
+  Grown = FindVariable (L"HwErrRec0003", &gEfiHardwareErrorVariableGuid);
+  UT_ASSERT_NOT_NULL (Grown);
+  OriginalSize = Grown->Size;
+  Original     = AllocateCopyPool (OriginalSize, Grown->Data);
+  UT_ASSERT_NOT_NULL (Original);
+  FillRecord (Grown, 4, 0x200);
+
+  SetupBert ();
+
+  FreePool (Grown->Data);
+  Grown->Data = Original;
+  Grown->Size = OriginalSize;
+  return VerifyBert (NULL);
+}
+
+/**
+  A variable under the HwErrRec GUID larger than PcdMaxHardwareErrorVariableSize is left
+  out, and the rest are published.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+OversizedRecordSkipped (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MOCK_VARIABLE  *Oversized;
+
+  Oversized = AddVariable (L"HwErrRecOversized", &gEfiHardwareErrorVariableGuid, 0);
+  FillRecord (Oversized, 2, PcdGet32 (PcdMaxHardwareErrorVariableSize));
+
+  GenerateVariableList ();
+  UT_ASSERT_EQUAL (mVarNameListCount, mRecordCount);
+
+  SetupBert ();
+  return VerifyBert (Oversized);
+}
+
+/**
+  Without records no table is published.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+NoRecordsNoTable (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CleanUpStore (Context);
+  AddVariable (L"BootOrder", &gEfiGlobalVariableGuid, 2);
+
+  GenerateVariableList ();
+  SetupBert ();
+
+  UT_ASSERT_EQUAL (mVarNameListCount, 0);
+  UT_ASSERT_EQUAL (mGetVariableCalls, 0);
+  UT_ASSERT_EQUAL (mInstallCalls, 0);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  HwErrBert driver and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      BertSuite;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  mVariables = AllocatePool (MOCK_MAX_VARIABLES * sizeof (MOCK_VARIABLE));
+  if (mVariables == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&BertSuite, Framework, "HwErrBert BERT generation tests", "HwErrBert.Bert", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for BertSuite\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (BertSuite, "Listing reads only the records", "ListReadsOnlyRecords", ListReadsOnlyRecords, SetUpStore, CleanUpStore, NULL);
+  AddTestCase (BertSuite, "The BERT reads each record once", "BertReadsEachRecordOnce", BertReadsEachRecordOnce, SetUpStore, CleanUpStore, NULL);
+  AddTestCase (BertSuite, "Long record names", "LongNameRecord", LongNameRecord, SetUpStore, CleanUpStore, NULL);
+  AddTestCase (BertSuite, "Records are deleted at ExitBootServices", "RecordsDeletedAtExitBootServices", RecordsDeletedAtExitBootServices, SetUpStore, CleanUpStore, NULL);
+  AddTestCase (BertSuite, "A changed record is published as read", "ChangedRecordPublishedAsRead", ChangedRecordPublishedAsRead, SetUpStore, CleanUpStore, NULL);
+  AddTestCase (BertSuite, "An oversized record is skipped", "OversizedRecordSkipped", OversizedRecordSkipped, SetUpStore, CleanUpStore, NULL);
+  AddTestCase (BertSuite, "No records, no table", "NoRecordsNoTable", NoRecordsNoTable, SetUpStore, CleanUpStore, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  if (mVariables != NULL) {
+    FreePool (mVariables);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
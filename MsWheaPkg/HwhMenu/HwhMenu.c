@@ -31,6 +31,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <MsWheaReport/MsWheaReportCommon.h>
 
 #include "HwhMenu.h"
+#include "HwhMenuRecords.h"
 #include "HwhMenuVfr.h"
 #include "CreatorIDParser.h"
 #include "PlatformIDParser.h"
@@ -39,9 +40,10 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 // Struct Containing a HWErrRec
 typedef struct ErrorRecord {
-  LIST_ENTRY                        entry;  // Necessary for linked list structure
-  EFI_COMMON_ERROR_RECORD_HEADER    *error; // Pointer to the HWErrRec
-  UINT32                            val;    // Page number
+  EFI_COMMON_ERROR_RECORD_HEADER    *error;       // Pointer to the HWErrRec
+  CONST CPER_SECTION_INDEX_ENTRY    *sections;    // Sections of the HWErrRec
+  UINTN                             sectionCount; // Number of entries in sections
+  UINT32                            val;          // Page number
 } ErrorRecord;
 
 #pragma pack()
@@ -50,7 +52,9 @@ typedef struct ErrorRecord {
 // * Global Variables                                                                      *
 // *---------------------------------------------------------------------------------------*
 STATIC  HWH_MENU_CONFIG  mHwhMenuConfiguration = { LOGS_TRUE };                             // Configuration for VFR
-LIST_ENTRY               mListHead             = INITIALIZE_LIST_HEAD_VARIABLE (mListHead); // Head of the linked list
+HWH_RECORD_INDEX         mRecords;                                                          // Index of the HwErrRec(s)
+ErrorRecord              mCurrentRecord;                                                    // Record displayed on the page
+PARSER_LIB_RECORD_LINES  mSectionLines;                                                     // Decoded sections of the record displayed
 UINT32                   NumErrorEntries       = 0;                                         // Number of HwErrRec(s)
 ErrorRecord              *currentPage          = NULL;                                      // Current record displayed on the page
 CHAR16                   UnicodeString[MAX_DISPLAY_STRING_LENGTH + 1];                      // Unicode buffer for printing
@@ -108,31 +112,42 @@ struct {
 };
 
 // *---------------------------------------------------------------------------------------*
-// * Doubly Linked List Methods                                                            *
+// * Paging Methods                                                                        *
 // *---------------------------------------------------------------------------------------*
 
 /**
- *  Deletes the list structure containing WHEA Errors
+ *  Points currentPage at the current record of the index
  *
  *  @retval     VOID
 **/
 VOID
-DeleteList (
+UpdateCurrentPage (
   VOID
   )
 {
-  while (!IsListEmpty (&mListHead)) {
-    currentPage = (ErrorRecord *)GetFirstNode (&mListHead); // get ErrorRecord being deleted
-    RemoveEntryList ((LIST_ENTRY *)currentPage);            // remove ErrorRecord from list
-    FreePool (currentPage->error);                          // free HwErrRecXXXX in record
-    FreePool (currentPage);                                 // free ErrorRecord
-  }
+  mCurrentRecord.error    = HwhRecordCurrent (&mRecords);
+  mCurrentRecord.sections = HwhRecordCurrentSections (&mRecords, &mCurrentRecord.sectionCount);
+  mCurrentRecord.val      = (UINT32)mRecords.Current + 1;
+  currentPage             = (mCurrentRecord.error != NULL) ? &mCurrentRecord : NULL;
+}
 
+/**
+ *  Deletes the index of WHEA Errors and the records it holds
+ *
+ *  @retval     VOID
+**/
+VOID
+DeleteList (
+  VOID
+  )
+{
+  HwhRecordIndexFree (&mRecords);
+  ParserLibFreeRecordLines (&mSectionLines);
   currentPage = NULL;
 }
 
 /**
- *  Changes the current page to be the current error record to be the next in the list structure
+ *  Changes the current page to be the next valid error record in the index
  *
  *  @retval     BOOLEAN       TRUE if currentPage was changed to next
  *                            FALSE otherwise
@@ -142,15 +157,8 @@ PageForward (
   VOID
   )
 {
-  LIST_ENTRY  *tmp;
-
-  tmp = GetNextNode (
-          &mListHead,
-          (LIST_ENTRY *)currentPage
-          );
-
-  if (tmp != &mListHead) {
-    currentPage = (ErrorRecord *)tmp;
+  if (HwhRecordSeek (&mRecords, TRUE)) {
+    UpdateCurrentPage ();
     return TRUE;
   }
 
@@ -158,7 +166,7 @@ PageForward (
 }
 
 /**
- *  Changes the current page to be the current error record to be the previous in the list structure
+ *  Changes the current page to be the previous valid error record in the index
  *
  *  @retval     BOOLEAN     TRUE if currentPage was changed to previous
  *                          FALSE otherwise
@@ -168,15 +176,8 @@ PageBackward (
   VOID
   )
 {
-  LIST_ENTRY  *tmp;
-
-  tmp = GetPreviousNode (
-          &mListHead,
-          (LIST_ENTRY *)currentPage
-          );
-
-  if (tmp != &mListHead) {
-    currentPage = (ErrorRecord *)tmp;
+  if (HwhRecordSeek (&mRecords, FALSE)) {
+    UpdateCurrentPage ();
     return TRUE;
   }
 
@@ -545,7 +546,7 @@ ParsePageNumber (
 **/
 UINTN
 FindNewline (
-  IN CHAR16  **Source
+  IN CONST CHAR16  **Source
   )
 {
   // Null-check
@@ -553,8 +554,8 @@ FindNewline (
     return 0;
   }
 
-  UINTN   Counter = 0;
-  CHAR16  *End    = *Source;
+  UINTN         Counter = 0;
+  CONST CHAR16  *End    = *Source;
 
   // Walk the string until one of the following is true
   while (*End != '\n' && *End != '\0' && Counter < MAX_DISPLAY_STRING_LENGTH + 1) {
@@ -567,10 +568,9 @@ FindNewline (
 }
 
 /**
- *  Parses the current page number out of overall number of pages
+ *  Writes the lines decoded for one section to the section data area of the page
  *
- *  @param[in]     Err              Pointer to HwErrRec being parsed
- *  @param[in]     SectionHeader    Pointer to Section Header of data being parsed
+ *  @param[in]     Section          Index of the section within mSectionLines
  *  @param[in]     index            Pointer to to the current line of the section data portion of
  *                                  front page being written to
  *
@@ -578,56 +578,36 @@ FindNewline (
 **/
 VOID
 ParseSectionData (
-  IN     CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err,
-  IN     CONST EFI_ERROR_SECTION_DESCRIPTOR    *SectionHeader,
-  IN OUT       UINT8                           *index
+  IN     UINTN  Section,
+  IN OUT UINT8  *index
   )
 {
-  if ((Err == NULL) || (SectionHeader == NULL) || (index == NULL)) {
+  if (index == NULL) {
     return;
   }
 
-  CHAR16              **SectionDataStrings = NULL;       // Array of strings which are written in the section data area of page
-  SECTIONFUNCTIONPTR  SectionParser = NULL;              // Pointer to function which can parse the section data
-  CHAR16              *StringParsePtr = NULL;            // Pointer to current place in string being written
-  UINTN               NumberOfStrings = 0;               // Number of strings within SectionDataStrings
-  UINTN               StringParseChars = 0;              // Number of chars from CHAR16* to '\n' or '\0'
-  UINTN               OuterLoop, InnerLoop;
-
-  // Get parser for the section data if available
-  SectionParser = ParserLibFindSectionParser (&(SectionHeader->SectionType));
-
-  if (SectionParser == NULL) {
-    SectionParser = (SECTIONFUNCTIONPTR)&SectionDump;
-  }
-
-  // Call the parser and get how many strings were returned
-  NumberOfStrings = SectionParser (
-                      &SectionDataStrings,
-                      Err,
-                      SectionHeader
-                      );
-
-  for (OuterLoop = 0; OuterLoop < NumberOfStrings; OuterLoop++) {
-    // Set the parse pointer to the start of the string
-    StringParsePtr = SectionDataStrings[OuterLoop];
-
-    // If this string was not allocated for some reason, just move on to the next one
-    if (StringParsePtr == NULL) {
-      continue;
+  CONST CHAR16  *Line            = NULL;               // Line of the section being written
+  CONST CHAR16  *LineEnd         = NULL;               // End of the part of the line that is displayed
+  CONST CHAR16  *StringParsePtr  = NULL;               // Pointer to current place in string being written
+  UINTN         StringParseChars = 0;                  // Number of chars from CHAR16* to '\n' or '\0'
+  UINTN         OuterLoop, InnerLoop;
+
+  // The parsers' strings were copied into mSectionLines when the record was decoded, so
+  // only as many lines as fit on the page are walked
+  for (OuterLoop = 0; (*index) < NUM_SEC_DATA_ROWS; OuterLoop++) {
+    Line = ParserLibGetLine (&mSectionLines, Section, OuterLoop);
+    if (Line == NULL) {
+      break;
     }
 
-    // If we've run out of writable lines, free this one and continue
-    // so the rest are freed as well
-    if ((*index) >= NUM_SEC_DATA_ROWS) {
-      FreePool (StringParsePtr);
-      continue;
-    }
+    // Set the parse pointer to the start of the string
+    StringParsePtr = Line;
+    LineEnd        = Line + StrnLenS (Line, MAX_DISPLAY_STRING_LENGTH);
 
     // For each column in the row being written to
     for (InnerLoop = 0; InnerLoop < NUM_SEC_DATA_COLUMNS; InnerLoop++) {
       // Make sure we still have more chars to parse from the string. If not, just clear the uni string
-      if (StringParsePtr >= SectionDataStrings[OuterLoop] + StrnLenS (SectionDataStrings[OuterLoop], MAX_DISPLAY_STRING_LENGTH)) {
+      if (StringParsePtr >= LineEnd) {
         HiiSetString (
           mHwhMenuPrivate.HiiHandle,
           DisplayLines[*index][InnerLoop],
@@ -670,18 +650,15 @@ ParseSectionData (
       }
     }
 
-    // Free the string and increment to the next line of the page
+    // Increment to the next line of the page
     (*index)++;
-    FreePool (SectionDataStrings[OuterLoop]);
   }
 
-  // Free the array if it was created
-  if (SectionDataStrings != NULL) {
-    FreePool (SectionDataStrings);
-    SectionDataStrings = NULL;
+  // Publish blank line if there is room for one
+  if ((*index) >= NUM_SEC_DATA_ROWS) {
+    return;
   }
 
-  // Publish blank line
   for (OuterLoop = 0; OuterLoop < NUM_SEC_DATA_COLUMNS; OuterLoop++) {
     HiiSetString (
       mHwhMenuPrivate.HiiHandle,
@@ -723,22 +700,26 @@ UpdateDisplayStrings (
   ParseSourceID (&(Err->PlatformID));  // Publish Source ID field
   ParseCreatorID (&(Err->CreatorID));  // Publish Creator ID field
 
-  // display at most 2 Sections.
-  for (OuterLoop = 0; OuterLoop < 2; OuterLoop++) {
-    // if We have another section to display
-    if (OuterLoop < Err->SectionCount) {
-      UnicodeDataToVFR (
-        DisplayLines[SecLineIndex++][0],
-        L"Section %d",
-        OuterLoop + 1
-        );
+  // Decode at most 2 Sections in one pass from the section index made when the record was loaded,
+  // reusing the buffers from the last record displayed. If space runs out part way the lines
+  // decoded so far are still shown.
+  ParserLibParseIndexedRecord (
+    Err,
+    currentPage->sections,
+    currentPage->sectionCount,
+    (SECTIONFUNCTIONPTR)&SectionDump,
+    2,
+    &mSectionLines
+    );
 
-      ParseSectionData (
-        Err,
-        (((EFI_ERROR_SECTION_DESCRIPTOR *)(Err + 1)) + OuterLoop),
-        &SecLineIndex
-        );
-    }
+  for (OuterLoop = 0; (OuterLoop < mSectionLines.SectionCount) && (SecLineIndex < NUM_SEC_DATA_ROWS); OuterLoop++) {
+    UnicodeDataToVFR (
+      DisplayLines[SecLineIndex++][0],
+      L"Section %d",
+      OuterLoop + 1
+      );
+
+    ParseSectionData (OuterLoop, &SecLineIndex);
   }
 
   // Set the rest of the lines to blank
@@ -757,51 +738,10 @@ UpdateDisplayStrings (
 }
 
 /**
- *  Finds the XXXX in the HwRecRecXXXX -> the next index at which a Whea record will be inserted.
+ *  Populates the index of Whea Errors. Only the first page and the one after it are read.
  *
- *  @retval     UINT32     A Whea Index.
- *
-**/
-UINT32
-GetMaxWheaIndex (
-  VOID
-  )
-{
-  EFI_STATUS  Status;                                   // Return status
-  UINTN       Size      = 0;                            // Used to store size of HwErrRec found
-  UINT32      OuterLoop = 0;                            // Store the current index we're checking
-  CHAR16      VarName[EFI_HW_ERR_REC_VAR_NAME_LEN];     // HwRecRecXXXX used to find variable
-
-  for (OuterLoop = 0; OuterLoop <= MAX_UINT32; OuterLoop++) {
-    UnicodeSPrint (
-      VarName,
-      sizeof (VarName),
-      L"%s%04X",
-      EFI_HW_ERR_REC_VAR_NAME,
-      (UINT16)(OuterLoop & MAX_UINT16)
-      );
-
-    Status = gRT->GetVariable (
-                    VarName,
-                    &gEfiHardwareErrorVariableGuid,
-                    NULL,
-                    &Size,
-                    NULL
-                    );
-
-    // We've found the next index. Excellent.
-    if (Status == EFI_NOT_FOUND) {
-      break;
-    }
-  }
-
-  return OuterLoop;
-}
-
-/**
- *  Populates list structure with Whea Errors.
- *
- *  @retval     VOID
+ *  @retval     EFI_SUCCESS     There is a record to display
+ *  @retval     EFI_ABORTED     There are no valid records
  *
 **/
 EFI_STATUS
@@ -809,66 +749,19 @@ PopulateWheaErrorList (
   VOID
   )
 {
-  EFI_STATUS                      Status;                               // Return status
-  UINTN                           Size = 0;                             // Size of variable being stored
-  CHAR16                          VarName[EFI_HW_ERR_REC_VAR_NAME_LEN]; // HwRecRecXXXX name of var being stored
-  EFI_COMMON_ERROR_RECORD_HEADER  *ErrorRecordPointer = NULL;           // Pointer to the start of the record
-  ErrorRecord                     *new;                                 // New record being added
-  UINT32                          OuterLoop;
-
-  NumErrorEntries = GetMaxWheaIndex ();
-
-  for (OuterLoop = NumErrorEntries; OuterLoop > 0; --OuterLoop) {
-    // Create HwRecRecXXXX string
-    UnicodeSPrint (
-      VarName,
-      sizeof (VarName),
-      L"%s%04X",
-      EFI_HW_ERR_REC_VAR_NAME,
-      OuterLoop - 1
-      );
-
-    // Determine size required to allocate
-    Status = gRT->GetVariable (
-                    VarName,
-                    &gEfiHardwareErrorVariableGuid,
-                    NULL,
-                    &Size,
-                    NULL
-                    );
-
-    if (Status != EFI_NOT_FOUND) {
-      ErrorRecordPointer = AllocatePool (Size);
-
-      // Populate the error record
-      Status = gRT->GetVariable (
-                      VarName,
-                      &gEfiHardwareErrorVariableGuid,
-                      NULL,
-                      &Size,
-                      ErrorRecordPointer
-                      );
+  EFI_STATUS  Status;
 
-      if (ValidateCperHeader (ErrorRecordPointer, Size)) {
-        new = AllocateZeroPool (sizeof (ErrorRecord));
+  DeleteList ();
 
-        new->error = ErrorRecordPointer;
-        new->val   = OuterLoop;
+  Status          = HwhRecordIndexBuild (&mRecords);
+  NumErrorEntries = (UINT32)mRecords.Count;
+  UpdateCurrentPage ();
 
-        InsertHeadList (
-          &mListHead,
-          (LIST_ENTRY *)new
-          );
-      }
-    }
-  }
-
-  if (!IsListEmpty (&mListHead)) {
-    currentPage = (ErrorRecord *)GetFirstNode (&mListHead);
-    return EFI_SUCCESS;
-  } else {
+  if (EFI_ERROR (Status) || (currentPage == NULL)) {
     return EFI_ABORTED;
   }
+
+  return EFI_SUCCESS;
 }
 
 /**
@@ -939,8 +832,9 @@ DriverCallback (
     case EFI_BROWSER_ACTION_FORM_CLOSE:
 
       // Capture form closing
-      if (QuestionId == HWH_MENU_LEFT_ID) {
-        currentPage = (ErrorRecord *)GetFirstNode (&mListHead);
+      if ((QuestionId == HWH_MENU_LEFT_ID) && (currentPage != NULL)) {
+        HwhRecordSeekFirst (&mRecords);
+        UpdateCurrentPage ();
       }
 
       break;
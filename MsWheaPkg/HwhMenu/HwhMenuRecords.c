@@ -0,0 +1,575 @@
+/** @file
+HwhMenuRecords.c
+
+Index of the HwErrRecs shown by HwhMenu, with records read a page at a time
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+
+#include <Guid/Cper.h>
+#include <Guid/HardwareErrorVariable.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+#include <Library/CheckHwErrRecHeaderLib.h>
+
+#include "HwhMenuRecords.h"
+
+#define HWH_RECORD_NONE           MAX_UINTN
+#define HWH_RECORD_INDEX_INITIAL  64
+#define HWH_VAR_NAME_INITIAL      64
+
+/**
+ *  Parses the XXXX of a HwErrRecXXXX variable name.
+ *
+ *  @param[in]   Name       Variable name
+ *  @param[out]  Number     XXXX of the name
+ *
+ *  @retval      BOOLEAN    TRUE if Name is a HwErrRec name
+ *                          FALSE otherwise
+**/
+STATIC
+BOOLEAN
+ParseRecordName (
+  IN  CONST CHAR16  *Name,
+  OUT UINT16        *Number
+  )
+{
+  UINTN   Prefix;
+  UINTN   Digit;
+  UINT16  Value;
+  CHAR16  Char;
+
+  Prefix = StrLen (EFI_HW_ERR_REC_VAR_NAME);
+  if ((StrnCmp (Name, EFI_HW_ERR_REC_VAR_NAME, Prefix) != 0) || (StrLen (Name) != Prefix + 4)) {
+    return FALSE;
+  }
+
+  Value = 0;
+  for (Digit = 0; Digit < 4; Digit++) {
+    Char = Name[Prefix + Digit];
+    if ((Char >= L'0') && (Char <= L'9')) {
+      Value = (UINT16)((Value << 4) | (Char - L'0'));
+    } else if ((Char >= L'A') && (Char <= L'F')) {
+      Value = (UINT16)((Value << 4) | (Char - L'A' + 10));
+    } else {
+      return FALSE;
+    }
+  }
+
+  *Number = Value;
+  return TRUE;
+}
+
+/**
+ *  Adds a record number to the index.
+ *
+ *  @param[in,out]  Index     Index of the records
+ *  @param[in]      Number    XXXX of HwErrRecXXXX
+ *
+ *  @retval  EFI_SUCCESS           The record was added
+ *  @retval  EFI_OUT_OF_RESOURCES  The index could not be grown
+**/
+STATIC
+EFI_STATUS
+AddRecord (
+  IN OUT HWH_RECORD_INDEX  *Index,
+  IN     UINT16            Number
+  )
+{
+  HWH_RECORD_ENTRY  *Entries;
+  UINTN             Capacity;
+
+  if (Index->Count == Index->Capacity) {
+    Capacity = (Index->Capacity == 0) ? HWH_RECORD_INDEX_INITIAL : Index->Capacity * 2;
+    Entries  = ReallocatePool (
+                 Index->Capacity * sizeof (HWH_RECORD_ENTRY),
+                 Capacity * sizeof (HWH_RECORD_ENTRY),
+                 Index->Entries
+                 );
+    if (Entries == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    Index->Entries  = Entries;
+    Index->Capacity = Capacity;
+  }
+
+  ZeroMem (&Index->Entries[Index->Count], sizeof (HWH_RECORD_ENTRY));
+  Index->Entries[Index->Count].Number = Number;
+  Index->Count++;
+  return EFI_SUCCESS;
+}
+
+/**
+ *  Sorts the index by record number. The variable store usually returns the names in the
+ *  order they were written, so the entries are nearly sorted already.
+ *
+ *  @param[in,out]  Index     Index of the records
+**/
+STATIC
+VOID
+SortRecords (
+  IN OUT HWH_RECORD_INDEX  *Index
+  )
+{
+  HWH_RECORD_ENTRY  Entry;
+  UINTN             OuterLoop;
+  UINTN             InnerLoop;
+
+  for (OuterLoop = 1; OuterLoop < Index->Count; OuterLoop++) {
+    Entry     = Index->Entries[OuterLoop];
+    InnerLoop = OuterLoop;
+    while ((InnerLoop > 0) && (Index->Entries[InnerLoop - 1].Number > Entry.Number)) {
+      Index->Entries[InnerLoop] = Index->Entries[InnerLoop - 1];
+      InnerLoop--;
+    }
+
+    Index->Entries[InnerLoop] = Entry;
+  }
+}
+
+/**
+ *  Frees the record of an entry and its section index.
+ *
+ *  @param[in,out]  Entry     Entry of a loaded record
+**/
+STATIC
+VOID
+FreeRecord (
+  IN OUT HWH_RECORD_ENTRY  *Entry
+  )
+{
+  FreePool (Entry->Record);
+  Entry->Record = NULL;
+
+  if (Entry->Sections != NULL) {
+    FreePool (Entry->Sections);
+    Entry->Sections = NULL;
+  }
+
+  Entry->SectionCount = 0;
+}
+
+/**
+ *  Reads and checks the record of an entry, unless it is loaded or known to be invalid. The
+ *  sections are indexed as the record is checked, so showing it again does not walk the
+ *  section descriptors.
+ *
+ *  @param[in,out]  Index     Index of the records
+ *  @param[in]      Position  Entry of the record
+ *
+ *  @retval  TRUE             The record is loaded
+ *  @retval  FALSE            The record could not be read or is not valid
+**/
+STATIC
+BOOLEAN
+LoadRecord (
+  IN OUT HWH_RECORD_INDEX  *Index,
+  IN     UINTN             Position
+  )
+{
+  HWH_RECORD_ENTRY          *Entry;
+  EFI_STATUS                Status;
+  UINTN                     Size;
+  CPER_SECTION_INDEX_ENTRY  *Sections;
+  UINTN                     SectionCount;
+  CHAR16                    VarName[EFI_HW_ERR_REC_VAR_NAME_LEN];
+
+  Entry = &Index->Entries[Position];
+  if (Entry->Record != NULL) {
+    return TRUE;
+  }
+
+  if (Entry->Invalid) {
+    return FALSE;
+  }
+
+  UnicodeSPrint (
+    VarName,
+    sizeof (VarName),
+    L"%s%04X",
+    EFI_HW_ERR_REC_VAR_NAME,
+    Entry->Number
+    );
+
+  //
+  // ReadBuffer holds the largest hardware error record, so one read is enough unless the
+  // record is larger than the PCD allows.
+  //
+  Size   = Index->ReadBufferSize;
+  Status = gRT->GetVariable (
+                  VarName,
+                  &gEfiHardwareErrorVariableGuid,
+                  NULL,
+                  &Size,
+                  Index->ReadBuffer
+                  );
+
+  if (Status == EFI_BUFFER_TOO_SMALL) {
+    if (Index->ReadBuffer != NULL) {
+      FreePool (Index->ReadBuffer);
+    }
+
+    Index->ReadBufferSize = 0;
+    Index->ReadBuffer     = AllocatePool (Size);
+    if (Index->ReadBuffer == NULL) {
+      return FALSE;
+    }
+
+    Index->ReadBufferSize = Size;
+    Status                = gRT->GetVariable (
+                                   VarName,
+                                   &gEfiHardwareErrorVariableGuid,
+                                   NULL,
+                                   &Size,
+                                   Index->ReadBuffer
+                                   );
+  }
+
+  if (EFI_ERROR (Status)) {
+    Entry->Invalid = TRUE;
+    return FALSE;
+  }
+
+  //
+  // No more sections than there is room for descriptors. A record that claims more fails the
+  // checks anyway, so the index is sized before the record is trusted.
+  //
+  Sections     = NULL;
+  SectionCount = 0;
+  if (Size > sizeof (EFI_COMMON_ERROR_RECORD_HEADER)) {
+    SectionCount = MIN (
+                     ((EFI_COMMON_ERROR_RECORD_HEADER *)Index->ReadBuffer)->SectionCount,
+                     (Size - sizeof (EFI_COMMON_ERROR_RECORD_HEADER)) / sizeof (EFI_ERROR_SECTION_DESCRIPTOR)
+                     );
+  }
+
+  if (SectionCount > 0) {
+    Sections = AllocatePool (SectionCount * sizeof (CPER_SECTION_INDEX_ENTRY));
+    if (Sections == NULL) {
+      return FALSE;
+    }
+  }
+
+  Status = ValidateCperHeaderAndIndex (Index->ReadBuffer, Size, Sections, &SectionCount);
+  if (EFI_ERROR (Status)) {
+    if (Sections != NULL) {
+      FreePool (Sections);
+    }
+
+    Entry->Invalid = TRUE;
+    return FALSE;
+  }
+
+  Entry->Record = AllocateCopyPool (Size, Index->ReadBuffer);
+  if (Entry->Record == NULL) {
+    if (Sections != NULL) {
+      FreePool (Sections);
+    }
+
+    return FALSE;
+  }
+
+  Entry->Sections     = Sections;
+  Entry->SectionCount = SectionCount;
+  Entry->Size         = (UINT32)Size;
+  return TRUE;
+}
+
+/**
+ *  Finds the nearest valid record before or after an entry, loading records on the way.
+ *
+ *  @param[in,out]  Index     Index of the records
+ *  @param[in]      Position  Entry to start from
+ *  @param[in]      Forward   TRUE to search after Position, FALSE to search before it
+ *
+ *  @retval  Entry of the valid record, or HWH_RECORD_NONE
+**/
+STATIC
+UINTN
+FindValidRecord (
+  IN OUT HWH_RECORD_INDEX  *Index,
+  IN     UINTN             Position,
+  IN     BOOLEAN           Forward
+  )
+{
+  while (TRUE) {
+    if (Forward) {
+      if (Position + 1 >= Index->Count) {
+        return HWH_RECORD_NONE;
+      }
+
+      Position++;
+    } else {
+      if (Position == 0) {
+        return HWH_RECORD_NONE;
+      }
+
+      Position--;
+    }
+
+    if (LoadRecord (Index, Position)) {
+      return Position;
+    }
+  }
+}
+
+/**
+ *  Makes an entry the current one, loads the valid records on either side of it, and frees
+ *  every other record.
+ *
+ *  @param[in,out]  Index     Index of the records
+ *  @param[in]      Position  Entry of a loaded record
+**/
+STATIC
+VOID
+SetCurrentRecord (
+  IN OUT HWH_RECORD_INDEX  *Index,
+  IN     UINTN             Position
+  )
+{
+  UINTN  First;
+  UINTN  Last;
+  UINTN  OuterLoop;
+
+  Index->Current = Position;
+
+  First = FindValidRecord (Index, Position, FALSE);
+  if (First == HWH_RECORD_NONE) {
+    First = Position;
+  }
+
+  Last = FindValidRecord (Index, Position, TRUE);
+  if (Last == HWH_RECORD_NONE) {
+    Last = Position;
+  }
+
+  for (OuterLoop = 0; OuterLoop < Index->Count; OuterLoop++) {
+    if (((OuterLoop < First) || (OuterLoop > Last)) && (Index->Entries[OuterLoop].Record != NULL)) {
+      FreeRecord (&Index->Entries[OuterLoop]);
+    }
+  }
+}
+
+/**
+ *  Builds the index of the HwErrRecs with one sweep of GetNextVariableName, and loads the
+ *  first valid record.
+ *
+ *  @param[out]  Index        Index to build. Free it with HwhRecordIndexFree.
+ *
+ *  @retval  EFI_SUCCESS           The first valid record is the current one.
+ *  @retval  EFI_NOT_FOUND         There is no valid record.
+ *  @retval  EFI_OUT_OF_RESOURCES  The index could not be allocated.
+**/
+EFI_STATUS
+HwhRecordIndexBuild (
+  OUT HWH_RECORD_INDEX  *Index
+  )
+{
+  EFI_STATUS  Status;
+  EFI_GUID    Guid;
+  CHAR16      *Name;
+  CHAR16      *NewName;
+  UINTN       NameBufferSize;
+  UINTN       NameSize;
+  UINT16      Number;
+
+  ZeroMem (Index, sizeof (HWH_RECORD_INDEX));
+
+  Index->ReadBufferSize = PcdGet32 (PcdMaxHardwareErrorVariableSize);
+  Index->ReadBuffer     = AllocatePool (Index->ReadBufferSize);
+  NameBufferSize        = HWH_VAR_NAME_INITIAL * sizeof (CHAR16);
+  Name                  = AllocateZeroPool (NameBufferSize);
+  if ((Index->ReadBuffer == NULL) || (Name == NULL)) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto Exit;
+  }
+
+  while (TRUE) {
+    NameSize = NameBufferSize;
+    Status   = gRT->GetNextVariableName (&NameSize, Name, &Guid);
+    if (Status == EFI_BUFFER_TOO_SMALL) {
+      NewName = ReallocatePool (NameBufferSize, NameSize, Name);
+      if (NewName == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        goto Exit;
+      }
+
+      Name           = NewName;
+      NameBufferSize = NameSize;
+      Status         = gRT->GetNextVariableName (&NameSize, Name, &Guid);
+    }
+
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    if (CompareGuid (&Guid, &gEfiHardwareErrorVariableGuid) && ParseRecordName (Name, &Number)) {
+      Status = AddRecord (Index, Number);
+      if (EFI_ERROR (Status)) {
+        goto Exit;
+      }
+    }
+  }
+
+  SortRecords (Index);
+
+  DEBUG ((DEBUG_INFO, "%a: %u HwErrRecs\n", __FUNCTION__, (UINT32)Index->Count));
+
+  Status = HwhRecordSeekFirst (Index) ? EFI_SUCCESS : EFI_NOT_FOUND;
+
+Exit:
+  if (Name != NULL) {
+    FreePool (Name);
+  }
+
+  if (Status == EFI_OUT_OF_RESOURCES) {
+    HwhRecordIndexFree (Index);
+  }
+
+  return Status;
+}
+
+/**
+ *  Frees the index and the records it holds.
+ *
+ *  @param[in,out]  Index     Index to free.
+**/
+VOID
+HwhRecordIndexFree (
+  IN OUT HWH_RECORD_INDEX  *Index
+  )
+{
+  UINTN  OuterLoop;
+
+  for (OuterLoop = 0; OuterLoop < Index->Count; OuterLoop++) {
+    if (Index->Entries[OuterLoop].Record != NULL) {
+      FreeRecord (&Index->Entries[OuterLoop]);
+    }
+  }
+
+  if (Index->Entries != NULL) {
+    FreePool (Index->Entries);
+  }
+
+  if (Index->ReadBuffer != NULL) {
+    FreePool (Index->ReadBuffer);
+  }
+
+  ZeroMem (Index, sizeof (HWH_RECORD_INDEX));
+}
+
+/**
+ *  Returns the current record.
+ *
+ *  @param[in,out]  Index     Index of the records.
+ *
+ *  @retval  The current record, or NULL if there is none.
+**/
+EFI_COMMON_ERROR_RECORD_HEADER *
+HwhRecordCurrent (
+  IN OUT HWH_RECORD_INDEX  *Index
+  )
+{
+  if (Index->Current >= Index->Count) {
+    return NULL;
+  }
+
+  return Index->Entries[Index->Current].Record;
+}
+
+/**
+ *  Returns the sections of the current record, as indexed when it was loaded.
+ *
+ *  @param[in,out]  Index         Index of the records.
+ *  @param[out]     SectionCount  Number of sections of the current record.
+ *
+ *  @retval  The sections of the current record, or NULL if it has none or there is no record.
+**/
+CONST CPER_SECTION_INDEX_ENTRY *
+HwhRecordCurrentSections (
+  IN OUT HWH_RECORD_INDEX  *Index,
+  OUT    UINTN             *SectionCount
+  )
+{
+  if (Index->Current >= Index->Count) {
+    *SectionCount = 0;
+    return NULL;
+  }
+
+  *SectionCount = Index->Entries[Index->Current].SectionCount;
+  return Index->Entries[Index->Current].Sections;
+}
+
+/**
+ *  Makes the nearest valid record before or after the current one the current record, and
+ *  loads the valid records on either side of it.
+ *
+ *  @param[in,out]  Index     Index of the records.
+ *  @param[in]      Forward   TRUE for the next record, FALSE for the previous one.
+ *
+ *  @retval  TRUE             The current record changed.
+ *  @retval  FALSE            There is no valid record in that direction.
+**/
+BOOLEAN
+HwhRecordSeek (
+  IN OUT HWH_RECORD_INDEX  *Index,
+  IN     BOOLEAN           Forward
+  )
+{
+  UINTN  Position;
+
+  if (HwhRecordCurrent (Index) == NULL) {
+    return FALSE;
+  }
+
+  Position = FindValidRecord (Index, Index->Current, Forward);
+  if (Position == HWH_RECORD_NONE) {
+    return FALSE;
+  }
+
+  SetCurrentRecord (Index, Position);
+  return TRUE;
+}
+
+/**
+ *  Makes the first valid record the current one.
+ *
+ *  @param[in,out]  Index     Index of the records.
+ *
+ *  @retval  TRUE             There is a valid record.
+ *  @retval  FALSE            There is no valid record.
+**/
+BOOLEAN
+HwhRecordSeekFirst (
+  IN OUT HWH_RECORD_INDEX  *Index
+  )
+{
+  UINTN  Position;
+
+  if (Index->Count == 0) {
+    Index->Current = 0;
+    return FALSE;
+  }
+
+  Position = 0;
+  if (!LoadRecord (Index, Position)) {
+    Position = FindValidRecord (Index, Position, TRUE);
+    if (Position == HWH_RECORD_NONE) {
+      Index->Current = Index->Count;
+      return FALSE;
+    }
+  }
+
+  SetCurrentRecord (Index, Position);
+  return TRUE;
+}
@@ -0,0 +1,113 @@
+/** @file
+HwhMenuRecords.h
+
+Index of the HwErrRecs shown by HwhMenu. The index holds only the record numbers, found with
+one sweep of GetNextVariableName. A record is read, checked and its sections indexed when a page
+needs it, and only the record shown and the records on either side of it are kept in memory.
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#ifndef __HWH_MENU_RECORDS__
+#define __HWH_MENU_RECORDS__
+
+typedef struct {
+  UINT16                            Number;       // XXXX of HwErrRecXXXX
+  BOOLEAN                           Invalid;      // Record failed ValidateCperHeaderAndIndex
+  UINT32                            Size;         // Size of the variable, 0 until it is read
+  EFI_COMMON_ERROR_RECORD_HEADER    *Record;      // Record, if loaded
+  CPER_SECTION_INDEX_ENTRY          *Sections;    // Sections of Record, indexed when it was loaded
+  UINTN                             SectionCount; // Number of entries in Sections
+} HWH_RECORD_ENTRY;
+
+typedef struct {
+  HWH_RECORD_ENTRY    *Entries;               // Records in ascending order of Number
+  UINTN               Count;                  // Number of entries
+  UINTN               Capacity;               // Number of entries allocated
+  UINTN               Current;                // Entry of the page shown
+  VOID                *ReadBuffer;            // Holds a record as it is read
+  UINTN               ReadBufferSize;         // Size of ReadBuffer
+} HWH_RECORD_INDEX;
+
+/**
+ *  Builds the index of the HwErrRecs with one sweep of GetNextVariableName, and loads the
+ *  first valid record.
+ *
+ *  @param[out]  Index        Index to build. Free it with HwhRecordIndexFree.
+ *
+ *  @retval  EFI_SUCCESS           The first valid record is the current one.
+ *  @retval  EFI_NOT_FOUND         There is no valid record.
+ *  @retval  EFI_OUT_OF_RESOURCES  The index could not be allocated.
+**/
+EFI_STATUS
+HwhRecordIndexBuild (
+  OUT HWH_RECORD_INDEX  *Index
+  );
+
+/**
+ *  Frees the index and the records it holds.
+ *
+ *  @param[in,out]  Index     Index to free.
+**/
+VOID
+HwhRecordIndexFree (
+  IN OUT HWH_RECORD_INDEX  *Index
+  );
+
+/**
+ *  Returns the current record.
+ *
+ *  @param[in,out]  Index     Index of the records.
+ *
+ *  @retval  The current record, or NULL if there is none.
+**/
+EFI_COMMON_ERROR_RECORD_HEADER *
+HwhRecordCurrent (
+  IN OUT HWH_RECORD_INDEX  *Index
+  );
+
+/**
+ *  Returns the sections of the current record, as indexed when it was loaded.
+ *
+ *  @param[in,out]  Index         Index of the records.
+ *  @param[out]     SectionCount  Number of sections of the current record.
+ *
+ *  @retval  The sections of the current record, or NULL if it has none or there is no record.
+**/
+CONST CPER_SECTION_INDEX_ENTRY *
+HwhRecordCurrentSections (
+  IN OUT HWH_RECORD_INDEX  *Index,
+  OUT    UINTN             *SectionCount
+  );
+
+/**
+ *  Makes the nearest valid record before or after the current one the current record, and
+ *  loads the valid records on either side of it.
+ *
+ *  @param[in,out]  Index     Index of the records.
+ *  @param[in]      Forward   TRUE for the next record, FALSE for the previous one.
+ *
+ *  @retval  TRUE             The current record changed.
+ *  @retval  FALSE            There is no valid record in that direction.
+**/
+BOOLEAN
+HwhRecordSeek (
+  IN OUT HWH_RECORD_INDEX  *Index,
+  IN     BOOLEAN           Forward
+  );
+
+/**
+ *  Makes the first valid record the current one.
+ *
+ *  @param[in,out]  Index     Index of the records.
+ *
+ *  @retval  TRUE             There is a valid record.
+ *  @retval  FALSE            There is no valid record.
+**/
+BOOLEAN
+HwhRecordSeekFirst (
+  IN OUT HWH_RECORD_INDEX  *Index
+  );
+
+#endif
@@ -0,0 +1,657 @@
+/** @file -- HwhMenuRecordsHostTest.c
+Host-based UnitTest for the record index of HwhMenu.
+
+The stand-in variable store holds more than a thousand HwErrRecs among other variables, and
+counts the variable reads, so each test can check how many records a page flip reads.
+
+Copyright (c) Microsoft Corporation
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+
+#include <Guid/Cper.h>
+#include <Guid/HardwareErrorVariable.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/CheckHwErrRecHeaderLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../HwhMenuRecords.h"
+
+#define UNIT_TEST_NAME     "HwhMenu Record Index Unit Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define MOCK_MAX_VARIABLES  1400
+#define MOCK_RECORD_COUNT   1200
+#define MOCK_DATA_OFFSET    (sizeof (EFI_COMMON_ERROR_RECORD_HEADER) + sizeof (EFI_ERROR_SECTION_DESCRIPTOR))
+#define MOCK_RECORD_SIZE    (MOCK_DATA_OFFSET + 0x40)
+#define MOCK_LARGE_SIZE     0x600                 // Above PcdMaxHardwareErrorVariableSize of the test
+
+typedef struct {
+  CHAR16      Name[16];
+  EFI_GUID    Guid;
+  UINT16      Number;
+  UINT32      Size;
+  BOOLEAN     Corrupt;
+} MOCK_VARIABLE;
+
+STATIC EFI_GUID  mOtherGuid = {
+  0x6c9b1ad2, 0x39e4, 0x4f07, { 0x8a, 0x3b, 0x15, 0x72, 0xc4, 0x0e, 0x5d, 0x91 }
+};
+
+STATIC MOCK_VARIABLE  *mVariables;
+STATIC UINTN          mVariableCount;
+STATIC UINTN          mNameReads;
+STATIC UINTN          mDataReads;
+STATIC UINTN          mValidations;
+
+STATIC HWH_RECORD_INDEX  mIndex;
+
+/**
+  Looks up a variable of the stand-in store.
+**/
+STATIC
+MOCK_VARIABLE *
+FindVariable (
+  IN CONST CHAR16    *Name,
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < mVariableCount; Index++) {
+    if (CompareGuid (&mVariables[Index].Guid, Guid) && (StrCmp (mVariables[Index].Name, Name) == 0)) {
+      return &mVariables[Index];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Stands in for gRT->GetVariable. The data of a record carries its number in RecordID, and
+  in the type of its one section.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockGetVariable (
+  IN     CHAR16    *VariableName,
+  IN     EFI_GUID  *VendorGuid,
+  OUT    UINT32    *Attributes OPTIONAL,
+  IN OUT UINTN     *DataSize,
+  OUT    VOID      *Data OPTIONAL
+  )
+{
+  MOCK_VARIABLE                   *Variable;
+  EFI_COMMON_ERROR_RECORD_HEADER  *Record;
+  EFI_ERROR_SECTION_DESCRIPTOR    *SecHead;
+
+  mDataReads++;
+
+  Variable = FindVariable (VariableName, VendorGuid);
+  if (Variable == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  if ((*DataSize < Variable->Size) || (Data == NULL)) {
+    *DataSize = Variable->Size;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  *DataSize = Variable->Size;
+  ZeroMem (Data, Variable->Size);
+  Record                 = (EFI_COMMON_ERROR_RECORD_HEADER *)Data;
+  Record->SignatureStart = Variable->Corrupt ? 0 : EFI_ERROR_RECORD_SIGNATURE_START;
+  Record->RecordLength   = Variable->Size;
+  Record->RecordID       = Variable->Number;
+  Record->SectionCount   = 1;
+
+  SecHead                    = (EFI_ERROR_SECTION_DESCRIPTOR *)(Record + 1);
+  SecHead->SectionOffset     = MOCK_DATA_OFFSET;
+  SecHead->SectionLength     = Variable->Size - MOCK_DATA_OFFSET;
+  SecHead->SectionType.Data1 = Variable->Number;
+  return EFI_SUCCESS;
+}
+
+/**
+  Stands in for gRT->GetNextVariableName.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockGetNextVariableName (
+  IN OUT UINTN     *VariableNameSize,
+  IN OUT CHAR16    *VariableName,
+  IN OUT EFI_GUID  *VendorGuid
+  )
+{
+  MOCK_VARIABLE  *Variable;
+  UINTN          Next;
+  UINTN          Size;
+
+  mNameReads++;
+
+  if (VariableName[0] == L'\0') {
+    Next = 0;
+  } else {
+    Variable = FindVariable (VariableName, VendorGuid);
+    if (Variable == NULL) {
+      return EFI_INVALID_PARAMETER;
+    }
+
+    Next = (Variable - mVariables) + 1;
+  }
+
+  if (Next >= mVariableCount) {
+    return EFI_NOT_FOUND;
+  }
+
+  Size = StrSize (mVariables[Next].Name);
+  if (*VariableNameSize < Size) {
+    *VariableNameSize = Size;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  *VariableNameSize = Size;
+  CopyMem (VariableName, mVariables[Next].Name, Size);
+  CopyGuid (VendorGuid, &mVariables[Next].Guid);
+  return EFI_SUCCESS;
+}
+
+STATIC EFI_RUNTIME_SERVICES  mMockRuntime = {
+  .GetVariable         = MockGetVariable,
+  .GetNextVariableName = MockGetNextVariableName,
+};
+
+EFI_RUNTIME_SERVICES  *gRT = &mMockRuntime;
+
+/**
+  Stands in for CheckHwErrRecHeaderLib, and counts the records checked.
+**/
+EFI_STATUS
+EFIAPI
+ValidateCperHeaderAndIndex (
+  IN     CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err,
+  IN     CONST UINTN                           Size,
+  OUT    CPER_SECTION_INDEX_ENTRY              *Sections OPTIONAL,
+  IN OUT UINTN                                 *SectionCount
+  )
+{
+  CONST EFI_ERROR_SECTION_DESCRIPTOR  *SecHead;
+  UINTN                               Index;
+
+  mValidations++;
+  if ((Err->SignatureStart != EFI_ERROR_RECORD_SIGNATURE_START) || (Err->RecordLength != Size)) {
+    return EFI_COMPROMISED_DATA;
+  }
+
+  if (*SectionCount < Err->SectionCount) {
+    *SectionCount = Err->SectionCount;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  SecHead = (CONST EFI_ERROR_SECTION_DESCRIPTOR *)(Err + 1);
+  for (Index = 0; Index < Err->SectionCount; Index++, SecHead++) {
+    CopyGuid (&Sections[Index].SectionType, &SecHead->SectionType);
+    Sections[Index].Offset   = SecHead->SectionOffset;
+    Sections[Index].Length   = SecHead->SectionLength;
+    Sections[Index].Severity = SecHead->Severity;
+  }
+
+  *SectionCount = Err->SectionCount;
+  return EFI_SUCCESS;
+}
+
+/**
+  Adds a variable to the stand-in store.
+**/
+STATIC
+MOCK_VARIABLE *
+AddVariable (
+  IN CONST CHAR16    *Name,
+  IN CONST EFI_GUID  *Guid
+  )
+{
+  MOCK_VARIABLE  *Variable;
+
+  Variable = &mVariables[mVariableCount++];
+  ZeroMem (Variable, sizeof (MOCK_VARIABLE));
+  StrCpyS (Variable->Name, ARRAY_SIZE (Variable->Name), Name);
+  CopyGuid (&Variable->Guid, Guid);
+  Variable->Size = MOCK_RECORD_SIZE;
+  return Variable;
+}
+
+/**
+  Adds HwErrRec<Number> to the stand-in store.
+**/
+STATIC
+MOCK_VARIABLE *
+AddRecord (
+  IN UINT16  Number
+  )
+{
+  MOCK_VARIABLE  *Variable;
+  CHAR16         Name[16];
+
+  UnicodeSPrint (Name, sizeof (Name), L"%s%04X", EFI_HW_ERR_REC_VAR_NAME, Number);
+  Variable         = AddVariable (Name, &gEfiHardwareErrorVariableGuid);
+  Variable->Number = Number;
+  return Variable;
+}
+
+/**
+  Fills the stand-in store with MOCK_RECORD_COUNT records, in order, among other variables.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetUpStore (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Number;
+
+  mVariableCount = 0;
+  AddVariable (L"BootOrder", &gEfiGlobalVariableGuid);
+  AddVariable (L"HwErrRecSupport", &gEfiGlobalVariableGuid);
+  AddVariable (L"HwErrRec0001", &mOtherGuid);
+  for (Number = 0; Number < MOCK_RECORD_COUNT; Number++) {
+    AddRecord ((UINT16)Number);
+    if (Number == MOCK_RECORD_COUNT / 2) {
+      AddVariable (L"PlatformConfig", &mOtherGuid);
+      AddVariable (L"HwErrRecXYZ", &gEfiHardwareErrorVariableGuid);
+      AddVariable (L"HwErrRec00g1", &gEfiHardwareErrorVariableGuid);
+    }
+  }
+
+  mNameReads   = 0;
+  mDataReads   = 0;
+  mValidations = 0;
+  ZeroMem (&mIndex, sizeof (mIndex));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Frees the index.
+**/
+STATIC
+VOID
+EFIAPI
+CleanUpIndex (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  HwhRecordIndexFree (&mIndex);
+}
+
+/**
+  Returns the number of the current record.
+**/
+STATIC
+UINT64
+CurrentNumber (
+  VOID
+  )
+{
+  EFI_COMMON_ERROR_RECORD_HEADER  *Record;
+
+  Record = HwhRecordCurrent (&mIndex);
+  return (Record == NULL) ? MAX_UINT64 : Record->RecordID;
+}
+
+/**
+  Returns the number of records held in memory.
+**/
+STATIC
+UINTN
+LoadedRecords (
+  VOID
+  )
+{
+  UINTN  Index;
+  UINTN  Count;
+
+  Count = 0;
+  for (Index = 0; Index < mIndex.Count; Index++) {
+    if (mIndex.Entries[Index].Record != NULL) {
+      Count++;
+    }
+  }
+
+  return Count;
+}
+
+/**
+  Opening the menu sweeps the names once, and reads only the first page and the one after it.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+OpenReadsFirstPages (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UT_ASSERT_NOT_EFI_ERROR (HwhRecordIndexBuild (&mIndex));
+
+  UT_ASSERT_EQUAL (mIndex.Count, MOCK_RECORD_COUNT);
+  UT_ASSERT_EQUAL (mNameReads, mVariableCount + 1);
+  UT_ASSERT_EQUAL (mDataReads, 2);
+  UT_ASSERT_EQUAL (LoadedRecords (), 2);
+  UT_ASSERT_EQUAL (CurrentNumber (), 0);
+
+  DEBUG ((DEBUG_INFO, "Open: %lu name reads, %lu record reads for %lu records\n", (UINT64)mNameReads, (UINT64)mDataReads, (UINT64)mIndex.Count);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Each page flip reads the one record past the next page, and no more than three records stay
+  in memory.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+PageFlipReadsOneRecord (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Flip;
+  UINTN  Reads;
+
+  UT_ASSERT_NOT_EFI_ERROR (HwhRecordIndexBuild (&mIndex));
+
+  for (Flip = 1; Flip <= 500; Flip++) {
+    Reads = mDataReads;
+    UT_ASSERT_TRUE (HwhRecordSeek (&mIndex, TRUE));
+    UT_ASSERT_EQUAL (mDataReads - Reads, 1);
+    UT_ASSERT_EQUAL (CurrentNumber (), Flip);
+    UT_ASSERT_EQUAL (LoadedRecords (), 3);
+  }
+
+  for (Flip = 499; Flip >= 400; Flip--) {
+    Reads = mDataReads;
+    UT_ASSERT_TRUE (HwhRecordSeek (&mIndex, FALSE));
+    UT_ASSERT_EQUAL (mDataReads - Reads, 1);
+    UT_ASSERT_EQUAL (CurrentNumber (), Flip);
+    UT_ASSERT_EQUAL (LoadedRecords (), 3);
+  }
+
+  //
+  // Back at the first page, there is nothing before it to read.
+  //
+  UT_ASSERT_TRUE (HwhRecordSeekFirst (&mIndex));
+  UT_ASSERT_EQUAL (CurrentNumber (), 0);
+  UT_ASSERT_FALSE (HwhRecordSeek (&mIndex, FALSE));
+  UT_ASSERT_EQUAL (LoadedRecords (), 2);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A record is checked and its sections indexed once, when it is read. Paging back to a
+  record still in memory uses the index kept with it.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SectionsIndexedOnLoad (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONST CPER_SECTION_INDEX_ENTRY  *Sections;
+  UINTN                           SectionCount;
+  UINTN                           Flip;
+
+  UT_ASSERT_NOT_EFI_ERROR (HwhRecordIndexBuild (&mIndex));
+
+  for (Flip = 1; Flip <= 10; Flip++) {
+    UT_ASSERT_TRUE (HwhRecordSeek (&mIndex, TRUE));
+    UT_ASSERT_TRUE (HwhRecordSeek (&mIndex, FALSE));
+    UT_ASSERT_TRUE (HwhRecordSeek (&mIndex, TRUE));
+  }
+
+  UT_ASSERT_EQUAL (CurrentNumber (), 10);
+  UT_ASSERT_EQUAL (mValidations, mDataReads);
+
+  Sections = HwhRecordCurrentSections (&mIndex, &SectionCount);
+  UT_ASSERT_NOT_NULL (Sections);
+  UT_ASSERT_EQUAL (SectionCount, 1);
+  UT_ASSERT_EQUAL (Sections[0].SectionType.Data1, 10);
+  UT_ASSERT_EQUAL (Sections[0].Offset, MOCK_DATA_OFFSET);
+  UT_ASSERT_EQUAL (Sections[0].Length, MOCK_RECORD_SIZE - MOCK_DATA_OFFSET);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Paging runs to the last record and stops there.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+PageToLastRecord (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Flips;
+
+  UT_ASSERT_NOT_EFI_ERROR (HwhRecordIndexBuild (&mIndex));
+
+  Flips = 0;
+  while (HwhRecordSeek (&mIndex, TRUE)) {
+    Flips++;
+  }
+
+  UT_ASSERT_EQUAL (Flips, MOCK_RECORD_COUNT - 1);
+  UT_ASSERT_EQUAL (CurrentNumber (), MOCK_RECORD_COUNT - 1);
+  UT_ASSERT_EQUAL (mDataReads, MOCK_RECORD_COUNT);
+  UT_ASSERT_EQUAL (LoadedRecords (), 2);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Records that fail the header check are skipped, and are read only once.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+InvalidRecordsSkipped (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Reads;
+
+  FindVariable (L"HwErrRec0000", &gEfiHardwareErrorVariableGuid)->Corrupt = TRUE;
+  FindVariable (L"HwErrRec0005", &gEfiHardwareErrorVariableGuid)->Corrupt = TRUE;
+  FindVariable (L"HwErrRec0006", &gEfiHardwareErrorVariableGuid)->Corrupt = TRUE;
+
+  UT_ASSERT_NOT_EFI_ERROR (HwhRecordIndexBuild (&mIndex));
+  UT_ASSERT_EQUAL (CurrentNumber (), 1);
+
+  UT_ASSERT_TRUE (HwhRecordSeek (&mIndex, TRUE));
+  UT_ASSERT_TRUE (HwhRecordSeek (&mIndex, TRUE));
+  UT_ASSERT_TRUE (HwhRecordSeek (&mIndex, TRUE));
+  UT_ASSERT_EQUAL (CurrentNumber (), 4);
+
+  UT_ASSERT_TRUE (HwhRecordSeek (&mIndex, TRUE));
+  UT_ASSERT_EQUAL (CurrentNumber (), 7);
+
+  Reads = mDataReads;
+  UT_ASSERT_TRUE (HwhRecordSeek (&mIndex, FALSE));
+  UT_ASSERT_EQUAL (CurrentNumber (), 4);
+  UT_ASSERT_TRUE (HwhRecordSeek (&mIndex, FALSE));
+  UT_ASSERT_EQUAL (CurrentNumber (), 3);
+  UT_ASSERT_TRUE (HwhRecordSeek (&mIndex, FALSE));
+  UT_ASSERT_TRUE (HwhRecordSeek (&mIndex, FALSE));
+  UT_ASSERT_EQUAL (CurrentNumber (), 1);
+  UT_ASSERT_FALSE (HwhRecordSeek (&mIndex, FALSE));
+
+  //
+  // Only records 3, 2 and 1 were not in memory; 5, 6 and 0 are known to be invalid.
+  //
+  UT_ASSERT_EQUAL (mDataReads - Reads, 3);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Records are shown in the order of their numbers, whatever the order of the names.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RecordsInNumberOrder (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Number;
+
+  mVariableCount = 0;
+  for (Number = 0; Number < MOCK_RECORD_COUNT; Number++) {
+    AddRecord ((UINT16)((Number * 7) % MOCK_RECORD_COUNT));
+  }
+
+  AddRecord (0xFFFF);
+
+  UT_ASSERT_NOT_EFI_ERROR (HwhRecordIndexBuild (&mIndex));
+  UT_ASSERT_EQUAL (mIndex.Count, MOCK_RECORD_COUNT + 1);
+
+  for (Number = 0; Number < MOCK_RECORD_COUNT; Number++) {
+    UT_ASSERT_EQUAL (CurrentNumber (), Number);
+    UT_ASSERT_TRUE (HwhRecordSeek (&mIndex, TRUE));
+  }
+
+  UT_ASSERT_EQUAL (CurrentNumber (), 0xFFFF);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A record larger than the read buffer is read again into a larger one.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LargeRecordReadTwice (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FindVariable (L"HwErrRec0001", &gEfiHardwareErrorVariableGuid)->Size = MOCK_LARGE_SIZE;
+
+  UT_ASSERT_NOT_EFI_ERROR (HwhRecordIndexBuild (&mIndex));
+  UT_ASSERT_EQUAL (mDataReads, 3);
+
+  UT_ASSERT_TRUE (HwhRecordSeek (&mIndex, TRUE));
+  UT_ASSERT_EQUAL (CurrentNumber (), 1);
+  UT_ASSERT_EQUAL (HwhRecordCurrent (&mIndex)->RecordLength, MOCK_LARGE_SIZE);
+  UT_ASSERT_EQUAL (mIndex.Entries[mIndex.Current].Size, MOCK_LARGE_SIZE);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Without records there is no page to show.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+NoRecords (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  SectionCount;
+
+  mVariableCount = 0;
+  AddVariable (L"BootOrder", &gEfiGlobalVariableGuid);
+
+  UT_ASSERT_STATUS_EQUAL (HwhRecordIndexBuild (&mIndex), EFI_NOT_FOUND);
+  UT_ASSERT_EQUAL (mIndex.Count, 0);
+  UT_ASSERT_TRUE (HwhRecordCurrent (&mIndex) == NULL);
+  UT_ASSERT_TRUE (HwhRecordCurrentSections (&mIndex, &SectionCount) == NULL);
+  UT_ASSERT_EQUAL (SectionCount, 0);
+  UT_ASSERT_FALSE (HwhRecordSeek (&mIndex, TRUE));
+  UT_ASSERT_FALSE (HwhRecordSeekFirst (&mIndex));
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  record index and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      IndexSuite;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  mVariables = AllocatePool (MOCK_MAX_VARIABLES * sizeof (MOCK_VARIABLE));
+  if (mVariables == NULL) {
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&IndexSuite, Framework, "HwhMenu record index tests", "HwhMenu.Records", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for IndexSuite\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (IndexSuite, "Opening reads only the first pages", "OpenReadsFirstPages", OpenReadsFirstPages, SetUpStore, CleanUpIndex, NULL);
+  AddTestCase (IndexSuite, "A page flip reads one record", "PageFlipReadsOneRecord", PageFlipReadsOneRecord, SetUpStore, CleanUpIndex, NULL);
+  AddTestCase (IndexSuite, "Sections are indexed once, on load", "SectionsIndexedOnLoad", SectionsIndexedOnLoad, SetUpStore, CleanUpIndex, NULL);
+  AddTestCase (IndexSuite, "Paging stops at the last record", "PageToLastRecord", PageToLastRecord, SetUpStore, CleanUpIndex, NULL);
+  AddTestCase (IndexSuite, "Invalid records are skipped", "InvalidRecordsSkipped", InvalidRecordsSkipped, SetUpStore, CleanUpIndex, NULL);
+  AddTestCase (IndexSuite, "Records are in number order", "RecordsInNumberOrder", RecordsInNumberOrder, SetUpStore, CleanUpIndex, NULL);
+  AddTestCase (IndexSuite, "A large record is read twice", "LargeRecordReadTwice", LargeRecordReadTwice, SetUpStore, CleanUpIndex, NULL);
+  AddTestCase (IndexSuite, "No records", "NoRecords", NoRecords, SetUpStore, CleanUpIndex, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  if (mVariables != NULL) {
+    FreePool (mVariables);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
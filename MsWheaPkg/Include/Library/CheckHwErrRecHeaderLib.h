@@ -4,6 +4,26 @@ Copyright (C) Microsoft Corporation. All rights reserved.
 SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
 
+#ifndef CHECK_HW_ERR_REC_HEADER_LIB_H_
+#define CHECK_HW_ERR_REC_HEADER_LIB_H_
+
+// One section of a HwErrRec, taken from its section descriptor once the record was validated
+typedef struct {
+  EFI_GUID    SectionType;
+  UINT32      Offset;                         // From the start of the record
+  UINT32      Length;
+  UINT32      Severity;
+} CPER_SECTION_INDEX_ENTRY;
+
+// One record found by ValidateCperRecordBuffer
+typedef struct {
+  UINTN      Offset;                          // From the start of the buffer
+  UINT32     Length;                          // RecordLength of the record
+  BOOLEAN    Valid;                           // The record passed ValidateCperHeader
+  UINTN      FirstSection;                    // Entry in the section index of the first section, when indexed
+  UINT16     SectionCount;                    // Sections in the record, 0 when it is not valid
+} CPER_RECORD_INDEX_ENTRY;
+
 /**
  *  Checks that all length and offset fields within the HWErrRec fall within the bounds of
  *  the buffer, all section data is accounted for in their respective section headers, and that
@@ -21,3 +41,67 @@ ValidateCperHeader (
   IN CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err,
   IN CONST UINTN                           Size
   );
+
+/**
+ *  Makes the same checks as ValidateCperHeader and, in the same pass over the section descriptors,
+ *  fills Sections with the type, offset, length and severity of each section. Once this succeeds
+ *  the entries can be used to reach the section data without walking the descriptors again.
+ *
+ *  @param[in]      Err              -    Pointer to HWErr record being checked
+ *  @param[in]      Size             -    Size obtained from calling GetVariable() to obtain the record
+ *  @param[out]     Sections         -    Entries filled with the sections of the record. May be NULL
+ *                                        when *SectionCount is 0.
+ *  @param[in,out]  SectionCount     -    On input the number of entries in Sections. On output the
+ *                                        number of sections in the record.
+ *
+ *  @retval     EFI_SUCCESS              The record is safe and every section was indexed
+ *  @retval     EFI_INVALID_PARAMETER    SectionCount is NULL, or Sections is NULL and *SectionCount is not 0
+ *  @retval     EFI_COMPROMISED_DATA     The record failed the checks of ValidateCperHeader
+ *  @retval     EFI_BUFFER_TOO_SMALL     The record is safe but has more sections than Sections holds.
+ *                                       *SectionCount is set to the number needed.
+**/
+EFI_STATUS
+EFIAPI
+ValidateCperHeaderAndIndex (
+  IN     CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err,
+  IN     CONST UINTN                           Size,
+  OUT    CPER_SECTION_INDEX_ENTRY              *Sections OPTIONAL,
+  IN OUT UINTN                                 *SectionCount
+  );
+
+/**
+ *  Validates HwErrRecs laid back to back in one buffer, finding each record from the RecordLength
+ *  of the one before it. A record that fails the checks of ValidateCperHeader is marked not valid
+ *  and skipped. The walk stops at a header that cannot be trusted to find the next record: one
+ *  that is cut short, has the wrong signature, or has a RecordLength that is too small or runs past
+ *  the end of the buffer.
+ *
+ *  @param[in]      Buffer           -    Records to validate
+ *  @param[in]      BufferSize       -    Size of Buffer in bytes
+ *  @param[out]     Records          -    One entry for each record found
+ *  @param[in,out]  RecordCount      -    On input the number of entries in Records. On output the
+ *                                        number of records found.
+ *  @param[out]     Sections         -    Section index shared by every valid record. May be NULL when
+ *                                        *SectionCount is 0, in which case no sections are indexed.
+ *  @param[in,out]  SectionCount     -    On input the number of entries in Sections. On output the
+ *                                        number of entries used.
+ *
+ *  @retval     EFI_SUCCESS              The whole buffer was walked
+ *  @retval     EFI_INVALID_PARAMETER    A pointer is NULL when it may not be
+ *  @retval     EFI_COMPROMISED_DATA     The walk stopped at a header that could not be trusted. The
+ *                                       records before it are returned.
+ *  @retval     EFI_BUFFER_TOO_SMALL     Records or Sections filled up before the end of the buffer. The
+ *                                       records that fit are returned.
+**/
+EFI_STATUS
+EFIAPI
+ValidateCperRecordBuffer (
+  IN     CONST VOID                *Buffer,
+  IN     UINTN                     BufferSize,
+  OUT    CPER_RECORD_INDEX_ENTRY   *Records,
+  IN OUT UINTN                     *RecordCount,
+  OUT    CPER_SECTION_INDEX_ENTRY  *Sections OPTIONAL,
+  IN OUT UINTN                     *SectionCount
+  );
+
+#endif // CHECK_HW_ERR_REC_HEADER_LIB_H_
@@ -16,6 +16,8 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #ifndef _PARSER_REG_LIB_
 #define _PARSER_REG_LIB_
 
+#include <Library/CheckHwErrRecHeaderLib.h>
+
 typedef UINTN (*SECTIONFUNCTIONPTR)(
   IN OUT CHAR16 ***,
   IN CONST EFI_COMMON_ERROR_RECORD_HEADER *,
@@ -32,6 +34,26 @@ typedef struct SectionMapType {
 
 #pragma pack()
 
+// Lines of one section within PARSER_LIB_RECORD_LINES
+typedef struct {
+  UINTN    FirstLine;                          // Index into Lines of the first line of the section
+  UINTN    LineCount;                          // Number of lines the section's parser returned
+} PARSER_LIB_SECTION_LINES;
+
+// Output of ParserLibParseRecord. Zero it before first use and keep it between records so the
+// buffers are reused. Read lines with ParserLibGetLine and free with ParserLibFreeRecordLines.
+typedef struct {
+  CHAR16                      *Text;           // Every line back to back, each null-terminated
+  UINTN                       TextCapacity;    // CHAR16s allocated for Text
+  UINTN                       TextLength;      // CHAR16s used in Text
+  UINTN                       *Lines;          // Offset in CHAR16s of each line within Text
+  UINTN                       LineCapacity;
+  UINTN                       LineCount;
+  PARSER_LIB_SECTION_LINES    *Sections;       // One entry per decoded section
+  UINTN                       SectionCapacity;
+  UINTN                       SectionCount;
+} PARSER_LIB_RECORD_LINES;
+
 /**
  *  Inserts a guid and function pointer into the internal table. The function pointer can later be retrieved
  *  by calling ParserLibFindSectionParser with the guid used to register the function. Note that we do not allow one
@@ -41,6 +63,7 @@ typedef struct SectionMapType {
  *  @param[in]     Guid                       Guid being registered
  *
  *  @retval        EFI_SUCCESS                The guid and pointer were successfully registered
+ *                 EFI_INVALID_PARAMETER      Ptr or Guid is NULL
  *                 EFI_ABORTED                The guid has already been registered
  *                 EFI_OUT_OF_RESOURCES       Couldn't allocate the space required to store the guid and pointer
 **/
@@ -65,4 +88,90 @@ ParserLibFindSectionParser (
   IN CONST GUID  *Guid
   );
 
+/**
+ *  Decodes the sections of a HwErrRec in one call. Each section is handed to the parser registered
+ *  for its section type, or to DefaultParser when there is none, and the strings the parser returns are
+ *  copied into Output and then freed. Output keeps its buffers between calls, so decoding record after
+ *  record only allocates when a record produces more text than any before it.
+ *
+ *  @param[in]     Err                        HwErrRec being decoded. The header and section descriptors
+ *                                            must already have been validated.
+ *  @param[in]     DefaultParser              Parser used for sections with no registered parser. When NULL
+ *                                            those sections are recorded with no lines.
+ *  @param[in]     MaxSections                Most sections to decode, starting from the first
+ *  @param[in,out] Output                     Record lines being filled. Must be zeroed before first use.
+ *
+ *  @retval        EFI_SUCCESS                The sections were decoded
+ *                 EFI_INVALID_PARAMETER      Err or Output is NULL
+ *                 EFI_OUT_OF_RESOURCES       Couldn't grow Output. The sections decoded up to that point
+ *                                            are kept and every string the parser returned is freed.
+**/
+EFI_STATUS
+EFIAPI
+ParserLibParseRecord (
+  IN     CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err,
+  IN           SECTIONFUNCTIONPTR              DefaultParser OPTIONAL,
+  IN           UINTN                           MaxSections,
+  IN OUT       PARSER_LIB_RECORD_LINES         *Output
+  );
+
+/**
+ *  Decodes the sections of a HwErrRec the same way as ParserLibParseRecord, using the index
+ *  ValidateCperHeaderAndIndex made of the record instead of its descriptors. Each parser is handed a
+ *  descriptor made from the index entry: the section type, offset, length and severity are set and
+ *  the other fields are zero.
+ *
+ *  @param[in]     Err                        HwErrRec being decoded
+ *  @param[in]     Sections                   Sections of Err, as indexed by ValidateCperHeaderAndIndex
+ *  @param[in]     SectionCount               Number of entries in Sections
+ *  @param[in]     DefaultParser              Parser used for sections with no registered parser. When NULL
+ *                                            those sections are recorded with no lines.
+ *  @param[in]     MaxSections                Most sections to decode, starting from the first
+ *  @param[in,out] Output                     Record lines being filled. Must be zeroed before first use.
+ *
+ *  @retval        EFI_SUCCESS                The sections were decoded
+ *                 EFI_INVALID_PARAMETER      Err or Output is NULL, or Sections is NULL and SectionCount is not 0
+ *                 EFI_OUT_OF_RESOURCES       Couldn't grow Output. The sections decoded up to that point
+ *                                            are kept and every string the parser returned is freed.
+**/
+EFI_STATUS
+EFIAPI
+ParserLibParseIndexedRecord (
+  IN     CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err,
+  IN     CONST CPER_SECTION_INDEX_ENTRY        *Sections,
+  IN           UINTN                           SectionCount,
+  IN           SECTIONFUNCTIONPTR              DefaultParser OPTIONAL,
+  IN           UINTN                           MaxSections,
+  IN OUT       PARSER_LIB_RECORD_LINES         *Output
+  );
+
+/**
+ *  Retrieves one line of a section decoded by ParserLibParseRecord
+ *
+ *  @param[in]     Output                     Record lines filled by ParserLibParseRecord
+ *  @param[in]     Section                    Index of the section
+ *  @param[in]     Line                       Index of the line within the section
+ *
+ *  @retval        NULL                       The section or line does not exist
+ *                 Anything else              Null-terminated line, valid until Output is next filled or freed
+**/
+CONST CHAR16 *
+EFIAPI
+ParserLibGetLine (
+  IN CONST PARSER_LIB_RECORD_LINES  *Output,
+  IN       UINTN                    Section,
+  IN       UINTN                    Line
+  );
+
+/**
+ *  Frees the buffers held by record lines and zeroes them so they can be used again
+ *
+ *  @param[in,out] Output                     Record lines being freed
+**/
+VOID
+EFIAPI
+ParserLibFreeRecordLines (
+  IN OUT PARSER_LIB_RECORD_LINES  *Output
+  );
+
 #endif
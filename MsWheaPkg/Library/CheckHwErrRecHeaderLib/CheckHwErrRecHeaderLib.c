@@ -1,7 +1,8 @@
 /**@file CheckHwErrRecHeaderLib.c
 
 Validates that size fields within HWErrRecXXXX headers are within bounds. After validation, utilizing size
-and offset fields within the common header and section header(s) is safe
+and offset fields within the common header and section header(s) is safe. The sections can also be
+indexed in the same pass, and many records laid back to back in one buffer validated in one call.
 
 Copyright (C) Microsoft Corporation. All rights reserved.
 SPDX-License-Identifier: BSD-2-Clause-Patent
@@ -12,6 +13,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <Guid/Cper.h>
 
+#include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/CheckHwErrRecHeaderLib.h>
 #include <Library/SafeIntLib.h>
@@ -19,19 +21,25 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 /**
  *  Checks that all length and offset fields within the HWErrRec fall within the bounds of
  *  the buffer, all section data is accounted for in their respective section headers, and that
- *  all section data is contiguous
+ *  all section data is contiguous. Each section is recorded in Sections as its descriptor is
+ *  checked, so validating and indexing the record takes one walk of the descriptors.
  *
  *  @param[in]  Err              -    Pointer to HWErr record being checked
  *  @param[in]  Size             -    Size obtained from calling GetVariable() to obtain the record
+ *  @param[out] Sections         -    Entries filled with the sections of the record. Only the first
+ *                                    MaxSections sections are recorded.
+ *  @param[in]  MaxSections      -    Number of entries in Sections
  *
  *  @retval     BOOLEAN          -    TRUE if all length and offsets are safe
  *                                    FALSE otherwise
 **/
+STATIC
 BOOLEAN
-EFIAPI
-ValidateCperHeader (
-  IN CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err,
-  IN CONST UINTN                           Size
+ValidateRecord (
+  IN  CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err,
+  IN  CONST UINTN                           Size,
+  OUT CPER_SECTION_INDEX_ENTRY              *Sections OPTIONAL,
+  IN  UINTN                                 MaxSections
   )
 {
   EFI_ERROR_SECTION_DESCRIPTOR  *SectionHeader = (EFI_ERROR_SECTION_DESCRIPTOR *)(Err + 1);
@@ -110,6 +118,13 @@ ValidateCperHeader (
       return FALSE;
     }
 
+    if (i < MaxSections) {
+      CopyGuid (&Sections[i].SectionType, &SectionHeader->SectionType);
+      Sections[i].Offset   = SectionHeader->SectionOffset;
+      Sections[i].Length   = SectionHeader->SectionLength;
+      Sections[i].Severity = SectionHeader->Severity;
+    }
+
     SectionHeader += 1;
   }
 
@@ -121,3 +136,185 @@ ValidateCperHeader (
 
   return TRUE;
 }
+
+/**
+ *  Checks that all length and offset fields within the HWErrRec fall within the bounds of
+ *  the buffer, all section data is accounted for in their respective section headers, and that
+ *  all section data is contiguous
+ *
+ *  @param[in]  Err              -    Pointer to HWErr record being checked
+ *  @param[in]  Size             -    Size obtained from calling GetVariable() to obtain the record
+ *
+ *  @retval     BOOLEAN          -    TRUE if all length and offsets are safe
+ *                                    FALSE otherwise
+**/
+BOOLEAN
+EFIAPI
+ValidateCperHeader (
+  IN CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err,
+  IN CONST UINTN                           Size
+  )
+{
+  return ValidateRecord (Err, Size, NULL, 0);
+}
+
+/**
+ *  Makes the same checks as ValidateCperHeader and, in the same pass over the section descriptors,
+ *  fills Sections with the type, offset, length and severity of each section. Once this succeeds
+ *  the entries can be used to reach the section data without walking the descriptors again.
+ *
+ *  @param[in]      Err              -    Pointer to HWErr record being checked
+ *  @param[in]      Size             -    Size obtained from calling GetVariable() to obtain the record
+ *  @param[out]     Sections         -    Entries filled with the sections of the record. May be NULL
+ *                                        when *SectionCount is 0.
+ *  @param[in,out]  SectionCount     -    On input the number of entries in Sections. On output the
+ *                                        number of sections in the record.
+ *
+ *  @retval     EFI_SUCCESS              The record is safe and every section was indexed
+ *  @retval     EFI_INVALID_PARAMETER    SectionCount is NULL, or Sections is NULL and *SectionCount is not 0
+ *  @retval     EFI_COMPROMISED_DATA     The record failed the checks of ValidateCperHeader
+ *  @retval     EFI_BUFFER_TOO_SMALL     The record is safe but has more sections than Sections holds.
+ *                                       *SectionCount is set to the number needed.
+**/
+EFI_STATUS
+EFIAPI
+ValidateCperHeaderAndIndex (
+  IN     CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err,
+  IN     CONST UINTN                           Size,
+  OUT    CPER_SECTION_INDEX_ENTRY              *Sections OPTIONAL,
+  IN OUT UINTN                                 *SectionCount
+  )
+{
+  UINTN  MaxSections;
+
+  if ((SectionCount == NULL) || ((Sections == NULL) && (*SectionCount != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  MaxSections = *SectionCount;
+  if (!ValidateRecord (Err, Size, Sections, MaxSections)) {
+    return EFI_COMPROMISED_DATA;
+  }
+
+  *SectionCount = Err->SectionCount;
+  if (MaxSections < Err->SectionCount) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+ *  Validates HwErrRecs laid back to back in one buffer, finding each record from the RecordLength
+ *  of the one before it. A record that fails the checks of ValidateCperHeader is marked not valid
+ *  and skipped. The walk stops at a header that cannot be trusted to find the next record: one
+ *  that is cut short, has the wrong signature, or has a RecordLength that is too small or runs past
+ *  the end of the buffer.
+ *
+ *  @param[in]      Buffer           -    Records to validate
+ *  @param[in]      BufferSize       -    Size of Buffer in bytes
+ *  @param[out]     Records          -    One entry for each record found
+ *  @param[in,out]  RecordCount      -    On input the number of entries in Records. On output the
+ *                                        number of records found.
+ *  @param[out]     Sections         -    Section index shared by every valid record. May be NULL when
+ *                                        *SectionCount is 0, in which case no sections are indexed.
+ *  @param[in,out]  SectionCount     -    On input the number of entries in Sections. On output the
+ *                                        number of entries used.
+ *
+ *  @retval     EFI_SUCCESS              The whole buffer was walked
+ *  @retval     EFI_INVALID_PARAMETER    A pointer is NULL when it may not be
+ *  @retval     EFI_COMPROMISED_DATA     The walk stopped at a header that could not be trusted. The
+ *                                       records before it are returned.
+ *  @retval     EFI_BUFFER_TOO_SMALL     Records or Sections filled up before the end of the buffer. The
+ *                                       records that fit are returned.
+**/
+EFI_STATUS
+EFIAPI
+ValidateCperRecordBuffer (
+  IN     CONST VOID                *Buffer,
+  IN     UINTN                     BufferSize,
+  OUT    CPER_RECORD_INDEX_ENTRY   *Records,
+  IN OUT UINTN                     *RecordCount,
+  OUT    CPER_SECTION_INDEX_ENTRY  *Sections OPTIONAL,
+  IN OUT UINTN                     *SectionCount
+  )
+{
+  CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err;
+  CPER_RECORD_INDEX_ENTRY               *Record;
+  UINTN                                 MaxRecords;
+  UINTN                                 MaxSections;
+  UINTN                                 RecordsFound;
+  UINTN                                 SectionsUsed;
+  UINTN                                 Offset;
+  UINTN                                 Remaining;
+  BOOLEAN                               Valid;
+  EFI_STATUS                            Status;
+
+  if ((Buffer == NULL) || (Records == NULL) || (RecordCount == NULL) || (SectionCount == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if ((Sections == NULL) && (*SectionCount != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  MaxRecords   = *RecordCount;
+  MaxSections  = *SectionCount;
+  RecordsFound = 0;
+  SectionsUsed = 0;
+  Offset       = 0;
+  Status       = EFI_SUCCESS;
+
+  while (Offset < BufferSize) {
+    Err       = (CONST EFI_COMMON_ERROR_RECORD_HEADER *)((CONST UINT8 *)Buffer + Offset);
+    Remaining = BufferSize - Offset;
+
+    // Without a sound header there is no telling where the next record starts
+    if ((Remaining < sizeof (EFI_COMMON_ERROR_RECORD_HEADER)) ||
+        (Err->SignatureStart != EFI_ERROR_RECORD_SIGNATURE_START) ||
+        (Err->RecordLength < sizeof (EFI_COMMON_ERROR_RECORD_HEADER)) ||
+        (Err->RecordLength > Remaining))
+    {
+      DEBUG ((DEBUG_ERROR, "%a : Record header at offset 0x%X cannot be trusted\n", __FUNCTION__, Offset));
+      Status = EFI_COMPROMISED_DATA;
+      break;
+    }
+
+    if (RecordsFound == MaxRecords) {
+      Status = EFI_BUFFER_TOO_SMALL;
+      break;
+    }
+
+    // Sections are only indexed when there is an index to put them in
+    if (MaxSections == 0) {
+      Valid = ValidateRecord (Err, Err->RecordLength, NULL, 0);
+    } else {
+      Valid = ValidateRecord (Err, Err->RecordLength, &Sections[SectionsUsed], MaxSections - SectionsUsed);
+      if (Valid && (Err->SectionCount > MaxSections - SectionsUsed)) {
+        Status = EFI_BUFFER_TOO_SMALL;
+        break;
+      }
+    }
+
+    Record               = &Records[RecordsFound++];
+    Record->Offset       = Offset;
+    Record->Length       = Err->RecordLength;
+    Record->Valid        = Valid;
+    Record->FirstSection = SectionsUsed;
+    Record->SectionCount = 0;
+
+    if (Valid) {
+      Record->SectionCount = Err->SectionCount;
+      if (MaxSections != 0) {
+        SectionsUsed += Err->SectionCount;
+      }
+    }
+
+    Offset += Err->RecordLength;
+  }
+
+  *RecordCount  = RecordsFound;
+  *SectionCount = SectionsUsed;
+
+  return Status;
+}
@@ -5,6 +5,11 @@ Holds a table which associates a guid with a function. When ParserLibRegisterSec
 is called, a guid and function are put into the table. And when ParserLibFindSectionParser
 is called, the input guid is used to return an associated function (if one exists)
 
+The table is open addressed and keyed by a hash of the guid, so a lookup costs the same
+however many parsers have been registered. ParserLibParseRecord decodes every section of
+a HwErrRec in one call into buffers the caller keeps between records, and
+ParserLibParseIndexedRecord does the same from the section index of a record.
+
 Copyright (c) Microsoft Corporation. All rights reserved.
 SPDX-License-Identifier: BSD-2-Clause-Patent
 **/
@@ -20,59 +25,120 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <Library/ParserRegistryLib.h>
 
-struct {
-  SectionMapType    **Map;
-  UINTN             MaxNumber;
-  UINTN             CurrentNumber;
-} SectionMap = { NULL, 0, 0 };
+#define SECTION_MAP_INITIAL_CAPACITY  16        // Must be a power of 2
+#define RECORD_TEXT_INITIAL_CAPACITY  1024      // CHAR16s
+#define RECORD_LINE_INITIAL_CAPACITY  64
+#define RECORD_SECT_INITIAL_CAPACITY  4
+
+//
+// A slot is free while its Parser is NULL. Entries are never removed, so probing stops at
+// the first free slot.
+//
+STATIC struct {
+  SectionMapType    *Map;
+  UINTN             Capacity;
+  UINTN             Count;
+} mSectionMap = { NULL, 0, 0 };
 
 /**
- *  Inserts a guid and function pointer into the internal table. The function pointer can later be retrieved
- *  by calling ParserLibFindSectionParser with the guid used to register the function. Note that we do not allow one
- *  guid to register more than one function.
+ *  Folds a guid into a hash used to pick its first slot in the table
  *
- *  @param[in,out]      Map                        Pointer to Function map the entry is being added to
- *  @param[in,out]      MaxNumber                  Max number of pointers which can be registered in current allocate
- *  @param[in,out]      CurrentNumber              Current number of pointers in the map
- *  @param[in]          Entry                      Element being added to map
+ *  @param[in]     Guid                       Guid being hashed
  *
- *  @retval             EFI_SUCCESS                The entry was successfully added
- *                      EFI_OUT_OF_RESOURCES       Couldn't allocate the space required to store the entry
+ *  @retval        UINTN                      Hash of the guid
 **/
-EFI_STATUS
-EFIAPI
-AddTableEntry (
-  IN OUT VOID   ***Map,           // Keeping this void for generality
-  IN OUT UINTN  *MaxNumber,
-  IN OUT UINTN  *CurrentNumber,
-  IN     VOID   *Entry
+STATIC
+UINTN
+HashGuid (
+  IN CONST GUID  *Guid
+  )
+{
+  UINT32  Hash;
+
+  // Section type guids are often generated from one another, so mix every word in
+  Hash  = ReadUnaligned32 ((CONST UINT32 *)Guid);
+  Hash  = (Hash * 0x9E3779B1) ^ ReadUnaligned32 ((CONST UINT32 *)Guid + 1);
+  Hash  = (Hash * 0x9E3779B1) ^ ReadUnaligned32 ((CONST UINT32 *)Guid + 2);
+  Hash  = (Hash * 0x9E3779B1) ^ ReadUnaligned32 ((CONST UINT32 *)Guid + 3);
+  Hash ^= Hash >> 15;
+  Hash *= 0x85EBCA6B;
+  Hash ^= Hash >> 13;
+
+  return (UINTN)Hash;
+}
+
+/**
+ *  Finds the slot holding the guid or, if the guid has not been registered, the free slot
+ *  where it would be placed
+ *
+ *  @param[in]     Map                        Table being searched
+ *  @param[in]     Capacity                   Number of slots in the table, a power of 2
+ *  @param[in]     Guid                       Guid being searched for
+ *
+ *  @retval        SectionMapType*            Slot for the guid
+**/
+STATIC
+SectionMapType *
+FindSlot (
+  IN SectionMapType  *Map,
+  IN UINTN           Capacity,
+  IN CONST GUID      *Guid
   )
 {
-  VOID  **TempMap;
-
-  // Check whether the table is enough to store new entry.
-  if (*CurrentNumber == *MaxNumber) {
-    // Reallocate memory for the table.
-    TempMap = ReallocatePool (
-                *MaxNumber * sizeof (VOID *),
-                (*MaxNumber + 5) * sizeof (VOID *),              // just increase 5 spaces for now
-                *Map
-                );
-
-    // No enough resource to allocate.
-    if (TempMap == NULL) {
-      return EFI_OUT_OF_RESOURCES;
+  UINTN  Index;
+
+  Index = HashGuid (Guid) & (Capacity - 1);
+
+  // The table is never more than half full, so there is always a free slot to stop at
+  while (Map[Index].Parser != NULL) {
+    if (CompareGuid (&Map[Index].Guid, Guid)) {
+      break;
     }
 
-    *Map = TempMap;
+    Index = (Index + 1) & (Capacity - 1);
+  }
+
+  return &Map[Index];
+}
+
+/**
+ *  Doubles the size of the table and rehashes every entry into the new one
+ *
+ *  @retval        EFI_SUCCESS                The table was grown
+ *                 EFI_OUT_OF_RESOURCES       Couldn't allocate the larger table, the old one is untouched
+**/
+STATIC
+EFI_STATUS
+GrowSectionMap (
+  VOID
+  )
+{
+  SectionMapType  *NewMap;
+  UINTN           NewCapacity;
+  UINTN           Index;
 
-    // Increase max number.
-    *MaxNumber += 5;
+  NewCapacity = (mSectionMap.Capacity == 0) ? SECTION_MAP_INITIAL_CAPACITY : mSectionMap.Capacity * 2;
+  NewMap      = AllocateZeroPool (NewCapacity * sizeof (SectionMapType));
+  if (NewMap == NULL) {
+    return EFI_OUT_OF_RESOURCES;
   }
 
-  // Add entry to the table.
-  (*Map)[*CurrentNumber] = Entry;
-  (*CurrentNumber)++;
+  for (Index = 0; Index < mSectionMap.Capacity; Index++) {
+    if (mSectionMap.Map[Index].Parser != NULL) {
+      CopyMem (
+        FindSlot (NewMap, NewCapacity, &mSectionMap.Map[Index].Guid),
+        &mSectionMap.Map[Index],
+        sizeof (SectionMapType)
+        );
+    }
+  }
+
+  if (mSectionMap.Map != NULL) {
+    FreePool (mSectionMap.Map);
+  }
+
+  mSectionMap.Map      = NewMap;
+  mSectionMap.Capacity = NewCapacity;
 
   return EFI_SUCCESS;
 }
@@ -86,6 +152,7 @@ AddTableEntry (
  *  @param[in]     Guid                       Guid being registered
  *
  *  @retval        EFI_SUCCESS                The guid and pointer were successfully registered
+ *                 EFI_INVALID_PARAMETER      Ptr or Guid is NULL
  *                 EFI_ABORTED                The guid has already been registered
  *                 EFI_OUT_OF_RESOURCES       Couldn't allocate the space required to store the guid and pointer
 **/
@@ -96,18 +163,33 @@ ParserLibRegisterSectionParser (
   IN CONST GUID                *Guid
   )
 {
-  for (UINTN i = 0; i < SectionMap.CurrentNumber; i++) {
-    if (CompareGuid ((GUID *)&(SectionMap.Map[i]->Guid), Guid)) {
-      return EFI_ABORTED;
-    }
+  SectionMapType  *Slot;
+  EFI_STATUS      Status;
+
+  if ((Ptr == NULL) || (Guid == NULL)) {
+    return EFI_INVALID_PARAMETER;
   }
 
-  SectionMapType  *new =  AllocatePool (sizeof (SectionMapType));
+  if ((mSectionMap.Map != NULL) &&
+      (FindSlot (mSectionMap.Map, mSectionMap.Capacity, Guid)->Parser != NULL))
+  {
+    return EFI_ABORTED;
+  }
 
-  new->Guid   = *Guid;
-  new->Parser =  Ptr;
+  // Keep the load at or below one half so probe runs stay short
+  if ((mSectionMap.Count + 1) * 2 > mSectionMap.Capacity) {
+    Status = GrowSectionMap ();
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
 
-  return AddTableEntry ((VOID *)(&SectionMap.Map), &SectionMap.MaxNumber, &SectionMap.CurrentNumber, (VOID *)new);
+  Slot = FindSlot (mSectionMap.Map, mSectionMap.Capacity, Guid);
+  CopyGuid (&Slot->Guid, Guid);
+  Slot->Parser = Ptr;
+  mSectionMap.Count++;
+
+  return EFI_SUCCESS;
 }
 
 /**
@@ -124,11 +206,341 @@ ParserLibFindSectionParser (
   IN CONST GUID  *Guid
   )
 {
-  for (UINTN i = 0; i < SectionMap.CurrentNumber; i++) {
-    if (CompareGuid ((GUID *)&(SectionMap.Map[i]->Guid), Guid)) {
-      return SectionMap.Map[i]->Parser;
+  if ((Guid == NULL) || (mSectionMap.Map == NULL)) {
+    return NULL;
+  }
+
+  return FindSlot (mSectionMap.Map, mSectionMap.Capacity, Guid)->Parser;
+}
+
+/**
+ *  Makes sure a buffer has room for at least Needed elements, growing it geometrically.
+ *  The contents are kept.
+ *
+ *  @param[in,out] Buffer                     Buffer being grown
+ *  @param[in,out] Capacity                   Elements the buffer holds, updated when it grows
+ *  @param[in]     Needed                     Elements the buffer must hold
+ *  @param[in]     ElementSize                Size of one element in bytes
+ *  @param[in]     InitialCapacity            Capacity given to a buffer that has not been allocated yet
+ *
+ *  @retval        EFI_SUCCESS                The buffer holds at least Needed elements
+ *                 EFI_OUT_OF_RESOURCES       Couldn't grow the buffer, it is untouched
+**/
+STATIC
+EFI_STATUS
+ReserveBuffer (
+  IN OUT VOID   **Buffer,
+  IN OUT UINTN  *Capacity,
+  IN     UINTN  Needed,
+  IN     UINTN  ElementSize,
+  IN     UINTN  InitialCapacity
+  )
+{
+  VOID   *NewBuffer;
+  UINTN  NewCapacity;
+
+  if (Needed <= *Capacity) {
+    return EFI_SUCCESS;
+  }
+
+  NewCapacity = (*Capacity == 0) ? InitialCapacity : *Capacity;
+  while (NewCapacity < Needed) {
+    NewCapacity *= 2;
+  }
+
+  NewBuffer = ReallocatePool (*Capacity * ElementSize, NewCapacity * ElementSize, *Buffer);
+  if (NewBuffer == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  *Buffer   = NewBuffer;
+  *Capacity = NewCapacity;
+
+  return EFI_SUCCESS;
+}
+
+/**
+ *  Copies one string returned by a parser to the end of the record text
+ *
+ *  @param[in,out] Output                     Record lines being filled
+ *  @param[in]     String                     Null-terminated string being copied
+ *
+ *  @retval        EFI_SUCCESS                The string was appended as a new line
+ *                 EFI_OUT_OF_RESOURCES       Couldn't grow the buffers to hold the string
+**/
+STATIC
+EFI_STATUS
+AppendLine (
+  IN OUT PARSER_LIB_RECORD_LINES  *Output,
+  IN     CONST CHAR16             *String
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Length;
+
+  Length = StrLen (String) + 1;
+
+  Status = ReserveBuffer (
+             (VOID **)&Output->Text,
+             &Output->TextCapacity,
+             Output->TextLength + Length,
+             sizeof (CHAR16),
+             RECORD_TEXT_INITIAL_CAPACITY
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = ReserveBuffer (
+             (VOID **)&Output->Lines,
+             &Output->LineCapacity,
+             Output->LineCount + 1,
+             sizeof (UINTN),
+             RECORD_LINE_INITIAL_CAPACITY
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  CopyMem (&Output->Text[Output->TextLength], String, Length * sizeof (CHAR16));
+  Output->Lines[Output->LineCount++] = Output->TextLength;
+  Output->TextLength                += Length;
+
+  return EFI_SUCCESS;
+}
+
+/**
+ *  Decodes the first MaxSections sections of a HwErrRec into Output. When Sections is given the
+ *  descriptors of the record are not read: each parser is handed a descriptor made from the index
+ *  entry, holding the section type, offset, length and severity.
+ *
+ *  @param[in]     Err                        HwErrRec being decoded
+ *  @param[in]     Sections                   Section index of Err, or NULL to read the descriptors
+ *  @param[in]     DefaultParser              Parser used for sections with no registered parser
+ *  @param[in]     MaxSections                Sections to decode. No more than the record holds.
+ *  @param[in,out] Output                     Record lines being filled
+ *
+ *  @retval        EFI_SUCCESS                The sections were decoded
+ *                 EFI_OUT_OF_RESOURCES       Couldn't grow Output
+**/
+STATIC
+EFI_STATUS
+ParseSections (
+  IN     CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err,
+  IN     CONST CPER_SECTION_INDEX_ENTRY        *Sections OPTIONAL,
+  IN           SECTIONFUNCTIONPTR              DefaultParser OPTIONAL,
+  IN           UINTN                           MaxSections,
+  IN OUT       PARSER_LIB_RECORD_LINES         *Output
+  )
+{
+  CONST EFI_ERROR_SECTION_DESCRIPTOR  *SectionHeader;
+  EFI_ERROR_SECTION_DESCRIPTOR        IndexedHeader;
+  SECTIONFUNCTIONPTR                  SectionParser;
+  PARSER_LIB_SECTION_LINES            *Section;
+  CHAR16                              **Strings;
+  UINTN                               NumberOfStrings;
+  UINTN                               SectionIndex;
+  UINTN                               StringIndex;
+  EFI_STATUS                          Status;
+
+  Output->TextLength   = 0;
+  Output->LineCount    = 0;
+  Output->SectionCount = 0;
+
+  Status = ReserveBuffer (
+             (VOID **)&Output->Sections,
+             &Output->SectionCapacity,
+             MaxSections,
+             sizeof (PARSER_LIB_SECTION_LINES),
+             RECORD_SECT_INITIAL_CAPACITY
+             );
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (SectionIndex = 0; SectionIndex < MaxSections; SectionIndex++) {
+    Section            = &Output->Sections[Output->SectionCount++];
+    Section->FirstLine = Output->LineCount;
+    Section->LineCount = 0;
+
+    if (Sections != NULL) {
+      ZeroMem (&IndexedHeader, sizeof (IndexedHeader));
+      CopyGuid (&IndexedHeader.SectionType, &Sections[SectionIndex].SectionType);
+      IndexedHeader.SectionOffset = Sections[SectionIndex].Offset;
+      IndexedHeader.SectionLength = Sections[SectionIndex].Length;
+      IndexedHeader.Severity      = Sections[SectionIndex].Severity;
+      SectionHeader               = &IndexedHeader;
+    } else {
+      SectionHeader = (CONST EFI_ERROR_SECTION_DESCRIPTOR *)(Err + 1) + SectionIndex;
+    }
+
+    SectionParser = ParserLibFindSectionParser ((CONST GUID *)&SectionHeader->SectionType);
+    if (SectionParser == NULL) {
+      SectionParser = DefaultParser;
+    }
+
+    if (SectionParser == NULL) {
+      continue;
     }
+
+    Strings         = NULL;
+    NumberOfStrings = SectionParser (&Strings, Err, SectionHeader);
+
+    for (StringIndex = 0; StringIndex < NumberOfStrings; StringIndex++) {
+      // If this string was not allocated for some reason, just move on to the next one
+      if (Strings[StringIndex] == NULL) {
+        continue;
+      }
+
+      // Once out of space keep going so the rest of the strings are freed as well
+      if (!EFI_ERROR (Status)) {
+        Status = AppendLine (Output, Strings[StringIndex]);
+        if (!EFI_ERROR (Status)) {
+          Section->LineCount++;
+        }
+      }
+
+      FreePool (Strings[StringIndex]);
+    }
+
+    if (Strings != NULL) {
+      FreePool (Strings);
+    }
+
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a - Out of space decoding section %d\n", __FUNCTION__, (UINT32)SectionIndex));
+      break;
+    }
+  }
+
+  return Status;
+}
+
+/**
+ *  Decodes the sections of a HwErrRec in one call. Each section is handed to the parser registered
+ *  for its section type, or to DefaultParser when there is none, and the strings the parser returns are
+ *  copied into Output and then freed. Output keeps its buffers between calls, so decoding record after
+ *  record only allocates when a record produces more text than any before it.
+ *
+ *  @param[in]     Err                        HwErrRec being decoded. The header and section descriptors
+ *                                            must already have been validated.
+ *  @param[in]     DefaultParser              Parser used for sections with no registered parser. When NULL
+ *                                            those sections are recorded with no lines.
+ *  @param[in]     MaxSections                Most sections to decode, starting from the first
+ *  @param[in,out] Output                     Record lines being filled. Must be zeroed before first use.
+ *
+ *  @retval        EFI_SUCCESS                The sections were decoded
+ *                 EFI_INVALID_PARAMETER      Err or Output is NULL
+ *                 EFI_OUT_OF_RESOURCES       Couldn't grow Output. The sections decoded up to that point
+ *                                            are kept and every string the parser returned is freed.
+**/
+EFI_STATUS
+EFIAPI
+ParserLibParseRecord (
+  IN     CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err,
+  IN           SECTIONFUNCTIONPTR              DefaultParser OPTIONAL,
+  IN           UINTN                           MaxSections,
+  IN OUT       PARSER_LIB_RECORD_LINES         *Output
+  )
+{
+  if ((Err == NULL) || (Output == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return ParseSections (Err, NULL, DefaultParser, MIN (MaxSections, Err->SectionCount), Output);
+}
+
+/**
+ *  Decodes the sections of a HwErrRec the same way as ParserLibParseRecord, using the index
+ *  ValidateCperHeaderAndIndex made of the record instead of its descriptors. Each parser is handed a
+ *  descriptor made from the index entry: the section type, offset, length and severity are set and
+ *  the other fields are zero.
+ *
+ *  @param[in]     Err                        HwErrRec being decoded
+ *  @param[in]     Sections                   Sections of Err, as indexed by ValidateCperHeaderAndIndex
+ *  @param[in]     SectionCount               Number of entries in Sections
+ *  @param[in]     DefaultParser              Parser used for sections with no registered parser. When NULL
+ *                                            those sections are recorded with no lines.
+ *  @param[in]     MaxSections                Most sections to decode, starting from the first
+ *  @param[in,out] Output                     Record lines being filled. Must be zeroed before first use.
+ *
+ *  @retval        EFI_SUCCESS                The sections were decoded
+ *                 EFI_INVALID_PARAMETER      Err or Output is NULL, or Sections is NULL and SectionCount is not 0
+ *                 EFI_OUT_OF_RESOURCES       Couldn't grow Output. The sections decoded up to that point
+ *                                            are kept and every string the parser returned is freed.
+**/
+EFI_STATUS
+EFIAPI
+ParserLibParseIndexedRecord (
+  IN     CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err,
+  IN     CONST CPER_SECTION_INDEX_ENTRY        *Sections,
+  IN           UINTN                           SectionCount,
+  IN           SECTIONFUNCTIONPTR              DefaultParser OPTIONAL,
+  IN           UINTN                           MaxSections,
+  IN OUT       PARSER_LIB_RECORD_LINES         *Output
+  )
+{
+  if ((Err == NULL) || (Output == NULL) || ((Sections == NULL) && (SectionCount != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  return ParseSections (Err, Sections, DefaultParser, MIN (MaxSections, SectionCount), Output);
+}
+
+/**
+ *  Retrieves one line of a section decoded by ParserLibParseRecord
+ *
+ *  @param[in]     Output                     Record lines filled by ParserLibParseRecord
+ *  @param[in]     Section                    Index of the section
+ *  @param[in]     Line                       Index of the line within the section
+ *
+ *  @retval        NULL                       The section or line does not exist
+ *                 Anything else              Null-terminated line, valid until Output is next filled or freed
+**/
+CONST CHAR16 *
+EFIAPI
+ParserLibGetLine (
+  IN CONST PARSER_LIB_RECORD_LINES  *Output,
+  IN       UINTN                    Section,
+  IN       UINTN                    Line
+  )
+{
+  if ((Output == NULL) ||
+      (Section >= Output->SectionCount) ||
+      (Line >= Output->Sections[Section].LineCount))
+  {
+    return NULL;
+  }
+
+  return &Output->Text[Output->Lines[Output->Sections[Section].FirstLine + Line]];
+}
+
+/**
+ *  Frees the buffers held by record lines and zeroes them so they can be used again
+ *
+ *  @param[in,out] Output                     Record lines being freed
+**/
+VOID
+EFIAPI
+ParserLibFreeRecordLines (
+  IN OUT PARSER_LIB_RECORD_LINES  *Output
+  )
+{
+  if (Output == NULL) {
+    return;
+  }
+
+  if (Output->Text != NULL) {
+    FreePool (Output->Text);
+  }
+
+  if (Output->Lines != NULL) {
+    FreePool (Output->Lines);
+  }
+
+  if (Output->Sections != NULL) {
+    FreePool (Output->Sections);
   }
 
-  return NULL;
+  ZeroMem (Output, sizeof (*Output));
 }
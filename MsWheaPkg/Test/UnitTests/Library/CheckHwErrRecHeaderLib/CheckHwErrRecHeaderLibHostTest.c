@@ -0,0 +1,846 @@
+/** @file -- CheckHwErrRecHeaderLibHostTest.c
+Host-based UnitTest for CheckHwErrRecHeaderLib.
+
+Checks the section index made while validating a record, validates records laid back to back
+in one buffer, and runs both over thousands of randomly corrupted records. Every record is put in
+an allocation of exactly its size so any read past the end is caught by the host sanitizers.
+
+Copyright (c) Microsoft Corporation
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <time.h>
+
+#include <Uefi.h>
+
+#include <Guid/Cper.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+
+#include <Library/CheckHwErrRecHeaderLib.h>
+
+#define UNIT_TEST_NAME     "CheckHwErrRecHeaderLib Unit Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define MAX_TEST_SECTIONS   8
+#define MAX_SECTION_LENGTH  96
+#define FUZZ_ROUNDS         20000
+#define FUZZ_BATCH_RECORDS  64
+#define BENCH_RECORDS       4096
+#define BENCH_SECTIONS      8
+#define BENCH_SECTION_LEN   64
+#define BENCHMARK_ROUNDS    100
+
+STATIC EFI_GUID  mSectionGuidBase = {
+  0x5e2f7a10, 0x3c4d, 0x4b8e, { 0x91, 0x06, 0xd4, 0x7a, 0x2b, 0xe3, 0x58, 0xc1 }
+};
+
+STATIC UINT32                    mRandom;
+STATIC UINT8                     *mBuffer;
+STATIC CPER_RECORD_INDEX_ENTRY   *mRecords;
+STATIC CPER_SECTION_INDEX_ENTRY  *mSections;
+
+/**
+  Returns the next number from a xorshift generator, so every run corrupts records the same way.
+**/
+STATIC
+UINT32
+NextRandom (
+  VOID
+  )
+{
+  mRandom ^= mRandom << 13;
+  mRandom ^= mRandom >> 17;
+  mRandom ^= mRandom << 5;
+  return mRandom;
+}
+
+/**
+  Returns the size of a record with SectionCount sections of SectionLength bytes each.
+**/
+STATIC
+UINTN
+RecordSize (
+  IN UINT16  SectionCount,
+  IN UINT32  SectionLength
+  )
+{
+  return sizeof (EFI_COMMON_ERROR_RECORD_HEADER) +
+         SectionCount * (sizeof (EFI_ERROR_SECTION_DESCRIPTOR) + SectionLength);
+}
+
+/**
+  Writes a valid record with SectionCount sections of SectionLength bytes each at Buffer. Each
+  section gets its own type and severity, and its data is filled from Seed.
+
+  @retval  Size of the record.
+**/
+STATIC
+UINTN
+WriteRecord (
+  OUT UINT8   *Buffer,
+  IN  UINT16  SectionCount,
+  IN  UINT32  SectionLength,
+  IN  UINT32  Seed
+  )
+{
+  EFI_COMMON_ERROR_RECORD_HEADER  *Header;
+  EFI_ERROR_SECTION_DESCRIPTOR    *Section;
+  UINTN                           Size;
+  UINTN                           Index;
+
+  Size   = RecordSize (SectionCount, SectionLength);
+  Header = (EFI_COMMON_ERROR_RECORD_HEADER *)Buffer;
+  ZeroMem (Header, sizeof (EFI_COMMON_ERROR_RECORD_HEADER) + SectionCount * sizeof (EFI_ERROR_SECTION_DESCRIPTOR));
+  Header->SignatureStart = EFI_ERROR_RECORD_SIGNATURE_START;
+  Header->Revision       = EFI_ERROR_RECORD_REVISION;
+  Header->SignatureEnd   = EFI_ERROR_RECORD_SIGNATURE_END;
+  Header->SectionCount   = SectionCount;
+  Header->RecordLength   = (UINT32)Size;
+
+  Section = (EFI_ERROR_SECTION_DESCRIPTOR *)(Header + 1);
+  for (Index = 0; Index < SectionCount; Index++) {
+    Section[Index].SectionOffset = (UINT32)(RecordSize (SectionCount, 0) + Index * SectionLength);
+    Section[Index].SectionLength = SectionLength;
+    Section[Index].Severity      = (UINT32)((Seed + Index) % 4);
+    CopyGuid (&Section[Index].SectionType, &mSectionGuidBase);
+    Section[Index].SectionType.Data1 += Seed + (UINT32)Index;
+    SetMem (Buffer + Section[Index].SectionOffset, SectionLength, (UINT8)(Seed + Index));
+  }
+
+  return Size;
+}
+
+/**
+  Checks a record against the rules for a HwErrRec written out plainly, to compare the library with.
+
+  @retval  TRUE if the record is well formed.
+**/
+STATIC
+BOOLEAN
+ReferenceValid (
+  IN CONST UINT8  *Buffer,
+  IN UINTN        Size
+  )
+{
+  CONST EFI_COMMON_ERROR_RECORD_HEADER  *Header;
+  CONST EFI_ERROR_SECTION_DESCRIPTOR    *Section;
+  UINT64                                Expected;
+  UINTN                                 Index;
+
+  Header = (CONST EFI_COMMON_ERROR_RECORD_HEADER *)Buffer;
+  if ((Size < sizeof (EFI_COMMON_ERROR_RECORD_HEADER)) ||
+      (Header->SignatureStart != EFI_ERROR_RECORD_SIGNATURE_START) ||
+      (Header->RecordLength != Size))
+  {
+    return FALSE;
+  }
+
+  Expected = RecordSize (Header->SectionCount, 0);
+  if (Expected > Size) {
+    return FALSE;
+  }
+
+  Section = (CONST EFI_ERROR_SECTION_DESCRIPTOR *)(Header + 1);
+  for (Index = 0; Index < Header->SectionCount; Index++) {
+    if ((Section[Index].SectionOffset != Expected) || (Section[Index].SectionLength == 0)) {
+      return FALSE;
+    }
+
+    Expected += Section[Index].SectionLength;
+    if (Expected > Size) {
+      return FALSE;
+    }
+  }
+
+  return Expected == Size;
+}
+
+/**
+  Checks that Sections describes every section of a record that is known to be valid, and reads
+  the data of each section so a bad entry would be caught reading out of bounds.
+
+  @retval  TRUE if every entry matches the descriptor of its section.
+**/
+STATIC
+BOOLEAN
+IndexMatchesRecord (
+  IN CONST UINT8                     *Buffer,
+  IN UINTN                           Size,
+  IN CONST CPER_SECTION_INDEX_ENTRY  *Sections,
+  IN UINTN                           SectionCount
+  )
+{
+  CONST EFI_COMMON_ERROR_RECORD_HEADER  *Header;
+  CONST EFI_ERROR_SECTION_DESCRIPTOR    *Section;
+  UINTN                                 Index;
+  UINTN                                 Byte;
+  volatile UINT8                        Sum;
+
+  Header  = (CONST EFI_COMMON_ERROR_RECORD_HEADER *)Buffer;
+  Section = (CONST EFI_ERROR_SECTION_DESCRIPTOR *)(Header + 1);
+  if (SectionCount != Header->SectionCount) {
+    return FALSE;
+  }
+
+  Sum = 0;
+  for (Index = 0; Index < SectionCount; Index++) {
+    if (!CompareGuid (&Sections[Index].SectionType, &Section[Index].SectionType) ||
+        (Sections[Index].Offset != Section[Index].SectionOffset) ||
+        (Sections[Index].Length != Section[Index].SectionLength) ||
+        (Sections[Index].Severity != Section[Index].Severity) ||
+        ((UINT64)Sections[Index].Offset + Sections[Index].Length > Size))
+    {
+      return FALSE;
+    }
+
+    for (Byte = 0; Byte < Sections[Index].Length; Byte++) {
+      Sum += Buffer[Sections[Index].Offset + Byte];
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Corrupts a record the ways a damaged or hostile HwErrRec tends to be: a flipped bit anywhere,
+  or a length, count or offset field pushed a little or a lot. The size of the record can change
+  as well, in which case bytes past the old size are filled at random.
+
+  @param[in,out]  Buffer    Record to corrupt. Must have room for MaxSize bytes.
+  @param[in,out]  Size      Size of the record
+  @param[in]      MaxSize   Size of Buffer
+**/
+STATIC
+VOID
+CorruptRecord (
+  IN OUT UINT8  *Buffer,
+  IN OUT UINTN  *Size,
+  IN     UINTN  MaxSize
+  )
+{
+  EFI_COMMON_ERROR_RECORD_HEADER  *Header;
+  EFI_ERROR_SECTION_DESCRIPTOR    *Section;
+  UINTN                           Descriptors;
+  UINTN                           Mutations;
+  UINTN                           Index;
+  INTN                            NewSize;
+  INT32                           Delta;
+
+  Header  = (EFI_COMMON_ERROR_RECORD_HEADER *)Buffer;
+  Section = (EFI_ERROR_SECTION_DESCRIPTOR *)(Header + 1);
+
+  for (Mutations = 1 + NextRandom () % 3; Mutations > 0; Mutations--) {
+    // Small nudges find off by one mistakes, large values find overflows
+    Delta = (INT32)(NextRandom () % 9) - 4;
+
+    // Only descriptors that are inside the record can be corrupted
+    Descriptors = 0;
+    if (*Size > sizeof (EFI_COMMON_ERROR_RECORD_HEADER)) {
+      Descriptors = MIN (Header->SectionCount, (*Size - sizeof (EFI_COMMON_ERROR_RECORD_HEADER)) / sizeof (EFI_ERROR_SECTION_DESCRIPTOR));
+    }
+
+    switch (NextRandom () % 6) {
+      case 0:
+        Index          = NextRandom () % *Size;
+        Buffer[Index] ^= (UINT8)(1 << (NextRandom () % 8));
+        break;
+
+      case 1:
+        Header->RecordLength = (NextRandom () % 2) ? NextRandom () : (UINT32)(Header->RecordLength + Delta);
+        break;
+
+      case 2:
+        Header->SectionCount = (NextRandom () % 2) ? (UINT16)NextRandom () : (UINT16)(Header->SectionCount + Delta);
+        break;
+
+      case 3:
+        if (Descriptors != 0) {
+          Index                        = NextRandom () % Descriptors;
+          Section[Index].SectionOffset = (NextRandom () % 2) ? NextRandom () : (UINT32)(Section[Index].SectionOffset + Delta);
+        }
+
+        break;
+
+      case 4:
+        if (Descriptors != 0) {
+          Index                        = NextRandom () % Descriptors;
+          Section[Index].SectionLength = (NextRandom () % 4 == 0) ? 0 : (NextRandom () % 2) ? NextRandom () : (UINT32)(Section[Index].SectionLength + Delta);
+        }
+
+        break;
+
+      default:
+        NewSize = (INTN)*Size + Delta * (INTN)(1 + NextRandom () % 64);
+        NewSize = MAX (MIN (NewSize, (INTN)MaxSize), 1);
+        for (Index = *Size; Index < (UINTN)NewSize; Index++) {
+          Buffer[Index] = (UINT8)NextRandom ();
+        }
+
+        *Size = (UINTN)NewSize;
+        break;
+    }
+  }
+}
+
+/**
+  Frees what a test allocated.
+**/
+VOID
+EFIAPI
+CleanUpBuffers (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mBuffer != NULL) {
+    FreePool (mBuffer);
+    mBuffer = NULL;
+  }
+
+  if (mRecords != NULL) {
+    FreePool (mRecords);
+    mRecords = NULL;
+  }
+
+  if (mSections != NULL) {
+    FreePool (mSections);
+    mSections = NULL;
+  }
+}
+
+/**
+  Validating a record indexes every section in it.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexValidRecord (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CPER_SECTION_INDEX_ENTRY  Sections[MAX_TEST_SECTIONS];
+  UINTN                     Size;
+  UINTN                     Count;
+
+  mBuffer = AllocatePool (RecordSize (MAX_TEST_SECTIONS, MAX_SECTION_LENGTH));
+  UT_ASSERT_NOT_NULL (mBuffer);
+
+  Size  = WriteRecord (mBuffer, MAX_TEST_SECTIONS, MAX_SECTION_LENGTH, 7);
+  Count = MAX_TEST_SECTIONS;
+  UT_ASSERT_TRUE (ValidateCperHeader ((EFI_COMMON_ERROR_RECORD_HEADER *)mBuffer, Size));
+  UT_ASSERT_NOT_EFI_ERROR (ValidateCperHeaderAndIndex ((EFI_COMMON_ERROR_RECORD_HEADER *)mBuffer, Size, Sections, &Count));
+  UT_ASSERT_EQUAL (Count, MAX_TEST_SECTIONS);
+  UT_ASSERT_TRUE (IndexMatchesRecord (mBuffer, Size, Sections, Count));
+
+  // A record with no sections needs no index
+  Size  = WriteRecord (mBuffer, 0, 0, 0);
+  Count = 0;
+  UT_ASSERT_NOT_EFI_ERROR (ValidateCperHeaderAndIndex ((EFI_COMMON_ERROR_RECORD_HEADER *)mBuffer, Size, NULL, &Count));
+  UT_ASSERT_EQUAL (Count, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A short index, a bad record and bad parameters are each reported with their own status.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+IndexReportsErrors (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CPER_SECTION_INDEX_ENTRY  Sections[MAX_TEST_SECTIONS];
+  UINTN                     Size;
+  UINTN                     Count;
+
+  mBuffer = AllocatePool (RecordSize (MAX_TEST_SECTIONS, MAX_SECTION_LENGTH));
+  UT_ASSERT_NOT_NULL (mBuffer);
+
+  Size  = WriteRecord (mBuffer, MAX_TEST_SECTIONS, MAX_SECTION_LENGTH, 3);
+  Count = MAX_TEST_SECTIONS - 1;
+  UT_ASSERT_STATUS_EQUAL (ValidateCperHeaderAndIndex ((EFI_COMMON_ERROR_RECORD_HEADER *)mBuffer, Size, Sections, &Count), EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (Count, MAX_TEST_SECTIONS);
+
+  // Asking for the count alone is a short index too
+  Count = 0;
+  UT_ASSERT_STATUS_EQUAL (ValidateCperHeaderAndIndex ((EFI_COMMON_ERROR_RECORD_HEADER *)mBuffer, Size, NULL, &Count), EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (Count, MAX_TEST_SECTIONS);
+
+  Count = MAX_TEST_SECTIONS;
+  UT_ASSERT_STATUS_EQUAL (ValidateCperHeaderAndIndex ((EFI_COMMON_ERROR_RECORD_HEADER *)mBuffer, Size - 1, Sections, &Count), EFI_COMPROMISED_DATA);
+  UT_ASSERT_STATUS_EQUAL (ValidateCperHeaderAndIndex (NULL, Size, Sections, &Count), EFI_COMPROMISED_DATA);
+  UT_ASSERT_STATUS_EQUAL (ValidateCperHeaderAndIndex ((EFI_COMMON_ERROR_RECORD_HEADER *)mBuffer, Size, Sections, NULL), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (ValidateCperHeaderAndIndex ((EFI_COMMON_ERROR_RECORD_HEADER *)mBuffer, Size, NULL, &Count), EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Corrupted records are judged the same way by ValidateCperHeader, ValidateCperHeaderAndIndex and
+  a plain reading of the rules, and the index of any record that passes points inside it.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+FuzzedRecords (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CPER_SECTION_INDEX_ENTRY  Sections[MAX_TEST_SECTIONS];
+  UINT8                     *Record;
+  UINTN                     MaxSize;
+  UINTN                     Size;
+  UINTN                     Count;
+  UINTN                     Round;
+  UINTN                     ValidCount;
+  BOOLEAN                   Expected;
+  EFI_STATUS                Status;
+
+  MaxSize = RecordSize (MAX_TEST_SECTIONS, MAX_SECTION_LENGTH) + 256;
+  mBuffer = AllocatePool (MaxSize);
+  UT_ASSERT_NOT_NULL (mBuffer);
+
+  mRandom    = 0x2545F491;
+  ValidCount = 0;
+  for (Round = 0; Round < FUZZ_ROUNDS; Round++) {
+    Size = WriteRecord (
+             mBuffer,
+             (UINT16)(1 + NextRandom () % MAX_TEST_SECTIONS),
+             1 + NextRandom () % MAX_SECTION_LENGTH,
+             (UINT32)Round
+             );
+    CorruptRecord (mBuffer, &Size, MaxSize);
+
+    // Give the library exactly Size bytes so reading past them is caught
+    Record = AllocateCopyPool (Size, mBuffer);
+    UT_ASSERT_NOT_NULL (Record);
+
+    Expected = ReferenceValid (Record, Size);
+    UT_ASSERT_EQUAL (ValidateCperHeader ((EFI_COMMON_ERROR_RECORD_HEADER *)Record, Size), Expected);
+
+    Count  = MAX_TEST_SECTIONS;
+    Status = ValidateCperHeaderAndIndex ((EFI_COMMON_ERROR_RECORD_HEADER *)Record, Size, Sections, &Count);
+    if (Expected) {
+      ValidCount++;
+      UT_ASSERT_NOT_EFI_ERROR (Status);
+      UT_ASSERT_TRUE (IndexMatchesRecord (Record, Size, Sections, Count));
+    } else {
+      UT_ASSERT_STATUS_EQUAL (Status, EFI_COMPROMISED_DATA);
+    }
+
+    FreePool (Record);
+  }
+
+  UT_LOG_INFO ("%d of %d corrupted records were still valid\n", ValidCount, FUZZ_ROUNDS);
+
+  // Make sure the corruption is neither too gentle nor too harsh to be of use
+  UT_ASSERT_TRUE (ValidCount > 0);
+  UT_ASSERT_TRUE (ValidCount < FUZZ_ROUNDS / 2);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A buffer of good and bad records is walked to the end. Bad records are marked and skipped, and
+  the sections of good records are indexed one after another.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BatchIndexesRecords (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_ERROR_SECTION_DESCRIPTOR  *Section;
+  UINTN                         Offsets[3];
+  UINTN                         Size;
+  UINTN                         RecordCount;
+  UINTN                         SectionCount;
+
+  Size    = RecordSize (2, 24) + RecordSize (3, 16) + RecordSize (4, 8);
+  mBuffer = AllocatePool (Size);
+  UT_ASSERT_NOT_NULL (mBuffer);
+
+  mRecords  = AllocatePool (4 * sizeof (CPER_RECORD_INDEX_ENTRY));
+  mSections = AllocatePool (16 * sizeof (CPER_SECTION_INDEX_ENTRY));
+  UT_ASSERT_NOT_NULL (mRecords);
+  UT_ASSERT_NOT_NULL (mSections);
+
+  Offsets[0] = 0;
+  Offsets[1] = Offsets[0] + WriteRecord (mBuffer + Offsets[0], 2, 24, 10);
+  Offsets[2] = Offsets[1] + WriteRecord (mBuffer + Offsets[1], 3, 16, 20);
+  WriteRecord (mBuffer + Offsets[2], 4, 8, 30);
+
+  // The middle record loses its second section, but its header still leads to the last one
+  Section                  = (EFI_ERROR_SECTION_DESCRIPTOR *)(mBuffer + Offsets[1] + sizeof (EFI_COMMON_ERROR_RECORD_HEADER));
+  Section[1].SectionLength = 0;
+
+  RecordCount  = 4;
+  SectionCount = 16;
+  UT_ASSERT_NOT_EFI_ERROR (ValidateCperRecordBuffer (mBuffer, Size, mRecords, &RecordCount, mSections, &SectionCount));
+  UT_ASSERT_EQUAL (RecordCount, 3);
+  UT_ASSERT_EQUAL (SectionCount, 6);
+
+  UT_ASSERT_TRUE (mRecords[0].Valid);
+  UT_ASSERT_EQUAL (mRecords[0].Offset, Offsets[0]);
+  UT_ASSERT_EQUAL (mRecords[0].Length, RecordSize (2, 24));
+  UT_ASSERT_EQUAL (mRecords[0].FirstSection, 0);
+  UT_ASSERT_EQUAL (mRecords[0].SectionCount, 2);
+  UT_ASSERT_TRUE (IndexMatchesRecord (mBuffer + Offsets[0], mRecords[0].Length, &mSections[0], 2));
+
+  UT_ASSERT_FALSE (mRecords[1].Valid);
+  UT_ASSERT_EQUAL (mRecords[1].Offset, Offsets[1]);
+  UT_ASSERT_EQUAL (mRecords[1].SectionCount, 0);
+
+  UT_ASSERT_TRUE (mRecords[2].Valid);
+  UT_ASSERT_EQUAL (mRecords[2].Offset, Offsets[2]);
+  UT_ASSERT_EQUAL (mRecords[2].FirstSection, 2);
+  UT_ASSERT_EQUAL (mRecords[2].SectionCount, 4);
+  UT_ASSERT_TRUE (IndexMatchesRecord (mBuffer + Offsets[2], mRecords[2].Length, &mSections[2], 4));
+
+  // Without a section index the records are still checked
+  RecordCount  = 4;
+  SectionCount = 0;
+  UT_ASSERT_NOT_EFI_ERROR (ValidateCperRecordBuffer (mBuffer, Size, mRecords, &RecordCount, NULL, &SectionCount));
+  UT_ASSERT_EQUAL (RecordCount, 3);
+  UT_ASSERT_EQUAL (SectionCount, 0);
+  UT_ASSERT_TRUE (mRecords[0].Valid);
+  UT_ASSERT_FALSE (mRecords[1].Valid);
+  UT_ASSERT_TRUE (mRecords[2].Valid);
+  UT_ASSERT_EQUAL (mRecords[2].SectionCount, 4);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  The walk stops at a header it cannot follow, and when the record or section index is full,
+  keeping what was found before that point.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+BatchStopsEarly (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_COMMON_ERROR_RECORD_HEADER  *Header;
+  UINTN                           Size;
+  UINTN                           Second;
+  UINTN                           RecordCount;
+  UINTN                           SectionCount;
+
+  Size    = 2 * RecordSize (2, 32);
+  mBuffer = AllocatePool (Size);
+  UT_ASSERT_NOT_NULL (mBuffer);
+
+  mRecords  = AllocatePool (2 * sizeof (CPER_RECORD_INDEX_ENTRY));
+  mSections = AllocatePool (4 * sizeof (CPER_SECTION_INDEX_ENTRY));
+  UT_ASSERT_NOT_NULL (mRecords);
+  UT_ASSERT_NOT_NULL (mSections);
+
+  Second = WriteRecord (mBuffer, 2, 32, 1);
+  WriteRecord (mBuffer + Second, 2, 32, 2);
+  Header = (EFI_COMMON_ERROR_RECORD_HEADER *)(mBuffer + Second);
+
+  // Room for one record only
+  RecordCount  = 1;
+  SectionCount = 4;
+  UT_ASSERT_STATUS_EQUAL (ValidateCperRecordBuffer (mBuffer, Size, mRecords, &RecordCount, mSections, &SectionCount), EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (RecordCount, 1);
+  UT_ASSERT_EQUAL (SectionCount, 2);
+
+  // Room for the sections of one record only
+  RecordCount  = 2;
+  SectionCount = 3;
+  UT_ASSERT_STATUS_EQUAL (ValidateCperRecordBuffer (mBuffer, Size, mRecords, &RecordCount, mSections, &SectionCount), EFI_BUFFER_TOO_SMALL);
+  UT_ASSERT_EQUAL (RecordCount, 1);
+  UT_ASSERT_EQUAL (SectionCount, 2);
+
+  // The second record claims to run past the buffer
+  Header->RecordLength++;
+  RecordCount  = 2;
+  SectionCount = 4;
+  UT_ASSERT_STATUS_EQUAL (ValidateCperRecordBuffer (mBuffer, Size, mRecords, &RecordCount, mSections, &SectionCount), EFI_COMPROMISED_DATA);
+  UT_ASSERT_EQUAL (RecordCount, 1);
+  UT_ASSERT_TRUE (mRecords[0].Valid);
+  Header->RecordLength--;
+
+  // The second record has lost its signature
+  Header->SignatureStart = 0;
+  RecordCount            = 2;
+  SectionCount           = 4;
+  UT_ASSERT_STATUS_EQUAL (ValidateCperRecordBuffer (mBuffer, Size, mRecords, &RecordCount, mSections, &SectionCount), EFI_COMPROMISED_DATA);
+  UT_ASSERT_EQUAL (RecordCount, 1);
+  Header->SignatureStart = EFI_ERROR_RECORD_SIGNATURE_START;
+
+  // The buffer ends inside the header of the second record
+  RecordCount  = 2;
+  SectionCount = 4;
+  UT_ASSERT_STATUS_EQUAL (ValidateCperRecordBuffer (mBuffer, Second + sizeof (EFI_COMMON_ERROR_RECORD_HEADER) - 1, mRecords, &RecordCount, mSections, &SectionCount), EFI_COMPROMISED_DATA);
+  UT_ASSERT_EQUAL (RecordCount, 1);
+
+  RecordCount  = 2;
+  SectionCount = 4;
+  UT_ASSERT_STATUS_EQUAL (ValidateCperRecordBuffer (NULL, Size, mRecords, &RecordCount, mSections, &SectionCount), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (ValidateCperRecordBuffer (mBuffer, Size, mRecords, &RecordCount, NULL, &SectionCount), EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Buffers of corrupted records, each with a header that can still be followed, are judged record
+  by record the same way ValidateCperHeader judges them one at a time.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+FuzzedBatches (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_COMMON_ERROR_RECORD_HEADER  *Header;
+  UINT8                           *Batch;
+  UINTN                           MaxRecordSize;
+  UINTN                           MaxSize;
+  UINTN                           Offset;
+  UINTN                           Size;
+  UINTN                           Round;
+  UINTN                           Index;
+  UINTN                           RecordCount;
+  UINTN                           SectionCount;
+  BOOLEAN                         Expected;
+
+  MaxRecordSize = RecordSize (MAX_TEST_SECTIONS, MAX_SECTION_LENGTH) + 256;
+  MaxSize       = FUZZ_BATCH_RECORDS * MaxRecordSize;
+  mBuffer       = AllocatePool (MaxSize);
+  mRecords      = AllocatePool (FUZZ_BATCH_RECORDS * sizeof (CPER_RECORD_INDEX_ENTRY));
+  mSections     = AllocatePool (FUZZ_BATCH_RECORDS * MaxRecordSize / sizeof (EFI_ERROR_SECTION_DESCRIPTOR) * sizeof (CPER_SECTION_INDEX_ENTRY));
+  UT_ASSERT_NOT_NULL (mBuffer);
+  UT_ASSERT_NOT_NULL (mRecords);
+  UT_ASSERT_NOT_NULL (mSections);
+
+  mRandom = 0x9E3779B9;
+  for (Round = 0; Round < FUZZ_ROUNDS / FUZZ_BATCH_RECORDS; Round++) {
+    Offset = 0;
+    for (Index = 0; Index < FUZZ_BATCH_RECORDS; Index++) {
+      Size = WriteRecord (
+               mBuffer + Offset,
+               (UINT16)(1 + NextRandom () % MAX_TEST_SECTIONS),
+               1 + NextRandom () % MAX_SECTION_LENGTH,
+               (UINT32)Index
+               );
+      CorruptRecord (mBuffer + Offset, &Size, MaxRecordSize);
+
+      // Keep the header followable so the walk reaches every record
+      Size                   = MAX (Size, sizeof (EFI_COMMON_ERROR_RECORD_HEADER));
+      Header                 = (EFI_COMMON_ERROR_RECORD_HEADER *)(mBuffer + Offset);
+      Header->SignatureStart = EFI_ERROR_RECORD_SIGNATURE_START;
+      Header->RecordLength   = (UINT32)Size;
+      Offset                += Size;
+    }
+
+    Batch = AllocateCopyPool (Offset, mBuffer);
+    UT_ASSERT_NOT_NULL (Batch);
+
+    RecordCount  = FUZZ_BATCH_RECORDS;
+    SectionCount = FUZZ_BATCH_RECORDS * MaxRecordSize / sizeof (EFI_ERROR_SECTION_DESCRIPTOR);
+    UT_ASSERT_NOT_EFI_ERROR (ValidateCperRecordBuffer (Batch, Offset, mRecords, &RecordCount, mSections, &SectionCount));
+    UT_ASSERT_EQUAL (RecordCount, FUZZ_BATCH_RECORDS);
+
+    for (Index = 0; Index < RecordCount; Index++) {
+      Expected = ReferenceValid (Batch + mRecords[Index].Offset, mRecords[Index].Length);
+      UT_ASSERT_EQUAL (mRecords[Index].Valid, Expected);
+      UT_ASSERT_EQUAL (ValidateCperHeader ((EFI_COMMON_ERROR_RECORD_HEADER *)(Batch + mRecords[Index].Offset), mRecords[Index].Length), Expected);
+      if (Expected) {
+        UT_ASSERT_TRUE (
+          IndexMatchesRecord (
+            Batch + mRecords[Index].Offset,
+            mRecords[Index].Length,
+            &mSections[mRecords[Index].FirstSection],
+            mRecords[Index].SectionCount
+            )
+          );
+      }
+    }
+
+    FreePool (Batch);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Reports how fast a large set of records is validated and its sections found, first one record
+  at a time walking the descriptors again afterwards the way consumers used to, then with one call
+  over the whole buffer using the index.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ValidateBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONST EFI_COMMON_ERROR_RECORD_HEADER  *Header;
+  CONST EFI_ERROR_SECTION_DESCRIPTOR    *Section;
+  UINTN                                 RecordLength;
+  UINTN                                 Size;
+  UINTN                                 Offset;
+  UINTN                                 Round;
+  UINTN                                 Index;
+  UINTN                                 SectionIndex;
+  UINTN                                 RecordCount;
+  UINTN                                 SectionCount;
+  UINT64                                Total;
+  UINT64                                IndexedTotal;
+  clock_t                               Start;
+  clock_t                               Elapsed;
+
+  RecordLength = RecordSize (BENCH_SECTIONS, BENCH_SECTION_LEN);
+  Size         = BENCH_RECORDS * RecordLength;
+  mBuffer      = AllocatePool (Size);
+  mRecords     = AllocatePool (BENCH_RECORDS * sizeof (CPER_RECORD_INDEX_ENTRY));
+  mSections    = AllocatePool (BENCH_RECORDS * BENCH_SECTIONS * sizeof (CPER_SECTION_INDEX_ENTRY));
+  UT_ASSERT_NOT_NULL (mBuffer);
+  UT_ASSERT_NOT_NULL (mRecords);
+  UT_ASSERT_NOT_NULL (mSections);
+
+  for (Index = 0; Index < BENCH_RECORDS; Index++) {
+    WriteRecord (mBuffer + Index * RecordLength, BENCH_SECTIONS, BENCH_SECTION_LEN, (UINT32)Index);
+  }
+
+  Total = 0;
+  Start = clock ();
+  for (Round = 0; Round < BENCHMARK_ROUNDS; Round++) {
+    for (Offset = 0; Offset < Size; Offset += RecordLength) {
+      Header = (CONST EFI_COMMON_ERROR_RECORD_HEADER *)(mBuffer + Offset);
+      UT_ASSERT_TRUE (ValidateCperHeader (Header, Header->RecordLength));
+
+      Section = (CONST EFI_ERROR_SECTION_DESCRIPTOR *)(Header + 1);
+      for (SectionIndex = 0; SectionIndex < Header->SectionCount; SectionIndex++) {
+        Total += mBuffer[Offset + Section[SectionIndex].SectionOffset] + Section[SectionIndex].SectionLength;
+      }
+    }
+  }
+
+  Elapsed = MAX (clock () - Start, 1);
+  UT_LOG_INFO (
+    "One record at a time, %d sections each: %d records/s\n",
+    BENCH_SECTIONS,
+    (UINT32)((UINT64)BENCH_RECORDS * BENCHMARK_ROUNDS * CLOCKS_PER_SEC / Elapsed)
+    );
+
+  IndexedTotal = 0;
+  Start        = clock ();
+  for (Round = 0; Round < BENCHMARK_ROUNDS; Round++) {
+    RecordCount  = BENCH_RECORDS;
+    SectionCount = BENCH_RECORDS * BENCH_SECTIONS;
+    UT_ASSERT_NOT_EFI_ERROR (ValidateCperRecordBuffer (mBuffer, Size, mRecords, &RecordCount, mSections, &SectionCount));
+
+    for (Index = 0; Index < RecordCount; Index++) {
+      for (SectionIndex = 0; SectionIndex < mRecords[Index].SectionCount; SectionIndex++) {
+        IndexedTotal += mBuffer[mRecords[Index].Offset + mSections[mRecords[Index].FirstSection + SectionIndex].Offset] +
+                        mSections[mRecords[Index].FirstSection + SectionIndex].Length;
+      }
+    }
+  }
+
+  Elapsed = MAX (clock () - Start, 1);
+  UT_LOG_INFO (
+    "Whole buffer with index, %d sections each: %d records/s\n",
+    BENCH_SECTIONS,
+    (UINT32)((UINT64)BENCH_RECORDS * BENCHMARK_ROUNDS * CLOCKS_PER_SEC / Elapsed)
+    );
+
+  UT_ASSERT_EQUAL (RecordCount, BENCH_RECORDS);
+  UT_ASSERT_EQUAL (SectionCount, BENCH_RECORDS * BENCH_SECTIONS);
+  UT_ASSERT_EQUAL (IndexedTotal, Total);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for
+  CheckHwErrRecHeaderLib and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      IndexSuite;
+  UNIT_TEST_SUITE_HANDLE      BatchSuite;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create the suites
+  //
+  Status = CreateUnitTestSuite (&IndexSuite, Framework, "CheckHwErrRecHeaderLib record index tests", "CheckHwErrRecHeaderLib.Index", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for IndexSuite\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&BatchSuite, Framework, "CheckHwErrRecHeaderLib record buffer tests", "CheckHwErrRecHeaderLib.Batch", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for BatchSuite\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (IndexSuite, "Every section of a valid record is indexed", "IndexValidRecord", IndexValidRecord, NULL, CleanUpBuffers, NULL);
+  AddTestCase (IndexSuite, "Short index, bad record and bad parameters are reported", "IndexReportsErrors", IndexReportsErrors, NULL, CleanUpBuffers, NULL);
+  AddTestCase (IndexSuite, "Corrupted records are judged by the rules", "FuzzedRecords", FuzzedRecords, NULL, CleanUpBuffers, NULL);
+
+  AddTestCase (BatchSuite, "Good and bad records in one buffer are indexed", "BatchIndexesRecords", BatchIndexesRecords, NULL, CleanUpBuffers, NULL);
+  AddTestCase (BatchSuite, "Walk stops at bad headers and full indexes", "BatchStopsEarly", BatchStopsEarly, NULL, CleanUpBuffers, NULL);
+  AddTestCase (BatchSuite, "Corrupted records in one buffer are judged by the rules", "FuzzedBatches", FuzzedBatches, NULL, CleanUpBuffers, NULL);
+  AddTestCase (BatchSuite, "Validation benchmark", "ValidateBenchmark", ValidateBenchmark, NULL, CleanUpBuffers, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
@@ -0,0 +1,655 @@
+/** @file -- ParserRegistryLibHostTest.c
+Host-based UnitTest for ParserRegistryLib.
+
+Registers hundreds of section types to check that the table finds each parser as it grows,
+then decodes multi-section records in one call and checks which parser produced each line.
+
+Copyright (c) Microsoft Corporation
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <time.h>
+
+#include <Uefi.h>
+
+#include <Guid/Cper.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UnitTestLib.h>
+
+#include <Library/ParserRegistryLib.h>
+
+#define UNIT_TEST_NAME     "ParserRegistryLib Unit Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define MANY_GUID_COUNT     500
+#define LINE_LENGTH         32
+#define LARGE_SECTIONS      64
+#define LARGE_SECTION_LINE  16
+#define BENCHMARK_ROUNDS    200
+
+//
+// Section types are made by adding an index to one of these, the way generated GUIDs
+// often differ only in a few bits.
+//
+STATIC EFI_GUID  mSingleGuidBase = {
+  0x6a3c19e0, 0x4d2b, 0x4f7e, { 0x8c, 0x51, 0x0e, 0x92, 0xb7, 0x44, 0xd3, 0x16 }
+};
+
+STATIC EFI_GUID  mManyGuidBase = {
+  0x1f80c000, 0x93a4, 0x4b61, { 0xa2, 0x7d, 0x58, 0xe0, 0x3c, 0x9f, 0x11, 0x6b }
+};
+
+STATIC EFI_GUID  mRecordGuidBase = {
+  0xc7e25000, 0x0b6f, 0x4a3d, { 0x9e, 0x08, 0x72, 0x4d, 0xa1, 0x5c, 0xe6, 0x2f }
+};
+
+STATIC PARSER_LIB_RECORD_LINES         mLines;
+STATIC EFI_COMMON_ERROR_RECORD_HEADER  *mRecord;
+
+/**
+  Makes the section type at Index from a base GUID.
+**/
+STATIC
+VOID
+MakeGuid (
+  IN  CONST EFI_GUID  *Base,
+  IN  UINTN           Index,
+  OUT EFI_GUID        *Guid
+  )
+{
+  CopyGuid (Guid, Base);
+  Guid->Data1 += (UINT32)Index;
+}
+
+/**
+  Returns as many lines as the section data asks for, each made from Prefix and the line number.
+**/
+STATIC
+UINTN
+MakeLines (
+  IN OUT CHAR16                                ***Strings,
+  IN     CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err,
+  IN     CONST EFI_ERROR_SECTION_DESCRIPTOR    *SecHead,
+  IN     CONST CHAR16                          *Prefix,
+  IN     BOOLEAN                               LeaveHoles
+  )
+{
+  UINTN  Count;
+  UINTN  Index;
+
+  Count    = *(CONST UINT32 *)((CONST UINT8 *)Err + SecHead->SectionOffset);
+  *Strings = AllocateZeroPool (Count * sizeof (CHAR16 *));
+  if (*Strings == NULL) {
+    return 0;
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    // Every other line is left unallocated, the way a parser that ran out of memory would
+    if (LeaveHoles && ((Index % 2) == 1)) {
+      continue;
+    }
+
+    (*Strings)[Index] = AllocatePool (LINE_LENGTH * sizeof (CHAR16));
+    if ((*Strings)[Index] != NULL) {
+      UnicodeSPrint ((*Strings)[Index], LINE_LENGTH * sizeof (CHAR16), L"%s %d", Prefix, (UINT32)Index);
+    }
+  }
+
+  return Count;
+}
+
+UINTN
+FirstParser (
+  IN OUT CHAR16                                ***Strings,
+  IN     CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err,
+  IN     CONST EFI_ERROR_SECTION_DESCRIPTOR    *SecHead
+  )
+{
+  return MakeLines (Strings, Err, SecHead, L"First", FALSE);
+}
+
+UINTN
+SecondParser (
+  IN OUT CHAR16                                ***Strings,
+  IN     CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err,
+  IN     CONST EFI_ERROR_SECTION_DESCRIPTOR    *SecHead
+  )
+{
+  return MakeLines (Strings, Err, SecHead, L"Second", FALSE);
+}
+
+UINTN
+HoleParser (
+  IN OUT CHAR16                                ***Strings,
+  IN     CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err,
+  IN     CONST EFI_ERROR_SECTION_DESCRIPTOR    *SecHead
+  )
+{
+  return MakeLines (Strings, Err, SecHead, L"Hole", TRUE);
+}
+
+UINTN
+FallbackParser (
+  IN OUT CHAR16                                ***Strings,
+  IN     CONST EFI_COMMON_ERROR_RECORD_HEADER  *Err,
+  IN     CONST EFI_ERROR_SECTION_DESCRIPTOR    *SecHead
+  )
+{
+  return MakeLines (Strings, Err, SecHead, L"Fallback", FALSE);
+}
+
+/**
+  Builds a record whose sections have the given types, each asking its parser for
+  LineCounts[Index] lines. Replaces mRecord.
+**/
+STATIC
+EFI_COMMON_ERROR_RECORD_HEADER *
+BuildRecord (
+  IN UINTN           SectionCount,
+  IN CONST EFI_GUID  *Types,
+  IN CONST UINT32    *LineCounts
+  )
+{
+  EFI_ERROR_SECTION_DESCRIPTOR  *SecHead;
+  UINT32                        DataOffset;
+  UINTN                         Index;
+
+  if (mRecord != NULL) {
+    FreePool (mRecord);
+  }
+
+  DataOffset = (UINT32)(sizeof (EFI_COMMON_ERROR_RECORD_HEADER) + SectionCount * sizeof (EFI_ERROR_SECTION_DESCRIPTOR));
+  mRecord    = AllocateZeroPool (DataOffset + SectionCount * sizeof (UINT32));
+  if (mRecord == NULL) {
+    return NULL;
+  }
+
+  mRecord->SignatureStart = EFI_ERROR_RECORD_SIGNATURE_START;
+  mRecord->SignatureEnd   = EFI_ERROR_RECORD_SIGNATURE_END;
+  mRecord->Revision       = EFI_ERROR_RECORD_REVISION;
+  mRecord->SectionCount   = (UINT16)SectionCount;
+  mRecord->RecordLength   = DataOffset + (UINT32)(SectionCount * sizeof (UINT32));
+
+  SecHead = (EFI_ERROR_SECTION_DESCRIPTOR *)(mRecord + 1);
+  for (Index = 0; Index < SectionCount; Index++, SecHead++) {
+    SecHead->SectionOffset = DataOffset + (UINT32)(Index * sizeof (UINT32));
+    SecHead->SectionLength = sizeof (UINT32);
+    CopyMem (&SecHead->SectionType, &Types[Index], sizeof (EFI_GUID));
+    *(UINT32 *)((UINT8 *)mRecord + SecHead->SectionOffset) = LineCounts[Index];
+  }
+
+  return mRecord;
+}
+
+/**
+  Builds a record of LARGE_SECTIONS sections, each of one of the MANY_GUID_COUNT types.
+**/
+STATIC
+EFI_COMMON_ERROR_RECORD_HEADER *
+BuildLargeRecord (
+  VOID
+  )
+{
+  EFI_GUID  Types[LARGE_SECTIONS];
+  UINT32    LineCounts[LARGE_SECTIONS];
+  UINTN     Index;
+
+  for (Index = 0; Index < LARGE_SECTIONS; Index++) {
+    MakeGuid (&mManyGuidBase, (Index * 7) % MANY_GUID_COUNT, &Types[Index]);
+    LineCounts[Index] = LARGE_SECTION_LINE;
+  }
+
+  return BuildRecord (LARGE_SECTIONS, Types, LineCounts);
+}
+
+/**
+  Registers the MANY_GUID_COUNT types, alternating between two parsers. Types already
+  registered by an earlier test are left as they are.
+**/
+STATIC
+BOOLEAN
+RegisterManyGuids (
+  VOID
+  )
+{
+  EFI_GUID    Guid;
+  EFI_STATUS  Status;
+  UINTN       Index;
+
+  for (Index = 0; Index < MANY_GUID_COUNT; Index++) {
+    MakeGuid (&mManyGuidBase, Index, &Guid);
+    Status = ParserLibRegisterSectionParser (((Index % 2) == 0) ? FirstParser : SecondParser, &Guid);
+    if (EFI_ERROR (Status) && (Status != EFI_ABORTED)) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Checks that a decoded line matches what the stand-in parser with Prefix would return.
+**/
+STATIC
+BOOLEAN
+LineIs (
+  IN UINTN         Section,
+  IN UINTN         Line,
+  IN CONST CHAR16  *Prefix,
+  IN UINTN         Number
+  )
+{
+  CHAR16        Expected[LINE_LENGTH];
+  CONST CHAR16  *Actual;
+
+  Actual = ParserLibGetLine (&mLines, Section, Line);
+  if (Actual == NULL) {
+    return FALSE;
+  }
+
+  UnicodeSPrint (Expected, sizeof (Expected), L"%s %d", Prefix, (UINT32)Number);
+  return StrCmp (Actual, Expected) == 0;
+}
+
+/**
+  Frees the record and decoded lines left by a test.
+**/
+VOID
+EFIAPI
+CleanUpRecord (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mRecord != NULL) {
+    FreePool (mRecord);
+    mRecord = NULL;
+  }
+
+  ParserLibFreeRecordLines (&mLines);
+}
+
+/**
+  A GUID can only be registered once, and NULL parsers or GUIDs are refused.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RegisterRejectsDuplicates (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_GUID  Guid;
+
+  MakeGuid (&mSingleGuidBase, 0, &Guid);
+
+  UT_ASSERT_STATUS_EQUAL (ParserLibRegisterSectionParser (FirstParser, &Guid), EFI_SUCCESS);
+  UT_ASSERT_STATUS_EQUAL (ParserLibRegisterSectionParser (SecondParser, &Guid), EFI_ABORTED);
+  UT_ASSERT_TRUE (ParserLibFindSectionParser (&Guid) == FirstParser);
+
+  MakeGuid (&mSingleGuidBase, 1, &Guid);
+  UT_ASSERT_STATUS_EQUAL (ParserLibRegisterSectionParser (NULL, &Guid), EFI_INVALID_PARAMETER);
+  UT_ASSERT_TRUE (ParserLibFindSectionParser (&Guid) == NULL);
+  UT_ASSERT_STATUS_EQUAL (ParserLibRegisterSectionParser (FirstParser, NULL), EFI_INVALID_PARAMETER);
+  UT_ASSERT_TRUE (ParserLibFindSectionParser (NULL) == NULL);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Every one of hundreds of registered GUIDs finds its own parser after the table has grown,
+  and GUIDs that were never registered find nothing.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ManyGuidsFound (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_GUID  Guid;
+  UINTN     Index;
+
+  UT_ASSERT_TRUE (RegisterManyGuids ());
+
+  for (Index = 0; Index < MANY_GUID_COUNT; Index++) {
+    MakeGuid (&mManyGuidBase, Index, &Guid);
+    UT_ASSERT_TRUE (ParserLibFindSectionParser (&Guid) == (((Index % 2) == 0) ? FirstParser : SecondParser));
+    UT_ASSERT_STATUS_EQUAL (ParserLibRegisterSectionParser (HoleParser, &Guid), EFI_ABORTED);
+
+    // Same Data1, different tail
+    Guid.Data4[7] ^= 0xFF;
+    UT_ASSERT_TRUE (ParserLibFindSectionParser (&Guid) == NULL);
+  }
+
+  MakeGuid (&mManyGuidBase, MANY_GUID_COUNT, &Guid);
+  UT_ASSERT_TRUE (ParserLibFindSectionParser (&Guid) == NULL);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Each section is decoded by its registered parser, or the default when there is none,
+  and MaxSections limits how many are decoded.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ParseRecordDispatchesSections (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_GUID  Types[3];
+  UINT32    LineCounts[3] = { 3, 2, 1 };
+
+  UT_ASSERT_TRUE (RegisterManyGuids ());
+  MakeGuid (&mManyGuidBase, 10, &Types[0]);         // FirstParser
+  MakeGuid (&mRecordGuidBase, 0, &Types[1]);        // Not registered
+  MakeGuid (&mManyGuidBase, 11, &Types[2]);         // SecondParser
+  UT_ASSERT_NOT_NULL (BuildRecord (3, Types, LineCounts));
+
+  UT_ASSERT_NOT_EFI_ERROR (ParserLibParseRecord (mRecord, FallbackParser, 10, &mLines));
+  UT_ASSERT_EQUAL (mLines.SectionCount, 3);
+  UT_ASSERT_EQUAL (mLines.Sections[0].LineCount, 3);
+  UT_ASSERT_EQUAL (mLines.Sections[1].LineCount, 2);
+  UT_ASSERT_EQUAL (mLines.Sections[2].LineCount, 1);
+
+  UT_ASSERT_TRUE (LineIs (0, 0, L"First", 0));
+  UT_ASSERT_TRUE (LineIs (0, 2, L"First", 2));
+  UT_ASSERT_TRUE (LineIs (1, 0, L"Fallback", 0));
+  UT_ASSERT_TRUE (LineIs (1, 1, L"Fallback", 1));
+  UT_ASSERT_TRUE (LineIs (2, 0, L"Second", 0));
+
+  UT_ASSERT_TRUE (ParserLibGetLine (&mLines, 0, 3) == NULL);
+  UT_ASSERT_TRUE (ParserLibGetLine (&mLines, 3, 0) == NULL);
+
+  UT_ASSERT_NOT_EFI_ERROR (ParserLibParseRecord (mRecord, FallbackParser, 2, &mLines));
+  UT_ASSERT_EQUAL (mLines.SectionCount, 2);
+  UT_ASSERT_EQUAL (mLines.LineCount, 5);
+  UT_ASSERT_TRUE (ParserLibGetLine (&mLines, 2, 0) == NULL);
+
+  UT_ASSERT_STATUS_EQUAL (ParserLibParseRecord (NULL, FallbackParser, 2, &mLines), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (ParserLibParseRecord (mRecord, FallbackParser, 2, NULL), EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  An indexed record is decoded from its index alone: the descriptors are not read, and the
+  section count of the index bounds MaxSections.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ParseIndexedRecordUsesIndex (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_GUID                      Types[3];
+  UINT32                        LineCounts[3] = { 3, 2, 1 };
+  CPER_SECTION_INDEX_ENTRY      Sections[3];
+  EFI_ERROR_SECTION_DESCRIPTOR  *SecHead;
+  UINTN                         Index;
+
+  UT_ASSERT_TRUE (RegisterManyGuids ());
+  MakeGuid (&mManyGuidBase, 10, &Types[0]);         // FirstParser
+  MakeGuid (&mRecordGuidBase, 0, &Types[1]);        // Not registered
+  MakeGuid (&mManyGuidBase, 11, &Types[2]);         // SecondParser
+  UT_ASSERT_NOT_NULL (BuildRecord (3, Types, LineCounts));
+
+  SecHead = (EFI_ERROR_SECTION_DESCRIPTOR *)(mRecord + 1);
+  for (Index = 0; Index < 3; Index++, SecHead++) {
+    CopyGuid (&Sections[Index].SectionType, &SecHead->SectionType);
+    Sections[Index].Offset   = SecHead->SectionOffset;
+    Sections[Index].Length   = SecHead->SectionLength;
+    Sections[Index].Severity = SecHead->Severity;
+  }
+
+  // The descriptors are not read once the record is indexed. The parsers reach the section
+  // data through the offsets of the index.
+  SetMem (mRecord + 1, 3 * sizeof (EFI_ERROR_SECTION_DESCRIPTOR), 0xA5);
+  MakeGuid (&mManyGuidBase, 10, &Sections[1].SectionType);
+
+  UT_ASSERT_NOT_EFI_ERROR (ParserLibParseIndexedRecord (mRecord, Sections, 3, FallbackParser, 10, &mLines));
+  UT_ASSERT_EQUAL (mLines.SectionCount, 3);
+  UT_ASSERT_TRUE (LineIs (0, 0, L"First", 0));
+  UT_ASSERT_TRUE (LineIs (1, 1, L"First", 1));
+  UT_ASSERT_TRUE (LineIs (2, 0, L"Second", 0));
+
+  UT_ASSERT_NOT_EFI_ERROR (ParserLibParseIndexedRecord (mRecord, Sections, 1, FallbackParser, 10, &mLines));
+  UT_ASSERT_EQUAL (mLines.SectionCount, 1);
+  UT_ASSERT_EQUAL (mLines.LineCount, 3);
+
+  UT_ASSERT_NOT_EFI_ERROR (ParserLibParseIndexedRecord (mRecord, NULL, 0, FallbackParser, 10, &mLines));
+  UT_ASSERT_EQUAL (mLines.SectionCount, 0);
+
+  UT_ASSERT_STATUS_EQUAL (ParserLibParseIndexedRecord (mRecord, NULL, 1, FallbackParser, 10, &mLines), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (ParserLibParseIndexedRecord (NULL, Sections, 3, FallbackParser, 10, &mLines), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (ParserLibParseIndexedRecord (mRecord, Sections, 3, FallbackParser, 10, NULL), EFI_INVALID_PARAMETER);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Without a default parser unregistered sections have no lines, and strings a parser
+  could not allocate are skipped.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ParseRecordSkipsMissingLines (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_GUID  Types[3];
+  UINT32    LineCounts[3] = { 4, 5, 0 };
+
+  MakeGuid (&mRecordGuidBase, 1, &Types[0]);        // Not registered
+  MakeGuid (&mRecordGuidBase, 2, &Types[1]);        // HoleParser
+  MakeGuid (&mRecordGuidBase, 3, &Types[2]);        // HoleParser, asks for no lines
+  UT_ASSERT_NOT_EFI_ERROR (ParserLibRegisterSectionParser (HoleParser, &Types[1]));
+  UT_ASSERT_NOT_EFI_ERROR (ParserLibRegisterSectionParser (HoleParser, &Types[2]));
+  UT_ASSERT_NOT_NULL (BuildRecord (3, Types, LineCounts));
+
+  UT_ASSERT_NOT_EFI_ERROR (ParserLibParseRecord (mRecord, NULL, 3, &mLines));
+  UT_ASSERT_EQUAL (mLines.SectionCount, 3);
+  UT_ASSERT_EQUAL (mLines.Sections[0].LineCount, 0);
+  UT_ASSERT_EQUAL (mLines.Sections[1].LineCount, 3);
+  UT_ASSERT_EQUAL (mLines.Sections[2].LineCount, 0);
+
+  UT_ASSERT_TRUE (ParserLibGetLine (&mLines, 0, 0) == NULL);
+  UT_ASSERT_TRUE (LineIs (1, 0, L"Hole", 0));
+  UT_ASSERT_TRUE (LineIs (1, 1, L"Hole", 2));
+  UT_ASSERT_TRUE (LineIs (1, 2, L"Hole", 4));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Decoding a smaller record after a large one keeps the buffers, and freeing them leaves the
+  lines ready to be used again.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ParseRecordReusesBuffers (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  PARSER_LIB_RECORD_LINES  Large;
+  EFI_GUID                 Type;
+  UINT32                   LineCount;
+  UINTN                    Index;
+
+  UT_ASSERT_TRUE (RegisterManyGuids ());
+  UT_ASSERT_NOT_NULL (BuildLargeRecord ());
+  UT_ASSERT_NOT_EFI_ERROR (ParserLibParseRecord (mRecord, NULL, MAX_UINTN, &mLines));
+  UT_ASSERT_EQUAL (mLines.SectionCount, LARGE_SECTIONS);
+  UT_ASSERT_EQUAL (mLines.LineCount, LARGE_SECTIONS * LARGE_SECTION_LINE);
+
+  for (Index = 0; Index < LARGE_SECTIONS; Index++) {
+    UT_ASSERT_TRUE (LineIs (Index, LARGE_SECTION_LINE - 1, (((Index * 7) % 2) == 0) ? L"First" : L"Second", LARGE_SECTION_LINE - 1));
+  }
+
+  CopyMem (&Large, &mLines, sizeof (Large));
+
+  MakeGuid (&mManyGuidBase, 0, &Type);
+  LineCount = 1;
+  UT_ASSERT_NOT_NULL (BuildRecord (1, &Type, &LineCount));
+  UT_ASSERT_NOT_EFI_ERROR (ParserLibParseRecord (mRecord, NULL, MAX_UINTN, &mLines));
+  UT_ASSERT_EQUAL (mLines.SectionCount, 1);
+  UT_ASSERT_TRUE (LineIs (0, 0, L"First", 0));
+
+  UT_ASSERT_TRUE (mLines.Text == Large.Text);
+  UT_ASSERT_TRUE (mLines.Lines == Large.Lines);
+  UT_ASSERT_TRUE (mLines.Sections == Large.Sections);
+  UT_ASSERT_EQUAL (mLines.TextCapacity, Large.TextCapacity);
+  UT_ASSERT_EQUAL (mLines.LineCapacity, Large.LineCapacity);
+  UT_ASSERT_EQUAL (mLines.SectionCapacity, Large.SectionCapacity);
+
+  ParserLibFreeRecordLines (&mLines);
+  UT_ASSERT_TRUE (mLines.Text == NULL);
+  UT_ASSERT_EQUAL (mLines.SectionCount, 0);
+
+  UT_ASSERT_NOT_EFI_ERROR (ParserLibParseRecord (mRecord, NULL, MAX_UINTN, &mLines));
+  UT_ASSERT_TRUE (LineIs (0, 0, L"First", 0));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Reports how fast parsers are found among hundreds of section types and how fast a large
+  record is decoded.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ParserBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_GUID  Guid;
+  UINTN     Round;
+  UINTN     Index;
+  clock_t   Start;
+  clock_t   Elapsed;
+
+  UT_ASSERT_TRUE (RegisterManyGuids ());
+
+  Start = clock ();
+  for (Round = 0; Round < BENCHMARK_ROUNDS; Round++) {
+    for (Index = 0; Index < MANY_GUID_COUNT; Index++) {
+      MakeGuid (&mManyGuidBase, Index, &Guid);
+      UT_ASSERT_NOT_NULL (ParserLibFindSectionParser (&Guid));
+    }
+  }
+
+  Elapsed = MAX (clock () - Start, 1);
+  UT_LOG_INFO (
+    "Lookup among %d section types: %d lookups/s\n",
+    MANY_GUID_COUNT,
+    (UINT32)((UINT64)MANY_GUID_COUNT * BENCHMARK_ROUNDS * CLOCKS_PER_SEC / Elapsed)
+    );
+
+  UT_ASSERT_NOT_NULL (BuildLargeRecord ());
+
+  Start = clock ();
+  for (Round = 0; Round < BENCHMARK_ROUNDS; Round++) {
+    UT_ASSERT_NOT_EFI_ERROR (ParserLibParseRecord (mRecord, NULL, MAX_UINTN, &mLines));
+  }
+
+  Elapsed = MAX (clock () - Start, 1);
+  UT_LOG_INFO (
+    "Decode of %d sections, %d lines each: %d records/s\n",
+    LARGE_SECTIONS,
+    LARGE_SECTION_LINE,
+    (UINT32)((UINT64)BENCHMARK_ROUNDS * CLOCKS_PER_SEC / Elapsed)
+    );
+
+  UT_ASSERT_EQUAL (mLines.LineCount, LARGE_SECTIONS * LARGE_SECTION_LINE);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for
+  ParserRegistryLib and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      RegistrySuite;
+  UNIT_TEST_SUITE_HANDLE      RecordSuite;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create the suites
+  //
+  Status = CreateUnitTestSuite (&RegistrySuite, Framework, "ParserRegistryLib registration tests", "ParserRegistryLib.Registry", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for RegistrySuite\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  Status = CreateUnitTestSuite (&RecordSuite, Framework, "ParserRegistryLib record decoding tests", "ParserRegistryLib.Record", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for RecordSuite\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (RegistrySuite, "Duplicate and NULL registrations are refused", "RegisterRejectsDuplicates", RegisterRejectsDuplicates, NULL, NULL, NULL);
+  AddTestCase (RegistrySuite, "Hundreds of section types are found", "ManyGuidsFound", ManyGuidsFound, NULL, NULL, NULL);
+
+  AddTestCase (RecordSuite, "Sections go to their own parser", "ParseRecordDispatchesSections", ParseRecordDispatchesSections, NULL, CleanUpRecord, NULL);
+  AddTestCase (RecordSuite, "Indexed sections go to their own parser", "ParseIndexedRecordUsesIndex", ParseIndexedRecordUsesIndex, NULL, CleanUpRecord, NULL);
+  AddTestCase (RecordSuite, "Missing lines are skipped", "ParseRecordSkipsMissingLines", ParseRecordSkipsMissingLines, NULL, CleanUpRecord, NULL);
+  AddTestCase (RecordSuite, "Buffers are reused between records", "ParseRecordReusesBuffers", ParseRecordReusesBuffers, NULL, CleanUpRecord, NULL);
+  AddTestCase (RecordSuite, "Lookup and decode benchmark", "ParserBenchmark", ParserBenchmark, NULL, CleanUpRecord, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
@@ -22,6 +22,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <DfciSystemSettingTypes.h>
 #include <MsBootManagerSettings.h>
+#include <Guid/DfciEventGroup.h>
 #include <Protocol/DfciSettingsProvider.h>
 
 #include <Settings/BootMenuSettings.h>
@@ -29,6 +30,18 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 EFI_EVENT  mBootManagerSettingsProviderSupportInstallEvent;
 VOID       *mBootManagerSettingsProviderSupportInstallEventRegistration = NULL;
 
+//
+// Copy of the settings variable, kept only by the module that installs the settings
+// provider.  That module's own writes are the only changes to the variable it has to
+// track, so the copy is written through and never re-read.  While the Settings Manager
+// applies a batch of settings the writes stay in the copy, and the batch is written
+// with one SetVariable when the apply completes.
+//
+STATIC MS_BOOT_MANAGER_SETTINGS  mSettingsCache;
+STATIC BOOLEAN                   mSettingsCached  = FALSE;
+STATIC BOOLEAN                   mSettingsDirty   = FALSE;
+STATIC BOOLEAN                   mApplyInProgress = FALSE;
+
 /**
 @param Id - Setting ID to check for support status
 @retval TRUE - Supported
@@ -56,6 +69,135 @@ IsIdSupported (
   return Result;
 }
 
+/**
+Read the boot manager settings, from the cache once it is loaded.
+
+@param Settings - Returns the settings
+
+@retval EFI_SUCCESS - Settings returned
+@retval Others      - Error from GetVariable.  Settings not returned.
+**/
+STATIC
+EFI_STATUS
+ReadSettings (
+  OUT MS_BOOT_MANAGER_SETTINGS  *Settings
+  )
+{
+  EFI_STATUS  Status;
+  UINT32      Attributes;
+  UINTN       BufferSize;
+
+  if (mSettingsCached) {
+    CopyMem (Settings, &mSettingsCache, sizeof (MS_BOOT_MANAGER_SETTINGS));
+    return EFI_SUCCESS;
+  }
+
+  BufferSize = sizeof (MS_BOOT_MANAGER_SETTINGS);
+  Status     = gRT->GetVariable (
+                      MS_BOOT_MANAGER_SETTINGS_NAME,
+                      &gMsBootManagerSettingsGuid,
+                      &Attributes,
+                      &BufferSize,
+                      Settings
+                      );
+
+  if (!EFI_ERROR (Status) && FeaturePcdGet (PcdSettingsManagerInstallProvider)) {
+    CopyMem (&mSettingsCache, Settings, sizeof (MS_BOOT_MANAGER_SETTINGS));
+    mSettingsCached = TRUE;
+  }
+
+  return Status;
+}
+
+/**
+Write the boot manager settings through the cache.  During a settings apply the write
+is held in the cache until the apply completes.
+
+@param Settings - The settings to write
+
+@retval EFI_SUCCESS - Settings written, or held until the apply completes
+@retval Others      - Error from SetVariable.  The cache is dropped.
+**/
+STATIC
+EFI_STATUS
+WriteSettings (
+  IN CONST MS_BOOT_MANAGER_SETTINGS  *Settings
+  )
+{
+  EFI_STATUS  Status;
+
+  if (FeaturePcdGet (PcdSettingsManagerInstallProvider)) {
+    CopyMem (&mSettingsCache, Settings, sizeof (MS_BOOT_MANAGER_SETTINGS));
+    mSettingsCached = TRUE;
+    if (mApplyInProgress) {
+      mSettingsDirty = TRUE;
+      return EFI_SUCCESS;
+    }
+  }
+
+  Status = gRT->SetVariable (
+                  MS_BOOT_MANAGER_SETTINGS_NAME,
+                  &gMsBootManagerSettingsGuid,
+                  MS_BOOT_MANAGER_SETTINGS_ATTRIBUTES,
+                  sizeof (MS_BOOT_MANAGER_SETTINGS),
+                  (VOID *)Settings
+                  );
+  if (EFI_ERROR (Status)) {
+    // The variable keeps its previous contents, so read it again next time.
+    mSettingsCached = FALSE;
+  }
+
+  return Status;
+}
+
+/**
+Called when the Settings Manager starts applying a batch of settings.  Changes are held
+in the cache until the apply completes.
+
+@param Event   - Event whose notification function is being invoked
+@param Context - NULL
+**/
+STATIC
+VOID
+EFIAPI
+BootManagerSettingsApplyStart (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  mApplyInProgress = TRUE;
+}
+
+/**
+Called when the Settings Manager has applied a batch of settings.  Writes the changes
+held during the apply with a single SetVariable.  SetBootManagerSetting has already
+returned success for them, so a failed write is reported to the Settings Manager by
+signaling the apply failed event group.
+
+@param Event   - Event whose notification function is being invoked
+@param Context - NULL
+**/
+STATIC
+VOID
+EFIAPI
+BootManagerSettingsApplyComplete (
+  IN  EFI_EVENT  Event,
+  IN  VOID       *Context
+  )
+{
+  EFI_STATUS  Status;
+
+  mApplyInProgress = FALSE;
+  if (mSettingsDirty) {
+    mSettingsDirty = FALSE;
+    Status         = WriteSettings (&mSettingsCache);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a - ERROR on SetVariable.  Code=%r\n", __FUNCTION__, Status));
+      EfiEventGroupSignal (&gDfciSettingsApplyFailedEventGroupGuid);
+    }
+  }
+}
+
 /**
 Internal function used to init the entire variable into flash.
 
@@ -246,6 +388,7 @@ GetBootManagerSettingDefault (
 Function to Get a Boot Manager Setting.
 If the setting has not be previously set this function will return the default.  However it will
 not cause the default to be set.
+In the module that installs the settings provider the variable is read once and cached.
 
 @param Id:      The MsSystemSettingsId for the setting
 @param Value:   Ptr to a boolean value for the setting to be returned.  Enabled = True, Disabled = False
@@ -263,23 +406,13 @@ GetBootManagerSetting (
 {
   MS_BOOT_MANAGER_SETTINGS  Settings;
   EFI_STATUS                Status;
-  UINT32                    Attributes;
-  UINTN                     BufferSize;
 
   if (!IsIdSupported (Id)) {
     DEBUG ((DEBUG_ERROR, "%a - Called with Invalid ID (%a)\n", __FUNCTION__, Id));
     return EFI_UNSUPPORTED;
   }
 
-  BufferSize = sizeof (Settings);
-  Status     = gRT->GetVariable (
-                      MS_BOOT_MANAGER_SETTINGS_NAME,
-                      &gMsBootManagerSettingsGuid,
-                      &Attributes,
-                      &BufferSize,
-                      &Settings
-                      );
-
+  Status = ReadSettings (&Settings);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_INFO, "%a - Error %r.  Returning Default.\n", __FUNCTION__, Status));
     return GetBootManagerSettingDefault (Id, Value);
@@ -304,6 +437,7 @@ GetBootManagerSetting (
 
 /**
 Function to Set a Boot Manager Setting
+While the Settings Manager applies a batch of settings, the write is held until the batch completes.
 @param Id:      The MsSystemSettingsId for the setting
 @param Value:   The boolean value for the setting.  Enabled = True, Disabled = False
 @param Flags:   The returning flags from setting the setting.  This can tell things like Reboot required.
@@ -322,8 +456,6 @@ SetBootManagerSetting (
 {
   MS_BOOT_MANAGER_SETTINGS  Settings;
   EFI_STATUS                Status;
-  UINTN                     BufferSize;
-  UINT32                    Attributes;
   BOOLEAN                   Changed = FALSE;
 
   if (Flags == NULL) {
@@ -336,15 +468,7 @@ SetBootManagerSetting (
     return EFI_UNSUPPORTED;
   }
 
-  BufferSize = sizeof (Settings);
-  Status     = gRT->GetVariable (
-                      MS_BOOT_MANAGER_SETTINGS_NAME,
-                      &gMsBootManagerSettingsGuid,
-                      &Attributes,
-                      &BufferSize,
-                      &Settings
-                      );
-
+  Status = ReadSettings (&Settings);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_INFO, "%a - Error %r.  Can't set until initialized.\n", __FUNCTION__, Status));
     return Status;
@@ -370,13 +494,7 @@ SetBootManagerSetting (
   }
 
   if (Changed) {
-    Status = gRT->SetVariable (
-                    MS_BOOT_MANAGER_SETTINGS_NAME,
-                    &gMsBootManagerSettingsGuid,
-                    MS_BOOT_MANAGER_SETTINGS_ATTRIBUTES,
-                    sizeof (Settings),
-                    &Settings
-                    );
+    Status = WriteSettings (&Settings);
     if (EFI_ERROR (Status)) {
       DEBUG ((DEBUG_ERROR, "ERROR on SetVariable.  Code=%r\n", Status));
     }
@@ -577,6 +695,7 @@ MsBootManagerSettingsConstructor (
   )
 {
   EFI_STATUS  Status = EFI_SUCCESS;
+  EFI_EVENT   ApplyEvent;
 
   if (FeaturePcdGet (PcdSettingsManagerInstallProvider)) {
     // Install callback on the SettingsManager gDfciSettingsProviderSupportProtocolGuid protocol
@@ -590,6 +709,31 @@ MsBootManagerSettingsConstructor (
 
     DEBUG ((DEBUG_INFO, "%a - Event Registered.\n", __FUNCTION__));
 
+    // Hold setting changes while the Settings Manager applies a batch of settings
+    Status = gBS->CreateEventEx (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_CALLBACK,
+                    BootManagerSettingsApplyStart,
+                    NULL,
+                    &gDfciSettingsApplyStartEventGroupGuid,
+                    &ApplyEvent
+                    );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a - Create Event Ex for Settings Apply Start. %r\n", __FUNCTION__, Status));
+    }
+
+    Status = gBS->CreateEventEx (
+                    EVT_NOTIFY_SIGNAL,
+                    TPL_CALLBACK,
+                    BootManagerSettingsApplyComplete,
+                    NULL,
+                    &gDfciSettingsApplyCompleteEventGroupGuid,
+                    &ApplyEvent
+                    );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a - Create Event Ex for Settings Apply Complete. %r\n", __FUNCTION__, Status));
+    }
+
     // Init nv var
     Status = InitializeNvVariable ();
     if (EFI_ERROR (Status)) {
@@ -0,0 +1,725 @@
+/** @file
+  Host based unit tests for the settings cache in MsBootManagerSettingsDxeLib.
+
+  The variable services are replaced with a single in memory MsBootPolicySettings
+  variable that counts every GetVariable and SetVariable.  The library is built as the
+  module that installs the settings provider, and the tests drive its providers the
+  way the DFCI Settings Manager does while applying a settings packet.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <PiDxe.h>
+
+#include <DfciSystemSettingTypes.h>
+#include <MsBootManagerSettings.h>
+#include <Guid/DfciEventGroup.h>
+#include <Protocol/DfciSettingsProvider.h>
+#include <Settings/BootMenuSettings.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MsBootManagerSettingsLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_NAME     "MsBootManagerSettingsDxeLib Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define BOOT_MANAGER_SETTING_COUNT  5
+#define MAX_MOCK_PROVIDERS          8
+
+EFI_STATUS
+EFIAPI
+MsBootManagerSettingsConstructor (
+  IN EFI_HANDLE        ImageHandle,
+  IN EFI_SYSTEM_TABLE  *SystemTable
+  );
+
+///
+/// The MsBootPolicySettings variable, and the variable service calls made for it
+///
+typedef struct {
+  BOOLEAN                     Present;
+  UINT32                      Attributes;
+  MS_BOOT_MANAGER_SETTINGS    Settings;
+  UINTN                       GetCount;
+  UINTN                       SetCount;
+  EFI_STATUS                  SetStatus;
+} MOCK_SETTINGS_VARIABLE;
+
+STATIC MOCK_SETTINGS_VARIABLE                  mVariable;
+STATIC EFI_BOOT_SERVICES                       mMockBootServices;
+STATIC EFI_RUNTIME_SERVICES                    mMockRuntimeServices;
+STATIC DFCI_SETTING_PROVIDER_SUPPORT_PROTOCOL  mProviderSupport;
+STATIC DFCI_SETTING_PROVIDER                   mProviders[MAX_MOCK_PROVIDERS];
+STATIC UINTN                                   mProviderCount;
+STATIC EFI_EVENT_NOTIFY                        mApplyStartNotify;
+STATIC EFI_EVENT_NOTIFY                        mApplyCompleteNotify;
+STATIC UINTN                                   mApplyFailedCount;
+STATIC UINTN                                   mEvent;
+
+//
+// Variable service mocks.
+//
+
+/**
+  Stands in for gRT->GetVariable.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockGetVariable (
+  IN     CHAR16    *VariableName,
+  IN     EFI_GUID  *VendorGuid,
+  OUT    UINT32    *Attributes     OPTIONAL,
+  IN OUT UINTN     *DataSize,
+  OUT    VOID      *Data           OPTIONAL
+  )
+{
+  mVariable.GetCount++;
+  if ((StrCmp (VariableName, MS_BOOT_MANAGER_SETTINGS_NAME) != 0) || !mVariable.Present) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (*DataSize < sizeof (MS_BOOT_MANAGER_SETTINGS)) {
+    *DataSize = sizeof (MS_BOOT_MANAGER_SETTINGS);
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  if (Attributes != NULL) {
+    *Attributes = mVariable.Attributes;
+  }
+
+  *DataSize = sizeof (MS_BOOT_MANAGER_SETTINGS);
+  CopyMem (Data, &mVariable.Settings, sizeof (MS_BOOT_MANAGER_SETTINGS));
+  return EFI_SUCCESS;
+}
+
+/**
+  Stands in for gRT->SetVariable.  Fails with mVariable.SetStatus when it is an error.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockSetVariable (
+  IN  CHAR16    *VariableName,
+  IN  EFI_GUID  *VendorGuid,
+  IN  UINT32    Attributes,
+  IN  UINTN     DataSize,
+  IN  VOID      *Data
+  )
+{
+  mVariable.SetCount++;
+  if (EFI_ERROR (mVariable.SetStatus)) {
+    return mVariable.SetStatus;
+  }
+
+  if (DataSize == 0) {
+    mVariable.Present = FALSE;
+    return EFI_SUCCESS;
+  }
+
+  if (DataSize != sizeof (MS_BOOT_MANAGER_SETTINGS)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  mVariable.Present    = TRUE;
+  mVariable.Attributes = Attributes;
+  CopyMem (&mVariable.Settings, Data, sizeof (MS_BOOT_MANAGER_SETTINGS));
+  return EFI_SUCCESS;
+}
+
+//
+// Boot services, UefiLib and Settings Manager mocks.
+//
+
+/**
+  Stands in for gBS->CreateEventEx, keeping the notify functions of the settings apply
+  event groups so the tests can signal them.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockCreateEventEx (
+  IN       UINT32            Type,
+  IN       EFI_TPL           NotifyTpl,
+  IN       EFI_EVENT_NOTIFY  NotifyFunction OPTIONAL,
+  IN CONST VOID              *NotifyContext OPTIONAL,
+  IN CONST EFI_GUID          *EventGroup    OPTIONAL,
+  OUT      EFI_EVENT         *Event
+  )
+{
+  if (CompareGuid (EventGroup, &gDfciSettingsApplyStartEventGroupGuid)) {
+    mApplyStartNotify = NotifyFunction;
+  } else if (CompareGuid (EventGroup, &gDfciSettingsApplyCompleteEventGroupGuid)) {
+    mApplyCompleteNotify = NotifyFunction;
+  } else {
+    return EFI_UNSUPPORTED;
+  }
+
+  *Event = (EFI_EVENT)&mEvent;
+  return EFI_SUCCESS;
+}
+
+/**
+  Stands in for gBS->LocateProtocol, for the settings provider support protocol.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockLocateProtocol (
+  IN  EFI_GUID  *Protocol,
+  IN  VOID      *Registration  OPTIONAL,
+  OUT VOID      **Interface
+  )
+{
+  if (!CompareGuid (Protocol, &gDfciSettingsProviderSupportProtocolGuid)) {
+    return EFI_NOT_FOUND;
+  }
+
+  *Interface = &mProviderSupport;
+  return EFI_SUCCESS;
+}
+
+/**
+  Stands in for gBS->CloseEvent.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockCloseEvent (
+  IN EFI_EVENT  Event
+  )
+{
+  return EFI_SUCCESS;
+}
+
+/**
+  Stands in for the Settings Manager RegisterProvider, which copies the provider.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockRegisterProvider (
+  IN DFCI_SETTING_PROVIDER_SUPPORT_PROTOCOL  *This,
+  IN DFCI_SETTING_PROVIDER                   *Provider
+  )
+{
+  if (mProviderCount == MAX_MOCK_PROVIDERS) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  CopyMem (&mProviders[mProviderCount++], Provider, sizeof (DFCI_SETTING_PROVIDER));
+  return EFI_SUCCESS;
+}
+
+/**
+  Stands in for UefiLib EfiCreateProtocolNotifyEvent.  The protocol is already
+  installed, so the notify function runs once straight away, as it does when the
+  real event is signaled at creation.
+**/
+EFI_EVENT
+EFIAPI
+EfiCreateProtocolNotifyEvent (
+  IN  EFI_GUID          *ProtocolGuid,
+  IN  EFI_TPL           NotifyTpl,
+  IN  EFI_EVENT_NOTIFY  NotifyFunction,
+  IN  VOID              *NotifyContext   OPTIONAL,
+  OUT VOID              **Registration
+  )
+{
+  NotifyFunction ((EFI_EVENT)&mEvent, NotifyContext);
+  return (EFI_EVENT)&mEvent;
+}
+
+/**
+  Stands in for UefiLib EfiEventGroupSignal.  Counts the signals of the apply failed
+  event group, which the Settings Manager would record against the apply.
+**/
+EFI_STATUS
+EFIAPI
+EfiEventGroupSignal (
+  IN CONST EFI_GUID  *EventGroup
+  )
+{
+  if (CompareGuid (EventGroup, &gDfciSettingsApplyFailedEventGroupGuid)) {
+    mApplyFailedCount++;
+  }
+
+  return EFI_SUCCESS;
+}
+
+//
+// Test helpers.
+//
+
+/**
+  Sets every boot manager setting in the variable, without counting the access.
+
+  @param  Value   Value of every setting.
+**/
+STATIC
+VOID
+StoreSettings (
+  IN BOOLEAN  Value
+  )
+{
+  ZeroMem (&mVariable.Settings, sizeof (mVariable.Settings));
+  mVariable.Present                = TRUE;
+  mVariable.Attributes             = MS_BOOT_MANAGER_SETTINGS_ATTRIBUTES;
+  mVariable.Settings.Signature     = MS_BOOT_MANAGER_SETTINGS_SIGNATURE;
+  mVariable.Settings.Version       = MS_BOOT_MANAGER_SETTINGS_VERSION3;
+  mVariable.Settings.IPv6          = Value;
+  mVariable.Settings.AltBoot       = Value;
+  mVariable.Settings.BootOrderLock = Value;
+  mVariable.Settings.EnableUsbBoot = Value;
+  mVariable.Settings.StartNetwork  = Value;
+}
+
+/**
+  Makes the library read the variable again.  The library only drops its copy of the
+  settings when a write fails, so make one fail.
+**/
+STATIC
+VOID
+DropSettingsCache (
+  VOID
+  )
+{
+  BOOLEAN             Value;
+  DFCI_SETTING_FLAGS  Flags;
+
+  GetBootManagerSetting (DFCI_SETTING_ID__IPV6, &Value);
+  mVariable.SetStatus = EFI_DEVICE_ERROR;
+  SetBootManagerSetting (DFCI_SETTING_ID__IPV6, !Value, &Flags);
+  mVariable.SetStatus = EFI_SUCCESS;
+}
+
+/**
+  Clears the variable service counters.
+**/
+STATIC
+VOID
+ResetCounters (
+  VOID
+  )
+{
+  mVariable.GetCount = 0;
+  mVariable.SetCount = 0;
+  mApplyFailedCount  = 0;
+}
+
+/**
+  Applies a value to every boot manager setting the way the Settings Manager applies a
+  settings packet: each setting is read, set and read back between the apply start and
+  complete events.  The current settings are then read twice, for the current settings
+  XML and for its result.
+
+  @param  Value   Value to apply to every setting.
+
+  @retval EFI_SUCCESS   Every setting was applied.
+  @retval Others        A provider failed.
+**/
+STATIC
+EFI_STATUS
+ApplyToAll (
+  IN BOOLEAN  Value
+  )
+{
+  EFI_STATUS          Status;
+  UINTN               Index;
+  UINTN               Pass;
+  UINTN               ValueSize;
+  BOOLEAN             Current;
+  DFCI_SETTING_FLAGS  Flags;
+
+  mApplyStartNotify ((EFI_EVENT)&mEvent, NULL);
+  for (Index = 0; Index < mProviderCount; Index++) {
+    ValueSize = sizeof (Current);
+    Status    = mProviders[Index].GetSettingValue (&mProviders[Index], &ValueSize, &Current);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    Flags  = 0;
+    Status = mProviders[Index].SetSettingValue (&mProviders[Index], sizeof (Value), &Value, &Flags);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+
+    ValueSize = sizeof (Current);
+    Status    = mProviders[Index].GetSettingValue (&mProviders[Index], &ValueSize, &Current);
+    if (EFI_ERROR (Status) || (Current != Value)) {
+      Status = EFI_ERROR (Status) ? Status : EFI_DEVICE_ERROR;
+      break;
+    }
+  }
+
+  mApplyCompleteNotify ((EFI_EVENT)&mEvent, NULL);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Pass = 0; Pass < 2; Pass++) {
+    for (Index = 0; Index < mProviderCount; Index++) {
+      ValueSize = sizeof (Current);
+      Status    = mProviders[Index].GetSettingValue (&mProviders[Index], &ValueSize, &Current);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Installs the mocks and runs the library constructor, which registers the providers.
+**/
+STATIC
+VOID
+EFIAPI
+SuiteSetup (
+  VOID
+  )
+{
+  ZeroMem (&mVariable, sizeof (mVariable));
+  StoreSettings (FALSE);
+
+  ZeroMem (&mMockRuntimeServices, sizeof (mMockRuntimeServices));
+  mMockRuntimeServices.GetVariable = MockGetVariable;
+  mMockRuntimeServices.SetVariable = MockSetVariable;
+  gRT                              = &mMockRuntimeServices;
+
+  ZeroMem (&mMockBootServices, sizeof (mMockBootServices));
+  mMockBootServices.CreateEventEx  = MockCreateEventEx;
+  mMockBootServices.LocateProtocol = MockLocateProtocol;
+  mMockBootServices.CloseEvent     = MockCloseEvent;
+  gBS                              = &mMockBootServices;
+
+  mProviderSupport.RegisterProvider = MockRegisterProvider;
+  mProviderCount                    = 0;
+
+  MsBootManagerSettingsConstructor (NULL, NULL);
+}
+
+/**
+  Checks the constructor registered the providers and the apply event notifications.
+
+  @param Context  Unused.
+
+  @retval UNIT_TEST_PASSED                      The library is ready to test.
+  @retval UNIT_TEST_ERROR_PREREQUISITE_NOT_MET  The constructor did not register everything.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SettingsSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if ((mProviderCount != BOOT_MANAGER_SETTING_COUNT) || (mApplyStartNotify == NULL) || (mApplyCompleteNotify == NULL)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  StoreSettings (FALSE);
+  DropSettingsCache ();
+  ResetCounters ();
+
+  return UNIT_TEST_PASSED;
+}
+
+//
+// Tests.
+//
+
+/**
+  Every read of the settings after the first one comes from the cache.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestGetReadsVariableOnce (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN    Index;
+  BOOLEAN  Value;
+
+  mVariable.Settings.EnableUsbBoot = TRUE;
+  for (Index = 0; Index < 20; Index++) {
+    UT_ASSERT_NOT_EFI_ERROR (GetBootManagerSetting (DFCI_SETTING_ID__ENABLE_USB_BOOT, &Value));
+    UT_ASSERT_TRUE (Value);
+    UT_ASSERT_NOT_EFI_ERROR (GetBootManagerSetting (DFCI_SETTING_ID__IPV6, &Value));
+    UT_ASSERT_FALSE (Value);
+  }
+
+  UT_ASSERT_EQUAL (mVariable.GetCount, 1);
+  UT_ASSERT_EQUAL (mVariable.SetCount, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Applying a packet that changes every setting reads the variable once and writes it
+  once, with all the changes.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestApplyCoalescesWrites (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  UncachedGets;
+  UINTN  UncachedSets;
+
+  UT_ASSERT_NOT_EFI_ERROR (ApplyToAll (TRUE));
+
+  //
+  // Without the cache every get, and every set, reads the variable and every changed
+  // setting writes it.
+  //
+  UncachedGets = BOOT_MANAGER_SETTING_COUNT * (2 + 1 + 2);
+  UncachedSets = BOOT_MANAGER_SETTING_COUNT;
+  UT_LOG_INFO (
+    "Apply of %d settings: %d GetVariable and %d SetVariable (%d and %d without the cache)\n",
+    BOOT_MANAGER_SETTING_COUNT,
+    (UINT32)mVariable.GetCount,
+    (UINT32)mVariable.SetCount,
+    (UINT32)UncachedGets,
+    (UINT32)UncachedSets
+    );
+
+  UT_ASSERT_EQUAL (mVariable.GetCount, 1);
+  UT_ASSERT_EQUAL (mVariable.SetCount, 1);
+  UT_ASSERT_EQUAL (mApplyFailedCount, 0);
+  UT_ASSERT_EQUAL (mVariable.Settings.IPv6, TRUE);
+  UT_ASSERT_EQUAL (mVariable.Settings.AltBoot, TRUE);
+  UT_ASSERT_EQUAL (mVariable.Settings.BootOrderLock, TRUE);
+  UT_ASSERT_EQUAL (mVariable.Settings.EnableUsbBoot, TRUE);
+  UT_ASSERT_EQUAL (mVariable.Settings.StartNetwork, TRUE);
+  UT_ASSERT_EQUAL (mVariable.Settings.Signature, MS_BOOT_MANAGER_SETTINGS_SIGNATURE);
+  UT_ASSERT_EQUAL (mVariable.Settings.Version, MS_BOOT_MANAGER_SETTINGS_VERSION3);
+
+  //
+  // A second packet is served from the cache.
+  //
+  ResetCounters ();
+  UT_ASSERT_NOT_EFI_ERROR (ApplyToAll (FALSE));
+  UT_ASSERT_EQUAL (mVariable.GetCount, 0);
+  UT_ASSERT_EQUAL (mVariable.SetCount, 1);
+  UT_ASSERT_EQUAL (mVariable.Settings.StartNetwork, FALSE);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A packet that changes nothing does not write the variable, and each set reports the
+  setting was already set.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestUnchangedApplyNotWritten (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  DFCI_SETTING_FLAGS  Flags;
+  BOOLEAN             Value;
+
+  UT_ASSERT_NOT_EFI_ERROR (ApplyToAll (FALSE));
+  UT_ASSERT_EQUAL (mVariable.GetCount, 1);
+  UT_ASSERT_EQUAL (mVariable.SetCount, 0);
+
+  Flags = 0;
+  Value = FALSE;
+  mApplyStartNotify ((EFI_EVENT)&mEvent, NULL);
+  UT_ASSERT_NOT_EFI_ERROR (mProviders[0].SetSettingValue (&mProviders[0], sizeof (Value), &Value, &Flags));
+  mApplyCompleteNotify ((EFI_EVENT)&mEvent, NULL);
+  UT_ASSERT_EQUAL (Flags, DFCI_SETTING_FLAGS_OUT_ALREADY_SET);
+  UT_ASSERT_EQUAL (mVariable.SetCount, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Outside of a settings apply a change is written straight away.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestSetOutsideApplyWritesThrough (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  DFCI_SETTING_FLAGS  Flags;
+  BOOLEAN             Value;
+
+  Flags = 0;
+  UT_ASSERT_NOT_EFI_ERROR (SetBootManagerSetting (DFCI_SETTING_ID__ALT_BOOT, TRUE, &Flags));
+  UT_ASSERT_EQUAL (mVariable.GetCount, 1);
+  UT_ASSERT_EQUAL (mVariable.SetCount, 1);
+  UT_ASSERT_EQUAL (mVariable.Settings.AltBoot, TRUE);
+
+  UT_ASSERT_NOT_EFI_ERROR (SetBootManagerSetting (DFCI_SETTING_ID__START_NETWORK, TRUE, &Flags));
+  UT_ASSERT_EQUAL (mVariable.SetCount, 2);
+  UT_ASSERT_EQUAL (mVariable.Settings.StartNetwork, TRUE);
+
+  UT_ASSERT_NOT_EFI_ERROR (GetBootManagerSetting (DFCI_SETTING_ID__ALT_BOOT, &Value));
+  UT_ASSERT_TRUE (Value);
+  UT_ASSERT_EQUAL (mVariable.GetCount, 1);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Resetting every setting to its default between the apply events writes the variable
+  once.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestSetDefaultsCoalesced (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  StoreSettings (TRUE);
+  DropSettingsCache ();
+  ResetCounters ();
+
+  mApplyStartNotify ((EFI_EVENT)&mEvent, NULL);
+  for (Index = 0; Index < mProviderCount; Index++) {
+    UT_ASSERT_NOT_EFI_ERROR (mProviders[Index].SetDefaultValue (&mProviders[Index]));
+  }
+
+  UT_ASSERT_EQUAL (mVariable.SetCount, 0);
+  mApplyCompleteNotify ((EFI_EVENT)&mEvent, NULL);
+
+  UT_ASSERT_EQUAL (mVariable.GetCount, 1);
+  UT_ASSERT_EQUAL (mVariable.SetCount, 1);
+  UT_ASSERT_EQUAL (mVariable.Settings.IPv6, FixedPcdGet8 (PcdEnableIPv6Boot));
+  UT_ASSERT_EQUAL (mVariable.Settings.AltBoot, FixedPcdGet8 (PcdEnableAltBoot));
+  UT_ASSERT_EQUAL (mVariable.Settings.BootOrderLock, FixedPcdGet8 (PcdEnableBootOrderLock));
+  UT_ASSERT_EQUAL (mVariable.Settings.EnableUsbBoot, FixedPcdGet8 (PcdEnableUsbBoot));
+  UT_ASSERT_EQUAL (mVariable.Settings.StartNetwork, FixedPcdGet8 (PcdStartNetwork));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  When the write at the end of an apply fails, the failure is signaled to the Settings
+  Manager, the cache is dropped and the settings are read from the variable again.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestFailedWriteDropsCache (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN               Index;
+  BOOLEAN             Value;
+  DFCI_SETTING_FLAGS  Flags;
+
+  Value = TRUE;
+  mApplyStartNotify ((EFI_EVENT)&mEvent, NULL);
+  for (Index = 0; Index < mProviderCount; Index++) {
+    UT_ASSERT_NOT_EFI_ERROR (mProviders[Index].SetSettingValue (&mProviders[Index], sizeof (Value), &Value, &Flags));
+  }
+
+  UT_ASSERT_EQUAL (mApplyFailedCount, 0);
+  mVariable.SetStatus = EFI_DEVICE_ERROR;
+  mApplyCompleteNotify ((EFI_EVENT)&mEvent, NULL);
+  mVariable.SetStatus = EFI_SUCCESS;
+  UT_ASSERT_EQUAL (mVariable.SetCount, 1);
+  UT_ASSERT_EQUAL (mApplyFailedCount, 1);
+
+  ResetCounters ();
+  UT_ASSERT_NOT_EFI_ERROR (GetBootManagerSetting (DFCI_SETTING_ID__ENABLE_USB_BOOT, &Value));
+  UT_ASSERT_FALSE (Value);
+  UT_ASSERT_EQUAL (mVariable.GetCount, 1);
+
+  UT_ASSERT_NOT_EFI_ERROR (GetBootManagerSetting (DFCI_SETTING_ID__IPV6, &Value));
+  UT_ASSERT_FALSE (Value);
+  UT_ASSERT_EQUAL (mVariable.GetCount, 1);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for
+  MsBootManagerSettingsDxeLib and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      CacheSuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&CacheSuiteHandle, Framework, "MsBootManagerSettingsDxeLib settings cache", "MsBootManagerSettingsDxeLib.Cache", SuiteSetup, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for CacheSuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (CacheSuiteHandle, "Settings are read from the variable once", "GetOnce", TestGetReadsVariableOnce, SettingsSetup, NULL, NULL);
+  AddTestCase (CacheSuiteHandle, "An applied packet is written with one SetVariable", "ApplyCoalesced", TestApplyCoalescesWrites, SettingsSetup, NULL, NULL);
+  AddTestCase (CacheSuiteHandle, "An unchanged packet is not written", "ApplyUnchanged", TestUnchangedApplyNotWritten, SettingsSetup, NULL, NULL);
+  AddTestCase (CacheSuiteHandle, "A set outside an apply is written through", "WriteThrough", TestSetOutsideApplyWritesThrough, SettingsSetup, NULL, NULL);
+  AddTestCase (CacheSuiteHandle, "Defaults set during an apply are written once", "DefaultsCoalesced", TestSetDefaultsCoalesced, SettingsSetup, NULL, NULL);
+  AddTestCase (CacheSuiteHandle, "A failed write is reported and drops the cache", "FailedWrite", TestFailedWriteDropsCache, SettingsSetup, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
@@ -373,12 +373,18 @@ CreateFvBootOption (
 /**
  * Register a boot option
  *
+ * The option is matched against a snapshot of the boot options taken by the caller, so
+ * registering several options reads the Boot#### variables only once. Only an option
+ * missing from the snapshot is written.
+ *
  * @param FileGuid
  * @param Description
  * @param Position
  * @param Attributes
  * @param OptionalData
  * @param OptionalDataSize
+ * @param BootOptions        Snapshot of the boot options from EfiBootManagerGetLoadOptions ()
+ * @param BootOptionCount    Number of entries in BootOptions
  *
  * @return UINTN
  */
@@ -390,21 +396,19 @@ RegisterFvBootOption (
   UINTN Position,
   UINT32 Attributes,
   UINT8 *OptionalData, OPTIONAL
-  UINT32                           OptionalDataSize
+  UINT32                           OptionalDataSize,
+  EFI_BOOT_MANAGER_LOAD_OPTION     *BootOptions,
+  UINTN                            BootOptionCount
   )
 {
   EFI_STATUS                    Status;
   UINTN                         OptionIndex;
   EFI_BOOT_MANAGER_LOAD_OPTION  NewOption;
-  EFI_BOOT_MANAGER_LOAD_OPTION  *BootOptions;
-  UINTN                         BootOptionCount;
   UINTN                         i;
 
   NewOption.OptionNumber = LoadOptionNumberUnassigned;
   Status                 = CreateFvBootOption (FileGuid, Description, &NewOption, Attributes, OptionalData, OptionalDataSize);
   if (!EFI_ERROR (Status)) {
-    BootOptions = EfiBootManagerGetLoadOptions (&BootOptionCount, LoadOptionTypeBoot);
-
     OptionIndex = EfiBootManagerFindLoadOption (&NewOption, BootOptions, BootOptionCount);
     if (OptionIndex == -1) {
       NewOption.Attributes ^= LOAD_OPTION_ACTIVE;
@@ -422,20 +426,16 @@ RegisterFvBootOption (
     }
 
     EfiBootManagerFreeLoadOption (&NewOption);
-    EfiBootManagerFreeLoadOptions (BootOptions, BootOptionCount);
   } else {
     // The Shell is optional.  If the shell cannot be created (due to not in image), then
     // ensure the boot option for INTERNAL SHELL is deleted.
     if (0 == StrCmp (INTERNAL_UEFI_SHELL_NAME, Description)) {
-      BootOptions = EfiBootManagerGetLoadOptions (&BootOptionCount, LoadOptionTypeBoot);
       for (i = 0; i < BootOptionCount; i++) {
         if (0 == StrCmp (INTERNAL_UEFI_SHELL_NAME, BootOptions[i].Description)) {
           EfiBootManagerDeleteLoadOptionVariable (BootOptions[i].OptionNumber, LoadOptionTypeBoot);
           DEBUG ((DEBUG_INFO, "Deleting Boot option as Boot%04x - %s\n", BootOptions[i].OptionNumber, BootOptions[i].Description));
         }
       }
-
-      EfiBootManagerFreeLoadOptions (BootOptions, BootOptionCount);
     }
   }
 
@@ -445,6 +445,10 @@ RegisterFvBootOption (
 /**
  * Register Default Boot Options
  *
+ * The boot options are read once, and every default option is reconciled against that
+ * snapshot. The default options are distinct from each other, so an option added for
+ * one of them can never be the match for another.
+ *
  * @param
  *
  * @return VOID EFIAPI
@@ -455,12 +459,19 @@ MsBootOptionsLibRegisterDefaultBootOptions (
   VOID
   )
 {
+  EFI_BOOT_MANAGER_LOAD_OPTION  *BootOptions;
+  UINTN                         BootOptionCount;
+
   DEBUG ((DEBUG_INFO, "%a\n", __FUNCTION__));
 
-  RegisterFvBootOption (&gMsBootPolicyFileGuid, MS_SDD_BOOT, (UINTN)-1, LOAD_OPTION_ACTIVE, (UINT8 *)MS_SDD_BOOT_PARM, sizeof (MS_SDD_BOOT_PARM));
-  RegisterFvBootOption (&gMsBootPolicyFileGuid, MS_USB_BOOT, (UINTN)-1, LOAD_OPTION_ACTIVE, (UINT8 *)MS_USB_BOOT_PARM, sizeof (MS_USB_BOOT_PARM));
-  RegisterFvBootOption (&gMsBootPolicyFileGuid, MS_PXE_BOOT, (UINTN)-1, LOAD_OPTION_ACTIVE, (UINT8 *)MS_PXE_BOOT_PARM, sizeof (MS_PXE_BOOT_PARM));
-  RegisterFvBootOption (PcdGetPtr (PcdShellFile), INTERNAL_UEFI_SHELL_NAME, (UINTN)-1, LOAD_OPTION_ACTIVE, NULL, 0);
+  BootOptions = EfiBootManagerGetLoadOptions (&BootOptionCount, LoadOptionTypeBoot);
+
+  RegisterFvBootOption (&gMsBootPolicyFileGuid, MS_SDD_BOOT, (UINTN)-1, LOAD_OPTION_ACTIVE, (UINT8 *)MS_SDD_BOOT_PARM, sizeof (MS_SDD_BOOT_PARM), BootOptions, BootOptionCount);
+  RegisterFvBootOption (&gMsBootPolicyFileGuid, MS_USB_BOOT, (UINTN)-1, LOAD_OPTION_ACTIVE, (UINT8 *)MS_USB_BOOT_PARM, sizeof (MS_USB_BOOT_PARM), BootOptions, BootOptionCount);
+  RegisterFvBootOption (&gMsBootPolicyFileGuid, MS_PXE_BOOT, (UINTN)-1, LOAD_OPTION_ACTIVE, (UINT8 *)MS_PXE_BOOT_PARM, sizeof (MS_PXE_BOOT_PARM), BootOptions, BootOptionCount);
+  RegisterFvBootOption (PcdGetPtr (PcdShellFile), INTERNAL_UEFI_SHELL_NAME, (UINTN)-1, LOAD_OPTION_ACTIVE, NULL, 0, BootOptions, BootOptionCount);
+
+  EfiBootManagerFreeLoadOptions (BootOptions, BootOptionCount);
 }
 
 /**
@@ -0,0 +1,901 @@
+/** @file
+  Host based unit tests for registering the default boot options in MsBootOptionsLib.
+
+  UefiBootManagerLib is replaced with a mock variable store that keeps the Boot####
+  options and BootOrder, and counts every variable the real library would read or
+  write for each call.  The firmware volume, loaded image and device path services the
+  library uses to build its options are mocked as well.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+
+#include <Protocol/FirmwareVolume2.h>
+#include <Protocol/LoadedImage.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/DevicePathLib.h>
+#include <Library/DxeServicesLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/MsBootOptionsLib.h>
+#include <Library/PcdLib.h>
+#include <Library/UefiBootManagerLib.h>
+#include <Library/UefiBootServicesTableLib.h>
+#include <Library/UefiLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_NAME     "MsBootOptionsLib Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define INTERNAL_UEFI_SHELL_NAME  L"Internal UEFI Shell 2.0"
+#define DEFAULT_OPTION_COUNT      4
+#define MOCK_MAX_OPTIONS          512
+
+///
+/// Boot#### variables and BootOrder, with the number of variable accesses made
+///
+typedef struct {
+  BOOLEAN                         Present[MOCK_MAX_OPTIONS];
+  EFI_BOOT_MANAGER_LOAD_OPTION    Options[MOCK_MAX_OPTIONS];
+  UINT16                          BootOrder[MOCK_MAX_OPTIONS];
+  UINTN                           BootOrderCount;
+  UINTN                           Reads;
+  UINTN                           Writes;
+  UINTN                           Snapshots;
+} MOCK_VARIABLE_STORE;
+
+///
+/// Device path of the firmware volume that holds the library's image
+///
+typedef struct {
+  MEDIA_FW_VOL_DEVICE_PATH    FvDevPath;
+  EFI_DEVICE_PATH_PROTOCOL    EndDevPath;
+} MOCK_FV_DEVICE_PATH;
+
+STATIC MOCK_VARIABLE_STORE            mStore;
+STATIC BOOLEAN                        mShellPresent;
+STATIC EFI_BOOT_SERVICES              mMockBootServices;
+STATIC EFI_LOADED_IMAGE_PROTOCOL      mLoadedImage;
+STATIC EFI_FIRMWARE_VOLUME2_PROTOCOL  mFv;
+STATIC UINTN                          mFvHandle;
+STATIC UINTN                          mImageHandle;
+STATIC MOCK_FV_DEVICE_PATH            mFvDevicePath = {
+  {
+    {
+      MEDIA_DEVICE_PATH,
+      MEDIA_PIWG_FW_VOL_DP,
+      {
+        (UINT8)(sizeof (MEDIA_FW_VOL_DEVICE_PATH)),
+        (UINT8)(sizeof (MEDIA_FW_VOL_DEVICE_PATH) >> 8)
+      }
+    },
+    { 0x3A2A36D2, 0x5E3B, 0x4F44, { 0x8D, 0x43, 0x59, 0x7B, 0xC1, 0x0F, 0x0A, 0x21 }
+    }
+  },
+  {
+    END_DEVICE_PATH_TYPE,
+    END_ENTIRE_DEVICE_PATH_SUBTYPE,
+    {
+      END_DEVICE_PATH_LENGTH,
+      0
+    }
+  }
+};
+
+//
+// Device path helpers.
+//
+
+/**
+  Returns the size of a device path, including its end node.
+**/
+STATIC
+UINTN
+MockDevicePathSize (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath
+  )
+{
+  CONST UINT8  *Node;
+  UINTN        Length;
+
+  Node = (CONST UINT8 *)DevicePath;
+  while (TRUE) {
+    Length = ((CONST EFI_DEVICE_PATH_PROTOCOL *)Node)->Length[0] | (((CONST EFI_DEVICE_PATH_PROTOCOL *)Node)->Length[1] << 8);
+    if (((CONST EFI_DEVICE_PATH_PROTOCOL *)Node)->Type == END_DEVICE_PATH_TYPE) {
+      return (UINTN)(Node - (CONST UINT8 *)DevicePath) + Length;
+    }
+
+    Node += Length;
+  }
+}
+
+/**
+  Stands in for DevicePathLib DevicePathFromHandle. Every handle is the firmware volume.
+**/
+EFI_DEVICE_PATH_PROTOCOL *
+EFIAPI
+DevicePathFromHandle (
+  IN EFI_HANDLE  Handle
+  )
+{
+  return (EFI_DEVICE_PATH_PROTOCOL *)&mFvDevicePath;
+}
+
+/**
+  Stands in for DevicePathLib AppendDevicePathNode.
+**/
+EFI_DEVICE_PATH_PROTOCOL *
+EFIAPI
+AppendDevicePathNode (
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePath      OPTIONAL,
+  IN CONST EFI_DEVICE_PATH_PROTOCOL  *DevicePathNode  OPTIONAL
+  )
+{
+  UINTN  PathSize;
+  UINTN  NodeSize;
+  UINT8  *NewPath;
+
+  PathSize = MockDevicePathSize (DevicePath) - END_DEVICE_PATH_LENGTH;
+  NodeSize = DevicePathNode->Length[0] | (DevicePathNode->Length[1] << 8);
+  NewPath  = AllocatePool (PathSize + NodeSize + END_DEVICE_PATH_LENGTH);
+  if (NewPath == NULL) {
+    return NULL;
+  }
+
+  CopyMem (NewPath, DevicePath, PathSize);
+  CopyMem (NewPath + PathSize, DevicePathNode, NodeSize);
+  CopyMem (NewPath + PathSize + NodeSize, &mFvDevicePath.EndDevPath, END_DEVICE_PATH_LENGTH);
+
+  return (EFI_DEVICE_PATH_PROTOCOL *)NewPath;
+}
+
+/**
+  Stands in for UefiLib EfiInitializeFwVolDevicepathNode.
+**/
+VOID
+EFIAPI
+EfiInitializeFwVolDevicepathNode (
+  IN OUT MEDIA_FW_VOL_FILEPATH_DEVICE_PATH  *FvDevicePathNode,
+  IN CONST EFI_GUID                         *NameGuid
+  )
+{
+  FvDevicePathNode->Header.Type      = MEDIA_DEVICE_PATH;
+  FvDevicePathNode->Header.SubType   = MEDIA_PIWG_FW_FILE_DP;
+  FvDevicePathNode->Header.Length[0] = (UINT8)sizeof (MEDIA_FW_VOL_FILEPATH_DEVICE_PATH);
+  FvDevicePathNode->Header.Length[1] = (UINT8)(sizeof (MEDIA_FW_VOL_FILEPATH_DEVICE_PATH) >> 8);
+  CopyGuid (&FvDevicePathNode->FvFileName, NameGuid);
+}
+
+/**
+  Stands in for DxeServicesLib GetSectionFromFv. Only used to build the boot manager
+  menu and default boot app options, which these tests do not.
+**/
+EFI_STATUS
+EFIAPI
+GetSectionFromFv (
+  IN  CONST EFI_GUID     *NameGuid,
+  IN  EFI_SECTION_TYPE   SectionType,
+  IN  UINTN              SectionInstance,
+  OUT VOID               **Buffer,
+  OUT UINTN              *Size
+  )
+{
+  return EFI_NOT_FOUND;
+}
+
+//
+// Boot services and firmware volume mocks.
+//
+
+/**
+  Stands in for Fv->ReadSection. The boot policy application is always present, the
+  shell only when mShellPresent is set.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockReadSection (
+  IN CONST  EFI_FIRMWARE_VOLUME2_PROTOCOL  *This,
+  IN CONST  EFI_GUID                       *NameGuid,
+  IN        EFI_SECTION_TYPE               SectionType,
+  IN        UINTN                          SectionInstance,
+  IN OUT    VOID                           **Buffer,
+  IN OUT    UINTN                          *BufferSize,
+  OUT       UINT32                         *AuthenticationStatus
+  )
+{
+  if (CompareGuid (NameGuid, PcdGetPtr (PcdShellFile))) {
+    return mShellPresent ? EFI_SUCCESS : EFI_NOT_FOUND;
+  }
+
+  return CompareGuid (NameGuid, &gMsBootPolicyFileGuid) ? EFI_SUCCESS : EFI_NOT_FOUND;
+}
+
+/**
+  Stands in for gBS->HandleProtocol, for the loaded image and firmware volume protocols.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockHandleProtocol (
+  IN  EFI_HANDLE  Handle,
+  IN  EFI_GUID    *Protocol,
+  OUT VOID        **Interface
+  )
+{
+  if ((Handle == (EFI_HANDLE)&mImageHandle) && CompareGuid (Protocol, &gEfiLoadedImageProtocolGuid)) {
+    *Interface = &mLoadedImage;
+    return EFI_SUCCESS;
+  }
+
+  if ((Handle == (EFI_HANDLE)&mFvHandle) && CompareGuid (Protocol, &gEfiFirmwareVolume2ProtocolGuid)) {
+    *Interface = &mFv;
+    return EFI_SUCCESS;
+  }
+
+  return EFI_UNSUPPORTED;
+}
+
+/**
+  Stands in for gBS->LocateHandleBuffer, returning the one firmware volume.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockLocateHandleBuffer (
+  IN     EFI_LOCATE_SEARCH_TYPE  SearchType,
+  IN     EFI_GUID                *Protocol       OPTIONAL,
+  IN     VOID                    *SearchKey      OPTIONAL,
+  OUT    UINTN                   *NoHandles,
+  OUT    EFI_HANDLE              **Buffer
+  )
+{
+  EFI_HANDLE  FvHandle;
+
+  FvHandle = (EFI_HANDLE)&mFvHandle;
+  *Buffer  = AllocateCopyPool (sizeof (FvHandle), &FvHandle);
+  if (*Buffer == NULL) {
+    *NoHandles = 0;
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  *NoHandles = 1;
+  return EFI_SUCCESS;
+}
+
+//
+// UefiBootManagerLib mocks, backed by the mock variable store.
+//
+
+/**
+  Stands in for UefiBootManagerLib EfiBootManagerInitializeLoadOption.
+**/
+EFI_STATUS
+EFIAPI
+EfiBootManagerInitializeLoadOption (
+  IN OUT EFI_BOOT_MANAGER_LOAD_OPTION       *Option,
+  IN  UINTN                                 OptionNumber,
+  IN  EFI_BOOT_MANAGER_LOAD_OPTION_TYPE     OptionType,
+  IN  UINT32                                Attributes,
+  IN  CHAR16                                *Description,
+  IN  EFI_DEVICE_PATH_PROTOCOL              *FilePath,
+  IN  UINT8                                 *OptionalData,
+  IN  UINT32                                OptionalDataSize
+  )
+{
+  if ((Option == NULL) || (Description == NULL) || (FilePath == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ZeroMem (Option, sizeof (EFI_BOOT_MANAGER_LOAD_OPTION));
+  Option->OptionNumber = OptionNumber;
+  Option->OptionType   = OptionType;
+  Option->Attributes   = Attributes;
+  Option->Description  = AllocateCopyPool (StrSize (Description), Description);
+  Option->FilePath     = AllocateCopyPool (MockDevicePathSize (FilePath), FilePath);
+  if (OptionalDataSize != 0) {
+    Option->OptionalData     = AllocateCopyPool (OptionalDataSize, OptionalData);
+    Option->OptionalDataSize = OptionalDataSize;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Stands in for UefiBootManagerLib EfiBootManagerFreeLoadOption.
+**/
+EFI_STATUS
+EFIAPI
+EfiBootManagerFreeLoadOption (
+  IN  EFI_BOOT_MANAGER_LOAD_OPTION  *LoadOption
+  )
+{
+  if (LoadOption == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (LoadOption->Description != NULL) {
+    FreePool (LoadOption->Description);
+  }
+
+  if (LoadOption->FilePath != NULL) {
+    FreePool (LoadOption->FilePath);
+  }
+
+  if (LoadOption->OptionalData != NULL) {
+    FreePool (LoadOption->OptionalData);
+  }
+
+  ZeroMem (LoadOption, sizeof (EFI_BOOT_MANAGER_LOAD_OPTION));
+  return EFI_SUCCESS;
+}
+
+/**
+  Stands in for UefiBootManagerLib EfiBootManagerFreeLoadOptions.
+**/
+EFI_STATUS
+EFIAPI
+EfiBootManagerFreeLoadOptions (
+  IN  EFI_BOOT_MANAGER_LOAD_OPTION  *LoadOptions,
+  IN  UINTN                         LoadOptionCount
+  )
+{
+  UINTN  Index;
+
+  if (LoadOptions == NULL) {
+    return EFI_NOT_FOUND;
+  }
+
+  for (Index = 0; Index < LoadOptionCount; Index++) {
+    EfiBootManagerFreeLoadOption (&LoadOptions[Index]);
+  }
+
+  FreePool (LoadOptions);
+  return EFI_SUCCESS;
+}
+
+/**
+  Stands in for UefiBootManagerLib EfiBootManagerGetLoadOptions. Reads BootOrder and
+  then every Boot#### variable it lists.
+**/
+EFI_BOOT_MANAGER_LOAD_OPTION *
+EFIAPI
+EfiBootManagerGetLoadOptions (
+  OUT UINTN                              *LoadOptionCount,
+  IN EFI_BOOT_MANAGER_LOAD_OPTION_TYPE   LoadOptionType
+  )
+{
+  EFI_BOOT_MANAGER_LOAD_OPTION  *Options;
+  EFI_BOOT_MANAGER_LOAD_OPTION  *Stored;
+  UINTN                         Index;
+
+  mStore.Snapshots++;
+  mStore.Reads++;
+  *LoadOptionCount = 0;
+  if (mStore.BootOrderCount == 0) {
+    return NULL;
+  }
+
+  Options = AllocateZeroPool (mStore.BootOrderCount * sizeof (EFI_BOOT_MANAGER_LOAD_OPTION));
+  if (Options == NULL) {
+    return NULL;
+  }
+
+  for (Index = 0; Index < mStore.BootOrderCount; Index++) {
+    mStore.Reads++;
+    Stored = &mStore.Options[mStore.BootOrder[Index]];
+    EfiBootManagerInitializeLoadOption (
+      &Options[Index],
+      Stored->OptionNumber,
+      Stored->OptionType,
+      Stored->Attributes,
+      Stored->Description,
+      Stored->FilePath,
+      Stored->OptionalData,
+      Stored->OptionalDataSize
+      );
+  }
+
+  *LoadOptionCount = mStore.BootOrderCount;
+  return Options;
+}
+
+/**
+  Stands in for UefiBootManagerLib EfiBootManagerFindLoadOption.
+**/
+INTN
+EFIAPI
+EfiBootManagerFindLoadOption (
+  IN CONST EFI_BOOT_MANAGER_LOAD_OPTION  *Key,
+  IN CONST EFI_BOOT_MANAGER_LOAD_OPTION  *Array,
+  IN UINTN                               Count
+  )
+{
+  UINTN  Index;
+  UINTN  PathSize;
+
+  PathSize = MockDevicePathSize (Key->FilePath);
+  for (Index = 0; Index < Count; Index++) {
+    if ((Key->OptionType == Array[Index].OptionType) &&
+        (Key->Attributes == Array[Index].Attributes) &&
+        (StrCmp (Key->Description, Array[Index].Description) == 0) &&
+        (PathSize == MockDevicePathSize (Array[Index].FilePath)) &&
+        (CompareMem (Key->FilePath, Array[Index].FilePath, PathSize) == 0) &&
+        (Key->OptionalDataSize == Array[Index].OptionalDataSize) &&
+        ((Key->OptionalDataSize == 0) || (CompareMem (Key->OptionalData, Array[Index].OptionalData, Key->OptionalDataSize) == 0)))
+    {
+      return (INTN)Index;
+    }
+  }
+
+  return -1;
+}
+
+/**
+  Stands in for UefiBootManagerLib EfiBootManagerAddLoadOptionVariable. Like the real
+  library it reads BootOrder to pick a free number, writes Boot####, then reads and
+  writes BootOrder.
+**/
+EFI_STATUS
+EFIAPI
+EfiBootManagerAddLoadOptionVariable (
+  IN OUT EFI_BOOT_MANAGER_LOAD_OPTION  *Option,
+  IN     UINTN                         Position
+  )
+{
+  UINTN  Number;
+
+  mStore.Reads++;
+  for (Number = 0; Number < MOCK_MAX_OPTIONS; Number++) {
+    if (!mStore.Present[Number]) {
+      break;
+    }
+  }
+
+  if (Number == MOCK_MAX_OPTIONS) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Option->OptionNumber = Number;
+  EfiBootManagerInitializeLoadOption (
+    &mStore.Options[Number],
+    Number,
+    Option->OptionType,
+    Option->Attributes,
+    Option->Description,
+    Option->FilePath,
+    Option->OptionalData,
+    Option->OptionalDataSize
+    );
+  mStore.Present[Number] = TRUE;
+  mStore.Writes++;
+
+  Position = MIN (Position, mStore.BootOrderCount);
+  CopyMem (&mStore.BootOrder[Position + 1], &mStore.BootOrder[Position], (mStore.BootOrderCount - Position) * sizeof (UINT16));
+  mStore.BootOrder[Position] = (UINT16)Number;
+  mStore.BootOrderCount++;
+  mStore.Reads++;
+  mStore.Writes++;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Stands in for UefiBootManagerLib EfiBootManagerDeleteLoadOptionVariable. Reads and
+  writes BootOrder, then deletes Boot####.
+**/
+EFI_STATUS
+EFIAPI
+EfiBootManagerDeleteLoadOptionVariable (
+  IN UINTN                              OptionNumber,
+  IN EFI_BOOT_MANAGER_LOAD_OPTION_TYPE  OptionType
+  )
+{
+  UINTN  Index;
+
+  if ((OptionNumber >= MOCK_MAX_OPTIONS) || !mStore.Present[OptionNumber]) {
+    return EFI_NOT_FOUND;
+  }
+
+  mStore.Reads++;
+  for (Index = 0; Index < mStore.BootOrderCount; Index++) {
+    if (mStore.BootOrder[Index] == OptionNumber) {
+      CopyMem (&mStore.BootOrder[Index], &mStore.BootOrder[Index + 1], (mStore.BootOrderCount - Index - 1) * sizeof (UINT16));
+      mStore.BootOrderCount--;
+      break;
+    }
+  }
+
+  mStore.Writes++;
+
+  EfiBootManagerFreeLoadOption (&mStore.Options[OptionNumber]);
+  mStore.Present[OptionNumber] = FALSE;
+  mStore.Writes++;
+
+  return EFI_SUCCESS;
+}
+
+//
+// Test helpers.
+//
+
+/**
+  Adds an option straight to the variable store without counting the accesses.
+
+  @param  Description   Description of the option.
+  @param  Attributes    Attributes of the option.
+  @param  FileGuid      File the option boots from the firmware volume.
+  @param  OptionalData  Optional data of the option.
+  @param  DataSize      Size of OptionalData.
+**/
+STATIC
+VOID
+StoreOption (
+  IN CHAR16    *Description,
+  IN UINT32    Attributes,
+  IN EFI_GUID  *FileGuid,
+  IN VOID      *OptionalData,
+  IN UINT32    DataSize
+  )
+{
+  EFI_BOOT_MANAGER_LOAD_OPTION       Option;
+  MEDIA_FW_VOL_FILEPATH_DEVICE_PATH  FileNode;
+  EFI_DEVICE_PATH_PROTOCOL           *DevicePath;
+  UINTN                              Reads;
+  UINTN                              Writes;
+
+  EfiInitializeFwVolDevicepathNode (&FileNode, FileGuid);
+  DevicePath = AppendDevicePathNode ((EFI_DEVICE_PATH_PROTOCOL *)&mFvDevicePath, (EFI_DEVICE_PATH_PROTOCOL *)&FileNode);
+  EfiBootManagerInitializeLoadOption (
+    &Option,
+    LoadOptionNumberUnassigned,
+    LoadOptionTypeBoot,
+    Attributes,
+    Description,
+    DevicePath,
+    OptionalData,
+    DataSize
+    );
+
+  Reads  = mStore.Reads;
+  Writes = mStore.Writes;
+  EfiBootManagerAddLoadOptionVariable (&Option, MAX_UINTN);
+  mStore.Reads  = Reads;
+  mStore.Writes = Writes;
+
+  EfiBootManagerFreeLoadOption (&Option);
+  FreePool (DevicePath);
+}
+
+/**
+  Adds options that are not defaults to the variable store.
+
+  @param  Count   Number of options to add.
+**/
+STATIC
+VOID
+StoreOtherOptions (
+  IN UINTN  Count
+  )
+{
+  UINT32  Index;
+
+  for (Index = 0; Index < Count; Index++) {
+    StoreOption (L"Other Boot Option", LOAD_OPTION_ACTIVE, &gEfiLoadedImageProtocolGuid, &Index, sizeof (Index));
+  }
+}
+
+/**
+  Counts the options in the store with a description.
+**/
+STATIC
+UINTN
+CountOptions (
+  IN CHAR16  *Description
+  )
+{
+  UINTN  Index;
+  UINTN  Count;
+
+  Count = 0;
+  for (Index = 0; Index < mStore.BootOrderCount; Index++) {
+    if (StrCmp (mStore.Options[mStore.BootOrder[Index]].Description, Description) == 0) {
+      Count++;
+    }
+  }
+
+  return Count;
+}
+
+/**
+  Clears the access counters.
+**/
+STATIC
+VOID
+ResetCounters (
+  VOID
+  )
+{
+  mStore.Reads     = 0;
+  mStore.Writes    = 0;
+  mStore.Snapshots = 0;
+}
+
+/**
+  Empties the variable store and installs the mocks.
+
+  @param Context  Unused.
+
+  @retval UNIT_TEST_PASSED  Always.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+StoreSetup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  ZeroMem (&mStore, sizeof (mStore));
+  mShellPresent = TRUE;
+
+  ZeroMem (&mMockBootServices, sizeof (mMockBootServices));
+  mMockBootServices.HandleProtocol      = MockHandleProtocol;
+  mMockBootServices.LocateHandleBuffer  = MockLocateHandleBuffer;
+  gBS                                   = &mMockBootServices;
+  gImageHandle                          = (EFI_HANDLE)&mImageHandle;
+  mLoadedImage.DeviceHandle             = (EFI_HANDLE)&mFvHandle;
+  mFv.ReadSection                       = MockReadSection;
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Frees everything left in the variable store.
+
+  @param Context  Unused.
+**/
+STATIC
+VOID
+EFIAPI
+StoreCleanup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < MOCK_MAX_OPTIONS; Index++) {
+    if (mStore.Present[Index]) {
+      EfiBootManagerFreeLoadOption (&mStore.Options[Index]);
+    }
+  }
+
+  ZeroMem (&mStore, sizeof (mStore));
+}
+
+//
+// Tests.
+//
+
+/**
+  On a first boot every default option is added from a single snapshot of the boot
+  options, each with one Boot#### and one BootOrder write.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestFirstBootAddsDefaults (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MsBootOptionsLibRegisterDefaultBootOptions ();
+
+  UT_ASSERT_EQUAL (mStore.Snapshots, 1);
+  UT_ASSERT_EQUAL (mStore.BootOrderCount, DEFAULT_OPTION_COUNT);
+  UT_ASSERT_EQUAL (CountOptions (L"Internal Storage"), 1);
+  UT_ASSERT_EQUAL (CountOptions (L"USB Storage"), 1);
+  UT_ASSERT_EQUAL (CountOptions (L"PXE Network"), 1);
+  UT_ASSERT_EQUAL (CountOptions (INTERNAL_UEFI_SHELL_NAME), 1);
+  UT_ASSERT_EQUAL (mStore.Writes, DEFAULT_OPTION_COUNT * 2);
+
+  //
+  // Registered in order, at the end of BootOrder.
+  //
+  UT_ASSERT_EQUAL (StrCmp (mStore.Options[mStore.BootOrder[0]].Description, L"Internal Storage"), 0);
+  UT_ASSERT_EQUAL (StrCmp (mStore.Options[mStore.BootOrder[3]].Description, INTERNAL_UEFI_SHELL_NAME), 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Registering again reads the boot options once and writes nothing.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestRegisteredDefaultsNotRewritten (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  StoreOtherOptions (3);
+  MsBootOptionsLibRegisterDefaultBootOptions ();
+  UT_ASSERT_EQUAL (mStore.BootOrderCount, 3 + DEFAULT_OPTION_COUNT);
+
+  ResetCounters ();
+  MsBootOptionsLibRegisterDefaultBootOptions ();
+
+  UT_ASSERT_EQUAL (mStore.BootOrderCount, 3 + DEFAULT_OPTION_COUNT);
+  UT_ASSERT_EQUAL (mStore.Snapshots, 1);
+  UT_ASSERT_EQUAL (mStore.Reads, 1 + 3 + DEFAULT_OPTION_COUNT);
+  UT_ASSERT_EQUAL (mStore.Writes, 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A default option the user disabled is reused rather than added again, and the other
+  defaults are still added.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestInactiveDefaultReused (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  StoreOption (L"USB Storage", 0, &gMsBootPolicyFileGuid, "USB", sizeof ("USB"));
+
+  MsBootOptionsLibRegisterDefaultBootOptions ();
+
+  UT_ASSERT_EQUAL (mStore.Snapshots, 1);
+  UT_ASSERT_EQUAL (mStore.BootOrderCount, DEFAULT_OPTION_COUNT);
+  UT_ASSERT_EQUAL (CountOptions (L"USB Storage"), 1);
+  UT_ASSERT_EQUAL (mStore.Options[mStore.BootOrder[0]].Attributes, 0);
+  UT_ASSERT_EQUAL (mStore.Writes, (DEFAULT_OPTION_COUNT - 1) * 2);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Without a shell in the image every shell option in the snapshot is deleted, and no
+  shell option is added.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestMissingShellDeletesShellOptions (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  StoreOtherOptions (2);
+  StoreOption (INTERNAL_UEFI_SHELL_NAME, LOAD_OPTION_ACTIVE, PcdGetPtr (PcdShellFile), NULL, 0);
+  StoreOtherOptions (2);
+  StoreOption (INTERNAL_UEFI_SHELL_NAME, 0, PcdGetPtr (PcdShellFile), NULL, 0);
+  mShellPresent = FALSE;
+
+  MsBootOptionsLibRegisterDefaultBootOptions ();
+
+  UT_ASSERT_EQUAL (mStore.Snapshots, 1);
+  UT_ASSERT_EQUAL (CountOptions (INTERNAL_UEFI_SHELL_NAME), 0);
+  UT_ASSERT_EQUAL (CountOptions (L"Other Boot Option"), 4);
+  UT_ASSERT_EQUAL (mStore.BootOrderCount, 4 + DEFAULT_OPTION_COUNT - 1);
+  UT_ASSERT_EQUAL (mStore.Writes, (DEFAULT_OPTION_COUNT - 1) * 2 + 2 * 2);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Counts the variable reads and writes of registering the defaults with boot
+  configurations of growing size, and compares them with taking a snapshot for every
+  default option.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TestAccessesByConfigurationSize (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST UINTN  Sizes[] = { 0, 16, 64, 256 };
+  UINTN               Index;
+  UINTN               PerOptionReads;
+
+  for (Index = 0; Index < ARRAY_SIZE (Sizes); Index++) {
+    StoreCleanup (NULL);
+    StoreOtherOptions (Sizes[Index]);
+    MsBootOptionsLibRegisterDefaultBootOptions ();
+
+    //
+    // Already registered: one read of BootOrder and of each Boot#### option.
+    //
+    ResetCounters ();
+    MsBootOptionsLibRegisterDefaultBootOptions ();
+    PerOptionReads = DEFAULT_OPTION_COUNT * (1 + Sizes[Index] + DEFAULT_OPTION_COUNT);
+
+    UT_LOG_INFO (
+      "%3d other options: %d reads, %d writes (a snapshot per default option reads %d)\n",
+      (UINT32)Sizes[Index],
+      (UINT32)mStore.Reads,
+      (UINT32)mStore.Writes,
+      (UINT32)PerOptionReads
+      );
+    UT_ASSERT_EQUAL (mStore.Snapshots, 1);
+    UT_ASSERT_EQUAL (mStore.Reads, 1 + Sizes[Index] + DEFAULT_OPTION_COUNT);
+    UT_ASSERT_EQUAL (mStore.Writes, 0);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for
+  MsBootOptionsLib and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      RegisterSuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&RegisterSuiteHandle, Framework, "MsBootOptionsLib default boot option registration", "MsBootOptionsLib.Register", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for RegisterSuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (RegisterSuiteHandle, "First boot adds every default option", "FirstBoot", TestFirstBootAddsDefaults, StoreSetup, StoreCleanup, NULL);
+  AddTestCase (RegisterSuiteHandle, "Registered defaults are not written again", "AlreadyRegistered", TestRegisteredDefaultsNotRewritten, StoreSetup, StoreCleanup, NULL);
+  AddTestCase (RegisterSuiteHandle, "An inactive default option is reused", "InactiveDefault", TestInactiveDefaultReused, StoreSetup, StoreCleanup, NULL);
+  AddTestCase (RegisterSuiteHandle, "Shell options are deleted without a shell", "MissingShell", TestMissingShellDeletesShellOptions, StoreSetup, StoreCleanup, NULL);
+  AddTestCase (RegisterSuiteHandle, "Variable accesses by boot configuration size", "AccessesBySize", TestAccessesByConfigurationSize, StoreSetup, StoreCleanup, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
@@ -13,141 +13,47 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/UefiApplicationEntryPoint.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
 #include <Library/Tpm2CommandLib.h>
 #include <Protocol/Tcg2Protocol.h>
 #include <IndustryStandard/UefiTcgPlatform.h>
 #include "TpmEventLogXml.h"
 
 /**
-  Add Header Event to XML List
+  Writes a chunk of the event log XML to the output file.
 
-  @param[in]  EventHdr     TCG PCR event structure.
+  @param[in]  Context  Pointer to the SHELL_FILE_HANDLE of the output file.
+  @param[in]  Size     Number of bytes to write.
+  @param[in]  Buffer   Bytes to write.
 **/
+STATIC
 EFI_STATUS
-AddHeaderEvent (
-  IN XmlNode            *RootNode,
-  IN TCG_PCR_EVENT_HDR  *EventHdr
-  )
-{
-  if (New_NodeInList (RootNode, (UINTN)EventHdr->PCRIndex, (UINTN)EventHdr->EventType, EventHdr->EventSize, (UINT8 *)(EventHdr + 1), 0, NULL) == NULL) {
-    DEBUG ((DEBUG_ERROR, "Failed to create new Header Node.  Event Type: %s PcrIndex: %g\n", EventHdr->EventType, EventHdr->PCRIndex));
-    return EFI_DEVICE_ERROR;
-  }
-
-  return EFI_SUCCESS;
-}
-
-/**
-  This function get size of TCG_EfiSpecIDEventStruct.
-  NOTE: Copied from Tcg2Dxe driver in UDK.
-
-  @param[in]  TcgEfiSpecIdEventStruct     A pointer to TCG_EfiSpecIDEventStruct.
-**/
-UINTN
-GetTcgEfiSpecIdEventStructSize (
-  IN TCG_EfiSpecIDEventStruct  *TcgEfiSpecIdEventStruct
-  )
-{
-  TCG_EfiSpecIdEventAlgorithmSize  *DigestSize;
-  UINT8                            *VendorInfoSize;
-  UINT32                           NumberOfAlgorithms;
-
-  CopyMem (&NumberOfAlgorithms, TcgEfiSpecIdEventStruct + 1, sizeof (NumberOfAlgorithms));
-
-  DigestSize     = (TCG_EfiSpecIdEventAlgorithmSize *)((UINT8 *)TcgEfiSpecIdEventStruct + sizeof (*TcgEfiSpecIdEventStruct) + sizeof (NumberOfAlgorithms));
-  VendorInfoSize = (UINT8 *)&DigestSize[NumberOfAlgorithms];
-  return sizeof (TCG_EfiSpecIDEventStruct) + sizeof (UINT32) + (NumberOfAlgorithms * sizeof (TCG_EfiSpecIdEventAlgorithmSize)) + sizeof (UINT8) + (*VendorInfoSize);
-}
-
-/**
-  Add Event to Xml List
-
-  @param[in]  TcgPcrEvent2     TCG PCR event 2 structure.
-**/
-EFI_STATUS
-AddEvent (
-  IN XmlNode         *RootNode,
-  IN TCG_PCR_EVENT2  *TcgPcrEvent2
+EFIAPI
+WriteXmlToFile (
+  IN VOID   *Context,
+  IN UINTN  Size,
+  IN VOID   *Buffer
   )
 {
-  UINT32         DigestIndex;
-  UINT32         DigestCount;
-  TPMI_ALG_HASH  HashAlgo;
-  UINT32         DigestSize;
-  UINT8          *DigestBuffer;
-  UINT32         EventSize;
-  UINT8          *EventBuffer;
-
-  DigestCount  = TcgPcrEvent2->Digest.count;
-  HashAlgo     = TcgPcrEvent2->Digest.digests[0].hashAlg;
-  DigestBuffer = (UINT8 *)&TcgPcrEvent2->Digest.digests[0].digest;
-  for (DigestIndex = 0; DigestIndex < DigestCount; DigestIndex++) {
-    DigestSize = GetHashSizeFromAlgo (HashAlgo);
-    //
-    // Prepare next
-    //
-    CopyMem (&HashAlgo, DigestBuffer + DigestSize, sizeof (TPMI_ALG_HASH));
-    DigestBuffer = DigestBuffer + DigestSize + sizeof (TPMI_ALG_HASH);
-  }
-
-  DigestBuffer = DigestBuffer - sizeof (TPMI_ALG_HASH);
-
-  CopyMem (&EventSize, DigestBuffer, sizeof (TcgPcrEvent2->EventSize));
-  EventBuffer = DigestBuffer + sizeof (TcgPcrEvent2->EventSize);
+  EFI_STATUS  Status;
+  UINTN       Written;
 
-  if (New_NodeInList (RootNode, (UINTN)TcgPcrEvent2->PCRIndex, (UINTN)TcgPcrEvent2->EventType, EventSize, EventBuffer, TcgPcrEvent2->Digest.count, &TcgPcrEvent2->Digest) == NULL) {
-    DEBUG ((DEBUG_ERROR, "Failed to create new Event Node.  Event Type: %s PcrIndex: %g\n", TcgPcrEvent2->EventType, TcgPcrEvent2->PCRIndex));
-    return EFI_DEVICE_ERROR;
+  Written = Size;
+  Status  = ShellWriteFile (*(SHELL_FILE_HANDLE *)Context, &Written, Buffer);
+  if (!EFI_ERROR (Status) && (Written != Size)) {
+    Status = EFI_VOLUME_FULL;
   }
 
-  return EFI_SUCCESS;
-}
-
-/**
-  This function returns size of TCG PCR event 2.
-  NOTE: Copied from Tcg2Dxe driver in UDK.
-
-  @param[in]  TcgPcrEvent2     TCG PCR event 2 structure.
-
-  @return size of TCG PCR event 2.
-**/
-UINTN
-GetPcrEvent2Size (
-  IN TCG_PCR_EVENT2  *TcgPcrEvent2
-  )
-{
-  UINT32         DigestIndex;
-  UINT32         DigestCount;
-  TPMI_ALG_HASH  HashAlgo;
-  UINT32         DigestSize;
-  UINT8          *DigestBuffer;
-  UINT32         EventSize;
-  UINT8          *EventBuffer;
-
-  DigestCount  = TcgPcrEvent2->Digest.count;
-  HashAlgo     = TcgPcrEvent2->Digest.digests[0].hashAlg;
-  DigestBuffer = (UINT8 *)&TcgPcrEvent2->Digest.digests[0].digest;
-  for (DigestIndex = 0; DigestIndex < DigestCount; DigestIndex++) {
-    DigestSize = GetHashSizeFromAlgo (HashAlgo);
-    //
-    // Prepare next
-    //
-    CopyMem (&HashAlgo, DigestBuffer + DigestSize, sizeof (TPMI_ALG_HASH));
-    DigestBuffer = DigestBuffer + DigestSize + sizeof (TPMI_ALG_HASH);
-  }
-
-  DigestBuffer = DigestBuffer - sizeof (TPMI_ALG_HASH);
-
-  CopyMem (&EventSize, DigestBuffer, sizeof (TcgPcrEvent2->EventSize));
-  EventBuffer = DigestBuffer + sizeof (TcgPcrEvent2->EventSize);
-
-  return (UINTN)EventBuffer + EventSize - (UINTN)TcgPcrEvent2;
+  return Status;
 }
 
 /**
   This function dump event log.
   NOTE: Copied from Tcg2Dxe driver in UDK.
 
+  Events are written to the file as the log is walked, so only a small buffer of the XML is
+  held in memory at any time.
+
   @param[in]  EventLogFormat     The type of the event log for which the information is requested.
   @param[in]  EventLogLocation   A pointer to the memory address of the event log.
   @param[in]  EventLogLastEntry  If the Event Log contains more than one entry, this is a pointer to the
@@ -162,108 +68,71 @@ DumpEventLog (
   IN EFI_TCG2_FINAL_EVENTS_TABLE  *FinalEventsTable
   )
 {
-  TCG_PCR_EVENT_HDR         *EventHdr;
-  TCG_PCR_EVENT2            *TcgPcrEvent2;
-  TCG_EfiSpecIDEventStruct  *TcgEfiSpecIdEventStruct;
-  UINTN                     NumberOfEvents;
-  XmlNode                   *List;
-  CHAR16                    LogFileName[] = L"TpmEventLogAudit_manifest.xml";
-  SHELL_FILE_HANDLE         FileHandle;
-  UINTN                     StringSize = 0;
-  CHAR8                     *XmlString = NULL;
-  EFI_STATUS                Status;
+  CHAR16                LogFileName[] = L"TpmEventLogAudit_manifest.xml";
+  SHELL_FILE_HANDLE     FileHandle    = NULL;
+  EVENT_LOG_XML_STREAM  *Stream       = NULL;
+  EFI_STATUS            Status;
 
   switch (EventLogFormat) {
     case EFI_TCG2_EVENT_LOG_FORMAT_TCG_2:
-      List = New_EventsNodeList ();
-      if (List == NULL) {
-        Status = EFI_DEVICE_ERROR;
-        DEBUG ((DEBUG_ERROR, "Failed to allocate an XML list\n"));
+      Stream = AllocatePool (sizeof (EVENT_LOG_XML_STREAM));
+      if (Stream == NULL) {
+        Status = EFI_OUT_OF_RESOURCES;
+        DEBUG ((DEBUG_ERROR, "Failed to allocate the XML stream\n"));
         goto Exit;
       }
 
-      EventHdr = (TCG_PCR_EVENT_HDR *)(UINTN)EventLogLocation;
-      Status   = AddHeaderEvent (List, EventHdr);
+      Status = ShellOpenFileByName (LogFileName, &FileHandle, EFI_FILE_MODE_CREATE | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ, 0);
       if (EFI_ERROR (Status)) {
-        DEBUG ((DEBUG_ERROR, "AddHeaderEvent failed.  %r\n", Status));
+        DEBUG ((DEBUG_ERROR, "Failed to open %s file for create. Status = %r\n", LogFileName, Status));
+        FileHandle = NULL;
         goto Exit;
       }
 
-      TcgEfiSpecIdEventStruct = (TCG_EfiSpecIDEventStruct *)(EventHdr + 1);
-      TcgPcrEvent2            = (TCG_PCR_EVENT2 *)((UINTN)TcgEfiSpecIdEventStruct + GetTcgEfiSpecIdEventStructSize (TcgEfiSpecIdEventStruct));
-      while ((UINTN)TcgPcrEvent2 <= EventLogLastEntry) {
-        Status = AddEvent (List, TcgPcrEvent2);
-        if (EFI_ERROR (Status)) {
-          DEBUG ((DEBUG_ERROR, "AddEvent failed.  %r\n", Status));
-          goto Exit;
-        }
-
-        TcgPcrEvent2 = (TCG_PCR_EVENT2 *)((UINTN)TcgPcrEvent2 + GetPcrEvent2Size (TcgPcrEvent2));
-      }
-
-      if (FinalEventsTable == NULL) {
-        DEBUG ((DEBUG_ERROR, "FinalEventsTable: NOT FOUND.\n"));
-      } else {
-        TcgPcrEvent2 = (TCG_PCR_EVENT2 *)(UINTN)(FinalEventsTable + 1);
-        for (NumberOfEvents = 0; NumberOfEvents < FinalEventsTable->NumberOfEvents; NumberOfEvents++) {
-          Status = AddEvent (List, TcgPcrEvent2);
-          if (EFI_ERROR (Status)) {
-            DEBUG ((DEBUG_ERROR, "AddEvent failed.  %r\n", Status));
-            goto Exit;
-          }
-
-          TcgPcrEvent2 = (TCG_PCR_EVENT2 *)((UINTN)TcgPcrEvent2 + GetPcrEvent2Size (TcgPcrEvent2));
-        }
-      }
-
-      // Write XML
-      Status = XmlTreeToString (List, FALSE, &StringSize, &XmlString);
+      // Workaround start - delete the file if it exists and then reopen it to fix an issue where file data may be corrupted at the end
+      ShellDeleteFile (&FileHandle);
+      Status = ShellOpenFileByName (LogFileName, &FileHandle, EFI_FILE_MODE_CREATE | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ, 0);
       if (EFI_ERROR (Status)) {
-        DEBUG ((DEBUG_ERROR, "XmlNodeListToString failed.  %r\n", Status));
+        DEBUG ((DEBUG_ERROR, "Failed to open %s file for create. Status = %r\n", LogFileName, Status));
+        FileHandle = NULL;
         goto Exit;
       }
 
-      if (StringSize == 0) {
-        Status = EFI_OUT_OF_RESOURCES;
-        DEBUG ((DEBUG_ERROR, "StringSize equal 0.\n"));
-        goto Exit;
+      // Workaround end
+
+      ShellPrintEx (-1, -1, L"Writing XML to file %s\n", LogFileName);
+
+      Status = EventLogXmlStreamBegin (Stream, WriteXmlToFile, &FileHandle);
+      if (!EFI_ERROR (Status)) {
+        Status = EventLogXmlStreamLog (Stream, EventLogLocation, EventLogLastEntry, FinalEventsTable);
       }
 
-      //
-      // subtract 1 from string size to avoid writing the NULL terminator
-      //
-      StringSize--;
+      if (!EFI_ERROR (Status)) {
+        Status = EventLogXmlStreamEnd (Stream);
+      }
 
-      Status = ShellOpenFileByName (LogFileName, &FileHandle, EFI_FILE_MODE_CREATE | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ, 0);
       if (EFI_ERROR (Status)) {
-        DEBUG ((DEBUG_ERROR, "Failed to open %s file for create. Status = %r\n", LogFileName, Status));
-        goto Exit;
-      } else {
-        // Workaround start - delete the file if it exists and then reopen it to fix an issue where file data may be corrupted at the end
+        DEBUG ((DEBUG_ERROR, "Failed to write the event log XML.  %r\n", Status));
+        //
+        // Don't leave a truncated manifest behind.
+        //
         ShellDeleteFile (&FileHandle);
-        Status = ShellOpenFileByName (LogFileName, &FileHandle, EFI_FILE_MODE_CREATE | EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ, 0);
-        if (EFI_ERROR (Status)) {
-          DEBUG ((DEBUG_ERROR, "Failed to open %s file for create. Status = %r\n", LogFileName, Status));
-          goto Exit;
-        }
-
-        // Workaround end
-
-        ShellPrintEx (-1, -1, L"Writing XML to file %s\n", LogFileName);
-        ShellWriteFile (FileHandle, &StringSize, XmlString);
-        ShellCloseFile (&FileHandle);
+        FileHandle = NULL;
+        goto Exit;
       }
 
+      DEBUG ((DEBUG_INFO, "Wrote %u events, %u bytes of XML\n", (UINT32)Stream->EventCount, (UINT32)Stream->BytesWritten));
+
       // success
       Status = EFI_SUCCESS;
 
 Exit:
-      if (List != NULL) {
-        FreeXmlTree (&List);
+      if (FileHandle != NULL) {
+        ShellCloseFile (&FileHandle);
       }
 
-      if (XmlString != NULL) {
-        FreePool (XmlString);
+      if (Stream != NULL) {
+        FreePool (Stream);
       }
 
       break;
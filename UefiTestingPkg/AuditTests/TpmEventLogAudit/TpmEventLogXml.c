@@ -8,7 +8,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "TpmEventLogXml.h"
 
-#define LIST_XML_TEMPLATE    "<?xml version=\"1.0\" encoding=\"utf-8\"?><Events></Events>"
+#define LIST_XML_TEMPLATE    LIST_XML_DECLARATION "<Events></Events>"
 #define DIGEST_XML_TEMPLATE  "<Digests></Digests>"
 
 #define MAX_STRING_LENGTH  (0xFFFF)
@@ -244,6 +244,7 @@ New_NodeInList (
     goto ERROR_EXIT;
   }
 
+  FreePages (AsciiString, NUM_OF_PAGES);
   return NewEventNode;
 
 ERROR_EXIT:
@@ -265,3 +266,506 @@ ERROR_EXIT:
 
   return NULL;
 }
+
+//
+// Streaming writer.  Produces the same document as XmlTreeToString on the list built by
+// New_EventsNodeList and New_NodeInList (unescaped, no formatting) without holding more than
+// EVENT_LOG_XML_STREAM_BUFFER_SIZE bytes of it at a time.
+//
+
+STATIC CONST CHAR8  mHexDigits[] = "0123456789ABCDEF";
+
+/**
+Hands the buffered bytes to the writer.
+
+@param[in]  Stream  Stream to flush.
+
+@retval EFI_SUCCESS  The buffer is empty.
+@retval Others       The stream failed, now or earlier.
+**/
+STATIC
+EFI_STATUS
+StreamFlush (
+  IN EVENT_LOG_XML_STREAM  *Stream
+  )
+{
+  EFI_STATUS  Status;
+
+  if (EFI_ERROR (Stream->Status) || (Stream->Used == 0)) {
+    return Stream->Status;
+  }
+
+  Status = Stream->Write (Stream->Context, Stream->Used, Stream->Buffer);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a - Write of %u bytes failed.  Status %r\n", __FUNCTION__, (UINT32)Stream->Used, Status));
+    Stream->Status = Status;
+    return Status;
+  }
+
+  Stream->BytesWritten += Stream->Used;
+  Stream->Used          = 0;
+  return EFI_SUCCESS;
+}
+
+/**
+Appends bytes to the stream, flushing as the buffer fills up.
+
+@param[in]  Stream  Stream to append to.
+@param[in]  Data    Bytes to append.
+@param[in]  Size    Number of bytes.
+**/
+STATIC
+VOID
+StreamAppend (
+  IN EVENT_LOG_XML_STREAM  *Stream,
+  IN CONST CHAR8           *Data,
+  IN UINTN                 Size
+  )
+{
+  UINTN  Chunk;
+
+  while ((Size > 0) && !EFI_ERROR (Stream->Status)) {
+    if (Stream->Used == sizeof (Stream->Buffer)) {
+      StreamFlush (Stream);
+      continue;
+    }
+
+    Chunk = sizeof (Stream->Buffer) - Stream->Used;
+    if (Chunk > Size) {
+      Chunk = Size;
+    }
+
+    CopyMem (Stream->Buffer + Stream->Used, Data, Chunk);
+    Stream->Used += Chunk;
+    Data         += Chunk;
+    Size         -= Chunk;
+  }
+}
+
+/**
+Appends a NULL terminated string to the stream.
+**/
+STATIC
+VOID
+StreamAppendString (
+  IN EVENT_LOG_XML_STREAM  *Stream,
+  IN CONST CHAR8           *String
+  )
+{
+  StreamAppend (Stream, String, AsciiStrLen (String));
+}
+
+/**
+Appends a value in decimal, formatted the same way New_NodeInList formats it.
+**/
+STATIC
+VOID
+StreamAppendValue (
+  IN EVENT_LOG_XML_STREAM  *Stream,
+  IN UINTN                 Value
+  )
+{
+  CHAR8  Digits[32];
+
+  Digits[0] = '\0';
+  AsciiValueToStringS (Digits, sizeof (Digits), 0, (INT64)Value, 30);
+  StreamAppendString (Stream, Digits);
+}
+
+/**
+Appends bytes as upper case hex pairs, encoding them directly into the stream buffer.
+**/
+STATIC
+VOID
+StreamAppendHex (
+  IN EVENT_LOG_XML_STREAM  *Stream,
+  IN CONST UINT8           *Data,
+  IN UINTN                 Size
+  )
+{
+  CHAR8  *Out;
+  UINTN  Chunk;
+  UINTN  Index;
+
+  while ((Size > 0) && !EFI_ERROR (Stream->Status)) {
+    Chunk = (sizeof (Stream->Buffer) - Stream->Used) / 2;
+    if (Chunk == 0) {
+      StreamFlush (Stream);
+      continue;
+    }
+
+    if (Chunk > Size) {
+      Chunk = Size;
+    }
+
+    Out = Stream->Buffer + Stream->Used;
+    for (Index = 0; Index < Chunk; Index++) {
+      *Out++ = mHexDigits[Data[Index] >> 4];
+      *Out++ = mHexDigits[Data[Index] & 0xF];
+    }
+
+    Stream->Used += Chunk * 2;
+    Data         += Chunk;
+    Size         -= Chunk;
+  }
+}
+
+/**
+Appends a complete element whose content is a decimal value.
+**/
+STATIC
+VOID
+StreamAppendValueElement (
+  IN EVENT_LOG_XML_STREAM  *Stream,
+  IN CONST CHAR8           *Name,
+  IN UINTN                 Value
+  )
+{
+  StreamAppendString (Stream, "<");
+  StreamAppendString (Stream, Name);
+  StreamAppendString (Stream, ">");
+  StreamAppendValue (Stream, Value);
+  StreamAppendString (Stream, "</");
+  StreamAppendString (Stream, Name);
+  StreamAppendString (Stream, ">");
+}
+
+/**
+Appends an element whose content is hex encoded data.  The opening tag, including any
+attributes, must already be started with "<Name".  Empty content closes it as "<Name />",
+the way XmlTreeToString writes empty elements.
+**/
+STATIC
+VOID
+StreamAppendHexContent (
+  IN EVENT_LOG_XML_STREAM  *Stream,
+  IN CONST CHAR8           *Name,
+  IN CONST UINT8           *Data,
+  IN UINTN                 Size
+  )
+{
+  if (Size == 0) {
+    StreamAppendString (Stream, " />");
+    return;
+  }
+
+  StreamAppendString (Stream, ">");
+  StreamAppendHex (Stream, Data, Size);
+  StreamAppendString (Stream, "</");
+  StreamAppendString (Stream, Name);
+  StreamAppendString (Stream, ">");
+}
+
+/**
+Starts an XML stream and writes the declaration and the opening of the Events element.
+
+@param[out] Stream   Stream to start.
+@param[in]  Write    Writes each chunk of the output.
+@param[in]  Context  Passed to Write.
+
+@retval EFI_SUCCESS            The stream was started.
+@retval EFI_INVALID_PARAMETER  Stream or Write is NULL.
+**/
+EFI_STATUS
+EFIAPI
+EventLogXmlStreamBegin (
+  OUT EVENT_LOG_XML_STREAM  *Stream,
+  IN  EVENT_LOG_XML_WRITE   Write,
+  IN  VOID                  *Context
+  )
+{
+  if ((Stream == NULL) || (Write == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Stream->Write        = Write;
+  Stream->Context      = Context;
+  Stream->Status       = EFI_SUCCESS;
+  Stream->EventCount   = 0;
+  Stream->BytesWritten = 0;
+  Stream->Used         = 0;
+
+  //
+  // The root element is left open.  Whether it becomes "<Events>" or "<Events />" depends on
+  // whether any events follow.
+  //
+  StreamAppendString (Stream, LIST_XML_DECLARATION "<" LIST_ELEMENT_NAME);
+  return Stream->Status;
+}
+
+/**
+Writes an event to the stream.  Takes the same arguments as New_NodeInList and produces the
+same XML.  A DigestCount of 0 writes the header event.
+
+@retval EFI_SUCCESS  The event was written or buffered.
+@retval Others       The stream failed, now or earlier.
+**/
+EFI_STATUS
+EFIAPI
+EventLogXmlStreamAddEvent (
+  IN EVENT_LOG_XML_STREAM  *Stream,
+  IN UINTN                 PcrIndex,
+  IN UINTN                 EventType,
+  IN UINTN                 EventSize,
+  IN UINT8                 *EventBuffer,
+  IN UINTN                 DigestCount,
+  IN TPML_DIGEST_VALUES    *Digest
+  )
+{
+  CONST CHAR8    *EventName;
+  UINTN          DigestIndex;
+  TPMI_ALG_HASH  HashAlgo;
+  UINTN          DigestSize;
+  UINT8          *DigestBuffer;
+
+  if (Stream == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (EFI_ERROR (Stream->Status)) {
+    return Stream->Status;
+  }
+
+  if ((DigestCount > 0) && (Digest == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Stream->EventCount == 0) {
+    StreamAppendString (Stream, ">");
+  }
+
+  EventName = (DigestCount > 0) ? EVENT_ENTRY_ELEMENT_NAME : HEADER_ENTRY_ELEMENT_NAME;
+
+  StreamAppendString (Stream, "<");
+  StreamAppendString (Stream, EventName);
+  StreamAppendString (Stream, ">");
+
+  StreamAppendValueElement (Stream, EVENT_PCR_ELEMENT_NAME, PcrIndex);
+  StreamAppendValueElement (Stream, EVENT_TYPE_ELEMENT_NAME, EventType);
+  StreamAppendValueElement (Stream, EVENT_SIZE_ELEMENT_NAME, EventSize);
+
+  StreamAppendString (Stream, "<" EVENT_DATA_ELEMENT_NAME);
+  StreamAppendHexContent (Stream, EVENT_DATA_ELEMENT_NAME, EventBuffer, EventSize);
+
+  if (DigestCount > 0) {
+    StreamAppendValueElement (Stream, EVENT_DIGEST_COUNT_ELEMENT_NAME, DigestCount);
+    StreamAppendString (Stream, "<" EVENT_DIGESTS_ELEMENT_NAME ">");
+
+    HashAlgo     = Digest->digests[0].hashAlg;
+    DigestBuffer = (UINT8 *)Digest->digests[0].digest.sha1;
+    for (DigestIndex = 0; DigestIndex < DigestCount; DigestIndex++) {
+      DigestSize = GetHashSizeFromAlgo (HashAlgo);
+
+      StreamAppendString (Stream, "<" EVENT_DIGEST_ELEMENT_NAME " " EVENT_HASH_ALGO_ATTRIBUTE_NAME "=\"");
+      StreamAppendValue (Stream, HashAlgo);
+      StreamAppendString (Stream, "\"");
+      StreamAppendHexContent (Stream, EVENT_DIGEST_ELEMENT_NAME, DigestBuffer, DigestSize);
+
+      //
+      // Prepare next
+      //
+      CopyMem (&HashAlgo, DigestBuffer + DigestSize, sizeof (TPMI_ALG_HASH));
+      DigestBuffer = DigestBuffer + DigestSize + sizeof (TPMI_ALG_HASH);
+    }
+
+    StreamAppendString (Stream, "</" EVENT_DIGESTS_ELEMENT_NAME ">");
+  }
+
+  StreamAppendString (Stream, "</");
+  StreamAppendString (Stream, EventName);
+  StreamAppendString (Stream, ">");
+
+  Stream->EventCount++;
+  return Stream->Status;
+}
+
+/**
+Closes the Events element and flushes the rest of the stream.
+
+@param[in]  Stream  Stream to finish.
+
+@retval EFI_SUCCESS  The whole document was written.
+@retval Others       The stream failed, now or earlier.
+**/
+EFI_STATUS
+EFIAPI
+EventLogXmlStreamEnd (
+  IN EVENT_LOG_XML_STREAM  *Stream
+  )
+{
+  if (Stream == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Stream->EventCount == 0) {
+    StreamAppendString (Stream, " />");
+  } else {
+    StreamAppendString (Stream, "</" LIST_ELEMENT_NAME ">");
+  }
+
+  return StreamFlush (Stream);
+}
+
+/**
+This function get size of TCG_EfiSpecIDEventStruct.
+NOTE: Copied from Tcg2Dxe driver in UDK.
+
+@param[in]  TcgEfiSpecIdEventStruct     A pointer to TCG_EfiSpecIDEventStruct.
+**/
+UINTN
+GetTcgEfiSpecIdEventStructSize (
+  IN TCG_EfiSpecIDEventStruct  *TcgEfiSpecIdEventStruct
+  )
+{
+  TCG_EfiSpecIdEventAlgorithmSize  *DigestSize;
+  UINT8                            *VendorInfoSize;
+  UINT32                           NumberOfAlgorithms;
+
+  CopyMem (&NumberOfAlgorithms, TcgEfiSpecIdEventStruct + 1, sizeof (NumberOfAlgorithms));
+
+  DigestSize     = (TCG_EfiSpecIdEventAlgorithmSize *)((UINT8 *)TcgEfiSpecIdEventStruct + sizeof (*TcgEfiSpecIdEventStruct) + sizeof (NumberOfAlgorithms));
+  VendorInfoSize = (UINT8 *)&DigestSize[NumberOfAlgorithms];
+  return sizeof (TCG_EfiSpecIDEventStruct) + sizeof (UINT32) + (NumberOfAlgorithms * sizeof (TCG_EfiSpecIdEventAlgorithmSize)) + sizeof (UINT8) + (*VendorInfoSize);
+}
+
+/**
+Locates the event data of a TCG PCR event 2, which follows the variable length digest list.
+
+@param[in]  TcgPcrEvent2  TCG PCR event 2 structure.
+@param[out] EventSize     Size of the event data.
+
+@return Pointer to the event data.
+**/
+STATIC
+UINT8 *
+GetPcrEvent2Data (
+  IN  TCG_PCR_EVENT2  *TcgPcrEvent2,
+  OUT UINT32          *EventSize
+  )
+{
+  UINT32         DigestIndex;
+  UINT32         DigestCount;
+  TPMI_ALG_HASH  HashAlgo;
+  UINT32         DigestSize;
+  UINT8          *DigestBuffer;
+
+  DigestCount  = TcgPcrEvent2->Digest.count;
+  HashAlgo     = TcgPcrEvent2->Digest.digests[0].hashAlg;
+  DigestBuffer = (UINT8 *)&TcgPcrEvent2->Digest.digests[0].digest;
+  for (DigestIndex = 0; DigestIndex < DigestCount; DigestIndex++) {
+    DigestSize = GetHashSizeFromAlgo (HashAlgo);
+    //
+    // Prepare next
+    //
+    CopyMem (&HashAlgo, DigestBuffer + DigestSize, sizeof (TPMI_ALG_HASH));
+    DigestBuffer = DigestBuffer + DigestSize + sizeof (TPMI_ALG_HASH);
+  }
+
+  DigestBuffer = DigestBuffer - sizeof (TPMI_ALG_HASH);
+
+  CopyMem (EventSize, DigestBuffer, sizeof (TcgPcrEvent2->EventSize));
+  return DigestBuffer + sizeof (TcgPcrEvent2->EventSize);
+}
+
+/**
+This function returns size of TCG PCR event 2.
+NOTE: Copied from Tcg2Dxe driver in UDK.
+
+@param[in]  TcgPcrEvent2     TCG PCR event 2 structure.
+
+@return size of TCG PCR event 2.
+**/
+UINTN
+GetPcrEvent2Size (
+  IN TCG_PCR_EVENT2  *TcgPcrEvent2
+  )
+{
+  UINT32  EventSize;
+  UINT8   *EventBuffer;
+
+  EventBuffer = GetPcrEvent2Data (TcgPcrEvent2, &EventSize);
+  return (UINTN)EventBuffer + EventSize - (UINTN)TcgPcrEvent2;
+}
+
+/**
+Writes a TCG PCR event 2 to the stream.
+
+@param[in]  Stream        Started stream.
+@param[in]  TcgPcrEvent2  TCG PCR event 2 structure.
+
+@return Size of the event in the log.
+**/
+STATIC
+UINTN
+StreamPcrEvent2 (
+  IN EVENT_LOG_XML_STREAM  *Stream,
+  IN TCG_PCR_EVENT2        *TcgPcrEvent2
+  )
+{
+  UINT32  EventSize;
+  UINT8   *EventBuffer;
+
+  EventBuffer = GetPcrEvent2Data (TcgPcrEvent2, &EventSize);
+  EventLogXmlStreamAddEvent (
+    Stream,
+    (UINTN)TcgPcrEvent2->PCRIndex,
+    (UINTN)TcgPcrEvent2->EventType,
+    EventSize,
+    EventBuffer,
+    TcgPcrEvent2->Digest.count,
+    &TcgPcrEvent2->Digest
+    );
+
+  return (UINTN)EventBuffer + EventSize - (UINTN)TcgPcrEvent2;
+}
+
+/**
+Walks a crypto-agile event log and the final events table and writes each event to the
+stream as it goes.
+
+@param[in]  Stream             Started stream.
+@param[in]  EventLogLocation   A pointer to the memory address of the event log.
+@param[in]  EventLogLastEntry  Address of the start of the last entry in the event log.
+@param[in]  FinalEventsTable   A pointer to the memory address of the final event table.  Optional.
+
+@retval EFI_SUCCESS  Every event was written or buffered.
+@retval Others       The stream failed.
+**/
+EFI_STATUS
+EFIAPI
+EventLogXmlStreamLog (
+  IN EVENT_LOG_XML_STREAM         *Stream,
+  IN EFI_PHYSICAL_ADDRESS         EventLogLocation,
+  IN EFI_PHYSICAL_ADDRESS         EventLogLastEntry,
+  IN EFI_TCG2_FINAL_EVENTS_TABLE  *FinalEventsTable OPTIONAL
+  )
+{
+  TCG_PCR_EVENT_HDR         *EventHdr;
+  TCG_PCR_EVENT2            *TcgPcrEvent2;
+  TCG_EfiSpecIDEventStruct  *TcgEfiSpecIdEventStruct;
+  UINT64                    NumberOfEvents;
+
+  if (Stream == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  EventHdr = (TCG_PCR_EVENT_HDR *)(UINTN)EventLogLocation;
+  EventLogXmlStreamAddEvent (Stream, (UINTN)EventHdr->PCRIndex, (UINTN)EventHdr->EventType, EventHdr->EventSize, (UINT8 *)(EventHdr + 1), 0, NULL);
+
+  TcgEfiSpecIdEventStruct = (TCG_EfiSpecIDEventStruct *)(EventHdr + 1);
+  TcgPcrEvent2            = (TCG_PCR_EVENT2 *)((UINTN)TcgEfiSpecIdEventStruct + GetTcgEfiSpecIdEventStructSize (TcgEfiSpecIdEventStruct));
+  while (((UINTN)TcgPcrEvent2 <= EventLogLastEntry) && !EFI_ERROR (Stream->Status)) {
+    TcgPcrEvent2 = (TCG_PCR_EVENT2 *)((UINTN)TcgPcrEvent2 + StreamPcrEvent2 (Stream, TcgPcrEvent2));
+  }
+
+  if (FinalEventsTable == NULL) {
+    DEBUG ((DEBUG_ERROR, "FinalEventsTable: NOT FOUND.\n"));
+  } else {
+    TcgPcrEvent2 = (TCG_PCR_EVENT2 *)(UINTN)(FinalEventsTable + 1);
+    for (NumberOfEvents = 0; (NumberOfEvents < FinalEventsTable->NumberOfEvents) && !EFI_ERROR (Stream->Status); NumberOfEvents++) {
+      TcgPcrEvent2 = (TCG_PCR_EVENT2 *)((UINTN)TcgPcrEvent2 + StreamPcrEvent2 (Stream, TcgPcrEvent2));
+    }
+  }
+
+  return Stream->Status;
+}
@@ -22,6 +22,7 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/ShellLib.h>
 #include <Library/Tpm2CommandLib.h>
 #include <IndustryStandard/UefiTcgPlatform.h>
+#include <Protocol/Tcg2Protocol.h>
 
 /**
 <Events>
@@ -61,6 +62,46 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #define EVENT_HASH_ALGO_ATTRIBUTE_NAME   "HashAlgo"
 #define EVENT_DIGEST_ELEMENT_NAME        "Digest"
 
+#define LIST_XML_DECLARATION  "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+
+//
+// Size of the buffer the XML stream collects output in before handing it to the writer.
+//
+#define EVENT_LOG_XML_STREAM_BUFFER_SIZE  SIZE_4KB
+
+/**
+Writes a chunk of the XML stream to its destination.
+
+@param[in]  Context  Context passed to EventLogXmlStreamBegin.
+@param[in]  Size     Number of bytes to write.
+@param[in]  Buffer   Bytes to write.
+
+@retval EFI_SUCCESS  All of the bytes were written.
+@retval Others       The stream stops and returns this error.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EVENT_LOG_XML_WRITE)(
+  IN VOID   *Context,
+  IN UINTN  Size,
+  IN VOID   *Buffer
+  );
+
+/**
+Serializes the event log straight to the output in the same format as the XmlNode list,
+without building the tree.  Output is collected in a fixed buffer and handed to the writer
+each time it fills up.
+**/
+typedef struct {
+  EVENT_LOG_XML_WRITE    Write;
+  VOID                   *Context;
+  EFI_STATUS             Status;          // First error hit.  Once set, nothing more is written.
+  UINTN                  EventCount;      // Elements written under the root.
+  UINTN                  BytesWritten;    // Bytes handed to Write so far.
+  UINTN                  Used;            // Bytes waiting in Buffer.
+  CHAR8                  Buffer[EVENT_LOG_XML_STREAM_BUFFER_SIZE];
+} EVENT_LOG_XML_STREAM;
+
 /**
 Creates a new XmlNode list following the List
 format.
@@ -102,4 +143,98 @@ New_NodeInList (
   IN TPML_DIGEST_VALUES  *Digest
   );
 
+/**
+Starts an XML stream and writes the declaration and the opening of the Events element.
+
+@param[out] Stream   Stream to start.
+@param[in]  Write    Writes each chunk of the output.
+@param[in]  Context  Passed to Write.
+
+@retval EFI_SUCCESS            The stream was started.
+@retval EFI_INVALID_PARAMETER  Stream or Write is NULL.
+**/
+EFI_STATUS
+EFIAPI
+EventLogXmlStreamBegin (
+  OUT EVENT_LOG_XML_STREAM  *Stream,
+  IN  EVENT_LOG_XML_WRITE   Write,
+  IN  VOID                  *Context
+  );
+
+/**
+Writes an event to the stream.  Takes the same arguments as New_NodeInList and produces the
+same XML.  A DigestCount of 0 writes the header event.
+
+@retval EFI_SUCCESS  The event was written or buffered.
+@retval Others       The stream failed, now or earlier.
+**/
+EFI_STATUS
+EFIAPI
+EventLogXmlStreamAddEvent (
+  IN EVENT_LOG_XML_STREAM  *Stream,
+  IN UINTN                 PcrIndex,
+  IN UINTN                 EventType,
+  IN UINTN                 EventSize,
+  IN UINT8                 *EventBuffer,
+  IN UINTN                 DigestCount,
+  IN TPML_DIGEST_VALUES    *Digest
+  );
+
+/**
+Closes the Events element and flushes the rest of the stream.
+
+@param[in]  Stream  Stream to finish.
+
+@retval EFI_SUCCESS  The whole document was written.
+@retval Others       The stream failed, now or earlier.
+**/
+EFI_STATUS
+EFIAPI
+EventLogXmlStreamEnd (
+  IN EVENT_LOG_XML_STREAM  *Stream
+  );
+
+/**
+Walks a crypto-agile event log and the final events table and writes each event to the
+stream as it goes.
+
+@param[in]  Stream             Started stream.
+@param[in]  EventLogLocation   A pointer to the memory address of the event log.
+@param[in]  EventLogLastEntry  Address of the start of the last entry in the event log.
+@param[in]  FinalEventsTable   A pointer to the memory address of the final event table.  Optional.
+
+@retval EFI_SUCCESS  Every event was written or buffered.
+@retval Others       The stream failed.
+**/
+EFI_STATUS
+EFIAPI
+EventLogXmlStreamLog (
+  IN EVENT_LOG_XML_STREAM         *Stream,
+  IN EFI_PHYSICAL_ADDRESS         EventLogLocation,
+  IN EFI_PHYSICAL_ADDRESS         EventLogLastEntry,
+  IN EFI_TCG2_FINAL_EVENTS_TABLE  *FinalEventsTable OPTIONAL
+  );
+
+/**
+This function get size of TCG_EfiSpecIDEventStruct.
+
+@param[in]  TcgEfiSpecIdEventStruct     A pointer to TCG_EfiSpecIDEventStruct.
+**/
+UINTN
+GetTcgEfiSpecIdEventStructSize (
+  IN TCG_EfiSpecIDEventStruct  *TcgEfiSpecIdEventStruct
+  );
+
+/**
+This function returns size of TCG PCR event 2.
+
+@param[in]  TcgPcrEvent2     TCG PCR event 2 structure.
+
+@return size of TCG PCR event 2.
+**/
+UINTN
+GetPcrEvent2Size (
+  IN TCG_PCR_EVENT2  *TcgPcrEvent2
+  );
+
 #endif // TPM_EVENT_LOG_XML_H
@@ -0,0 +1,751 @@
+/** @file
+  Host based unit tests for the TpmEventLogAudit XML stream.
+
+  Crypto-agile event logs are laid out in memory the way firmware records them, walked by
+  the streaming writer into a mock file, and compared byte for byte against the document
+  XmlTreeToString produces from the XmlNode list.  The mock file also records the largest
+  write it receives so that the memory held by the stream can be compared with the size of
+  the rendered tree.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include "../TpmEventLogXml.h"
+
+#define UNIT_TEST_NAME     "TpmEventLogAudit XML Stream Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define LARGE_LOG_EVENTS    4000
+#define FINAL_TABLE_EVENTS  64
+#define SMALL_LOG_EVENTS    48
+#define MAX_TEST_EVENTS     (LARGE_LOG_EVENTS + FINAL_TABLE_EVENTS + 1)
+#define LOG_CAPACITY        SIZE_4MB
+
+//
+// Hash algorithm the test's GetHashSizeFromAlgo doesn't know.  Its digests take no space.
+//
+#define TEST_UNKNOWN_ALG  0x7777
+
+//
+// An event as the reference path sees it, kept while the log is laid out.
+//
+typedef struct {
+  UINTN                 PcrIndex;
+  UINTN                 EventType;
+  UINTN                 EventSize;
+  UINT8                 *EventBuffer;
+  UINTN                 DigestCount;
+  TPML_DIGEST_VALUES    *Digest;
+} TEST_EVENT;
+
+typedef struct {
+  UINT8                          *Buffer;
+  UINTN                          Used;
+  EFI_PHYSICAL_ADDRESS           LastEntry;
+  EFI_TCG2_FINAL_EVENTS_TABLE    *FinalEventsTable;
+  TEST_EVENT                     *Events;
+  UINTN                          EventCount;
+} TEST_LOG;
+
+//
+// Mock of the output file.  Keeps everything written to it.
+//
+typedef struct {
+  UINT8    *Data;
+  UINTN    Size;
+  UINTN    Capacity;
+  UINTN    WriteCalls;
+  UINTN    LargestWrite;
+  UINTN    FailAfter;       // Number of writes to accept before failing.  MAX_UINTN never fails.
+} MOCK_FILE;
+
+STATIC TEST_LOG   mLog;
+STATIC MOCK_FILE  mFile;
+STATIC UINT32     mRandomState;
+
+/**
+  Digest sizes of the algorithms the test logs use.  Stands in for Tpm2CommandLib.
+**/
+UINT16
+EFIAPI
+GetHashSizeFromAlgo (
+  IN TPMI_ALG_HASH  HashAlgo
+  )
+{
+  switch (HashAlgo) {
+    case TPM_ALG_SHA1:
+      return SHA1_DIGEST_SIZE;
+    case TPM_ALG_SHA256:
+      return SHA256_DIGEST_SIZE;
+    case TPM_ALG_SHA384:
+      return SHA384_DIGEST_SIZE;
+    case TPM_ALG_SHA512:
+      return SHA512_DIGEST_SIZE;
+    default:
+      return 0;
+  }
+}
+
+/**
+  Deterministic pseudo random numbers so that failures reproduce.
+**/
+STATIC
+UINT32
+NextRandom (
+  VOID
+  )
+{
+  mRandomState = mRandomState * 1103515245 + 12345;
+  return (mRandomState >> 8) & 0xFFFFFF;
+}
+
+/**
+  EVENT_LOG_XML_WRITE for the mock file.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockFileWrite (
+  IN VOID   *Context,
+  IN UINTN  Size,
+  IN VOID   *Buffer
+  )
+{
+  MOCK_FILE  *File;
+  UINT8      *NewData;
+
+  File = (MOCK_FILE *)Context;
+  if (File->WriteCalls >= File->FailAfter) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  File->WriteCalls++;
+  if (Size > File->LargestWrite) {
+    File->LargestWrite = Size;
+  }
+
+  if (File->Size + Size > File->Capacity) {
+    NewData = ReallocatePool (File->Capacity, (File->Size + Size) * 2, File->Data);
+    if (NewData == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+
+    File->Data     = NewData;
+    File->Capacity = (File->Size + Size) * 2;
+  }
+
+  CopyMem (File->Data + File->Size, Buffer, Size);
+  File->Size += Size;
+  return EFI_SUCCESS;
+}
+
+STATIC
+VOID *
+LogAppend (
+  IN CONST VOID  *Data OPTIONAL,
+  IN UINTN       Size
+  )
+{
+  VOID   *Position;
+  UINTN  Index;
+
+  ASSERT (mLog.Used + Size <= LOG_CAPACITY);
+  Position = mLog.Buffer + mLog.Used;
+  if (Data != NULL) {
+    CopyMem (Position, Data, Size);
+  } else {
+    for (Index = 0; Index < Size; Index++) {
+      ((UINT8 *)Position)[Index] = (UINT8)NextRandom ();
+    }
+  }
+
+  mLog.Used += Size;
+  return Position;
+}
+
+/**
+  Lays out the TCG_PCR_EVENT_HDR and Spec ID event that start a crypto-agile log.
+**/
+STATIC
+VOID
+LogAddSpecIdEvent (
+  VOID
+  )
+{
+  TCG_PCR_EVENT_HDR                EventHdr;
+  TCG_EfiSpecIDEventStruct         SpecId;
+  TCG_EfiSpecIdEventAlgorithmSize  Algorithms[3];
+  UINT32                           NumberOfAlgorithms;
+  UINT8                            VendorInfoSize;
+  TCG_PCR_EVENT_HDR                *Recorded;
+
+  NumberOfAlgorithms        = ARRAY_SIZE (Algorithms);
+  Algorithms[0].algorithmId = TPM_ALG_SHA1;
+  Algorithms[0].digestSize  = SHA1_DIGEST_SIZE;
+  Algorithms[1].algorithmId = TPM_ALG_SHA256;
+  Algorithms[1].digestSize  = SHA256_DIGEST_SIZE;
+  Algorithms[2].algorithmId = TPM_ALG_SHA384;
+  Algorithms[2].digestSize  = SHA384_DIGEST_SIZE;
+  VendorInfoSize            = 3;
+
+  ZeroMem (&SpecId, sizeof (SpecId));
+  CopyMem (SpecId.signature, TCG_EfiSpecIDEventStruct_SIGNATURE_03, sizeof (TCG_EfiSpecIDEventStruct_SIGNATURE_03));
+  SpecId.specVersionMajor = TCG_EfiSpecIDEventStruct_SPEC_VERSION_MAJOR_TPM2;
+  SpecId.specVersionMinor = TCG_EfiSpecIDEventStruct_SPEC_VERSION_MINOR_TPM2;
+  SpecId.specErrata       = TCG_EfiSpecIDEventStruct_SPEC_ERRATA_TPM2;
+  SpecId.uintnSize        = sizeof (UINTN) / sizeof (UINT32);
+
+  ZeroMem (&EventHdr, sizeof (EventHdr));
+  EventHdr.PCRIndex  = 0;
+  EventHdr.EventType = EV_NO_ACTION;
+  EventHdr.EventSize = (UINT32)(sizeof (SpecId) + sizeof (NumberOfAlgorithms) + sizeof (Algorithms) + sizeof (VendorInfoSize) + VendorInfoSize);
+
+  Recorded = LogAppend (&EventHdr, sizeof (EventHdr));
+  LogAppend (&SpecId, sizeof (SpecId));
+  LogAppend (&NumberOfAlgorithms, sizeof (NumberOfAlgorithms));
+  LogAppend (Algorithms, sizeof (Algorithms));
+  LogAppend (&VendorInfoSize, sizeof (VendorInfoSize));
+  LogAppend (NULL, VendorInfoSize);
+
+  mLog.Events[mLog.EventCount].PcrIndex    = Recorded->PCRIndex;
+  mLog.Events[mLog.EventCount].EventType   = Recorded->EventType;
+  mLog.Events[mLog.EventCount].EventSize   = Recorded->EventSize;
+  mLog.Events[mLog.EventCount].EventBuffer = (UINT8 *)(Recorded + 1);
+  mLog.Events[mLog.EventCount].DigestCount = 0;
+  mLog.Events[mLog.EventCount].Digest      = NULL;
+  mLog.EventCount++;
+}
+
+/**
+  Lays out a TCG_PCR_EVENT2 with packed digests, the way it appears in the log.
+
+  @param[in] Algorithms   Hash algorithm of each digest.
+  @param[in] DigestCount  Number of digests.
+  @param[in] EventSize    Size of the event data.  The data is random.
+
+  @return Address of the event.
+**/
+STATIC
+EFI_PHYSICAL_ADDRESS
+LogAddPcrEvent2 (
+  IN CONST TPMI_ALG_HASH  *Algorithms,
+  IN UINT32               DigestCount,
+  IN UINT32               EventSize
+  )
+{
+  UINT8   *Event;
+  UINT32  Value;
+  UINTN   Index;
+
+  Event = LogAppend (NULL, 0);
+  Value = NextRandom () % 24;
+  LogAppend (&Value, sizeof (Value));
+  Value = (NextRandom () & 1) ? EV_EFI_VARIABLE_DRIVER_CONFIG : (EV_EFI_EVENT_BASE + (NextRandom () % 0x10));
+  LogAppend (&Value, sizeof (Value));
+  LogAppend (&DigestCount, sizeof (DigestCount));
+  for (Index = 0; Index < DigestCount; Index++) {
+    LogAppend (&Algorithms[Index], sizeof (TPMI_ALG_HASH));
+    LogAppend (NULL, GetHashSizeFromAlgo (Algorithms[Index]));
+  }
+
+  LogAppend (&EventSize, sizeof (EventSize));
+  LogAppend (NULL, EventSize);
+
+  mLog.Events[mLog.EventCount].PcrIndex    = ((TCG_PCR_EVENT2 *)Event)->PCRIndex;
+  mLog.Events[mLog.EventCount].EventType   = ((TCG_PCR_EVENT2 *)Event)->EventType;
+  mLog.Events[mLog.EventCount].EventSize   = EventSize;
+  mLog.Events[mLog.EventCount].EventBuffer = mLog.Buffer + mLog.Used - EventSize;
+  mLog.Events[mLog.EventCount].DigestCount = DigestCount;
+  mLog.Events[mLog.EventCount].Digest      = &((TCG_PCR_EVENT2 *)Event)->Digest;
+  mLog.EventCount++;
+
+  return (EFI_PHYSICAL_ADDRESS)(UINTN)Event;
+}
+
+/**
+  Lays out a random event.  Digest banks vary, some events carry no data and some carry a
+  digest of an algorithm the walker has to skip without knowing its size.
+**/
+STATIC
+EFI_PHYSICAL_ADDRESS
+LogAddRandomEvent (
+  VOID
+  )
+{
+  STATIC CONST TPMI_ALG_HASH  Banks[] = { TPM_ALG_SHA1, TPM_ALG_SHA256, TPM_ALG_SHA384, TPM_ALG_SHA512 };
+  TPMI_ALG_HASH               Algorithms[5];
+  UINT32                      DigestCount;
+  UINT32                      EventSize;
+  UINT32                      Index;
+
+  DigestCount = 1 + NextRandom () % 4;
+  for (Index = 0; Index < DigestCount; Index++) {
+    Algorithms[Index] = Banks[(Index + NextRandom ()) % ARRAY_SIZE (Banks)];
+  }
+
+  if (NextRandom () % 16 == 0) {
+    Algorithms[DigestCount++] = TEST_UNKNOWN_ALG;
+  }
+
+  switch (NextRandom () % 8) {
+    case 0:
+      EventSize = 0;
+      break;
+    case 1:
+      EventSize = 1024 + NextRandom () % 4096;
+      break;
+    default:
+      EventSize = NextRandom () % 96;
+      break;
+  }
+
+  return LogAddPcrEvent2 (Algorithms, DigestCount, EventSize);
+}
+
+/**
+  Lays out a log of EventCount events after the Spec ID event, followed by a final events
+  table of FinalCount events.
+**/
+STATIC
+VOID
+LogBuild (
+  IN UINTN    EventCount,
+  IN UINTN    FinalCount,
+  IN BOOLEAN  WithFinalTable
+  )
+{
+  UINTN  Index;
+
+  mLog.Used      = 0;
+  mLog.LastEntry = 0;
+  LogAddSpecIdEvent ();
+  for (Index = 0; Index < EventCount; Index++) {
+    mLog.LastEntry = LogAddRandomEvent ();
+  }
+
+  if (EventCount == 0) {
+    //
+    // Nothing follows the Spec ID event.
+    //
+    mLog.LastEntry = (EFI_PHYSICAL_ADDRESS)(UINTN)mLog.Buffer;
+  }
+
+  mLog.FinalEventsTable = NULL;
+  if (WithFinalTable) {
+    LogAppend (NULL, ALIGN_VALUE (mLog.Used, sizeof (UINT64)) - mLog.Used);
+    mLog.FinalEventsTable                 = LogAppend (NULL, sizeof (EFI_TCG2_FINAL_EVENTS_TABLE));
+    mLog.FinalEventsTable->Version        = EFI_TCG2_FINAL_EVENTS_TABLE_VERSION;
+    mLog.FinalEventsTable->NumberOfEvents = FinalCount;
+    for (Index = 0; Index < FinalCount; Index++) {
+      LogAddRandomEvent ();
+    }
+  }
+}
+
+/**
+  Renders recorded events through the XmlNode list the way the audit used to.
+
+  @param[in]  First       First event to render.
+  @param[in]  Count       Number of events to render.
+  @param[out] XmlString   Rendered document.  Free with FreePool.
+  @param[out] StringSize  Size of the document, excluding the terminator.
+**/
+STATIC
+EFI_STATUS
+RenderReference (
+  IN  UINTN  First,
+  IN  UINTN  Count,
+  OUT CHAR8  **XmlString,
+  OUT UINTN  *StringSize
+  )
+{
+  XmlNode     *List;
+  EFI_STATUS  Status;
+  UINTN       Index;
+
+  List = New_EventsNodeList ();
+  if (List == NULL) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  Status = EFI_SUCCESS;
+  for (Index = First; Index < First + Count; Index++) {
+    if (New_NodeInList (
+          List,
+          mLog.Events[Index].PcrIndex,
+          mLog.Events[Index].EventType,
+          mLog.Events[Index].EventSize,
+          mLog.Events[Index].EventBuffer,
+          mLog.Events[Index].DigestCount,
+          mLog.Events[Index].Digest
+          ) == NULL)
+    {
+      Status = EFI_DEVICE_ERROR;
+      break;
+    }
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = XmlTreeToString (List, FALSE, StringSize, XmlString);
+    if (!EFI_ERROR (Status)) {
+      //
+      // Don't count the NULL terminator, the audit never wrote it.
+      //
+      (*StringSize)--;
+    }
+  }
+
+  FreeXmlTree (&List);
+  return Status;
+}
+
+/**
+  Streams the whole log into the mock file.
+**/
+STATIC
+EFI_STATUS
+StreamLog (
+  OUT EVENT_LOG_XML_STREAM  *Stream
+  )
+{
+  EFI_STATUS  Status;
+
+  Status = EventLogXmlStreamBegin (Stream, MockFileWrite, &mFile);
+  if (!EFI_ERROR (Status)) {
+    Status = EventLogXmlStreamLog (Stream, (EFI_PHYSICAL_ADDRESS)(UINTN)mLog.Buffer, mLog.LastEntry, mLog.FinalEventsTable);
+  }
+
+  if (!EFI_ERROR (Status)) {
+    Status = EventLogXmlStreamEnd (Stream);
+  }
+
+  return Status;
+}
+
+STATIC
+VOID
+EFIAPI
+ResetLog (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mLog.Buffer == NULL) {
+    mLog.Buffer = AllocatePool (LOG_CAPACITY);
+    mLog.Events = AllocatePool (MAX_TEST_EVENTS * sizeof (TEST_EVENT));
+  }
+
+  mLog.Used             = 0;
+  mLog.EventCount       = 0;
+  mLog.LastEntry        = 0;
+  mLog.FinalEventsTable = NULL;
+
+  if (mFile.Data != NULL) {
+    FreePool (mFile.Data);
+  }
+
+  ZeroMem (&mFile, sizeof (mFile));
+  mFile.FailAfter = MAX_UINTN;
+  mRandomState    = 0x54504D32;
+}
+
+STATIC
+VOID
+EFIAPI
+FreeLog (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mFile.Data != NULL) {
+    FreePool (mFile.Data);
+  }
+
+  ZeroMem (&mFile, sizeof (mFile));
+}
+
+/**
+  A large log with a final events table streams to exactly the document the tree produced,
+  while the stream never holds more than its buffer.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LargeLogMatchesTree (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST CHAR8    DocumentStart[] = LIST_XML_DECLARATION "<" LIST_ELEMENT_NAME ">";
+  STATIC CONST CHAR8    DocumentEnd[]   = "</" LIST_ELEMENT_NAME ">";
+  EVENT_LOG_XML_STREAM  *Stream;
+  CHAR8                 *Reference;
+  UINTN                 ReferenceSize;
+  CHAR8                 *Fragment;
+  UINTN                 FragmentSize;
+  UINTN                 Offset;
+  UINTN                 Index;
+
+  UT_ASSERT_NOT_NULL (mLog.Buffer);
+  LogBuild (LARGE_LOG_EVENTS, FINAL_TABLE_EVENTS, TRUE);
+
+  Stream = AllocatePool (sizeof (EVENT_LOG_XML_STREAM));
+  UT_ASSERT_NOT_NULL (Stream);
+  UT_ASSERT_NOT_EFI_ERROR (StreamLog (Stream));
+  UT_ASSERT_EQUAL (Stream->EventCount, mLog.EventCount);
+  UT_ASSERT_EQUAL (Stream->BytesWritten, mFile.Size);
+  FreePool (Stream);
+
+  //
+  // XmlTreeToString takes quadratic time on a list this long, so each event is rendered on
+  // its own and compared with its stretch of the stream.
+  //
+  Offset = sizeof (DocumentStart) - 1;
+  UT_ASSERT_TRUE (mFile.Size > Offset);
+  UT_ASSERT_MEM_EQUAL (mFile.Data, DocumentStart, Offset);
+  for (Index = 0; Index < mLog.EventCount; Index++) {
+    UT_ASSERT_NOT_EFI_ERROR (RenderReference (Index, 1, &Reference, &ReferenceSize));
+    UT_ASSERT_TRUE (ReferenceSize > sizeof (DocumentStart) + sizeof (DocumentEnd) - 2);
+    Fragment     = Reference + sizeof (DocumentStart) - 1;
+    FragmentSize = ReferenceSize - (sizeof (DocumentStart) - 1) - (sizeof (DocumentEnd) - 1);
+    UT_ASSERT_TRUE (Offset + FragmentSize <= mFile.Size);
+    UT_ASSERT_MEM_EQUAL (mFile.Data + Offset, Fragment, FragmentSize);
+    Offset += FragmentSize;
+    FreePool (Reference);
+  }
+
+  UT_ASSERT_EQUAL (Offset + sizeof (DocumentEnd) - 1, mFile.Size);
+  UT_ASSERT_MEM_EQUAL (mFile.Data + Offset, DocumentEnd, sizeof (DocumentEnd) - 1);
+
+  //
+  // The tree had to hold the whole document at once.  The stream holds one buffer.
+  //
+  UT_ASSERT_TRUE (mFile.LargestWrite <= EVENT_LOG_XML_STREAM_BUFFER_SIZE);
+  UT_ASSERT_TRUE (sizeof (EVENT_LOG_XML_STREAM) * 64 < mFile.Size);
+  UT_ASSERT_TRUE (mFile.WriteCalls >= mFile.Size / EVENT_LOG_XML_STREAM_BUFFER_SIZE);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Whole documents match for logs with and without a final events table, including one whose
+  Spec ID event is its only entry.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+SmallLogsMatchTree (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EVENT_LOG_XML_STREAM  Stream;
+  CHAR8                 *Reference;
+  UINTN                 ReferenceSize;
+  UINTN                 Events;
+
+  UT_ASSERT_NOT_NULL (mLog.Buffer);
+  for (Events = 0; Events < SMALL_LOG_EVENTS; Events += 1 + Events / 2) {
+    mLog.EventCount = 0;
+    mFile.Size      = 0;
+    LogBuild (Events, Events % 5, (BOOLEAN)(Events % 2));
+
+    UT_ASSERT_NOT_EFI_ERROR (StreamLog (&Stream));
+    UT_ASSERT_NOT_EFI_ERROR (RenderReference (0, mLog.EventCount, &Reference, &ReferenceSize));
+    UT_ASSERT_EQUAL (mFile.Size, ReferenceSize);
+    UT_ASSERT_MEM_EQUAL (mFile.Data, Reference, ReferenceSize);
+    FreePool (Reference);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A stream without events closes the root the way the tree renders an empty list.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+EmptyStreamMatchesEmptyList (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EVENT_LOG_XML_STREAM  Stream;
+  CHAR8                 *Reference;
+  UINTN                 ReferenceSize;
+
+  UT_ASSERT_NOT_NULL (mLog.Buffer);
+  UT_ASSERT_NOT_EFI_ERROR (EventLogXmlStreamBegin (&Stream, MockFileWrite, &mFile));
+  UT_ASSERT_EQUAL (mFile.WriteCalls, 0);
+  UT_ASSERT_NOT_EFI_ERROR (EventLogXmlStreamEnd (&Stream));
+  UT_ASSERT_EQUAL (mFile.WriteCalls, 1);
+
+  UT_ASSERT_NOT_EFI_ERROR (RenderReference (0, 0, &Reference, &ReferenceSize));
+  UT_ASSERT_EQUAL (mFile.Size, ReferenceSize);
+  UT_ASSERT_MEM_EQUAL (mFile.Data, Reference, ReferenceSize);
+  FreePool (Reference);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Event data larger than the 32 KB the tree path could convert is streamed in pieces.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LargeEventIsStreamed (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST CHAR8    HexDigits[] = "0123456789ABCDEF";
+  TPMI_ALG_HASH         Algorithm;
+  EVENT_LOG_XML_STREAM  Stream;
+  CONST CHAR8           *Data;
+  TEST_EVENT            *Event;
+  UINTN                 Index;
+  UINTN                 EventSize;
+
+  UT_ASSERT_NOT_NULL (mLog.Buffer);
+  EventSize = 3 * EVENT_LOG_XML_STREAM_BUFFER_SIZE * 4 + 7;
+  Algorithm = TPM_ALG_SHA256;
+  LogAddSpecIdEvent ();
+  mLog.LastEntry = LogAddPcrEvent2 (&Algorithm, 1, (UINT32)EventSize);
+  Event          = &mLog.Events[1];
+
+  UT_ASSERT_NOT_EFI_ERROR (StreamLog (&Stream));
+  UT_ASSERT_TRUE (mFile.LargestWrite <= EVENT_LOG_XML_STREAM_BUFFER_SIZE);
+
+  //
+  // Find the data of the second event and check every byte of its encoding.
+  //
+  Data = (CONST CHAR8 *)mFile.Data;
+  for (Index = 0; Index < 2; Index++) {
+    while (AsciiStrnCmp (Data, "<" EVENT_DATA_ELEMENT_NAME ">", sizeof (EVENT_DATA_ELEMENT_NAME) + 1) != 0) {
+      Data++;
+      UT_ASSERT_TRUE ((UINT8 *)Data < mFile.Data + mFile.Size);
+    }
+
+    Data += sizeof (EVENT_DATA_ELEMENT_NAME) + 1;
+  }
+
+  UT_ASSERT_TRUE ((UINT8 *)Data + EventSize * 2 < mFile.Data + mFile.Size);
+  for (Index = 0; Index < EventSize; Index++) {
+    UT_ASSERT_EQUAL (Data[Index * 2], HexDigits[Event->EventBuffer[Index] >> 4]);
+    UT_ASSERT_EQUAL (Data[Index * 2 + 1], HexDigits[Event->EventBuffer[Index] & 0xF]);
+  }
+
+  UT_ASSERT_EQUAL (AsciiStrnCmp (Data + EventSize * 2, "</" EVENT_DATA_ELEMENT_NAME ">", sizeof (EVENT_DATA_ELEMENT_NAME) + 2), 0);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A failed write stops the stream, and nothing further reaches the file.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+WriteFailureStopsStream (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EVENT_LOG_XML_STREAM  Stream;
+  UINTN                 FailAfter;
+  UINTN                 Written;
+
+  UT_ASSERT_NOT_NULL (mLog.Buffer);
+  LogBuild (400, 8, TRUE);
+
+  for (FailAfter = 0; FailAfter < 8; FailAfter++) {
+    FreeLog (Context);
+    mFile.FailAfter = FailAfter;
+
+    UT_ASSERT_STATUS_EQUAL (StreamLog (&Stream), EFI_DEVICE_ERROR);
+    UT_ASSERT_EQUAL (mFile.WriteCalls, FailAfter);
+    UT_ASSERT_EQUAL (Stream.BytesWritten, mFile.Size);
+
+    //
+    // The stream stays failed.
+    //
+    Written = mFile.Size;
+    UT_ASSERT_STATUS_EQUAL (EventLogXmlStreamAddEvent (&Stream, 0, 0, 0, NULL, 0, NULL), EFI_DEVICE_ERROR);
+    UT_ASSERT_STATUS_EQUAL (EventLogXmlStreamEnd (&Stream), EFI_DEVICE_ERROR);
+    UT_ASSERT_EQUAL (mFile.Size, Written);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  TpmEventLogAudit XML stream and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      StreamSuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&StreamSuiteHandle, Framework, "TpmEventLogAudit XML stream tests", "TpmEventLogXml.Stream", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for StreamSuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (StreamSuiteHandle, "Large log matches the XmlNode list", "LargeLog", LargeLogMatchesTree, ResetLog, FreeLog, NULL);
+  AddTestCase (StreamSuiteHandle, "Small logs match the XmlNode list", "SmallLogs", SmallLogsMatchTree, ResetLog, FreeLog, NULL);
+  AddTestCase (StreamSuiteHandle, "Empty stream matches an empty list", "EmptyStream", EmptyStreamMatchesEmptyList, ResetLog, FreeLog, NULL);
+  AddTestCase (StreamSuiteHandle, "Large event data is streamed", "LargeEvent", LargeEventIsStreamed, ResetLog, FreeLog, NULL);
+  AddTestCase (StreamSuiteHandle, "Write failure stops the stream", "WriteFailure", WriteFailureStopsStream, ResetLog, FreeLog, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
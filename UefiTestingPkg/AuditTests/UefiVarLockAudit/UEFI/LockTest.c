@@ -19,11 +19,22 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include <Library/BaseMemoryLib.h>
 
 #include <Library/ShellLib.h>
+#include <Protocol/VariablePolicy.h>
 #include "LockTestXml.h"
+#include "VarPolicyProbe.h"
 
 #define MAX_NAME_LEN   1024
 #define MAX_NAME_SIZE  (MAX_NAME_LEN * sizeof(CHAR16 ))
 
+//
+// Parameters
+//
+STATIC CONST SHELL_PARAM_ITEM  ParamList[] = {
+  { L"-h", TypeFlag },    // -h Help
+  { L"-w", TypeFlag },    // -w Write probe every variable
+  { NULL,  TypeMax  }
+};
+
 XmlNode *
 EFIAPI
 CreateListOfAllVars (
@@ -73,7 +84,8 @@ CreateListOfAllVars (
 EFI_STATUS
 EFIAPI
 UpdateListWithReadWriteInfo (
-  XmlNode  *List
+  XmlNode            *List,
+  VAR_PROBE_CONTEXT  *ProbeContext
   )
 {
   EFI_STATUS  Status;
@@ -91,13 +103,14 @@ UpdateListWithReadWriteInfo (
 
   // Loop thru all children which should be variable nodes
   for (Link = List->ChildrenListHead.ForwardLink; Link != &(List->ChildrenListHead); Link = Link->ForwardLink) {
-    XmlNode     *Current = (XmlNode *)Link;
-    CHAR16      *varName = NULL;
-    EFI_GUID    varGuid;
-    UINT8       *varData         = NULL;
-    UINTN       varDataSize      = 0;
-    UINT32      varAttributes    = 0;
-    EFI_STATUS  StatusFromDelete = EFI_SUCCESS;
+    XmlNode           *Current = (XmlNode *)Link;
+    CHAR16            *varName = NULL;
+    EFI_GUID          varGuid;
+    UINT8             *varData         = NULL;
+    UINTN             varDataSize      = 0;
+    UINT32            varAttributes    = 0;
+    EFI_STATUS        StatusFromDelete = EFI_SUCCESS;
+    VAR_PROBE_METHOD  ProbeMethod      = VarProbeMethodWriteProbe;
 
     // Get current info
     Status = GetNameGuidMembersFromNode (Current, &varName, &varGuid);
@@ -118,19 +131,15 @@ UpdateListWithReadWriteInfo (
     DEBUG ((DEBUG_INFO, " ::%s", varName));
     DEBUG ((DEBUG_INFO, "\n"));  // do independent debug print so that we always have newline.  Some names can be long and overrun the debug buffer
 
-    // Delete current var
-    StatusFromDelete = gRT->SetVariable (varName, &varGuid, varAttributes, 0, NULL);
-    Status           = AddReadyToBootStatusToNode (Current, EFI_SUCCESS, StatusFromDelete);
+    // Get the delete status from the variable policy, or by deleting and restoring the var
+    Status = VarProbeWriteStatus (ProbeContext, varName, &varGuid, varAttributes, varDataSize, varData, &StatusFromDelete, &ProbeMethod);
     if (EFI_ERROR (Status)) {
-      DEBUG ((DEBUG_ERROR, "%a failed in AddReadyToBootStatusToNode.  Status = %r\n", __FUNCTION__, Status));
+      DEBUG ((DEBUG_ERROR, "%a failed in VarProbeWriteStatus.  Status = %r\n", __FUNCTION__, Status));
     }
 
-    // restore if needed
-    if (!EFI_ERROR (StatusFromDelete)) {
-      Status = gRT->SetVariable (varName, &varGuid, varAttributes, varDataSize, varData);
-      if (EFI_ERROR (Status)) {
-        DEBUG ((DEBUG_ERROR, "%a failed to restore variable data.  Status = %r\n", __FUNCTION__, Status));
-      }
+    Status = AddReadyToBootStatusToNode (Current, EFI_SUCCESS, StatusFromDelete, VarProbeMethodToString (ProbeMethod));
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a failed in AddReadyToBootStatusToNode.  Status = %r\n", __FUNCTION__, Status));
     }
 
     // clean up
@@ -164,12 +173,55 @@ LockTestEntry (
   IN EFI_SYSTEM_TABLE  *SystemTable
   )
 {
-  EFI_STATUS         Status;
-  CHAR16             LogFileName[] = L"UefiVarLockAudit_manifest.xml";
-  SHELL_FILE_HANDLE  FileHandle;
-  XmlNode            *MyList    = NULL;
-  UINTN              StringSize = 0;
-  CHAR8              *XmlString = NULL;
+  EFI_STATUS                      Status;
+  CHAR16                          LogFileName[] = L"UefiVarLockAudit_manifest.xml";
+  SHELL_FILE_HANDLE               FileHandle;
+  XmlNode                         *MyList    = NULL;
+  UINTN                           StringSize = 0;
+  CHAR8                           *XmlString = NULL;
+  LIST_ENTRY                      *ParamPackage;
+  CHAR16                          *ProblemParm   = NULL;
+  EDKII_VARIABLE_POLICY_PROTOCOL  *VariablePolicy = NULL;
+  VAR_PROBE_CONTEXT               ProbeContext;
+
+  ZeroMem (&ProbeContext, sizeof (ProbeContext));
+
+  Status = ShellCommandLineParseEx (ParamList, &ParamPackage, &ProblemParm, FALSE, TRUE);
+  if (EFI_ERROR (Status)) {
+    if (ProblemParm != NULL) {
+      AsciiPrint ("Invalid parameter %s\n", ProblemParm);
+      FreePool (ProblemParm);
+    } else {
+      AsciiPrint ("Unable to parse command line. Code=%r", Status);
+    }
+
+    return SHELL_INVALID_PARAMETER;
+  }
+
+  if (ShellCommandLineGetFlag (ParamPackage, L"-h")) {
+    AsciiPrint ("%a [-h] [-w]\n", gEfiCallerBaseName);
+    AsciiPrint ("   -h    Print this Help\n");
+    AsciiPrint ("   -w    Delete and restore every variable instead of using the Variable Policy\n");
+    ShellCommandLineFreeVarList (ParamPackage);
+    return 0;
+  }
+
+  // Unless every variable should be write probed, use the variable policy to avoid NV writes
+  if (!ShellCommandLineGetFlag (ParamPackage, L"-w")) {
+    Status = gBS->LocateProtocol (&gEdkiiVariablePolicyProtocolGuid, NULL, (VOID **)&VariablePolicy);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN, "Variable Policy protocol not found.  Status = %r\n", Status));
+      VariablePolicy = NULL;
+    }
+  }
+
+  ShellCommandLineFreeVarList (ParamPackage);
+
+  Status = VarProbeInit (&ProbeContext, VariablePolicy);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed to initialize the variable probe = %r\n", Status));
+    goto Exit;
+  }
 
   MyList = CreateListOfAllVars ();
   if (MyList == NULL) {
@@ -179,12 +231,14 @@ LockTestEntry (
   }
 
   // Get R/W properties
-  Status = UpdateListWithReadWriteInfo (MyList);
+  Status = UpdateListWithReadWriteInfo (MyList, &ProbeContext);
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR, "Failed to Update List with Read/Write Properties = %r\n", Status));
     goto Exit;
   }
 
+  ShellPrintEx (-1, -1, L"Write status from variable policy: %d, from write probe: %d\n", (UINT32)ProbeContext.PolicyAnswers, (UINT32)ProbeContext.WriteProbes);
+
   // Write XML
   Status = XmlTreeToString (MyList, TRUE, &StringSize, &XmlString);
   if (EFI_ERROR (Status)) {
@@ -229,6 +283,8 @@ LockTestEntry (
   Status = EFI_SUCCESS;
 
 Exit:
+  VarProbeFree (&ProbeContext);
+
   if (MyList != NULL) {
     FreeXmlTree (&MyList);
   }
@@ -341,7 +341,8 @@ EFIAPI
 AddReadyToBootStatusToNode (
   IN CONST XmlNode  *Node,
   IN EFI_STATUS     ReadStatus,
-  IN EFI_STATUS     WriteStatus
+  IN EFI_STATUS     WriteStatus,
+  IN CONST CHAR8    *ProbeMethod
   )
 {
   XmlNode     *StatusNode = NULL;
@@ -369,6 +370,13 @@ AddReadyToBootStatusToNode (
     goto ERROR_EXIT;
   }
 
+  // Record how the write status was determined
+  Status = AddNode (StatusNode, VAR_PROBE_METHOD_ELEMENT_NAME, ProbeMethod, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "%a - AddNode for Probe Method Failed.  Status %r\n", __FUNCTION__, Status));
+    goto ERROR_EXIT;
+  }
+
   // Add the StatusNode to the end of the Node
   Status = AddChildTree ((XmlNode *)Node, StatusNode);
   if (EFI_ERROR (Status)) {
@@ -30,6 +30,7 @@
     <ReadyToBoot>
       <ReadStatus></ReadStatus>
       <WriteStatus></WriteStatus>
+      <ProbeMethod></ProbeMethod>
     </ReadyToBoot>
     <OsRuntime>
       <ReadStatus></ReadStatus>
@@ -50,6 +51,7 @@
 #define VAR_OSRUNTIME_ELEMENT_NAME     "OsRuntime"
 #define VAR_READ_STATUS_ELEMENT_NAME   "ReadStatus"
 #define VAR_WRITE_STATUS_ELEMENT_NAME  "WriteStatus"
+#define VAR_PROBE_METHOD_ELEMENT_NAME  "ProbeMethod"
 
 /**
 Creates a new XmlNode list following the List
@@ -96,7 +98,8 @@ EFIAPI
 AddReadyToBootStatusToNode (
   IN CONST XmlNode  *Node,
   IN EFI_STATUS     ReadStatus,
-  IN EFI_STATUS     WriteStatus
+  IN EFI_STATUS     WriteStatus,
+  IN CONST CHAR8    *ProbeMethod
   );
 
 EFI_STATUS
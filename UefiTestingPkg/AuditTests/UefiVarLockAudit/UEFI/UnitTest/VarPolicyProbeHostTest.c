@@ -0,0 +1,622 @@
+/** @file
+  Host based unit tests for the UefiVarLockAudit variable write probe.
+
+  A mocked variable store enforces write protection and counts NV writes, and a mocked
+  Variable Policy protocol dumps a policy table that describes the same protection.
+  Each test compares the write probe only mode with the policy first mode.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+#include "../VarPolicyProbe.h"
+
+#define UNIT_TEST_NAME     "UefiVarLockAudit Variable Probe Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define MOCK_MAX_NAME      32
+#define MOCK_MAX_DATA      8
+#define MOCK_POLICY_SIZE   0x400
+
+#define NV_BS     (EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS)
+#define NV_BS_RT  (EFI_VARIABLE_NON_VOLATILE | EFI_VARIABLE_BOOTSERVICE_ACCESS | EFI_VARIABLE_RUNTIME_ACCESS)
+
+typedef struct {
+  CHAR16        *Name;
+  EFI_GUID      *Guid;
+  UINT32        Attributes;
+  BOOLEAN       WriteProtected;     // Ground truth enforced by the mocked store.
+  EFI_STATUS    ExpectedStatus;     // Status a real delete returns.
+  BOOLEAN       Present;
+  UINTN         DataSize;
+  UINT8         Data[MOCK_MAX_DATA];
+} MOCK_VARIABLE;
+
+STATIC EFI_GUID  mVendorA = {
+  0x6b6e7a3c, 0x1d0f, 0x4c52, { 0x9a, 0x3e, 0x51, 0x7c, 0x2d, 0x84, 0x0b, 0xf1 }
+};
+STATIC EFI_GUID  mVendorB = {
+  0x8be4df61, 0x93ca, 0x11d2, { 0xaa, 0x0d, 0x00, 0xe0, 0x98, 0x03, 0x2b, 0x8c }
+};
+STATIC EFI_GUID  mVendorC = {
+  0x2f4c1a90, 0x7e35, 0x4b1d, { 0x86, 0x0a, 0xc3, 0x5e, 0x92, 0x7d, 0x14, 0x6b }
+};
+STATIC EFI_GUID  mVendorD = {
+  0xd1a0e7b4, 0x3c58, 0x4f2e, { 0xb9, 0x61, 0x0e, 0x47, 0xa8, 0x5c, 0x33, 0x9d }
+};
+
+STATIC MOCK_VARIABLE  mVariables[] = {
+  { L"LockedNow",     &mVendorA, NV_BS,                                                      TRUE,  EFI_WRITE_PROTECTED    },
+  { L"Open",          &mVendorA, NV_BS_RT,                                                   FALSE, EFI_SUCCESS            },
+  { L"Boot0001",      &mVendorB, NV_BS_RT,                                                   FALSE, EFI_SUCCESS            },
+  { L"PlatformThing", &mVendorB, NV_BS,                                                      TRUE,  EFI_WRITE_PROTECTED    },
+  { L"Created",       &mVendorA, NV_BS,                                                      TRUE,  EFI_WRITE_PROTECTED    },
+  { L"StateLocked",   &mVendorC, NV_BS,                                                      TRUE,  EFI_WRITE_PROTECTED    },
+  { L"LockState",     &mVendorC, EFI_VARIABLE_BOOTSERVICE_ACCESS,                            FALSE, EFI_SUCCESS            },
+  { L"Unknown",       &mVendorD, NV_BS,                                                      FALSE, EFI_SUCCESS            },
+  { L"AuthVar",       &mVendorA, NV_BS_RT | EFI_VARIABLE_TIME_BASED_AUTHENTICATED_WRITE_ACCESS, FALSE, EFI_SECURITY_VIOLATION },
+};
+
+#define LOCK_STATE_INDEX  6
+
+STATIC UINTN    mNvWrites;
+STATIC UINTN    mSetVariableCalls;
+STATIC BOOLEAN  mPolicyEnabled;
+STATIC UINT8    mPolicyDump[MOCK_POLICY_SIZE];
+STATIC UINT32   mPolicyDumpSize;
+
+/**
+  Finds a variable in the mocked store.
+**/
+STATIC
+MOCK_VARIABLE *
+FindMockVariable (
+  IN CHAR16    *Name,
+  IN EFI_GUID  *Guid
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mVariables); Index++) {
+    if (CompareGuid (mVariables[Index].Guid, Guid) && (StrCmp (mVariables[Index].Name, Name) == 0)) {
+      return &mVariables[Index];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Mock gRT->GetVariable.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockGetVariable (
+  IN     CHAR16    *VariableName,
+  IN     EFI_GUID  *VendorGuid,
+  OUT    UINT32    *Attributes OPTIONAL,
+  IN OUT UINTN     *DataSize,
+  OUT    VOID      *Data OPTIONAL
+  )
+{
+  MOCK_VARIABLE  *Variable;
+
+  Variable = FindMockVariable (VariableName, VendorGuid);
+  if ((Variable == NULL) || !Variable->Present) {
+    return EFI_NOT_FOUND;
+  }
+
+  if (*DataSize < Variable->DataSize) {
+    *DataSize = Variable->DataSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  *DataSize = Variable->DataSize;
+  CopyMem (Data, Variable->Data, Variable->DataSize);
+  if (Attributes != NULL) {
+    *Attributes = Variable->Attributes;
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Mock gRT->SetVariable.  Only deletes and rewrites of existing variables are supported.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockSetVariable (
+  IN CHAR16    *VariableName,
+  IN EFI_GUID  *VendorGuid,
+  IN UINT32    Attributes,
+  IN UINTN     DataSize,
+  IN VOID      *Data
+  )
+{
+  MOCK_VARIABLE  *Variable;
+
+  mSetVariableCalls++;
+
+  Variable = FindMockVariable (VariableName, VendorGuid);
+  if ((Variable == NULL) || (DataSize > MOCK_MAX_DATA)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Variable->WriteProtected) {
+    return EFI_WRITE_PROTECTED;
+  }
+
+  if ((Attributes & EFI_VARIABLE_TIME_BASED_AUTHENTICATED_WRITE_ACCESS) != 0) {
+    return EFI_SECURITY_VIOLATION;
+  }
+
+  if (DataSize == 0) {
+    if (!Variable->Present) {
+      return EFI_NOT_FOUND;
+    }
+
+    Variable->Present = FALSE;
+  } else {
+    Variable->Present  = TRUE;
+    Variable->DataSize = DataSize;
+    CopyMem (Variable->Data, Data, DataSize);
+  }
+
+  if ((Attributes & EFI_VARIABLE_NON_VOLATILE) != 0) {
+    mNvWrites++;
+  }
+
+  return EFI_SUCCESS;
+}
+
+STATIC EFI_RUNTIME_SERVICES  mMockRuntime = {
+  .GetVariable = MockGetVariable,
+  .SetVariable = MockSetVariable,
+};
+
+EFI_RUNTIME_SERVICES  *gRT = &mMockRuntime;
+
+/**
+  Mock VariablePolicy->IsVariablePolicyEnabled.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockIsVariablePolicyEnabled (
+  OUT BOOLEAN  *State
+  )
+{
+  *State = mPolicyEnabled;
+  return EFI_SUCCESS;
+}
+
+/**
+  Mock VariablePolicy->DumpVariablePolicy.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+MockDumpVariablePolicy (
+  OUT UINT8      *Policy OPTIONAL,
+  IN OUT UINT32  *Size
+  )
+{
+  if ((Policy == NULL) || (*Size < mPolicyDumpSize)) {
+    *Size = mPolicyDumpSize;
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  CopyMem (Policy, mPolicyDump, mPolicyDumpSize);
+  *Size = mPolicyDumpSize;
+  return EFI_SUCCESS;
+}
+
+STATIC EDKII_VARIABLE_POLICY_PROTOCOL  mMockVariablePolicy = {
+  .IsVariablePolicyEnabled = MockIsVariablePolicyEnabled,
+  .DumpVariablePolicy      = MockDumpVariablePolicy,
+};
+
+/**
+  Appends a policy entry to the mocked policy dump.
+**/
+STATIC
+VOID
+AddPolicy (
+  IN EFI_GUID  *Namespace,
+  IN CHAR16    *Name OPTIONAL,
+  IN UINT8     LockPolicyType,
+  IN EFI_GUID  *StateNamespace OPTIONAL,
+  IN CHAR16    *StateName OPTIONAL,
+  IN UINT8     StateValue
+  )
+{
+  VARIABLE_POLICY_ENTRY              *Entry;
+  VARIABLE_LOCK_ON_VAR_STATE_POLICY  *StatePolicy;
+  UINT16                             Size;
+
+  Entry = (VARIABLE_POLICY_ENTRY *)(mPolicyDump + mPolicyDumpSize);
+  ZeroMem (Entry, sizeof (VARIABLE_POLICY_ENTRY));
+
+  Size = sizeof (VARIABLE_POLICY_ENTRY);
+  if (LockPolicyType == VARIABLE_POLICY_TYPE_LOCK_ON_VAR_STATE) {
+    StatePolicy = (VARIABLE_LOCK_ON_VAR_STATE_POLICY *)(Entry + 1);
+    CopyMem (&StatePolicy->Namespace, StateNamespace, sizeof (EFI_GUID));
+    StatePolicy->Value   = StateValue;
+    StatePolicy->Padding = 0;
+    CopyMem (StatePolicy + 1, StateName, StrSize (StateName));
+    Size += (UINT16)(sizeof (VARIABLE_LOCK_ON_VAR_STATE_POLICY) + StrSize (StateName));
+  }
+
+  Entry->OffsetToName = Size;
+  if (Name != NULL) {
+    CopyMem ((UINT8 *)Entry + Size, Name, StrSize (Name));
+    Size += (UINT16)StrSize (Name);
+  }
+
+  Entry->Version            = VARIABLE_POLICY_ENTRY_REVISION;
+  Entry->Size               = Size;
+  Entry->MinSize            = VARIABLE_POLICY_NO_MIN_SIZE;
+  Entry->MaxSize            = VARIABLE_POLICY_NO_MAX_SIZE;
+  Entry->LockPolicyType     = LockPolicyType;
+  Entry->AttributesMustHave = 0;
+  Entry->AttributesCantHave = 0;
+  CopyMem (&Entry->Namespace, Namespace, sizeof (EFI_GUID));
+
+  mPolicyDumpSize += Size;
+}
+
+/**
+  Resets the mocked store and builds the policy table that matches its protection.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SetupMocks (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mVariables); Index++) {
+    mVariables[Index].Present  = TRUE;
+    mVariables[Index].DataSize = 4;
+    SetMem (mVariables[Index].Data, MOCK_MAX_DATA, (UINT8)(0xA0 + Index));
+  }
+
+  // LockState == 1 engages the lock on StateLocked.
+  mVariables[LOCK_STATE_INDEX].DataSize = 1;
+  mVariables[LOCK_STATE_INDEX].Data[0]  = 1;
+
+  mNvWrites         = 0;
+  mSetVariableCalls = 0;
+  mPolicyEnabled    = TRUE;
+  mPolicyDumpSize   = 0;
+
+  AddPolicy (&mVendorA, L"LockedNow", VARIABLE_POLICY_TYPE_LOCK_NOW, NULL, NULL, 0);
+  AddPolicy (&mVendorA, L"Open", VARIABLE_POLICY_TYPE_NO_LOCK, NULL, NULL, 0);
+  AddPolicy (&mVendorB, NULL, VARIABLE_POLICY_TYPE_LOCK_NOW, NULL, NULL, 0);
+  AddPolicy (&mVendorB, L"Boot####", VARIABLE_POLICY_TYPE_NO_LOCK, NULL, NULL, 0);
+  AddPolicy (&mVendorA, L"Created", VARIABLE_POLICY_TYPE_LOCK_ON_CREATE, NULL, NULL, 0);
+  AddPolicy (&mVendorC, L"StateLocked", VARIABLE_POLICY_TYPE_LOCK_ON_VAR_STATE, &mVendorC, L"LockState", 1);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Probes every variable in the mocked store and checks the results against the ground truth.
+**/
+STATIC
+UNIT_TEST_STATUS
+ProbeAllVariables (
+  IN  VAR_PROBE_CONTEXT  *ProbeContext,
+  OUT UINTN              *PolicyAnswers
+  )
+{
+  UINTN             Index;
+  EFI_STATUS        Status;
+  EFI_STATUS        WriteStatus;
+  VAR_PROBE_METHOD  Method;
+
+  *PolicyAnswers = 0;
+
+  for (Index = 0; Index < ARRAY_SIZE (mVariables); Index++) {
+    Status = VarProbeWriteStatus (
+               ProbeContext,
+               mVariables[Index].Name,
+               mVariables[Index].Guid,
+               mVariables[Index].Attributes,
+               mVariables[Index].DataSize,
+               mVariables[Index].Data,
+               &WriteStatus,
+               &Method
+               );
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_STATUS_EQUAL (WriteStatus, mVariables[Index].ExpectedStatus);
+
+    // Every variable must still be in the store.
+    UT_ASSERT_TRUE (mVariables[Index].Present);
+
+    if (Method == VarProbeMethodPolicy) {
+      (*PolicyAnswers)++;
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Without the policy, every writable NV variable costs a delete and a restore.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+WriteProbeModeCountsNvWrites (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VAR_PROBE_CONTEXT  ProbeContext;
+  UINTN              PolicyAnswers;
+
+  UT_ASSERT_NOT_EFI_ERROR (VarProbeInit (&ProbeContext, NULL));
+  UT_ASSERT_EQUAL (ProbeAllVariables (&ProbeContext, &PolicyAnswers), UNIT_TEST_PASSED);
+
+  UT_LOG_INFO ("Write probe mode: %u NV writes, %u SetVariable calls\n", (UINT32)mNvWrites, (UINT32)mSetVariableCalls);
+
+  UT_ASSERT_EQUAL (PolicyAnswers, 0);
+  UT_ASSERT_EQUAL (ProbeContext.WriteProbes, ARRAY_SIZE (mVariables));
+  UT_ASSERT_EQUAL (mNvWrites, 3 * 2);    // Open, Boot0001 and Unknown.
+
+  VarProbeFree (&ProbeContext);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  With the policy, only variables the policy can't classify are write probed.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+PolicyModeAvoidsNvWrites (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VAR_PROBE_CONTEXT  ProbeContext;
+  UINTN              PolicyAnswers;
+
+  UT_ASSERT_NOT_EFI_ERROR (VarProbeInit (&ProbeContext, &mMockVariablePolicy));
+  UT_ASSERT_EQUAL (ProbeAllVariables (&ProbeContext, &PolicyAnswers), UNIT_TEST_PASSED);
+
+  UT_LOG_INFO ("Policy mode: %u NV writes, %u SetVariable calls\n", (UINT32)mNvWrites, (UINT32)mSetVariableCalls);
+
+  // LockedNow, Open, Boot0001, PlatformThing, Created and StateLocked.
+  UT_ASSERT_EQUAL (PolicyAnswers, 6);
+  UT_ASSERT_EQUAL (ProbeContext.PolicyAnswers, 6);
+
+  // LockState (volatile), Unknown (no policy) and AuthVar (authenticated).
+  UT_ASSERT_EQUAL (ProbeContext.WriteProbes, 3);
+  UT_ASSERT_EQUAL (mNvWrites, 1 * 2);    // Unknown.
+
+  VarProbeFree (&ProbeContext);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A lock on variable state is only engaged when the state variable holds the trigger value.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+LockOnVarStateFollowsStateVariable (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VAR_PROBE_CONTEXT  ProbeContext;
+  EFI_STATUS         WriteStatus;
+  VAR_PROBE_METHOD   Method;
+  MOCK_VARIABLE      *Variable;
+
+  Variable = FindMockVariable (L"StateLocked", &mVendorC);
+  UT_ASSERT_NOT_NULL (Variable);
+
+  UT_ASSERT_NOT_EFI_ERROR (VarProbeInit (&ProbeContext, &mMockVariablePolicy));
+
+  // Engaged.
+  UT_ASSERT_NOT_EFI_ERROR (VarProbeWriteStatus (&ProbeContext, Variable->Name, Variable->Guid, Variable->Attributes, Variable->DataSize, Variable->Data, &WriteStatus, &Method));
+  UT_ASSERT_EQUAL (Method, VarProbeMethodPolicy);
+  UT_ASSERT_STATUS_EQUAL (WriteStatus, EFI_WRITE_PROTECTED);
+
+  // Wrong value.
+  mVariables[LOCK_STATE_INDEX].Data[0] = 2;
+  UT_ASSERT_NOT_EFI_ERROR (VarProbeWriteStatus (&ProbeContext, Variable->Name, Variable->Guid, Variable->Attributes, Variable->DataSize, Variable->Data, &WriteStatus, &Method));
+  UT_ASSERT_EQUAL (Method, VarProbeMethodPolicy);
+  UT_ASSERT_STATUS_EQUAL (WriteStatus, EFI_SUCCESS);
+
+  // Wrong size.
+  mVariables[LOCK_STATE_INDEX].Data[0]  = 1;
+  mVariables[LOCK_STATE_INDEX].DataSize = 2;
+  UT_ASSERT_NOT_EFI_ERROR (VarProbeWriteStatus (&ProbeContext, Variable->Name, Variable->Guid, Variable->Attributes, Variable->DataSize, Variable->Data, &WriteStatus, &Method));
+  UT_ASSERT_EQUAL (Method, VarProbeMethodPolicy);
+  UT_ASSERT_STATUS_EQUAL (WriteStatus, EFI_SUCCESS);
+
+  // Missing.
+  mVariables[LOCK_STATE_INDEX].Present = FALSE;
+  UT_ASSERT_NOT_EFI_ERROR (VarProbeWriteStatus (&ProbeContext, Variable->Name, Variable->Guid, Variable->Attributes, Variable->DataSize, Variable->Data, &WriteStatus, &Method));
+  UT_ASSERT_EQUAL (Method, VarProbeMethodPolicy);
+  UT_ASSERT_STATUS_EQUAL (WriteStatus, EFI_SUCCESS);
+
+  UT_ASSERT_EQUAL (mNvWrites, 0);
+
+  VarProbeFree (&ProbeContext);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Exact names beat wildcards, which beat namespace-wide policies.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+PolicyMatchPriority (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VAR_PROBE_CONTEXT            ProbeContext;
+  CONST VARIABLE_POLICY_ENTRY  *Entry;
+
+  UT_ASSERT_NOT_EFI_ERROR (VarProbeInit (&ProbeContext, &mMockVariablePolicy));
+
+  Entry = VarProbeFindPolicy (&ProbeContext, L"Boot00Af", &mVendorB);
+  UT_ASSERT_NOT_NULL (Entry);
+  UT_ASSERT_EQUAL (Entry->LockPolicyType, VARIABLE_POLICY_TYPE_NO_LOCK);
+
+  // Not a hex digit, or the wrong length: only the namespace-wide policy applies.
+  Entry = VarProbeFindPolicy (&ProbeContext, L"Boot00G1", &mVendorB);
+  UT_ASSERT_NOT_NULL (Entry);
+  UT_ASSERT_EQUAL (Entry->LockPolicyType, VARIABLE_POLICY_TYPE_LOCK_NOW);
+  UT_ASSERT_EQUAL (Entry->Size, Entry->OffsetToName);
+
+  Entry = VarProbeFindPolicy (&ProbeContext, L"Boot00011", &mVendorB);
+  UT_ASSERT_NOT_NULL (Entry);
+  UT_ASSERT_EQUAL (Entry->Size, Entry->OffsetToName);
+
+  // Exact match, and no match at all.
+  Entry = VarProbeFindPolicy (&ProbeContext, L"Created", &mVendorA);
+  UT_ASSERT_NOT_NULL (Entry);
+  UT_ASSERT_EQUAL (Entry->LockPolicyType, VARIABLE_POLICY_TYPE_LOCK_ON_CREATE);
+
+  UT_ASSERT_TRUE (VarProbeFindPolicy (&ProbeContext, L"Create", &mVendorA) == NULL);
+  UT_ASSERT_TRUE (VarProbeFindPolicy (&ProbeContext, L"Unknown", &mVendorD) == NULL);
+
+  VarProbeFree (&ProbeContext);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A policy engine that isn't enforcing falls back to write probes.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+DisabledPolicyUsesWriteProbes (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VAR_PROBE_CONTEXT  ProbeContext;
+  UINTN              PolicyAnswers;
+
+  mPolicyEnabled = FALSE;
+
+  UT_ASSERT_NOT_EFI_ERROR (VarProbeInit (&ProbeContext, &mMockVariablePolicy));
+  UT_ASSERT_TRUE (ProbeContext.VariablePolicy == NULL);
+  UT_ASSERT_EQUAL (ProbeAllVariables (&ProbeContext, &PolicyAnswers), UNIT_TEST_PASSED);
+
+  UT_ASSERT_EQUAL (PolicyAnswers, 0);
+  UT_ASSERT_EQUAL (mNvWrites, 3 * 2);
+
+  VarProbeFree (&ProbeContext);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A malformed policy table stops matching instead of reading past the dump.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+MalformedPolicyDumpIsIgnored (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  VAR_PROBE_CONTEXT      ProbeContext;
+  VARIABLE_POLICY_ENTRY  *Entry;
+
+  // Corrupt the size of the first entry so that it runs past the end of the dump.
+  Entry       = (VARIABLE_POLICY_ENTRY *)mPolicyDump;
+  Entry->Size = (UINT16)(mPolicyDumpSize + 1);
+
+  UT_ASSERT_NOT_EFI_ERROR (VarProbeInit (&ProbeContext, &mMockVariablePolicy));
+  UT_ASSERT_TRUE (VarProbeFindPolicy (&ProbeContext, L"LockedNow", &mVendorA) == NULL);
+  UT_ASSERT_TRUE (VarProbeFindPolicy (&ProbeContext, L"Open", &mVendorA) == NULL);
+
+  VarProbeFree (&ProbeContext);
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  variable write probe and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      ProbeSuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&ProbeSuiteHandle, Framework, "UefiVarLockAudit variable probe tests", "UefiVarLockAudit.Probe", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for ProbeSuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (ProbeSuiteHandle, "Write probe mode NV write count", "WriteProbeMode", WriteProbeModeCountsNvWrites, SetupMocks, NULL, NULL);
+  AddTestCase (ProbeSuiteHandle, "Policy mode NV write count", "PolicyMode", PolicyModeAvoidsNvWrites, SetupMocks, NULL, NULL);
+  AddTestCase (ProbeSuiteHandle, "Lock on variable state", "LockOnVarState", LockOnVarStateFollowsStateVariable, SetupMocks, NULL, NULL);
+  AddTestCase (ProbeSuiteHandle, "Policy match priority", "MatchPriority", PolicyMatchPriority, SetupMocks, NULL, NULL);
+  AddTestCase (ProbeSuiteHandle, "Disabled policy uses write probes", "PolicyDisabled", DisabledPolicyUsesWriteProbes, SetupMocks, NULL, NULL);
+  AddTestCase (ProbeSuiteHandle, "Malformed policy dump is ignored", "MalformedDump", MalformedPolicyDumpIsIgnored, SetupMocks, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
@@ -0,0 +1,432 @@
+/** @file
+  Determines whether a variable can be written at the time the audit runs.
+
+  Deleting and restoring each variable costs two NV writes for every writable variable.
+  On SPI flash that wears the part and can trigger a variable store reclaim, so the
+  Variable Policy table is consulted first and the write probe is only used for
+  variables the policy can't classify.
+
+Copyright (C) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+  **/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UefiRuntimeServicesTableLib.h>
+
+#include "VarPolicyProbe.h"
+
+#define MATCH_PRIORITY_EXACT  0
+#define MATCH_PRIORITY_MIN    MAX_UINT8
+#define WILDCARD_CHARACTER    L'#'
+
+//
+// Attributes that make SetVariable run checks the policy engine doesn't know about.
+//
+#define AUTHENTICATED_WRITE_ATTRIBUTES  (EFI_VARIABLE_AUTHENTICATED_WRITE_ACCESS | \
+                                         EFI_VARIABLE_TIME_BASED_AUTHENTICATED_WRITE_ACCESS)
+
+/**
+  Initializes a probe context.
+
+  If VariablePolicy is provided and enforcement is enabled, the policy table is dumped
+  once and cached in the context.  Otherwise the context falls back to write probes.
+
+  @param[out] Context         Context to initialize.
+  @param[in]  VariablePolicy  Variable Policy protocol, or NULL to always use write probes.
+
+  @retval EFI_SUCCESS           The context was initialized.
+  @retval EFI_INVALID_PARAMETER Context is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+VarProbeInit (
+  OUT VAR_PROBE_CONTEXT               *Context,
+  IN  EDKII_VARIABLE_POLICY_PROTOCOL  *VariablePolicy OPTIONAL
+  )
+{
+  EFI_STATUS  Status;
+  BOOLEAN     Enabled;
+  UINT32      Size;
+
+  if (Context == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ZeroMem (Context, sizeof (VAR_PROBE_CONTEXT));
+
+  if (VariablePolicy == NULL) {
+    return EFI_SUCCESS;
+  }
+
+  // If the engine isn't enforcing, the policy table says nothing about write protection.
+  Enabled = FALSE;
+  Status  = VariablePolicy->IsVariablePolicyEnabled (&Enabled);
+  if (EFI_ERROR (Status) || !Enabled) {
+    DEBUG ((DEBUG_WARN, "%a - Variable Policy not enforced (%r).  Using write probes.\n", __FUNCTION__, Status));
+    return EFI_SUCCESS;
+  }
+
+  Size   = 0;
+  Status = VariablePolicy->DumpVariablePolicy (NULL, &Size);
+  if (Status == EFI_BUFFER_TOO_SMALL) {
+    Context->PolicyDump = AllocatePool (Size);
+    if (Context->PolicyDump == NULL) {
+      DEBUG ((DEBUG_ERROR, "%a - Failed to allocate 0x%x bytes for the policy dump.\n", __FUNCTION__, Size));
+      return EFI_SUCCESS;
+    }
+
+    Status = VariablePolicy->DumpVariablePolicy (Context->PolicyDump, &Size);
+  }
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_WARN, "%a - DumpVariablePolicy failed (%r).  Using write probes.\n", __FUNCTION__, Status));
+    VarProbeFree (Context);
+    return EFI_SUCCESS;
+  }
+
+  Context->VariablePolicy = VariablePolicy;
+  Context->PolicyDumpSize = Size;
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Frees the resources held by a probe context.
+
+  @param[in] Context  Context to free.
+
+**/
+VOID
+EFIAPI
+VarProbeFree (
+  IN VAR_PROBE_CONTEXT  *Context
+  )
+{
+  if (Context->PolicyDump != NULL) {
+    FreePool (Context->PolicyDump);
+  }
+
+  Context->PolicyDump     = NULL;
+  Context->PolicyDumpSize = 0;
+  Context->VariablePolicy = NULL;
+}
+
+/**
+  Evaluates whether a policy entry applies to a variable and, if so, how specific the match is.
+
+  @param[in]  Entry         Policy entry.
+  @param[in]  VariableName  Name of the variable.
+  @param[in]  VendorGuid    Namespace of the variable.
+  @param[out] Priority      Match priority (MATCH_PRIORITY_EXACT is the most specific).
+
+  @retval TRUE   The policy applies to the variable.
+  @retval FALSE  The policy doesn't apply to the variable.
+
+**/
+STATIC
+BOOLEAN
+EvaluatePolicyMatch (
+  IN  CONST VARIABLE_POLICY_ENTRY  *Entry,
+  IN  CONST CHAR16                 *VariableName,
+  IN  CONST EFI_GUID               *VendorGuid,
+  OUT UINT8                        *Priority
+  )
+{
+  CONST CHAR16  *PolicyName;
+  UINTN         Index;
+
+  if (!CompareGuid (&Entry->Namespace, VendorGuid)) {
+    return FALSE;
+  }
+
+  // A policy without a name applies to the whole namespace.
+  if (Entry->Size == Entry->OffsetToName) {
+    *Priority = MATCH_PRIORITY_MIN;
+    return TRUE;
+  }
+
+  PolicyName = (CONST CHAR16 *)((CONST UINT8 *)Entry + Entry->OffsetToName);
+  *Priority  = MATCH_PRIORITY_EXACT;
+
+  for (Index = 0; PolicyName[Index] != CHAR_NULL; Index++) {
+    if (PolicyName[Index] == VariableName[Index]) {
+      continue;
+    }
+
+    // A wildcard matches any hex digit.
+    if ((PolicyName[Index] != WILDCARD_CHARACTER) ||
+        !(((VariableName[Index] >= L'0') && (VariableName[Index] <= L'9')) ||
+          ((VariableName[Index] >= L'A') && (VariableName[Index] <= L'F')) ||
+          ((VariableName[Index] >= L'a') && (VariableName[Index] <= L'f'))))
+    {
+      return FALSE;
+    }
+
+    if (*Priority < (MATCH_PRIORITY_MIN - 1)) {
+      (*Priority)++;
+    }
+  }
+
+  return (BOOLEAN)(VariableName[Index] == CHAR_NULL);
+}
+
+/**
+  Finds the policy entry that the Variable Policy engine would apply to a variable.
+
+  Matching follows the engine: an exact name match wins over a name with '#' wildcards
+  (fewer wildcards win), which wins over a namespace-wide policy.
+
+  @param[in] Context       Probe context holding the policy dump.
+  @param[in] VariableName  Name of the variable.
+  @param[in] VendorGuid    Namespace of the variable.
+
+  @retval NULL   No policy applies to the variable.
+  @retval Other  The best matching policy entry (points into the policy dump).
+
+**/
+CONST VARIABLE_POLICY_ENTRY *
+EFIAPI
+VarProbeFindPolicy (
+  IN CONST VAR_PROBE_CONTEXT  *Context,
+  IN CONST CHAR16             *VariableName,
+  IN CONST EFI_GUID           *VendorGuid
+  )
+{
+  CONST VARIABLE_POLICY_ENTRY  *Entry;
+  CONST VARIABLE_POLICY_ENTRY  *Best;
+  UINT8                        BestPriority;
+  UINT8                        Priority;
+  UINT32                       Offset;
+
+  Best         = NULL;
+  BestPriority = MATCH_PRIORITY_MIN;
+
+  if ((Context == NULL) || (Context->PolicyDump == NULL)) {
+    return NULL;
+  }
+
+  for (Offset = 0; (Offset + sizeof (VARIABLE_POLICY_ENTRY)) <= Context->PolicyDumpSize; Offset += Entry->Size) {
+    Entry = (CONST VARIABLE_POLICY_ENTRY *)(Context->PolicyDump + Offset);
+
+    // Stop at anything that doesn't look like a well formed entry.
+    if ((Entry->Size < sizeof (VARIABLE_POLICY_ENTRY)) ||
+        ((Offset + Entry->Size) > Context->PolicyDumpSize) ||
+        (Entry->OffsetToName < sizeof (VARIABLE_POLICY_ENTRY)) ||
+        (Entry->OffsetToName > Entry->Size))
+    {
+      DEBUG ((DEBUG_ERROR, "%a - Malformed policy entry at offset 0x%x.\n", __FUNCTION__, Offset));
+      break;
+    }
+
+    if (EvaluatePolicyMatch (Entry, VariableName, VendorGuid, &Priority)) {
+      if ((Best == NULL) || (Priority < BestPriority)) {
+        Best         = Entry;
+        BestPriority = Priority;
+      }
+
+      if (BestPriority == MATCH_PRIORITY_EXACT) {
+        break;
+      }
+    }
+  }
+
+  return Best;
+}
+
+/**
+  Classifies a variable using its policy.
+
+  @param[in]  Entry        Policy that applies to the variable.
+  @param[out] Locked       TRUE if the policy engine will reject writes to the variable.
+
+  @retval TRUE   The lock state was determined.
+  @retval FALSE  The lock state could not be determined from the policy.
+
+**/
+STATIC
+BOOLEAN
+IsLockedByPolicy (
+  IN  CONST VARIABLE_POLICY_ENTRY  *Entry,
+  OUT BOOLEAN                      *Locked
+  )
+{
+  CONST VARIABLE_LOCK_ON_VAR_STATE_POLICY  *StatePolicy;
+  CHAR16                                   *StateVarName;
+  UINT8                                    StateVar;
+  UINTN                                    StateVarSize;
+  EFI_STATUS                               Status;
+
+  switch (Entry->LockPolicyType) {
+    case VARIABLE_POLICY_TYPE_NO_LOCK:
+      *Locked = FALSE;
+      return TRUE;
+
+    case VARIABLE_POLICY_TYPE_LOCK_NOW:
+      *Locked = TRUE;
+      return TRUE;
+
+    case VARIABLE_POLICY_TYPE_LOCK_ON_CREATE:
+      // The variable under audit exists, so the policy is engaged.
+      *Locked = TRUE;
+      return TRUE;
+
+    case VARIABLE_POLICY_TYPE_LOCK_ON_VAR_STATE:
+      if ((sizeof (VARIABLE_POLICY_ENTRY) + sizeof (VARIABLE_LOCK_ON_VAR_STATE_POLICY) + sizeof (CHAR16)) > Entry->OffsetToName) {
+        return FALSE;
+      }
+
+      StatePolicy  = (CONST VARIABLE_LOCK_ON_VAR_STATE_POLICY *)(Entry + 1);
+      StateVarName = (CHAR16 *)(StatePolicy + 1);
+      StateVarSize = sizeof (StateVar);
+      Status       = gRT->GetVariable (StateVarName, (EFI_GUID *)&StatePolicy->Namespace, NULL, &StateVarSize, &StateVar);
+
+      // Same evaluation as the policy engine: the lock is engaged only if the state variable
+      // exists, is exactly one byte and holds the trigger value.
+      if (!EFI_ERROR (Status)) {
+        *Locked = (BOOLEAN)((StateVarSize == sizeof (StateVar)) && (StateVar == StatePolicy->Value));
+        return TRUE;
+      }
+
+      if ((Status == EFI_NOT_FOUND) || (Status == EFI_BUFFER_TOO_SMALL)) {
+        *Locked = FALSE;
+        return TRUE;
+      }
+
+      return FALSE;
+
+    default:
+      return FALSE;
+  }
+}
+
+/**
+  Deletes the variable and restores it if the delete succeeded.
+
+  @param[in]  VariableName  Name of the variable.
+  @param[in]  VendorGuid    Namespace of the variable.
+  @param[in]  Attributes    Current attributes of the variable.
+  @param[in]  DataSize      Size of the current variable data.
+  @param[in]  Data          Current variable data.
+  @param[out] WriteStatus   Status returned by the delete.
+
+  @retval EFI_SUCCESS  The variable is in its original state.
+  @retval Others       The variable was deleted but could not be restored.
+
+**/
+STATIC
+EFI_STATUS
+WriteProbe (
+  IN  CHAR16      *VariableName,
+  IN  EFI_GUID    *VendorGuid,
+  IN  UINT32      Attributes,
+  IN  UINTN       DataSize,
+  IN  VOID        *Data,
+  OUT EFI_STATUS  *WriteStatus
+  )
+{
+  EFI_STATUS  Status;
+
+  // Delete current var
+  *WriteStatus = gRT->SetVariable (VariableName, VendorGuid, Attributes, 0, NULL);
+
+  // restore if needed
+  if (!EFI_ERROR (*WriteStatus)) {
+    Status = gRT->SetVariable (VariableName, VendorGuid, Attributes, DataSize, Data);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR, "%a failed to restore variable data.  Status = %r\n", __FUNCTION__, Status));
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Determines the status SetVariable would return when deleting the variable.
+
+  The Variable Policy engine is consulted first.  If it can't classify the variable, the
+  variable is deleted and, if that succeeded, restored with its original data and attributes.
+
+  @param[in]  Context       Probe context.
+  @param[in]  VariableName  Name of the variable.
+  @param[in]  VendorGuid    Namespace of the variable.
+  @param[in]  Attributes    Current attributes of the variable.
+  @param[in]  DataSize      Size of the current variable data.
+  @param[in]  Data          Current variable data (used to restore the variable).
+  @param[out] WriteStatus   Status of the (real or predicted) delete.
+  @param[out] Method        How WriteStatus was obtained.
+
+  @retval EFI_SUCCESS           WriteStatus and Method are valid.
+  @retval EFI_INVALID_PARAMETER A required parameter is NULL.
+  @retval Others                The variable was deleted but could not be restored.
+
+**/
+EFI_STATUS
+EFIAPI
+VarProbeWriteStatus (
+  IN  VAR_PROBE_CONTEXT  *Context,
+  IN  CHAR16             *VariableName,
+  IN  EFI_GUID           *VendorGuid,
+  IN  UINT32             Attributes,
+  IN  UINTN              DataSize,
+  IN  VOID               *Data,
+  OUT EFI_STATUS         *WriteStatus,
+  OUT VAR_PROBE_METHOD   *Method
+  )
+{
+  CONST VARIABLE_POLICY_ENTRY  *Entry;
+  BOOLEAN                      Locked;
+
+  if ((Context == NULL) || (VariableName == NULL) || (VendorGuid == NULL) || (WriteStatus == NULL) || (Method == NULL)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  //
+  // Only classify NV variables without authenticated write access from the policy.  Probing
+  // a volatile variable doesn't touch flash, and authenticated variables are subject to
+  // signature checks the policy table doesn't describe.
+  //
+  if (((Attributes & EFI_VARIABLE_NON_VOLATILE) != 0) &&
+      ((Attributes & AUTHENTICATED_WRITE_ATTRIBUTES) == 0))
+  {
+    Entry = VarProbeFindPolicy (Context, VariableName, VendorGuid);
+    if ((Entry != NULL) && IsLockedByPolicy (Entry, &Locked)) {
+      *WriteStatus = Locked ? EFI_WRITE_PROTECTED : EFI_SUCCESS;
+      *Method      = VarProbeMethodPolicy;
+      Context->PolicyAnswers++;
+      return EFI_SUCCESS;
+    }
+  }
+
+  *Method = VarProbeMethodWriteProbe;
+  Context->WriteProbes++;
+
+  return WriteProbe (VariableName, VendorGuid, Attributes, DataSize, Data, WriteStatus);
+}
+
+/**
+  Returns the string recorded in the XML for a probe method.
+
+  @param[in] Method  Probe method.
+
+  @retval Ascii string naming the method.
+
+**/
+CONST CHAR8 *
+EFIAPI
+VarProbeMethodToString (
+  IN VAR_PROBE_METHOD  Method
+  )
+{
+  if (Method == VarProbeMethodPolicy) {
+    return VAR_PROBE_METHOD_POLICY_STRING;
+  }
+
+  return VAR_PROBE_METHOD_WRITE_PROBE_STRING;
+}
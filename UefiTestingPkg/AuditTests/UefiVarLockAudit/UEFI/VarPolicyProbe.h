@@ -0,0 +1,137 @@
+/** @file
+  Determines whether a variable can be written at the time the audit runs.
+
+  The answer is derived from the Variable Policy engine when possible so that the audit
+  doesn't have to delete and rewrite every variable.  Variables the policy can't classify
+  fall back to a real write probe.
+
+  Copyright (C) Microsoft Corporation. All rights reserved.
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+  **/
+
+#ifndef VAR_POLICY_PROBE_H
+#define VAR_POLICY_PROBE_H
+
+#include <Uefi.h>
+#include <Protocol/VariablePolicy.h>
+
+#define VAR_PROBE_METHOD_WRITE_PROBE_STRING  "WriteProbe"
+#define VAR_PROBE_METHOD_POLICY_STRING       "VariablePolicy"
+
+typedef enum {
+  VarProbeMethodWriteProbe,         // The variable was deleted and restored.
+  VarProbeMethodPolicy              // The answer was derived from the Variable Policy engine.
+} VAR_PROBE_METHOD;
+
+typedef struct {
+  EDKII_VARIABLE_POLICY_PROTOCOL    *VariablePolicy;  // NULL if only write probes are used.
+  UINT8                             *PolicyDump;      // Buffer returned by DumpVariablePolicy.
+  UINT32                            PolicyDumpSize;   // Size of PolicyDump in bytes.
+  UINTN                             PolicyAnswers;    // Number of answers derived from the policy.
+  UINTN                             WriteProbes;      // Number of write probes performed.
+} VAR_PROBE_CONTEXT;
+
+/**
+  Initializes a probe context.
+
+  If VariablePolicy is provided and enforcement is enabled, the policy table is dumped
+  once and cached in the context.  Otherwise the context falls back to write probes.
+
+  @param[out] Context         Context to initialize.
+  @param[in]  VariablePolicy  Variable Policy protocol, or NULL to always use write probes.
+
+  @retval EFI_SUCCESS           The context was initialized.
+  @retval EFI_INVALID_PARAMETER Context is NULL.
+
+**/
+EFI_STATUS
+EFIAPI
+VarProbeInit (
+  OUT VAR_PROBE_CONTEXT               *Context,
+  IN  EDKII_VARIABLE_POLICY_PROTOCOL  *VariablePolicy OPTIONAL
+  );
+
+/**
+  Frees the resources held by a probe context.
+
+  @param[in] Context  Context to free.
+
+**/
+VOID
+EFIAPI
+VarProbeFree (
+  IN VAR_PROBE_CONTEXT  *Context
+  );
+
+/**
+  Finds the policy entry that the Variable Policy engine would apply to a variable.
+
+  Matching follows the engine: an exact name match wins over a name with '#' wildcards
+  (fewer wildcards win), which wins over a namespace-wide policy.
+
+  @param[in] Context       Probe context holding the policy dump.
+  @param[in] VariableName  Name of the variable.
+  @param[in] VendorGuid    Namespace of the variable.
+
+  @retval NULL   No policy applies to the variable.
+  @retval Other  The best matching policy entry (points into the policy dump).
+
+**/
+CONST VARIABLE_POLICY_ENTRY *
+EFIAPI
+VarProbeFindPolicy (
+  IN CONST VAR_PROBE_CONTEXT  *Context,
+  IN CONST CHAR16             *VariableName,
+  IN CONST EFI_GUID           *VendorGuid
+  );
+
+/**
+  Determines the status SetVariable would return when deleting the variable.
+
+  The Variable Policy engine is consulted first.  If it can't classify the variable, the
+  variable is deleted and, if that succeeded, restored with its original data and attributes.
+
+  @param[in]  Context       Probe context.
+  @param[in]  VariableName  Name of the variable.
+  @param[in]  VendorGuid    Namespace of the variable.
+  @param[in]  Attributes    Current attributes of the variable.
+  @param[in]  DataSize      Size of the current variable data.
+  @param[in]  Data          Current variable data (used to restore the variable).
+  @param[out] WriteStatus   Status of the (real or predicted) delete.
+  @param[out] Method        How WriteStatus was obtained.
+
+  @retval EFI_SUCCESS           WriteStatus and Method are valid.
+  @retval EFI_INVALID_PARAMETER A required parameter is NULL.
+  @retval Others                The variable was deleted but could not be restored.
+
+**/
+EFI_STATUS
+EFIAPI
+VarProbeWriteStatus (
+  IN  VAR_PROBE_CONTEXT  *Context,
+  IN  CHAR16             *VariableName,
+  IN  EFI_GUID           *VendorGuid,
+  IN  UINT32             Attributes,
+  IN  UINTN              DataSize,
+  IN  VOID               *Data,
+  OUT EFI_STATUS         *WriteStatus,
+  OUT VAR_PROBE_METHOD   *Method
+  );
+
+/**
+  Returns the string recorded in the XML for a probe method.
+
+  @param[in] Method  Probe method.
+
+  @retval Ascii string naming the method.
+
+**/
+CONST CHAR8 *
+EFIAPI
+VarProbeMethodToString (
+  IN VAR_PROBE_METHOD  Method
+  );
+
+#endif
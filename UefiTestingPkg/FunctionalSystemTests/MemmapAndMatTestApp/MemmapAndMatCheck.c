@@ -0,0 +1,668 @@
+/** @file -- MemmapAndMatCheck.c
+Sorted views of the MemoryMap and the UEFI Memory Attributes Table, and the range checks
+that sweep over them.
+
+Copyright (C) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+
+#include "MemmapAndMatCheck.h"
+
+typedef
+INTN
+(*SORTED_ENTRY_COMPARE)(
+  IN CONST MEM_MAP_SORTED_ENTRY  *Left,
+  IN CONST MEM_MAP_SORTED_ENTRY  *Right
+  );
+
+/**
+  Returns the descriptor at a given position in a map.
+
+  @param[in] Meta   Map to index.
+  @param[in] Index  Position of the descriptor.
+
+  @retval The descriptor.
+**/
+EFI_MEMORY_DESCRIPTOR *
+MemMapGetDescriptor (
+  IN MEM_MAP_META  *Meta,
+  IN UINTN         Index
+  )
+{
+  return (EFI_MEMORY_DESCRIPTOR *)((UINT8 *)Meta->Map + (Index * Meta->EntrySize));
+}
+
+/**
+  Fills in a sorted entry from a map descriptor.
+
+  @param[in]  Meta   Map that holds the descriptor.
+  @param[in]  Index  Position of the descriptor.
+  @param[out] Entry  Entry to fill in.
+**/
+STATIC
+VOID
+LoadSortedEntry (
+  IN  MEM_MAP_META          *Meta,
+  IN  UINTN                 Index,
+  OUT MEM_MAP_SORTED_ENTRY  *Entry
+  )
+{
+  EFI_MEMORY_DESCRIPTOR  *Descriptor;
+
+  Descriptor   = MemMapGetDescriptor (Meta, Index);
+  Entry->Type  = Descriptor->Type;
+  Entry->Start = Descriptor->PhysicalStart;
+  Entry->End   = Descriptor->PhysicalStart + EFI_PAGES_TO_SIZE (Descriptor->NumberOfPages) - 1;
+  Entry->Index = Index;
+}
+
+/**
+  Orders entries by Start.  Ties keep map order.
+**/
+STATIC
+INTN
+CompareByStart (
+  IN CONST MEM_MAP_SORTED_ENTRY  *Left,
+  IN CONST MEM_MAP_SORTED_ENTRY  *Right
+  )
+{
+  if (Left->Start != Right->Start) {
+    return (Left->Start < Right->Start) ? -1 : 1;
+  }
+
+  return (Left->Index < Right->Index) ? -1 : (Left->Index > Right->Index) ? 1 : 0;
+}
+
+/**
+  Orders entries by Type, then by Start.  Ties keep map order.
+**/
+STATIC
+INTN
+CompareByTypeAndStart (
+  IN CONST MEM_MAP_SORTED_ENTRY  *Left,
+  IN CONST MEM_MAP_SORTED_ENTRY  *Right
+  )
+{
+  if (Left->Type != Right->Type) {
+    return (Left->Type < Right->Type) ? -1 : 1;
+  }
+
+  return CompareByStart (Left, Right);
+}
+
+/**
+  Sorts entries with a bottom-up merge sort.
+
+  SortLib is not used because its quick sort degrades to quadratic time on input that is
+  already in order, which is exactly what a well-formed MAT is.
+
+  @param[in,out] Entries  Entries to sort.
+  @param[in]     Scratch  Buffer of the same size as Entries.
+  @param[in]     Count    Number of entries.
+  @param[in]     Compare  Ordering of the entries.
+**/
+STATIC
+VOID
+SortEntries (
+  IN OUT MEM_MAP_SORTED_ENTRY  *Entries,
+  IN     MEM_MAP_SORTED_ENTRY  *Scratch,
+  IN     UINTN                 Count,
+  IN     SORTED_ENTRY_COMPARE  Compare
+  )
+{
+  MEM_MAP_SORTED_ENTRY  *Source;
+  MEM_MAP_SORTED_ENTRY  *Target;
+  MEM_MAP_SORTED_ENTRY  *Swap;
+  UINTN                 Width;
+  UINTN                 Low;
+  UINTN                 Middle;
+  UINTN                 High;
+  UINTN                 Left;
+  UINTN                 Right;
+  UINTN                 Out;
+
+  Source = Entries;
+  Target = Scratch;
+
+  for (Width = 1; Width < Count; Width *= 2) {
+    for (Low = 0; Low < Count; Low += 2 * Width) {
+      Middle = MIN (Low + Width, Count);
+      High   = MIN (Low + 2 * Width, Count);
+      Left   = Low;
+      Right  = Middle;
+
+      for (Out = Low; Out < High; Out++) {
+        if ((Left < Middle) && ((Right >= High) || (Compare (&Source[Left], &Source[Right]) <= 0))) {
+          Target[Out] = Source[Left++];
+        } else {
+          Target[Out] = Source[Right++];
+        }
+      }
+    }
+
+    Swap   = Source;
+    Source = Target;
+    Target = Swap;
+  }
+
+  if (Source != Entries) {
+    CopyMem (Entries, Source, Count * sizeof (MEM_MAP_SORTED_ENTRY));
+  }
+}
+
+/**
+  Counts the entries of a Type-then-Start ordered array that sort at or before a given key.
+
+  @param[in] Entries  Entries ordered by Type, then by Start.
+  @param[in] Count    Number of entries.
+  @param[in] Type     Type of the key.
+  @param[in] Start    Start of the key.
+
+  @retval Number of leading entries at or before the key.  The last of them is the entry of the
+          same Type with the highest Start not above the key, if there is one.
+**/
+STATIC
+UINTN
+CountAtOrBefore (
+  IN CONST MEM_MAP_SORTED_ENTRY  *Entries,
+  IN UINTN                       Count,
+  IN UINT32                      Type,
+  IN EFI_PHYSICAL_ADDRESS        Start
+  )
+{
+  UINTN  Low;
+  UINTN  High;
+  UINTN  Middle;
+
+  Low  = 0;
+  High = Count;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    if ((Entries[Middle].Type < Type) ||
+        ((Entries[Middle].Type == Type) && (Entries[Middle].Start <= Start)))
+    {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  return Low;
+}
+
+/**
+  Merges the Type-then-Start ordered entries into contiguous stretches of the same type.
+
+  Two entries join the same stretch under the same rule the coverage check has always used
+  to advance its high water mark: the next entry must start exactly at the mark, or straddle it.
+
+  @param[in,out] Index  Index whose ByTypeAndStart view is built.
+**/
+STATIC
+VOID
+BuildRuns (
+  IN OUT MEM_MAP_INDEX  *Index
+  )
+{
+  UINTN                 Position;
+  MEM_MAP_SORTED_ENTRY  *Entry;
+  MEM_MAP_SORTED_ENTRY  *Run;
+  EFI_PHYSICAL_ADDRESS  Next;
+
+  Index->RunCount = 0;
+  for (Position = 0; Position < Index->Count; Position++) {
+    Entry = &Index->ByTypeAndStart[Position];
+
+    if ((Index->RunCount > 0) && (Index->Runs[Index->RunCount - 1].Type == Entry->Type)) {
+      Run  = &Index->Runs[Index->RunCount - 1];
+      Next = Run->End + 1;
+
+      if ((Entry->Start == Next) || A_IS_BETWEEN_B_AND_C (Next, Entry->Start, Entry->End)) {
+        Run->End = MAX (Run->End, Entry->End);
+        continue;
+      }
+
+      // Entirely inside the current stretch.
+      if ((Entry->Start < Next) || (Run->End == MAX_UINT64)) {
+        continue;
+      }
+    }
+
+    Index->Runs[Index->RunCount++] = *Entry;
+  }
+}
+
+/**
+  Builds the sorted views of a map.
+
+  @param[in]  Meta   Map to index.  Must stay valid for the lifetime of the index.
+  @param[out] Index  Index to build.  Release it with MemMapIndexFree.
+
+  @retval EFI_SUCCESS            The index was built.
+  @retval EFI_INVALID_PARAMETER  A parameter is NULL, or the map has entries but no entry size.
+  @retval EFI_OUT_OF_RESOURCES   The sorted views could not be allocated.
+**/
+EFI_STATUS
+MemMapIndexBuild (
+  IN  MEM_MAP_META   *Meta,
+  OUT MEM_MAP_INDEX  *Index
+  )
+{
+  MEM_MAP_SORTED_ENTRY  *Scratch;
+  UINTN                 Position;
+  UINTN                 Best;
+
+  if ((Meta == NULL) || (Index == NULL) ||
+      ((Meta->EntryCount > 0) && ((Meta->Map == NULL) || (Meta->EntrySize == 0))))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ZeroMem (Index, sizeof (MEM_MAP_INDEX));
+  Index->Meta  = Meta;
+  Index->Count = Meta->EntryCount;
+  if (Index->Count == 0) {
+    return EFI_SUCCESS;
+  }
+
+  Index->ByStart        = AllocatePool (Index->Count * sizeof (MEM_MAP_SORTED_ENTRY));
+  Index->ByTypeAndStart = AllocatePool (Index->Count * sizeof (MEM_MAP_SORTED_ENTRY));
+  Index->Runs           = AllocatePool (Index->Count * sizeof (MEM_MAP_SORTED_ENTRY));
+  Index->MaxEndPos      = AllocatePool (Index->Count * sizeof (UINTN));
+  Index->Heap           = AllocatePool (Index->Count * sizeof (UINTN));
+  Scratch               = AllocatePool (Index->Count * sizeof (MEM_MAP_SORTED_ENTRY));
+  if ((Index->ByStart == NULL) || (Index->ByTypeAndStart == NULL) || (Index->Runs == NULL) ||
+      (Index->MaxEndPos == NULL) || (Index->Heap == NULL) || (Scratch == NULL))
+  {
+    if (Scratch != NULL) {
+      FreePool (Scratch);
+    }
+
+    MemMapIndexFree (Index);
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for (Position = 0; Position < Index->Count; Position++) {
+    LoadSortedEntry (Meta, Position, &Index->ByStart[Position]);
+  }
+
+  CopyMem (Index->ByTypeAndStart, Index->ByStart, Index->Count * sizeof (MEM_MAP_SORTED_ENTRY));
+  SortEntries (Index->ByStart, Scratch, Index->Count, CompareByStart);
+  SortEntries (Index->ByTypeAndStart, Scratch, Index->Count, CompareByTypeAndStart);
+  FreePool (Scratch);
+
+  //
+  // Running maximum of End within each type, used to find the widest candidate container.
+  //
+  Best = 0;
+  for (Position = 0; Position < Index->Count; Position++) {
+    if ((Position == 0) ||
+        (Index->ByTypeAndStart[Position].Type != Index->ByTypeAndStart[Position - 1].Type) ||
+        (Index->ByTypeAndStart[Position].End > Index->ByTypeAndStart[Best].End))
+    {
+      Best = Position;
+    }
+
+    Index->MaxEndPos[Position] = Best;
+  }
+
+  BuildRuns (Index);
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Releases the sorted views of a map.
+
+  @param[in,out] Index  Index to release.
+**/
+VOID
+MemMapIndexFree (
+  IN OUT MEM_MAP_INDEX  *Index
+  )
+{
+  if (Index == NULL) {
+    return;
+  }
+
+  if (Index->ByStart != NULL) {
+    FreePool (Index->ByStart);
+  }
+
+  if (Index->ByTypeAndStart != NULL) {
+    FreePool (Index->ByTypeAndStart);
+  }
+
+  if (Index->Runs != NULL) {
+    FreePool (Index->Runs);
+  }
+
+  if (Index->MaxEndPos != NULL) {
+    FreePool (Index->MaxEndPos);
+  }
+
+  if (Index->Heap != NULL) {
+    FreePool (Index->Heap);
+  }
+
+  ZeroMem (Index, sizeof (MEM_MAP_INDEX));
+}
+
+/**
+  Looks for two entries in the same map where one starts strictly inside the other.
+
+  The entries are swept in order of Start while tracking the highest End among the entries
+  that start strictly lower.  An entry starts inside an earlier one exactly when that End
+  lies above its Start.
+
+  @param[in]  Index       Map to check.
+  @param[out] LeftIndex   Map position of the first entry of the offending pair.
+  @param[out] RightIndex  Map position of the second entry of the offending pair.
+
+  @retval TRUE   An overlap was found.
+  @retval FALSE  No entries overlap.
+**/
+BOOLEAN
+MemMapFindOverlap (
+  IN  MEM_MAP_INDEX  *Index,
+  OUT UINTN          *LeftIndex,
+  OUT UINTN          *RightIndex
+  )
+{
+  MEM_MAP_SORTED_ENTRY  *Entries;
+  UINTN                 GroupStart;
+  UINTN                 Position;
+  UINTN                 Widest;
+  BOOLEAN               HaveWidest;
+
+  Entries    = Index->ByStart;
+  Widest     = 0;
+  HaveWidest = FALSE;
+
+  for (GroupStart = 0; GroupStart < Index->Count; GroupStart = Position) {
+    //
+    // Entries with the same Start never overlap under this rule, so compare the whole group
+    // against the entries before it and only then fold it into the running maximum.
+    //
+    for (Position = GroupStart; (Position < Index->Count) && (Entries[Position].Start == Entries[GroupStart].Start); Position++) {
+      if (HaveWidest && (Entries[Widest].End > Entries[Position].Start)) {
+        *LeftIndex  = MIN (Entries[Widest].Index, Entries[Position].Index);
+        *RightIndex = MAX (Entries[Widest].Index, Entries[Position].Index);
+        return TRUE;
+      }
+    }
+
+    for (Position = GroupStart; (Position < Index->Count) && (Entries[Position].Start == Entries[GroupStart].Start); Position++) {
+      if (!HaveWidest || (Entries[Position].End > Entries[Widest].End)) {
+        Widest     = Position;
+        HaveWidest = TRUE;
+      }
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Adds a position to a min-heap of entries keyed by End.
+**/
+STATIC
+VOID
+HeapPush (
+  IN     CONST MEM_MAP_SORTED_ENTRY  *Entries,
+  IN OUT UINTN                       *Heap,
+  IN OUT UINTN                       *HeapCount,
+  IN     UINTN                       Position
+  )
+{
+  UINTN  Child;
+  UINTN  Parent;
+
+  Child = (*HeapCount)++;
+  while (Child > 0) {
+    Parent = (Child - 1) / 2;
+    if (Entries[Heap[Parent]].End <= Entries[Position].End) {
+      break;
+    }
+
+    Heap[Child] = Heap[Parent];
+    Child       = Parent;
+  }
+
+  Heap[Child] = Position;
+}
+
+/**
+  Removes the entry with the lowest End from a min-heap.
+**/
+STATIC
+VOID
+HeapPop (
+  IN     CONST MEM_MAP_SORTED_ENTRY  *Entries,
+  IN OUT UINTN                       *Heap,
+  IN OUT UINTN                       *HeapCount
+  )
+{
+  UINTN  Last;
+  UINTN  Parent;
+  UINTN  Child;
+
+  Last   = Heap[--(*HeapCount)];
+  Parent = 0;
+  for (Child = 1; Child < *HeapCount; Child = 2 * Parent + 1) {
+    if ((Child + 1 < *HeapCount) && (Entries[Heap[Child + 1]].End < Entries[Heap[Child]].End)) {
+      Child++;
+    }
+
+    if (Entries[Last].End <= Entries[Heap[Child]].End) {
+      break;
+    }
+
+    Heap[Parent] = Heap[Child];
+    Parent       = Child;
+  }
+
+  if (*HeapCount > 0) {
+    Heap[Parent] = Last;
+  }
+}
+
+/**
+  Looks for an Inner entry that starts strictly inside an Outer entry and ends strictly past it.
+
+  Inner entries are swept in order of Start.  Every Outer entry that starts strictly lower is
+  pushed onto a min-heap keyed by End, and entries that end at or below the current Start are
+  popped for good, since later Inner entries start no lower.  What remains on top is the Outer
+  entry with the lowest End above the Start, which is the one to test against the Inner End.
+
+  @param[in]  Outer          Map whose entry is straddled.
+  @param[in]  Inner          Map whose entry straddles.
+  @param[out] OuterPosition  Map position of the offending Outer entry.
+  @param[out] InnerPosition  Map position of the offending Inner entry.
+
+  @retval TRUE   A straddling entry was found.
+  @retval FALSE  No Inner entry straddles the end of an Outer entry.
+**/
+STATIC
+BOOLEAN
+FindStraddle (
+  IN  MEM_MAP_INDEX  *Outer,
+  IN  MEM_MAP_INDEX  *Inner,
+  OUT UINTN          *OuterPosition,
+  OUT UINTN          *InnerPosition
+  )
+{
+  UINTN                 OuterNext;
+  UINTN                 InnerPos;
+  UINTN                 HeapCount;
+  MEM_MAP_SORTED_ENTRY  *Candidate;
+  MEM_MAP_SORTED_ENTRY  *Entry;
+
+  OuterNext = 0;
+  HeapCount = 0;
+
+  for (InnerPos = 0; InnerPos < Inner->Count; InnerPos++) {
+    Entry = &Inner->ByStart[InnerPos];
+
+    while ((OuterNext < Outer->Count) && (Outer->ByStart[OuterNext].Start < Entry->Start)) {
+      HeapPush (Outer->ByStart, Outer->Heap, &HeapCount, OuterNext++);
+    }
+
+    while ((HeapCount > 0) && (Outer->ByStart[Outer->Heap[0]].End <= Entry->Start)) {
+      HeapPop (Outer->ByStart, Outer->Heap, &HeapCount);
+    }
+
+    if (HeapCount == 0) {
+      continue;
+    }
+
+    Candidate = &Outer->ByStart[Outer->Heap[0]];
+    if (Entry->End > Candidate->End) {
+      *OuterPosition = Candidate->Index;
+      *InnerPosition = Entry->Index;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Looks for an entry in one map that lies across the start or the end of an entry in the other
+  map, but not both.
+
+  @param[in]  LegacyIndex      Standard MemoryMap.
+  @param[in]  MatIndex         Memory Attributes Table.
+  @param[out] LegacyPosition   Map position of the offending MemoryMap entry.
+  @param[out] MatPosition      Map position of the offending MAT entry.
+
+  @retval TRUE   A boundary overlap was found.
+  @retval FALSE  No entries overlap a boundary.
+**/
+BOOLEAN
+MemMapFindBoundaryOverlap (
+  IN  MEM_MAP_INDEX  *LegacyIndex,
+  IN  MEM_MAP_INDEX  *MatIndex,
+  OUT UINTN          *LegacyPosition,
+  OUT UINTN          *MatPosition
+  )
+{
+  //
+  // A MAT entry running off the end of a MemoryMap entry, or a MemoryMap entry running off
+  // the end of a MAT entry.
+  //
+  return FindStraddle (LegacyIndex, MatIndex, LegacyPosition, MatPosition) ||
+         FindStraddle (MatIndex, LegacyIndex, MatPosition, LegacyPosition);
+}
+
+/**
+  Looks for a MAT entry that does not lie entirely within a single MemoryMap entry of the
+  same type.  Entries are checked in map order, so the first offender in the MAT is returned.
+
+  Of the MemoryMap entries of the same type that start at or below the MAT entry, the one
+  that reaches the highest is the only one that needs to be tested.
+
+  @param[in]  LegacyIndex  Standard MemoryMap.
+  @param[in]  MatIndex     Memory Attributes Table.
+  @param[out] MatPosition  Map position of the offending MAT entry.
+
+  @retval TRUE   A MAT entry without a matching MemoryMap entry was found.
+  @retval FALSE  Every MAT entry lies within a matching MemoryMap entry.
+**/
+BOOLEAN
+MemMapFindUncontainedEntry (
+  IN  MEM_MAP_INDEX  *LegacyIndex,
+  IN  MEM_MAP_INDEX  *MatIndex,
+  OUT UINTN          *MatPosition
+  )
+{
+  UINTN                 Position;
+  UINTN                 Before;
+  MEM_MAP_SORTED_ENTRY  Mat;
+  MEM_MAP_SORTED_ENTRY  *Legacy;
+
+  for (Position = 0; Position < MatIndex->Count; Position++) {
+    LoadSortedEntry (MatIndex->Meta, Position, &Mat);
+
+    Before = CountAtOrBefore (LegacyIndex->ByTypeAndStart, LegacyIndex->Count, Mat.Type, Mat.Start);
+    if ((Before == 0) || (LegacyIndex->ByTypeAndStart[Before - 1].Type != Mat.Type)) {
+      *MatPosition = Position;
+      return TRUE;
+    }
+
+    //
+    // An entry lies within if:
+    //    - It starts at the same address or starts within AND
+    //    - It ends at the same address or ends within.
+    //
+    Legacy = &LegacyIndex->ByTypeAndStart[LegacyIndex->MaxEndPos[Before - 1]];
+    if (!((A_IS_BETWEEN_B_AND_C (Mat.Start, Legacy->Start, Legacy->End) || (Mat.Start == Legacy->Start)) &&
+          (A_IS_BETWEEN_B_AND_C (Mat.End, Legacy->Start, Legacy->End) || (Mat.End == Legacy->End))))
+    {
+      *MatPosition = Position;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+/**
+  Looks for an EfiRuntimeServicesCode or EfiRuntimeServicesData MemoryMap entry that is not
+  entirely described by MAT entries of the same type.  Entries are checked in map order, so
+  the first offender in the MemoryMap is returned.
+
+  The MAT entries are merged into contiguous stretches when the index is built, so each
+  MemoryMap entry only has to be found within a single stretch.
+
+  @param[in]  LegacyIndex     Standard MemoryMap.
+  @param[in]  MatIndex        Memory Attributes Table.
+  @param[out] LegacyPosition  Map position of the offending MemoryMap entry.
+
+  @retval TRUE   A runtime entry that is not covered by the MAT was found.
+  @retval FALSE  Every runtime entry is covered by the MAT.
+**/
+BOOLEAN
+MemMapFindUncoveredRuntimeEntry (
+  IN  MEM_MAP_INDEX  *LegacyIndex,
+  IN  MEM_MAP_INDEX  *MatIndex,
+  OUT UINTN          *LegacyPosition
+  )
+{
+  UINTN                 Position;
+  UINTN                 Before;
+  MEM_MAP_SORTED_ENTRY  Legacy;
+  MEM_MAP_SORTED_ENTRY  *Run;
+
+  for (Position = 0; Position < LegacyIndex->Count; Position++) {
+    LoadSortedEntry (LegacyIndex->Meta, Position, &Legacy);
+
+    // If this entry is not EfiRuntimeServicesCode or EfiRuntimeServicesData, we don't care.
+    if ((Legacy.Type != EfiRuntimeServicesCode) && (Legacy.Type != EfiRuntimeServicesData)) {
+      continue;
+    }
+
+    Before = CountAtOrBefore (MatIndex->Runs, MatIndex->RunCount, Legacy.Type, Legacy.Start);
+    if ((Before == 0) || (MatIndex->Runs[Before - 1].Type != Legacy.Type)) {
+      *LegacyPosition = Position;
+      return TRUE;
+    }
+
+    Run = &MatIndex->Runs[Before - 1];
+    if (!((Legacy.Start == Run->Start) || A_IS_BETWEEN_B_AND_C (Legacy.Start, Run->Start, Run->End)) ||
+        (Run->End < Legacy.End))
+    {
+      *LegacyPosition = Position;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
@@ -0,0 +1,161 @@
+/** @file -- MemmapAndMatCheck.h
+Sorted views of the MemoryMap and the UEFI Memory Attributes Table, and the range checks
+that sweep over them.
+
+Each map is sorted once when the test environment is set up.  The overlap, containment and
+coverage checks then walk the sorted views in a single merged pass instead of comparing
+every entry against every other one.  The checks only locate the offending descriptors;
+reporting them is left to the caller.
+
+Copyright (C) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _MEMMAP_AND_MAT_CHECK_H_
+#define _MEMMAP_AND_MAT_CHECK_H_
+
+#define A_IS_BETWEEN_B_AND_C(A, B, C) \
+  (((B) < (A)) && ((A) < (C)))
+
+typedef struct _MEM_MAP_META {
+  UINTN    MapSize;
+  UINTN    EntrySize;
+  UINTN    EntryCount;
+  VOID     *Map;
+} MEM_MAP_META;
+
+typedef struct {
+  UINT32                  Type;
+  EFI_PHYSICAL_ADDRESS    Start;
+  EFI_PHYSICAL_ADDRESS    End;              // Last byte of the entry.
+  UINTN                   Index;            // Position of the descriptor in the map.
+} MEM_MAP_SORTED_ENTRY;
+
+typedef struct {
+  MEM_MAP_META            *Meta;
+  UINTN                   Count;
+  MEM_MAP_SORTED_ENTRY    *ByStart;         // Entries ordered by Start.
+  MEM_MAP_SORTED_ENTRY    *ByTypeAndStart;  // Entries ordered by Type, then Start.
+  UINTN                   *MaxEndPos;       // For each position in ByTypeAndStart, the position of the
+                                            // entry with the highest End so far within the same Type.
+  MEM_MAP_SORTED_ENTRY    *Runs;            // Contiguous stretches of same-typed entries, ordered by Type, then Start.
+  UINTN                   RunCount;
+  UINTN                   *Heap;            // Scratch space for the boundary sweep.
+} MEM_MAP_INDEX;
+
+/**
+  Returns the descriptor at a given position in a map.
+
+  @param[in] Meta   Map to index.
+  @param[in] Index  Position of the descriptor.
+
+  @retval The descriptor.
+**/
+EFI_MEMORY_DESCRIPTOR *
+MemMapGetDescriptor (
+  IN MEM_MAP_META  *Meta,
+  IN UINTN         Index
+  );
+
+/**
+  Builds the sorted views of a map.
+
+  @param[in]  Meta   Map to index.  Must stay valid for the lifetime of the index.
+  @param[out] Index  Index to build.  Release it with MemMapIndexFree.
+
+  @retval EFI_SUCCESS            The index was built.
+  @retval EFI_INVALID_PARAMETER  A parameter is NULL, or the map has entries but no entry size.
+  @retval EFI_OUT_OF_RESOURCES   The sorted views could not be allocated.
+**/
+EFI_STATUS
+MemMapIndexBuild (
+  IN  MEM_MAP_META   *Meta,
+  OUT MEM_MAP_INDEX  *Index
+  );
+
+/**
+  Releases the sorted views of a map.
+
+  @param[in,out] Index  Index to release.
+**/
+VOID
+MemMapIndexFree (
+  IN OUT MEM_MAP_INDEX  *Index
+  );
+
+/**
+  Looks for two entries in the same map where one starts strictly inside the other.
+
+  @param[in]  Index       Map to check.
+  @param[out] LeftIndex   Map position of the first entry of the offending pair.
+  @param[out] RightIndex  Map position of the second entry of the offending pair.
+
+  @retval TRUE   An overlap was found.
+  @retval FALSE  No entries overlap.
+**/
+BOOLEAN
+MemMapFindOverlap (
+  IN  MEM_MAP_INDEX  *Index,
+  OUT UINTN          *LeftIndex,
+  OUT UINTN          *RightIndex
+  );
+
+/**
+  Looks for an entry in one map that lies across the start or the end of an entry in the other
+  map, but not both.
+
+  @param[in]  LegacyIndex      Standard MemoryMap.
+  @param[in]  MatIndex         Memory Attributes Table.
+  @param[out] LegacyPosition   Map position of the offending MemoryMap entry.
+  @param[out] MatPosition      Map position of the offending MAT entry.
+
+  @retval TRUE   A boundary overlap was found.
+  @retval FALSE  No entries overlap a boundary.
+**/
+BOOLEAN
+MemMapFindBoundaryOverlap (
+  IN  MEM_MAP_INDEX  *LegacyIndex,
+  IN  MEM_MAP_INDEX  *MatIndex,
+  OUT UINTN          *LegacyPosition,
+  OUT UINTN          *MatPosition
+  );
+
+/**
+  Looks for a MAT entry that does not lie entirely within a single MemoryMap entry of the
+  same type.  Entries are checked in map order, so the first offender in the MAT is returned.
+
+  @param[in]  LegacyIndex  Standard MemoryMap.
+  @param[in]  MatIndex     Memory Attributes Table.
+  @param[out] MatPosition  Map position of the offending MAT entry.
+
+  @retval TRUE   A MAT entry without a matching MemoryMap entry was found.
+  @retval FALSE  Every MAT entry lies within a matching MemoryMap entry.
+**/
+BOOLEAN
+MemMapFindUncontainedEntry (
+  IN  MEM_MAP_INDEX  *LegacyIndex,
+  IN  MEM_MAP_INDEX  *MatIndex,
+  OUT UINTN          *MatPosition
+  );
+
+/**
+  Looks for an EfiRuntimeServicesCode or EfiRuntimeServicesData MemoryMap entry that is not
+  entirely described by MAT entries of the same type.  Entries are checked in map order, so
+  the first offender in the MemoryMap is returned.
+
+  @param[in]  LegacyIndex     Standard MemoryMap.
+  @param[in]  MatIndex        Memory Attributes Table.
+  @param[out] LegacyPosition  Map position of the offending MemoryMap entry.
+
+  @retval TRUE   A runtime entry that is not covered by the MAT was found.
+  @retval FALSE  Every runtime entry is covered by the MAT.
+**/
+BOOLEAN
+MemMapFindUncoveredRuntimeEntry (
+  IN  MEM_MAP_INDEX  *LegacyIndex,
+  IN  MEM_MAP_INDEX  *MatIndex,
+  OUT UINTN          *LegacyPosition
+  );
+
+#endif // _MEMMAP_AND_MAT_CHECK_H_
@@ -18,22 +18,16 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include <Guid/MemoryAttributesTable.h>
 
+#include "MemmapAndMatCheck.h"
+
 #define UNIT_TEST_APP_NAME        "MemoryMap and MemoryAttributesTable Unit Test"
 #define UNIT_TEST_APP_SHORT_NAME  "MemMap_and_MAT_Test"
 #define UNIT_TEST_APP_VERSION     "1.0"
 
-#define A_IS_BETWEEN_B_AND_C(A, B, C) \
-  (((B) < (A)) && ((A) < (C)))
-
-typedef struct _MEM_MAP_META {
-  UINTN    MapSize;
-  UINTN    EntrySize;
-  UINTN    EntryCount;
-  VOID     *Map;
-} MEM_MAP_META;
-
-MEM_MAP_META  mLegacyMapMeta;
-MEM_MAP_META  mMatMapMeta;
+MEM_MAP_META   mLegacyMapMeta;
+MEM_MAP_META   mMatMapMeta;
+MEM_MAP_INDEX  mLegacyMapIndex;
+MEM_MAP_INDEX  mMatMapIndex;
 
 /// ================================================================================================
 /// ================================================================================================
@@ -340,36 +334,16 @@ AllMatEntriesMustBeInAscendingOrder (
 UNIT_TEST_STATUS
 EFIAPI
 EntriesInASingleMapShouldNotOverlapAtAll (
-  MEM_MAP_META  *TestMap
+  MEM_MAP_INDEX  *TestMap
   )
 {
-  UNIT_TEST_STATUS       Status = UNIT_TEST_PASSED;
-  UINTN                  LeftIndex, RightIndex;
-  EFI_PHYSICAL_ADDRESS   LeftEnd, RightEnd;
-  EFI_MEMORY_DESCRIPTOR  *LeftDescriptor, *RightDescriptor;
-  BOOLEAN                Ok;
-
-  Ok = TRUE;
-  for (LeftIndex = 0; LeftIndex < TestMap->EntryCount && Ok; LeftIndex++) {
-    LeftDescriptor = (EFI_MEMORY_DESCRIPTOR *)((UINT8 *)TestMap->Map + (LeftIndex * TestMap->EntrySize));
-    LeftEnd        = LeftDescriptor->PhysicalStart + EFI_PAGES_TO_SIZE (LeftDescriptor->NumberOfPages) - 1;
-
-    // Start a new loop checking all of the entries in this list against the current one.
-    for (RightIndex = LeftIndex + 1; RightIndex < TestMap->EntryCount && Ok; RightIndex++) {
-      RightDescriptor = (EFI_MEMORY_DESCRIPTOR *)((UINT8 *)TestMap->Map + (RightIndex * TestMap->EntrySize));
-      RightEnd        = RightDescriptor->PhysicalStart + EFI_PAGES_TO_SIZE (RightDescriptor->NumberOfPages) - 1;
-
-      // Actually compare the data.
-      if (A_IS_BETWEEN_B_AND_C (RightDescriptor->PhysicalStart, LeftDescriptor->PhysicalStart, LeftEnd) ||
-          A_IS_BETWEEN_B_AND_C (LeftDescriptor->PhysicalStart, RightDescriptor->PhysicalStart, RightEnd))
-      {
-        DumpDescriptor (DEBUG_VERBOSE, L"[LeftDescriptor]", LeftDescriptor);
-        DumpDescriptor (DEBUG_VERBOSE, L"[RightDescriptor]", RightDescriptor);
-        Status = UNIT_TEST_ERROR_TEST_FAILED;
-        Ok     = FALSE;
-        break;
-      }
-    }
+  UNIT_TEST_STATUS  Status = UNIT_TEST_PASSED;
+  UINTN             LeftIndex, RightIndex;
+
+  if (MemMapFindOverlap (TestMap, &LeftIndex, &RightIndex)) {
+    DumpDescriptor (DEBUG_VERBOSE, L"[LeftDescriptor]", MemMapGetDescriptor (TestMap->Meta, LeftIndex));
+    DumpDescriptor (DEBUG_VERBOSE, L"[RightDescriptor]", MemMapGetDescriptor (TestMap->Meta, RightIndex));
+    Status = UNIT_TEST_ERROR_TEST_FAILED;
   }
 
   return Status;
@@ -381,7 +355,7 @@ EntriesInLegacyMapShouldNotOverlapAtAll (
   IN UNIT_TEST_CONTEXT  Context
   )
 {
-  return EntriesInASingleMapShouldNotOverlapAtAll (&mLegacyMapMeta);
+  return EntriesInASingleMapShouldNotOverlapAtAll (&mLegacyMapIndex);
 } // EntriesInLegacyMapShouldNotOverlapAtAll()
 
 UNIT_TEST_STATUS
@@ -390,7 +364,7 @@ EntriesInMatMapShouldNotOverlapAtAll (
   IN UNIT_TEST_CONTEXT  Context
   )
 {
-  return EntriesInASingleMapShouldNotOverlapAtAll (&mMatMapMeta);
+  return EntriesInASingleMapShouldNotOverlapAtAll (&mMatMapIndex);
 } // EntriesInMatMapShouldNotOverlapAtAll()
 
 UNIT_TEST_STATUS
@@ -399,45 +373,28 @@ EntriesBetweenListsShouldNotOverlapBoundaries (
   IN UNIT_TEST_CONTEXT  Context
   )
 {
-  UNIT_TEST_STATUS       Status = UNIT_TEST_PASSED;
-  UINTN                  LegacyIndex, MatIndex;
-  EFI_PHYSICAL_ADDRESS   LegacyEnd, MatEnd;
-  EFI_MEMORY_DESCRIPTOR  *LegacyDescriptor, *MatDescriptor;
-
-  // Create an outer loop for the first list.
-  for (LegacyIndex = 0; LegacyIndex < mLegacyMapMeta.EntryCount; LegacyIndex++) {
-    LegacyDescriptor = (EFI_MEMORY_DESCRIPTOR *)((UINT8 *)mLegacyMapMeta.Map + (LegacyIndex * mLegacyMapMeta.EntrySize));
-    LegacyEnd        = LegacyDescriptor->PhysicalStart + EFI_PAGES_TO_SIZE (LegacyDescriptor->NumberOfPages) - 1;
-
-    // Create an inner loop for the second list.
-    for (MatIndex = 0; MatIndex < mMatMapMeta.EntryCount; MatIndex++) {
-      MatDescriptor = (EFI_MEMORY_DESCRIPTOR *)((UINT8 *)mMatMapMeta.Map + (MatIndex * mMatMapMeta.EntrySize));
-      MatEnd        = MatDescriptor->PhysicalStart + EFI_PAGES_TO_SIZE (MatDescriptor->NumberOfPages) - 1;
-
-      //
-      // A bondary overlap is defined as an entry that lies across the start OR the end of another entry,
-      // but not both (See diagram).
-      //
-      //    |---------|
-      //    |         |
-      //    |    A    |   |---------|
-      //    |         |   |         |
-      //    |         |   |    B    |
-      //    |         |   |         |
-      //    |---------|   |         |
-      //                  |         |
-      //                  |---------|
-      //
-      if ((A_IS_BETWEEN_B_AND_C (MatDescriptor->PhysicalStart, LegacyDescriptor->PhysicalStart, LegacyEnd) && (MatEnd > LegacyEnd)) ||
-          (A_IS_BETWEEN_B_AND_C (LegacyDescriptor->PhysicalStart, MatDescriptor->PhysicalStart, MatEnd) && (LegacyEnd > MatEnd)))
-      {
-        DEBUG ((DEBUG_VERBOSE, "%a - Overlap between MemoryMaps!\n", __FUNCTION__));
-        DumpDescriptor (DEBUG_VERBOSE, L"[MatDescriptor]", MatDescriptor);
-        DumpDescriptor (DEBUG_VERBOSE, L"[LegacyDescriptor]", LegacyDescriptor);
-        Status = UNIT_TEST_ERROR_TEST_FAILED;
-        break;
-      }
-    }
+  UNIT_TEST_STATUS  Status = UNIT_TEST_PASSED;
+  UINTN             LegacyIndex, MatIndex;
+
+  //
+  // A bondary overlap is defined as an entry that lies across the start OR the end of another entry,
+  // but not both (See diagram).
+  //
+  //    |---------|
+  //    |         |
+  //    |    A    |   |---------|
+  //    |         |   |         |
+  //    |         |   |    B    |
+  //    |         |   |         |
+  //    |---------|   |         |
+  //                  |         |
+  //                  |---------|
+  //
+  if (MemMapFindBoundaryOverlap (&mLegacyMapIndex, &mMatMapIndex, &LegacyIndex, &MatIndex)) {
+    DEBUG ((DEBUG_VERBOSE, "%a - Overlap between MemoryMaps!\n", __FUNCTION__));
+    DumpDescriptor (DEBUG_VERBOSE, L"[MatDescriptor]", MemMapGetDescriptor (&mMatMapMeta, MatIndex));
+    DumpDescriptor (DEBUG_VERBOSE, L"[LegacyDescriptor]", MemMapGetDescriptor (&mLegacyMapMeta, LegacyIndex));
+    Status = UNIT_TEST_ERROR_TEST_FAILED;
   }
 
   return Status;
@@ -449,49 +406,14 @@ AllEntriesInMatShouldLieWithinAMatchingEntryInMemmap (
   IN UNIT_TEST_CONTEXT  Context
   )
 {
-  UNIT_TEST_STATUS       Status = UNIT_TEST_PASSED;
-  UINTN                  MatIndex, LegacyIndex;
-  EFI_PHYSICAL_ADDRESS   MatEnd, LegacyEnd;
-  EFI_MEMORY_DESCRIPTOR  *MatDescriptor, *LegacyDescriptor;
-  BOOLEAN                MatchFound;
-
-  // Create an outer loop for the first list.
-  for (MatIndex = 0; MatIndex < mMatMapMeta.EntryCount; MatIndex++) {
-    MatDescriptor = (EFI_MEMORY_DESCRIPTOR *)((UINT8 *)mMatMapMeta.Map + (MatIndex * mMatMapMeta.EntrySize));
-    MatEnd        = MatDescriptor->PhysicalStart + EFI_PAGES_TO_SIZE (MatDescriptor->NumberOfPages) - 1;
-
-    // Indicate that no match has yet been found for this entry.
-    MatchFound = FALSE;
-
-    // Create an inner loop for the second list.
-    for (LegacyIndex = 0; LegacyIndex < mLegacyMapMeta.EntryCount && !MatchFound; LegacyIndex++) {
-      LegacyDescriptor = (EFI_MEMORY_DESCRIPTOR *)((UINT8 *)mLegacyMapMeta.Map + (LegacyIndex * mLegacyMapMeta.EntrySize));
-      LegacyEnd        = LegacyDescriptor->PhysicalStart + EFI_PAGES_TO_SIZE (LegacyDescriptor->NumberOfPages) - 1;
-
-      //
-      // Determine whether this MAT entry lies entirely within this Legacy entry.
-      // An entry lies within if:
-      //    - It starts at the same address or starts within AND
-      //    - It ends at the same address or ends within.
-      //
-      if ((A_IS_BETWEEN_B_AND_C (MatDescriptor->PhysicalStart, LegacyDescriptor->PhysicalStart, LegacyEnd) ||
-           (MatDescriptor->PhysicalStart == LegacyDescriptor->PhysicalStart)) &&
-          (A_IS_BETWEEN_B_AND_C (MatEnd, LegacyDescriptor->PhysicalStart, LegacyEnd) || (MatEnd == LegacyEnd)))
-      {
-        // Now, make sure that the type matches.
-        if (MatDescriptor->Type == LegacyDescriptor->Type) {
-          MatchFound = TRUE;
-        }
-      }
-    }
+  UNIT_TEST_STATUS  Status = UNIT_TEST_PASSED;
+  UINTN             MatIndex;
 
-    // If a match was not found for this MAT entry, we have a problem.
-    if (!MatchFound) {
-      DEBUG ((DEBUG_VERBOSE, "%a - MAT entry not found in Legacy MemoryMap!\n", __FUNCTION__));
-      DumpDescriptor (DEBUG_VERBOSE, NULL, MatDescriptor);
-      Status = UNIT_TEST_ERROR_TEST_FAILED;
-      break;
-    }
+  // If a match was not found for a MAT entry, we have a problem.
+  if (MemMapFindUncontainedEntry (&mLegacyMapIndex, &mMatMapIndex, &MatIndex)) {
+    DEBUG ((DEBUG_VERBOSE, "%a - MAT entry not found in Legacy MemoryMap!\n", __FUNCTION__));
+    DumpDescriptor (DEBUG_VERBOSE, NULL, MemMapGetDescriptor (&mMatMapMeta, MatIndex));
+    Status = UNIT_TEST_ERROR_TEST_FAILED;
   }
 
   return Status;
@@ -503,67 +425,14 @@ AllMemmapRuntimeCodeAndDataEntriesMustBeEntirelyDescribedByMat (
   IN UNIT_TEST_CONTEXT  Context
   )
 {
-  UNIT_TEST_STATUS       Status = UNIT_TEST_PASSED;
-  UINTN                  LegacyIndex, MatIndex;
-  EFI_PHYSICAL_ADDRESS   LegacyEnd, MatEnd;
-  EFI_MEMORY_DESCRIPTOR  *LegacyDescriptor, *MatDescriptor;
-  EFI_PHYSICAL_ADDRESS   CurrentEntryProgress;
-  BOOLEAN                EntryComplete;
-
-  // Create an outer loop for the first list.
-  for (LegacyIndex = 0; LegacyIndex < mLegacyMapMeta.EntryCount; LegacyIndex++) {
-    LegacyDescriptor = (EFI_MEMORY_DESCRIPTOR *)((UINT8 *)mLegacyMapMeta.Map + (LegacyIndex * mLegacyMapMeta.EntrySize));
-    LegacyEnd        = LegacyDescriptor->PhysicalStart + EFI_PAGES_TO_SIZE (LegacyDescriptor->NumberOfPages) - 1;
-
-    // If this entry is not EfiRuntimeServicesCode or EfiRuntimeServicesData, we don't care.
-    if ((LegacyDescriptor->Type != EfiRuntimeServicesCode) && (LegacyDescriptor->Type != EfiRuntimeServicesData)) {
-      continue;   // Just keep looping over other entries.
-    }
-
-    //
-    // Now that we've found an entry of interest, we must make sure that
-    // the entire region is covered by MAT entries.
-    // We'll start by setting a "high water mark" for how much of the current entry has been verified.
-    // Since there's a prerequisite on the MAT entries being in ascending order, we can be confident
-    // that a bottom-up approach will work.
-    //
-    CurrentEntryProgress = LegacyDescriptor->PhysicalStart;
-    EntryComplete        = FALSE;
-
-    // Create an inner loop for the second list.
-    for (MatIndex = 0; MatIndex < mMatMapMeta.EntryCount && !EntryComplete; MatIndex++) {
-      MatDescriptor = (EFI_MEMORY_DESCRIPTOR *)((UINT8 *)mMatMapMeta.Map + (MatIndex * mMatMapMeta.EntrySize));
-      MatEnd        = MatDescriptor->PhysicalStart + EFI_PAGES_TO_SIZE (MatDescriptor->NumberOfPages) - 1;
-
-      // If this entry doesn't match the type we're looking for, then it's of no interest.
-      if (LegacyDescriptor->Type != MatDescriptor->Type) {
-        continue;
-      }
-
-      //
-      // If the start is the same as the high-water mark, we can remove the size from
-      // the "unaccounted" region of the current entry.
-      //
-      if ((CurrentEntryProgress == MatDescriptor->PhysicalStart) ||
-          A_IS_BETWEEN_B_AND_C (CurrentEntryProgress, MatDescriptor->PhysicalStart, MatEnd))
-      {
-        CurrentEntryProgress = MatEnd + 1;
-      }
-
-      // If the progress has now covered the entire entry, we're good.
-      if (CurrentEntryProgress > LegacyEnd) {
-        EntryComplete = TRUE;
-        break;
-      }
-    }
+  UNIT_TEST_STATUS  Status = UNIT_TEST_PASSED;
+  UINTN             LegacyIndex;
 
-    // If we never completed this entry, we're borked.
-    if (!EntryComplete) {
-      DEBUG ((DEBUG_VERBOSE, "%a - Legacy MemoryMap entry not covered by MAT entries!\n", __FUNCTION__));
-      DumpDescriptor (DEBUG_VERBOSE, NULL, LegacyDescriptor);
-      Status = UNIT_TEST_ERROR_TEST_FAILED;
-      break;
-    }
+  // If we never completed an entry, we're borked.
+  if (MemMapFindUncoveredRuntimeEntry (&mLegacyMapIndex, &mMatMapIndex, &LegacyIndex)) {
+    DEBUG ((DEBUG_VERBOSE, "%a - Legacy MemoryMap entry not covered by MAT entries!\n", __FUNCTION__));
+    DumpDescriptor (DEBUG_VERBOSE, NULL, MemMapGetDescriptor (&mLegacyMapMeta, LegacyIndex));
+    Status = UNIT_TEST_ERROR_TEST_FAILED;
   }
 
   return Status;
@@ -601,6 +470,8 @@ InitializeTestEnvironment (
   //
   ZeroMem (&mLegacyMapMeta, sizeof (mLegacyMapMeta));
   ZeroMem (&mMatMapMeta, sizeof (mMatMapMeta));
+  ZeroMem (&mLegacyMapIndex, sizeof (mLegacyMapIndex));
+  ZeroMem (&mMatMapIndex, sizeof (mMatMapIndex));
 
   //
   // Grab the legacy MemoryMap...
@@ -643,6 +514,17 @@ InitializeTestEnvironment (
   mMatMapMeta.EntryCount = MatMap->NumberOfEntries;
   mMatMapMeta.Map        = (VOID *)((UINT8 *)MatMap + sizeof (*MatMap));
 
+  //
+  // Sort both maps once so that the range tests can sweep them instead of
+  // comparing every entry against every other one.
+  //
+  Status = MemMapIndexBuild (&mLegacyMapMeta, &mLegacyMapIndex);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = MemMapIndexBuild (&mMatMapMeta, &mMatMapIndex);
+
   return Status;
 } // InitializeTestEnvironment()
 
@@ -736,8 +618,7 @@ MemmapAndMatTestApp (
   AddTestCase (TableEntryRangeTests, "Entries in MAT should not overlap each other at all", "Security.MAT.MatEntryOverlap", EntriesInMatMapShouldNotOverlapAtAll, NULL, NULL, NULL);
   AddTestCase (TableEntryRangeTests, "Entries in one list should not overlap any of the boundaries of entries in the other", "Security.MAT.EntryOverlap", EntriesBetweenListsShouldNotOverlapBoundaries, NULL, NULL, NULL);
   AddTestCase (TableEntryRangeTests, "All MAT entries should lie entirely within a standard MemoryMap entry of the same type", "Security.MAT.EntriesWithinMemMap", AllEntriesInMatShouldLieWithinAMatchingEntryInMemmap, NULL, NULL, NULL);
-  // NOTE: For this test, it would be ideal for the AllMatEntriesMustBeInAscendingOrder test to be a prereq, but since the prototype for
-  //       a test case and a prereq are now different (and since I'm too lazy to write a wrapper function...) here we are.
+  // NOTE: This test sorts the MAT on its own, so it does not depend on AllMatEntriesMustBeInAscendingOrder passing.
   AddTestCase (
     TableEntryRangeTests,
     "All EfiRuntimeServicesCode and EfiRuntimeServicesData entries in standard MemoryMap must be entirely described by MAT",
@@ -754,6 +635,9 @@ MemmapAndMatTestApp (
   Status = RunAllTestSuites (Fw);
 
 EXIT:
+  MemMapIndexFree (&mLegacyMapIndex);
+  MemMapIndexFree (&mMatMapIndex);
+
   // Need to free the memory that was allocated for the Legacy Mem Map.
   if (mLegacyMapMeta.Map) {
     FreePool (mLegacyMapMeta.Map);
@@ -0,0 +1,835 @@
+/** @file
+  Host based unit tests for the MemmapAndMatTestApp range checks.
+
+  The range checks are run against synthetic MemoryMaps and MATs of more than ten thousand
+  entries, including layouts built to defeat shortcuts such as comparing only against the
+  widest earlier entry.  A reference copy of the original pairwise checks is kept here to
+  confirm that the sweeps reach the same verdicts on small random maps.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/UnitTestLib.h>
+#include "../MemmapAndMatCheck.h"
+
+#define UNIT_TEST_NAME     "MemmapAndMatTestApp Range Check Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define LARGE_MAP_ENTRIES      12288
+#define RANDOM_MAP_ENTRIES     48
+#define RANDOM_MAP_ITERATIONS  400
+
+//
+// Firmware is allowed to report descriptors larger than EFI_MEMORY_DESCRIPTOR.
+//
+#define TEST_DESCRIPTOR_SIZE  (sizeof (EFI_MEMORY_DESCRIPTOR) + 16)
+
+typedef struct {
+  MEM_MAP_META     Meta;
+  UINTN            Capacity;
+  MEM_MAP_INDEX    Index;
+} TEST_MAP;
+
+STATIC TEST_MAP  mLegacy;
+STATIC TEST_MAP  mMat;
+STATIC UINT32    mRandomState;
+
+/**
+  Deterministic pseudo random numbers so that failures reproduce.
+**/
+STATIC
+UINT32
+NextRandom (
+  VOID
+  )
+{
+  mRandomState = mRandomState * 1103515245 + 12345;
+  return (mRandomState >> 8) & 0xFFFFFF;
+}
+
+STATIC
+VOID
+MapReset (
+  IN OUT TEST_MAP  *Map,
+  IN     UINTN     Capacity
+  )
+{
+  MemMapIndexFree (&Map->Index);
+  if (Map->Meta.Map != NULL) {
+    FreePool (Map->Meta.Map);
+  }
+
+  ZeroMem (Map, sizeof (TEST_MAP));
+  Map->Capacity       = Capacity;
+  Map->Meta.EntrySize = TEST_DESCRIPTOR_SIZE;
+  Map->Meta.Map       = AllocateZeroPool (Capacity * TEST_DESCRIPTOR_SIZE);
+}
+
+STATIC
+UINTN
+MapAdd (
+  IN OUT TEST_MAP              *Map,
+  IN     EFI_MEMORY_TYPE       Type,
+  IN     EFI_PHYSICAL_ADDRESS  Start,
+  IN     UINT64                Pages
+  )
+{
+  EFI_MEMORY_DESCRIPTOR  *Descriptor;
+
+  ASSERT (Map->Meta.EntryCount < Map->Capacity);
+  Descriptor                = MemMapGetDescriptor (&Map->Meta, Map->Meta.EntryCount);
+  Descriptor->Type          = Type;
+  Descriptor->PhysicalStart = Start;
+  Descriptor->VirtualStart  = 0;
+  Descriptor->NumberOfPages = Pages;
+  Descriptor->Attribute     = (Type == EfiRuntimeServicesCode || Type == EfiRuntimeServicesData) ? EFI_MEMORY_RUNTIME : 0;
+
+  Map->Meta.MapSize = ++Map->Meta.EntryCount * Map->Meta.EntrySize;
+  return Map->Meta.EntryCount - 1;
+}
+
+STATIC
+VOID
+MapSwap (
+  IN OUT TEST_MAP  *Map,
+  IN     UINTN     Left,
+  IN     UINTN     Right
+  )
+{
+  EFI_MEMORY_DESCRIPTOR  Temp;
+
+  CopyMem (&Temp, MemMapGetDescriptor (&Map->Meta, Left), sizeof (Temp));
+  CopyMem (MemMapGetDescriptor (&Map->Meta, Left), MemMapGetDescriptor (&Map->Meta, Right), sizeof (Temp));
+  CopyMem (MemMapGetDescriptor (&Map->Meta, Right), &Temp, sizeof (Temp));
+}
+
+STATIC
+VOID
+MapShuffle (
+  IN OUT TEST_MAP  *Map
+  )
+{
+  UINTN  Index;
+
+  for (Index = Map->Meta.EntryCount; Index > 1; Index--) {
+    MapSwap (Map, Index - 1, NextRandom () % Index);
+  }
+}
+
+STATIC
+VOID
+MapReverse (
+  IN OUT TEST_MAP  *Map
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < Map->Meta.EntryCount / 2; Index++) {
+    MapSwap (Map, Index, Map->Meta.EntryCount - 1 - Index);
+  }
+}
+
+STATIC
+EFI_STATUS
+MapBuildIndex (
+  IN OUT TEST_MAP  *Map
+  )
+{
+  MemMapIndexFree (&Map->Index);
+  return MemMapIndexBuild (&Map->Meta, &Map->Index);
+}
+
+STATIC
+EFI_PHYSICAL_ADDRESS
+DescriptorEnd (
+  IN EFI_MEMORY_DESCRIPTOR  *Descriptor
+  )
+{
+  return Descriptor->PhysicalStart + EFI_PAGES_TO_SIZE (Descriptor->NumberOfPages) - 1;
+}
+
+/**
+  Builds a well-formed pair of maps.  The MemoryMap is a contiguous run of mixed types, and
+  every runtime entry is split into MAT entries of up to six pages in ascending order.
+**/
+STATIC
+VOID
+BuildCleanMaps (
+  IN UINTN  LegacyCount
+  )
+{
+  STATIC CONST EFI_MEMORY_TYPE  Types[] = {
+    EfiConventionalMemory, EfiBootServicesData, EfiRuntimeServicesCode,
+    EfiRuntimeServicesData, EfiBootServicesCode, EfiRuntimeServicesCode
+  };
+  EFI_PHYSICAL_ADDRESS          Address;
+  UINTN                         Index;
+  UINT64                        Pages;
+  UINT64                        Piece;
+  EFI_MEMORY_TYPE               Type;
+
+  MapReset (&mLegacy, LegacyCount + 16);
+  MapReset (&mMat, LegacyCount * 16);
+
+  Address = 0x100000;
+  for (Index = 0; Index < LegacyCount; Index++) {
+    Type  = Types[Index % ARRAY_SIZE (Types)];
+    Pages = 1 + NextRandom () % 16;
+    MapAdd (&mLegacy, Type, Address, Pages);
+
+    if ((Type == EfiRuntimeServicesCode) || (Type == EfiRuntimeServicesData)) {
+      while (Pages > 0) {
+        Piece = 1 + NextRandom () % 6;
+        Piece = MIN (Pages, Piece);
+        MapAdd (&mMat, Type, Address, Piece);
+        Address += EFI_PAGES_TO_SIZE (Piece);
+        Pages   -= Piece;
+      }
+    } else {
+      Address += EFI_PAGES_TO_SIZE (Pages);
+    }
+  }
+}
+
+//
+// Reference copies of the original pairwise checks.
+//
+
+STATIC
+BOOLEAN
+ReferenceOverlap (
+  IN MEM_MAP_META  *Map
+  )
+{
+  UINTN                  Left, Right;
+  EFI_MEMORY_DESCRIPTOR  *L, *R;
+
+  for (Left = 0; Left < Map->EntryCount; Left++) {
+    L = MemMapGetDescriptor (Map, Left);
+    for (Right = Left + 1; Right < Map->EntryCount; Right++) {
+      R = MemMapGetDescriptor (Map, Right);
+      if (A_IS_BETWEEN_B_AND_C (R->PhysicalStart, L->PhysicalStart, DescriptorEnd (L)) ||
+          A_IS_BETWEEN_B_AND_C (L->PhysicalStart, R->PhysicalStart, DescriptorEnd (R)))
+      {
+        return TRUE;
+      }
+    }
+  }
+
+  return FALSE;
+}
+
+STATIC
+BOOLEAN
+ReferenceBoundaryOverlap (
+  IN MEM_MAP_META  *Legacy,
+  IN MEM_MAP_META  *Mat
+  )
+{
+  UINTN                  LegacyIndex, MatIndex;
+  EFI_MEMORY_DESCRIPTOR  *L, *M;
+
+  for (LegacyIndex = 0; LegacyIndex < Legacy->EntryCount; LegacyIndex++) {
+    L = MemMapGetDescriptor (Legacy, LegacyIndex);
+    for (MatIndex = 0; MatIndex < Mat->EntryCount; MatIndex++) {
+      M = MemMapGetDescriptor (Mat, MatIndex);
+      if ((A_IS_BETWEEN_B_AND_C (M->PhysicalStart, L->PhysicalStart, DescriptorEnd (L)) && (DescriptorEnd (M) > DescriptorEnd (L))) ||
+          (A_IS_BETWEEN_B_AND_C (L->PhysicalStart, M->PhysicalStart, DescriptorEnd (M)) && (DescriptorEnd (L) > DescriptorEnd (M))))
+      {
+        return TRUE;
+      }
+    }
+  }
+
+  return FALSE;
+}
+
+STATIC
+BOOLEAN
+ReferenceUncontained (
+  IN  MEM_MAP_META  *Legacy,
+  IN  MEM_MAP_META  *Mat,
+  OUT UINTN         *MatPosition
+  )
+{
+  UINTN                  LegacyIndex, MatIndex;
+  EFI_MEMORY_DESCRIPTOR  *L, *M;
+  BOOLEAN                MatchFound;
+
+  for (MatIndex = 0; MatIndex < Mat->EntryCount; MatIndex++) {
+    M          = MemMapGetDescriptor (Mat, MatIndex);
+    MatchFound = FALSE;
+    for (LegacyIndex = 0; LegacyIndex < Legacy->EntryCount && !MatchFound; LegacyIndex++) {
+      L = MemMapGetDescriptor (Legacy, LegacyIndex);
+      if ((A_IS_BETWEEN_B_AND_C (M->PhysicalStart, L->PhysicalStart, DescriptorEnd (L)) || (M->PhysicalStart == L->PhysicalStart)) &&
+          (A_IS_BETWEEN_B_AND_C (DescriptorEnd (M), L->PhysicalStart, DescriptorEnd (L)) || (DescriptorEnd (M) == DescriptorEnd (L))) &&
+          (M->Type == L->Type))
+      {
+        MatchFound = TRUE;
+      }
+    }
+
+    if (!MatchFound) {
+      *MatPosition = MatIndex;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+STATIC
+BOOLEAN
+ReferenceUncovered (
+  IN  MEM_MAP_META  *Legacy,
+  IN  MEM_MAP_META  *Mat,
+  OUT UINTN         *LegacyPosition
+  )
+{
+  UINTN                  LegacyIndex, MatIndex;
+  EFI_MEMORY_DESCRIPTOR  *L, *M;
+  EFI_PHYSICAL_ADDRESS   Progress;
+  BOOLEAN                Complete;
+
+  for (LegacyIndex = 0; LegacyIndex < Legacy->EntryCount; LegacyIndex++) {
+    L = MemMapGetDescriptor (Legacy, LegacyIndex);
+    if ((L->Type != EfiRuntimeServicesCode) && (L->Type != EfiRuntimeServicesData)) {
+      continue;
+    }
+
+    Progress = L->PhysicalStart;
+    Complete = FALSE;
+    for (MatIndex = 0; MatIndex < Mat->EntryCount && !Complete; MatIndex++) {
+      M = MemMapGetDescriptor (Mat, MatIndex);
+      if (L->Type != M->Type) {
+        continue;
+      }
+
+      if ((Progress == M->PhysicalStart) || A_IS_BETWEEN_B_AND_C (Progress, M->PhysicalStart, DescriptorEnd (M))) {
+        Progress = DescriptorEnd (M) + 1;
+      }
+
+      if (Progress > DescriptorEnd (L)) {
+        Complete = TRUE;
+      }
+    }
+
+    if (!Complete) {
+      *LegacyPosition = LegacyIndex;
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+//
+// Test cases.
+//
+
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+ResetMaps (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mRandomState = 0x5EED;
+  MapReset (&mLegacy, 0);
+  MapReset (&mMat, 0);
+  return UNIT_TEST_PASSED;
+}
+
+STATIC
+VOID
+EFIAPI
+FreeMaps (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  MemMapIndexFree (&mLegacy.Index);
+  MemMapIndexFree (&mMat.Index);
+  FreePool (mLegacy.Meta.Map);
+  FreePool (mMat.Meta.Map);
+  ZeroMem (&mLegacy, sizeof (mLegacy));
+  ZeroMem (&mMat, sizeof (mMat));
+}
+
+/**
+  Well-formed maps pass every check, even when the MemoryMap is reported out of order.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+CleanLargeMapsPass (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  First, Second;
+
+  BuildCleanMaps (LARGE_MAP_ENTRIES);
+  MapShuffle (&mLegacy);
+  UT_ASSERT_TRUE (mMat.Meta.EntryCount > LARGE_MAP_ENTRIES);
+
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mLegacy));
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mMat));
+
+  UT_ASSERT_FALSE (MemMapFindOverlap (&mLegacy.Index, &First, &Second));
+  UT_ASSERT_FALSE (MemMapFindOverlap (&mMat.Index, &First, &Second));
+  UT_ASSERT_FALSE (MemMapFindBoundaryOverlap (&mLegacy.Index, &mMat.Index, &First, &Second));
+  UT_ASSERT_FALSE (MemMapFindUncontainedEntry (&mLegacy.Index, &mMat.Index, &First));
+  UT_ASSERT_FALSE (MemMapFindUncoveredRuntimeEntry (&mLegacy.Index, &mMat.Index, &First));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Empty maps are trivially consistent.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+EmptyMapsPass (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  First, Second;
+
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mLegacy));
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mMat));
+
+  UT_ASSERT_FALSE (MemMapFindOverlap (&mLegacy.Index, &First, &Second));
+  UT_ASSERT_FALSE (MemMapFindBoundaryOverlap (&mLegacy.Index, &mMat.Index, &First, &Second));
+  UT_ASSERT_FALSE (MemMapFindUncontainedEntry (&mLegacy.Index, &mMat.Index, &First));
+  UT_ASSERT_FALSE (MemMapFindUncoveredRuntimeEntry (&mLegacy.Index, &mMat.Index, &First));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  An entry appended at the end of the map that starts inside the very first region is found.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+OverlapBetweenDistantEntriesIsFound (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_MEMORY_DESCRIPTOR  *First;
+  UINTN                  Intruder;
+  UINTN                  Left, Right;
+
+  BuildCleanMaps (LARGE_MAP_ENTRIES);
+  First = MemMapGetDescriptor (&mLegacy.Meta, 0);
+  UT_ASSERT_TRUE (First->NumberOfPages > 0);
+  First->NumberOfPages += 1;
+  Intruder              = MapAdd (&mLegacy, EfiReservedMemoryType, DescriptorEnd (First) + 1 - EFI_PAGE_SIZE, 1);
+
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mLegacy));
+  UT_ASSERT_TRUE (MemMapFindOverlap (&mLegacy.Index, &Left, &Right));
+  UT_ASSERT_TRUE (Left < Right);
+
+  //
+  // Growing the first entry also runs it into its neighbour, so accept either pair as long
+  // as it really overlaps.
+  //
+  UT_ASSERT_TRUE (Left == 0 || Right == Intruder);
+  UT_ASSERT_TRUE (
+    A_IS_BETWEEN_B_AND_C (MemMapGetDescriptor (&mLegacy.Meta, Right)->PhysicalStart, MemMapGetDescriptor (&mLegacy.Meta, Left)->PhysicalStart, DescriptorEnd (MemMapGetDescriptor (&mLegacy.Meta, Left))) ||
+    A_IS_BETWEEN_B_AND_C (MemMapGetDescriptor (&mLegacy.Meta, Left)->PhysicalStart, MemMapGetDescriptor (&mLegacy.Meta, Right)->PhysicalStart, DescriptorEnd (MemMapGetDescriptor (&mLegacy.Meta, Right)))
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Entries that share a start address are not an overlap under the rule the test has always
+  applied, no matter how many there are.  One more entry starting a page later is.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SharedStartsAreNotOverlaps (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+  UINTN  Intruder;
+  UINTN  Left, Right;
+
+  MapReset (&mLegacy, LARGE_MAP_ENTRIES + 1);
+  for (Index = 0; Index < LARGE_MAP_ENTRIES; Index++) {
+    MapAdd (&mLegacy, EfiBootServicesData, 0x200000, 1 + (Index * 7919) % LARGE_MAP_ENTRIES);
+  }
+
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mLegacy));
+  UT_ASSERT_FALSE (MemMapFindOverlap (&mLegacy.Index, &Left, &Right));
+
+  Intruder = MapAdd (&mLegacy, EfiBootServicesData, 0x201000, 1);
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mLegacy));
+  UT_ASSERT_TRUE (MemMapFindOverlap (&mLegacy.Index, &Left, &Right));
+  UT_ASSERT_EQUAL (Right, Intruder);
+  UT_ASSERT_TRUE (MemMapGetDescriptor (&mLegacy.Meta, Left)->NumberOfPages > 1);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Deeply nested entries, the worst case for a pairwise scan, are found.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DeeplyNestedEntriesOverlap (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+  UINTN  Left, Right;
+
+  MapReset (&mMat, LARGE_MAP_ENTRIES);
+  for (Index = 0; Index < LARGE_MAP_ENTRIES; Index++) {
+    MapAdd (&mMat, EfiRuntimeServicesData, EFI_PAGES_TO_SIZE (Index), 2 * (LARGE_MAP_ENTRIES - Index));
+  }
+
+  MapReverse (&mMat);
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mMat));
+  UT_ASSERT_TRUE (MemMapFindOverlap (&mMat.Index, &Left, &Right));
+  UT_ASSERT_TRUE (Left < Right);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A MAT entry that runs off the end of a small MemoryMap entry is found even though a much
+  wider MemoryMap entry starting lower would contain it.  Only tracking the widest earlier
+  entry would miss this.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+StraddleHiddenBehindWideEntryIsFound (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+  UINTN  Small;
+  UINTN  Straddler;
+  UINTN  LegacyPosition, MatPosition;
+
+  MapReset (&mLegacy, LARGE_MAP_ENTRIES + 2);
+  MapReset (&mMat, LARGE_MAP_ENTRIES + 2);
+
+  MapAdd (&mLegacy, EfiReservedMemoryType, 0, 4 * LARGE_MAP_ENTRIES);
+  for (Index = 0; Index < LARGE_MAP_ENTRIES; Index++) {
+    //
+    // MAT entries strictly inside the wide entry are fine.
+    //
+    MapAdd (&mMat, EfiRuntimeServicesCode, EFI_PAGES_TO_SIZE (4 * Index + 1), 2);
+  }
+
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mLegacy));
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mMat));
+  UT_ASSERT_FALSE (MemMapFindBoundaryOverlap (&mLegacy.Index, &mMat.Index, &LegacyPosition, &MatPosition));
+
+  Small     = MapAdd (&mLegacy, EfiReservedMemoryType, EFI_PAGES_TO_SIZE (2 * LARGE_MAP_ENTRIES), 4);
+  Straddler = MapAdd (&mMat, EfiRuntimeServicesCode, EFI_PAGES_TO_SIZE (2 * LARGE_MAP_ENTRIES + 3), 3);
+
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mLegacy));
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mMat));
+  UT_ASSERT_TRUE (ReferenceBoundaryOverlap (&mLegacy.Meta, &mMat.Meta));
+  UT_ASSERT_TRUE (MemMapFindBoundaryOverlap (&mLegacy.Index, &mMat.Index, &LegacyPosition, &MatPosition));
+  UT_ASSERT_EQUAL (LegacyPosition, Small);
+  UT_ASSERT_EQUAL (MatPosition, Straddler);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A MemoryMap entry that runs off the end of a MAT entry is found as well.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+LegacyStraddlingMatIsFound (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  EFI_MEMORY_DESCRIPTOR  *Mat;
+  UINTN                  Straddler;
+  UINTN                  LegacyPosition, MatPosition;
+
+  BuildCleanMaps (LARGE_MAP_ENTRIES);
+  Mat = MemMapGetDescriptor (&mMat.Meta, mMat.Meta.EntryCount / 2);
+
+  //
+  // Starts one page into the MAT entry and ends one page past it.
+  //
+  Straddler = MapAdd (&mLegacy, Mat->Type, Mat->PhysicalStart + EFI_PAGE_SIZE, Mat->NumberOfPages);
+  if (Mat->NumberOfPages == 1) {
+    MemMapGetDescriptor (&mLegacy.Meta, Straddler)->PhysicalStart = Mat->PhysicalStart + EFI_PAGE_SIZE / 2;
+  }
+
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mLegacy));
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mMat));
+  UT_ASSERT_TRUE (MemMapFindBoundaryOverlap (&mLegacy.Index, &mMat.Index, &LegacyPosition, &MatPosition));
+  UT_ASSERT_TRUE (
+    (A_IS_BETWEEN_B_AND_C (MemMapGetDescriptor (&mMat.Meta, MatPosition)->PhysicalStart, MemMapGetDescriptor (&mLegacy.Meta, LegacyPosition)->PhysicalStart, DescriptorEnd (MemMapGetDescriptor (&mLegacy.Meta, LegacyPosition))) &&
+     (DescriptorEnd (MemMapGetDescriptor (&mMat.Meta, MatPosition)) > DescriptorEnd (MemMapGetDescriptor (&mLegacy.Meta, LegacyPosition)))) ||
+    (A_IS_BETWEEN_B_AND_C (MemMapGetDescriptor (&mLegacy.Meta, LegacyPosition)->PhysicalStart, MemMapGetDescriptor (&mMat.Meta, MatPosition)->PhysicalStart, DescriptorEnd (MemMapGetDescriptor (&mMat.Meta, MatPosition))) &&
+     (DescriptorEnd (MemMapGetDescriptor (&mLegacy.Meta, LegacyPosition)) > DescriptorEnd (MemMapGetDescriptor (&mMat.Meta, MatPosition))))
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A MAT entry whose type doesn't match, and one that spans two MemoryMap entries of the right
+  type, are both reported, the earlier one in MAT order first.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+UncontainedMatEntriesAreFound (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN                  Found;
+  UINTN                  Expected;
+  EFI_PHYSICAL_ADDRESS   Top;
+  EFI_MEMORY_DESCRIPTOR  *Mat;
+
+  BuildCleanMaps (LARGE_MAP_ENTRIES);
+
+  //
+  // Two adjacent runtime code entries above everything else, and a MAT entry of the same
+  // type that starts in the first and ends in the second.
+  //
+  Top = DescriptorEnd (MemMapGetDescriptor (&mLegacy.Meta, mLegacy.Meta.EntryCount - 1)) + 1;
+  MapAdd (&mLegacy, EfiRuntimeServicesCode, Top, 2);
+  MapAdd (&mLegacy, EfiRuntimeServicesCode, Top + EFI_PAGES_TO_SIZE (2), 2);
+  Expected = MapAdd (&mMat, EfiRuntimeServicesCode, Top + EFI_PAGE_SIZE, 2);
+  MapAdd (&mMat, EfiRuntimeServicesCode, Top + EFI_PAGES_TO_SIZE (3), 1);
+
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mLegacy));
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mMat));
+  UT_ASSERT_TRUE (MemMapFindUncontainedEntry (&mLegacy.Index, &mMat.Index, &Found));
+  UT_ASSERT_EQUAL (Found, Expected);
+
+  //
+  // Flip the type of an earlier entry.  It's now the first offender.
+  //
+  Mat       = MemMapGetDescriptor (&mMat.Meta, 3);
+  Mat->Type = (Mat->Type == EfiRuntimeServicesCode) ? EfiRuntimeServicesData : EfiRuntimeServicesCode;
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mMat));
+  UT_ASSERT_TRUE (MemMapFindUncontainedEntry (&mLegacy.Index, &mMat.Index, &Found));
+  UT_ASSERT_EQUAL (Found, 3);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A single page missing from the MAT inside one runtime entry is found.  The MAT is checked
+  by address, so reporting it in descending order doesn't hide full coverage.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+CoverageGapIsFound (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN                  Index;
+  UINTN                  Found;
+  UINTN                  Runtime;
+
+  MapReset (&mLegacy, 3);
+  MapReset (&mMat, LARGE_MAP_ENTRIES);
+
+  MapAdd (&mLegacy, EfiConventionalMemory, 0x100000, 16);
+  Runtime = MapAdd (&mLegacy, EfiRuntimeServicesData, 0x110000, LARGE_MAP_ENTRIES);
+  MapAdd (&mLegacy, EfiRuntimeServicesCode, 0x110000 + EFI_PAGES_TO_SIZE (LARGE_MAP_ENTRIES), 1);
+
+  for (Index = 0; Index < LARGE_MAP_ENTRIES; Index++) {
+    MapAdd (&mMat, EfiRuntimeServicesData, 0x110000 + EFI_PAGES_TO_SIZE (Index), 1);
+  }
+
+  //
+  // The runtime code entry has no MAT entry at all.
+  //
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mLegacy));
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mMat));
+  UT_ASSERT_TRUE (MemMapFindUncoveredRuntimeEntry (&mLegacy.Index, &mMat.Index, &Found));
+  UT_ASSERT_EQUAL (Found, Runtime + 1);
+
+  mLegacy.Meta.EntryCount--;
+  mLegacy.Meta.MapSize -= mLegacy.Meta.EntrySize;
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mLegacy));
+  MapReverse (&mMat);
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mMat));
+  UT_ASSERT_FALSE (MemMapFindUncoveredRuntimeEntry (&mLegacy.Index, &mMat.Index, &Found));
+
+  //
+  // Punch a hole one page wide in the middle by retyping it.
+  //
+  MemMapGetDescriptor (&mMat.Meta, LARGE_MAP_ENTRIES / 3)->Type = EfiRuntimeServicesCode;
+  UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mMat));
+  UT_ASSERT_TRUE (MemMapFindUncoveredRuntimeEntry (&mLegacy.Index, &mMat.Index, &Found));
+  UT_ASSERT_EQUAL (Found, Runtime);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  On small random maps full of overlaps, the sweeps agree with the original pairwise checks.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+SweepsMatchPairwiseReference (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST EFI_MEMORY_TYPE  Types[] = { EfiRuntimeServicesCode, EfiRuntimeServicesData, EfiBootServicesData };
+  UINTN                         Iteration;
+  UINTN                         Index;
+  UINTN                         Next;
+  UINTN                         First, Second;
+  UINTN                         Expected;
+  BOOLEAN                       ExpectedFound;
+  UINTN                         Granularity;
+  UINTN                         Spread;
+
+  for (Iteration = 0; Iteration < RANDOM_MAP_ITERATIONS; Iteration++) {
+    MapReset (&mLegacy, RANDOM_MAP_ENTRIES);
+    MapReset (&mMat, RANDOM_MAP_ENTRIES);
+
+    //
+    // Every other map is built from misaligned starts to reach the edge cases of the
+    // original comparisons, where one entry ends right where another one starts.
+    //
+    Granularity = ((Iteration % 2) == 0) ? EFI_PAGE_SIZE : 0x555;
+    Spread      = 64 << (Iteration % 7);
+    for (Index = 0; Index < RANDOM_MAP_ENTRIES; Index++) {
+      MapAdd (&mLegacy, Types[NextRandom () % ARRAY_SIZE (Types)], Granularity * (NextRandom () % Spread), 1 + NextRandom () % 12);
+      MapAdd (&mMat, Types[NextRandom () % 2], Granularity * (NextRandom () % Spread), 1 + NextRandom () % 6);
+    }
+
+    //
+    // The original coverage check relied on the MAT being in ascending order.
+    //
+    for (Index = 1; Index < mMat.Meta.EntryCount; Index++) {
+      for (Next = Index; Next > 0 && MemMapGetDescriptor (&mMat.Meta, Next - 1)->PhysicalStart > MemMapGetDescriptor (&mMat.Meta, Next)->PhysicalStart; Next--) {
+        MapSwap (&mMat, Next - 1, Next);
+      }
+    }
+
+    UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mLegacy));
+    UT_ASSERT_NOT_EFI_ERROR (MapBuildIndex (&mMat));
+
+    UT_ASSERT_EQUAL (MemMapFindOverlap (&mLegacy.Index, &First, &Second), ReferenceOverlap (&mLegacy.Meta));
+    UT_ASSERT_EQUAL (MemMapFindOverlap (&mMat.Index, &First, &Second), ReferenceOverlap (&mMat.Meta));
+    UT_ASSERT_EQUAL (MemMapFindBoundaryOverlap (&mLegacy.Index, &mMat.Index, &First, &Second), ReferenceBoundaryOverlap (&mLegacy.Meta, &mMat.Meta));
+
+    ExpectedFound = ReferenceUncontained (&mLegacy.Meta, &mMat.Meta, &Expected);
+    UT_ASSERT_EQUAL (MemMapFindUncontainedEntry (&mLegacy.Index, &mMat.Index, &First), ExpectedFound);
+    if (ExpectedFound) {
+      UT_ASSERT_EQUAL (First, Expected);
+    }
+
+    ExpectedFound = ReferenceUncovered (&mLegacy.Meta, &mMat.Meta, &Expected);
+    UT_ASSERT_EQUAL (MemMapFindUncoveredRuntimeEntry (&mLegacy.Index, &mMat.Index, &First), ExpectedFound);
+    if (ExpectedFound) {
+      UT_ASSERT_EQUAL (First, Expected);
+    }
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  MemmapAndMatTestApp range checks and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      RangeSuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&RangeSuiteHandle, Framework, "MemmapAndMatTestApp range check tests", "MemmapAndMat.Range", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for RangeSuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (RangeSuiteHandle, "Clean large maps pass", "CleanLargeMaps", CleanLargeMapsPass, ResetMaps, FreeMaps, NULL);
+  AddTestCase (RangeSuiteHandle, "Empty maps pass", "EmptyMaps", EmptyMapsPass, ResetMaps, FreeMaps, NULL);
+  AddTestCase (RangeSuiteHandle, "Overlap between distant entries", "DistantOverlap", OverlapBetweenDistantEntriesIsFound, ResetMaps, FreeMaps, NULL);
+  AddTestCase (RangeSuiteHandle, "Shared starts are not overlaps", "SharedStarts", SharedStartsAreNotOverlaps, ResetMaps, FreeMaps, NULL);
+  AddTestCase (RangeSuiteHandle, "Deeply nested entries overlap", "DeepNesting", DeeplyNestedEntriesOverlap, ResetMaps, FreeMaps, NULL);
+  AddTestCase (RangeSuiteHandle, "Straddle hidden behind a wide entry", "HiddenStraddle", StraddleHiddenBehindWideEntryIsFound, ResetMaps, FreeMaps, NULL);
+  AddTestCase (RangeSuiteHandle, "MemoryMap entry straddling a MAT entry", "LegacyStraddle", LegacyStraddlingMatIsFound, ResetMaps, FreeMaps, NULL);
+  AddTestCase (RangeSuiteHandle, "Uncontained MAT entries", "Uncontained", UncontainedMatEntriesAreFound, ResetMaps, FreeMaps, NULL);
+  AddTestCase (RangeSuiteHandle, "Coverage gap", "CoverageGap", CoverageGapIsFound, ResetMaps, FreeMaps, NULL);
+  AddTestCase (RangeSuiteHandle, "Sweeps match the pairwise reference", "Reference", SweepsMatchPairwiseReference, ResetMaps, FreeMaps, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
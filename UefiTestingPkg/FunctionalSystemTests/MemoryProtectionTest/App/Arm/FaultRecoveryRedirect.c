@@ -0,0 +1,46 @@
+/** @file
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+
+#include "../FaultRecovery.h"
+
+/**
+  Reports whether same-boot recovery is implemented for this architecture.
+
+  @retval FALSE  Tests must reset the system on each expected fault.
+**/
+BOOLEAN
+FaultRecoveryIsSupported (
+  VOID
+  )
+{
+  return FALSE;
+}
+
+/**
+  Same-boot fault recovery is not implemented on ARM.  The tests fall back to resetting
+  the system on each expected fault.
+
+  @param[in] SystemContext  Processor context of the fault.
+  @param[in] Recovery       Fault recovery context that claimed the fault.
+  @param[in] Resume         Function to resume at.
+
+  @retval EFI_UNSUPPORTED  The architecture doesn't support recovery.
+**/
+EFI_STATUS
+FaultRecoveryRedirectContext (
+  IN EFI_SYSTEM_CONTEXT      SystemContext,
+  IN FAULT_RECOVERY_CONTEXT  *Recovery,
+  IN FAULT_RECOVERY_RESUME   Resume
+  )
+{
+  return EFI_UNSUPPORTED;
+}
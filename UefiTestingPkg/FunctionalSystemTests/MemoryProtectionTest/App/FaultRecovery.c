@@ -0,0 +1,152 @@
+/** @file -- FaultRecovery.c
+Recovers from expected page faults and general protection faults in the same boot.
+
+Copyright (C) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+
+#include "FaultRecovery.h"
+
+/**
+  Initializes a fault recovery context.
+
+  @param[out] Recovery  Context to initialize.
+**/
+VOID
+FaultRecoveryInit (
+  OUT FAULT_RECOVERY_CONTEXT  *Recovery
+  )
+{
+  ZeroMem (Recovery, sizeof (FAULT_RECOVERY_CONTEXT));
+  Recovery->State = FaultRecoveryIdle;
+}
+
+/**
+  Runs each step of a test, recovering from the fault each step is expected to trigger.
+
+  @param[in]  Recovery     Fault recovery context.
+  @param[in]  StepCount    Number of steps to run.
+  @param[in]  StepFn       Runs one step.
+  @param[in]  CleanupFn    Releases the resources of one step.  Optional.
+  @param[in]  Context      Context passed to StepFn and CleanupFn.
+  @param[out] MissedSteps  Bitmask of the steps that completed without faulting.
+
+  @retval EFI_SUCCESS            All steps ran.  Check MissedSteps for the result.
+  @retval EFI_INVALID_PARAMETER  A parameter is invalid, or StepCount is larger than FAULT_RECOVERY_MAX_STEPS.
+  @retval EFI_ALREADY_STARTED    A step is already running.
+  @retval Others                 Error returned by StepFn.  Recovery->Step is the step that failed.
+**/
+EFI_STATUS
+FaultRecoveryRunSteps (
+  IN  FAULT_RECOVERY_CONTEXT  *Recovery,
+  IN  UINTN                   StepCount,
+  IN  FAULT_RECOVERY_STEP     StepFn,
+  IN  FAULT_RECOVERY_CLEANUP  CleanupFn OPTIONAL,
+  IN  VOID                    *Context,
+  OUT UINT64                  *MissedSteps
+  )
+{
+  //
+  // Everything that has to survive the LongJump lives in Recovery or is volatile.
+  //
+  volatile EFI_STATUS  Status;
+
+  if ((Recovery == NULL) || (StepFn == NULL) || (MissedSteps == NULL) ||
+      (StepCount == 0) || (StepCount > FAULT_RECOVERY_MAX_STEPS))
+  {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (Recovery->State != FaultRecoveryIdle) {
+    return EFI_ALREADY_STARTED;
+  }
+
+  *MissedSteps = 0;
+  Status       = EFI_SUCCESS;
+
+  for (Recovery->Step = 0; Recovery->Step < StepCount; Recovery->Step++) {
+    Recovery->State = FaultRecoveryArmed;
+
+    if (SetJump (&Recovery->JumpBuffer) == 0) {
+      Status = StepFn (Context, Recovery->Step);
+
+      //
+      // Getting here means the step didn't fault.
+      //
+      Recovery->State = FaultRecoveryIdle;
+      if (!EFI_ERROR (Status)) {
+        *MissedSteps |= LShiftU64 (1, Recovery->Step);
+        DEBUG ((DEBUG_ERROR, "%a - Step %u completed without faulting.\n", __FUNCTION__, (UINT32)Recovery->Step));
+      }
+    } else {
+      //
+      // Resumed from the exception handler.
+      //
+      ASSERT (Recovery->State == FaultRecoveryCaught);
+      Recovery->State = FaultRecoveryIdle;
+      DEBUG ((DEBUG_INFO, "%a - Step %u faulted (exception 0x%lx) as expected.\n", __FUNCTION__, (UINT32)Recovery->Step, (UINT64)Recovery->LastFaultType));
+    }
+
+    if (CleanupFn != NULL) {
+      CleanupFn (Context, Recovery->Step);
+    }
+
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Claims a fault for the running step.  Called from the exception handler.
+
+  @param[in] Recovery       Fault recovery context.
+  @param[in] ExceptionType  Exception that occurred.
+
+  @retval TRUE   The fault was expected.  The handler must resume at FaultRecoveryResume.
+  @retval FALSE  No step is armed.  The fault must be handled some other way.
+**/
+BOOLEAN
+FaultRecoveryClaimException (
+  IN FAULT_RECOVERY_CONTEXT  *Recovery,
+  IN EFI_EXCEPTION_TYPE      ExceptionType
+  )
+{
+  //
+  // Only the first fault of an armed step is claimed.  A second fault before the recovery
+  // point is reached means the recovery path itself faulted.
+  //
+  if (Recovery->State != FaultRecoveryArmed) {
+    Recovery->UnexpectedFaults++;
+    return FALSE;
+  }
+
+  Recovery->State         = FaultRecoveryCaught;
+  Recovery->LastFaultType = ExceptionType;
+  Recovery->FaultsCaught++;
+
+  return TRUE;
+}
+
+/**
+  Resumes execution at the recovery point of the step that faulted.  Does not return.
+
+  @param[in] Recovery  Fault recovery context.
+**/
+VOID
+FaultRecoveryResume (
+  IN FAULT_RECOVERY_CONTEXT  *Recovery
+  )
+{
+  ASSERT (Recovery->State == FaultRecoveryCaught);
+  LongJump (&Recovery->JumpBuffer, 1);
+}
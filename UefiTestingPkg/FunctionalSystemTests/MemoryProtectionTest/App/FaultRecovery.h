@@ -0,0 +1,164 @@
+/** @file -- FaultRecovery.h
+Recovers from expected page faults and general protection faults in the same boot.
+
+A test is split into steps, each of which is expected to fault.  The step runs with the
+recovery state armed.  When the fault arrives, the exception handler claims it and resumes
+execution at the recovery point, which marks the step as caught and moves on to the next
+one.  A step that returns without faulting is recorded as missed.
+
+Copyright (C) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef _MEMORY_PROTECTION_FAULT_RECOVERY_H_
+#define _MEMORY_PROTECTION_FAULT_RECOVERY_H_
+
+#include <Library/BaseLib.h>
+#include <Protocol/DebugSupport.h>
+
+#define FAULT_RECOVERY_MAX_STEPS  64
+
+typedef enum {
+  FaultRecoveryIdle,                // No step is running.  Any fault is unexpected.
+  FaultRecoveryArmed,               // A step is running and is expected to fault.
+  FaultRecoveryCaught               // The step faulted and execution is resuming at the recovery point.
+} FAULT_RECOVERY_STATE;
+
+typedef struct {
+  FAULT_RECOVERY_STATE        State;
+  UINTN                       Step;             // Step currently (or last) run.
+  UINTN                       FaultsCaught;     // Expected faults claimed since the context was initialized.
+  UINTN                       UnexpectedFaults; // Faults that arrived while no step was armed.
+  EFI_EXCEPTION_TYPE          LastFaultType;    // Exception type of the last claimed fault.
+  BASE_LIBRARY_JUMP_BUFFER    JumpBuffer;       // Recovery point of the running step.
+} FAULT_RECOVERY_CONTEXT;
+
+/**
+  Runs a single step of a test.  The step is expected to fault.
+
+  @param[in] Context  Context passed to FaultRecoveryRunSteps.
+  @param[in] Step     Index of the step to run.
+
+  @retval EFI_SUCCESS  The step ran to completion without faulting.
+  @retval Others       The step could not be run.  Remaining steps are abandoned.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *FAULT_RECOVERY_STEP)(
+  IN VOID   *Context,
+  IN UINTN  Step
+  );
+
+/**
+  Releases whatever a step allocated.  Called after every step, whether it faulted or not.
+
+  @param[in] Context  Context passed to FaultRecoveryRunSteps.
+  @param[in] Step     Index of the step that ran.
+**/
+typedef
+VOID
+(EFIAPI *FAULT_RECOVERY_CLEANUP)(
+  IN VOID   *Context,
+  IN UINTN  Step
+  );
+
+/**
+  Function the exception handler returns to in order to resume at the recovery point.
+**/
+typedef
+VOID
+(EFIAPI *FAULT_RECOVERY_RESUME)(
+  VOID
+  );
+
+/**
+  Initializes a fault recovery context.
+
+  @param[out] Recovery  Context to initialize.
+**/
+VOID
+FaultRecoveryInit (
+  OUT FAULT_RECOVERY_CONTEXT  *Recovery
+  );
+
+/**
+  Runs each step of a test, recovering from the fault each step is expected to trigger.
+
+  @param[in]  Recovery     Fault recovery context.
+  @param[in]  StepCount    Number of steps to run.
+  @param[in]  StepFn       Runs one step.
+  @param[in]  CleanupFn    Releases the resources of one step.  Optional.
+  @param[in]  Context      Context passed to StepFn and CleanupFn.
+  @param[out] MissedSteps  Bitmask of the steps that completed without faulting.
+
+  @retval EFI_SUCCESS            All steps ran.  Check MissedSteps for the result.
+  @retval EFI_INVALID_PARAMETER  A parameter is invalid, or StepCount is larger than FAULT_RECOVERY_MAX_STEPS.
+  @retval EFI_ALREADY_STARTED    A step is already running.
+  @retval Others                 Error returned by StepFn.  Recovery->Step is the step that failed.
+**/
+EFI_STATUS
+FaultRecoveryRunSteps (
+  IN  FAULT_RECOVERY_CONTEXT  *Recovery,
+  IN  UINTN                   StepCount,
+  IN  FAULT_RECOVERY_STEP     StepFn,
+  IN  FAULT_RECOVERY_CLEANUP  CleanupFn OPTIONAL,
+  IN  VOID                    *Context,
+  OUT UINT64                  *MissedSteps
+  );
+
+/**
+  Claims a fault for the running step.  Called from the exception handler.
+
+  @param[in] Recovery       Fault recovery context.
+  @param[in] ExceptionType  Exception that occurred.
+
+  @retval TRUE   The fault was expected.  The handler must resume at FaultRecoveryResume.
+  @retval FALSE  No step is armed.  The fault must be handled some other way.
+**/
+BOOLEAN
+FaultRecoveryClaimException (
+  IN FAULT_RECOVERY_CONTEXT  *Recovery,
+  IN EFI_EXCEPTION_TYPE      ExceptionType
+  );
+
+/**
+  Resumes execution at the recovery point of the step that faulted.  Does not return.
+
+  @param[in] Recovery  Fault recovery context.
+**/
+VOID
+FaultRecoveryResume (
+  IN FAULT_RECOVERY_CONTEXT  *Recovery
+  );
+
+/**
+  Reports whether same-boot recovery is implemented for this architecture.
+
+  @retval TRUE   FaultRecoveryRedirectContext is implemented.
+  @retval FALSE  Tests must reset the system on each expected fault.
+**/
+BOOLEAN
+FaultRecoveryIsSupported (
+  VOID
+  );
+
+/**
+  Modifies the interrupted context so that returning from the exception handler calls Resume
+  on the stack of the recovery point.  Implemented per architecture.
+
+  @param[in] SystemContext  Processor context of the fault.
+  @param[in] Recovery       Fault recovery context that claimed the fault.
+  @param[in] Resume         Function to resume at.
+
+  @retval EFI_SUCCESS      The context now resumes at Resume.
+  @retval EFI_UNSUPPORTED  The architecture doesn't support recovery.
+**/
+EFI_STATUS
+FaultRecoveryRedirectContext (
+  IN EFI_SYSTEM_CONTEXT      SystemContext,
+  IN FAULT_RECOVERY_CONTEXT  *Recovery,
+  IN FAULT_RECOVERY_RESUME   Resume
+  );
+
+#endif // _MEMORY_PROTECTION_FAULT_RECOVERY_H_
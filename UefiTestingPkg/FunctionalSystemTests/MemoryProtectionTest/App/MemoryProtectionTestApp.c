@@ -40,12 +40,28 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 
 #include "../MemoryProtectionTestCommon.h"
 #include "UefiHardwareNxProtectionStub.h"
+#include "FaultRecovery.h"
 
 #define UNIT_TEST_APP_NAME     "Heap Guard Test"
 #define UNIT_TEST_APP_VERSION  "0.5"
 
 #define DUMMY_FUNCTION_FOR_CODE_SELF_TEST_GENERIC_SIZE  512
 
+//
+// TestProgress of a test running in recovery mode.  Seeing it on entry means the system
+// reset while the test was recovering from an expected fault.
+//
+#define RECOVERY_TEST_IN_PROGRESS  MAX_UINT64
+
+//
+// State shared by the steps of a test running in recovery mode.
+//
+typedef struct {
+  MEMORY_PROTECTION_TEST_CONTEXT    *TestContext;
+  EFI_PHYSICAL_ADDRESS              Pages;        // Page allocation of the current step, if any.
+  VOID                              *Pool;        // Pool allocation of the current step, if any.
+} RECOVERY_STEP_CONTEXT;
+
 VOID                                     *mPiSmmCommonCommBufferAddress = NULL;
 UINTN                                    mPiSmmCommonCommBufferSize;
 EFI_CPU_ARCH_PROTOCOL                    *mCpu = NULL;
@@ -53,6 +69,10 @@ MM_MEMORY_PROTECTION_SETTINGS            mMmMps;
 DXE_MEMORY_PROTECTION_SETTINGS           mDxeMps;
 MEMORY_PROTECTION_NONSTOP_MODE_PROTOCOL  *mNonstopModeProtocol      = NULL;
 MEMORY_PROTECTION_DEBUG_PROTOCOL         *mMemoryProtectionProtocol = NULL;
+FAULT_RECOVERY_CONTEXT                   mFaultRecovery;
+BOOLEAN                                  mRecoveryActive      = FALSE;
+BOOLEAN                                  mRecoveryOwnsGpFault = FALSE;
+volatile UNIT_TEST_FRAMEWORK             *mFw                 = NULL;
 
 /// ================================================================================================
 /// ================================================================================================
@@ -257,6 +277,88 @@ InterruptHandler (
   ResetWarm ();
 } // InterruptHandler()
 
+/**
+  Resumes the test that faulted at its recovery point.  The exception handler returns here.
+**/
+STATIC
+VOID
+EFIAPI
+RecoveryResume (
+  VOID
+  )
+{
+  FaultRecoveryResume (&mFaultRecovery);
+} // RecoveryResume()
+
+/**
+  Recovers from an expected fault, or resets the system on any other fault.
+
+  @param  InterruptType    Defines the type of interrupt or exception that
+                           occurred on the processor.This parameter is processor architecture specific.
+  @param  SystemContext    A pointer to the processor context when
+                           the interrupt occurred on the processor.
+**/
+VOID
+EFIAPI
+RecoveryInterruptHandler (
+  IN EFI_EXCEPTION_TYPE  InterruptType,
+  IN EFI_SYSTEM_CONTEXT  SystemContext
+  )
+{
+  if (FaultRecoveryClaimException (&mFaultRecovery, InterruptType) &&
+      !EFI_ERROR (FaultRecoveryRedirectContext (SystemContext, &mFaultRecovery, RecoveryResume)))
+  {
+    return;
+  }
+
+  ResetWarm ();
+} // RecoveryInterruptHandler()
+
+/**
+  Replaces the reset-on-fault handler with the recovery handler for page faults and, if no
+  other handler owns it, general protection faults.
+
+  @retval EFI_SUCCESS   The recovery handler is installed.
+  @retval other         The page fault handler could not be replaced.
+**/
+STATIC
+EFI_STATUS
+InstallRecoveryHandlers (
+  VOID
+  )
+{
+  EFI_STATUS  Status;
+
+  mCpu->RegisterInterruptHandler (mCpu, EXCEPT_IA32_PAGE_FAULT, NULL);
+  Status = mCpu->RegisterInterruptHandler (mCpu, EXCEPT_IA32_PAGE_FAULT, RecoveryInterruptHandler);
+  if (EFI_ERROR (Status)) {
+    mCpu->RegisterInterruptHandler (mCpu, EXCEPT_IA32_PAGE_FAULT, InterruptHandler);
+    return Status;
+  }
+
+  mRecoveryOwnsGpFault = !EFI_ERROR (mCpu->RegisterInterruptHandler (mCpu, EXCEPT_IA32_GP_FAULT, RecoveryInterruptHandler));
+
+  return EFI_SUCCESS;
+} // InstallRecoveryHandlers()
+
+/**
+  Puts the reset-on-fault page fault handler back and removes the recovery handlers.
+**/
+STATIC
+VOID
+RemoveRecoveryHandlers (
+  VOID
+  )
+{
+  mCpu->RegisterInterruptHandler (mCpu, EXCEPT_IA32_PAGE_FAULT, NULL);
+  mCpu->RegisterInterruptHandler (mCpu, EXCEPT_IA32_PAGE_FAULT, InterruptHandler);
+
+  if (mRecoveryOwnsGpFault) {
+    mCpu->RegisterInterruptHandler (mCpu, EXCEPT_IA32_GP_FAULT, NULL);
+    mRecoveryOwnsGpFault = FALSE;
+  }
+} // RemoveRecoveryHandlers()
+
 /**
   This helper function returns EFI_SUCCESS if the Nonstop protocol is installed.
 
@@ -468,6 +570,38 @@ Recursion (
   return Sum + Count;
 }
 
+/**
+  Infinite recursion that does not print.  Used by the recovery test, which
+  LongJumps out of the stack overflow; a DEBUG print interrupted there would
+  leave the DebugLib and serial port state (and any locks they hold) behind.
+
+  @param[in] Count  Recursion depth.
+
+  @retval Sum of the depths, never reached.
+**/
+STATIC
+UINT64
+RecursionSilent (
+  UINT64  Count
+  )
+{
+  UINT64            Sum            = 0;
+  volatile UINT8    Frame[64];
+  volatile BOOLEAN  AlwaysTrueBool = TRUE;
+
+  //
+  // Touch a buffer in every frame so each level uses stack the compiler cannot elide.
+  //
+  Frame[0]                      = (UINT8)Count;
+  Frame[ARRAY_SIZE (Frame) - 1] = (UINT8)Count;
+
+  if (AlwaysTrueBool) {
+    Sum = RecursionSilent (++Count);
+  }
+
+  return Sum + Count + Frame[0] + Frame[ARRAY_SIZE (Frame) - 1];
+}
+
 STATIC
 UINT64
 RecursionDynamic (
@@ -571,6 +705,251 @@ DummyFunctionForCodeSelfTest (
   return;
 } // DummyFunctionForCodeSelfTest()
 
+/// ================================================================================================
+/// ================================================================================================
+///
+/// RECOVERY MODE STEPS
+///
+/// ================================================================================================
+/// ================================================================================================
+
+/**
+  Frees the allocation made by a recovery step.
+
+  @param[in] Context  RECOVERY_STEP_CONTEXT of the test.
+  @param[in] Step     Index of the step that ran.
+**/
+STATIC
+VOID
+EFIAPI
+RecoveryStepCleanup (
+  IN VOID   *Context,
+  IN UINTN  Step
+  )
+{
+  RECOVERY_STEP_CONTEXT  *StepContext = (RECOVERY_STEP_CONTEXT *)Context;
+
+  if (StepContext->Pages != 0) {
+    gBS->FreePages (StepContext->Pages, 1);
+    StepContext->Pages = 0;
+  }
+
+  if (StepContext->Pool != NULL) {
+    gBS->FreePool (StepContext->Pool);
+    StepContext->Pool = NULL;
+  }
+} // RecoveryStepCleanup()
+
+/**
+  Step 0 hits the head guard page and step 1 hits the tail guard page of a page allocation.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+PageGuardStep (
+  IN VOID   *Context,
+  IN UINTN  Step
+  )
+{
+  RECOVERY_STEP_CONTEXT  *StepContext = (RECOVERY_STEP_CONTEXT *)Context;
+  EFI_STATUS             Status;
+
+  Status = gBS->AllocatePages (AllocateAnyPages, (EFI_MEMORY_TYPE)StepContext->TestContext->TargetMemoryType, 1, &StepContext->Pages);
+  if (EFI_ERROR (Status)) {
+    StepContext->Pages = 0;
+    return Status;
+  }
+
+  DEBUG ((DEBUG_INFO, "%a - Allocated page at 0x%p\n", __FUNCTION__, StepContext->Pages));
+
+  if (Step == 0) {
+    HeadPageTest ((UINT64 *)(UINTN)StepContext->Pages);
+  } else {
+    TailPageTest ((UINT64 *)(UINTN)StepContext->Pages);
+  }
+
+  return EFI_SUCCESS;
+} // PageGuardStep()
+
+/**
+  Each step hits the guard page of a pool allocation of the next size in mPoolSizeTable.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+PoolGuardStep (
+  IN VOID   *Context,
+  IN UINTN  Step
+  )
+{
+  RECOVERY_STEP_CONTEXT  *StepContext = (RECOVERY_STEP_CONTEXT *)Context;
+  EFI_STATUS             Status;
+
+  Status = gBS->AllocatePool ((EFI_MEMORY_TYPE)StepContext->TestContext->TargetMemoryType, mPoolSizeTable[Step], &StepContext->Pool);
+  if (EFI_ERROR (Status)) {
+    StepContext->Pool = NULL;
+    return Status;
+  }
+
+  PoolTest ((UINT64 *)StepContext->Pool, mPoolSizeTable[Step]);
+
+  return EFI_SUCCESS;
+} // PoolGuardStep()
+
+/**
+  Overflows the stack.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+StackGuardStep (
+  IN VOID   *Context,
+  IN UINTN  Step
+  )
+{
+  RecursionSilent (1);
+
+  return EFI_SUCCESS;
+} // StackGuardStep()
+
+/**
+  Step 0 reads through a NULL pointer and step 1 writes through it.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+NullPointerStep (
+  IN VOID   *Context,
+  IN UINTN  Step
+  )
+{
+  if (Step == 0) {
+    if (mFw->Title == NULL) {
+      DEBUG ((DEBUG_ERROR, "%a - Should have failed \n", __FUNCTION__));
+    }
+  } else {
+    mFw->Title = "Title";
+  }
+
+  return EFI_SUCCESS;
+} // NullPointerStep()
+
+/**
+  Executes code copied to the stack.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+NxStackStep (
+  IN VOID   *Context,
+  IN UINTN  Step
+  )
+{
+  UINT8  CodeRegionToCopyTo[DUMMY_FUNCTION_FOR_CODE_SELF_TEST_GENERIC_SIZE];
+
+  CopyMem (CodeRegionToCopyTo, (UINT8 *)DummyFunctionForCodeSelfTest, DUMMY_FUNCTION_FOR_CODE_SELF_TEST_GENERIC_SIZE);
+  ((DUMMY_VOID_FUNCTION_FOR_DATA_TEST)CodeRegionToCopyTo)();
+
+  return EFI_SUCCESS;
+} // NxStackStep()
+
+/**
+  Executes code copied to a pool allocation of the target memory type.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+NxProtectionStep (
+  IN VOID   *Context,
+  IN UINTN  Step
+  )
+{
+  RECOVERY_STEP_CONTEXT  *StepContext = (RECOVERY_STEP_CONTEXT *)Context;
+  EFI_STATUS             Status;
+
+  Status = gBS->AllocatePool ((EFI_MEMORY_TYPE)StepContext->TestContext->TargetMemoryType, EFI_PAGE_SIZE, &StepContext->Pool);
+  if (EFI_ERROR (Status)) {
+    StepContext->Pool = NULL;
+    return Status;
+  }
+
+  CopyMem (StepContext->Pool, (UINT8 *)DummyFunctionForCodeSelfTest, DUMMY_FUNCTION_FOR_CODE_SELF_TEST_GENERIC_SIZE);
+  ((DUMMY_VOID_FUNCTION_FOR_DATA_TEST)StepContext->Pool)();
+
+  return EFI_SUCCESS;
+} // NxProtectionStep()
+
+/**
+  Runs the steps of a test in recovery mode.  Every step must fault.
+
+  @param[in] MemoryProtectionContext  Context of the test.
+  @param[in] StepCount                Number of steps in the test.
+  @param[in] StepFn                   Runs one step.
+  @param[in] TestName                 Name used when logging a step that didn't fault.
+
+  @retval UNIT_TEST_PASSED              Every step faulted.
+  @retval UNIT_TEST_SKIPPED             A step couldn't allocate the memory it tests.
+  @retval UNIT_TEST_ERROR_TEST_FAILED   A step didn't fault, or the system reset during the test.
+**/
+STATIC
+UNIT_TEST_STATUS
+RunRecoveryTest (
+  IN MEMORY_PROTECTION_TEST_CONTEXT  *MemoryProtectionContext,
+  IN UINTN                           StepCount,
+  IN FAULT_RECOVERY_STEP             StepFn,
+  IN CONST CHAR8                     *TestName
+  )
+{
+  RECOVERY_STEP_CONTEXT  StepContext;
+  EFI_STATUS             Status;
+  UINT64                 MissedSteps;
+  UINTN                  Index;
+
+  if (MemoryProtectionContext->TestProgress == RECOVERY_TEST_IN_PROGRESS) {
+    UT_LOG_ERROR ("%a: the system reset instead of recovering from an expected fault.", TestName);
+    MemoryProtectionContext->TestProgress = 0;
+    SaveFrameworkState (MemoryProtectionContext, sizeof (MEMORY_PROTECTION_TEST_CONTEXT));
+    return UNIT_TEST_ERROR_TEST_FAILED;
+  }
+
+  Status = InstallRecoveryHandlers ();
+  if (EFI_ERROR (Status)) {
+    UT_LOG_ERROR ("%a: failed to install the recovery handler - %r", TestName, Status);
+    return UNIT_TEST_ERROR_TEST_FAILED;
+  }
+
+  //
+  // Save our progress once for the whole test.  If recovery doesn't work on this system, the
+  // test is reported as failed the next time the framework runs instead of being run again.
+  //
+  MemoryProtectionContext->TestProgress = RECOVERY_TEST_IN_PROGRESS;
+  SaveFrameworkState (MemoryProtectionContext, sizeof (MEMORY_PROTECTION_TEST_CONTEXT));
+
+  ZeroMem (&StepContext, sizeof (StepContext));
+  StepContext.TestContext = MemoryProtectionContext;
+
+  Status = FaultRecoveryRunSteps (&mFaultRecovery, StepCount, StepFn, RecoveryStepCleanup, &StepContext, &MissedSteps);
+  RemoveRecoveryHandlers ();
+
+  MemoryProtectionContext->TestProgress = 0;
+  SaveFrameworkState (MemoryProtectionContext, sizeof (MEMORY_PROTECTION_TEST_CONTEXT));
+
+  if (EFI_ERROR (Status)) {
+    UT_LOG_WARNING ("%a: step %u could not run for type %a - %r\n", TestName, (UINT32)mFaultRecovery.Step, MEMORY_TYPES[MemoryProtectionContext->TargetMemoryType], Status);
+    return UNIT_TEST_SKIPPED;
+  }
+
+  for (Index = 0; Index < StepCount; Index++) {
+    if ((MissedSteps & LShiftU64 (1, Index)) != 0) {
+      UT_LOG_ERROR ("%a failed: step %u of %u did not fault.", TestName, (UINT32)(Index + 1), (UINT32)StepCount);
+    }
+  }
+
+  UT_ASSERT_EQUAL (MissedSteps, 0);
+
+  return UNIT_TEST_PASSED;
+} // RunRecoveryTest()
+
 /// ================================================================================================
 /// ================================================================================================
 ///
@@ -881,6 +1260,10 @@ UefiPageGuard (
     return UNIT_TEST_PASSED;
   }
 
+  if (MemoryProtectionContext.RecoveryActive) {
+    return RunRecoveryTest (&MemoryProtectionContext, 2, PageGuardStep, "Page guard");
+  }
+
   if (MemoryProtectionContext.TestProgress < 2) {
     //
     // Context.TestProgress indicates progress within this specific test.
@@ -985,6 +1368,10 @@ UefiPoolGuard (
     return UNIT_TEST_PASSED;
   }
 
+  if (MemoryProtectionContext.RecoveryActive) {
+    return RunRecoveryTest (&MemoryProtectionContext, NUM_POOL_SIZES, PoolGuardStep, "Pool guard");
+  }
+
   if (MemoryProtectionContext.TestProgress < NUM_POOL_SIZES) {
     //
     // Context.TestProgress indicates progress within this specific test.
@@ -1050,6 +1437,10 @@ UefiCpuStackGuard (
     return UNIT_TEST_PASSED;
   }
 
+  if (MemoryProtectionContext.RecoveryActive) {
+    return RunRecoveryTest (&MemoryProtectionContext, 1, StackGuardStep, "Stack guard");
+  }
+
   if (MemoryProtectionContext.TestProgress < 1) {
     //
     // Context.TestProgress 0 indicates the test hasn't started yet.
@@ -1075,7 +1466,6 @@ UefiCpuStackGuard (
   return UNIT_TEST_PASSED;
 } // UefiCpuStackGuard()
 
-volatile UNIT_TEST_FRAMEWORK  *mFw = NULL;
 UNIT_TEST_STATUS
 EFIAPI
 UefiNullPointerDetection (
@@ -1120,6 +1510,10 @@ UefiNullPointerDetection (
     return UNIT_TEST_PASSED;
   }
 
+  if (MemoryProtectionContext.RecoveryActive) {
+    return RunRecoveryTest (&MemoryProtectionContext, 2, NullPointerStep, "NULL pointer detection");
+  }
+
   if (MemoryProtectionContext.TestProgress < 2) {
     //
     // Context.TestProgress indicates progress within this specific test.
@@ -1184,6 +1578,10 @@ UefiNxStackGuard (
     return UNIT_TEST_PASSED;
   }
 
+  if (MemoryProtectionContext.RecoveryActive) {
+    return RunRecoveryTest (&MemoryProtectionContext, 1, NxStackStep, "NX stack guard");
+  }
+
   if (MemoryProtectionContext.TestProgress < 1) {
     //
     // Context.TestProgress 0 indicates the test hasn't started yet.
@@ -1249,6 +1647,10 @@ UefiNxProtection (
     return UNIT_TEST_PASSED;
   }
 
+  if (MemoryProtectionContext.RecoveryActive) {
+    return RunRecoveryTest (&MemoryProtectionContext, 1, NxProtectionStep, "NX protection");
+  }
+
   if (MemoryProtectionContext.TestProgress < 1) {
     //
     // Context.TestProgress 0 indicates the test hasn't started yet.
@@ -1559,6 +1961,7 @@ AddUefiNxTest (
     MemoryProtectionContext->TargetMemoryType = Index;
     MemoryProtectionContext->GuardAlignment   = mDxeMps.HeapGuardPolicy.Fields.Direction;
     MemoryProtectionContext->DynamicActive    = Dynamic;
+    MemoryProtectionContext->RecoveryActive   = mRecoveryActive;
 
     TestNameSize = sizeof (CHAR8) * (1 + AsciiStrnLenS (NameStub, UNIT_TEST_MAX_STRING_LENGTH) + AsciiStrnLenS (MEMORY_TYPES[Index], UNIT_TEST_MAX_STRING_LENGTH));
     TestName     = AllocateZeroPool (TestNameSize);
@@ -1623,6 +2026,7 @@ AddUefiPoolTest (
     MemoryProtectionContext->TargetMemoryType = Index;
     MemoryProtectionContext->GuardAlignment   = mDxeMps.HeapGuardPolicy.Fields.Direction;
     MemoryProtectionContext->DynamicActive    = Dynamic;
+    MemoryProtectionContext->RecoveryActive   = mRecoveryActive;
 
     //
     // Name of the test is Security.PoolGuard.Uefi + Memory Type Name (from MEMORY_TYPES)
@@ -1687,6 +2091,7 @@ AddUefiPageTest (
     MemoryProtectionContext->TargetMemoryType = Index;
     MemoryProtectionContext->GuardAlignment   = mDxeMps.HeapGuardPolicy.Fields.Direction;
     MemoryProtectionContext->DynamicActive    = Dynamic;
+    MemoryProtectionContext->RecoveryActive   = mRecoveryActive;
 
     TestNameSize = sizeof (CHAR8) * (1 + AsciiStrnLenS (NameStub, UNIT_TEST_MAX_STRING_LENGTH) + AsciiStrnLenS (MEMORY_TYPES[Index], UNIT_TEST_MAX_STRING_LENGTH));
     TestName     = (CHAR8 *)AllocateZeroPool (TestNameSize);
@@ -1926,6 +2331,14 @@ MemoryProtectionTestAppEntryPoint (
       DEBUG ((DEBUG_ERROR, "Failed to install interrupt handler. Status = %r\n", Status));
       goto EXIT;
     }
+
+    // Recover from the expected faults of the UEFI tests in the same boot instead of
+    // rebooting after each one. Unexpected faults still reboot.
+    if (FaultRecoveryIsSupported ()) {
+      FaultRecoveryInit (&mFaultRecovery);
+      mRecoveryActive                         = TRUE;
+      MemoryProtectionContext->RecoveryActive = TRUE;
+    }
   }
 
   AddUefiPoolTest (PoolGuard);
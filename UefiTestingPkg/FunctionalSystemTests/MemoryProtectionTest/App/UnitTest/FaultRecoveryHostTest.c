@@ -0,0 +1,404 @@
+/** @file
+  Host based unit tests for the MemoryProtectionTestApp fault recovery state machine.
+
+  A simulated fault injector stands in for the page fault and #GP handler: a step that is
+  expected to fault hands the fault to FaultRecoveryClaimException and resumes at the
+  recovery point, exactly as the exception handler does on hardware.
+
+  Copyright (c) Microsoft Corporation
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/UnitTestLib.h>
+#include "../FaultRecovery.h"
+
+#define UNIT_TEST_NAME     "MemoryProtectionTestApp Fault Recovery Host Test"
+#define UNIT_TEST_VERSION  "0.1"
+
+#define INJECTOR_FAULT_DEPTH  8
+#define NUM_MEMORY_TYPES      15
+#define NUM_POOL_SIZES        13
+
+typedef struct {
+  UINT64        GuardedSteps;                          // Steps whose access faults.
+  UINT64        GpFaultSteps;                          // Faulting steps that raise #GP instead of #PF.
+  UINTN         FailStep;                              // Step that returns FailStatus (MAX_UINTN for none).
+  EFI_STATUS    FailStatus;
+  UINTN         StepSequence[FAULT_RECOVERY_MAX_STEPS];
+  UINTN         StepCount;
+  UINTN         CleanupSequence[FAULT_RECOVERY_MAX_STEPS];
+  UINTN         CleanupCount;
+  BOOLEAN       Allocated;                             // A step's simulated allocation is outstanding.
+  UINTN         Resets;                                // Faults the handler would have reset the system for.
+} FAULT_INJECTOR;
+
+STATIC FAULT_RECOVERY_CONTEXT  mRecovery;
+STATIC FAULT_INJECTOR          mInjector;
+
+/**
+  Simulated exception handler.  Returns only if the fault was not claimed.
+**/
+STATIC
+VOID
+InjectFault (
+  IN EFI_EXCEPTION_TYPE  ExceptionType
+  )
+{
+  if (FaultRecoveryClaimException (&mRecovery, ExceptionType)) {
+    FaultRecoveryResume (&mRecovery);
+  }
+
+  mInjector.Resets++;
+}
+
+/**
+  Touches the simulated guard page a few frames down so that recovery unwinds a real stack.
+**/
+STATIC
+VOID
+SimulatedAccess (
+  IN UINTN  Step,
+  IN UINTN  Depth
+  )
+{
+  volatile UINTN  Frame[4];
+
+  Frame[0] = Step;
+  if (Depth > 0) {
+    SimulatedAccess (Step, Depth - 1);
+    return;
+  }
+
+  if ((mInjector.GuardedSteps & LShiftU64 (1, Frame[0])) != 0) {
+    InjectFault (((mInjector.GpFaultSteps & LShiftU64 (1, Frame[0])) != 0) ? EXCEPT_IA32_GP_FAULT : EXCEPT_IA32_PAGE_FAULT);
+  }
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+InjectorStep (
+  IN VOID   *Context,
+  IN UINTN  Step
+  )
+{
+  FAULT_INJECTOR  *Injector = (FAULT_INJECTOR *)Context;
+
+  Injector->StepSequence[Injector->StepCount++] = Step;
+
+  if (Step == Injector->FailStep) {
+    return Injector->FailStatus;
+  }
+
+  Injector->Allocated = TRUE;
+  SimulatedAccess (Step, INJECTOR_FAULT_DEPTH);
+
+  return EFI_SUCCESS;
+}
+
+STATIC
+VOID
+EFIAPI
+InjectorCleanup (
+  IN VOID   *Context,
+  IN UINTN  Step
+  )
+{
+  FAULT_INJECTOR  *Injector = (FAULT_INJECTOR *)Context;
+
+  Injector->CleanupSequence[Injector->CleanupCount++] = Step;
+  Injector->Allocated                                 = FALSE;
+}
+
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+ResetInjector (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  FaultRecoveryInit (&mRecovery);
+  ZeroMem (&mInjector, sizeof (mInjector));
+  mInjector.FailStep = MAX_UINTN;
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Every step faults: all of them are caught in order and cleaned up.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+AllStepsFault (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT64  MissedSteps;
+  UINTN   Index;
+
+  mInjector.GuardedSteps = LShiftU64 (1, NUM_POOL_SIZES) - 1;
+
+  UT_ASSERT_NOT_EFI_ERROR (FaultRecoveryRunSteps (&mRecovery, NUM_POOL_SIZES, InjectorStep, InjectorCleanup, &mInjector, &MissedSteps));
+
+  UT_ASSERT_EQUAL (MissedSteps, 0);
+  UT_ASSERT_EQUAL (mRecovery.FaultsCaught, NUM_POOL_SIZES);
+  UT_ASSERT_EQUAL (mRecovery.UnexpectedFaults, 0);
+  UT_ASSERT_EQUAL (mRecovery.State, FaultRecoveryIdle);
+  UT_ASSERT_EQUAL (mInjector.StepCount, NUM_POOL_SIZES);
+  UT_ASSERT_EQUAL (mInjector.CleanupCount, NUM_POOL_SIZES);
+  UT_ASSERT_FALSE (mInjector.Allocated);
+  UT_ASSERT_EQUAL (mInjector.Resets, 0);
+
+  for (Index = 0; Index < NUM_POOL_SIZES; Index++) {
+    UT_ASSERT_EQUAL (mInjector.StepSequence[Index], Index);
+    UT_ASSERT_EQUAL (mInjector.CleanupSequence[Index], Index);
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Steps that don't fault are recorded as missed and the remaining steps still run.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+MissedStepsAreRecorded (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT64  MissedSteps;
+
+  mInjector.GuardedSteps = BIT0 | BIT2 | BIT3 | BIT5;
+
+  UT_ASSERT_NOT_EFI_ERROR (FaultRecoveryRunSteps (&mRecovery, 6, InjectorStep, InjectorCleanup, &mInjector, &MissedSteps));
+
+  UT_ASSERT_EQUAL (MissedSteps, BIT1 | BIT4);
+  UT_ASSERT_EQUAL (mRecovery.FaultsCaught, 4);
+  UT_ASSERT_EQUAL (mInjector.StepCount, 6);
+  UT_ASSERT_EQUAL (mInjector.CleanupCount, 6);
+  UT_ASSERT_FALSE (mInjector.Allocated);
+  UT_ASSERT_EQUAL (mRecovery.State, FaultRecoveryIdle);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  A step that can't run stops the test after its cleanup.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+StepErrorStopsTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT64  MissedSteps;
+
+  mInjector.GuardedSteps = MAX_UINT64;
+  mInjector.FailStep     = 2;
+  mInjector.FailStatus   = EFI_OUT_OF_RESOURCES;
+
+  UT_ASSERT_STATUS_EQUAL (
+    FaultRecoveryRunSteps (&mRecovery, 5, InjectorStep, InjectorCleanup, &mInjector, &MissedSteps),
+    EFI_OUT_OF_RESOURCES
+    );
+
+  UT_ASSERT_EQUAL (mRecovery.Step, 2);
+  UT_ASSERT_EQUAL (MissedSteps, 0);
+  UT_ASSERT_EQUAL (mRecovery.FaultsCaught, 2);
+  UT_ASSERT_EQUAL (mInjector.StepCount, 3);
+  UT_ASSERT_EQUAL (mInjector.CleanupCount, 3);
+  UT_ASSERT_EQUAL (mRecovery.State, FaultRecoveryIdle);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Faults outside of an armed step are left to the reset handler.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+UnarmedFaultIsNotClaimed (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT64  MissedSteps;
+
+  InjectFault (EXCEPT_IA32_PAGE_FAULT);
+  UT_ASSERT_EQUAL (mInjector.Resets, 1);
+  UT_ASSERT_EQUAL (mRecovery.UnexpectedFaults, 1);
+
+  mInjector.GuardedSteps = BIT0;
+  UT_ASSERT_NOT_EFI_ERROR (FaultRecoveryRunSteps (&mRecovery, 1, InjectorStep, InjectorCleanup, &mInjector, &MissedSteps));
+
+  // Same as a fault raised by the cleanup of a step.
+  InjectFault (EXCEPT_IA32_GP_FAULT);
+  UT_ASSERT_EQUAL (mInjector.Resets, 2);
+  UT_ASSERT_EQUAL (mRecovery.UnexpectedFaults, 2);
+  UT_ASSERT_EQUAL (mRecovery.FaultsCaught, 1);
+
+  // A second fault while the first is being recovered is not claimed either.
+  mRecovery.State = FaultRecoveryCaught;
+  UT_ASSERT_FALSE (FaultRecoveryClaimException (&mRecovery, EXCEPT_IA32_PAGE_FAULT));
+  UT_ASSERT_EQUAL (mRecovery.UnexpectedFaults, 3);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Runs the page and pool guard steps of every memory type back to back, as one boot would.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+MemoryTypeMatrixInOnePass (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT64  MissedSteps;
+  UINTN   Type;
+  UINTN   Expected;
+
+  Expected = 0;
+
+  for (Type = 0; Type < NUM_MEMORY_TYPES; Type++) {
+    // Page guard: head and tail.  Type 3 is missing its tail guard.
+    ZeroMem (&mInjector, sizeof (mInjector));
+    mInjector.FailStep     = MAX_UINTN;
+    mInjector.GuardedSteps = (Type == 3) ? BIT0 : (BIT0 | BIT1);
+    mInjector.GpFaultSteps = BIT1;
+
+    UT_ASSERT_NOT_EFI_ERROR (FaultRecoveryRunSteps (&mRecovery, 2, InjectorStep, InjectorCleanup, &mInjector, &MissedSteps));
+    UT_ASSERT_EQUAL (MissedSteps, (Type == 3) ? BIT1 : 0);
+    Expected += (Type == 3) ? 1 : 2;
+
+    // Pool guard: every pool size.
+    ZeroMem (&mInjector, sizeof (mInjector));
+    mInjector.FailStep     = MAX_UINTN;
+    mInjector.GuardedSteps = LShiftU64 (1, NUM_POOL_SIZES) - 1;
+
+    UT_ASSERT_NOT_EFI_ERROR (FaultRecoveryRunSteps (&mRecovery, NUM_POOL_SIZES, InjectorStep, InjectorCleanup, &mInjector, &MissedSteps));
+    UT_ASSERT_EQUAL (MissedSteps, 0);
+    UT_ASSERT_EQUAL (mRecovery.LastFaultType, EXCEPT_IA32_PAGE_FAULT);
+    Expected += NUM_POOL_SIZES;
+  }
+
+  UT_ASSERT_EQUAL (mRecovery.FaultsCaught, Expected);
+  UT_ASSERT_EQUAL (mRecovery.UnexpectedFaults, 0);
+  UT_ASSERT_EQUAL (mRecovery.State, FaultRecoveryIdle);
+
+  return UNIT_TEST_PASSED;
+}
+
+STATIC
+EFI_STATUS
+EFIAPI
+NestedRunStep (
+  IN VOID   *Context,
+  IN UINTN  Step
+  )
+{
+  UINT64  MissedSteps;
+
+  return FaultRecoveryRunSteps (&mRecovery, 1, InjectorStep, NULL, &mInjector, &MissedSteps);
+}
+
+/**
+  Invalid step counts and nested runs are rejected.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+InvalidRunsAreRejected (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT64  MissedSteps;
+
+  UT_ASSERT_STATUS_EQUAL (FaultRecoveryRunSteps (&mRecovery, 0, InjectorStep, NULL, &mInjector, &MissedSteps), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (FaultRecoveryRunSteps (&mRecovery, FAULT_RECOVERY_MAX_STEPS + 1, InjectorStep, NULL, &mInjector, &MissedSteps), EFI_INVALID_PARAMETER);
+  UT_ASSERT_STATUS_EQUAL (FaultRecoveryRunSteps (&mRecovery, 1, NULL, NULL, &mInjector, &MissedSteps), EFI_INVALID_PARAMETER);
+
+  UT_ASSERT_STATUS_EQUAL (FaultRecoveryRunSteps (&mRecovery, 1, NestedRunStep, NULL, &mInjector, &MissedSteps), EFI_ALREADY_STARTED);
+  UT_ASSERT_EQUAL (mInjector.StepCount, 0);
+  UT_ASSERT_EQUAL (mRecovery.State, FaultRecoveryIdle);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  fault recovery state machine and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      RecoverySuiteHandle;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_NAME, UNIT_TEST_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_NAME, gEfiCallerBaseName, UNIT_TEST_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create a suite
+  //
+  Status = CreateUnitTestSuite (&RecoverySuiteHandle, Framework, "Fault recovery tests", "MemoryProtection.FaultRecovery", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for RecoverySuiteHandle\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (RecoverySuiteHandle, "Every step faults and is recovered", "AllStepsFault", AllStepsFault, ResetInjector, NULL, NULL);
+  AddTestCase (RecoverySuiteHandle, "Steps that don't fault are recorded", "MissedSteps", MissedStepsAreRecorded, ResetInjector, NULL, NULL);
+  AddTestCase (RecoverySuiteHandle, "A step that can't run stops the test", "StepError", StepErrorStopsTest, ResetInjector, NULL, NULL);
+  AddTestCase (RecoverySuiteHandle, "Unarmed faults are not claimed", "UnarmedFault", UnarmedFaultIsNotClaimed, ResetInjector, NULL, NULL);
+  AddTestCase (RecoverySuiteHandle, "Memory type matrix runs in one pass", "MemoryTypeMatrix", MemoryTypeMatrixInOnePass, ResetInjector, NULL, NULL);
+  AddTestCase (RecoverySuiteHandle, "Invalid runs are rejected", "InvalidRuns", InvalidRunsAreRejected, ResetInjector, NULL, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
@@ -0,0 +1,66 @@
+/** @file
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+
+#include <Library/BaseLib.h>
+#include <Library/DebugLib.h>
+
+#include "../FaultRecovery.h"
+
+//
+// Space left between the recovery point's stack pointer and the stack Resume runs on.
+//
+#define RECOVERY_STACK_GAP  0x100
+
+/**
+  Reports whether same-boot recovery is implemented for this architecture.
+
+  @retval TRUE   FaultRecoveryRedirectContext is implemented.
+**/
+BOOLEAN
+FaultRecoveryIsSupported (
+  VOID
+  )
+{
+  return TRUE;
+}
+
+/**
+  Modifies the interrupted context so that returning from the exception handler calls Resume
+  on the stack of the recovery point.
+
+  The stack below the recovery point's SetJump frame belonged to the step that faulted, which
+  is being abandoned, so Resume can safely run there.  This also recovers from faults caused
+  by exhausting the stack.
+
+  @param[in] SystemContext  Processor context of the fault.
+  @param[in] Recovery       Fault recovery context that claimed the fault.
+  @param[in] Resume         Function to resume at.
+
+  @retval EFI_SUCCESS      The context now resumes at Resume.
+**/
+EFI_STATUS
+FaultRecoveryRedirectContext (
+  IN EFI_SYSTEM_CONTEXT      SystemContext,
+  IN FAULT_RECOVERY_CONTEXT  *Recovery,
+  IN FAULT_RECOVERY_RESUME   Resume
+  )
+{
+  UINT64  Stack;
+
+  Stack = (Recovery->JumpBuffer.Rsp - RECOVERY_STACK_GAP) & ~(UINT64)0xF;
+
+  //
+  // Enter Resume as if it had been called: the return address slot leaves the stack
+  // misaligned by 8 bytes.
+  //
+  SystemContext.SystemContextX64->Rsp = Stack - sizeof (UINT64);
+  SystemContext.SystemContextX64->Rip = (UINT64)(UINTN)Resume;
+
+  return EFI_SUCCESS;
+}
@@ -19,6 +19,7 @@ typedef struct _MEMORY_PROTECTION_TEST_CONTEXT {
   UINT64     TestProgress;
   UINT8      GuardAlignment;
   BOOLEAN    DynamicActive;
+  BOOLEAN    RecoveryActive;
 } MEMORY_PROTECTION_TEST_CONTEXT;
 
 #define MEMORY_PROTECTION_TEST_POOL          1
@@ -903,6 +903,15 @@ RtlXmlGetCurrentLocation (
   PXML_LINE_AND_COLUMN     Location
   );
 
+/** Decoder for UTF-8 and ASCII streams. While it is the stream's decoder the
+    tokenizer steps over plain ASCII runs without calling it. */
+XML_RAWTOKENIZATION_RESULT
+EFIAPI
+RtlXmlDefaultNextCharacter_UTF8 (
+  const void     *pvCursor,
+  IN const void  *pvEnd
+  );
+
 /** Returns a string ordering, not necessarily alphabetical */
 EFI_STATUS
 EFIAPI
@@ -1134,6 +1143,18 @@ typedef struct _NS_ALIAS {
   //
   XML_EXTENT          AliasName;
 
+  //
+  // Hash of AliasName, see RtlpNsHashAliasName
+  //
+  UINT32              ulHash;
+
+  //
+  // Index of the next alias in the same hash bucket while this one is in
+  // use, or of the next free alias once it isn't.  NS_ALIAS_INDEX_NONE ends
+  // either chain.
+  //
+  UINT32              ulNextAlias;
+
   //
   // How many aliased namespaces are there?
   //
@@ -1152,8 +1173,24 @@ typedef struct _NS_ALIAS {
   NS_NAME_DEPTH       InlineNamespaceMaps[NS_ALIAS_MAP_INLINE_COUNT];
 } NS_ALIAS, *PNS_ALIAS;
 
+/*++
+    Every alias declaration pushes one of these onto the namespace manager's
+    undo stack.  Declarations only ever happen at the innermost open depth, so
+    the stack is ordered by depth and leaving a depth pops just the
+    declarations made at or below it.
+--*/
+typedef struct _NS_ALIAS_UNDO {
+  UINT32    ulAliasIndex;
+  UINT32    Depth;
+} NS_ALIAS_UNDO, *PNS_ALIAS_UNDO;
+
+#define NS_ALIAS_INDEX_NONE  ((UINT32)-1)
+
 #define NS_MANAGER_INLINE_ALIAS_COUNT   (5)
 #define NS_MANAGER_ALIAS_GROWTH_SIZE    (40)
+#define NS_MANAGER_ALIAS_BUCKET_COUNT   (64)
+#define NS_MANAGER_INLINE_UNDO_COUNT    (8)
+#define NS_MANAGER_UNDO_GROWTH_SIZE     (40)
 #define NS_MANAGER_DEFAULT_COUNT        (5)
 #define NS_MANAGER_DEFAULT_GROWTH_SIZE  (40)
 
@@ -1181,13 +1218,19 @@ typedef struct _NS_MANAGER {
   UINT32              ulAliasCount;
 
   //
-  // The array of aliases.  N.B. that this list can have holes in it, and
-  // the user will have to do some special magic to find empty slots in
-  // it to make efficient use of this.  Alternatively, you could have another
-  // growing list representing a 'freed slot' stack, but I'm not sure that
-  // would really be an optimization.
+  // The array of aliases.  Aliases in use are chained off AliasBuckets by
+  // the hash of their name; the ones that fell out of use are chained off
+  // ulFreeAlias and get reused before the list grows.
   //
   RTL_GROWING_LIST     Aliases;
+  UINT32               AliasBuckets[NS_MANAGER_ALIAS_BUCKET_COUNT];
+  UINT32               ulFreeAlias;
+
+  //
+  // Stack of alias declarations, innermost last
+  //
+  UINT32               ulAliasUndoCount;
+  RTL_GROWING_LIST     AliasUndo;
 
   //
   // Comparison
@@ -1203,6 +1246,7 @@ typedef struct _NS_MANAGER {
   // Inline list of aliases to start with
   //
   NS_ALIAS             InlineAliases[NS_MANAGER_INLINE_ALIAS_COUNT];
+  NS_ALIAS_UNDO        InlineAliasUndo[NS_MANAGER_INLINE_UNDO_COUNT];
   NS_NAME_DEPTH        InlineDefaultNamespaces[NS_MANAGER_DEFAULT_COUNT];
 } NS_MANAGER, *PNS_MANAGER;
 
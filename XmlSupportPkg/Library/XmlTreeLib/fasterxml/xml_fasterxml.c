@@ -655,6 +655,142 @@ RtlpXmlSetEndOfStream (
   pToken->TokenName        = NTXML_RAWTOKEN_END_OF_STREAM;
 }
 
+//
+// UTF-8 fast path.  When the stream is read by RtlXmlDefaultNextCharacter_UTF8,
+// every byte from 0x01 to 0x7F is one character that decodes to itself, so runs
+// of them can be stepped over eight bytes at a time without calling the decoder.
+// The scan stops at the first byte it is not sure about (a delimiter, NUL or the
+// start of a multi-byte sequence) and leaves it to the decoder, so tokens and
+// errors come out exactly as they do one character at a time.
+//
+#define XML_FAST_ONES   0x0101010101010101ULL
+#define XML_FAST_LOWS   0x7F7F7F7F7F7F7F7FULL
+#define XML_FAST_HIGHS  0x8080808080808080ULL
+
+//
+// Sets the high bit of each byte of Word that is zero, and only those
+//
+#define XML_FAST_ZERO_BYTES(Word)  (~((((Word) & XML_FAST_LOWS) + XML_FAST_LOWS) | (Word)) & XML_FAST_HIGHS)
+
+//
+// Sets the high bit of each byte of Word equal to Byte, and only those
+//
+#define XML_FAST_MATCH_BYTES(Word, Byte)  XML_FAST_ZERO_BYTES ((Word) ^ (XML_FAST_ONES * (UINT8)(Byte)))
+
+#define XML_FAST_IS_PLAIN(Byte)       (((Byte) != 0) && ((Byte) < 0x80))
+#define XML_FAST_IS_WHITESPACE(Byte)  (((Byte) == 0x20) || ((Byte) == 0x9) || ((Byte) == 0xa) || ((Byte) == 0xd))
+
+static
+BOOLEAN
+RtlpXmlUsesFastPath (
+  IN PXML_RAWTOKENIZATION_STATE  pState
+  )
+{
+  return (BOOLEAN)(pState->pfnNextChar == RtlXmlDefaultNextCharacter_UTF8);
+}
+
+//
+// Returns the one byte that decodes to a raw token, or zero when the token
+// stands for more than one character.
+//
+static
+UINT8
+RtlpXmlRawTokenByte (
+  IN NTXML_RAW_TOKEN  Token
+  )
+{
+  switch (Token) {
+    case NTXML_RAWTOKEN_DASH:          return '-';
+    case NTXML_RAWTOKEN_DOT:           return '.';
+    case NTXML_RAWTOKEN_EQUALS:        return '=';
+    case NTXML_RAWTOKEN_FORWARDSLASH:  return '/';
+    case NTXML_RAWTOKEN_GT:            return '>';
+    case NTXML_RAWTOKEN_LT:            return '<';
+    case NTXML_RAWTOKEN_QUESTIONMARK:  return '?';
+    case NTXML_RAWTOKEN_DOUBLEQUOTE:   return '\"';
+    case NTXML_RAWTOKEN_QUOTE:         return '\'';
+    case NTXML_RAWTOKEN_OPENBRACKET:   return '[';
+    case NTXML_RAWTOKEN_CLOSEBRACKET:  return ']';
+    case NTXML_RAWTOKEN_BANG:          return '!';
+    case NTXML_RAWTOKEN_OPENPAREN:     return '(';
+    case NTXML_RAWTOKEN_CLOSEPAREN:    return ')';
+    case NTXML_RAWTOKEN_OPENCURLY:     return '{';
+    case NTXML_RAWTOKEN_CLOSECURLY:    return '}';
+    case NTXML_RAWTOKEN_COLON:         return ':';
+    case NTXML_RAWTOKEN_SEMICOLON:     return ';';
+    case NTXML_RAWTOKEN_UNDERSCORE:    return '_';
+    case NTXML_RAWTOKEN_AMPERSAND:     return '&';
+    case NTXML_RAWTOKEN_POUNDSIGN:     return '#';
+    case NTXML_RAWTOKEN_PERCENT:       return '%';
+    default:                           return 0;
+  }
+}
+
+//
+// Steps over the plain bytes from pbCursor that are neither Stop1 nor Stop2.
+// Each byte stepped over is one character.
+//
+static
+const UINT8 *
+RtlpXmlFastScanUntil (
+  IN const UINT8  *pbCursor,
+  IN const UINT8  *pbEnd,
+  IN UINT8        Stop1,
+  IN UINT8        Stop2
+  )
+{
+  UINT64  Word;
+
+  while ((UINTN)(pbEnd - pbCursor) >= sizeof (UINT64)) {
+    Word = ReadUnaligned64 ((const UINT64 *)pbCursor);
+    if (((Word & XML_FAST_HIGHS) | XML_FAST_ZERO_BYTES (Word) |
+         XML_FAST_MATCH_BYTES (Word, Stop1) | XML_FAST_MATCH_BYTES (Word, Stop2)) != 0)
+    {
+      break;
+    }
+
+    pbCursor += sizeof (UINT64);
+  }
+
+  while ((pbCursor < pbEnd) && XML_FAST_IS_PLAIN (*pbCursor) && (*pbCursor != Stop1) && (*pbCursor != Stop2)) {
+    pbCursor++;
+  }
+
+  return pbCursor;
+}
+
+//
+// Steps over the tab, space, cr and lf bytes from pbCursor.  Each byte stepped
+// over is one character.
+//
+static
+const UINT8 *
+RtlpXmlFastScanWhitespace (
+  IN const UINT8  *pbCursor,
+  IN const UINT8  *pbEnd
+  )
+{
+  UINT64  Word;
+  UINT64  Whitespace;
+
+  while ((UINTN)(pbEnd - pbCursor) >= sizeof (UINT64)) {
+    Word       = ReadUnaligned64 ((const UINT64 *)pbCursor);
+    Whitespace = XML_FAST_MATCH_BYTES (Word, 0x20) | XML_FAST_MATCH_BYTES (Word, 0x9) |
+                 XML_FAST_MATCH_BYTES (Word, 0xa) | XML_FAST_MATCH_BYTES (Word, 0xd);
+    if (Whitespace != XML_FAST_HIGHS) {
+      break;
+    }
+
+    pbCursor += sizeof (UINT64);
+  }
+
+  while ((pbCursor < pbEnd) && XML_FAST_IS_WHITESPACE (*pbCursor)) {
+    pbCursor++;
+  }
+
+  return pbCursor;
+}
+
 EFI_STATUS
 EFIAPI
 RtlRawXmlTokenizer_SingleToken (
@@ -707,10 +843,13 @@ RtlRawXmlTokenizer_GatherWhitespace (
   PXML_RAW_TOKEN              pTerminator
   )
 {
-  UINT64  ulCharCount = 0;
+  UINT64                      ulCharCount = 0;
+  XML_RAWTOKENIZATION_RESULT  Result;
+  const UINT8                 *pbSkipped;
 
-  VOID  *pvCursor = pState->pvCursor;
-  VOID  *pvEnd    = pState->pvDocumentEnd;
+  VOID           *pvCursor = pState->pvCursor;
+  VOID           *pvEnd    = pState->pvDocumentEnd;
+  const BOOLEAN  fFastPath = RtlpXmlUsesFastPath (pState);
 
   if (pvCursor >= pvEnd) {
     RtlpXmlSetEndOfStream (pState, pWhitespace);
@@ -726,10 +865,22 @@ RtlRawXmlTokenizer_GatherWhitespace (
   // Record starting point
   //
   do {
+    //
+    // Step over plain whitespace without decoding it
+    //
+    if (fFastPath) {
+      pbSkipped    = RtlpXmlFastScanWhitespace (pvCursor, pvEnd);
+      ulCharCount += (UINTN)pbSkipped - (UINTN)pvCursor;
+      pvCursor     = (VOID *)pbSkipped;
+      if (pvCursor >= pvEnd) {
+        break;
+      }
+    }
+
     //
     // Gather a character
     //
-    const XML_RAWTOKENIZATION_RESULT  Result = (*pState->pfnNextChar)(pvCursor, pvEnd);
+    Result = (*pState->pfnNextChar)(pvCursor, pvEnd);
 
     //
     // If this is tab, space, cr or lf, then continue.  Otherwise,
@@ -807,9 +958,12 @@ RtlRawXmlTokenizer_GatherPCData (
 
 --*/
 {
-  VOID    *pvCursor;
-  VOID    *pvEnd;
-  UINT64  ulCharCount = 0;
+  VOID                        *pvCursor;
+  VOID                        *pvEnd;
+  UINT64                      ulCharCount = 0;
+  XML_RAWTOKENIZATION_RESULT  Result;
+  const UINT8                 *pbSkipped;
+  const BOOLEAN               fFastPath = RtlpXmlUsesFastPath (pState);
 
   ZeroMem (pPcData, sizeof (*pPcData));
   pPcData->Run.pvData   = pState->pvCursor;
@@ -824,7 +978,19 @@ RtlRawXmlTokenizer_GatherPCData (
   pvEnd    = pState->pvDocumentEnd;
 
   do {
-    const XML_RAWTOKENIZATION_RESULT  Result = (*pState->pfnNextChar)(pvCursor, pvEnd);
+    //
+    // Step over plain pcdata without decoding it
+    //
+    if (fFastPath) {
+      pbSkipped    = RtlpXmlFastScanUntil (pvCursor, pvEnd, '<', '<');
+      ulCharCount += (UINTN)pbSkipped - (UINTN)pvCursor;
+      pvCursor     = (VOID *)pbSkipped;
+      if (pvCursor >= pvEnd) {
+        break;
+      }
+    }
+
+    Result = (*pState->pfnNextChar)(pvCursor, pvEnd);
 
     switch (Result.Character) {
       case XML_RAWTOKENIZATION_INVALID_CHARACTER:
@@ -1072,7 +1238,13 @@ RtlRawXmlTokenizer_GatherUntilOneOrOther (
   VOID  *pvCursor      = pState->pvCursor;
   VOID  *pvDocumentEnd = pState->pvDocumentEnd;
   // UINT64 cbChunk = 0;
-  UINT64  ulCharCount = 0;
+  UINT64                      ulCharCount = 0;
+  XML_RAWTOKENIZATION_RESULT  Result;
+  NTXML_RAW_TOKEN             ulDecoded;
+  const UINT8                 *pbSkipped;
+  const UINT8                 Stop1     = RtlpXmlRawTokenByte (StopOn1);
+  const UINT8                 Stop2     = RtlpXmlRawTokenByte (StopOn2);
+  const BOOLEAN               fFastPath = RtlpXmlUsesFastPath (pState) && (Stop1 != 0) && (Stop2 != 0);
 
   pGathered->Run.cbData       = 0;
   pGathered->Run.pvData       = pvCursor;
@@ -1089,8 +1261,20 @@ RtlRawXmlTokenizer_GatherUntilOneOrOther (
   }
 
   do {
-    const XML_RAWTOKENIZATION_RESULT  Result    = (*pState->pfnNextChar)(pvCursor, pvDocumentEnd);
-    const NTXML_RAW_TOKEN             ulDecoded = _RtlpDecodeCharacter (Result.Character);
+    //
+    // Step over plain characters that are neither stop without decoding them
+    //
+    if (fFastPath) {
+      pbSkipped    = RtlpXmlFastScanUntil (pvCursor, pvDocumentEnd, Stop1, Stop2);
+      ulCharCount += (UINTN)pbSkipped - (UINTN)pvCursor;
+      pvCursor     = (VOID *)pbSkipped;
+      if (pvCursor >= pvDocumentEnd) {
+        break;
+      }
+    }
+
+    Result    = (*pState->pfnNextChar)(pvCursor, pvDocumentEnd);
+    ulDecoded = _RtlpDecodeCharacter (Result.Character);
 
     //
     // Zero character, and error?  Oops.
@@ -1242,11 +1426,15 @@ RtlRawXmlTokenizer_GatherUntil (
   )
 {
   // UINT32 cbChunk = 0;
-  NTXML_RAW_TOKEN  ulDecoded;
-  UINT32           ulCharCount = 0;
+  NTXML_RAW_TOKEN             ulDecoded;
+  UINT32                      ulCharCount = 0;
+  XML_RAWTOKENIZATION_RESULT  Result;
+  const UINT8                 *pbSkipped;
 
-  VOID  *pvCursor      = pState->pvCursor;
-  VOID  *pvDocumentEnd = pState->pvDocumentEnd;
+  VOID           *pvCursor      = pState->pvCursor;
+  VOID           *pvDocumentEnd = pState->pvDocumentEnd;
+  const UINT8    Stop           = RtlpXmlRawTokenByte (StopOn);
+  const BOOLEAN  fFastPath      = RtlpXmlUsesFastPath (pState) && (Stop != 0);
 
   if (pTokenFound) {
     ZeroMem (&pTokenFound->Run, sizeof pTokenFound->Run);
@@ -1261,7 +1449,19 @@ RtlRawXmlTokenizer_GatherUntil (
   GATHER_ITEM_SETUP (pState, pGathered);
 
   do {
-    const XML_RAWTOKENIZATION_RESULT  Result = (*pState->pfnNextChar)(pvCursor, pvDocumentEnd);
+    //
+    // Step over plain characters other than the stop without decoding them
+    //
+    if (fFastPath) {
+      pbSkipped    = RtlpXmlFastScanUntil (pvCursor, pvDocumentEnd, Stop, Stop);
+      ulCharCount += (UINT32)((UINTN)pbSkipped - (UINTN)pvCursor);
+      pvCursor     = (VOID *)pbSkipped;
+      if (pvCursor >= pvDocumentEnd) {
+        break;
+      }
+    }
+
+    Result = (*pState->pfnNextChar)(pvCursor, pvDocumentEnd);
 
     //
     // Zero character, and error?  Oops.
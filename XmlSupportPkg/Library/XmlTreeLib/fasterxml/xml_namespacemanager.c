@@ -15,6 +15,193 @@ SPDX-License-Identifier: BSD-2-Clause-Patent
 #include "xmlerr.h"                              // XML Errors.
 #include "xmlstructure.h"                        // XML structures
 
+static
+UINT32
+RtlpNsHashAliasName (
+  PCXML_EXTENT  pAliasName
+  )
+
+/*++
+
+  Purpose:
+
+    Hashes the bytes of an alias name.  Namespace prefixes only match when
+    they are made of the same characters, and every extent handed to the
+    manager comes from the same document and so the same encoding, which
+    means equal names always hash the same whatever comparison the manager
+    was given.  That comparison still decides the match.
+
+  Parameters:
+
+    pAliasName - Alias name to hash
+
+  Returns:
+
+    The FNV-1a hash of the name.
+
+--*/
+{
+  const UINT8  *pbName = (const UINT8 *)pAliasName->pvData;
+  UINT64       cbName  = pAliasName->cbData;
+  UINT32       ulHash  = 0x811C9DC5;
+
+  while (cbName-- > 0) {
+    ulHash = (ulHash ^ *pbName++) * 0x01000193;
+  }
+
+  return ulHash;
+}
+
+static
+EFI_STATUS
+RtlpNsLookupAlias (
+  PNS_MANAGER   pManager,
+  PCXML_EXTENT  pAliasName,
+  UINT32        ulHash,
+  UINT32        *pulAliasIndex,
+  PNS_ALIAS     *ppAlias
+  )
+
+/*++
+
+  Purpose:
+
+    Finds the alias in use with the given name by walking its hash bucket.
+
+  Parameters:
+
+    pManager - Namespace manager to look in
+
+    pAliasName - Name of the alias
+
+    ulHash - RtlpNsHashAliasName of pAliasName
+
+    pulAliasIndex - Index of the alias in pManager->Aliases when found
+
+    ppAlias - The alias, or NULL when no alias by that name is in use
+
+  Returns:
+
+    EFI_SUCCESS - The bucket was searched, whether or not the alias was found
+
+    * - Failures from RtlIndexIntoGrowingList or the comparison callback
+
+--*/
+{
+  EFI_STATUS          status  = EFI_SUCCESS;
+  UINT32              idx     = pManager->AliasBuckets[ulHash % NS_MANAGER_ALIAS_BUCKET_COUNT];
+  XML_STRING_COMPARE  Matches = XML_STRING_COMPARE_EQUALS;
+  PNS_ALIAS           pCandidateAlias;
+
+  *ppAlias = NULL;
+
+  while (idx != NS_ALIAS_INDEX_NONE) {
+    status = RtlIndexIntoGrowingList (
+               &pManager->Aliases,
+               idx,
+               (VOID **)&pCandidateAlias,
+               FALSE
+               );
+
+    if (EFI_ERROR (status)) {
+      return status;
+    }
+
+    ASSERT (pCandidateAlias->fInUse);
+
+    //
+    // Only names with the same hash and length can be equal, so only those
+    // go to the comparison callback
+    //
+    if ((pCandidateAlias->ulHash == ulHash) &&
+        (pCandidateAlias->AliasName.cbData == pAliasName->cbData))
+    {
+      status = pManager->pfnCompare (
+                           pManager->pvCompareContext,
+                           &pCandidateAlias->AliasName,
+                           pAliasName,
+                           &Matches
+                           );
+
+      if (EFI_ERROR (status)) {
+        return status;
+      }
+
+      if (Matches == XML_STRING_COMPARE_EQUALS) {
+        *pulAliasIndex = idx;
+        *ppAlias       = pCandidateAlias;
+        return EFI_SUCCESS;
+      }
+    }
+
+    idx = pCandidateAlias->ulNextAlias;
+  }
+
+  return EFI_SUCCESS;
+}
+
+static
+EFI_STATUS
+RtlpNsReleaseAlias (
+  PNS_MANAGER  pManager,
+  UINT32       ulAliasIndex,
+  PNS_ALIAS    pAlias
+  )
+
+/*++
+
+  Purpose:
+
+    Takes an alias that no longer maps to any namespace out of its hash
+    bucket and puts it on the free list.
+
+  Parameters:
+
+    pManager - Namespace manager owning the alias
+
+    ulAliasIndex - Index of the alias in pManager->Aliases
+
+    pAlias - The alias itself
+
+  Returns:
+
+    EFI_SUCCESS - The alias is free for reuse
+
+    * - Failures from RtlIndexIntoGrowingList
+
+--*/
+{
+  EFI_STATUS  status = EFI_SUCCESS;
+  UINT32      *pulLink;
+  PNS_ALIAS   pPrevious;
+
+  pulLink = &pManager->AliasBuckets[pAlias->ulHash % NS_MANAGER_ALIAS_BUCKET_COUNT];
+
+  while (*pulLink != ulAliasIndex) {
+    ASSERT (*pulLink != NS_ALIAS_INDEX_NONE);
+
+    status = RtlIndexIntoGrowingList (
+               &pManager->Aliases,
+               *pulLink,
+               (VOID **)&pPrevious,
+               FALSE
+               );
+
+    if (EFI_ERROR (status)) {
+      return status;
+    }
+
+    pulLink = &pPrevious->ulNextAlias;
+  }
+
+  *pulLink              = pAlias->ulNextAlias;
+  pAlias->fInUse        = FALSE;
+  pAlias->ulNextAlias   = pManager->ulFreeAlias;
+  pManager->ulFreeAlias = ulAliasIndex;
+
+  return status;
+}
+
 EFI_STATUS
 EFIAPI
 RtlNsInitialize (
@@ -30,7 +217,7 @@ RtlNsInitialize (
     return EFI_INVALID_PARAMETER;
   }
 
-  ZeroMem (pManager, sizeof (pManager));
+  ZeroMem (pManager, sizeof (*pManager));
 
   status = RtlInitializeGrowingList (
              &pManager->DefaultNamespaces,
@@ -58,9 +245,26 @@ RtlNsInitialize (
     return status;
   }
 
+  status = RtlInitializeGrowingList (
+             &pManager->AliasUndo,
+             sizeof (NS_ALIAS_UNDO),
+             NS_MANAGER_UNDO_GROWTH_SIZE,
+             pManager->InlineAliasUndo,
+             sizeof (pManager->InlineAliasUndo),
+             Allocation
+             );
+
+  if (EFI_ERROR (status)) {
+    return status;
+  }
+
+  SetMem32 (pManager->AliasBuckets, sizeof (pManager->AliasBuckets), NS_ALIAS_INDEX_NONE);
+
   pManager->pvCompareContext = pCompareContext;
   pManager->pfnCompare       = pCompare;
   pManager->ulAliasCount     = 0;
+  pManager->ulFreeAlias      = NS_ALIAS_INDEX_NONE;
+  pManager->ulAliasUndoCount = 0;
 
   //
   // Should be golden at this point, everything else is zero-initialized, so that's
@@ -76,6 +280,8 @@ RtlNsDestroy (
   )
 {
   EFI_STATUS  status = EFI_SUCCESS;
+  UINT32      idx;
+  PNS_ALIAS   pAlias;
 
   if (!ARGUMENT_PRESENT (pManager)) {
     return RtlpReportXmlError (EFI_INVALID_PARAMETER);
@@ -83,6 +289,26 @@ RtlNsDestroy (
 
   status = RtlDestroyGrowingList (&pManager->DefaultNamespaces);
 
+  //
+  // Every alias ever created owns a namespace map list, in use or not
+  //
+  for (idx = 0; !EFI_ERROR (status) && (idx < pManager->ulAliasCount); idx++) {
+    status = RtlIndexIntoGrowingList (
+               &pManager->Aliases,
+               idx,
+               (VOID **)&pAlias,
+               FALSE
+               );
+
+    if (!EFI_ERROR (status)) {
+      status = RtlDestroyGrowingList (&pAlias->NamespaceMaps);
+    }
+  }
+
+  if (!EFI_ERROR (status)) {
+    status = RtlDestroyGrowingList (&pManager->AliasUndo);
+  }
+
   if (!EFI_ERROR (status)) {
     status = RtlDestroyGrowingList (&pManager->Aliases);
   }
@@ -99,24 +325,24 @@ RtlNsInsertNamespaceAlias (
   PXML_EXTENT  Alias
   )
 {
-  EFI_STATUS          status       = EFI_SUCCESS;
-  PNS_NAME_DEPTH      pNameDepth   = NULL;
-  PNS_ALIAS           pNsAliasSlot = NULL;
-  PNS_ALIAS           pNsFreeSlot  = NULL;
-  UINT32              ul           = 0;
-  XML_STRING_COMPARE  Equals       = XML_STRING_COMPARE_EQUALS;
+  EFI_STATUS      status       = EFI_SUCCESS;
+  PNS_NAME_DEPTH  pNameDepth   = NULL;
+  PNS_ALIAS       pNsAliasSlot = NULL;
+  PNS_ALIAS_UNDO  pUndo        = NULL;
+  UINT32          ulAliasIndex = NS_ALIAS_INDEX_NONE;
+  UINT32          ulHash       = 0;
+  UINT32          ulBucket     = 0;
+  BOOLEAN         fNewAlias    = FALSE;
 
   //
-  // Run through all the aliases we currently have, see if any of them are
-  // the one we've got - in which case, we push-down a new namespace on that
-  // alias.  As we're going, track to find a free slot, in case we don't find
-  // it in the list
+  // Declarations only ever happen at the innermost open depth; leaving a
+  // depth relies on the undo stack being in depth order.
   //
-  for (ul = 0; ul < pManager->ulAliasCount; ul++) {
+  if (pManager->ulAliasUndoCount > 0) {
     status = RtlIndexIntoGrowingList (
-               &pManager->Aliases,
-               ul,
-               (VOID **)&pNsAliasSlot,
+               &pManager->AliasUndo,
+               pManager->ulAliasUndoCount - 1,
+               (VOID **)&pUndo,
                FALSE
                );
 
@@ -124,60 +350,52 @@ RtlNsInsertNamespaceAlias (
       goto Exit;
     }
 
-    //
-    // If we found a hole, stash it
-    //
-    if (!pNsAliasSlot->fInUse) {
-      if (pNsFreeSlot == NULL) {
-        pNsFreeSlot = pNsAliasSlot;
-      }
-
-      pNsAliasSlot = NULL;
-    }
-    //
-    // Does this alias match?
-    //
-    else {
-      status = pManager->pfnCompare (
-                           pManager->pvCompareContext,
-                           Alias,
-                           &pNsAliasSlot->AliasName,
-                           &Equals
-                           );
+    ASSERT (pUndo->Depth <= ulDepth);
+  }
 
-      if (EFI_ERROR (status)) {
-        goto Exit;
-      }
+  //
+  // See if this alias is already in use, in which case we push-down a new
+  // namespace on it
+  //
+  ulHash   = RtlpNsHashAliasName (Alias);
+  ulBucket = ulHash % NS_MANAGER_ALIAS_BUCKET_COUNT;
 
-      //
-      // Not equals, continue
-      //
-      if (Equals != XML_STRING_COMPARE_EQUALS) {
-        pNsAliasSlot = NULL;
-      }
-      //
-      // Otherwise, stop
-      //
-      else {
-        break;
-      }
-    }
+  status = RtlpNsLookupAlias (pManager, Alias, ulHash, &ulAliasIndex, &pNsAliasSlot);
+  if (EFI_ERROR (status)) {
+    goto Exit;
   }
 
   //
-  // We didn't find the alias slot that this fits in to, so see if we can
-  // find a free one and initialize it.
+  // We didn't find the alias, so pick up a slot for it: the most recently
+  // freed one if there is one, otherwise a new entry at the end of the list.
+  // Neither is taken off the free list or counted until everything below
+  // has succeeded.
   //
   if (pNsAliasSlot == NULL) {
-    //
-    // Didn't find a free slot, either - add a new entry to the list
-    // and go from there
-    //
-    if (pNsFreeSlot == NULL) {
+    fNewAlias = TRUE;
+
+    if (pManager->ulFreeAlias != NS_ALIAS_INDEX_NONE) {
+      ulAliasIndex = pManager->ulFreeAlias;
+
+      status = RtlIndexIntoGrowingList (
+                 &pManager->Aliases,
+                 ulAliasIndex,
+                 (VOID **)&pNsAliasSlot,
+                 FALSE
+                 );
+
+      if (EFI_ERROR (status)) {
+        goto Exit;
+      }
+
+      ASSERT (!pNsAliasSlot->fInUse);
+    } else {
+      ulAliasIndex = pManager->ulAliasCount;
+
       status = RtlIndexIntoGrowingList (
                  &pManager->Aliases,
-                 pManager->ulAliasCount++,
-                 (VOID **)&pNsFreeSlot,
+                 ulAliasIndex,
+                 (VOID **)&pNsAliasSlot,
                  TRUE
                  );
 
@@ -188,41 +406,34 @@ RtlNsInsertNamespaceAlias (
       //
       // Init this, it just came out of the 'really free' list
       //
-      ZeroMem (pNsFreeSlot, sizeof (*pNsFreeSlot));
+      ZeroMem (pNsAliasSlot, sizeof (*pNsAliasSlot));
 
       status = RtlInitializeGrowingList (
-                 &pNsFreeSlot->NamespaceMaps,
+                 &pNsAliasSlot->NamespaceMaps,
                  sizeof (NS_NAME_DEPTH),
-                 20,
-                 pNsFreeSlot->InlineNamespaceMaps,
-                 sizeof (pNsFreeSlot->InlineNamespaceMaps),
+                 NS_ALIAS_MAP_GROWING_COUNT,
+                 pNsAliasSlot->InlineNamespaceMaps,
+                 sizeof (pNsAliasSlot->InlineNamespaceMaps),
                  &pManager->Aliases.Allocator
                  );
 
       if (EFI_ERROR (status)) {
         goto Exit;
       }
-    }
-
-    ASSERT (pNsFreeSlot != NULL);
 
-    pNsAliasSlot = pNsFreeSlot;
+      pNsAliasSlot->ulNextAlias = NS_ALIAS_INDEX_NONE;
+    }
 
-    //
-    // Zero init this one
-    //
-    pNsAliasSlot->fInUse           = TRUE;
     pNsAliasSlot->ulNamespaceCount = 0;
-    pNsAliasSlot->AliasName        = *Alias;
   }
-
   //
-  // Look at the current count in the slot - the top of the stack.
-  // If its document depth matches the current document depth,
-  // that's a redefinition of an alias <x xmlns:x="y" xmlns:x="y"/>
-  // and is a document error.
+  // Look at the top of the alias' stack.  If its document depth matches the
+  // current document depth, that's a redefinition of an alias
+  // <x xmlns:x="y" xmlns:x="y"/> and is a document error.
   //
-  if (pNsAliasSlot->ulNamespaceCount > 0) {
+  else {
+    ASSERT (pNsAliasSlot->ulNamespaceCount > 0);
+
     status = RtlIndexIntoGrowingList (
                &pNsAliasSlot->NamespaceMaps,
                (pNsAliasSlot->ulNamespaceCount - 1),
@@ -234,19 +445,19 @@ RtlNsInsertNamespaceAlias (
       goto Exit;
     }
 
-    if (pNsAliasSlot->fInUse && (pNameDepth->Depth == ulDepth)) {
+    if (pNameDepth->Depth == ulDepth) {
       status = RtlpReportXmlError (STATUS_DUPLICATE_NAME);
       goto Exit;
     }
   }
 
   //
-  // At this point, pNsAliasSlot points at the alias slot for which
-  // we want to add a new depth thing.
+  // Make room for the new name-at-depth on the alias and for the
+  // declaration on the undo stack
   //
   status = RtlIndexIntoGrowingList (
              &pNsAliasSlot->NamespaceMaps,
-             pNsAliasSlot->ulNamespaceCount++,
+             pNsAliasSlot->ulNamespaceCount,
              (VOID **)&pNameDepth,
              TRUE
              );
@@ -255,14 +466,41 @@ RtlNsInsertNamespaceAlias (
     goto Exit;
   }
 
-  pNsAliasSlot->fInUse = TRUE;
+  status = RtlIndexIntoGrowingList (
+             &pManager->AliasUndo,
+             pManager->ulAliasUndoCount,
+             (VOID **)&pUndo,
+             TRUE
+             );
+
+  if (EFI_ERROR (status)) {
+    goto Exit;
+  }
 
   //
-  // Good - now write the depth and the name into the
-  // name-at-depth thing
+  // Nothing can fail from here on, so commit
   //
+  if (fNewAlias) {
+    if (ulAliasIndex == pManager->ulAliasCount) {
+      pManager->ulAliasCount++;
+    } else {
+      pManager->ulFreeAlias = pNsAliasSlot->ulNextAlias;
+    }
+
+    pNsAliasSlot->fInUse             = TRUE;
+    pNsAliasSlot->AliasName          = *Alias;
+    pNsAliasSlot->ulHash             = ulHash;
+    pNsAliasSlot->ulNextAlias        = pManager->AliasBuckets[ulBucket];
+    pManager->AliasBuckets[ulBucket] = ulAliasIndex;
+  }
+
   pNameDepth->Depth = ulDepth;
   pNameDepth->Name  = *Namespace;
+  pNsAliasSlot->ulNamespaceCount++;
+
+  pUndo->ulAliasIndex = ulAliasIndex;
+  pUndo->Depth        = ulDepth;
+  pManager->ulAliasUndoCount++;
 
 Exit:
   return status;
@@ -471,8 +709,9 @@ RtlpRemoveNamespaceAliasesAboveDepth (
 
   Purpose:
 
-    Looks through the list of namespace aliases in this manager and removes the
-    ones that are at or above a given depth.
+    Pops the alias declarations made at or above a given depth off the undo
+    stack, taking each one's namespace off its alias.  Aliases left without
+    a namespace are freed.  Only the declarations being undone are touched.
 
   Parameters:
 
@@ -488,26 +727,32 @@ RtlpRemoveNamespaceAliasesAboveDepth (
 
 --*/
 {
-  EFI_STATUS  status = EFI_SUCCESS;
-  UINT32      idx    = 0;
+  EFI_STATUS      status = EFI_SUCCESS;
+  PNS_ALIAS_UNDO  pUndo;
+  PNS_ALIAS       pAlias;
 
-  //
-  // Note that the alias list is constructed such that it continually
-  // grows, but deleteing namespace aliases can leave holes in the
-  // list that can be filled in.  The ulAliasCount member of the namespace
-  // manager is there to know what the high water mark of namespaces is,
-  // above which we don't need to go to find valid aliases.  This value
-  // is maintained in RtlNsInsertNamespaceAlias, but never cleared up.
-  // A "potentially bad" situation could arise when a document with a lot of
-  // namespace aliases at the second-level appears.
-  //
-  for (idx = 0; idx < pManager->ulAliasCount; idx++) {
-    PNS_ALIAS  pAlias;
+  while (pManager->ulAliasUndoCount > 0) {
+    status = RtlIndexIntoGrowingList (
+               &pManager->AliasUndo,
+               pManager->ulAliasUndoCount - 1,
+               (VOID **)&pUndo,
+               FALSE
+               );
+
+    if (EFI_ERROR (status)) {
+      return status;
+    }
+
+    //
+    // Out of the deep water, stop looking
+    //
+    if (pUndo->Depth < ulDepth) {
+      break;
+    }
 
-    /* Get the namespace alias entry */
     status = RtlIndexIntoGrowingList (
                &pManager->Aliases,
-               idx,
+               pUndo->ulAliasIndex,
                (VOID **)&pAlias,
                FALSE
                );
@@ -516,40 +761,19 @@ RtlpRemoveNamespaceAliasesAboveDepth (
       return status;
     }
 
-    if (pAlias->fInUse) {
-      UINT32  jdx;
-
-      for (jdx = 0; jdx < pAlias->ulNamespaceCount; jdx++) {
-        PNS_NAME_DEPTH  pNameDepth;
-
-        /* Get the name and depth for each mapping of this alias */
-        status = RtlIndexIntoGrowingList (
-                   &pAlias->NamespaceMaps,
-                   jdx,
-                   (VOID **)&pNameDepth,
-                   FALSE
-                   );
-
-        if (EFI_ERROR (status)) {
-          return status;
-        }
-
-        /*
-         * Stop when we hit a depth greater than the depth that was
-         * passed in.  We assume that the namespace list is in order
-         * of increasing depth, so everything after this in the list
-         * should be lopped off.
-         */
-        if (pNameDepth->Depth >= ulDepth) {
-          break;
-        }
-      }
+    //
+    // The declaration being undone is the newest one on its alias
+    //
+    ASSERT (pAlias->fInUse && (pAlias->ulNamespaceCount > 0));
 
-      pAlias->ulNamespaceCount = jdx;
+    pAlias->ulNamespaceCount--;
+    pManager->ulAliasUndoCount--;
 
-      /* No point in keeping around an alias with no mapping */
-      if (pAlias->ulNamespaceCount == 0) {
-        pAlias->fInUse = FALSE;
+    /* No point in keeping around an alias with no mapping */
+    if (pAlias->ulNamespaceCount == 0) {
+      status = RtlpNsReleaseAlias (pManager, pUndo->ulAliasIndex, pAlias);
+      if (EFI_ERROR (status)) {
+        return status;
       }
     }
   }
@@ -583,7 +807,7 @@ RtlNsLeaveDepth (
     }
   }
 
-  if (pManager->ulAliasCount > 0) {
+  if (pManager->ulAliasUndoCount > 0) {
     status = RtlpRemoveNamespaceAliasesAboveDepth (pManager, ulDepth);
     if (EFI_ERROR (status)) {
       return status;
@@ -601,60 +825,15 @@ RtlpNsFindMatchingAlias (
   PNS_ALIAS    *pAlias
   )
 {
-  EFI_STATUS  status = EFI_SUCCESS;
-  UINT32      idx    = 0;
-
-  *pAlias = NULL;
-
-  for (idx = 0; idx < pManager->ulAliasCount; idx++) {
-    XML_STRING_COMPARE  Matches         = XML_STRING_COMPARE_EQUALS;
-    PNS_ALIAS           pCandidateAlias = NULL;
-
-    status = RtlIndexIntoGrowingList (
-               &pManager->Aliases,
-               idx,
-               (VOID **)&pCandidateAlias,
-               FALSE
-               );
-
-    //
-    // This shouldn't fail - we are within the boundaries set
-    // in the alias count, and we're not attempting to grow
-    // the array at all.
-    //
-    if (EFI_ERROR (status)) {
-      return status;
-    }
-
-    //
-    // If this slot is in use...
-    //
-    if (pCandidateAlias->fInUse) {
-      status = pManager->pfnCompare (
-                           pManager->pvCompareContext,
-                           &pCandidateAlias->AliasName,
-                           pAliasName,
-                           &Matches
-                           );
-
-      if (EFI_ERROR (status)) {
-        return status;
-      }
-
-      //
-      // This alias matches the alias in the list
-      //
-      if (Matches == XML_STRING_COMPARE_EQUALS) {
-        ASSERT (pCandidateAlias->fInUse);
-        *pAlias = pCandidateAlias;
-        return EFI_SUCCESS;
-      }
-    }
-  }
-
-  ASSERT (*pAlias == NULL);
-
-  return EFI_SUCCESS;
+  UINT32  idx;
+
+  return RtlpNsLookupAlias (
+           pManager,
+           pAliasName,
+           RtlpNsHashAliasName (pAliasName),
+           &idx,
+           pAlias
+           );
 }
 
 EFI_STATUS
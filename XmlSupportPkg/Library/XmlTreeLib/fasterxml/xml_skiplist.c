@@ -298,9 +298,10 @@ RtlIndexIntoGrowingList (
 
     //
     // Success! Go move the chunk pointer past the header of the growing list
-    // chunk, and then index off it to find the right place.
+    // chunk, and then index off it to find the right place.  N.B. EFI_STATUS
+    // is unsigned, so NT_SUCCESS would take STATUS_NOT_FOUND for success too.
     //
-    if (NT_SUCCESS (status)) {
+    if (status == EFI_SUCCESS) {
       pbData = ((UINT8 *)(pThisChunk + 1)) + (pList->cbElementSize * ulNewOffset);
     }
     //
@@ -0,0 +1,571 @@
+/**
+@file
+Host based unit test for the fasterxml namespace manager.
+
+Covers prefixes shadowed at deeper elements and redefined on the same element, checks a long
+random run of declarations, lookups and element closes against a simple model of the scoping
+rules, and times the manager on deeply nested documents that declare prefixes at every level.
+
+Copyright (C) Microsoft Corporation.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <time.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../../../Library/XmlTreeLib/fasterxml/fasterxml.h"
+#include "../../../Library/XmlTreeLib/fasterxml/xmlerr.h"
+
+#define UNIT_TEST_APP_NAME     "FasterXml Namespace Manager Host Test"
+#define UNIT_TEST_APP_VERSION  "0.1"
+
+#define NAME_COUNT        200
+#define NAME_LENGTH       16
+#define MODEL_CAPACITY    4096
+#define RANDOM_STEPS      20000
+#define BENCHMARK_DEPTH   512
+#define BENCHMARK_ROUNDS  20
+
+//
+// Names used by the random and benchmark tests. Extents point into these, so they live for the
+// whole run.
+//
+STATIC CHAR8  mPrefixes[NAME_COUNT][NAME_LENGTH];
+STATIC CHAR8  mNamespaces[NAME_COUNT][NAME_LENGTH];
+
+//
+// What the manager should hold, as a plain list of declarations in document order. The newest
+// declaration of a prefix wins and closing an element drops everything declared at or below it.
+//
+typedef struct {
+  UINT32    Prefix;
+  UINT32    Namespace;
+  UINT32    Depth;
+} MODEL_DECLARATION;
+
+STATIC MODEL_DECLARATION  mModel[MODEL_CAPACITY];
+STATIC UINTN              mModelCount;
+
+STATIC NS_MANAGER  mManager;
+STATIC BOOLEAN     mManagerReady = FALSE;
+STATIC UINTN       mCompareCount;
+
+/**
+  Allocation callback for the namespace manager.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestAllocate (
+  UINT32  cb,
+  VOID    **ppv,
+  VOID    *pvContext
+  )
+{
+  *ppv = AllocatePool (cb);
+  return (*ppv == NULL) ? EFI_OUT_OF_RESOURCES : EFI_SUCCESS;
+}
+
+/**
+  Free callback for the namespace manager.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+TestFree (
+  VOID  *pv,
+  VOID  *pvContext
+  )
+{
+  FreePool (pv);
+  return EFI_SUCCESS;
+}
+
+STATIC RTL_ALLOCATOR  mAllocator = { TestAllocate, TestFree, NULL };
+
+/**
+  Comparison callback for the namespace manager, the same binary comparison the tokenizer
+  uses for UTF-8 documents. Counts its calls in the context.
+**/
+STATIC
+EFI_STATUS
+TestCompare (
+  VOID                *pvContext,
+  PCXML_EXTENT        pLeft,
+  PCXML_EXTENT        pRight,
+  XML_STRING_COMPARE  *pfMatching
+  )
+{
+  INTN  Comparison;
+
+  (*(UINTN *)pvContext)++;
+
+  if (pLeft->cbData != pRight->cbData) {
+    *pfMatching = (pLeft->cbData < pRight->cbData) ? XML_STRING_COMPARE_LT : XML_STRING_COMPARE_GT;
+    return EFI_SUCCESS;
+  }
+
+  Comparison  = CompareMem (pLeft->pvData, pRight->pvData, (UINTN)pLeft->cbData);
+  *pfMatching = (Comparison == 0) ? XML_STRING_COMPARE_EQUALS :
+                ((Comparison < 0) ? XML_STRING_COMPARE_LT : XML_STRING_COMPARE_GT);
+  return EFI_SUCCESS;
+}
+
+/**
+  Describes an ASCII string as an extent of a UTF-8 document.
+**/
+STATIC
+XML_EXTENT
+Extent (
+  IN CONST CHAR8  *String
+  )
+{
+  XML_EXTENT  Result;
+
+  Result.pvData       = (VOID *)String;
+  Result.cbData       = AsciiStrLen (String);
+  Result.Encoding     = XMLEF_UTF_8_OR_ASCII;
+  Result.ulCharacters = Result.cbData;
+  return Result;
+}
+
+/**
+  Checks what a prefix resolves to.
+
+  @param[in]  Depth      Depth the lookup is made at
+  @param[in]  Prefix     Prefix to resolve, "" for the default namespace
+  @param[in]  Expected   Namespace it should resolve to, or NULL if it should not resolve
+
+  @retval  TRUE when the manager agrees.
+**/
+STATIC
+BOOLEAN
+Resolves (
+  IN UINT32       Depth,
+  IN CONST CHAR8  *Prefix,
+  IN CONST CHAR8  *Expected
+  )
+{
+  XML_EXTENT  Alias;
+  XML_EXTENT  Namespace;
+  EFI_STATUS  Status;
+
+  Alias  = Extent (Prefix);
+  Status = RtlNsGetNamespaceForAlias (&mManager, Depth, &Alias, &Namespace);
+
+  if (Expected == NULL) {
+    return (Prefix[0] == '\0') ? (!EFI_ERROR (Status) && (Namespace.pvData == NULL)) : (Status == STATUS_NOT_FOUND);
+  }
+
+  return !EFI_ERROR (Status) && (Namespace.pvData == (VOID *)Expected);
+}
+
+/**
+  Declares Prefix as an alias for Namespace at Depth.
+**/
+STATIC
+EFI_STATUS
+Declare (
+  IN UINT32       Depth,
+  IN CONST CHAR8  *Prefix,
+  IN CONST CHAR8  *Namespace
+  )
+{
+  XML_EXTENT  Alias;
+  XML_EXTENT  Name;
+
+  Alias = Extent (Prefix);
+  Name  = Extent (Namespace);
+  return RtlNsInsertNamespaceAlias (&mManager, Depth, &Name, &Alias);
+}
+
+/**
+  Sets up an empty namespace manager and the name tables.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+InitializeManager (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < NAME_COUNT; Index++) {
+    AsciiSPrint (mPrefixes[Index], NAME_LENGTH, "p%d", Index);
+    AsciiSPrint (mNamespaces[Index], NAME_LENGTH, "urn:ns:%d", Index);
+  }
+
+  mCompareCount = 0;
+  mModelCount   = 0;
+  if (EFI_ERROR (RtlNsInitialize (&mManager, TestCompare, &mCompareCount, &mAllocator))) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  mManagerReady = TRUE;
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Frees the namespace manager.
+**/
+VOID
+EFIAPI
+DestroyManager (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mManagerReady) {
+    RtlNsDestroy (&mManager);
+    mManagerReady = FALSE;
+  }
+}
+
+/**
+  A prefix declared again on a deeper element hides the outer declaration until that element
+  closes, and goes away when the outer element closes.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+ShadowedPrefixes (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST CHAR8  Settings[]  = "urn:UefiSettings-Schema";
+  STATIC CONST CHAR8  Inner[]     = "urn:UefiSettings-Inner";
+  STATIC CONST CHAR8  Innermost[] = "urn:UefiSettings-Innermost";
+  STATIC CONST CHAR8  Other[]     = "urn:Other";
+
+  // <s:SettingsPacket xmlns:s=Settings xmlns:o=Other>
+  UT_ASSERT_NOT_EFI_ERROR (Declare (1, "s", Settings));
+  UT_ASSERT_NOT_EFI_ERROR (Declare (1, "o", Other));
+  UT_ASSERT_TRUE (Resolves (1, "s", Settings));
+
+  //   <s:Settings xmlns:s=Inner>
+  UT_ASSERT_NOT_EFI_ERROR (Declare (2, "s", Inner));
+  UT_ASSERT_TRUE (Resolves (2, "s", Inner));
+  UT_ASSERT_TRUE (Resolves (2, "o", Other));
+
+  //     <s:Setting> <s:Id xmlns:s=Innermost/> </s:Setting>
+  UT_ASSERT_NOT_EFI_ERROR (Declare (4, "s", Innermost));
+  UT_ASSERT_TRUE (Resolves (4, "s", Innermost));
+  UT_ASSERT_NOT_EFI_ERROR (RtlNsLeaveDepth (&mManager, 4));
+  UT_ASSERT_TRUE (Resolves (3, "s", Inner));
+  UT_ASSERT_NOT_EFI_ERROR (RtlNsLeaveDepth (&mManager, 3));
+  UT_ASSERT_TRUE (Resolves (2, "s", Inner));
+
+  //   </s:Settings>
+  UT_ASSERT_NOT_EFI_ERROR (RtlNsLeaveDepth (&mManager, 2));
+  UT_ASSERT_TRUE (Resolves (1, "s", Settings));
+  UT_ASSERT_TRUE (Resolves (1, "o", Other));
+
+  // </s:SettingsPacket>
+  UT_ASSERT_NOT_EFI_ERROR (RtlNsLeaveDepth (&mManager, 1));
+  UT_ASSERT_TRUE (Resolves (0, "s", NULL));
+  UT_ASSERT_TRUE (Resolves (0, "o", NULL));
+  UT_ASSERT_TRUE (Resolves (0, "x", NULL));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Declaring a prefix twice on one element is refused and leaves the first declaration in place.
+  Once the element closes the prefix can be declared again.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RedefinedPrefixes (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  STATIC CONST CHAR8  First[]  = "urn:first";
+  STATIC CONST CHAR8  Second[] = "urn:second";
+  STATIC CONST CHAR8  Third[]  = "urn:third";
+  XML_EXTENT          Default;
+
+  // <a xmlns:x=First> <b xmlns:x=Second xmlns:x=Third/>
+  UT_ASSERT_NOT_EFI_ERROR (Declare (1, "x", First));
+  UT_ASSERT_NOT_EFI_ERROR (Declare (2, "x", Second));
+  UT_ASSERT_EQUAL (Declare (2, "x", Third), STATUS_DUPLICATE_NAME);
+  UT_ASSERT_TRUE (Resolves (2, "x", Second));
+  UT_ASSERT_NOT_EFI_ERROR (RtlNsLeaveDepth (&mManager, 2));
+  UT_ASSERT_TRUE (Resolves (1, "x", First));
+
+  // <b xmlns:x=Third/> again, now that the first <b> is gone
+  UT_ASSERT_NOT_EFI_ERROR (Declare (2, "x", Third));
+  UT_ASSERT_TRUE (Resolves (2, "x", Third));
+  UT_ASSERT_NOT_EFI_ERROR (RtlNsLeaveDepth (&mManager, 2));
+  UT_ASSERT_TRUE (Resolves (1, "x", First));
+
+  // The same for the default namespace
+  Default = Extent (First);
+  UT_ASSERT_NOT_EFI_ERROR (RtlNsInsertDefaultNamespace (&mManager, 1, &Default));
+  Default = Extent (Second);
+  UT_ASSERT_NOT_EFI_ERROR (RtlNsInsertDefaultNamespace (&mManager, 2, &Default));
+  Default = Extent (Third);
+  UT_ASSERT_EQUAL (RtlNsInsertDefaultNamespace (&mManager, 2, &Default), STATUS_DUPLICATE_NAME);
+  UT_ASSERT_TRUE (Resolves (2, "", Second));
+  UT_ASSERT_NOT_EFI_ERROR (RtlNsLeaveDepth (&mManager, 2));
+  UT_ASSERT_TRUE (Resolves (1, "", First));
+
+  // Closing the outer element forgets both, and the prefix is free to be reused
+  UT_ASSERT_NOT_EFI_ERROR (RtlNsLeaveDepth (&mManager, 1));
+  UT_ASSERT_TRUE (Resolves (0, "x", NULL));
+  UT_ASSERT_TRUE (Resolves (0, "", NULL));
+  UT_ASSERT_NOT_EFI_ERROR (Declare (1, "x", Second));
+  UT_ASSERT_TRUE (Resolves (1, "x", Second));
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  What the model says a prefix resolves to, or NULL.
+**/
+STATIC
+CONST CHAR8 *
+ModelResolve (
+  IN UINT32  Prefix
+  )
+{
+  UINTN  Index;
+
+  for (Index = mModelCount; Index > 0; Index--) {
+    if (mModel[Index - 1].Prefix == Prefix) {
+      return mNamespaces[mModel[Index - 1].Namespace];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  A long random run of declarations, lookups and element closes over more prefixes than the
+  manager has hash buckets gives the same answers as the model.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+RandomScopesMatchModel (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINT32      Seed;
+  UINT32      Depth;
+  UINTN       Step;
+  UINT32      Prefix;
+  UINT32      Namespace;
+  UINTN       Index;
+  BOOLEAN     Duplicate;
+  EFI_STATUS  Status;
+
+  Seed  = 0x2545F491;
+  Depth = 1;
+
+  for (Step = 0; Step < RANDOM_STEPS; Step++) {
+    Seed      = Seed * 1103515245 + 12345;
+    Prefix    = (Seed >> 8) % NAME_COUNT;
+    Namespace = (Seed >> 20) % NAME_COUNT;
+
+    switch ((Seed >> 28) % 4) {
+      case 0:
+        // Open a child element
+        if (Depth < 64) {
+          Depth++;
+        }
+
+        break;
+
+      case 1:
+        // Close the current element
+        if (Depth > 1) {
+          UT_ASSERT_NOT_EFI_ERROR (RtlNsLeaveDepth (&mManager, Depth));
+          while ((mModelCount > 0) && (mModel[mModelCount - 1].Depth >= Depth)) {
+            mModelCount--;
+          }
+
+          Depth--;
+        }
+
+        break;
+
+      case 2:
+        // Declare a prefix on the current element
+        if (mModelCount == MODEL_CAPACITY) {
+          break;
+        }
+
+        Duplicate = FALSE;
+        for (Index = mModelCount; (Index > 0) && (mModel[Index - 1].Depth == Depth); Index--) {
+          if (mModel[Index - 1].Prefix == Prefix) {
+            Duplicate = TRUE;
+          }
+        }
+
+        Status = Declare (Depth, mPrefixes[Prefix], mNamespaces[Namespace]);
+        if (Duplicate) {
+          UT_ASSERT_EQUAL (Status, STATUS_DUPLICATE_NAME);
+        } else {
+          UT_ASSERT_NOT_EFI_ERROR (Status);
+          mModel[mModelCount].Prefix    = Prefix;
+          mModel[mModelCount].Namespace = Namespace;
+          mModel[mModelCount].Depth     = Depth;
+          mModelCount++;
+        }
+
+        break;
+
+      default:
+        // Resolve a prefix
+        UT_ASSERT_TRUE (Resolves (Depth, mPrefixes[Prefix], ModelResolve (Prefix)));
+        break;
+    }
+  }
+
+  // Close everything, and nothing resolves any more
+  UT_ASSERT_NOT_EFI_ERROR (RtlNsLeaveDepth (&mManager, 1));
+  mModelCount = 0;
+  for (Prefix = 0; Prefix < NAME_COUNT; Prefix++) {
+    UT_ASSERT_TRUE (Resolves (0, mPrefixes[Prefix], NULL));
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Opens BENCHMARK_DEPTH nested elements, each declaring two prefixes of its own and shadowing
+  one from an outer element, resolves prefixes at every level the way element and attribute
+  names do and closes them all again.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+NestedNamespaceBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN    Round;
+  UINT32   Depth;
+  UINTN    Operations;
+  clock_t  Start;
+  clock_t  Elapsed;
+
+  Operations    = 0;
+  mCompareCount = 0;
+  Start         = clock ();
+
+  for (Round = 0; Round < BENCHMARK_ROUNDS; Round++) {
+    UT_ASSERT_NOT_EFI_ERROR (Declare (1, "dfci", mNamespaces[0]));
+    UT_ASSERT_NOT_EFI_ERROR (Declare (1, "xsi", mNamespaces[1]));
+
+    for (Depth = 2; Depth <= BENCHMARK_DEPTH; Depth++) {
+      UT_ASSERT_NOT_EFI_ERROR (Declare (Depth, mPrefixes[(2 * Depth) % NAME_COUNT], mNamespaces[Depth % NAME_COUNT]));
+      UT_ASSERT_NOT_EFI_ERROR (Declare (Depth, mPrefixes[(2 * Depth + 1) % NAME_COUNT], mNamespaces[Depth % NAME_COUNT]));
+      UT_ASSERT_NOT_EFI_ERROR (Declare (Depth, "xsi", mNamespaces[Depth % NAME_COUNT]));
+      UT_ASSERT_TRUE (Resolves (Depth, "dfci", mNamespaces[0]));
+      UT_ASSERT_TRUE (Resolves (Depth, "xsi", mNamespaces[Depth % NAME_COUNT]));
+      UT_ASSERT_TRUE (Resolves (Depth, mPrefixes[(2 * Depth) % NAME_COUNT], mNamespaces[Depth % NAME_COUNT]));
+      Operations += 6;
+    }
+
+    for (Depth = BENCHMARK_DEPTH; Depth >= 2; Depth--) {
+      UT_ASSERT_TRUE (Resolves (Depth, "xsi", mNamespaces[Depth % NAME_COUNT]));
+      UT_ASSERT_NOT_EFI_ERROR (RtlNsLeaveDepth (&mManager, Depth));
+      Operations += 2;
+    }
+
+    UT_ASSERT_TRUE (Resolves (1, "xsi", mNamespaces[1]));
+    UT_ASSERT_NOT_EFI_ERROR (RtlNsLeaveDepth (&mManager, 1));
+    UT_ASSERT_TRUE (Resolves (0, "dfci", NULL));
+  }
+
+  Elapsed = MAX (clock () - Start, 1);
+
+  UT_LOG_INFO (
+    "%d namespace operations over %d levels: %d operations/ms, %d comparisons\n",
+    Operations,
+    BENCHMARK_DEPTH,
+    (UINT32)((UINT64)Operations * CLOCKS_PER_SEC / 1000 / Elapsed),
+    mCompareCount
+    );
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  fasterxml namespace manager and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      NamespaceSuite;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create the suite
+  //
+  Status = CreateUnitTestSuite (&NamespaceSuite, Framework, "FasterXml namespace manager tests", "XmlTreeLib.Namespaces", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for NamespaceSuite\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (NamespaceSuite, "Deeper declarations shadow a prefix until their element closes", "ShadowedPrefixes", ShadowedPrefixes, InitializeManager, DestroyManager, NULL);
+  AddTestCase (NamespaceSuite, "A prefix declared twice on one element is refused", "RedefinedPrefixes", RedefinedPrefixes, InitializeManager, DestroyManager, NULL);
+  AddTestCase (NamespaceSuite, "Random declarations and closes match a model of the scoping rules", "RandomScopesMatchModel", RandomScopesMatchModel, InitializeManager, DestroyManager, NULL);
+  AddTestCase (NamespaceSuite, "Deeply nested namespace benchmark", "NestedNamespaceBenchmark", NestedNamespaceBenchmark, InitializeManager, DestroyManager, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}
@@ -0,0 +1,582 @@
+/**
+@file
+Host based unit test for the fasterxml tokenizer.
+
+While the UTF-8 decoder is in use the tokenizer steps over plain ASCII runs without decoding
+them one character at a time. These tests tokenize DFCI and JUnit documents twice, once as the
+library does and once through a decoder that only forwards to the UTF-8 decoder, which keeps
+the tokenizer on its character by character path, and check that the two token streams are the
+same. Every prefix of each document past its XML declaration is tokenized, so runs are cut off
+at every possible point.
+
+Copyright (C) Microsoft Corporation.
+SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <time.h>
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PrintLib.h>
+#include <Library/UnitTestLib.h>
+
+#include "../../../Library/XmlTreeLib/fasterxml/fasterxml.h"
+
+#define UNIT_TEST_APP_NAME     "FasterXml Tokenizer Host Test"
+#define UNIT_TEST_APP_VERSION  "0.1"
+
+#define MAX_TOKENS_PER_DOCUMENT  100000
+#define BENCHMARK_SETTINGS       2000
+#define BENCHMARK_ROUNDS         10
+
+//
+// A DFCI settings packet, with comments, indentation and a long value.
+//
+STATIC CONST CHAR8  mSettingsPacket[] =
+  "<?xml version=\"1.0\" encoding=\"utf-8\"?>\r\n"
+  "<SettingsPacket xmlns=\"urn:UefiSettings-Schema\">\r\n"
+  "  <CreatedBy>UserName</CreatedBy>\r\n"
+  "  <CreatedOn>2015-10-26</CreatedOn>\r\n"
+  "  <Version>1</Version>\r\n"
+  "  <LowestSupportedVersion>1</LowestSupportedVersion>\r\n"
+  "  <Settings>\r\n"
+  "    <Setting Type=\"AssetTag\">\r\n"
+  "      <!-- Asset Tag -->\r\n"
+  "      <Id>100</Id>\r\n"
+  "      <Value>7897897890</Value>\r\n"
+  "    </Setting>\r\n"
+  "    <Setting Type='SecureBootKey'>\r\n"
+  "      <!-- Secure Boot Key Enum - - with dashes -->\r\n"
+  "      <Id>Dfci.SecureBootKeys.Enable</Id>\r\n"
+  "      <Value>MsOnly</Value>\r\n"
+  "    </Setting>\r\n"
+  "    <Setting>\r\n"
+  "      <Id>Dfci.OnboardCameras.Enable</Id>\r\n"
+  "      <Value>Disabled</Value>\r\n"
+  "    </Setting>\r\n"
+  "    <Setting>\r\n"
+  "      <Id>Dfci.Hash.Ownership</Id>\r\n"
+  "      <Value>MIIDeDCCAmCgAwIBAgIQZx6o2cpm1LdCdfkMhfZ8ojANBgkqhkiG9w0BAQsFADAuMSwwKgYDVQQDEyNEZmNp"
+  "IFRlc3QgQ2VydGlmaWNhdGUgQXV0aG9yaXR5IDIwHhcNMjAwNjE2MDAwMDAwWhcNMzAwNjE2MDAwMDAwWjAu</Value>\r\n"
+  "    </Setting>\r\n"
+  "  </Settings>\r\n"
+  "</SettingsPacket>\r\n";
+
+//
+// A DFCI permissions packet, with attributes in both kinds of quote.
+//
+STATIC CONST CHAR8  mPermissionsPacket[] =
+  "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+  "<PermissionsPacket xmlns=\"urn:UefiSettings-Schema\">\n"
+  "\t<CreatedBy>UserName</CreatedBy>\n"
+  "\t<CreatedOn>2015-10-26</CreatedOn>\n"
+  "\t<Version>1</Version>\n"
+  "\t<LowestSupportedVersion>1</LowestSupportedVersion>\n"
+  "\t<Permissions Default=\"0x80\" Append='False' Delegated = \"0x00\" >\n"
+  "\t\t<Permission>\n"
+  "\t\t\t<Id>Dfci.OnboardWifi.Enable</Id>\n"
+  "\t\t\t<PMask>0xFF</PMask>\n"
+  "\t\t\t<DMask>0x81</DMask>\n"
+  "\t\t</Permission>\n"
+  "\t\t<Permission><Id>Dfci.Zero_Touch</Id><PMask>0x81</PMask></Permission>\n"
+  "\t</Permissions>\n"
+  "</PermissionsPacket>\n";
+
+//
+// A JUnit report of the kind UnitTestResultReportJUnitFormatLib writes, with escapes, CDATA and
+// text outside ASCII.
+//
+STATIC CONST CHAR8  mJUnitReport[] =
+  "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+  "<testsuites>\n"
+  "  <testsuite name=\"Dfci.Settings &amp; Permissions\" package=\"DfciPkg\" tests=\"3\" failures=\"1\">\n"
+  "    <testcase name=\"ApplyAll\" classname=\"Dfci.Apply\" time=\"0.001\"/>\n"
+  "    <testcase name=\"R\xC3\xA9sum\xC3\xA9 \xE2\x9C\x93\" classname=\"Dfci.Unicode\">\n"
+  "      <system-out>caf\xC3\xA9 \xF0\x9F\x98\x80 &lt;ok&gt; &#x41;&#66;</system-out>\n"
+  "    </testcase>\n"
+  "    <testcase name=\"Broken\" classname='Dfci.Broken'>\n"
+  "      <failure message=\"Expected 'A' &quot;got&quot; B\" type=\"failure\"><![CDATA[Assert ] ]] > x < y && z\n"
+  "  at DfciTests.c:42]]></failure>\n"
+  "    </testcase>\n"
+  "    <!-- \xE2\x80\x94 trailing comment \xE2\x80\x94 -->\n"
+  "  </testsuite>\n"
+  "</testsuites>\n";
+
+//
+// Documents that go wrong part way through. Each is tokenized up to the error.
+//
+STATIC CONST CHAR8  mBadUtf8[] =
+  "<?xml version=\"1.0\" encoding=\"utf-8\"?><Root>long plain text before the bad byte \xFF and after</Root>";
+STATIC CONST CHAR8  mTruncatedUtf8[] =
+  "<?xml version=\"1.0\" encoding=\"utf-8\"?><Root a=\"value \xE2\x9C\"/></Root>";
+STATIC CONST CHAR8  mBadContinuation[] =
+  "<?xml version=\"1.0\" encoding=\"utf-8\"?><Root><!-- comment \xC3\x28 --></Root>";
+STATIC CONST CHAR8  mUnclosedComment[] =
+  "<?xml version=\"1.0\" encoding=\"utf-8\"?><Root><!-- this comment never ends";
+
+//
+// A NUL byte inside text. The fast scan must hand it to the decoder rather than step over it.
+//
+STATIC CONST CHAR8  mEmbeddedNul[] =
+  "<?xml version=\"1.0\" encoding=\"utf-8\"?><Root>text with a \0 in the middle of it</Root>";
+
+typedef struct {
+  CONST CHAR8    *Name;
+  CONST CHAR8    *Document;
+  UINTN          Size;
+} TOKENIZER_CORPUS_ENTRY;
+
+STATIC CONST TOKENIZER_CORPUS_ENTRY  mCorpus[] = {
+  { "SettingsPacket",    mSettingsPacket,    sizeof (mSettingsPacket) - 1    },
+  { "PermissionsPacket", mPermissionsPacket, sizeof (mPermissionsPacket) - 1 },
+  { "JUnitReport",       mJUnitReport,       sizeof (mJUnitReport) - 1       },
+};
+
+STATIC CONST TOKENIZER_CORPUS_ENTRY  mMalformed[] = {
+  { "BadUtf8",         mBadUtf8,         sizeof (mBadUtf8) - 1         },
+  { "TruncatedUtf8",   mTruncatedUtf8,   sizeof (mTruncatedUtf8) - 1   },
+  { "BadContinuation", mBadContinuation, sizeof (mBadContinuation) - 1 },
+  { "UnclosedComment", mUnclosedComment, sizeof (mUnclosedComment) - 1 },
+  { "EmbeddedNul",     mEmbeddedNul,     sizeof (mEmbeddedNul) - 1     },
+};
+
+//
+// One token as the tokenizer returned it, with the data pointer made relative to the document.
+//
+typedef struct {
+  EFI_STATUS                         Status;
+  XML_TOKENIZATION_SPECIFIC_STATE    State;
+  BOOLEAN                            fError;
+  UINT64                             Offset;
+  UINT64                             cbData;
+  UINT64                             ulCharacters;
+  XML_LINE_AND_COLUMN                Location;
+} RECORDED_TOKEN;
+
+STATIC RECORDED_TOKEN  *mFastTokens    = NULL;
+STATIC RECORDED_TOKEN  *mGenericTokens = NULL;
+STATIC CHAR8           *mLargeDocument = NULL;
+
+/**
+  Stands in for RtlXmlDefaultNextCharacter_UTF8. The tokenizer only takes its fast path for the
+  UTF-8 decoder itself, so decoding through this keeps it on the character by character path.
+**/
+XML_RAWTOKENIZATION_RESULT
+EFIAPI
+GenericNextCharacter (
+  const void     *pvCursor,
+  IN const void  *pvEnd
+  )
+{
+  return RtlXmlDefaultNextCharacter_UTF8 (pvCursor, pvEnd);
+}
+
+/**
+  Tokenizes a document to its end or its first error and records every token.
+
+  @param[in]   Document    Document to tokenize. Only Size bytes of it are read.
+  @param[in]   Size        Bytes of the document to tokenize
+  @param[in]   Generic     TRUE to keep the tokenizer on its character by character path
+  @param[out]  Tokens      Tokens returned, MAX_TOKENS_PER_DOCUMENT of them at most
+  @param[out]  Count       Number of tokens recorded
+
+  @retval  EFI_SUCCESS     The tokenizer was run. A failing token is recorded like any other.
+  @retval  other           The tokenizer could not be set up.
+**/
+STATIC
+EFI_STATUS
+TokenizeDocument (
+  IN  CONST CHAR8     *Document,
+  IN  UINTN           Size,
+  IN  BOOLEAN         Generic,
+  OUT RECORDED_TOKEN  *Tokens,
+  OUT UINTN           *Count
+  )
+{
+  XML_TOKENIZATION_INIT   Init;
+  XML_TOKENIZATION_STATE  State;
+  XML_TOKEN               Token;
+  UINTN                   EncodingLength;
+  EFI_STATUS              Status;
+  RECORDED_TOKEN          *Recorded;
+
+  *Count = 0;
+
+  ZeroMem (&Init, sizeof (Init));
+  Init.Size            = sizeof (Init);
+  Init.XmlData         = (VOID *)Document;
+  Init.XmlDataSize     = (UINT32)Size;
+  Init.SupportPosition = TRUE;
+
+  Status = RtlXmlInitializeTokenization (&State, &Init);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  Status = RtlXmlDetermineStreamEncoding (&State, &EncodingLength);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  State.RawTokenState.pvCursor = (VOID *)((UINTN)State.RawTokenState.pvCursor + EncodingLength);
+  if (Generic) {
+    State.RawTokenState.pfnNextChar = GenericNextCharacter;
+  }
+
+  while (*Count < MAX_TOKENS_PER_DOCUMENT) {
+    ZeroMem (&Token, sizeof (Token));
+    Status = RtlXmlNextToken (&State, &Token, TRUE);
+
+    Recorded               = &Tokens[(*Count)++];
+    Recorded->Status       = Status;
+    Recorded->State        = Token.State;
+    Recorded->fError       = Token.fError;
+    Recorded->Offset       = (Token.Run.pvData == NULL) ? MAX_UINT64 : (UINT64)((UINTN)Token.Run.pvData - (UINTN)Document);
+    Recorded->cbData       = Token.Run.cbData;
+    Recorded->ulCharacters = Token.Run.ulCharacters;
+    Recorded->Location     = State.Location;
+
+    if (EFI_ERROR (Status) || Token.fError || (Token.State == XTSS_STREAM_END) || (Token.State == XTSS_ERRONEOUS)) {
+      break;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Tokenizes every prefix of a document both ways and checks the two token streams are the same.
+
+  @param[in]  Entry   Document to check
+  @param[in]  Whole   TRUE when the whole document must tokenize without error
+
+  @retval  TRUE if every prefix gave the same tokens both ways.
+**/
+STATIC
+BOOLEAN
+TokenStreamsMatch (
+  IN CONST TOKENIZER_CORPUS_ENTRY  *Entry,
+  IN BOOLEAN                       Whole
+  )
+{
+  CHAR8        *Document;
+  CONST CHAR8  *DeclarationEnd;
+  UINTN        Size;
+  UINTN        FastCount;
+  UINTN        GenericCount;
+  UINTN        Index;
+
+  //
+  // The tokenizer asserts when the XML declaration itself is cut short, so every prefix
+  // keeps the whole declaration. The fast path is not used inside it anyway.
+  //
+  DeclarationEnd = AsciiStrStr (Entry->Document, "?>");
+  if (DeclarationEnd == NULL) {
+    return FALSE;
+  }
+
+  for (Size = (UINTN)(DeclarationEnd - Entry->Document) + 2; Size <= Entry->Size; Size++) {
+    // Copy the prefix on its own so reading past it is caught
+    Document = AllocateCopyPool (Size, Entry->Document);
+    if (Document == NULL) {
+      return FALSE;
+    }
+
+    if (EFI_ERROR (TokenizeDocument (Document, Size, FALSE, mFastTokens, &FastCount)) ||
+        EFI_ERROR (TokenizeDocument (Document, Size, TRUE, mGenericTokens, &GenericCount)))
+    {
+      FreePool (Document);
+      return FALSE;
+    }
+
+    FreePool (Document);
+
+    if (FastCount != GenericCount) {
+      UT_LOG_ERROR ("%a: %d bytes gave %d tokens, expected %d\n", Entry->Name, Size, FastCount, GenericCount);
+      return FALSE;
+    }
+
+    for (Index = 0; Index < FastCount; Index++) {
+      if (CompareMem (&mFastTokens[Index], &mGenericTokens[Index], sizeof (RECORDED_TOKEN)) != 0) {
+        UT_LOG_ERROR (
+          "%a: %d bytes, token %d differs: state %d/%d offset %ld/%ld length %ld/%ld\n",
+          Entry->Name,
+          Size,
+          Index,
+          mFastTokens[Index].State,
+          mGenericTokens[Index].State,
+          mFastTokens[Index].Offset,
+          mGenericTokens[Index].Offset,
+          mFastTokens[Index].cbData,
+          mGenericTokens[Index].cbData
+          );
+        return FALSE;
+      }
+    }
+
+    // The whole of a good document must come out clean
+    if (Whole && (Size == Entry->Size) &&
+        (EFI_ERROR (mFastTokens[FastCount - 1].Status) || mFastTokens[FastCount - 1].fError ||
+         (mFastTokens[FastCount - 1].State != XTSS_STREAM_END)))
+    {
+      UT_LOG_ERROR ("%a: did not tokenize cleanly\n", Entry->Name);
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Allocates the token buffers used by every test.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+AllocateTokenBuffers (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  mFastTokens    = AllocateZeroPool (MAX_TOKENS_PER_DOCUMENT * sizeof (RECORDED_TOKEN));
+  mGenericTokens = AllocateZeroPool (MAX_TOKENS_PER_DOCUMENT * sizeof (RECORDED_TOKEN));
+  if ((mFastTokens == NULL) || (mGenericTokens == NULL)) {
+    return UNIT_TEST_ERROR_PREREQUISITE_NOT_MET;
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Frees what the tests allocated.
+**/
+VOID
+EFIAPI
+FreeTokenBuffers (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  if (mFastTokens != NULL) {
+    FreePool (mFastTokens);
+    mFastTokens = NULL;
+  }
+
+  if (mGenericTokens != NULL) {
+    FreePool (mGenericTokens);
+    mGenericTokens = NULL;
+  }
+
+  if (mLargeDocument != NULL) {
+    FreePool (mLargeDocument);
+    mLargeDocument = NULL;
+  }
+}
+
+/**
+  DFCI packets and a JUnit report give the same tokens both ways, cut off at any point.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+CorpusTokenStreamsMatch (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mCorpus); Index++) {
+    UT_ASSERT_TRUE (TokenStreamsMatch (&mCorpus[Index], TRUE));
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Bad UTF-8, a NUL byte and unterminated constructs fail at the same token both ways.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+MalformedTokenStreamsMatch (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN  Index;
+
+  for (Index = 0; Index < ARRAY_SIZE (mMalformed); Index++) {
+    UT_ASSERT_TRUE (TokenStreamsMatch (&mMalformed[Index], FALSE));
+  }
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Writes a settings packet with BENCHMARK_SETTINGS settings into mLargeDocument.
+
+  @retval  Size of the document, or 0 when it could not be allocated.
+**/
+STATIC
+UINTN
+BuildLargeSettingsPacket (
+  VOID
+  )
+{
+  UINTN  Capacity;
+  UINTN  Size;
+  UINTN  Index;
+
+  Capacity       = 512 * (BENCHMARK_SETTINGS + 1);
+  mLargeDocument = AllocatePool (Capacity);
+  if (mLargeDocument == NULL) {
+    return 0;
+  }
+
+  Size = AsciiSPrint (
+           mLargeDocument,
+           Capacity,
+           "<?xml version=\"1.0\" encoding=\"utf-8\"?>\r\n"
+           "<SettingsPacket xmlns=\"urn:UefiSettings-Schema\">\r\n"
+           "  <CreatedBy>UserName</CreatedBy>\r\n"
+           "  <Version>2</Version>\r\n"
+           "  <Settings>\r\n"
+           );
+
+  for (Index = 0; Index < BENCHMARK_SETTINGS; Index++) {
+    Size += AsciiSPrint (
+              &mLargeDocument[Size],
+              Capacity - Size,
+              "    <Setting Type=\"Enable\">\r\n"
+              "      <!-- Generated setting number %d of the benchmark packet -->\r\n"
+              "      <Id>Dfci.Generated.Setting%d.Enable</Id>\r\n"
+              "      <Value>MIIDeDCCAmCgAwIBAgIQZx6o2cpm1LdCdfkMhfZ8ojANBgkqhkiG9w0BAQsFADAu%d</Value>\r\n"
+              "    </Setting>\r\n",
+              Index,
+              Index,
+              Index
+              );
+  }
+
+  Size += AsciiSPrint (&mLargeDocument[Size], Capacity - Size, "  </Settings>\r\n</SettingsPacket>\r\n");
+  return Size;
+}
+
+/**
+  Reports how fast a large settings packet is tokenized both ways.
+**/
+UNIT_TEST_STATUS
+EFIAPI
+TokenizerBenchmark (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  UINTN    Size;
+  UINTN    Round;
+  UINTN    FastCount;
+  UINTN    GenericCount;
+  clock_t  Start;
+  clock_t  FastElapsed;
+  clock_t  GenericElapsed;
+
+  Size = BuildLargeSettingsPacket ();
+  UT_ASSERT_NOT_EQUAL (Size, 0);
+
+  Start = clock ();
+  for (Round = 0; Round < BENCHMARK_ROUNDS; Round++) {
+    UT_ASSERT_NOT_EFI_ERROR (TokenizeDocument (mLargeDocument, Size, FALSE, mFastTokens, &FastCount));
+  }
+
+  FastElapsed = MAX (clock () - Start, 1);
+
+  Start = clock ();
+  for (Round = 0; Round < BENCHMARK_ROUNDS; Round++) {
+    UT_ASSERT_NOT_EFI_ERROR (TokenizeDocument (mLargeDocument, Size, TRUE, mGenericTokens, &GenericCount));
+  }
+
+  GenericElapsed = MAX (clock () - Start, 1);
+
+  UT_LOG_INFO (
+    "Tokenizing %d bytes: %d KB/s with the UTF-8 fast path, %d KB/s one character at a time\n",
+    Size,
+    (UINT32)((UINT64)Size * BENCHMARK_ROUNDS * CLOCKS_PER_SEC / FastElapsed / 1024),
+    (UINT32)((UINT64)Size * BENCHMARK_ROUNDS * CLOCKS_PER_SEC / GenericElapsed / 1024)
+    );
+
+  UT_ASSERT_EQUAL (FastCount, GenericCount);
+  UT_ASSERT_MEM_EQUAL (mFastTokens, mGenericTokens, FastCount * sizeof (RECORDED_TOKEN));
+  UT_ASSERT_EQUAL (mFastTokens[FastCount - 1].State, XTSS_STREAM_END);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Initialize the unit test framework, suite, and unit tests for the
+  fasterxml tokenizer and run the unit tests.
+
+  @retval  EFI_SUCCESS           All test cases were dispatched.
+  @retval  EFI_OUT_OF_RESOURCES  There are not enough resources available to
+                                 initialize the unit tests.
+**/
+EFI_STATUS
+EFIAPI
+UefiTestMain (
+  VOID
+  )
+{
+  EFI_STATUS                  Status;
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  UNIT_TEST_SUITE_HANDLE      TokenizerSuite;
+
+  Framework = NULL;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  //
+  // Start setting up the test framework for running the tests.
+  //
+  Status = InitUnitTestFramework (&Framework, UNIT_TEST_APP_NAME, gEfiCallerBaseName, UNIT_TEST_APP_VERSION);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in InitUnitTestFramework. Status = %r\n", Status));
+    goto EXIT;
+  }
+
+  //
+  // Create the suite
+  //
+  Status = CreateUnitTestSuite (&TokenizerSuite, Framework, "FasterXml tokenizer fast path tests", "XmlTreeLib.Tokenizer", NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "Failed in CreateUnitTestSuite for TokenizerSuite\n"));
+    Status = EFI_OUT_OF_RESOURCES;
+    goto EXIT;
+  }
+
+  //
+  // Register Tests
+  //
+  AddTestCase (TokenizerSuite, "DFCI and JUnit documents tokenize the same both ways", "CorpusTokenStreamsMatch", CorpusTokenStreamsMatch, AllocateTokenBuffers, FreeTokenBuffers, NULL);
+  AddTestCase (TokenizerSuite, "Malformed documents fail the same both ways", "MalformedTokenStreamsMatch", MalformedTokenStreamsMatch, AllocateTokenBuffers, FreeTokenBuffers, NULL);
+  AddTestCase (TokenizerSuite, "Tokenizer throughput benchmark", "TokenizerBenchmark", TokenizerBenchmark, AllocateTokenBuffers, FreeTokenBuffers, NULL);
+
+  //
+  // Execute the tests.
+  //
+  Status = RunAllTestSuites (Framework);
+
+EXIT:
+  if (Framework) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return Status;
+}
+
+/**
+  Standard POSIX C entry point for host based unit test execution.
+**/
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  return UefiTestMain ();
+}